@@ -326,6 +326,50 @@ typedef struct
 */
 ODE_API int dWorldSetStepMemoryManager(dWorldID w, const dWorldStepMemoryFunctionsInfo *memfuncs);
 
+/**
+ * @struct dWorldStepMemoryStats
+ * @brief Statistics of the working memory arenas used by world stepping.
+ *
+ * The world steps from one arena holding the islands and one arena per
+ * island thread holding the stepper data of the island being stepped. The
+ * arenas are kept from one step to the next and only grow, so once the
+ * largest step has been seen stepping does not allocate any more.
+ *
+ * @c arena_count is the number of arenas.
+ *
+ * @c reserved_bytes is the total size of the arenas.
+ *
+ * @c high_water_bytes is the total of the largest amount of memory each arena
+ * has had in use.
+ *
+ * @c grow_count is the number of times an arena has been (re)allocated.
+ *
+ * @ingroup world
+ * @see dWorldGetStepMemoryStats
+ */
+typedef struct
+{
+  unsigned arena_count;
+  size_t reserved_bytes;
+  size_t high_water_bytes;
+  unsigned grow_count;
+
+} dWorldStepMemoryStats;
+
+/**
+ * @brief Get the statistics of the working memory used by world stepping.
+ *
+ * The statistics start over when the working memory is released with
+ * @c dWorldCleanupWorkingMemory.
+ *
+ * @param w The world to get the statistics of.
+ * @param stats The statistics.
+ *
+ * @ingroup world
+ * @see dWorldCleanupWorkingMemory
+ */
+ODE_API void dWorldGetStepMemoryStats(dWorldID w, dWorldStepMemoryStats *stats);
+
 /**
  * @brief Step the world.
  *
@@ -399,6 +443,45 @@ ODE_API int dWorldRobustStep (dWorldID, dReal stepsize);
  */
 ODE_API int dWorldQuickStep (dWorldID w, dReal stepsize);
 
+/**
+ * @brief Step the world like dWorldQuickStep, solving the constraint rows
+ * of each island with a graph-colored PGS.
+ * @ingroup world
+ * @remarks
+ * The rows are grouped by pair of bodies, and the groups are colored so
+ * that the groups of a color touch disjoint bodies. The groups of a color
+ * are then solved at the same time by a persistent pool of threads, the
+ * colors one after another. The result does not depend on the number of
+ * threads, but the rows are not solved in the same order as
+ * dWorldQuickStep, so the solution differs by the PGS error.
+ * Small islands, and worlds using thread_position_correction, are solved
+ * serially.
+ * @param w The world to be stepped
+ * @param stepsize The number of seconds that the simulation has to advance.
+ * @returns 1 for success and 0 for failure
+ * @sa dWorldSetQuickStepColoredThreads
+ */
+ODE_API int dWorldColoredQuickStep (dWorldID w, dReal stepsize);
+
+/**
+ * @brief Step the world like dWorldQuickStep, solving the joints of each
+ * island that form trees exactly.
+ * @ingroup world
+ * @remarks
+ * The unbounded rows of the joints that do not close a loop are solved
+ * with a sparse LDL' factorization that follows the tree structure, in
+ * time linear in the number of bodies. The rest of the rows (contacts,
+ * limits, motors, and joints closing loops) are solved by PGS, alternating
+ * with the tree solution for dWorldSetQuickStepNumIterations iterations.
+ * The tree is solved last, so long chains and branched models keep their
+ * joints together with few iterations. Only the pyramid friction model
+ * of quickstep is supported.
+ * @param w The world to be stepped
+ * @param stepsize The number of seconds that the simulation has to advance.
+ * @returns 1 for success and 0 for failure
+ */
+ODE_API int dWorldSparseQuickStep (dWorldID w, dReal stepsize);
+
 
 /**
 * @brief Converts an impulse to a force.
@@ -503,6 +586,22 @@ ODE_API void dWorldSetQuickStepPreconIterations (dWorldID, int num);
  */
 ODE_API int dWorldGetQuickStepNumIterations (dWorldID);
 
+/**
+ * @brief Set the number of threads solving the rows with
+ *        dWorldColoredQuickStep, including the stepping thread.
+ * @ingroup world
+ * @param num The default is 0, for one thread per core.
+ */
+ODE_API void dWorldSetQuickStepColoredThreads (dWorldID, int num);
+
+/**
+ * @brief Get the number of threads solving the rows with
+ *        dWorldColoredQuickStep.
+ * @ingroup world
+ * @return number of threads, 0 for one thread per core
+ */
+ODE_API int dWorldGetQuickStepColoredThreads (dWorldID);
+
 /**
  * @brief Get the number of iterations that the QuickStep method performs per
  *        step.
@@ -2131,6 +2230,30 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Get the constraint impulses computed for the joint by the last
+ * quickstep, which are used to warm start the next one. They are only
+ * stored when the warm start factor is positive.
+ * @param lambda Array of 6 elements receiving the impulses, one per
+ * constraint row. May be 0.
+ * @param lambda_erp Array of 6 elements receiving the impulses of the
+ * position correction. May be 0.
+ * @ingroup joints
+ */
+ODE_API void dJointGetLambda (dJointID, dReal *lambda, dReal *lambda_erp);
+
+/**
+ * @brief Set the constraint impulses used to warm start the next quickstep.
+ * This seeds joints created every step, such as contacts, with the
+ * impulses of their counterparts of the previous step.
+ * @param lambda Array of 6 impulses, one per constraint row. May be 0.
+ * @param lambda_erp Array of 6 impulses of the position correction.
+ * May be 0.
+ * @ingroup joints
+ */
+ODE_API void dJointSetLambda (dJointID, const dReal *lambda,
+    const dReal *lambda_erp);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
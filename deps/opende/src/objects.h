@@ -35,6 +35,8 @@
 #include <boost/threadpool.hpp>
 
 class dxStepWorkingMemory;
+class dxWorkerPool;
+struct dxWorldProcessContext;
 
 // some body flags
 
@@ -195,15 +197,19 @@ struct dxWorld : public dBase {
   dxAutoDisable adis;    // auto-disable parameters
   int body_flags;               // flags for new bodies
   dxStepWorkingMemory *wmem; // Working memory object for dWorldStep/dWorldQuickStep
-  std::vector<dxStepWorkingMemory *> island_wmems; // Working memory object for dWorldStep/dWorldQuickStep
+  std::vector<dxWorldProcessContext *> island_contexts; // stepper arena of each island thread
+  unsigned step_arena_grows;    // (re)allocations of the stepping arenas
 
   dxQuickStepParameters qs;
   dxRobustStepParameters rs;
   dxContactParameters contactp;
   dxDampingParameters dampingp; // damping parameters
   dReal max_angular_speed;      // limit the angular velocity to this magnitude
-  boost::threadpool::pool *threadpool;
+  dxWorkerPool *island_pool;    // steps the islands, NULL to step them in the calling thread
   boost::threadpool::pool *row_threadpool;
+  int color_threads;            // threads of the colored quickstep, 0 for all cores
+  dxWorkerPool *color_pool;     // created by the first colored quickstep
+  int parallel_threads;         // threads of the parallel quickstep, 0 for all cores
 };
 
 
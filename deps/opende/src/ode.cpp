@@ -37,6 +37,8 @@
 #include "joints/joints.h"
 #include "step.h"
 #include "quickstep.h"
+#include "sparsestep.h"
+#include "quickstep_worker_pool.h"
 #include "util.h"
 #include "odetls.h"
 #include "robuststep.h"
@@ -1542,6 +1544,25 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
   return joint->feedback;
 }
 
+void dJointGetLambda (dxJoint *joint, dReal *lambda, dReal *lambda_erp)
+{
+  dAASSERT (joint);
+  if (lambda)
+    memcpy (lambda, joint->lambda, sizeof(joint->lambda));
+  if (lambda_erp)
+    memcpy (lambda_erp, joint->lambda_erp, sizeof(joint->lambda_erp));
+}
+
+void dJointSetLambda (dxJoint *joint, const dReal *lambda,
+    const dReal *lambda_erp)
+{
+  dAASSERT (joint);
+  if (lambda)
+    memcpy (joint->lambda, lambda, sizeof(joint->lambda));
+  if (lambda_erp)
+    memcpy (joint->lambda_erp, lambda_erp, sizeof(joint->lambda_erp));
+}
+
 
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
@@ -1681,8 +1702,12 @@ dxWorld * dWorldCreate()
   w->dampingp.angular_threshold = REAL(0.01) * REAL(0.01);
   w->max_angular_speed = dInfinity;
 
-  w->threadpool = NULL; // new boost::threadpool::pool(0);
+  w->island_pool = NULL;
+  w->step_arena_grows = 0;
   w->row_threadpool = NULL; // new boost::threadpool::pool(0);
+  w->color_threads = 0;
+  w->color_pool = NULL;
+  w->parallel_threads = 0;
 
   return w;
 }
@@ -1747,16 +1772,16 @@ void dWorldDestroy (dxWorld *w)
     w->wmem->Release();
   }
 
-  if (w->threadpool) {
-    w->threadpool->wait();
-    delete w->threadpool;
-  }
+  dxFreeIslandProcessContexts(w);
+  delete w->island_pool;
 
   if (w->row_threadpool) {
     w->row_threadpool->wait();
     delete w->row_threadpool;
   }
 
+  delete w->color_pool;
+
   delete w;
 }
 
@@ -1772,23 +1797,20 @@ void dWorldSetGravity (dWorldID w, dReal x, dReal y, dReal z)
 int dWorldGetIslandThreads (dWorldID w)
 {
   dAASSERT (w);
-  if (!w->threadpool) {
+  if (!w->island_pool) {
     return 0;
   }
   // else
-  return w->threadpool->size();
+  return w->island_pool->size();
 }
 
 void dWorldSetIslandThreads (dWorldID w, int num_island_threads)
 {
   dAASSERT (w);
-  if (w->threadpool) {
-    w->threadpool->wait();
-    delete w->threadpool;
-    w->threadpool = NULL;
-  }
+  delete w->island_pool;
+  w->island_pool = NULL;
   if (num_island_threads > 0) {
-    w->threadpool = new boost::threadpool::pool(num_island_threads);
+    w->island_pool = new dxWorkerPool(num_island_threads);
   }
 }
 
@@ -1897,6 +1919,37 @@ void dWorldCleanupWorkingMemory(dWorldID w)
   {
     wmem->CleanupMemory();
   }
+
+  dxFreeIslandProcessContexts(w);
+}
+
+void dWorldGetStepMemoryStats(dWorldID w, dWorldStepMemoryStats *stats)
+{
+  dUASSERT (w,"bad world argument");
+  dUASSERT (stats,"bad stats argument");
+
+  stats->arena_count = 0;
+  stats->reserved_bytes = 0;
+  stats->high_water_bytes = 0;
+  stats->grow_count = w->step_arena_grows;
+
+  dxWorldProcessContext *context = w->wmem ? w->wmem->GetWorldProcessingContext() : NULL;
+  if (context)
+  {
+    stats->arena_count++;
+    stats->reserved_bytes += context->GetMemorySize();
+    stats->high_water_bytes += context->GetHighWaterSize();
+  }
+
+  for (auto island_context : w->island_contexts)
+  {
+    if (island_context)
+    {
+      stats->arena_count++;
+      stats->reserved_bytes += island_context->GetMemorySize();
+      stats->high_water_bytes += island_context->GetHighWaterSize();
+    }
+  }
 }
 
 int dWorldSetStepMemoryReservationPolicy(dWorldID w, const dWorldStepReserveInfo *policyinfo)
@@ -1994,6 +2047,48 @@ int dWorldQuickStep (dWorldID w, dReal stepsize)
   return result;
 }
 
+int dWorldColoredQuickStep (dWorldID w, dReal stepsize)
+{
+  dUASSERT (w,"bad world argument");
+  dUASSERT (stepsize > 0,"stepsize must be > 0");
+
+  bool result = false;
+
+  if (!w->color_pool)
+  {
+    int threads = w->color_threads;
+    if (threads <= 0)
+      threads = std::thread::hardware_concurrency();
+    w->color_pool = new dxWorkerPool(threads);
+  }
+
+  if (dxReallocateWorldProcessContext (w, stepsize, &dxEstimateQuickStepMemoryRequirements))
+  {
+    dxProcessIslands (w, stepsize, &dxColoredQuickStepper);
+
+    result = true;
+  }
+
+  return result;
+}
+
+int dWorldSparseQuickStep (dWorldID w, dReal stepsize)
+{
+  dUASSERT (w,"bad world argument");
+  dUASSERT (stepsize > 0,"stepsize must be > 0");
+
+  bool result = false;
+
+  if (dxReallocateWorldProcessContext (w, stepsize, &dxEstimateSparseQuickStepMemoryRequirements))
+  {
+    dxProcessIslands (w, stepsize, &dxSparseQuickStepper);
+
+    result = true;
+  }
+
+  return result;
+}
+
 int dWorldRobustStep(dWorldID w, dReal stepsize)
 {
   dUASSERT (w,"bad world argument");
@@ -2239,6 +2334,22 @@ int dWorldGetQuickStepNumIterations (dWorldID w)
   return w->qs.num_iterations;
 }
 
+void dWorldSetQuickStepColoredThreads (dWorldID w, int num)
+{
+  dAASSERT(w);
+  w->color_threads = num > 0 ? num : 0;
+
+  // the pool is created again by the next step
+  delete w->color_pool;
+  w->color_pool = NULL;
+}
+
+int dWorldGetQuickStepColoredThreads (dWorldID w)
+{
+  dAASSERT(w);
+  return w->color_threads;
+}
+
 void dWorldSetRobustStepMaxIterations (dWorldID w, int num)
 {
   dAASSERT(w);
@@ -100,9 +100,11 @@ void computeRHSPrecon(dxWorldProcessContext *context, const int m, const int nb,
     } END_STATE_SAVE(context, tmp2state);
 }
 
-void dxQuickStepper (dxWorldProcessContext *context,
+// quickstep of an island, solving the LCP with the graph-colored solver on
+// the threads of pool when it is not NULL
+static void QuickStep (dxWorldProcessContext *context,
   dxWorld *world, dxBody * const *body, int nb,
-  dxJoint * const *_joint, int _nj, dReal stepsize)
+  dxJoint * const *_joint, int _nj, dReal stepsize, dxWorkerPool *pool)
 {
   IFTIMING(dTimerStart("preprocessing"));
 
@@ -512,7 +514,7 @@ void dxQuickStepper (dxWorldProcessContext *context,
                caccel,caccel_erp,cforce,
                rhs,rhs_erp,rhs_precon,
                lo,hi,cfm,findex,
-               &world->qs
+               &world->qs, pool
 #ifdef USE_TPROW
                , world->row_threadpool
 #endif
@@ -524,8 +526,8 @@ void dxQuickStepper (dxWorldProcessContext *context,
     {
       // warm starting
       // save lambda for the next iteration
-      //@@@ note that this doesn't work for contact joints yet, as they are
-      // recreated every iteration
+      // contact joints are recreated every iteration, their lambda is
+      // carried over by the caller (see dJointGetLambda/dJointSetLambda)
       const dReal *lambdacurr = lambda;
       const dReal *lambda_erpcurr = lambda_erp;
       const dJointWithInfo1 *jicurr = jointiinfos;
@@ -551,6 +553,21 @@ void dxQuickStepper (dxWorldProcessContext *context,
 
 }
 
+void dxQuickStepper (dxWorldProcessContext *context,
+  dxWorld *world, dxBody * const *body, int nb,
+  dxJoint * const *_joint, int _nj, dReal stepsize)
+{
+  QuickStep(context, world, body, nb, _joint, _nj, stepsize, NULL);
+}
+
+void dxColoredQuickStepper (dxWorldProcessContext *context,
+  dxWorld *world, dxBody * const *body, int nb,
+  dxJoint * const *_joint, int _nj, dReal stepsize)
+{
+  QuickStep(context, world, body, nb, _joint, _nj, stepsize,
+    world->color_pool);
+}
+
 size_t dxEstimateQuickStepMemoryRequirements (
   dxBody * const * /*body*/, int nb, dxJoint * const *_joint, int _nj)
 {
@@ -32,5 +32,11 @@ void dxQuickStepper (dxWorldProcessContext *context,
         dxWorld *world, dxBody * const *body, int nb,
 		    dxJoint * const *_joint, int _nj, dReal stepsize);
 
+// same as dxQuickStepper, the constraint rows being solved with the
+// graph-colored PGS on the threads of world->color_pool
+void dxColoredQuickStepper (dxWorldProcessContext *context,
+        dxWorld *world, dxBody * const *body, int nb,
+		    dxJoint * const *_joint, int _nj, dReal stepsize);
+
 
 #endif
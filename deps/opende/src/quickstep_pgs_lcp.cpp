@@ -19,6 +19,7 @@
 * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
 *                                                                       *
 *************************************************************************/
+#include <stdint.h>
 #include <thread>
 
 #include <gazebo/ode/common.h>
@@ -40,6 +41,8 @@
 
 #include "quickstep_util.h"
 #include "quickstep_pgs_lcp.h"
+#include "quickstep_simd.h"
+#include "quickstep_worker_pool.h"
 #ifndef TIMING
 #ifdef HDF5_INSTRUMENT
 #define DUMP
@@ -49,35 +52,49 @@ std::vector<dReal> errors;
 
 using namespace ode;
 
-static void* ComputeRows(void *p)
+// Residual of the rows solved during an iteration, per type of constraint
+struct dxPGSResidual
 {
-  dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
+  // m_rms_dlambda[3] keeps track of number of constraint
+  // rows per type of constraint.
+  // m_rms_dlambda[0]: bilateral constraints (findex = -1)
+  // m_rms_dlambda[1]: contact normal constraints (findex = -2)
+  // rm_ms_dlambda[2]: friction constraints (findex >= 0)
+  int m_rms_dlambda[3];
 
-  #ifdef REPORT_THREAD_TIMING
-  int thread_id                 = params->thread_id;
-  struct timeval tv;
-  double cur_time;
-  gettimeofday(&tv,NULL);
-  cur_time = (double)tv.tv_sec + (double)tv.tv_usec / 1.e6;
-  // printf("thread %d started at time %f\n",thread_id,cur_time);
-  #endif
+  // rms of dlambda
+  dReal rms_dlambda[4];
 
+  // rms of b_i - A_ij \lambda_j as we sweep through rows
+  dReal rms_error[4];
+};
+
+static inline void ResetResidual(dxPGSResidual *residual)
+{
+  residual->m_rms_dlambda[0] = 0;
+  residual->m_rms_dlambda[1] = 0;
+  residual->m_rms_dlambda[2] = 0;
+  dSetZero(residual->rms_dlambda, 4);
+  dSetZero(residual->rms_error, 4);
+}
+
+// Update the constraint row order[i] once, and add its change to the
+// residual of the iteration. Rows startRow to startRow+nRows-1 of order
+// are the ones solved by the caller, the rows of a contact being next to
+// each other.
+static inline void SolveRow(dxPGSLCPParameters *params, const int iteration,
+  const int i, const int startRow, const int nRows, dxPGSResidual *residual
+#ifdef PENETRATION_JVERROR_CORRECTION
+  , const dReal Jvnew_final, dReal &Jvnew
+#endif
+  )
+{
   IndexError* order             = params->order;
   dxBody* const* body           = params->body;
-#ifdef RANDOMLY_REORDER_CONSTRAINTS
-#ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
-  boost::recursive_mutex* mutex = params->mutex;
-#endif
-#endif
   bool inline_position_correction = params->inline_position_correction;
   bool position_correction_thread = params->position_correction_thread;
 
   dxQuickStepParameters *qs    = params->qs;
-  int startRow                 = params->nStart;   // 0
-  int nRows                    = params->nChunkSize; // m
-#ifdef USE_1NORM
-  int m                        = params->m; // m used for rms error computation
-#endif
   int nb                       = params->nb;
 #ifdef PENETRATION_JVERROR_CORRECTION
   dReal stepsize               = params->stepsize;
@@ -107,9 +124,619 @@ static void* ComputeRows(void *p)
   dRealMutablePtr caccel_erp   = params->caccel_erp;
   dRealMutablePtr lambda_erp   = params->lambda_erp;
 
+  int num_iterations = qs->num_iterations;
+  int precon_iterations = qs->precon_iterations;
+  Friction_Model friction_model = qs->friction_model;
+  dReal smooth_contacts = qs->smooth_contacts;
+
+  int *m_rms_dlambda = residual->m_rms_dlambda;
+  dReal *rms_dlambda = residual->rms_dlambda;
+  dReal *rms_error = residual->rms_error;
+
+  dRealMutablePtr caccel_ptr1;
+  dRealMutablePtr caccel_ptr2;
+
+  /// THREAD_POSITION_CORRECTION
+  dRealMutablePtr caccel_erp_ptr1;
+  dRealMutablePtr caccel_erp_ptr2;
+
+  dRealMutablePtr cforce_ptr1;
+  dRealMutablePtr cforce_ptr2;
+
+#ifdef PENETRATION_JVERROR_CORRECTION
+  dRealMutablePtr vnew_ptr1;
+  dRealMutablePtr vnew_ptr2;
+#endif
+
+  //boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
+
+  // @@@ potential optimization: we could pre-sort J and iMJ, thereby
+  //     linearizing access to those arrays. hmmm, this does not seem
+  //     like a win, but we should think carefully about our memory
+  //     access pattern.
+
+  int index = order[i].index;
+  int constraint_index = findex[index];  // cache for efficiency
+
+  // check if we are doing extra friction_iterations, if so, only solve
+  // friction force constraints and nothing else.
+  // i.e. skip bilateral and contact normal constraints.
+  if (iteration >= (num_iterations + precon_iterations) &&
+      constraint_index < 0)
+    return;
+
+
+  dReal delta = 0;
+  dReal delta_precon = 0;
+
+  // THREAD_POSITION_CORRECTION
+  dReal delta_erp = 0;
+  // precon does not support split position correction right now.
+  // dReal delta_precon_erp = 0;
+
+  // setup pointers
+  int b1 = jb[index*2];
+  int b2 = jb[index*2+1];
+
+  // for precon
+  {
+    cforce_ptr1 = cforce + 6*b1;
+    if (b2 >= 0)
+    {
+      cforce_ptr2     = cforce + 6*b2;
+    }
+    else
+    {
+      cforce_ptr2     = NULL;
+    }
+  }
+
+  // for non-precon
+  {
+    caccel_ptr1 = caccel + 6*b1;
+    if (b2 >= 0)
+    {
+      caccel_ptr2     = caccel + 6*b2;
+    }
+    else
+    {
+      caccel_ptr2     = NULL;
+    }
+
+    if (inline_position_correction)
+    {
+      caccel_erp_ptr1 = caccel_erp + 6*b1;
+      if (b2 >= 0)
+      {
+        caccel_erp_ptr2     = caccel_erp + 6*b2;
+      }
+      else
+      {
+        caccel_erp_ptr2     = NULL;
+      }
+    }
+  }
+  dReal old_lambda        = lambda[index];
+
+  /// THREAD_POSITION_CORRECTION
+  dReal old_lambda_erp;
+  if (inline_position_correction)
+    old_lambda_erp    = lambda_erp[index];
+
+#ifdef PENETRATION_JVERROR_CORRECTION
+  // 4/4 optional pointers for jverror correction
+  vnew_ptr1 = vnew + 6*b1;
+  vnew_ptr2 = (b2 >= 0) ? vnew + 6*b2 : NULL;
+#endif
+
+
+  //
+  // caccel is the constraint accel in the non-precon case
+  // cforce is the constraint force in the     precon case
+  // J_precon and J differs essentially in Ad and Ad_precon,
+  //  Ad is derived from diagonal of J inv(M) J'
+  //  Ad_precon is derived from diagonal of J J'
+  //
+  if (iteration < precon_iterations)
+  {
+    // preconditioning
+
+    // update delta_precon
+    delta_precon = rhs_precon[index] - old_lambda*Adcfm_precon[index];
+
+    dRealPtr J_ptr = J_precon + index*12;
+
+    // for preconditioned case, update delta using cforce, not caccel
+
+    delta_precon -= quickstep::dot6(cforce_ptr1, J_ptr);
+    if (cforce_ptr2)
+      delta_precon -= quickstep::dot6(cforce_ptr2, J_ptr + 6);
+
+    // set the limits for this constraint.
+    // this is the place where the QuickStep method differs from the
+    // direct LCP solving method, since that method only performs this
+    // limit adjustment once per time step, whereas this method performs
+    // once per iteration per constraint row.
+    // the constraints are ordered so that all lambda[] values needed have
+    // already been computed.
+    dReal hi_act, lo_act;
+    if (constraint_index >= 0) {
+      hi_act = dFabs (hi[index] * lambda[constraint_index]);
+      lo_act = -hi_act;
+    } else {
+      hi_act = hi[index];
+      lo_act = lo[index];
+    }
+
+    // compute lambda and clamp it to [lo,hi].
+    // @@@ SSE is used to speed up vector math
+    // operations with gcc compiler when defined
+    // but SSE is not a win here, #undef for now
+#undef SSE_CLAMP
+#ifndef SSE_CLAMP
+    lambda[index] = old_lambda+ delta_precon;
+    if (lambda[index] < lo_act) {
+      delta_precon = lo_act-old_lambda;
+      lambda[index] = lo_act;
+    }
+    else if (lambda[index] > hi_act) {
+      delta_precon = hi_act-old_lambda;
+      lambda[index] = hi_act;
+    }
+#else
+    dReal nl = old_lambda+ delta_precon;
+    _mm_store_sd(&nl, _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
+      _mm_load_sd(&hi_act)), _mm_load_sd(&lo_act)));
+    lambda[index] = nl;
+    delta_precon = nl - old_lambda;
+#endif
+
+    // update cforce (this is strictly for the precon case)
+    {
+      // for preconditioning case, compute cforce
+      // FIXME: need un-altered unscaled J, not J_precon!!
+      J_ptr = J_orig + index*12;
+
+      // update cforce.
+      quickstep::sum6(cforce_ptr1, delta_precon, J_ptr);
+      if (cforce_ptr2)
+        quickstep::sum6(cforce_ptr2, delta_precon, J_ptr + 6);
+    }
+
+    // record residual (error) (for the non-erp version)
+    // given
+    //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
+    // define scalar Ad:
+    //   Ad = sor / (A_ii + cfm)
+    // then
+    //   dlambda = Ad  * (b_i - A_ij * lambda_j)
+    // thus, to get residual from dlambda,
+    //   residual = dlambda / Ad
+    // or
+    //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
+    //   where Ad2 = 1/(Ad * Ad)
+    dReal Ad2 = 0.0;
+    if (!_dequal(Ad[index], 0.0))
+    {
+      // Ad[i] = sor_w / (sum + cfm[i]);
+      Ad2 = 1.0 / (Ad[index] * Ad[index]);
+    }
+    else
+    {
+      // TODO: Usually, this means qs->w (SOR param) is zero.
+      // Residual calculation is wrong when SOR (w) is zero
+      // Given SOR is rarely 0, we'll set residual as 0 for now.
+      // To do this properly, we should compute dlambda without sor
+      // then use the Ad without SOR to back out residual.
+    }
+
+    dReal delta_precon2 = delta_precon*delta_precon;
+    if (constraint_index == -1)  // bilateral
+    {
+      rms_dlambda[0] += delta_precon2;
+      rms_error[0] += delta_precon2*Ad2;
+      m_rms_dlambda[0]++;
+    }
+    else if (constraint_index == -2)  // contact normal
+    {
+      rms_dlambda[1] += delta_precon2;
+      rms_error[1] += delta_precon2*Ad2;
+      m_rms_dlambda[1]++;
+    }
+    else  // friction forces
+    {
+      rms_dlambda[2] += delta_precon2;
+      rms_error[2] += delta_precon2*Ad2;
+      m_rms_dlambda[2]++;
+    }
+
+    // initialize position correction terms (_erp) with precon results
+    if (inline_position_correction)
+    {
+      old_lambda_erp = old_lambda;
+      lambda_erp[index] = lambda[index];
+    }
+  }
+  else
+  {
+    if (!skip_friction || constraint_index < 0)
+    {
+      // NOTE:
+      // for this update, we need not throw away J*v(n+1)/h term from rhs
+      //   ...so adding it back, but remember rhs has already been
+      //      scaled by Ad_i, so we need to do the same to J*v(n+1)/h
+      //      but given that J is already scaled by Ad_i, we don't have
+      //      to do it explicitly here
+
+      // delta: erp throttled by info.c_v_max or info.c
+      delta =
+#ifdef PENETRATION_JVERROR_CORRECTION
+             Jvnew_final +
+#endif
+            rhs[index] - old_lambda*Adcfm[index];
+      dRealPtr J_ptr = J + index*12;
+      delta -= quickstep::dot6(caccel_ptr1, J_ptr);
+      if (caccel_ptr2)
+        delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
+
+      if (inline_position_correction)
+      {
+        delta_erp = rhs_erp[index] - old_lambda_erp*Adcfm[index];
+        delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
+        if (caccel_ptr2)
+          delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
+      }
+
+    // set the limits for this constraint.
+    // this is the place where the QuickStep method differs from the
+    // direct LCP solving method, since that method only performs this
+    // limit adjustment once per time step, whereas this method performs
+    // once per iteration per constraint row.
+    // the constraints are ordered so that all lambda[] values needed have
+    // already been computed.
+    dReal hi_act, lo_act;
+    /// THREAD_POSITION_CORRECTION
+    dReal hi_act_erp, lo_act_erp;
+    if (constraint_index >= 0)
+    {
+      if (index - constraint_index >= 3)
+      {
+        // torsional friction should have been added as the third row from
+        // contact normal constraint
+        // this_is_torsional_friction
+        hi_act = dFabs (hi[index] * lambda[constraint_index]);
+        lo_act = -hi_act;
+        if (inline_position_correction)
+        {
+          hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
+          lo_act_erp = -hi_act_erp;
+        }
+      }
+      else
+      {
+        // deal with non-torsional frictions
+        if (friction_model == pyramid_friction)
+        {
+          // FOR erp throttled by info.c_v_max or info.c
+          hi_act = dFabs (hi[index] * lambda[constraint_index]);
+          lo_act = -hi_act;
+          if (inline_position_correction)
+          {
+            hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
+            lo_act_erp = -hi_act_erp;
+          }
+        }
+        else if (friction_model == cone_friction)
+        {
+          quickstep::dxConeFrictionModel(lo_act, hi_act, lo_act_erp, hi_act_erp, jb, J_orig, index,
+              constraint_index, startRow, nRows, nb, body, i, order, findex, NULL, hi, lambda, lambda_erp);
+        }
+        else if(friction_model == box_friction)
+        {
+          hi_act = hi[index];
+          lo_act = -hi_act;
+          hi_act_erp = hi[index];
+          lo_act_erp = -hi_act_erp;
+        }
+        else
+        {
+            // initialize the hi and lo to get rid of warnings
+            hi_act = dInfinity;
+            lo_act = -dInfinity;
+            hi_act_erp = dInfinity;
+            lo_act_erp = -dInfinity;
+            dMessage (d_ERR_UASSERT, "internal error, undefined friction model");
+        }
+      }
+    }
+    else
+    {
+      // FOR erp throttled by info.c_v_max or info.c
+      hi_act = hi[index];
+      lo_act = lo[index];
+      if (inline_position_correction)
+      {
+        hi_act_erp = hi[index];
+        lo_act_erp = lo[index];
+      }
+    }
+    // compute lambda and clamp it to [lo,hi].
+    // @@@ SSE not a win here
+#undef SSE_CLAMP
+#ifndef SSE_CLAMP
+      // FOR erp throttled by info.c_v_max or info.c
+      lambda[index] = old_lambda + delta;
+      if (lambda[index] < lo_act) {
+        delta = lo_act-old_lambda;
+        lambda[index] = lo_act;
+      }
+      else if (lambda[index] > hi_act) {
+        delta = hi_act-old_lambda;
+        lambda[index] = hi_act;
+      }
+
+      if (inline_position_correction)
+      {
+        lambda_erp[index] = old_lambda_erp + delta_erp;
+        if (lambda_erp[index] < lo_act_erp) {
+          delta_erp = lo_act_erp-old_lambda_erp;
+          lambda_erp[index] = lo_act_erp;
+        }
+        else if (lambda_erp[index] > hi_act_erp) {
+          delta_erp = hi_act_erp-old_lambda_erp;
+          lambda_erp[index] = hi_act_erp;
+        }
+      }
+#else
+      // FOR erp throttled by info.c_v_max or info.c
+      dReal nl = old_lambda + delta;
+      _mm_store_sd(&nl,
+                   _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
+                   _mm_load_sd(&hi_act)),
+                   _mm_load_sd(&lo_act)));
+      lambda[index] = nl;
+      delta = nl - old_lambda;
+
+      if (inline_position_correction)
+      {
+        dReal nl_erp = old_lambda_erp + delta_erp;
+        _mm_store_sd(&nl_erp,
+                     _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl_erp),
+                     _mm_load_sd(&hi_act_erp)),
+                     _mm_load_sd(&lo_act_erp)));
+        lambda_erp[index] = nl_erp;
+        delta_erp = nl_erp - old_lambda_erp;
+      }
+#endif
+
+      // option to smooth lambda
+#ifdef SMOOTH_LAMBDA
+      // skip smoothing for the position correction thread
+      if (!position_correction_thread)
+      {
+        // smooth delta lambda
+        // equivalent to first order artificial dissipation on lambda update.
+
+        // debug smoothing
+        // if (i == 0)
+        //   printf("rhs[%f] adcfm[%f]: ",rhs[index], Adcfm[index]);
+        // if (i == 0)
+        //   printf("dlambda iter[%d]: ",iteration);
+        // printf(" %f ", lambda[index]-old_lambda);
+        // if (i == startRow + nRows - 1)
+        //   printf("\n");
+
+        // extra residual smoothing for contact constraints
+        // was smoothing both contact normal and friction constraints for VRC
+        // if (constraint_index != -1)
+        // smooth only lambda for friction directions fails friction_demo.world
+        if (constraint_index != -1)
+        {
+          lambda[index] = (1.0 - smooth_contacts)*lambda[index]
+            + smooth_contacts*old_lambda;
+        }
+
+        // if (inline_position_correction)
+        // {
+        //   /// not smoothing lambda_erp
+        // }
+      }
+#endif
+
+      // update caccel
+      {
+        // FOR erp throttled by info.c_v_max or info.c
+        dRealPtr iMJ_ptr = iMJ + index*12;
+
+        // update caccel.
+        quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
+        if (caccel_ptr2)
+          quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
+
+        if (inline_position_correction)
+        {
+          quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
+          if (caccel_erp_ptr2)
+            quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
+        }
+      }
+    }  // end of skip friction check
+
+#ifdef PENETRATION_JVERROR_CORRECTION
+    {
+      // FOR erp throttled by info.c_v_max or info.c
+      dRealPtr iMJ_ptr = iMJ + index*12;
+      // update vnew incrementally
+      //   add stepsize * delta_caccel to the body velocity
+      //   vnew = vnew + dt * delta_caccel
+      quickstep::sum6(vnew_ptr1, stepsize*delta, iMJ_ptr);
+      if (caccel_ptr2)
+        quickstep::sum6(vnew_ptr2, stepsize*delta, iMJ_ptr + 6);
+
+      // COMPUTE Jvnew = J*vnew/h*Ad
+      //   but J is already scaled by Ad, and we multiply by h later
+      //   so it's just Jvnew = J*vnew here
+      if (iteration >= num_iterations-7) {
+        // check for non-contact bilateral constraints only
+        // I've set findex to -2 for contact normal constraint
+        if (constraint_index == -1) {
+          dRealPtr J_ptr = J + index*12;
+          Jvnew = quickstep::dot6(vnew_ptr1,J_ptr);
+          if (caccel_ptr2)
+            Jvnew += quickstep::dot6(vnew_ptr2,J_ptr+6);
+          // printf("iter [%d] findex [%d] Jvnew [%f] lo [%f] hi [%f]\n",
+          //   iteration, constraint_index, Jvnew, lo[index], hi[index]);
+        }
+      }
+      //printf("iter [%d] vnew [%f,%f,%f,%f,%f,%f] Jvnew [%f]\n",
+      //       iteration,
+      //       vnew_ptr1[0], vnew_ptr1[1], vnew_ptr1[2],
+      //       vnew_ptr1[3], vnew_ptr1[4], vnew_ptr1[5],Jvnew);
+    }
+#endif
+
+
+    //////////////////////////////////////////////////////
+    // record residual (error) (for the non-erp version)
+    //////////////////////////////////////////////////////
+    // given
+    //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
+    // define scalar Ad:
+    //   Ad = sor / (A_ii + cfm)
+    // then
+    //   dlambda = Ad  * (b_i - A_ij * lambda_j)
+    // thus, to get residual from dlambda,
+    //   residual = dlambda / Ad
+    // or
+    //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
+    //   where Ad2 = 1/(Ad * Ad)
+    dReal Ad2 = 0.0;
+    if (!_dequal(Ad[index], 0.0))
+    {
+      // Ad[i] = sor_w / (sum + cfm[i]);
+      Ad2 = 1.0 / (Ad[index] * Ad[index]);
+    }
+    else
+    {
+      // TODO: Usually, this means qs->w (SOR param) is zero.
+      // Residual calculation is wrong when SOR (w) is zero
+      // Given SOR is rarely 0, we'll set residual as 0 for now.
+      // To do this properly, we should compute dlambda without sor
+      // then use the Ad without SOR to back out residual.
+    }
+
+    dReal delta2 = delta*delta;
+    if (constraint_index == -1)  // bilateral
+    {
+      rms_dlambda[0] += delta2;
+      rms_error[0] += delta2*Ad2;
+      m_rms_dlambda[0]++;
+    }
+    else if (constraint_index == -2)  // contact normal
+    {
+      rms_dlambda[1] += delta2;
+      rms_error[1] += delta2*Ad2;
+      m_rms_dlambda[1]++;
+    }
+    else  // friction forces
+    {
+      rms_dlambda[2] += delta2;
+      rms_error[2] += delta2*Ad2;
+      m_rms_dlambda[2]++;
+    }
+  } // end of non-precon
+
+  //@@@ a trick that may or may not help
+  //dReal ramp = (1-((dReal)(iteration+1)/(dReal)iterations));
+  //delta *= ramp;
+}
+
+// Store the rms of the residual of an iteration in qs.
+static void StoreResidual(dxQuickStepParameters *qs,
+  const dxPGSResidual *residual)
+{
+  const int *m_rms_dlambda = residual->m_rms_dlambda;
+  const dReal *rms_dlambda = residual->rms_dlambda;
+  const dReal *rms_error = residual->rms_error;
+
+  dReal dlambda_bilateral_mean = 0.0;
+  dReal dlambda_contact_normal_mean = 0.0;
+  dReal dlambda_contact_friction_mean = 0.0;
+  dReal dlambda_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
+  if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
+    dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
+  qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
+  qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
+  qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
+
+  dReal residual_bilateral_mean = 0.0;
+  dReal residual_contact_normal_mean = 0.0;
+  dReal residual_contact_friction_mean = 0.0;
+  dReal residual_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
+  if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
+    residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
+  qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
+  qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
+  qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
+  qs->num_contacts = m_rms_dlambda[1];
+}
+
+static void* ComputeRows(void *p)
+{
+  dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
+
+  #ifdef REPORT_THREAD_TIMING
+  int thread_id                 = params->thread_id;
+  struct timeval tv;
+  double cur_time;
+  gettimeofday(&tv,NULL);
+  cur_time = (double)tv.tv_sec + (double)tv.tv_usec / 1.e6;
+  // printf("thread %d started at time %f\n",thread_id,cur_time);
+  #endif
+
+#if defined(REORDER_CONSTRAINTS) || defined(RANDOMLY_REORDER_CONSTRAINTS)
+  IndexError* order             = params->order;
+#endif
+#ifdef RANDOMLY_REORDER_CONSTRAINTS
+#ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
+  boost::recursive_mutex* mutex = params->mutex;
+#endif
+#endif
+  bool position_correction_thread = params->position_correction_thread;
+
+  dxQuickStepParameters *qs    = params->qs;
+  int startRow                 = params->nStart;   // 0
+  int nRows                    = params->nChunkSize; // m
+#ifdef PENETRATION_JVERROR_CORRECTION
+  dReal stepsize               = params->stepsize;
+#endif
 #ifdef REORDER_CONSTRAINTS
+  const int* findex            = params->findex;
   dRealMutablePtr last_lambda  = params->last_lambda;
 #endif
+#if defined(REORDER_CONSTRAINTS) || defined(SHOW_CONVERGENCE)
+  dRealMutablePtr lambda       = params->lambda;
+#endif
 
   //printf("iiiiiiiii %d %d %d\n",thread_id,jb[0],jb[1]);
   //for (int i=startRow; i<startRow+nRows; i++) // swap within boundary of our own segment
@@ -154,31 +781,18 @@ static void* ComputeRows(void *p)
   for (int i=startRow; i<startRow+nRows; i++)
     printf("  %12.6f",rhs[i]);
   printf("\n");
-  */
-
-  // m_rms_dlambda[3] keeps track of number of constraint
-  // rows per type of constraint.
-  // m_rms_dlambda[0]: bilateral constraints (findex = -1)
-  // m_rms_dlambda[1]: contact normal constraints (findex = -2)
-  // rm_ms_dlambda[2]: friction constraints (findex >= 0)
-  int m_rms_dlambda[3];
-  m_rms_dlambda[0] = 0;
-  m_rms_dlambda[1] = 0;
-  m_rms_dlambda[2] = 0;
+  */
 
-  // rms of dlambda
-  dReal rms_dlambda[4];
-  dSetZero(rms_dlambda, 4);
-  // rms of b_i - A_ij \lambda_j as we sweep through rows
-  dReal rms_error[4];
-  dSetZero(rms_error, 4);
+  dxPGSResidual residual;
+  ResetResidual(&residual);
+  int *m_rms_dlambda = residual.m_rms_dlambda;
+  dReal *rms_dlambda = residual.rms_dlambda;
+  dReal *rms_error = residual.rms_error;
 
   int num_iterations = qs->num_iterations;
   int precon_iterations = qs->precon_iterations;
   dReal pgs_lcp_tolerance = qs->pgs_lcp_tolerance;
   int friction_iterations = qs->friction_iterations;
-  Friction_Model friction_model = qs->friction_model;
-  dReal smooth_contacts = qs->smooth_contacts;
 
 #ifdef SHOW_CONVERGENCE
     // show starting lambda
@@ -194,15 +808,6 @@ static void* ComputeRows(void *p)
 #ifdef HDF5_INSTRUMENT
   errors.resize(num_iterations + precon_iterations + friction_iterations);
 #endif
-  dRealMutablePtr caccel_ptr1;
-  dRealMutablePtr caccel_ptr2;
-
-  /// THREAD_POSITION_CORRECTION
-  dRealMutablePtr caccel_erp_ptr1;
-  dRealMutablePtr caccel_erp_ptr2;
-
-  dRealMutablePtr cforce_ptr1;
-  dRealMutablePtr cforce_ptr2;
   int total_iterations = precon_iterations + num_iterations +
     friction_iterations;
   for (int iteration = 0; iteration < total_iterations; ++iteration)
@@ -296,515 +901,16 @@ static void* ComputeRows(void *p)
 #endif
 
 #ifdef PENETRATION_JVERROR_CORRECTION
-    dRealMutablePtr vnew_ptr1;
-    dRealMutablePtr vnew_ptr2;
     const dReal stepsize1 = dRecip(stepsize);
     dReal Jvnew = 0;
 #endif
     for (int i=startRow; i<startRow+nRows; i++) {
-      //boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
-
-      // @@@ potential optimization: we could pre-sort J and iMJ, thereby
-      //     linearizing access to those arrays. hmmm, this does not seem
-      //     like a win, but we should think carefully about our memory
-      //     access pattern.
-
-      int index = order[i].index;
-      int constraint_index = findex[index];  // cache for efficiency
-
-      // check if we are doing extra friction_iterations, if so, only solve
-      // friction force constraints and nothing else.
-      // i.e. skip bilateral and contact normal constraints.
-      if (iteration >= (num_iterations + precon_iterations) &&
-          constraint_index < 0)
-        continue;
-
-
-      dReal delta = 0;
-      dReal delta_precon = 0;
-
-      // THREAD_POSITION_CORRECTION
-      dReal delta_erp = 0;
-      // precon does not support split position correction right now.
-      // dReal delta_precon_erp = 0;
-
-      // setup pointers
-      int b1 = jb[index*2];
-      int b2 = jb[index*2+1];
-
-      // for precon
-      {
-        cforce_ptr1 = cforce + 6*b1;
-        if (b2 >= 0)
-        {
-          cforce_ptr2     = cforce + 6*b2;
-        }
-        else
-        {
-          cforce_ptr2     = NULL;
-        }
-      }
-
-      // for non-precon
-      {
-        caccel_ptr1 = caccel + 6*b1;
-        if (b2 >= 0)
-        {
-          caccel_ptr2     = caccel + 6*b2;
-        }
-        else
-        {
-          caccel_ptr2     = NULL;
-        }
-
-        if (inline_position_correction)
-        {
-          caccel_erp_ptr1 = caccel_erp + 6*b1;
-          if (b2 >= 0)
-          {
-            caccel_erp_ptr2     = caccel_erp + 6*b2;
-          }
-          else
-          {
-            caccel_erp_ptr2     = NULL;
-          }
-        }
-      }
-      dReal old_lambda        = lambda[index];
-
-      /// THREAD_POSITION_CORRECTION
-      dReal old_lambda_erp;
-      if (inline_position_correction)
-        old_lambda_erp    = lambda_erp[index];
-
-#ifdef PENETRATION_JVERROR_CORRECTION
-      // 4/4 optional pointers for jverror correction
-      vnew_ptr1 = vnew + 6*b1;
-      vnew_ptr2 = (b2 >= 0) ? vnew + 6*b2 : NULL;
-#endif
-
-
-      //
-      // caccel is the constraint accel in the non-precon case
-      // cforce is the constraint force in the     precon case
-      // J_precon and J differs essentially in Ad and Ad_precon,
-      //  Ad is derived from diagonal of J inv(M) J'
-      //  Ad_precon is derived from diagonal of J J'
-      //
-      if (iteration < precon_iterations)
-      {
-        // preconditioning
-
-        // update delta_precon
-        delta_precon = rhs_precon[index] - old_lambda*Adcfm_precon[index];
-
-        dRealPtr J_ptr = J_precon + index*12;
-
-        // for preconditioned case, update delta using cforce, not caccel
-
-        delta_precon -= quickstep::dot6(cforce_ptr1, J_ptr);
-        if (cforce_ptr2)
-          delta_precon -= quickstep::dot6(cforce_ptr2, J_ptr + 6);
-
-        // set the limits for this constraint.
-        // this is the place where the QuickStep method differs from the
-        // direct LCP solving method, since that method only performs this
-        // limit adjustment once per time step, whereas this method performs
-        // once per iteration per constraint row.
-        // the constraints are ordered so that all lambda[] values needed have
-        // already been computed.
-        dReal hi_act, lo_act;
-        if (constraint_index >= 0) {
-          hi_act = dFabs (hi[index] * lambda[constraint_index]);
-          lo_act = -hi_act;
-        } else {
-          hi_act = hi[index];
-          lo_act = lo[index];
-        }
-
-        // compute lambda and clamp it to [lo,hi].
-        // @@@ SSE is used to speed up vector math
-        // operations with gcc compiler when defined
-        // but SSE is not a win here, #undef for now
-#undef SSE_CLAMP
-#ifndef SSE_CLAMP
-        lambda[index] = old_lambda+ delta_precon;
-        if (lambda[index] < lo_act) {
-          delta_precon = lo_act-old_lambda;
-          lambda[index] = lo_act;
-        }
-        else if (lambda[index] > hi_act) {
-          delta_precon = hi_act-old_lambda;
-          lambda[index] = hi_act;
-        }
-#else
-        dReal nl = old_lambda+ delta_precon;
-        _mm_store_sd(&nl, _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
-          _mm_load_sd(&hi_act)), _mm_load_sd(&lo_act)));
-        lambda[index] = nl;
-        delta_precon = nl - old_lambda;
-#endif
-
-        // update cforce (this is strictly for the precon case)
-        {
-          // for preconditioning case, compute cforce
-          // FIXME: need un-altered unscaled J, not J_precon!!
-          J_ptr = J_orig + index*12;
-
-          // update cforce.
-          quickstep::sum6(cforce_ptr1, delta_precon, J_ptr);
-          if (cforce_ptr2)
-            quickstep::sum6(cforce_ptr2, delta_precon, J_ptr + 6);
-        }
-
-        // record residual (error) (for the non-erp version)
-        // given
-        //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
-        // define scalar Ad:
-        //   Ad = sor / (A_ii + cfm)
-        // then
-        //   dlambda = Ad  * (b_i - A_ij * lambda_j)
-        // thus, to get residual from dlambda,
-        //   residual = dlambda / Ad
-        // or
-        //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
-        //   where Ad2 = 1/(Ad * Ad)
-        dReal Ad2 = 0.0;
-        if (!_dequal(Ad[index], 0.0))
-        {
-          // Ad[i] = sor_w / (sum + cfm[i]);
-          Ad2 = 1.0 / (Ad[index] * Ad[index]);
-        }
-        else
-        {
-          // TODO: Usually, this means qs->w (SOR param) is zero.
-          // Residual calculation is wrong when SOR (w) is zero
-          // Given SOR is rarely 0, we'll set residual as 0 for now.
-          // To do this properly, we should compute dlambda without sor
-          // then use the Ad without SOR to back out residual.
-        }
-
-        dReal delta_precon2 = delta_precon*delta_precon;
-        if (constraint_index == -1)  // bilateral
-        {
-          rms_dlambda[0] += delta_precon2;
-          rms_error[0] += delta_precon2*Ad2;
-          m_rms_dlambda[0]++;
-        }
-        else if (constraint_index == -2)  // contact normal
-        {
-          rms_dlambda[1] += delta_precon2;
-          rms_error[1] += delta_precon2*Ad2;
-          m_rms_dlambda[1]++;
-        }
-        else  // friction forces
-        {
-          rms_dlambda[2] += delta_precon2;
-          rms_error[2] += delta_precon2*Ad2;
-          m_rms_dlambda[2]++;
-        }
-
-        // initialize position correction terms (_erp) with precon results
-        if (inline_position_correction)
-        {
-          old_lambda_erp = old_lambda;
-          lambda_erp[index] = lambda[index];
-        }
-      }
-      else
-      {
-        if (!skip_friction || constraint_index < 0)
-        {
-          // NOTE:
-          // for this update, we need not throw away J*v(n+1)/h term from rhs
-          //   ...so adding it back, but remember rhs has already been
-          //      scaled by Ad_i, so we need to do the same to J*v(n+1)/h
-          //      but given that J is already scaled by Ad_i, we don't have
-          //      to do it explicitly here
-
-          // delta: erp throttled by info.c_v_max or info.c
-          delta =
-#ifdef PENETRATION_JVERROR_CORRECTION
-                 Jvnew_final +
-#endif
-                rhs[index] - old_lambda*Adcfm[index];
-          dRealPtr J_ptr = J + index*12;
-          delta -= quickstep::dot6(caccel_ptr1, J_ptr);
-          if (caccel_ptr2)
-            delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
-
-          if (inline_position_correction)
-          {
-            delta_erp = rhs_erp[index] - old_lambda_erp*Adcfm[index];
-            delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
-            if (caccel_ptr2)
-              delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
-          }
-
-        // set the limits for this constraint.
-        // this is the place where the QuickStep method differs from the
-        // direct LCP solving method, since that method only performs this
-        // limit adjustment once per time step, whereas this method performs
-        // once per iteration per constraint row.
-        // the constraints are ordered so that all lambda[] values needed have
-        // already been computed.
-        dReal hi_act, lo_act;
-        /// THREAD_POSITION_CORRECTION
-        dReal hi_act_erp, lo_act_erp;
-        if (constraint_index >= 0)
-        {
-          if (index - constraint_index >= 3)
-          {
-            // torsional friction should have been added as the third row from
-            // contact normal constraint
-            // this_is_torsional_friction
-            hi_act = dFabs (hi[index] * lambda[constraint_index]);
-            lo_act = -hi_act;
-            if (inline_position_correction)
-            {
-              hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
-              lo_act_erp = -hi_act_erp;
-            }
-          }
-          else
-          {
-            // deal with non-torsional frictions
-            if (friction_model == pyramid_friction)
-            {
-              // FOR erp throttled by info.c_v_max or info.c
-              hi_act = dFabs (hi[index] * lambda[constraint_index]);
-              lo_act = -hi_act;
-              if (inline_position_correction)
-              {
-                hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
-                lo_act_erp = -hi_act_erp;
-              }
-            }
-            else if (friction_model == cone_friction)
-            {
-              quickstep::dxConeFrictionModel(lo_act, hi_act, lo_act_erp, hi_act_erp, jb, J_orig, index,
-                  constraint_index, startRow, nRows, nb, body, i, order, findex, NULL, hi, lambda, lambda_erp);
-            }
-            else if(friction_model == box_friction)
-            {
-              hi_act = hi[index];
-              lo_act = -hi_act;
-              hi_act_erp = hi[index];
-              lo_act_erp = -hi_act_erp;
-            }
-            else
-            {
-                // initialize the hi and lo to get rid of warnings
-                hi_act = dInfinity;
-                lo_act = -dInfinity;
-                hi_act_erp = dInfinity;
-                lo_act_erp = -dInfinity;
-                dMessage (d_ERR_UASSERT, "internal error, undefined friction model");
-            }
-          }
-        }
-        else
-        {
-          // FOR erp throttled by info.c_v_max or info.c
-          hi_act = hi[index];
-          lo_act = lo[index];
-          if (inline_position_correction)
-          {
-            hi_act_erp = hi[index];
-            lo_act_erp = lo[index];
-          }
-        }
-        // compute lambda and clamp it to [lo,hi].
-        // @@@ SSE not a win here
-#undef SSE_CLAMP
-#ifndef SSE_CLAMP
-          // FOR erp throttled by info.c_v_max or info.c
-          lambda[index] = old_lambda + delta;
-          if (lambda[index] < lo_act) {
-            delta = lo_act-old_lambda;
-            lambda[index] = lo_act;
-          }
-          else if (lambda[index] > hi_act) {
-            delta = hi_act-old_lambda;
-            lambda[index] = hi_act;
-          }
-
-          if (inline_position_correction)
-          {
-            lambda_erp[index] = old_lambda_erp + delta_erp;
-            if (lambda_erp[index] < lo_act_erp) {
-              delta_erp = lo_act_erp-old_lambda_erp;
-              lambda_erp[index] = lo_act_erp;
-            }
-            else if (lambda_erp[index] > hi_act_erp) {
-              delta_erp = hi_act_erp-old_lambda_erp;
-              lambda_erp[index] = hi_act_erp;
-            }
-          }
-#else
-          // FOR erp throttled by info.c_v_max or info.c
-          dReal nl = old_lambda + delta;
-          _mm_store_sd(&nl,
-                       _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
-                       _mm_load_sd(&hi_act)),
-                       _mm_load_sd(&lo_act)));
-          lambda[index] = nl;
-          delta = nl - old_lambda;
-
-          if (inline_position_correction)
-          {
-            dReal nl_erp = old_lambda_erp + delta_erp;
-            _mm_store_sd(&nl_erp,
-                         _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl_erp),
-                         _mm_load_sd(&hi_act_erp)),
-                         _mm_load_sd(&lo_act_erp)));
-            lambda_erp[index] = nl_erp;
-            delta_erp = nl_erp - old_lambda_erp;
-          }
-#endif
-
-          // option to smooth lambda
-#ifdef SMOOTH_LAMBDA
-          // skip smoothing for the position correction thread
-          if (!position_correction_thread)
-          {
-            // smooth delta lambda
-            // equivalent to first order artificial dissipation on lambda update.
-
-            // debug smoothing
-            // if (i == 0)
-            //   printf("rhs[%f] adcfm[%f]: ",rhs[index], Adcfm[index]);
-            // if (i == 0)
-            //   printf("dlambda iter[%d]: ",iteration);
-            // printf(" %f ", lambda[index]-old_lambda);
-            // if (i == startRow + nRows - 1)
-            //   printf("\n");
-
-            // extra residual smoothing for contact constraints
-            // was smoothing both contact normal and friction constraints for VRC
-            // if (constraint_index != -1)
-            // smooth only lambda for friction directions fails friction_demo.world
-            if (constraint_index != -1)
-            {
-              lambda[index] = (1.0 - smooth_contacts)*lambda[index]
-                + smooth_contacts*old_lambda;
-            }
-
-            // if (inline_position_correction)
-            // {
-            //   /// not smoothing lambda_erp
-            // }
-          }
-#endif
-
-          // update caccel
-          {
-            // FOR erp throttled by info.c_v_max or info.c
-            dRealPtr iMJ_ptr = iMJ + index*12;
-
-            // update caccel.
-            quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
-            if (caccel_ptr2)
-              quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
-
-            if (inline_position_correction)
-            {
-              quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
-              if (caccel_erp_ptr2)
-                quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
-            }
-          }
-        }  // end of skip friction check
-
+      SolveRow(params, iteration, i, startRow, nRows, &residual
 #ifdef PENETRATION_JVERROR_CORRECTION
-        {
-          // FOR erp throttled by info.c_v_max or info.c
-          dRealPtr iMJ_ptr = iMJ + index*12;
-          // update vnew incrementally
-          //   add stepsize * delta_caccel to the body velocity
-          //   vnew = vnew + dt * delta_caccel
-          quickstep::sum6(vnew_ptr1, stepsize*delta, iMJ_ptr);
-          if (caccel_ptr2)
-            quickstep::sum6(vnew_ptr2, stepsize*delta, iMJ_ptr + 6);
-
-          // COMPUTE Jvnew = J*vnew/h*Ad
-          //   but J is already scaled by Ad, and we multiply by h later
-          //   so it's just Jvnew = J*vnew here
-          if (iteration >= num_iterations-7) {
-            // check for non-contact bilateral constraints only
-            // I've set findex to -2 for contact normal constraint
-            if (constraint_index == -1) {
-              dRealPtr J_ptr = J + index*12;
-              Jvnew = quickstep::dot6(vnew_ptr1,J_ptr);
-              if (caccel_ptr2)
-                Jvnew += quickstep::dot6(vnew_ptr2,J_ptr+6);
-              // printf("iter [%d] findex [%d] Jvnew [%f] lo [%f] hi [%f]\n",
-              //   iteration, constraint_index, Jvnew, lo[index], hi[index]);
-            }
-          }
-          //printf("iter [%d] vnew [%f,%f,%f,%f,%f,%f] Jvnew [%f]\n",
-          //       iteration,
-          //       vnew_ptr1[0], vnew_ptr1[1], vnew_ptr1[2],
-          //       vnew_ptr1[3], vnew_ptr1[4], vnew_ptr1[5],Jvnew);
-        }
+               , Jvnew_final, Jvnew
 #endif
-
-
-        //////////////////////////////////////////////////////
-        // record residual (error) (for the non-erp version)
-        //////////////////////////////////////////////////////
-        // given
-        //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
-        // define scalar Ad:
-        //   Ad = sor / (A_ii + cfm)
-        // then
-        //   dlambda = Ad  * (b_i - A_ij * lambda_j)
-        // thus, to get residual from dlambda,
-        //   residual = dlambda / Ad
-        // or
-        //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
-        //   where Ad2 = 1/(Ad * Ad)
-        dReal Ad2 = 0.0;
-        if (!_dequal(Ad[index], 0.0))
-        {
-          // Ad[i] = sor_w / (sum + cfm[i]);
-          Ad2 = 1.0 / (Ad[index] * Ad[index]);
-        }
-        else
-        {
-          // TODO: Usually, this means qs->w (SOR param) is zero.
-          // Residual calculation is wrong when SOR (w) is zero
-          // Given SOR is rarely 0, we'll set residual as 0 for now.
-          // To do this properly, we should compute dlambda without sor
-          // then use the Ad without SOR to back out residual.
-        }
-
-        dReal delta2 = delta*delta;
-        if (constraint_index == -1)  // bilateral
-        {
-          rms_dlambda[0] += delta2;
-          rms_error[0] += delta2*Ad2;
-          m_rms_dlambda[0]++;
-        }
-        else if (constraint_index == -2)  // contact normal
-        {
-          rms_dlambda[1] += delta2;
-          rms_error[1] += delta2*Ad2;
-          m_rms_dlambda[1]++;
-        }
-        else  // friction forces
-        {
-          rms_dlambda[2] += delta2;
-          rms_error[2] += delta2*Ad2;
-          m_rms_dlambda[2]++;
-        }
-      } // end of non-precon
-
-      //@@@ a trick that may or may not help
-      //dReal ramp = (1-((dReal)(iteration+1)/(dReal)iterations));
-      //delta *= ramp;
-
-    } // end of for loop on m
+               );
+    }
 
 #ifdef PENETRATION_JVERROR_CORRECTION
     Jvnew_final = Jvnew*stepsize1;
@@ -813,49 +919,11 @@ static void* ComputeRows(void *p)
 
     // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
     // since local convergence might produce errors in other nodes?
-    dReal dlambda_bilateral_mean = 0.0;
-    dReal dlambda_contact_normal_mean = 0.0;
-    dReal dlambda_contact_friction_mean = 0.0;
-    dReal dlambda_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
-    if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
-      dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
-    qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
-    qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
-    qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
-
-    dReal residual_bilateral_mean = 0.0;
-    dReal residual_contact_normal_mean = 0.0;
-    dReal residual_contact_friction_mean = 0.0;
-    dReal residual_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
-    if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
-      residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
-    qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
-    qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
-    qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
-    qs->num_contacts = m_rms_dlambda[1];
+    StoreResidual(qs, &residual);
 
 #ifdef HDF5_INSTRUMENT
-    errors[iteration] = residual_total_mean;
+    errors[iteration] = qs->rms_constraint_residual[3] *
+      qs->rms_constraint_residual[3];
 #endif
     // debugging mutex locking
     //{
@@ -953,6 +1021,295 @@ static void* ComputeRows(void *p)
   return NULL;
 }
 
+#ifdef COLORED_PGS
+//***************************************************************************
+// graph-colored PGS
+//
+// rows are grouped into blocks, a block being a run of consecutive rows of
+// order with the same pair of bodies (the rows of a contact, or of a
+// joint). blocks are then colored so that the blocks of a color touch
+// disjoint bodies, and the blocks of a color are solved concurrently by
+// the threads of the worker pool. the world (body index -1) does not
+// count, so the contacts of bodies resting on the ground share a color.
+//
+// as in the serial sweep, the rows with findex < 0 are all solved before
+// the friction rows, which read the normal lambda of their contact. the
+// result does not depend on how the blocks of a color are spread over the
+// threads, so the solution is deterministic.
+
+// colors of each of the two phases, the blocks left over once all of them
+// are taken go to an extra color solved by a single thread.
+static const int kMaxColors = 64;
+
+// blocks handed to a thread at a time
+static const int kBlocksPerChunk = 16;
+
+// below this number of rows the serial sweep is faster
+static const int kColoredMinRows = 64;
+
+struct dxColoredRows
+{
+  // rows laid out by color, then by block
+  IndexError *order;
+
+  // first row in order and number of rows of each block
+  int *block_start;
+  int *block_rows;
+
+  // first block of each chunk, num_chunks+1 entries
+  int *chunk_block;
+
+  // first chunk of each color, num_colors+1 entries
+  int *color_chunk;
+
+  int num_colors;
+  int num_chunks;
+};
+
+// Color the rows order[start] to order[end-1], appending their blocks,
+// chunks and colors to rows.
+static void ColorPhase(const int start, const int end, const int nb,
+  const int *jb, const IndexError *order, int *block_color,
+  uint64_t *body_colors, dxColoredRows *rows, int *num_blocks)
+{
+  if (start == end)
+    return;
+
+  const int first_block = *num_blocks;
+  int color_blocks[kMaxColors+1];
+  memset(color_blocks, 0, sizeof(color_blocks));
+  memset(body_colors, 0, nb*sizeof(uint64_t));
+
+  // cut the rows into blocks, and give each block the lowest color not
+  // used yet by its bodies
+  int num_phase_blocks = 0;
+  for (int i = start; i < end;)
+  {
+    const int b1 = jb[order[i].index*2];
+    const int b2 = jb[order[i].index*2+1];
+    int j = i + 1;
+    while (j < end && jb[order[j].index*2] == b1 &&
+           jb[order[j].index*2+1] == b2)
+      ++j;
+
+    uint64_t used = 0;
+    if (b1 >= 0)
+      used |= body_colors[b1];
+    if (b2 >= 0)
+      used |= body_colors[b2];
+
+    int color = kMaxColors;
+    if (~used)
+    {
+      color = 0;
+      while (used & (uint64_t(1) << color))
+        ++color;
+      if (b1 >= 0)
+        body_colors[b1] |= uint64_t(1) << color;
+      if (b2 >= 0)
+        body_colors[b2] |= uint64_t(1) << color;
+    }
+
+    // the block is stored where it starts, sorted below
+    block_color[first_block + num_phase_blocks] = color;
+    rows->block_start[first_block + num_phase_blocks] = i;
+    rows->block_rows[first_block + num_phase_blocks] = j - i;
+    ++color_blocks[color];
+    ++num_phase_blocks;
+    i = j;
+  }
+
+  // stable sort of the blocks by color, the rows following their block
+  int color_start[kMaxColors+2];
+  color_start[0] = 0;
+  for (int c = 0; c <= kMaxColors; ++c)
+    color_start[c+1] = color_start[c] + color_blocks[c];
+
+  int *sorted_start = rows->chunk_block + first_block;
+  int *sorted_rows = block_color + first_block + num_phase_blocks;
+  int slot[kMaxColors+1];
+  memcpy(slot, color_start, sizeof(slot));
+  for (int b = first_block; b < first_block + num_phase_blocks; ++b)
+  {
+    const int s = slot[block_color[b]]++;
+    sorted_start[s] = rows->block_start[b];
+    sorted_rows[s] = rows->block_rows[b];
+  }
+
+  int row = start;
+  for (int s = 0; s < num_phase_blocks; ++s)
+  {
+    const int b = first_block + s;
+    for (int r = 0; r < sorted_rows[s]; ++r)
+      rows->order[row + r] = order[sorted_start[s] + r];
+    rows->block_start[b] = row;
+    rows->block_rows[b] = sorted_rows[s];
+    row += sorted_rows[s];
+  }
+
+  // cut each color into chunks, the extra color being a single chunk
+  for (int c = 0; c <= kMaxColors; ++c)
+  {
+    if (color_blocks[c] == 0)
+      continue;
+
+    rows->color_chunk[rows->num_colors++] = rows->num_chunks;
+    const int step = c < kMaxColors ? kBlocksPerChunk : color_blocks[c];
+    for (int s = color_start[c]; s < color_start[c+1]; s += step)
+      rows->chunk_block[rows->num_chunks++] = first_block + s;
+  }
+
+  *num_blocks += num_phase_blocks;
+}
+
+// Color the rows of order for the colored solver.
+static void ColorRows(dxWorldProcessContext *context, const int m,
+  const int nb, const int *jb, const int *findex, const IndexError *order,
+  dxColoredRows *rows)
+{
+  rows->order = context->AllocateArray<IndexError> (m);
+  rows->block_start = context->AllocateArray<int> (m);
+  rows->block_rows = context->AllocateArray<int> (m);
+  rows->chunk_block = context->AllocateArray<int> (m+1);
+  rows->color_chunk = context->AllocateArray<int> (2*(kMaxColors+1)+1);
+  rows->num_colors = 0;
+  rows->num_chunks = 0;
+
+  // scratch, 2*m for the color and then the row count of the blocks
+  int *block_color = context->AllocateArray<int> (2*m);
+  uint64_t *body_colors = context->AllocateArray<uint64_t> (nb);
+
+  // order holds the rows with findex < 0 first
+  int num_bilateral = 0;
+  while (num_bilateral < m && findex[order[num_bilateral].index] < 0)
+    ++num_bilateral;
+
+  // while a phase is sorted, chunk_block past the chunks of the previous
+  // phases holds the sorted block starts
+  int num_blocks = 0;
+  ColorPhase(0, num_bilateral, nb, jb, order, block_color, body_colors,
+    rows, &num_blocks);
+  ColorPhase(num_bilateral, m, nb, jb, order, block_color, body_colors,
+    rows, &num_blocks);
+
+  rows->color_chunk[rows->num_colors] = rows->num_chunks;
+  rows->chunk_block[rows->num_chunks] = num_blocks;
+}
+
+// Total rms of the residual, as stored by StoreResidual in
+// rms_constraint_residual[3].
+static dReal TotalResidual(const dxPGSResidual *residual)
+{
+  const int m_rms = residual->m_rms_dlambda[0] +
+    residual->m_rms_dlambda[1] + residual->m_rms_dlambda[2];
+  const dReal rms = residual->rms_error[0] + residual->rms_error[1] +
+    residual->rms_error[2];
+  if (rms > 0)
+    return sqrt(rms / (dReal)m_rms);
+  return 0;
+}
+
+// Iterations of the colored solver run by each thread of the pool, or by
+// the calling thread alone when pool is NULL. partial holds the residual of each chunk, twice so that the residual of
+// an iteration can still be read while the next one is being solved.
+static void ColoredIterations(dxPGSLCPParameters *params,
+  const dxColoredRows *rows, dxPGSResidual *partial, dxWorkerPool *pool,
+  const int thread_index)
+{
+  dxQuickStepParameters *qs = params->qs;
+  const int num_threads = pool ? pool->size() : 1;
+  const int num_iterations = qs->num_iterations;
+  const int precon_iterations = qs->precon_iterations;
+  const int total_iterations = precon_iterations + num_iterations +
+    qs->friction_iterations;
+  const dReal pgs_lcp_tolerance = qs->pgs_lcp_tolerance;
+
+  // every thread sums the residual of the chunks in the same order, so
+  // that they all stop at the same iteration
+  dxPGSResidual residual;
+  ResetResidual(&residual);
+
+  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  {
+    dxPGSResidual *current = partial + (iteration & 1) * rows->num_chunks;
+
+    for (int c = 0; c < rows->num_colors; ++c)
+    {
+      for (int k = rows->color_chunk[c] + thread_index;
+           k < rows->color_chunk[c+1]; k += num_threads)
+      {
+        ResetResidual(current + k);
+        for (int b = rows->chunk_block[k]; b < rows->chunk_block[k+1]; ++b)
+        {
+          const int startRow = rows->block_start[b];
+          const int nRows = rows->block_rows[b];
+          for (int i = startRow; i < startRow + nRows; ++i)
+            SolveRow(params, iteration, i, startRow, nRows, current + k);
+        }
+      }
+      if (pool)
+        pool->barrier();
+    }
+
+    // same bookkeeping as ComputeRows
+    residual.rms_dlambda[2] = 0;
+    residual.rms_error[2] = 0;
+    residual.m_rms_dlambda[2] = 0;
+    if (iteration < num_iterations + precon_iterations)
+    {
+      residual.rms_dlambda[0] = 0;
+      residual.rms_dlambda[1] = 0;
+      residual.rms_error[0] = 0;
+      residual.rms_error[1] = 0;
+      residual.m_rms_dlambda[0] = 0;
+      residual.m_rms_dlambda[1] = 0;
+    }
+    for (int k = 0; k < rows->num_chunks; ++k)
+    {
+      for (int t = 0; t < 3; ++t)
+      {
+        residual.m_rms_dlambda[t] += current[k].m_rms_dlambda[t];
+        residual.rms_dlambda[t] += current[k].rms_dlambda[t];
+        residual.rms_error[t] += current[k].rms_error[t];
+      }
+    }
+
+    if (thread_index == 0)
+      StoreResidual(qs, &residual);
+
+    // option to stop when tolerance has been met
+    if (iteration >= precon_iterations &&
+        TotalResidual(&residual) < pgs_lcp_tolerance)
+      break;
+  }
+}
+
+// Solve the rows of params with the colored solver. When the pool is busy
+// with another island, the calling thread solves them alone, in the same
+// order.
+static void ComputeRowsColored(dxWorldProcessContext *context,
+  dxPGSLCPParameters *params, dxWorkerPool *pool)
+{
+  dxColoredRows rows;
+  ColorRows(context, params->m, params->nb, params->jb, params->findex,
+    params->order, &rows);
+
+  dxPGSResidual *partial =
+    context->AllocateArray<dxPGSResidual> (2*rows.num_chunks);
+
+  dxPGSLCPParameters colored = *params;
+  colored.order = rows.order;
+
+  IFTIMING (dTimerNow ("start colored pgs rows"));
+  const bool ran = pool->run([&](int thread_index)
+  {
+    ColoredIterations(&colored, &rows, partial, pool, thread_index);
+  });
+  if (!ran)
+    ColoredIterations(&colored, &rows, partial, NULL, 0);
+}
+#endif
+
 //***************************************************************************
 // PGS_LCP method was previously SOR_LCP
 //
@@ -975,7 +1332,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
+  dxQuickStepParameters *qs, dxWorkerPool *pool
 #ifdef USE_TPROW
   , boost::threadpool::pool* row_threadpool
 #endif
@@ -1007,23 +1364,21 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     dSetZero (caccel_erp,nb*6);
   }
 
+  // the passes below go through the rows independently, they use the
+  // widest kernels the CPU supports
+  const quickstep::dxQuickStepKernels &kernels = quickstep::QuickStepKernels();
+
   dReal *Ad = context->AllocateArray<dReal> (m);
 
   {
     const dReal sor_w = qs->w;    // SOR over-relaxation parameter
     // precompute 1 / diagonals of A
-    dRealPtr iMJ_ptr = iMJ;
-    dRealPtr J_ptr = J;
-    for (int i=0; i<m; J_ptr += 12, iMJ_ptr += 12, i++) {
-      dReal sum = 0;
-      sum += quickstep::dot6(iMJ_ptr, J_ptr);
-      if (jb[i*2+1] >= 0) {
-        sum += quickstep::dot6(iMJ_ptr+6, J_ptr+6);
-      }
+    kernels.row_dot(m, iMJ, J, jb, Ad);
+    for (int i=0; i<m; i++) {
       if (findex[i] < 0)
-        Ad[i] = sor_w / (sum + cfm[i]);
+        Ad[i] = sor_w / (Ad[i] + cfm[i]);
       else
-        Ad[i] = qs->contact_sor_scale * sor_w / (sum + cfm[i]);
+        Ad[i] = qs->contact_sor_scale * sor_w / (Ad[i] + cfm[i]);
     }
   }
 
@@ -1039,17 +1394,13 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
       const dReal sor_w = qs->w;    // SOR over-relaxation parameter
       // precompute 1 / diagonals of A
       // preconditioned version uses J instead of iMJ
-      dRealPtr J_ptr = J;
-      for (int i=0; i<m; J_ptr += 12, i++) {
-        dReal sum = 0;
-        sum += quickstep::dot6(J_ptr, J_ptr);
-        if (jb[i*2+1] >= 0) {
-          sum += quickstep::dot6(J_ptr+6, J_ptr+6);
-        }
+      kernels.row_dot(m, J, J, jb, Ad_precon);
+      for (int i=0; i<m; i++) {
         if (findex[i] < 0)
-          Ad_precon[i] = sor_w / (sum + cfm[i]);
+          Ad_precon[i] = sor_w / (Ad_precon[i] + cfm[i]);
         else
-          Ad_precon[i] = qs->contact_sor_scale * sor_w / (sum + cfm[i]);
+          Ad_precon[i] = qs->contact_sor_scale * sor_w /
+            (Ad_precon[i] + cfm[i]);
       }
     }
 
@@ -1093,12 +1444,9 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     // to move multiplication by Ad[i] and cfm[i] out of iteration loop.
 
     // scale J and rhs by Ad
-    dRealMutablePtr J_ptr = J;
-    for (int i=0; i<m; J_ptr += 12, i++) {
+    kernels.scale_rows(m, J, Ad);
+    for (int i=0; i<m; i++) {
       dReal Ad_i = Ad[i];
-      for (int j=0; j<12; j++) {
-        J_ptr[j] *= Ad_i;
-      }
       rhs[i] *= Ad_i;
       rhs_erp[i] *= Ad_i;
       // scale Ad by CFM. N.B. this should be done last since it is used above
@@ -1200,9 +1548,21 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   boost::recursive_mutex* mutex =
     context->AllocateArray<boost::recursive_mutex>(1);
 
+  // the colored solver goes through all the rows at once, and solves the
+  // position correction inline
+#ifdef COLORED_PGS
+  // a pool of one thread still solves the colored order, so that the
+  // result does not depend on the number of threads
+  const bool colored = pool && m >= kColoredMinRows &&
+    !qs->thread_position_correction;
+#else
+  (void)pool;
+  const bool colored = false;
+#endif
+
   // number of chunks must be at least 1
   // (single iteration, through all the constraints)
-  int num_chunks = qs->num_chunks > 0 ? qs->num_chunks : 1; // min is 1
+  int num_chunks = qs->num_chunks > 0 && !colored ? qs->num_chunks : 1;
 
   // divide into chunks sequentially
   int chunk = m / num_chunks+1;
@@ -1390,7 +1750,12 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     else
       ComputeRows((void*)(&(params[thread_id])));
 #else
-    ComputeRows((void*)(&(params[thread_id])));
+#ifdef COLORED_PGS
+    if (colored)
+      ComputeRowsColored(context, &(params[thread_id]), pool);
+    else
+#endif
+      ComputeRows((void*)(&(params[thread_id])));
 #endif
 
     if (qs->thread_position_correction && params_erp_thread.joinable())
@@ -1569,7 +1934,7 @@ void quickstep::dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_
   } // if-else (abs(v)< eps)
 }
 
-size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
+size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int nb)
 {
   size_t res = dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Ad
@@ -1585,6 +1950,18 @@ size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params_erp
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params
   res += dEFFICIENT_SIZE(sizeof(boost::recursive_mutex)); // for mutex
+#ifdef COLORED_PGS
+  if (m >= kColoredMinRows)
+  {
+    res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for colored order
+    res += 2 * dEFFICIENT_SIZE(sizeof(int) * m); // for blocks
+    res += dEFFICIENT_SIZE(sizeof(int) * (m + 1)); // for chunks
+    res += dEFFICIENT_SIZE(sizeof(int) * (2 * (kMaxColors + 1) + 1));
+    res += dEFFICIENT_SIZE(sizeof(int) * 2 * m); // for block_color
+    res += dEFFICIENT_SIZE(sizeof(uint64_t) * nb); // for body_colors
+    res += dEFFICIENT_SIZE(sizeof(dxPGSResidual) * 2 * m); // for partial
+  }
+#endif
   return res;
 }
 
@@ -26,10 +26,14 @@
 #include <gazebo/ode/common.h>
 #include "quickstep_util.h"
 
+class dxWorkerPool;
+
 namespace ode {
     namespace quickstep{
 
 // PGS_LCP was previously named SOR_LCP
+// rows are solved with the graph-colored solver on the threads of pool when
+// it is not NULL, and serially otherwise.
 void PGS_LCP (dxWorldProcessContext *context,
   const int m, const int nb, dRealMutablePtr J, dRealMutablePtr J_precon,
   dRealMutablePtr J_orig,
@@ -43,7 +47,7 @@ void PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
+  dxQuickStepParameters *qs, dxWorkerPool *pool
 #ifdef USE_TPROW
   , boost::threadpool::pool* row_threadpool
 #endif
@@ -74,7 +78,7 @@ void dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_erp, dReal&
     int nRows, const int nb, dxBody * const *body, int i, const IndexError *order,
     const int *findex, dRealPtr lo, dRealPtr hi, dRealMutablePtr lambda, dRealMutablePtr lambda_erp);
 
-size_t EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/);
+size_t EstimatePGS_LCPMemoryRequirements(int m,int nb);
 
     } // namespace quickstep
 } // namespace ode
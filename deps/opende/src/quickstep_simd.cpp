@@ -0,0 +1,282 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+
+#include "quickstep_simd.h"
+
+// the vector kernels are built with per-function target attributes, so
+// that the library runs on any x86 CPU and picks them at runtime
+#if defined(dDOUBLE) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define QUICKSTEP_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace ode;
+
+//***************************************************************************
+// scalar kernels
+
+static void RowDotScalar (int m, const dReal *a, const dReal *b,
+  const int *jb, dReal *out)
+{
+  for (int i=0; i<m; a += 12, b += 12, i++) {
+    dReal sum = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] +
+      a[3]*b[3] + a[4]*b[4] + a[5]*b[5];
+    if (jb[i*2+1] >= 0) {
+      sum += a[6]*b[6] + a[7]*b[7] + a[8]*b[8] +
+        a[9]*b[9] + a[10]*b[10] + a[11]*b[11];
+    }
+    out[i] = sum;
+  }
+}
+
+static void MultiplyJScalar (int m, const dReal *J, const int *jb,
+  const dReal *in, dReal *out)
+{
+  for (int i=0; i<m; i++) {
+    int b1 = jb[i*2];
+    int b2 = jb[i*2+1];
+    dReal sum = 0;
+    const dReal *in_ptr = in + b1*6;
+    for (int j=0; j<6; j++) sum += J[j] * in_ptr[j];
+    J += 6;
+    if (b2 >= 0) {
+      in_ptr = in + b2*6;
+      for (int j=0; j<6; j++) sum += J[j] * in_ptr[j];
+    }
+    J += 6;
+    out[i] = sum;
+  }
+}
+
+static void ScaleRowsScalar (int m, dReal *J, const dReal *s)
+{
+  for (int i=0; i<m; J += 12, i++) {
+    const dReal s_i = s[i];
+    for (int j=0; j<12; j++) J[j] *= s_i;
+  }
+}
+
+static void ScaledSubScalar (int n, dReal *out, dReal h, const dReal *a,
+  const dReal *b)
+{
+  for (int k=0; k<n; k++) out[k] = h * (a[k] - b[k]);
+}
+
+static const quickstep::dxQuickStepKernels scalarKernels =
+{
+  "scalar", &RowDotScalar, &MultiplyJScalar, &ScaleRowsScalar,
+  &ScaledSubScalar
+};
+
+#ifdef QUICKSTEP_X86_KERNELS
+//***************************************************************************
+// AVX2 kernels, 4 rows per iteration
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+// sum of the lanes of r0 to r3, in the lanes of the result
+AVX2_TARGET static inline __m256d Sum4Avx2 (__m256d r0, __m256d r1,
+  __m256d r2, __m256d r3)
+{
+  __m256d s01 = _mm256_hadd_pd(r0, r1);
+  __m256d s23 = _mm256_hadd_pd(r2, r3);
+  return _mm256_add_pd(_mm256_permute2f128_pd(s01, s23, 0x20),
+    _mm256_permute2f128_pd(s01, s23, 0x31));
+}
+
+// products of the used entries of a row, to be summed
+AVX2_TARGET static inline __m256d RowProductAvx2 (const dReal *a,
+  const dReal *b, bool two)
+{
+  __m256d p = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+  __m256d q = _mm256_mul_pd(_mm256_loadu_pd(a+4), _mm256_loadu_pd(b+4));
+  if (!two)
+    return _mm256_add_pd(p, _mm256_blend_pd(q, _mm256_setzero_pd(), 0xC));
+  __m256d r = _mm256_mul_pd(_mm256_loadu_pd(a+8), _mm256_loadu_pd(b+8));
+  return _mm256_add_pd(_mm256_add_pd(p, q), r);
+}
+
+AVX2_TARGET static void RowDotAvx2 (int m, const dReal *a, const dReal *b,
+  const int *jb, dReal *out)
+{
+  int i = 0;
+  for (; i+4<=m; a += 48, b += 48, i += 4) {
+    __m256d r0 = RowProductAvx2(a, b, jb[i*2+1] >= 0);
+    __m256d r1 = RowProductAvx2(a+12, b+12, jb[i*2+3] >= 0);
+    __m256d r2 = RowProductAvx2(a+24, b+24, jb[i*2+5] >= 0);
+    __m256d r3 = RowProductAvx2(a+36, b+36, jb[i*2+7] >= 0);
+    _mm256_storeu_pd(out+i, Sum4Avx2(r0, r1, r2, r3));
+  }
+  RowDotScalar(m-i, a, b, jb+i*2, out+i);
+}
+
+// products of a row of J with the velocities of its bodies
+AVX2_TARGET static inline __m256d RowVelocityAvx2 (const dReal *J,
+  const dReal *in1, const dReal *in2)
+{
+  __m256d p = _mm256_mul_pd(_mm256_loadu_pd(J), _mm256_loadu_pd(in1));
+  if (!in2) {
+    __m256d q = _mm256_mul_pd(_mm256_castpd128_pd256(_mm_loadu_pd(J+4)),
+      _mm256_castpd128_pd256(_mm_loadu_pd(in1+4)));
+    return _mm256_add_pd(p,
+      _mm256_blend_pd(q, _mm256_setzero_pd(), 0xC));
+  }
+  __m256d v = _mm256_insertf128_pd(
+    _mm256_castpd128_pd256(_mm_loadu_pd(in1+4)), _mm_loadu_pd(in2), 1);
+  __m256d q = _mm256_mul_pd(_mm256_loadu_pd(J+4), v);
+  __m256d r = _mm256_mul_pd(_mm256_loadu_pd(J+8), _mm256_loadu_pd(in2+2));
+  return _mm256_add_pd(_mm256_add_pd(p, q), r);
+}
+
+AVX2_TARGET static void MultiplyJAvx2 (int m, const dReal *J,
+  const int *jb, const dReal *in, dReal *out)
+{
+  __m256d r[4];
+  int i = 0;
+  for (; i+4<=m; J += 48, i += 4) {
+    for (int k=0; k<4; k++) {
+      const int b2 = jb[(i+k)*2+1];
+      r[k] = RowVelocityAvx2(J+12*k, in + 6*jb[(i+k)*2],
+        b2 >= 0 ? in + 6*b2 : NULL);
+    }
+    _mm256_storeu_pd(out+i, Sum4Avx2(r[0], r[1], r[2], r[3]));
+  }
+  MultiplyJScalar(m-i, J, jb+i*2, in, out+i);
+}
+
+AVX2_TARGET static void ScaleRowsAvx2 (int m, dReal *J, const dReal *s)
+{
+  for (int i=0; i<m; J += 12, i++) {
+    const __m256d s_i = _mm256_broadcast_sd(s+i);
+    _mm256_storeu_pd(J, _mm256_mul_pd(_mm256_loadu_pd(J), s_i));
+    _mm256_storeu_pd(J+4, _mm256_mul_pd(_mm256_loadu_pd(J+4), s_i));
+    _mm256_storeu_pd(J+8, _mm256_mul_pd(_mm256_loadu_pd(J+8), s_i));
+  }
+}
+
+AVX2_TARGET static void ScaledSubAvx2 (int n, dReal *out, dReal h,
+  const dReal *a, const dReal *b)
+{
+  const __m256d hv = _mm256_set1_pd(h);
+  int k = 0;
+  for (; k+4<=n; k += 4) {
+    _mm256_storeu_pd(out+k, _mm256_mul_pd(hv,
+      _mm256_sub_pd(_mm256_loadu_pd(a+k), _mm256_loadu_pd(b+k))));
+  }
+  ScaledSubScalar(n-k, out+k, h, a+k, b+k);
+}
+
+static const quickstep::dxQuickStepKernels avx2Kernels =
+{
+  "avx2", &RowDotAvx2, &MultiplyJAvx2, &ScaleRowsAvx2, &ScaledSubAvx2
+};
+
+//***************************************************************************
+// AVX-512 kernels. a row is 12 dReal, which does not fit the 8 lanes, and
+// summing each row of a 512 bit product is slower than summing 4 rows at
+// once with the AVX2 kernels, so only the passes over whole arrays are
+// 512 bit wide.
+
+#define AVX512_TARGET __attribute__((target("avx512f")))
+
+AVX512_TARGET static void ScaleRowsAvx512 (int m, dReal *J, const dReal *s)
+{
+  int i = 0;
+  // two rows are 3 vectors
+  for (; i+2<=m; J += 24, i += 2) {
+    const __m512d s0 = _mm512_set1_pd(s[i]);
+    const __m512d s1 = _mm512_set1_pd(s[i+1]);
+    const __m512d s01 = _mm512_mask_blend_pd(0xF0, s0, s1);
+    _mm512_storeu_pd(J, _mm512_mul_pd(_mm512_loadu_pd(J), s0));
+    _mm512_storeu_pd(J+8, _mm512_mul_pd(_mm512_loadu_pd(J+8), s01));
+    _mm512_storeu_pd(J+16, _mm512_mul_pd(_mm512_loadu_pd(J+16), s1));
+  }
+  ScaleRowsScalar(m-i, J, s+i);
+}
+
+AVX512_TARGET static void ScaledSubAvx512 (int n, dReal *out, dReal h,
+  const dReal *a, const dReal *b)
+{
+  const __m512d hv = _mm512_set1_pd(h);
+  int k = 0;
+  for (; k+8<=n; k += 8) {
+    _mm512_storeu_pd(out+k, _mm512_mul_pd(hv,
+      _mm512_sub_pd(_mm512_loadu_pd(a+k), _mm512_loadu_pd(b+k))));
+  }
+  ScaledSubScalar(n-k, out+k, h, a+k, b+k);
+}
+
+static const quickstep::dxQuickStepKernels avx512Kernels =
+{
+  "avx512", &RowDotAvx2, &MultiplyJAvx2, &ScaleRowsAvx512,
+  &ScaledSubAvx512
+};
+#endif
+
+//***************************************************************************
+
+const quickstep::dxQuickStepKernels *quickstep::QuickStepKernelsFor (
+  int type)
+{
+  switch (type)
+  {
+    case QUICKSTEP_KERNEL_SCALAR:
+      return &scalarKernels;
+#ifdef QUICKSTEP_X86_KERNELS
+    case QUICKSTEP_KERNEL_AVX2:
+      if (__builtin_cpu_supports("avx2"))
+        return &avx2Kernels;
+      break;
+    case QUICKSTEP_KERNEL_AVX512:
+      if (__builtin_cpu_supports("avx512f") &&
+          __builtin_cpu_supports("avx2"))
+        return &avx512Kernels;
+      break;
+#endif
+    default:
+      break;
+  }
+  return NULL;
+}
+
+static const quickstep::dxQuickStepKernels *SelectKernels ()
+{
+  const char *forced = getenv("ODE_QUICKSTEP_KERNEL");
+  for (int type = quickstep::QUICKSTEP_KERNEL_COUNT-1; type >= 0; --type)
+  {
+    const quickstep::dxQuickStepKernels *kernels =
+      quickstep::QuickStepKernelsFor(type);
+    if (kernels && (!forced || strcmp(forced, kernels->name) == 0))
+      return kernels;
+  }
+  return &scalarKernels;
+}
+
+const quickstep::dxQuickStepKernels &quickstep::QuickStepKernels ()
+{
+  static const dxQuickStepKernels *kernels = SelectKernels();
+  return *kernels;
+}
@@ -0,0 +1,77 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef _ODE_QUICK_STEP_SIMD_H_
+#define _ODE_QUICK_STEP_SIMD_H_
+
+#include <gazebo/ode/common.h>
+
+namespace ode {
+    namespace quickstep{
+
+// instruction sets the quickstep kernels are built for
+enum dxQuickStepKernelType
+{
+  QUICKSTEP_KERNEL_SCALAR = 0,
+  QUICKSTEP_KERNEL_AVX2,
+  QUICKSTEP_KERNEL_AVX512,
+  QUICKSTEP_KERNEL_COUNT
+};
+
+// kernels of the passes of quickstep which go through all the constraint
+// rows or all the bodies independently. J and iMJ are packed 12 dReal per
+// row, the last 6 being only used when the row has a second body
+// (jb[2*i+1] >= 0). the vector kernels handle several rows per iteration.
+// the PGS sweep itself goes one row at a time, each row depending on the
+// previous ones.
+struct dxQuickStepKernels
+{
+  const char *name;
+
+  // out[i] = a_i . b_i
+  void (*row_dot) (int m, const dReal *a, const dReal *b, const int *jb,
+    dReal *out);
+
+  // out[i] = J_i * in, where in holds 6 dReal per body
+  void (*multiply_J) (int m, const dReal *J, const int *jb, const dReal *in,
+    dReal *out);
+
+  // J_i *= s[i]
+  void (*scale_rows) (int m, dReal *J, const dReal *s);
+
+  // out[k] = h * (a[k] - b[k]) for k < n, out may be b
+  void (*scaled_sub) (int n, dReal *out, dReal h, const dReal *a,
+    const dReal *b);
+};
+
+// kernels used by quickstep: the widest ones supported by the CPU, unless
+// the ODE_QUICKSTEP_KERNEL environment variable names other supported
+// ones (scalar, avx2 or avx512). chosen on the first call.
+ODE_API const dxQuickStepKernels &QuickStepKernels ();
+
+// kernels of an instruction set, NULL when they are not built for this
+// platform or not supported by the CPU
+ODE_API const dxQuickStepKernels *QuickStepKernelsFor (int type);
+
+    } // namespace quickstep
+} // namespace ode
+#endif
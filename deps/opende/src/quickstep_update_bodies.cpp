@@ -35,6 +35,7 @@
 #endif
 #include "quickstep_util.h"
 #include "quickstep_update_bodies.h"
+#include "quickstep_simd.h"
 using namespace ode;
 
 // Update the velocity, position of bodies
@@ -253,23 +254,23 @@ void quickstep::dxUpdateBodies(
 
   // revert lvel and avel with the non-erp version of caccel
   if (m > 0) {
-    dReal erp_removal = 1.00;
     IFTIMING (dTimerNow ("velocity update due to constraint forces"));
-    // remove caccel_erp
-    const dReal *caccel_erp_curr = caccel_erp;
-    const dReal *caccel_curr = caccel;
+    // remove caccel_erp. caccel_erp is not used anymore, it is overwritten
+    // with the velocity change stepsize * (caccel - caccel_erp) for all
+    // the bodies at once.
+    QuickStepKernels().scaled_sub(6*nb, caccel_erp, stepsize, caccel,
+      caccel_erp);
+    const dReal *dvel_curr = caccel_erp;
     dxBody *const *const bodyend = body + nb;
     int debug_count = 0;
     for (dxBody *const *bodycurr = body; bodycurr != bodyend;
-         caccel_curr+=6, caccel_erp_curr+=6, bodycurr++, debug_count++) {
+         dvel_curr+=6, bodycurr++, debug_count++) {
       dxBody *b_ptr = *bodycurr;
       for (int j=0; j<3; j++) {
         // dReal v0 = b_ptr->lvel[j];
         // dReal a0 = b_ptr->avel[j];
-        dReal dv = erp_removal * stepsize *
-          (caccel_curr[j]   - caccel_erp_curr[j]);
-        dReal da = erp_removal * stepsize *
-          (caccel_curr[3+j] - caccel_erp_curr[3+j]);
+        dReal dv = dvel_curr[j];
+        dReal da = dvel_curr[3+j];
 
         /* default v removal
         */
@@ -296,8 +297,8 @@ void quickstep::dxUpdateBodies(
         printf("nb[%d] m[%d] b[%d] i[%d] v[%f] dv[%f] vf[%f] a[%f] da[%f] af[%f] debug[%f - %f][%f - %f]\n"
                ,nb, m, debug_count, j, v0, dv, b_ptr->lvel[j]
                  , a0, da, b_ptr->avel[j]
-               ,caccel_curr[j], caccel_erp_curr[j]
-               ,caccel_curr[3+j], caccel_erp_curr[3+j]);
+               ,caccel[6*debug_count+j], caccel_erp[6*debug_count+j]
+               ,caccel[6*debug_count+3+j], caccel_erp[6*debug_count+3+j]);
         */
       }
       /*  DEBUG PRINTOUTS
@@ -308,6 +309,7 @@ void quickstep::dxUpdateBodies(
     }
 
 #ifdef POST_UPDATE_CONSTRAINT_VIOLATION_CORRECTION
+    dReal erp_removal = 1.00;
     // ADD CACCEL CORRECTION FROM VELOCITY CONSTRAINT VIOLATION
     BEGIN_STATE_SAVE(context, velstate) {
       dReal *vel = context->AllocateArray<dReal>(nb*6);
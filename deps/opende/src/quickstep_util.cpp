@@ -36,6 +36,7 @@
 #endif
 
 #include "quickstep_util.h"
+#include "quickstep_simd.h"
 
 using namespace ode;
 // multiply block of B matrix (q x 6) with 12 dReal per row with C vektor (q)
@@ -122,21 +123,7 @@ void quickstep::multiply_invM_JT (int m, int nb, dRealMutablePtr iMJ, int *jb,
 void quickstep::multiply_J (int m, dRealPtr J, int *jb,
   dRealPtr in, dRealMutablePtr out)
 {
-  dRealPtr J_ptr = J;
-  for (int i=0; i<m; i++) {
-    int b1 = jb[i*2];
-    int b2 = jb[i*2+1];
-    dReal sum = 0;
-    dRealPtr in_ptr = in + b1*6;
-    for (int j=0; j<6; j++) sum += J_ptr[j] * in_ptr[j];
-    J_ptr += 6;
-    if (b2 >= 0) {
-      in_ptr = in + b2*6;
-      for (int j=0; j<6; j++) sum += J_ptr[j] * in_ptr[j];
-    }
-    J_ptr += 6;
-    out[i] = sum;
-  }
+  QuickStepKernels().multiply_J(m, J, jb, in, out);
 }
 
 #ifdef USE_CG_LCP
@@ -89,6 +89,17 @@ typedef dReal *dRealMutablePtr;
 // #define RANDOMLY_REORDER_CONSTRAINTS 1
 #undef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
 
+// for the PGS method:
+// the graph-colored solver used by dWorldColoredQuickStep lays the rows
+// out in an order of its own, so it is only available when that order is
+// not changed during the solution. otherwise the colored step falls back
+// to the serial sweep.
+#if !defined(REORDER_CONSTRAINTS) && \
+    !defined(RANDOMLY_REORDER_CONSTRAINTS) && \
+    !defined(PENETRATION_JVERROR_CORRECTION) && !defined(USE_TPROW)
+#define COLORED_PGS
+#endif
+
 //***************************************************************************
 // testing stuff
 
@@ -0,0 +1,116 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+#include "quickstep_worker_pool.h"
+
+// number of busy-wait rounds before a thread waiting at the barrier starts
+// yielding its core
+static const int kSpinCount = 1000;
+
+dxWorkerPool::dxWorkerPool(int _num_threads)
+  : num_threads(_num_threads > 1 ? _num_threads : 1),
+    job(NULL), job_generation(0), stop(false),
+    pending(0), arrived(0), barrier_generation(0)
+{
+  for (int i = 1; i < num_threads; ++i)
+    workers.push_back(std::thread(&dxWorkerPool::workerLoop, this, i));
+}
+
+dxWorkerPool::~dxWorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(job_mutex);
+    stop = true;
+  }
+  job_condition.notify_all();
+  for (size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+}
+
+bool dxWorkerPool::run(const std::function<void(int)> &fn)
+{
+  std::unique_lock<std::mutex> run_lock(run_mutex, std::try_to_lock);
+  if (!run_lock.owns_lock())
+    return false;
+
+  pending.store(num_threads - 1);
+  {
+    std::lock_guard<std::mutex> lock(job_mutex);
+    job = &fn;
+    ++job_generation;
+  }
+  job_condition.notify_all();
+
+  fn(0);
+
+  // the workers finish right after the last barrier of the job
+  int spins = 0;
+  while (pending.load(std::memory_order_acquire) > 0)
+  {
+    if (++spins > kSpinCount)
+      std::this_thread::yield();
+  }
+  return true;
+}
+
+void dxWorkerPool::barrier()
+{
+  if (num_threads == 1)
+    return;
+
+  const unsigned int generation =
+    barrier_generation.load(std::memory_order_acquire);
+  if (arrived.fetch_add(1, std::memory_order_acq_rel) == num_threads - 1)
+  {
+    // last one in releases the others
+    arrived.store(0, std::memory_order_relaxed);
+    barrier_generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  int spins = 0;
+  while (barrier_generation.load(std::memory_order_acquire) == generation)
+  {
+    if (++spins > kSpinCount)
+      std::this_thread::yield();
+  }
+}
+
+void dxWorkerPool::workerLoop(int thread_index)
+{
+  unsigned int seen = 0;
+  while (true)
+  {
+    const std::function<void(int)> *fn;
+    {
+      std::unique_lock<std::mutex> lock(job_mutex);
+      job_condition.wait(lock, [&] { return stop || job_generation != seen; });
+      if (stop)
+        return;
+      seen = job_generation;
+      fn = job;
+    }
+
+    (*fn)(thread_index);
+    pending.fetch_sub(1, std::memory_order_release);
+  }
+}
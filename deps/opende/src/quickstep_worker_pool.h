@@ -0,0 +1,80 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef _ODE_QUICK_STEP_WORKER_POOL_H_
+#define _ODE_QUICK_STEP_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent threads which all run the same function, used by the
+// graph-colored PGS solver. The threads sleep between runs; during a run
+// they synchronize through a spinning barrier, which is cheap enough to be
+// crossed once per color per PGS iteration.
+class dxWorkerPool
+{
+public:
+  // num_threads is the number of threads taking part in a run, including
+  // the calling thread.
+  explicit dxWorkerPool(int num_threads);
+  ~dxWorkerPool();
+
+  int size() const { return num_threads; }
+
+  // Run fn(thread_index) on every thread of the pool, the calling thread
+  // being thread 0, and wait for all of them to return. Returns false
+  // without running anything if another run is in progress, for example
+  // from another island thread.
+  bool run(const std::function<void(int)> &fn);
+
+  // Wait until every thread of the current run reached the barrier.
+  void barrier();
+
+private:
+  void workerLoop(int thread_index);
+
+  const int num_threads;
+  std::vector<std::thread> workers;
+
+  // serializes runs
+  std::mutex run_mutex;
+
+  // job hand-off to the sleeping workers
+  std::mutex job_mutex;
+  std::condition_variable job_condition;
+  const std::function<void(int)> *job;
+  unsigned int job_generation;
+  bool stop;
+
+  // workers still running the current job
+  std::atomic<int> pending;
+
+  // spinning barrier
+  std::atomic<int> arrived;
+  std::atomic<unsigned int> barrier_generation;
+};
+
+#endif
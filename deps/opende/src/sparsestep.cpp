@@ -0,0 +1,725 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+/*
+
+sparse quickstep: the unbounded rows of the joints that do not close a loop
+are solved exactly with the linear time sparse factorization of
+
+  D. Baraff, "Linear-Time Dynamics using Lagrange Multipliers", SIGGRAPH 96
+
+while the remaining rows (contacts, limits, motors and the joints closing
+loops) are solved by projected gauss-seidel, as in quickstep. the two are
+alternated in a block gauss-seidel iteration, the tree being solved exactly
+last so that long chains do not drift apart however few iterations are made.
+
+the step is solved for the new velocities v and the constraint impulses
+p = h*lambda. with M the mass matrix, fe the external forces and e = cfm/h
+
+  M v = M v0 + h fe + J' p
+  J v + e p = c
+
+for the tree rows T, given the impulses pC of the other rows, this is the
+symmetric system
+
+  [ M   JT' ] [ v ]   [ M v0 + h fe + JC' pC ]
+  [ JT  -e  ] [ q ] = [ c                    ]    q = -pT
+
+whose graph, with the bodies and the tree joints as nodes, is a forest.
+eliminating the nodes leaves first, every block of the factor is either a
+node or a node and its parent, so the factorization and the solve are linear
+in the number of bodies. the node blocks are at most 6x6 and are factored
+with dFactorLDLT.
+
+*/
+
+#include <gazebo/ode/odeconfig.h>
+#include <gazebo/ode/odemath.h>
+#include <gazebo/ode/rotation.h>
+#include <gazebo/ode/error.h>
+#include <gazebo/ode/matrix.h>
+#include "config.h"
+#include "objects.h"
+#include "joints/joint.h"
+#include "util.h"
+#include "sparsestep.h"
+
+//****************************************************************************
+// misc defines
+
+// leading dimension of the node blocks of the factor
+#define NODE_SKIP 8
+
+struct dJointWithInfo1
+{
+  dxJoint *joint;
+  dxJoint::Info1 info;
+};
+
+// a node of the forest: a body, or the tree rows of a joint
+struct dxSparseNode
+{
+  int parent;   // parent node, -1 for a root
+  int dim;      // 6 for a body, the number of tree rows for a joint
+  int row;      // first row of a joint in J, -1 for a body
+  int joint;    // index of a joint in the joint list, -1 for a body
+  int side;     // side in the joint of the body of the node or its parent,
+                // -1 until the node is reached
+};
+
+//****************************************************************************
+// forest
+
+// root of the set of node i, halving the paths on the way
+static int FindRoot (int *set, int i)
+{
+  while (set[i] != i) {
+    set[i] = set[set[i]];
+    i = set[i];
+  }
+  return i;
+}
+
+// number of leading rows of a joint that are unbounded and without a
+// friction index, at most its nub
+static int CountTreeRows (const dJointWithInfo1 *ji, const dReal *lo,
+                          const dReal *hi, const int *findex)
+{
+  int n = 0;
+  while (n < ji->info.nub && findex[n] == -1 &&
+         lo[n] == -dInfinity && hi[n] == dInfinity)
+    ++n;
+  return n;
+}
+
+// block of the system between node p and its child i, dim(p) x dim(i)
+// stored by rows with a leading dimension of 6
+static void GetParentBlock (dReal *H, const dxSparseNode *nodes,
+                            const dReal *J, int p, int i)
+{
+  const dxSparseNode &np = nodes[p];
+  const dxSparseNode &ni = nodes[i];
+  if (np.row >= 0) {
+    // joint over body: the body's side of the jacobian
+    const dReal *Jrow = J + 12*np.row + 6*ni.side;
+    for (int r = 0; r < np.dim; ++r, Jrow += 12)
+      for (int k = 0; k < 6; ++k) H[r*6+k] = Jrow[k];
+  }
+  else {
+    // body over joint: the transpose of the body's side of the jacobian
+    const dReal *Jrow = J + 12*ni.row + 6*ni.side;
+    for (int k = 0; k < ni.dim; ++k, Jrow += 12)
+      for (int r = 0; r < 6; ++r) H[r*6+k] = Jrow[r];
+  }
+}
+
+// visit the trees breadth first from the nodes order[head..tail), appending
+// the nodes reached to order. returns the end of order
+static int VisitTrees (dxBody * const *body, int nb,
+                       const dJointWithInfo1 *jointiinfos, int nj,
+                       const int *jnode, dxSparseNode *nodes, int *order,
+                       int head, int tail)
+{
+  while (head < tail) {
+    const int i = order[head++];
+    if (i < nb) {
+      // the tree joints of a body, checking that the tag of the joint is
+      // from this step: disabled joints are not numbered
+      for (dxJointNode *jn=body[i]->firstjoint; jn; jn=jn->next) {
+        const int t = jn->joint->tag;
+        if (t < 0 || t >= nj || jointiinfos[t].joint != jn->joint)
+          continue;
+        const int q = jnode[t];
+        if (q < 0 || nodes[q].side >= 0)
+          continue;
+        nodes[q].parent = i;
+        nodes[q].side = jn->joint->node[0].body == body[i] ? 0 : 1;
+        order[tail++] = q;
+      }
+    }
+    else {
+      const dxJoint *joint = jointiinfos[nodes[i].joint].joint;
+      for (int s=0; s<2; s++) {
+        const dxBody *b = joint->node[s].body;
+        if (!b || nodes[b->tag].side >= 0)
+          continue;
+        nodes[b->tag].parent = i;
+        nodes[b->tag].side = s;
+        order[tail++] = b->tag;
+      }
+    }
+  }
+  return tail;
+}
+
+// factor the forest, children before parents. the node blocks D are
+// replaced by their LDL' factors and L gets, for every node, the block
+// H D^-1 of the factor between its parent and itself
+static void FactorForest (dxSparseNode *nodes, const int *order, int n,
+                          const dReal *J, dReal *D, dReal *d, dReal *L)
+{
+  for (int k = n - 1; k >= 0; --k) {
+    const int i = order[k];
+    const dxSparseNode &ni = nodes[i];
+    dReal *Di = D + 6*NODE_SKIP*i;
+    dReal *di = d + NODE_SKIP*i;
+    dFactorLDLT (Di, di, ni.dim, NODE_SKIP);
+
+    const int p = ni.parent;
+    if (p < 0)
+      continue;
+
+    const int dimp = nodes[p].dim;
+    dReal H[36];
+    GetParentBlock (H, nodes, J, p, i);
+
+    dReal *Li = L + 36*i;
+    for (int r = 0; r < dimp; ++r) {
+      dReal tmp[6];
+      for (int c = 0; c < ni.dim; ++c) tmp[c] = H[r*6+c];
+      dSolveLDLT (Di, di, tmp, ni.dim, NODE_SKIP);
+      for (int c = 0; c < ni.dim; ++c) Li[r*6+c] = tmp[c];
+    }
+
+    // schur complement of the node in its parent: Dp -= L H'
+    dReal *Dp = D + 6*NODE_SKIP*p;
+    for (int r = 0; r < dimp; ++r) {
+      for (int s = 0; s < dimp; ++s) {
+        dReal sum = 0;
+        for (int c = 0; c < ni.dim; ++c) sum += Li[r*6+c] * H[s*6+c];
+        Dp[r*NODE_SKIP+s] -= sum;
+      }
+    }
+  }
+}
+
+// solve the factored forest for x, 6 elements per node, in place
+static void SolveForest (const dxSparseNode *nodes, const int *order, int n,
+                         const dReal *D, const dReal *d, const dReal *L,
+                         dReal *x)
+{
+  for (int k = n - 1; k >= 0; --k) {
+    const int i = order[k];
+    const int p = nodes[i].parent;
+    if (p < 0)
+      continue;
+    const dReal *Li = L + 36*i;
+    const dReal *xi = x + 6*i;
+    dReal *xp = x + 6*p;
+    for (int r = 0; r < nodes[p].dim; ++r) {
+      dReal sum = 0;
+      for (int c = 0; c < nodes[i].dim; ++c) sum += Li[r*6+c] * xi[c];
+      xp[r] -= sum;
+    }
+  }
+
+  for (int i = 0; i < n; ++i)
+    dSolveLDLT (D + 6*NODE_SKIP*i, d + NODE_SKIP*i, x + 6*i, nodes[i].dim,
+                NODE_SKIP);
+
+  for (int k = 0; k < n; ++k) {
+    const int i = order[k];
+    const int p = nodes[i].parent;
+    if (p < 0)
+      continue;
+    const dReal *Li = L + 36*i;
+    const dReal *xp = x + 6*p;
+    dReal *xi = x + 6*i;
+    for (int c = 0; c < nodes[i].dim; ++c) {
+      dReal sum = 0;
+      for (int r = 0; r < nodes[p].dim; ++r) sum += Li[r*6+c] * xp[r];
+      xi[c] -= sum;
+    }
+  }
+}
+
+//****************************************************************************
+// rows
+
+// J*v for one row
+static dReal MultiplyRow (const dReal *Jrow, const int *jbrow, const dReal *v)
+{
+  dReal sum = 0;
+  for (int s = 0; s < 2; ++s) {
+    if (jbrow[s] < 0)
+      continue;
+    const dReal *vb = v + 6*jbrow[s];
+    const dReal *Js = Jrow + 6*s;
+    for (int k = 0; k < 6; ++k) sum += Js[k] * vb[k];
+  }
+  return sum;
+}
+
+// x += J'*a for one row
+static void AddRowTranspose (dReal *x, const dReal *Jrow, const int *jbrow,
+                             dReal a)
+{
+  for (int s = 0; s < 2; ++s) {
+    if (jbrow[s] < 0)
+      continue;
+    dReal *xb = x + 6*jbrow[s];
+    const dReal *Js = Jrow + 6*s;
+    for (int k = 0; k < 6; ++k) xb[k] += Js[k] * a;
+  }
+}
+
+// one projected gauss-seidel sweep over the rows that are not in the tree.
+// v and pc are kept up to date with the impulses p
+static void SweepRows (int nc, const int *crow, const dReal *J,
+                       const dReal *iMJ, const int *jb, const dReal *c,
+                       const dReal *e, const dReal *iAd, const dReal *lo,
+                       const dReal *hi, const int *findex, dReal w,
+                       dReal *p, dReal *v, dReal *pc)
+{
+  for (int k = 0; k < nc; ++k) {
+    const int i = crow[k];
+    if (iAd[i] == 0)
+      continue;
+    const dReal *Jrow = J + 12*i;
+    const int *jbrow = jb + 2*i;
+
+    dReal delta = w * (c[i] - e[i]*p[i] - MultiplyRow (Jrow, jbrow, v)) *
+      iAd[i];
+
+    dReal lo_act = lo[i], hi_act = hi[i];
+    if (findex[i] >= 0) {
+      hi_act = dFabs (hi[i] * p[findex[i]]);
+      lo_act = -hi_act;
+    }
+
+    const dReal pnew = p[i] + delta;
+    if (pnew < lo_act)
+      delta = lo_act - p[i];
+    else if (pnew > hi_act)
+      delta = hi_act - p[i];
+    p[i] += delta;
+
+    AddRowTranspose (v, iMJ + 12*i, jbrow, delta);
+    AddRowTranspose (pc, Jrow, jbrow, delta);
+  }
+}
+
+
+//****************************************************************************
+// the stepper
+
+void dxSparseQuickStepper (dxWorldProcessContext *context, dxWorld *world,
+                           dxBody * const *body, int nb,
+                           dxJoint * const *_joint, int _nj,
+                           dReal stepsize)
+{
+  const dReal stepsize1 = dRecip(stepsize);
+
+  // number all bodies in the body list - set their tag values
+  for (int i=0; i<nb; i++) body[i]->tag = i;
+
+  // compute the world frame inertia and its inverse, add the gyroscopic
+  // torques and gravity as quickstep does, and the momentum each body would
+  // have without the constraints, M v0 + h fe
+  dReal *I = context->AllocateArray<dReal> (3*4*nb);
+  dReal *invI = context->AllocateArray<dReal> (3*4*nb);
+  dReal *mom = context->AllocateArray<dReal> (6*nb);
+
+  for (int i=0; i<nb; i++) {
+    dxBody *b = body[i];
+    dReal *Irow = I + 12*i;
+    dMatrix3 tmp;
+    dMultiply2_333 (tmp,b->invI,b->posr.R);
+    dMultiply0_333 (invI + 12*i,b->posr.R,tmp);
+    dMultiply2_333 (tmp,b->mass.I,b->posr.R);
+    dMultiply0_333 (Irow,b->posr.R,tmp);
+
+    if (b->flags & dxBodyGyroscopic) {
+      dMultiply0_331 (tmp,Irow,b->avel);
+      dSubtractVectorCross3 (b->tacc,b->avel,tmp);
+    }
+    if ((b->flags & dxBodyNoGravity)==0) {
+      for (int k=0; k<3; k++) b->facc[k] += b->mass.mass * world->gravity[k];
+    }
+
+    dReal *momrow = mom + 6*i;
+    dMultiply0_331 (momrow + 3,Irow,b->avel);
+    for (int k=0; k<3; k++) {
+      momrow[k] = b->mass.mass * b->lvel[k] + stepsize * b->facc[k];
+      momrow[3+k] += stepsize * b->tacc[k];
+    }
+  }
+
+  // get joint information. joints with m=0 are inactive and are left out,
+  // the others are numbered by their tag
+  dJointWithInfo1 *const jointiinfos =
+    context->AllocateArray<dJointWithInfo1> (_nj);
+  int nj = 0, m = 0;
+  for (int i=0; i<_nj; i++) {
+    dxJoint *j = _joint[i];
+    dJointWithInfo1 *ji = jointiinfos + nj;
+    j->tag = -1;
+    j->getInfo1 (&ji->info);
+    dIASSERT (ji->info.m >= 0 && ji->info.m <= 6 && ji->info.nub >= 0 &&
+              ji->info.nub <= ji->info.m);
+    if (ji->info.m > 0) {
+      ji->joint = j;
+      j->tag = nj++;
+      m += ji->info.m;
+    }
+  }
+
+  // get the jacobians and the rest of the rows, laid out as in quickstep
+  dReal *J = context->AllocateArray<dReal> (12*m);
+  dReal *c = context->AllocateArray<dReal> (m);
+  dReal *cfm = context->AllocateArray<dReal> (m);
+  dReal *lo = context->AllocateArray<dReal> (m);
+  dReal *hi = context->AllocateArray<dReal> (m);
+  dReal *c_v_max = context->AllocateArray<dReal> (m);
+  int *findex = context->AllocateArray<int> (m);
+  int *jb = context->AllocateArray<int> (2*m);
+  int *jrow = context->AllocateArray<int> (nj);
+
+  dSetZero (J,12*m);
+  dSetZero (c,m);
+  dSetValue (cfm,m,world->global_cfm);
+  dSetValue (lo,m,-dInfinity);
+  dSetValue (hi,m,dInfinity);
+  dSetValue (c_v_max,m,world->contactp.max_vel);
+  for (int i=0; i<m; i++) findex[i] = -1;
+
+  {
+    dxJoint::Info2 Jinfo;
+    Jinfo.rowskip = 12;
+    Jinfo.fps = stepsize1;
+
+    int ofsi = 0;
+    for (int ji=0; ji<nj; ji++) {
+      dxJoint *joint = jointiinfos[ji].joint;
+      const int infom = jointiinfos[ji].info.m;
+      dReal *const Jrow = J + ofsi*12;
+      Jinfo.erp = world->global_erp;
+      Jinfo.J1l = Jrow;
+      Jinfo.J1a = Jrow + 3;
+      Jinfo.J2l = Jrow + 6;
+      Jinfo.J2a = Jrow + 9;
+      Jinfo.c = c + ofsi;
+      Jinfo.cfm = cfm + ofsi;
+      Jinfo.lo = lo + ofsi;
+      Jinfo.hi = hi + ofsi;
+      Jinfo.findex = findex + ofsi;
+      Jinfo.c_v_max = c_v_max + ofsi;
+      joint->getInfo2 (&Jinfo);
+
+      // adjust returned findex values for global index numbering
+      for (int r=0; r<infom; r++) {
+        if (findex[ofsi+r] >= 0)
+          findex[ofsi+r] += ofsi;
+      }
+
+      const int b1 = joint->node[0].body ? joint->node[0].body->tag : -1;
+      const int b2 = joint->node[1].body ? joint->node[1].body->tag : -1;
+      for (int r=0; r<infom; r++) {
+        jb[2*(ofsi+r)] = b1;
+        jb[2*(ofsi+r)+1] = b2;
+      }
+
+      jrow[ji] = ofsi;
+      ofsi += infom;
+    }
+  }
+
+  // build the forest. the bodies are the first nb nodes, then come the
+  // joints whose unbounded rows do not close a loop, the world included.
+  // the rows of the other joints and the bounded rows of all joints are
+  // left to PGS
+  dxSparseNode *nodes = context->AllocateArray<dxSparseNode> (nb + nj);
+  int *jnode = context->AllocateArray<int> (nj);
+  int *crow = context->AllocateArray<int> (m);
+  int n = nb, nc = 0;
+
+  for (int i=0; i<nb; i++) {
+    nodes[i].parent = -1;
+    nodes[i].dim = 6;
+    nodes[i].row = -1;
+    nodes[i].joint = -1;
+    nodes[i].side = -1;
+  }
+
+  BEGIN_STATE_SAVE(context, setstate) {
+    int *set = context->AllocateArray<int> (nb + 1);
+    for (int i=0; i<=nb; i++) set[i] = i;
+
+    for (int ji=0; ji<nj; ji++) {
+      const int row = jrow[ji];
+      int ntree = CountTreeRows (jointiinfos + ji, lo + row, hi + row,
+                                 findex + row);
+      jnode[ji] = -1;
+      if (ntree > 0) {
+        const int s1 = FindRoot (set, jb[2*row] >= 0 ? jb[2*row] : nb);
+        const int s2 = FindRoot (set, jb[2*row+1] >= 0 ? jb[2*row+1] : nb);
+        if (s1 != s2) {
+          set[s1] = s2;
+          jnode[ji] = n;
+          nodes[n].parent = -1;
+          nodes[n].dim = ntree;
+          nodes[n].row = row;
+          nodes[n].joint = ji;
+          nodes[n].side = -1;
+          n++;
+        }
+        else {
+          ntree = 0;
+        }
+      }
+      for (int r=ntree; r<jointiinfos[ji].info.m; r++) crow[nc++] = row + r;
+    }
+  } END_STATE_SAVE(context, setstate);
+
+  // order the nodes breadth first from the roots: the joints to the world
+  // and then the bodies of the trees that have none
+  int *order = context->AllocateArray<int> (n);
+  {
+    int tail = 0;
+    for (int i=nb; i<n; i++) {
+      const dxJoint *joint = jointiinfos[nodes[i].joint].joint;
+      if (!joint->node[0].body || !joint->node[1].body) {
+        nodes[i].side = 0;
+        order[tail++] = i;
+      }
+    }
+    int head = VisitTrees (body,nb,jointiinfos,nj,jnode,nodes,order,0,tail);
+    for (int i=0; i<nb; i++) {
+      if (nodes[i].side < 0) {
+        nodes[i].side = 0;
+        order[head] = i;
+        head = VisitTrees (body,nb,jointiinfos,nj,jnode,nodes,order,head,
+                           head + 1);
+      }
+    }
+    dIASSERT (head == n);
+  }
+
+  // the node blocks: the mass matrices of the bodies and -cfm/h for the
+  // joints. then factor
+  dReal *D = context->AllocateArray<dReal> (6*NODE_SKIP*n);
+  dReal *d = context->AllocateArray<dReal> (NODE_SKIP*n);
+  dReal *L = context->AllocateArray<dReal> (36*n);
+  dReal *e = context->AllocateArray<dReal> (m);
+
+  for (int i=0; i<m; i++) e[i] = cfm[i] * stepsize1;
+
+  dSetZero (D,6*NODE_SKIP*n);
+  for (int i=0; i<nb; i++) {
+    dReal *Di = D + 6*NODE_SKIP*i;
+    const dReal *Irow = I + 12*i;
+    for (int k=0; k<3; k++) {
+      Di[k*NODE_SKIP+k] = body[i]->mass.mass;
+      for (int l=0; l<3; l++) Di[(3+k)*NODE_SKIP+3+l] = Irow[k*4+l];
+    }
+  }
+  for (int i=nb; i<n; i++) {
+    dReal *Di = D + 6*NODE_SKIP*i;
+    for (int k=0; k<nodes[i].dim; k++)
+      Di[k*NODE_SKIP+k] = -e[nodes[i].row+k];
+  }
+
+  FactorForest (nodes, order, n, J, D, d, L);
+
+  // the PGS rows: velocities are limited as in quickstep, and the impulses
+  // are warm started from the last step
+  dReal *iMJ = context->AllocateArray<dReal> (12*m);
+  dReal *iAd = context->AllocateArray<dReal> (m);
+  dReal *p = context->AllocateArray<dReal> (m);
+  dReal *v = context->AllocateArray<dReal> (6*nb);
+  dReal *pc = context->AllocateArray<dReal> (6*nb);
+  dReal *x = context->AllocateArray<dReal> (6*n);
+
+  for (int i=0; i<m; i++) {
+    if (dFabs(c[i]) > c_v_max[i])
+      c[i] = c_v_max[i];
+  }
+
+  dSetZero (p,m);
+  dSetZero (pc,6*nb);
+  for (int ji=0; ji<nj; ji++) {
+    const dxJoint *joint = jointiinfos[ji].joint;
+    for (int r=0; r<jointiinfos[ji].info.m; r++)
+      p[jrow[ji]+r] = world->qs.warm_start * joint->lambda[r] * stepsize;
+  }
+
+  for (int k=0; k<nc; k++) {
+    const int i = crow[k];
+    const dReal *Jrow = J + 12*i;
+    dReal *iMJrow = iMJ + 12*i;
+    dReal Ad = e[i];
+    for (int s=0; s<2; s++) {
+      const int b = jb[2*i+s];
+      if (b < 0) {
+        dSetZero (iMJrow + 6*s,6);
+        continue;
+      }
+      for (int l=0; l<3; l++)
+        iMJrow[6*s+l] = body[b]->invMass * Jrow[6*s+l];
+      dMultiply0_331 (iMJrow + 6*s + 3,invI + 12*b,Jrow + 6*s + 3);
+      for (int l=0; l<6; l++) Ad += Jrow[6*s+l] * iMJrow[6*s+l];
+    }
+    iAd[i] = Ad > 0 ? dRecip(Ad) : 0;
+    AddRowTranspose (pc,Jrow,jb + 2*i,p[i]);
+  }
+
+  // block gauss-seidel: the tree exactly given the PGS impulses, then a
+  // PGS sweep given the velocities of the tree. without tree joints the
+  // bodies are only solved once, before the sweeps
+  const bool tree = n > nb;
+  const int iterations = nc > 0 ? world->qs.num_iterations : 0;
+  for (int it=0; it<=iterations; it++) {
+    if (it == 0 || tree || it == iterations) {
+      for (int i=0; i<nb; i++)
+        for (int k=0; k<6; k++) x[6*i+k] = mom[6*i+k] + pc[6*i+k];
+      for (int i=nb; i<n; i++)
+        for (int k=0; k<nodes[i].dim; k++) x[6*i+k] = c[nodes[i].row+k];
+
+      SolveForest (nodes, order, n, D, d, L, x);
+
+      memcpy (v,x,6*nb*sizeof(dReal));
+      for (int i=nb; i<n; i++)
+        for (int k=0; k<nodes[i].dim; k++) p[nodes[i].row+k] = -x[6*i+k];
+    }
+    if (it < iterations)
+      SweepRows (nc,crow,J,iMJ,jb,c,e,iAd,lo,hi,findex,world->qs.w,p,v,pc);
+  }
+
+  // rms of the velocity error of the rows, by kind, as quickstep reports it
+  {
+    dReal error[3] = {0, 0, 0};
+    int count[3] = {0, 0, 0};
+    for (int i=0; i<m; i++) {
+      const int kind = findex[i] == -1 ? 0 : (findex[i] == -2 ? 1 : 2);
+      const dReal r = c[i] - e[i]*p[i] - MultiplyRow (J + 12*i,jb + 2*i,v);
+      error[kind] += r*r;
+      count[kind]++;
+    }
+    const int total = count[0] + count[1] + count[2];
+    for (int k=0; k<3; k++)
+      world->qs.rms_constraint_residual[k] =
+        count[k] > 0 ? dSqrt(error[k] / count[k]) : 0;
+    world->qs.rms_constraint_residual[3] = total > 0 ?
+      dSqrt((error[0] + error[1] + error[2]) / total) : 0;
+    world->qs.num_contacts = count[1];
+  }
+
+  // save the forces for warm starting and the joint feedback
+  for (int ji=0; ji<nj; ji++) {
+    dxJoint *joint = jointiinfos[ji].joint;
+    const int infom = jointiinfos[ji].info.m;
+    const int row = jrow[ji];
+    for (int r=0; r<infom; r++) {
+      joint->lambda[r] = p[row+r] * stepsize1;
+      joint->lambda_erp[r] = joint->lambda[r];
+    }
+
+    dJointFeedback *fb = joint->feedback;
+    if (fb) {
+      dReal data[12];
+      dSetZero (data,12);
+      for (int r=0; r<infom; r++) {
+        const dReal *Jrow = J + 12*(row+r);
+        for (int l=0; l<12; l++) data[l] += Jrow[l] * joint->lambda[r];
+      }
+      for (int l=0; l<3; l++) {
+        fb->f1[l] = data[l];
+        fb->t1[l] = data[3+l];
+        fb->f2[l] = data[6+l];
+        fb->t2[l] = data[9+l];
+      }
+    }
+  }
+
+  // the constraint forces are what takes each body from its momentum to the
+  // solved velocity. they are summed into facc and tacc so that
+  // dBodyGetForce and dBodyGetTorque return the total force on the body
+  for (int i=0; i<nb; i++) {
+    dxBody *b = body[i];
+    const dReal *vrow = v + 6*i;
+    dReal Iw[3];
+    dMultiply0_331 (Iw,I + 12*i,vrow + 3);
+    for (int k=0; k<3; k++) {
+      b->facc[k] += (b->mass.mass * vrow[k] - mom[6*i+k]) * stepsize1;
+      b->tacc[k] += (Iw[k] - mom[6*i+3+k]) * stepsize1;
+      b->lvel[k] = vrow[k];
+      b->avel[k] = vrow[3+k];
+    }
+    dxStepBody (b,stepsize);
+  }
+
+  // zero all force accumulators
+  for (int i=0; i<nb; i++) {
+    dxBody *b = body[i];
+    dSetZero (b->facc,4);
+    dSetZero (b->tacc,4);
+  }
+}
+
+//****************************************************************************
+
+size_t dxEstimateSparseQuickStepMemoryRequirements (
+  dxBody * const * /*body*/, int nb, dxJoint * const *_joint, int _nj)
+{
+  int nj = 0, m = 0;
+  {
+    dxJoint::SureMaxInfo info;
+    for (int i=0; i<_nj; i++) {
+      _joint[i]->getSureMaxInfo (&info);
+      if (info.max_m > 0) {
+        nj++;
+        m += info.max_m;
+      }
+    }
+  }
+  const int n = nb + nj;
+
+  size_t res = 0;
+  res += 2 * dEFFICIENT_SIZE(sizeof(dReal) * 3 * 4 * nb); // for I, invI
+  res += dEFFICIENT_SIZE(sizeof(dReal) * 6 * nb); // for mom
+  res += dEFFICIENT_SIZE(sizeof(dJointWithInfo1) * _nj); // for jointiinfos
+  res += dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for J
+  res += 5 * dEFFICIENT_SIZE(sizeof(dReal) * m); // for c, cfm, lo, hi, c_v_max
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for findex
+  res += dEFFICIENT_SIZE(sizeof(int) * 2 * m); // for jb
+  res += dEFFICIENT_SIZE(sizeof(int) * nj); // for jrow
+  res += dEFFICIENT_SIZE(sizeof(dxSparseNode) * n); // for nodes
+  res += dEFFICIENT_SIZE(sizeof(int) * nj); // for jnode
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for crow
+  {
+    size_t sub1_res1 = dEFFICIENT_SIZE(sizeof(int) * (nb + 1)); // for set
+
+    size_t sub1_res2 = dEFFICIENT_SIZE(sizeof(int) * n); // for order
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 6 * NODE_SKIP * n); // for D
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * NODE_SKIP * n); // for d
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 36 * n); // for L
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * m); // for e
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
+    sub1_res2 += 2 * dEFFICIENT_SIZE(sizeof(dReal) * m); // for iAd, p
+    sub1_res2 += 2 * dEFFICIENT_SIZE(sizeof(dReal) * 6 * nb); // for v, pc
+    sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 6 * n); // for x
+
+    res += (sub1_res1 >= sub1_res2) ? sub1_res1 : sub1_res2;
+  }
+
+  return res;
+}
@@ -25,8 +25,9 @@
 #include "objects.h"
 #include "joints/joint.h"
 #include "util.h"
+#include "quickstep_worker_pool.h"
+#include <atomic>
 #include <boost/thread/recursive_mutex.hpp>
-#include <boost/bind.hpp>
 #include <gazebo/ode/timer.h>
 
 #undef REPORT_THREAD_TIMING
@@ -391,6 +392,8 @@ static size_t EstimateIslandsProcessingMemoryRequirements(dxWorld *world, size_t
   res += islandcounts;
   size_t islandreqs = dEFFICIENT_SIZE(world->nb * sizeof(size_t)); // keep separate islandreqs for each island
   res += islandreqs;
+  size_t islandstarts = dEFFICIENT_SIZE(world->nb * 2 * sizeof(int)); // body and joint offsets of each island, see dxProcessIslands
+  res += islandstarts;
 
   size_t bodiessize = dEFFICIENT_SIZE(world->nb * sizeof(dxBody*));
   size_t jointssize = dEFFICIENT_SIZE(world->nj * sizeof(dxJoint*));
@@ -593,6 +596,34 @@ void dxProcessOneIsland(dxWorldProcessContext *island_context, dxWorld *world, d
 #endif
 }
 
+// the islands of a step, shared by the island threads
+struct dxIslandsJob
+{
+  dxWorld *world;
+  dReal stepsize;
+  dstepper_fn_t stepper;
+  int islandcount;
+  int const *islandsizes;   // body and joint count of each island
+  int const *islandstarts;  // offset of the first body and joint of each island
+  dxBody *const *body;
+  dxJoint *const *joint;
+  std::atomic<int> nextisland;
+};
+
+// steps islands until there are none left, with the arena of the thread
+static void dxProcessIslandsOnThread(dxIslandsJob *job, int thread_index)
+{
+  dxWorldProcessContext *island_context = job->world->island_contexts[thread_index];
+  dIASSERT(island_context != NULL);
+
+  for (int ii = job->nextisland++; ii < job->islandcount; ii = job->nextisland++) {
+    int const *sizes = job->islandsizes + 2 * ii;
+    int const *starts = job->islandstarts + 2 * ii;
+    dxProcessOneIsland(island_context, job->world, job->stepsize, job->stepper,
+      job->body + starts[0], sizes[0], job->joint + starts[1], sizes[1]);
+  }
+}
+
 void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
 {
   const int sizeelements = 2;
@@ -609,12 +640,18 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   dxJoint *const *joint;
   context->RetrievePreallocations(islandcount, islandsizes, body, joint, islandreqs);
 
-  dxBody *const *bodystart = body;
-  dxJoint *const *jointstart = joint;
-
   IFTIMING(dTimerStart("preprocessing islands"));
-  int island_index = 0;
-  int const *const sizesend = islandsizes + islandcount * sizeelements;
+
+  // offsets of the islands in body and joint, so that any thread can step
+  // any island
+  int *islandstarts = context->AllocateArray<int>(islandcount * sizeelements);
+  int bodystart = 0, jointstart = 0;
+  for (int ii = 0; ii < islandcount; ii++) {
+    islandstarts[ii * sizeelements] = bodystart;
+    islandstarts[ii * sizeelements + 1] = jointstart;
+    bodystart += islandsizes[ii * sizeelements];
+    jointstart += islandsizes[ii * sizeelements + 1];
+  }
 
 #ifdef REPORT_THREAD_TIMING
   struct timeval tv;
@@ -624,35 +661,31 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   printf(">>>>>>>>>>>> start island spawn threads at time %f\n",cur_time);
 #endif
 
-  for (int const *sizescurr = islandsizes; sizescurr != sizesend; sizescurr += sizeelements) {
-    int bcount = sizescurr[0];
-    int jcount = sizescurr[1];
-
-    // get working memory for each island
-    dxStepWorkingMemory *island_wmem = world->island_wmems[island_index++];
-    dIASSERT(island_wmem != NULL);
-    dxWorldProcessContext *island_context = island_wmem->GetWorldProcessingContext();
-
-#define USE_TPISLAND
-#ifdef USE_TPISLAND
-    IFTIMING(dTimerNow("scheduling island"));
-    //printf("debug opende tp %d\n",world->threadpool->size());
-    if (world->threadpool && world->threadpool->size() > 0)
-      world->threadpool->schedule(boost::bind(dxProcessOneIsland,island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount));
-    else //automatically skip threadpool if only 1 thread allocated
-      dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount);
-#else
-    dxProcessOneIsland(island_context, world, stepsize, stepper,bodystart, bcount, jointstart, jcount);
-#endif
-
-    bodystart += bcount;
-    jointstart += jcount;
+  dxIslandsJob job;
+  job.world = world;
+  job.stepsize = stepsize;
+  job.stepper = stepper;
+  job.islandcount = islandcount;
+  job.islandsizes = islandsizes;
+  job.islandstarts = islandstarts;
+  job.body = body;
+  job.joint = joint;
+  job.nextisland = 0;
+
+  // the lambda only holds a pointer, small enough for std::function not to
+  // allocate
+  dxIslandsJob *pjob = &job;
+  IFTIMING(dTimerNow("stepping islands"));
+  if (islandcount > 1 && world->island_pool &&
+      world->island_pool->run([pjob](int thread_index)
+      {
+        dxProcessIslandsOnThread(pjob, thread_index);
+      })) {
+    // stepped by the island threads
+  }
+  else {
+    dxProcessIslandsOnThread(&job, 0);
   }
-#ifdef USE_TPISLAND
-  IFTIMING(dTimerNow("islands wait"));
-  if (world->threadpool && world->threadpool->size() > 0)
-    world->threadpool->wait();
-#endif
   IFTIMING(dTimerEnd());
   IFTIMING(dTimerReport (stdout,1));
 
@@ -663,9 +696,10 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
   printf("<<<<<<<<<<<< all island threads stopped at time %f with duration %f\n",end_time,end_time - cur_time);
 #endif
 
-  for (auto &m : world->island_wmems)
+  for (auto &island_context : world->island_contexts)
   {
-    m->GetWorldProcessingContext()->CleanupContext();
+    if (island_context)
+      island_context->CleanupContext();
   }
 
   context->CleanupContext();
@@ -745,6 +779,7 @@ static dxWorldProcessContext *InternalReallocateWorldProcessContext (
               shrunkcontext->m_pAllocBegin = blockbegin;
               shrunkcontext->m_pAllocEnd = blockend;
               shrunkcontext->m_pAllocCurrent = blockend; // -- set to end to prevent possibility of further allocation
+              shrunkcontext->m_pAllocPeak = blockend;
               shrunkcontext->m_pArenaBegin = pShrunkOldArena;
 
               size_t stOffset = ((size_t)pShrunkOldArena - (size_t)pOldArena) - offsetdiff;
@@ -785,6 +820,7 @@ static dxWorldProcessContext *InternalReallocateWorldProcessContext (
       context->m_pAllocEnd = blockend;
       context->m_pArenaBegin = pNewArena;
       context->m_pAllocCurrent = blockbegin;
+      context->m_pAllocPeak = blockbegin;
 
       if (oldcontext) {
         context->CopyPreallocations(oldcontext);
@@ -845,13 +881,17 @@ bool dxReallocateWorldProcessContext (dxWorld *world,
   dIASSERT(sesize == dEFFICIENT_SIZE(sesize));
 
   size_t stepperestimatereq = islandsreq + sesize;
-  context = InternalReallocateWorldProcessContext(context, stepperestimatereq, memmgr, 1.0f, reserveinfo->m_uiReserveMinimum);
+  context = InternalReallocateWorldProcessContext(context, stepperestimatereq, memmgr, reserveinfo->m_fReserveFactor, reserveinfo->m_uiReserveMinimum);
+  if (context != oldcontext) world->step_arena_grows++;
 
   //
   // above context allocation of the island arrays is successful, then we proceed to allocate more spaces for the actual stepping work
   //
-  // we want to start multiple contexts, one for each island.
+  // each island thread steps its islands one after the other from its own
+  // arena, which only grows, so that once the largest island has been seen
+  // stepping does not allocate
   //
+  bool success = context != NULL;
   if (context)
   {
     /*size_t stepperreq =*/ BuildIslandsAndEstimateStepperMemoryRequirements(context, world, stepsize, stepperestimate);
@@ -865,41 +905,37 @@ bool dxReallocateWorldProcessContext (dxWorld *world,
     dxJoint *const *joint;
     context->RetrievePreallocations(islandcount, islandsizes, body, joint, islandreqs);
 
-    if (static_cast<size_t>(islandcount) > world->island_wmems.size())
-      world->island_wmems.resize(islandcount);
-
+    size_t islandreq = 0;
     for (int jj = 0; jj < islandcount; jj++)
     {
-      dxStepWorkingMemory *island_wmem = NULL;
-
-      // for individual islands
-      // this is starting a new instance of dxStepWorkingMemory
-      if (!world->island_wmems[jj])
-      {
-        island_wmem = new dxStepWorkingMemory();
-        world->island_wmems[jj] = island_wmem;
-      }
-      else
-        island_wmem = world->island_wmems[jj];
+      if (islandreqs[jj] > islandreq)
+        islandreq = islandreqs[jj];
+    }
 
-      if (!island_wmem) return false;
+    size_t threadcount = world->island_pool ? world->island_pool->size() : 1;
+    if (threadcount > world->island_contexts.size())
+      world->island_contexts.resize(threadcount, NULL);
 
-      dxWorldProcessContext *island_oldcontext = island_wmem->GetWorldProcessingContext();
+    for (size_t tt = 0; tt < threadcount; tt++)
+    {
+      dxWorldProcessContext *island_oldcontext = world->island_contexts[tt];
       dIASSERT (!island_oldcontext || island_oldcontext->IsStructureValid());
 
-      const dxWorldProcessMemoryReserveInfo *island_reserveinfo = island_wmem->SureGetMemoryReserveInfo();
-      const dxWorldProcessMemoryManager *island_memmgr = island_wmem->SureGetMemoryManager();
+      dxWorldProcessContext *island_context = InternalReallocateWorldProcessContext(island_oldcontext, islandreq, memmgr, reserveinfo->m_fReserveFactor, reserveinfo->m_uiReserveMinimum);
+      if (island_context != island_oldcontext) world->step_arena_grows++;
+      world->island_contexts[tt] = island_context;
 
-      dxWorldProcessContext *island_context = island_oldcontext;
-
-      // this is where islandreqs is used, to MakeArenaSize
-      island_context = InternalReallocateWorldProcessContext(island_context, islandreqs[jj], island_memmgr, island_reserveinfo->m_fReserveFactor, island_reserveinfo->m_uiReserveMinimum);
-      island_wmem->SetWorldProcessingContext(island_context); // set dxStepWorkingMemory to context
+      if (!island_context)
+      {
+        context->CleanupContext();
+        success = false;
+        break;
+      }
     }
   }
 
   wmem->SetWorldProcessingContext(context); // set dxStepWorkingMemory to context
-  return context != NULL;
+  return success;
 }
 
 dxWorldProcessContext *dxReallocateTemporayWorldProcessContext(dxWorldProcessContext *oldcontext,
@@ -923,6 +959,19 @@ dxWorldProcessContext *dxReallocateTemporayWorldProcessContext(dxWorldProcessCon
   return context;
 }
 
+void dxFreeIslandProcessContexts (dxWorld *world)
+{
+  for (auto &island_context : world->island_contexts)
+  {
+    if (island_context)
+    {
+      dxFreeWorldProcessContext(island_context);
+      island_context = NULL;
+    }
+  }
+  world->step_arena_grows = 0;
+}
+
 void dxFreeWorldProcessContext (dxWorldProcessContext *context)
 {
   // Free old arena for the case if context is freed after reallocation without
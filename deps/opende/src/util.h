@@ -144,6 +144,12 @@ struct dxWorldProcessContext
     return (size_t)m_pAllocEnd - (size_t)m_pAllocBegin;
   }
 
+  // the most memory in use at once since the arena was allocated
+  size_t GetHighWaterSize() const
+  {
+    return (size_t)m_pAllocPeak - (size_t)m_pAllocBegin;
+  }
+
   void *SaveState() const
   {
     return m_pAllocCurrent;
@@ -169,6 +175,7 @@ struct dxWorldProcessContext
     void *block = m_pAllocCurrent;
     m_pAllocCurrent = dOFFSET_EFFICIENTLY(block, size);
     dIASSERT(m_pAllocCurrent <= m_pAllocEnd);
+    if (m_pAllocCurrent > m_pAllocPeak) m_pAllocPeak = m_pAllocCurrent;
     return block;
   }
 
@@ -203,6 +210,7 @@ struct dxWorldProcessContext
   void *m_pAllocBegin;
   void *m_pAllocEnd;
   void *m_pAllocCurrent;
+  void *m_pAllocPeak;
   void *m_pArenaBegin;
 
   int m_IslandCount;
@@ -235,6 +243,7 @@ bool dxReallocateWorldProcessContext (dxWorld *world,
 dxWorldProcessContext *dxReallocateTemporayWorldProcessContext(dxWorldProcessContext *oldcontext,
   size_t memreq, const dxWorldProcessMemoryManager *memmgr/*=NULL*/, const dxWorldProcessMemoryReserveInfo *reserveinfo/*=NULL*/);
 void dxFreeWorldProcessContext (dxWorldProcessContext *context);
+void dxFreeIslandProcessContexts (dxWorld *world);
 
 
 
@@ -6,11 +6,20 @@
 namespace parallel_ode
 {
 
+// the rows of a batch update the body accelerations in place. summing
+// the impulses of the rows of a body solved from the same accelerations
+// overshoots, so the batches are colored to keep the rows of a body apart
+// and are then solved by several threads. a box resting on another has 4
+// contacts of 3 rows below and above it, which needs more colors than the
+// GPU default.
 const int DEFAULT_OPENMP_FLAGS =
     ParallelFlags::PARALLEL_ALIGN
     | ParallelFlags::PARALLEL_RANDOMIZE
     | ParallelFlags::PARALLEL_ATOMICS;
 
+const BatchType DEFAULT_OPENMP_BATCH_TYPE = BatchTypes::BATCH_COLORED;
+const int DEFAULT_OPENMP_BATCHES = 64;
+
 template<typename T>
 class OpenMPPGSSolver : public ParallelPGSSolver<T, T, ParallelType::OpenMP>
 {
@@ -26,11 +35,12 @@ public:
    * @param numBatches The maximum number of batches to be used, if any
    */
   OpenMPPGSSolver( int parallelFlags = DEFAULT_OPENMP_FLAGS,
-                BatchType batchType = BatchTypes::DEFAULT_BATCH_TYPE,
+                BatchType batchType = DEFAULT_OPENMP_BATCH_TYPE,
                 ReduceType reduceType = ReduceTypes::DEFAULT_REDUCE_TYPE,
-                uint numBatches = ParallelOptions::MAXBATCHES )
+                uint numBatches = DEFAULT_OPENMP_BATCHES )
 
-      : ParallelPGSSolver<T, T, ParallelTypes::OpenMP>( parallelFlags, batchType, reduceType, numBatches ) {
+      : ParallelPGSSolver<T, T, ParallelTypes::OpenMP>( parallelFlags, batchType, reduceType, numBatches ),
+        bConflictFree_( false ) {
 
   }
 
@@ -43,6 +53,10 @@ protected:
   virtual void solveAndReduce( const int offset, const int batchSize );
 
   virtual void loadConstraints( );
+
+private:
+
+  bool bConflictFree_;                  /**< Whether no two constraints of a batch share a body */
 };
 
 }
@@ -69,7 +69,7 @@ public:
                      BatchVector& batchSizes );
 
   inline int getMaxBatches() const { return maxBatches_; }
-  inline void setMaxBatches( int maxBatches ) { maxBatches_ = maxBatches_; }
+  inline void setMaxBatches( int maxBatches ) { maxBatches_ = maxBatches; }
 
   inline bool isAligning() const { return bAlign_; }
   inline void setAlign( bool bAlign ) { bAlign_ = bAlign; }
@@ -114,6 +114,15 @@ protected:
    */
   static void batchIndicesFromBatchSizes( const BatchVector& batchSizes, BatchVector& batchIndices, bool bAlign, int alignment );
 
+  /**
+   * @brief Orders the constraints by batch, keeping their relative order within a batch
+   *
+   * @param constraintBatches The batch of each constraint
+   * @param batchSizes The number of constraints per batch
+   * @param constraintIndices The computed ordering, constraintIndices[ i ] is the ODE index of the i-th ordered constraint
+   */
+  static void orderByBatch( const BatchVector& constraintBatches, const BatchVector& batchSizes, BatchVector& constraintIndices );
+
 private:
 
   int maxBatches_;                      /**< The maximum number of batches */
@@ -465,6 +465,10 @@ inline dxHost dxDevice void operator-=(float4 &a, float4 b)
   a.x -= b.x; a.y -= b.y; a.z -= b.z; a.w -= b.w;
 }
 
+// defined below, needed by the template multiply
+inline dxHost dxDevice vec4<float>::Type make_vec4(float a, float b, float c, float d);
+inline dxHost dxDevice vec4<double>::Type make_vec4(double a, double b, double c, double d);
+
 // multiply
 template <typename T> inline dxHost dxDevice typename vec4<T>::Type operator*(typename vec4<T>::Type a, T s)
 {
@@ -1,7 +1,7 @@
 #ifndef PARALLEL_ODE_H
 #define PARALLEL_ODE_H
 
-#include <ode/objects.h>
+#include <gazebo/ode/objects.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,6 +13,11 @@ extern "C" {
 
   ODE_API void dWorldSetParallelQuickStepReduceType(dWorldID, int reduceType);
 
+  /* number of threads of the OpenMP solver, 0 or less for one per core */
+  ODE_API void dWorldSetParallelQuickStepThreads(dWorldID, int threads);
+
+  ODE_API int dWorldGetParallelQuickStepThreads(dWorldID);
+
 #ifdef __cplusplus
 }
 #endif
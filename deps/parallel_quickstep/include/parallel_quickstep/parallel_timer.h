@@ -1,7 +1,7 @@
 #ifndef PARALLEL_TIMER_H
 #define PARALLEL_TIMER_H
 
-#include <ode/timer.h>
+#include <gazebo/ode/timer.h>
 #include "parallel_common.h"
 
 class ParallelTimer
@@ -16,7 +16,7 @@ namespace parallel_ode
 template <typename T>
 void ompZeroVector( T *buffer, int bufferSize )
 {
-  //#pragma omp parallel for
+#pragma omp parallel for if(bufferSize > OMP_MIN_PARALLEL_SIZE)
   for(int index = 0; index < bufferSize; ++index) {
     buffer[ index ] = parallel_zero<T>();
   }
@@ -38,12 +38,16 @@ void ompPGSReduce( typename vec4<T>::Type *fc0,
 
   const Vec4T zeroVec = make_vec4( (T)0.0 );
 
-  //#pragma omp parallel for
+#pragma omp parallel for if(bodySize > OMP_MIN_PARALLEL_SIZE)
   for(int index = 0; index < bodySize; ++index) {
     int nextIndex = index + reductionStride;
 
+    // every slot is cleared once summed, a slot which is not written by the
+    // next batch must not be added again
     Vec4T sum0 = fc0_reduction[ index ];
+    fc0_reduction[ index ] = zeroVec;
     Vec4T sum1 = fc1_reduction[ index ];
+    fc1_reduction[ index ] = zeroVec;
 
     while(nextIndex < reductionSize) {
       sum0 += fc0_reduction[ nextIndex ];
@@ -73,11 +77,14 @@ void ompPGSSolve( int4 *bodyIDs,
                   T* rhs,
                   T* hilo,
                   int offset, int numConstraints, bool bUseAtomics,
-                  int bStride, int cStride)
+                  bool bParallel, int bStride, int cStride)
 {
   typedef typename vec4<T>::Type Vec4T;
 
-  //#pragma omp parallel for
+  // with atomics the rows of a batch update the body accelerations in
+  // place, which the caller only allows in parallel when no two rows of
+  // the batch share a body
+#pragma omp parallel for if(bParallel && numConstraints > OMP_MIN_PARALLEL_SIZE)
   for(int localIndex = 0; localIndex < numConstraints; ++localIndex) {
 
     const int index = localIndex + offset;
@@ -194,6 +201,7 @@ template void ompPGSSolve<dReal>( int4 *bodyIDs,
                                   dReal *adcfm,
                                   dReal *rhs,
                                   dReal *hilo,
-                                  int batch, int numConstraints, bool bUseAtomics, int bStride, int cStride );
+                                  int batch, int numConstraints, bool bUseAtomics, bool bParallel,
+                                  int bStride, int cStride );
 
 }
@@ -6,6 +6,10 @@ class ReduceStrategy;
 #include <parallel_common.h>
 #include <parallel_math.h>
 
+// loops over fewer items than this run on the calling thread, the cost of
+// waking the team is larger than the work
+#define OMP_MIN_PARALLEL_SIZE 256
+
 namespace parallel_ode
 {
 
@@ -32,7 +36,8 @@ void ompPGSSolve( int4 *bodyIDs,
                   T* adcfm,
                   T* rhs,
                   T* hilo,
-                  int offset, int numConstraints, bool bUseAtomics, int bStride, int cStride );
+                  int offset, int numConstraints, bool bUseAtomics, bool bParallel,
+                  int bStride, int cStride );
 
 }
 #endif
@@ -26,6 +26,7 @@ void OpenMPPGSSolver<T>::solveAndReduce( const int offset, const int batchSize )
                   offset,
                   batchSize,
                   this->atomicsEnabled( ),
+                  !this->atomicsEnabled( ) || bConflictFree_,
                   this->getBodyStride( ),
                   this->getConstraintStride( ) );
 
@@ -43,6 +44,12 @@ void OpenMPPGSSolver<T>::loadConstraints( )
 {
   ParallelPGSSolver<T,T,ParallelTypes::OpenMP>::loadConstraints( );
 
+  // the coloring may run out of batches, the rows of a body then share a
+  // batch and have to be solved in turn
+  bConflictFree_ = true;
+  for( size_t batchID = 0; batchID < this->batchRepetitionCount_.size(); ++batchID )
+    bConflictFree_ = bConflictFree_ && this->batchRepetitionCount_[ batchID ] <= 1;
+
   // Zero out the force accumulation vector
   if( this->reduceEnabled( ) ) {
     ompZeroVector<Vec4T>(this->bodyFAccReduction.getHostBuffer( ), this->bodyFAccReduction.getSize( ));
@@ -1,8 +1,8 @@
 #include <parallel_batch.h>
 #include <parallel_utils.h>
 
-#include <map>
-#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace parallel_ode
 {
@@ -10,10 +10,6 @@ namespace parallel_ode
 using ::parallel_utils::permuteVector;
 using ::parallel_utils::fillSequentialVector;
 
-typedef boost::unordered_map<int, int> BatchMap;
-typedef std::multimap<int, int, std::greater<int> > BatchMultimap;
-typedef BatchMultimap::iterator BatchMultimapIterator;
-
 int BatchStrategy::baseBatch( const int* pairList,
                               const BatchVector& constraintIndices,
                               const BatchVector& batchSizes,
@@ -39,6 +35,20 @@ void BatchStrategy::batchIndicesFromBatchSizes( const BatchVector& batchSizes, B
   }
 }
 
+void BatchStrategy::orderByBatch( const BatchVector& constraintBatches, const BatchVector& batchSizes, BatchVector& constraintIndices )
+{
+  BatchVector batchOffsets( batchSizes.size() );
+  for( size_t batchID = 0, batchOffset = 0; batchID < batchSizes.size(); batchID++ )
+  {
+    batchOffsets[ batchID ] = batchOffset;
+    batchOffset += batchSizes[ batchID ];
+  }
+
+  constraintIndices.resize( constraintBatches.size() );
+  for( size_t constraintID = 0; constraintID < constraintBatches.size(); ++constraintID )
+    constraintIndices[ batchOffsets[ constraintBatches[ constraintID ] ]++ ] = constraintID;
+}
+
 int BatchStrategy::batchRepetitionCount( const int *pairList,
                                          const BatchVector& constraintIndices,
                                          const BatchVector& batchSizes,
@@ -49,7 +59,16 @@ int BatchStrategy::batchRepetitionCount( const int *pairList,
   maxBodyRepetitionCountInBatch.resize( getMaxBatches() );
 
   int maxRepetitionCount = 0;
-  BatchVector bodyRepetitionMap( bodyRepetitionCount0.size() );
+
+  // the map is indexed by body, size it for the largest body id
+  int numBodies = 0;
+  for( size_t batchID = 0, constraintID = 0; batchID < batchSizes.size(); batchID++ ) {
+    for( int iter = 0; iter < batchSizes[ batchID ]; ++iter,++constraintID ) {
+      numBodies = std::max( numBodies, pairList[ constraintIndices[ constraintID ]*2 ] + 1 );
+      numBodies = std::max( numBodies, pairList[ constraintIndices[ constraintID ]*2+1 ] + 1 );
+    }
+  }
+  BatchVector bodyRepetitionMap( numBodies );
 
   for( size_t batchID = 0, constraintID = 0; batchID < batchSizes.size(); batchID++ )
   {
@@ -94,7 +113,7 @@ int BatchStrategy::batch( const int* pairList, const int numConstraints, const i
   permuteVector( constraintIndices );
 
   const int batchSize = numConstraints / getMaxBatches( );
-  batchSizes[ 0 ] = batchSize + ( numConstraints % batchSize );
+  batchSizes[ 0 ] = numConstraints - batchSize * ( getMaxBatches( ) - 1 );
   for( int batchID = 1; batchID < getMaxBatches(); ++batchID ) {
     batchSizes[ batchID ] = batchSize;
   }
@@ -149,15 +168,9 @@ int GreedyBatchStrategy::batch( const int* pairList, const int numConstraints, c
     }
   } while( constraintsUsed < numConstraints);
 
-  BatchVector batchSizesCopy = batchSizes;
-  BatchVector constraintIndicesCopy = constraintIndices;
-
   // Now recover the ordered constraint indices from their batch assignment
-  for(int constraintID = 0; constraintID < numConstraints; ++constraintID) {
-    const int constraintBatchID = constraintIndicesCopy[ constraintID ];
-    const int newConstraintID = --batchSizesCopy[ constraintBatchID ];
-    constraintIndices[ constraintID ] = newConstraintID;
-  }
+  BatchVector constraintBatches = constraintIndices;
+  orderByBatch( constraintBatches, batchSizes, constraintIndices );
 
   return baseBatch( pairList, constraintIndices, batchSizes, batchIndices, bodyRepetitionCount0, bodyRepetitionCount1, maxBodyRepetitionCountInBatch );
 }
@@ -170,116 +183,79 @@ int ColoringBatchStrategy::batch( const int* pairList, const int numConstraints,
                                   BatchVector& batchIndices,
                                   BatchVector& batchSizes )
 {
-  BatchMultimap bodyConstraintMap;
-  BatchMultimap constraintHeap;
-
-  std::vector<BatchMultimapIterator> pointers( numConstraints );
-  BatchVector colors( numConstraints, std::numeric_limits<int>::max() );
-
-  int maxDegree( 0 ), numColors( 1 ), degree;
-
-  // Build body to constraint map
-  for( int constraintID = 0; constraintID < numConstraints; ++constraintID )
-  {
-    bodyConstraintMap.insert( std::make_pair( pairList[ constraintID*2 ], constraintID ) );
-    bodyConstraintMap.insert( std::make_pair( pairList[ constraintID*2 + 1 ], constraintID ) );
+  // runs every step, so the per body state lives in flat arrays rather
+  // than in maps. the static environment (-1) does not couple the
+  // constraints attached to it.
+  const int maxColors = getMaxBatches();
+  BatchVector bodyDegree( numBodies, 0 );
+  for( int constraintID = 0; constraintID < numConstraints; ++constraintID ) {
+    if( pairList[ constraintID*2 ] >= 0 ) ++bodyDegree[ pairList[ constraintID*2 ] ];
+    if( pairList[ constraintID*2 + 1 ] >= 0 ) ++bodyDegree[ pairList[ constraintID*2 + 1 ] ];
   }
 
-  // Find the maximal degree, and degree, for each constraint
-  for( int constraintID  = 0; constraintID < numConstraints; ++constraintID ) {
-    const int b1( pairList[ constraintID*2 ] );
-    const int b2( pairList[ constraintID*2 + 1 ] );
-
-    int degree = 0;
-
-    if( b1 >= 0 && b2 >= 0)
-      degree = bodyConstraintMap.count( b1 ) + bodyConstraintMap.count( b2 ) - 1;
-    else if( b1 >= 0 )
-      degree = bodyConstraintMap.count( b1 );
-    else if( b2 >= 0 )
-      degree = bodyConstraintMap.count( b2 );
-
-    if( degree > 0 ) {
-      pointers[ constraintID ] = constraintHeap.insert( std::make_pair( degree, constraintID ) );
-      maxDegree = std::max( maxDegree, degree );
-    }
+  // Color the most connected constraints first
+  BatchVector degrees( numConstraints, 0 );
+  int maxDegree = 0;
+  for( int constraintID = 0; constraintID < numConstraints; ++constraintID ) {
+    const int b1 = pairList[ constraintID*2 ];
+    const int b2 = pairList[ constraintID*2 + 1 ];
+    degrees[ constraintID ] = ( b1 >= 0 ? bodyDegree[ b1 ] : 0 ) + ( b2 >= 0 ? bodyDegree[ b2 ] : 0 );
+    maxDegree = std::max( maxDegree, degrees[ constraintID ] );
   }
-
-  BatchVector occurrences( getMaxBatches() );
-  BatchVector colorCount( numColors, 0 );
-
-  while( !constraintHeap.empty() ) {
-    int constraintID = constraintHeap.begin()->second;
-    constraintHeap.erase( constraintHeap.begin() );
-    occurrences.assign( numColors, 0 );
-
-    const int bodyIDs[2] = { pairList[ constraintID*2 ], pairList[ constraintID*2 + 1 ] };
-
-    for( int j = 0; j < 2; ++j) {
-
-      BatchMultimapIterator it = bodyConstraintMap.find( bodyIDs[ j ] );
-      if( it == bodyConstraintMap.end() ) continue;
-      BatchMultimapIterator end = bodyConstraintMap.upper_bound( bodyIDs[ j ] );
-
-      for(; it != end; ++it ) {
-        int bodyConstraintID = it->second;
-        if( bodyConstraintID == constraintID ) continue;
-
-        if( colors[ bodyConstraintID ] < numColors ) {
-          // Exclude color
-          ++occurrences[ colors[ bodyConstraintID ] ];
-        }
-        else {
-          // Decrement degree ( the constraint has been assigned )
-          degree = pointers[ bodyConstraintID ]->first;
-          if( pointers[bodyConstraintID] == constraintHeap.begin() ) {
-            constraintHeap.erase( pointers[ bodyConstraintID ] );
-            pointers[ bodyConstraintID ] = constraintHeap.insert( std::make_pair( degree - 1, bodyConstraintID ) );
-          }
-          else {
-            constraintHeap.erase( pointers[ bodyConstraintID ]-- );
-            pointers[ bodyConstraintID ] = constraintHeap.insert( pointers[ bodyConstraintID ], std::make_pair( degree - 1, bodyConstraintID ) );
-          }
-        }
-      }
-    }
-
-    // Ensure creation of a well-balanced coloring
+  // a counting sort on the degrees, reversed to sort them down
+  BatchVector degreeSizes( maxDegree + 1, 0 );
+  for( int constraintID = 0; constraintID < numConstraints; ++constraintID ) {
+    degrees[ constraintID ] = maxDegree - degrees[ constraintID ];
+    ++degreeSizes[ degrees[ constraintID ] ];
+  }
+  BatchVector order;
+  orderByBatch( degrees, degreeSizes, order );
+
+  // number of constraints of each color attached to each body
+  BatchVector bodyColors( (size_t)numBodies * maxColors, 0 );
+  BatchVector colors( numConstraints, 0 );
+  BatchVector colorCount( 1, 0 );
+  int numColors = 1;
+
+  for( int orderID = 0; orderID < numConstraints; ++orderID ) {
+    const int constraintID = order[ orderID ];
+    const int b1 = pairList[ constraintID*2 ];
+    const int b2 = pairList[ constraintID*2 + 1 ];
+    const int *colors1 = b1 >= 0 ? &bodyColors[ (size_t)b1 * maxColors ] : NULL;
+    const int *colors2 = b2 >= 0 ? &bodyColors[ (size_t)b2 * maxColors ] : NULL;
+
+    // Ensure creation of a well-balanced coloring: the color sharing the
+    // fewest bodies, then the least used one
     int minColor = 0;
-    for( int colorID = 1; colorID < numColors; ++colorID )
-    {
-      if( ( occurrences[ colorID ] <  occurrences[ minColor ] ) ||
-          ( occurrences[ colorID ] == occurrences[ minColor ] && colorCount[ colorID ] < colorCount[ minColor ] ) )
-      {
+    int minOccurrences = std::numeric_limits<int>::max();
+    for( int colorID = 0; colorID < numColors; ++colorID ) {
+      const int occurrences = ( colors1 ? colors1[ colorID ] : 0 ) + ( colors2 ? colors2[ colorID ] : 0 );
+      if( occurrences < minOccurrences ||
+          ( occurrences == minOccurrences && colorCount[ colorID ] < colorCount[ minColor ] ) ) {
         minColor = colorID;
+        minOccurrences = occurrences;
       }
     }
 
-    if( occurrences[ minColor ] > 0 && numColors < getMaxBatches() )
-    {
-      colors[ constraintID ] = numColors++;
-      colorCount.resize( numColors );
-      colorCount[ colors[ constraintID ] ] = 1;
-    }
-    else
-    {
-      colors[ constraintID ] = minColor;
-      colorCount[ colors[ constraintID ] ]++;
+    if( minOccurrences > 0 && numColors < maxColors ) {
+      minColor = numColors++;
+      colorCount.push_back( 0 );
     }
+
+    colors[ constraintID ] = minColor;
+    ++colorCount[ minColor ];
+    if( b1 >= 0 ) ++bodyColors[ (size_t)b1 * maxColors + minColor ];
+    if( b2 >= 0 ) ++bodyColors[ (size_t)b2 * maxColors + minColor ];
   }
 
-  batchSizes.resize( getMaxBatches(), 0 );
+  // the solver goes through getMaxBatches() batches, the unused ones are empty
   batchSizes = colorCount;
-  batchIndicesFromBatchSizes( batchSizes, batchIndices, isAligning( ), getAlignment( ) );
+  batchSizes.resize( getMaxBatches(), 0 );
 
   // Assign indices from colors
-  for( int constraintID = 0; constraintID < numConstraints; ++constraintID ) {
-    const int constraintBatchID = colors[ constraintID ];
-    constraintIndices[ constraintID ] = batchIndices[ constraintBatchID ] + ( batchSizes[ constraintBatchID ] - colorCount[ constraintBatchID ] );
-    --colorCount[ constraintBatchID ];
-  }
+  orderByBatch( colors, batchSizes, constraintIndices );
 
-  return batchRepetitionCount( pairList, constraintIndices, batchSizes, bodyRepetitionCount0, bodyRepetitionCount1, maxBodyRepetitionCountInBatch );
+  return baseBatch( pairList, constraintIndices, batchSizes, batchIndices, bodyRepetitionCount0, bodyRepetitionCount1, maxBodyRepetitionCountInBatch );
 }
 
 }
@@ -4,6 +4,10 @@
 #include "quickstep.h"
 #include "util.h"
 
+#if defined(USE_OPENMP)
+#include <omp.h>
+#endif
+
 /** @todo Add the cs object to dxWorld */
 static dxParallelStepParameters cs;
 
@@ -14,6 +18,11 @@ int dWorldParallelQuickStep (dWorldID w, dReal stepsize)
 
   bool result = false;
 
+#if defined(USE_OPENMP)
+  // the thread count is per calling thread, set it on the stepping one
+  omp_set_num_threads( w->parallel_threads > 0 ? w->parallel_threads : omp_get_num_procs() );
+#endif
+
   if( dxReallocateParallelWorldProcessContext (w, stepsize, &dxEstimateParallelStepMemoryRequirements) ) {
     dxParallelProcessIslands (w, stepsize, &dxParallelQuickStepper);
     result = true;
@@ -36,5 +45,14 @@ void dWorldSetParallelQuickStepReduceType(dWorldID w, int reduceType)
   cs.reduceType = reduceType;
 }
 
+void dWorldSetParallelQuickStepThreads(dWorldID w, int threads)
+{
+  dAASSERT(w);
+  w->parallel_threads = threads > 0 ? threads : 0;
+}
 
-
+int dWorldGetParallelQuickStepThreads(dWorldID w)
+{
+  dAASSERT(w);
+  return w->parallel_threads;
+}
@@ -223,6 +223,16 @@ void ParallelPGSSolver<CudaT,ParamsT,PType>::loadConstraints( )
   int *fIDP = fIDs.getHostBuffer();
   Vec4T *jP = j0.getHostBuffer();
 
+  // the rows are stored in batch order, the friction rows have to point at
+  // the stored position of their normal row rather than at its ODE index
+  IntVector storedIndex( constraintIndices_.size(), -1 );
+  for(size_t batchID = 0, hIndex = 0; batchID < batchSizes_.size(); ++batchID)
+  {
+    size_t dIndex = batchIndices_[ batchID ];
+    for(int batchCount = 0; batchCount < batchSizes_[ batchID ]; ++batchCount,++hIndex,++dIndex)
+      storedIndex[ constraintIndices_[hIndex] ] = dIndex;
+  }
+
   for(size_t batchID = 0, hIndex = 0; batchID < batchSizes_.size(); ++batchID)
   {
     size_t dIndex = batchIndices_[ batchID ];
@@ -239,7 +249,8 @@ void ParallelPGSSolver<CudaT,ParamsT,PType>::loadConstraints( )
 
       bodyIDsP[dIndex]  = make_int4( body0ID, body1ID, body0ReductionID, body1ReductionID );
 
-      fIDP[dIndex]   = parallelParams_->findex[ scalarIndex ];
+      const int normalIndex = parallelParams_->findex[ scalarIndex ];
+      fIDP[dIndex]   = normalIndex < 0 ? -1 : storedIndex[ normalIndex ];
       rhsP[dIndex]   = parallelParams_->b[ scalarIndex ];
       adcfmP[dIndex] = parallelParams_->Adcfm[ scalarIndex ];
 
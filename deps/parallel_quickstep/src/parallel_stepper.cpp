@@ -1,11 +1,11 @@
-#include <ode/objects.h>
-#include <ode/ode.h>
-#include <ode/odemath.h>
-#include <ode/rotation.h>
-#include <ode/timer.h>
-#include <ode/error.h>
-#include <ode/matrix.h>
-#include <ode/misc.h>
+#include <gazebo/ode/objects.h>
+#include <gazebo/ode/ode.h>
+#include <gazebo/ode/odemath.h>
+#include <gazebo/ode/rotation.h>
+#include <gazebo/ode/timer.h>
+#include <gazebo/ode/error.h>
+#include <gazebo/ode/matrix.h>
+#include <gazebo/ode/misc.h>
 #include "objects.h"
 #include "config.h"
 #include "joints/joint.h"
@@ -577,6 +577,7 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
 
   if (m > 0) {
     dReal *cfm, *lo, *hi, *rhs, *Jcopy;
+    dReal *c_v_max;
     int *findex;
 
     {
@@ -601,6 +602,9 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
       findex = context->AllocateArray<int> (mlocal);
       for (int i=0; i<mlocal; i++) findex[i] = -1;
 
+      c_v_max = context->AllocateArray<dReal> (mlocal);
+      for (int i=0; i<mlocal; i++) c_v_max[i] = world->contactp.max_vel; // init all to world max surface vel
+
       const unsigned jbelements = mlocal*2;
       jb = context->AllocateArray<int> (jbelements);
 
@@ -649,6 +653,7 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
           Jinfo.lo = lo + ofsi;
           Jinfo.hi = hi + ofsi;
           Jinfo.findex = findex + ofsi;
+          Jinfo.c_v_max = c_v_max + ofsi;
 
 
           // now write all information into J
@@ -719,7 +724,12 @@ void dxParallelQuickStepper( dxWorldProcessContext *context,
       } END_STATE_SAVE(context, tmp1state);
 
       // complete rhs
-      for (int i=0; i<m; i++) rhs[i] = c[i]*stepsize1 - rhs[i];
+      for (int i=0; i<m; i++) {
+        if (dFabs(c[i]) > c_v_max[i])
+          rhs[i] = c_v_max[i]*stepsize1 - rhs[i];
+        else
+          rhs[i] = c[i]*stepsize1 - rhs[i];
+      }
 
       // scale CFM
       for (int j=0; j<m; j++) cfm[j] *= stepsize1;
@@ -918,7 +928,7 @@ size_t dxEstimateParallelStepMemoryRequirements (
     size_t sub1_res2 = dEFFICIENT_SIZE(sizeof(dJointWithInfo1) * nj); // for shrunk jointiinfos
     if (m > 0) {
       sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for J
-      sub1_res2 += 4 * dEFFICIENT_SIZE(sizeof(dReal) * m); // for cfm, lo, hi, rhs
+      sub1_res2 += 5 * dEFFICIENT_SIZE(sizeof(dReal) * m); // for cfm, lo, hi, rhs, c_v_max
       sub1_res2 += dEFFICIENT_SIZE(sizeof(int) * 12 * m); // for jb            FIXME: shoulbe be 2 not 12?
       sub1_res2 += dEFFICIENT_SIZE(sizeof(int) * m); // for findex
       sub1_res2 += dEFFICIENT_SIZE(sizeof(dReal) * 12 * mfb); // for Jcopy
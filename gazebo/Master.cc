@@ -15,7 +15,9 @@
  *
 */
 
+#include <condition_variable>
 #include <functional>
+#include <map>
 #include <thread>
 #include <mutex>
 
@@ -35,6 +37,16 @@ namespace gazebo
 {
   struct MasterPrivate
   {
+    /// \brief Wake up the run loop.
+    void Notify()
+    {
+      {
+        std::lock_guard<std::mutex> lock(this->runMutex);
+        this->runPending = true;
+      }
+      this->runCondition.notify_all();
+    }
+
     /// \brief All the known publishers.
     gazebo::Master::PubList publishers;
 
@@ -64,6 +76,19 @@ namespace gazebo
 
     /// \brief Mutex to protect msg bufferes.
     std::recursive_mutex msgsMutex;
+
+    /// \brief Connections to the shutdown events of the connections.
+    std::map<unsigned int, event::ConnectionPtr> shutdownConnections;
+
+    /// \brief True when the run loop has work to do.
+    bool runPending = false;
+
+    /// \brief Mutex to protect runPending.
+    std::mutex runMutex;
+
+    /// \brief Signaled when a message arrives, a connection is closed or
+    /// the master is stopped.
+    std::condition_variable runCondition;
   };
 }
 
@@ -135,6 +160,11 @@ void Master::OnAccept(transport::ConnectionPtr _newConnection)
 
     this->dataPtr->connections[index] = _newConnection;
 
+    // Remove the connection as soon as it's closed
+    this->dataPtr->shutdownConnections[index] =
+        _newConnection->ConnectToShutdown(
+          boost::bind(&MasterPrivate::Notify, this->dataPtr.get()));
+
     // Start reading from the connection
     _newConnection->AsyncRead(
         boost::bind(&Master::OnRead, this, index, _1));
@@ -162,8 +192,11 @@ void Master::OnRead(const unsigned int _connectionIndex,
   // Store the message if it's not empty
   if (!_data.empty())
   {
-    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->msgsMutex);
-    this->dataPtr->msgs.push_back(std::make_pair(_connectionIndex, _data));
+    {
+      std::lock_guard<std::recursive_mutex> lock(this->dataPtr->msgsMutex);
+      this->dataPtr->msgs.push_back(std::make_pair(_connectionIndex, _data));
+    }
+    this->dataPtr->Notify();
   }
   else
   {
@@ -384,7 +417,14 @@ void Master::Run()
   while (!this->dataPtr->stop)
   {
     this->RunOnce();
-    common::Time::MSleep(10);
+
+    // Sleep until a message arrives or a connection is closed
+    std::unique_lock<std::mutex> lock(this->dataPtr->runMutex);
+    this->dataPtr->runCondition.wait(lock, [this]
+        {
+          return this->dataPtr->runPending || this->dataPtr->stop;
+        });
+    this->dataPtr->runPending = false;
   }
 }
 
@@ -490,6 +530,7 @@ void Master::RemoveConnection(Connection_M::iterator _connIter)
     }
   }
 
+  this->dataPtr->shutdownConnections.erase(_connIter->first);
   this->dataPtr->connections.erase(_connIter);
 }
 
@@ -554,6 +595,7 @@ void Master::RemoveSubscriber(const msgs::Subscribe _sub)
 void Master::Stop()
 {
   this->dataPtr->stop = true;
+  this->dataPtr->Notify();
 
   if (this->dataPtr->runThread)
   {
@@ -568,6 +610,11 @@ void Master::Fini()
 {
   this->Stop();
 
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->connectionMutex);
+    this->dataPtr->shutdownConnections.clear();
+  }
+
   if (this->dataPtr->connection)
     this->dataPtr->connection->Shutdown();
   this->dataPtr->connection.reset();
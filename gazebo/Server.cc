@@ -175,6 +175,10 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_filter", po::value<std::string>()->default_value(""),
      "Recording filter (supports wildcard and regular expression).")
     ("record_resources", "Recording with model meshes and materials.")
+    ("record_compression", po::value<int>()->default_value(-1),
+     "Compression level for log data (zlib: 0-9, bz2: 1-9, -1: default).")
+    ("record_workers", po::value<unsigned int>()->default_value(0),
+     "Number of threads compressing log data (0: automatic).")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
@@ -696,6 +700,9 @@ void Server::ProcessParams()
       params.filter = this->dataPtr->vm["record_filter"].as<std::string>();
       params.recordResources =
           this->dataPtr->params.count("record_resources") > 0;
+      params.compressionLevel =
+          this->dataPtr->vm["record_compression"].as<int>();
+      params.workers = this->dataPtr->vm["record_workers"].as<unsigned int>();
       util::LogRecord::Instance()->Start(params);
     }
   }
@@ -15,6 +15,9 @@
  *
  */
 
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Event.hh"
 
@@ -44,6 +47,19 @@ void Event::SetSignaled(const bool _sig)
   this->signaled = _sig;
 }
 
+//////////////////////////////////////////////////
+void Event::RunConcurrently(const size_t _count,
+    const std::function<void(const size_t)> &_task)
+{
+  // One task per range, callbacks are expected to be coarse
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, _count, 1),
+      [&_task](const tbb::blocked_range<size_t> &_range)
+      {
+        for (size_t i = _range.begin(); i != _range.end(); ++i)
+          _task(i);
+      });
+}
+
 //////////////////////////////////////////////////
 Connection::Connection(Event *_e, const int _i)
   : event(_e), id(_i)
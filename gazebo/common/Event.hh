@@ -23,10 +23,14 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "gazebo/gazebo_config.h"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/util/system.hh"
 
 #include "ignition/common/Profiler.hh"
@@ -62,10 +66,60 @@ namespace gazebo
       /// \param[in] _sig True if the event has been signaled.
       public: void SetSignaled(const bool _sig);
 
+      /// \brief Run tasks concurrently on the shared task pool, and wait
+      /// for all of them to return.
+      /// \param[in] _count Number of tasks.
+      /// \param[in] _task Function called with the index of each task.
+      protected: static void RunConcurrently(const size_t _count,
+                     const std::function<void(const size_t)> &_task);
+
       /// \brief True if the event has been signaled.
       private: bool signaled;
     };
 
+    /// \brief Options of a connection to an event.
+    class GZ_COMMON_VISIBLE ConnectionOptions
+    {
+      /// \brief Name reported in the connection timings, such as the name
+      /// of the plugin which made the connection.
+      public: std::string name;
+
+      /// \brief True if the callback only touches state owned by the
+      /// subscriber, such as a model plugin which only reads and writes its
+      /// own model. Such callbacks may run concurrently with each other,
+      /// on other threads than the one signaling the event.
+      ///
+      /// Locks held by the signaling thread are not held by these threads.
+      /// World::Update signals its events with the world update mutex
+      /// locked, so a concurrent callback of a world event must not call
+      /// World functions which lock it, such as Reset, SetPaused or Step:
+      /// it would deadlock.
+      public: bool concurrent = false;
+    };
+
+    /// \brief Timing of the calls of a connection. Durations are in
+    /// seconds.
+    class GZ_COMMON_VISIBLE ConnectionTiming
+    {
+      /// \brief Id of the connection.
+      public: int id = -1;
+
+      /// \brief Name given in the connection options.
+      public: std::string name;
+
+      /// \brief True if the callback may run concurrently.
+      public: bool concurrent = false;
+
+      /// \brief Number of timed calls.
+      public: uint64_t count = 0;
+
+      /// \brief Total duration of the calls.
+      public: double total = 0;
+
+      /// \brief Longest call.
+      public: double max = 0;
+    };
+
     /// \brief A class that encapsulates a connection.
     class GZ_COMMON_VISIBLE Connection
     {
@@ -95,6 +149,10 @@ namespace gazebo
     };
 
     /// \brief A class for event processing.
+    ///
+    /// Signaling doesn't take any lock: it iterates over an immutable
+    /// snapshot of the connections, which is replaced when a connection is
+    /// made or removed.
     template<typename T>
     class EventT : public Event
     {
@@ -110,6 +168,16 @@ namespace gazebo
       /// Disconnect when it goes out of scope.
       public: ConnectionPtr Connect(const std::function<T> &_subscriber);
 
+      /// \brief Connect a callback to this event.
+      /// See ConnectionOptions::concurrent for what a concurrent callback
+      /// must not do.
+      /// \param[in] _subscriber Pointer to a callback function.
+      /// \param[in] _options Options of the connection.
+      /// \return A Connection object, which will automatically call
+      /// Disconnect when it goes out of scope.
+      public: ConnectionPtr Connect(const std::function<T> &_subscriber,
+                  const ConnectionOptions &_options);
+
       /// \brief Disconnect a callback to this event.
       /// \param[in] _id The id of the connection to disconnect.
       public: virtual void Disconnect(int _id);
@@ -118,486 +186,208 @@ namespace gazebo
       /// \return Number of connection to this Event.
       public: unsigned int ConnectionCount() const;
 
-      /// \brief Access the signal.
-      public: void operator()()
-              {this->Signal();}
-
-      /// \brief Signal the event with one parameter.
-      /// \param[in] _p the parameter.
-      public: template< typename P >
-              void operator()(const P &_p)
-      {
-        this->Signal(_p);
-      }
-
-      /// \brief Signal the event with two parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      public: template< typename P1, typename P2 >
-              void operator()(const P1 &_p1, const P2 &_p2)
-      {
-        this->Signal(_p1, _p2);
-      }
-
-      /// \brief Signal the event with three parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      public: template< typename P1, typename P2, typename P3 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3)
-      {
-        this->Signal(_p1, _p2, _p3);
-      }
-
-      /// \brief Signal the event with four parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4)
-      {
-        this->Signal(_p1, _p2, _p3, _p4);
-      }
-
-      /// \brief Signal the event with five parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fift parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5)
-      {
-        this->Signal(_p1, _p2, _p3, _p4, _p5);
-      }
-
-      /// \brief Signal the event with six parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fift parameter.
-      /// \param[in] _p6 the sixt parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5, const P6 &_p6)
-      {
-        this->Signal(_p1, _p2, _p3, _p4, _p5, _p6);
-      }
-
-      /// \brief Signal the event with seven parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5, const P6 &_p6,
-                              const P7 &_p7)
-      {
-        this->Signal(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
-      }
-
-      /// \brief Signal the event with eight parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7, typename P8 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5, const P6 &_p6,
-                              const P7 &_p7, const P8 &_p8)
-      {
-        this->Signal(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
-      }
-
-      /// \brief Signal the event with nine parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      /// \param[in] _p9 the ninth parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7, typename P8,
-                        typename P9 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5, const P6 &_p6,
-                              const P7 &_p7, const P8 &_p8, const P9 &_p9)
-      {
-        this->Signal(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9);
-      }
-
-      /// \brief Signal the event with ten parameters.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      /// \param[in] _p9 the ninth parameter.
-      /// \param[in] _p10 the tenth parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7, typename P8,
-                        typename P9, typename P10 >
-              void operator()(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                              const P4 &_p4, const P5 &_p5, const P6 &_p6,
-                              const P7 &_p7, const P8 &_p8, const P9 &_p9,
-                              const P10 &_p10)
+      /// \brief Signal the event for all subscribers.
+      /// \param[in] _args Parameters passed to the callbacks.
+      /// \sa Signal
+      public: template<typename... Args>
+              void operator()(Args &&... _args)
       {
-        this->Signal(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9, _p10);
+        this->Signal(std::forward<Args>(_args)...);
       }
 
       /// \brief Signal the event for all subscribers.
-      public: void Signal()
+      ///
+      /// Serial connections are called in the order they were made. All
+      /// the connections made with ConnectionOptions::concurrent are called
+      /// together, as one concurrent phase, in place of the first of them:
+      /// serial connections made before it are called before the phase,
+      /// and the other ones after all concurrent connections returned.
+      /// \param[in] _args Parameters passed to the callbacks.
+      public: template<typename... Args>
+              void Signal(const Args &... _args)
       {
         IGN_PROFILE("Event::Signal");
 
-        this->Cleanup();
-
         this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback0");
-            iter.second->callback();
-            IGN_PROFILE_END();
-          }
-        }
-      }
 
-      /// \brief Signal the event with one parameter.
-      /// \param[in] _p parameter.
-      public: template< typename P >
-              void Signal(const P &_p)
-      {
-        IGN_PROFILE("Event::Signal");
+        // Snapshot of the connections, taken without locking. Connections
+        // made or removed by the callbacks take effect on the next signal.
+        std::shared_ptr<const ConnectionList> list =
+          std::atomic_load(&this->list);
+        if (!list)
+          return;
 
-        this->Cleanup();
+        const bool timed = this->timing;
+        for (size_t i = 0; i < list->phase; ++i)
+          this->Call(*list->serial[i], timed, _args...);
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        if (list->concurrent.size() > 1)
         {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback1");
-            iter.second->callback(_p);
-            IGN_PROFILE_END();
-          }
+          RunConcurrently(list->concurrent.size(), [&](const size_t _index)
+              {
+                this->Call(*list->concurrent[_index], timed, _args...);
+              });
         }
-      }
-
-      /// \brief Signal the event with two parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      public: template< typename P1, typename P2 >
-              void Signal(const P1 &_p1, const P2 &_p2)
-      {
-        IGN_PROFILE("Event::Signal");
-
-        this->Cleanup();
-
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        else if (!list->concurrent.empty())
         {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback2");
-            iter.second->callback(_p1, _p2);
-            IGN_PROFILE_END();
-          }
+          this->Call(*list->concurrent[0], timed, _args...);
         }
-      }
 
-      /// \brief Signal the event with three parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      public: template< typename P1, typename P2, typename P3 >
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3)
-      {
-        IGN_PROFILE("Event::Signal");
-
-        this->Cleanup();
-
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback3");
-            iter.second->callback(_p1, _p2, _p3);
-            IGN_PROFILE_END();
-          }
-        }
+        for (size_t i = list->phase; i < list->serial.size(); ++i)
+          this->Call(*list->serial[i], timed, _args...);
       }
 
-      /// \brief Signal the event with four parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      public: template<typename P1, typename P2, typename P3, typename P4>
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                          const P4 &_p4)
-      {
-        IGN_PROFILE("Event::Signal");
+      /// \brief Enable or disable the timing of connections. Disabled by
+      /// default.
+      /// \param[in] _enabled True to time each callback.
+      public: void SetTimingEnabled(const bool _enabled);
 
-        this->Cleanup();
+      /// \brief Whether connections are timed.
+      /// \return True if enabled.
+      public: bool TimingEnabled() const;
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback4");
-            iter.second->callback(_p1, _p2, _p3, _p4);
-            IGN_PROFILE_END();
-          }
-        }
-      }
+      /// \brief Get the timing of all connections since they were made or
+      /// the timings were reset.
+      /// \return Timings, in the order the connections are called.
+      public: std::vector<ConnectionTiming> ConnectionTimings() const;
 
-      /// \brief Signal the event with five parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      public: template<typename P1, typename P2, typename P3, typename P4,
-                       typename P5>
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                          const P4 &_p4, const P5 &_p5)
-      {
-        IGN_PROFILE("Event::Signal");
-
-        this->Cleanup();
+      /// \brief Reset the timing of all connections.
+      public: void ResetTimings();
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+      /// \brief A private helper class used in maintaining connections.
+      private: class EventConnection
+      {
+        /// \brief Constructor
+        public: EventConnection(const bool _on, const std::function<T> &_cb,
+                    const int _id, const ConnectionOptions &_options)
+                : callback(_cb), id(_id), name(_options.name),
+                  concurrent(_options.concurrent)
         {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback5");
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5);
-            IGN_PROFILE_END();
-          }
+          // Windows Visual Studio 2012 does not have atomic_bool constructor,
+          // so we have to set "on" using operator=
+          this->on = _on;
+          this->count = 0;
+          this->ticks = 0;
+          this->maxTicks = 0;
         }
-      }
-
-      /// \brief Signal the event with six parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      public: template<typename P1, typename P2, typename P3, typename P4,
-                       typename P5, typename P6>
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                  const P4 &_p4, const P5 &_p5, const P6 &_p6)
-      {
-        IGN_PROFILE("Event::Signal");
 
-        this->Cleanup();
+        /// \brief On/off value for the event callback
+        public: std::atomic_bool on;
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback6");
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6);
-            IGN_PROFILE_END();
-          }
-        }
-      }
+        /// \brief Callback function
+        public: std::function<T> callback;
 
-      /// \brief Signal the event with seven parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      public: template<typename P1, typename P2, typename P3, typename P4,
-                       typename P5, typename P6, typename P7>
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                  const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7)
-      {
-        IGN_PROFILE("Event::Signal");
+        /// \brief Id of the connection.
+        public: const int id;
 
-        this->Cleanup();
+        /// \brief Name given in the connection options.
+        public: const std::string name;
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback7");
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7);
-            IGN_PROFILE_END();
-          }
-        }
-      }
+        /// \brief True if the callback can run concurrently.
+        public: const bool concurrent;
 
-      /// \brief Signal the event with eight parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      public: template<typename P1, typename P2, typename P3, typename P4,
-                       typename P5, typename P6, typename P7, typename P8>
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                  const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
-                  const P8 &_p8)
-      {
-        IGN_PROFILE("Event::Signal");
+        /// \brief Number of timed calls.
+        public: std::atomic<uint64_t> count;
 
-        this->Cleanup();
+        /// \brief Total duration of the timed calls, in profiler ticks.
+        public: std::atomic<uint64_t> ticks;
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
-        {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback8");
-            iter.second->callback(_p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8);
-            IGN_PROFILE_END();
-          }
-        }
-      }
+        /// \brief Longest timed call, in profiler ticks. Only written by
+        /// the thread running the callback.
+        public: std::atomic<uint64_t> maxTicks;
+      };
 
-      /// \brief Signal the event with nine parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      /// \param[in] _p9 the ninth parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7, typename P8,
-                        typename P9 >
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                  const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
-                  const P8 &_p8, const P9 &_p9)
+      /// \brief Call a connection.
+      /// \param[in] _conn Connection to call.
+      /// \param[in] _timed True to time the call.
+      /// \param[in] _args Parameters passed to the callback.
+      private: template<typename... Args>
+               void Call(EventConnection &_conn, const bool _timed,
+                   const Args &... _args)
       {
-        IGN_PROFILE("Event::Signal");
-
-        this->Cleanup();
+        if (!_conn.on)
+          return;
 
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        IGN_PROFILE_BEGIN("callback");
+        if (_timed)
         {
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback9");
-            iter.second->callback(
-                _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9);
-            IGN_PROFILE_END();
-          }
+          const uint64_t start = common::Profiler::Ticks();
+          _conn.callback(_args...);
+          const uint64_t ticks = common::Profiler::Ticks() - start;
+
+          _conn.count.fetch_add(1, std::memory_order_relaxed);
+          _conn.ticks.fetch_add(ticks, std::memory_order_relaxed);
+          if (ticks > _conn.maxTicks.load(std::memory_order_relaxed))
+            _conn.maxTicks.store(ticks, std::memory_order_relaxed);
         }
-      }
-
-      /// \brief Signal the event with ten parameter.
-      /// \param[in] _p1 the first parameter.
-      /// \param[in] _p2 the second parameter.
-      /// \param[in] _p3 the second parameter.
-      /// \param[in] _p4 the first parameter.
-      /// \param[in] _p5 the fifth parameter.
-      /// \param[in] _p6 the sixth parameter.
-      /// \param[in] _p7 the seventh parameter.
-      /// \param[in] _p8 the eighth parameter.
-      /// \param[in] _p9 the ninth parameter.
-      /// \param[in] _p10 the tenth parameter.
-      public: template< typename P1, typename P2, typename P3, typename P4,
-                        typename P5, typename P6, typename P7, typename P8,
-                        typename P9, typename P10 >
-              void Signal(const P1 &_p1, const P2 &_p2, const P3 &_p3,
-                  const P4 &_p4, const P5 &_p5, const P6 &_p6, const P7 &_p7,
-                  const P8 &_p8, const P9 &_p9, const P10 &_p10)
-      {
-        this->Cleanup();
-
-        this->SetSignaled(true);
-        for (const auto &iter: this->connections)
+        else
         {
-          IGN_PROFILE("Event::Signal");
-
-          if (iter.second->on)
-          {
-            IGN_PROFILE_BEGIN("callback10");
-            iter.second->callback(
-                _p1, _p2, _p3, _p4, _p5, _p6, _p7, _p8, _p9, _p10);
-            IGN_PROFILE_END();
-          }
+          _conn.callback(_args...);
         }
+        IGN_PROFILE_END();
       }
 
-      /// \internal
-      /// \brief Removes queued connections.
-      /// We assume that this function is called from a Signal function.
-      private: void Cleanup();
+      /// \def EvtConnectionMap
+      /// \brief Event Connection map typedef.
+      typedef std::map<int, std::shared_ptr<EventConnection>>
+          EvtConnectionMap;
 
-      /// \brief A private helper class used in maintaining connections.
-      private: class EventConnection
+      /// \brief Immutable snapshot of the connections, split into the
+      /// serial connections and the concurrent phase.
+      private: class ConnectionList
       {
-        /// \brief Constructor
-        public: EventConnection(const bool _on, const std::function<T> &_cb)
-                : callback(_cb)
-        {
-          // Windows Visual Studio 2012 does not have atomic_bool constructor,
-          // so we have to set "on" using operator=
-          this->on = _on;
-        }
-
-        /// \brief On/off value for the event callback
-        public: std::atomic_bool on;
-
-        /// \brief Callback function
-        public: std::function<T> callback;
+        /// \brief Serial connections, in the order they were made.
+        public: std::vector<std::shared_ptr<EventConnection>> serial;
+
+        /// \brief Number of serial connections called before the
+        /// concurrent phase.
+        public: size_t phase = 0;
+
+        /// \brief Concurrent connections, called as one phase.
+        public: std::vector<std::shared_ptr<EventConnection>> concurrent;
+
+        /// \brief Get the number of connections.
+        /// \return Number of serial and concurrent connections.
+        public: size_t Size() const
+                {
+                  return this->serial.size() + this->concurrent.size();
+                }
+
+        /// \brief Get the connections in the order they are called.
+        /// \return The connections.
+        public: std::vector<std::shared_ptr<EventConnection>> Ordered() const
+                {
+                  std::vector<std::shared_ptr<EventConnection>> ordered(
+                      this->serial.begin(), this->serial.begin() + this->phase);
+                  ordered.insert(ordered.end(), this->concurrent.begin(),
+                      this->concurrent.end());
+                  ordered.insert(ordered.end(),
+                      this->serial.begin() + this->phase, this->serial.end());
+                  return ordered;
+                }
       };
 
-      /// \def EvtConnectionMap
-      /// \brief Event Connection map typedef.
-      typedef std::map<int, std::unique_ptr<EventConnection>> EvtConnectionMap;
+      /// \internal
+      /// \brief Publish a new snapshot of the connections. Called with
+      /// the mutex locked.
+      /// \return The previous snapshot, to be released after unlocking.
+      private: std::shared_ptr<const ConnectionList> Publish();
 
-      /// \brief Array of connection callbacks.
+      /// \brief Array of connection callbacks. Protected by the mutex.
       private: EvtConnectionMap connections;
 
-      /// \brief A thread lock.
+      /// \brief Snapshot of the connections used by Signal. Only accessed
+      /// through the atomic shared_ptr functions.
+      private: std::shared_ptr<const ConnectionList> list;
+
+      /// \brief A thread lock, taken when connecting and disconnecting.
       private: std::mutex mutex;
 
-      /// \brief List of connections to remove
-      private: std::list<typename EvtConnectionMap::const_iterator>
-              connectionsToRemove;
+      /// \brief Id of the next connection. Protected by the mutex.
+      private: int nextId = 0;
+
+      /// \brief True if connections are timed.
+      private: std::atomic_bool timing;
     };
 
     /// \brief Constructor.
@@ -605,12 +395,14 @@ namespace gazebo
     EventT<T>::EventT()
     : Event()
     {
+      this->timing = false;
     }
 
     /// \brief Destructor. Deletes all the associated connections.
     template<typename T>
     EventT<T>::~EventT()
     {
+      std::atomic_store(&this->list, std::shared_ptr<const ConnectionList>());
       this->connections.clear();
     }
 
@@ -619,13 +411,25 @@ namespace gazebo
     template<typename T>
     ConnectionPtr EventT<T>::Connect(const std::function<T> &_subscriber)
     {
-      int index = 0;
-      if (!this->connections.empty())
-      {
-        auto const &iter = this->connections.rbegin();
-        index = iter->first + 1;
-      }
-      this->connections[index].reset(new EventConnection(true, _subscriber));
+      return this->Connect(_subscriber, ConnectionOptions());
+    }
+
+    /// \brief Adds a connection with options.
+    /// \param[in] _subscriber the subscriber to connect.
+    /// \param[in] _options Options of the connection.
+    template<typename T>
+    ConnectionPtr EventT<T>::Connect(const std::function<T> &_subscriber,
+        const ConnectionOptions &_options)
+    {
+      std::shared_ptr<const ConnectionList> previous;
+      std::lock_guard<std::mutex> lock(this->mutex);
+
+      // Ids aren't reused, since connections are removed right away
+      int index = this->nextId++;
+      this->connections[index].reset(
+          new EventConnection(true, _subscriber, index, _options));
+      previous = this->Publish();
+
       return ConnectionPtr(new Connection(this, index));
     }
 
@@ -634,7 +438,9 @@ namespace gazebo
     template<typename T>
     unsigned int EventT<T>::ConnectionCount() const
     {
-      return this->connections.size();
+      std::shared_ptr<const ConnectionList> current =
+        std::atomic_load(&this->list);
+      return current ? current->Size() : 0u;
     }
 
     /// \brief Removes a connection.
@@ -642,25 +448,110 @@ namespace gazebo
     template<typename T>
     void EventT<T>::Disconnect(int _id)
     {
+      // Released after unlocking, since destroying a callback may
+      // disconnect other connections.
+      std::shared_ptr<EventConnection> removed;
+      std::shared_ptr<const ConnectionList> previous;
+      std::lock_guard<std::mutex> lock(this->mutex);
+
       // Find the connection
       auto const &it = this->connections.find(_id);
 
       if (it != this->connections.end())
       {
+        // A signal in progress may still hold the connection
         it->second->on = false;
-        this->connectionsToRemove.push_back(it);
+        removed = it->second;
+        this->connections.erase(it);
+        previous = this->Publish();
       }
     }
 
     /////////////////////////////////////////////
     template<typename T>
-    void EventT<T>::Cleanup()
+    std::shared_ptr<const typename EventT<T>::ConnectionList>
+    EventT<T>::Publish()
     {
-      std::lock_guard<std::mutex> lock(this->mutex);
-      // Remove all queue connections.
-      for (auto &conn : this->connectionsToRemove)
-        this->connections.erase(conn);
-      this->connectionsToRemove.clear();
+      std::shared_ptr<const ConnectionList> current;
+      if (!this->connections.empty())
+      {
+        // The concurrent phase takes the place of the first concurrent
+        // connection
+        auto newList = std::make_shared<ConnectionList>();
+        for (auto const &conn : this->connections)
+        {
+          if (conn.second->concurrent)
+          {
+            if (newList->concurrent.empty())
+              newList->phase = newList->serial.size();
+            newList->concurrent.push_back(conn.second);
+          }
+          else
+          {
+            newList->serial.push_back(conn.second);
+          }
+        }
+        current = newList;
+      }
+      return std::atomic_exchange(&this->list, current);
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    void EventT<T>::SetTimingEnabled(const bool _enabled)
+    {
+      this->timing = _enabled;
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    bool EventT<T>::TimingEnabled() const
+    {
+      return this->timing;
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    std::vector<ConnectionTiming> EventT<T>::ConnectionTimings() const
+    {
+      std::vector<ConnectionTiming> timings;
+
+      std::shared_ptr<const ConnectionList> current =
+        std::atomic_load(&this->list);
+      if (!current)
+        return timings;
+
+      const double ticksPerSecond =
+        common::Profiler::Instance()->TicksPerSecond();
+      for (auto const &conn : current->Ordered())
+      {
+        ConnectionTiming timing;
+        timing.id = conn->id;
+        timing.name = conn->name;
+        timing.concurrent = conn->concurrent;
+        timing.count = conn->count;
+        timing.total = conn->ticks / ticksPerSecond;
+        timing.max = conn->maxTicks / ticksPerSecond;
+        timings.push_back(timing);
+      }
+      return timings;
+    }
+
+    /////////////////////////////////////////////
+    template<typename T>
+    void EventT<T>::ResetTimings()
+    {
+      std::shared_ptr<const ConnectionList> current =
+        std::atomic_load(&this->list);
+      if (!current)
+        return;
+
+      for (auto const &conn : current->Ordered())
+      {
+        conn->count = 0;
+        conn->ticks = 0;
+        conn->maxTicks = 0;
+      }
     }
     /// \}
   }
@@ -15,7 +15,10 @@
  *
 */
 
+#include <atomic>
 #include <functional>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <gazebo/common/Time.hh>
 #include <gazebo/common/Event.hh>
@@ -220,6 +223,182 @@ TEST_F(EventTest, ManyChanges)
   EXPECT_EQ(g_callback1, 2);
 }
 
+/////////////////////////////////////////////////
+TEST_F(EventTest, DisconnectCount)
+{
+  event::EventT<void ()> evt;
+  event::ConnectionPtr conn = evt.Connect(std::bind(&callback));
+  event::ConnectionPtr conn1 = evt.Connect(std::bind(&callback1));
+  EXPECT_EQ(2u, evt.ConnectionCount());
+
+  // Connections are removed right away, and ids aren't reused
+  int id = conn->Id();
+  conn.reset();
+  EXPECT_EQ(1u, evt.ConnectionCount());
+
+  conn = evt.Connect(std::bind(&callback));
+  EXPECT_NE(id, conn->Id());
+  EXPECT_EQ(2u, evt.ConnectionCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, Concurrent)
+{
+  event::EventT<void (int)> evt;
+
+  const int count = 64;
+  std::atomic<int> calls(0);
+  std::atomic<int> running(0);
+  std::atomic<int> maxRunning(0);
+  std::vector<int> order;
+
+  event::ConnectionOptions options;
+  options.concurrent = true;
+
+  std::vector<event::ConnectionPtr> conns;
+  conns.push_back(evt.Connect([&](int) {order.push_back(0);}));
+  for (int i = 0; i < count; ++i)
+  {
+    conns.push_back(evt.Connect([&](int _value)
+        {
+          int now = ++running;
+          int prev = maxRunning;
+          while (now > prev && !maxRunning.compare_exchange_weak(prev, now))
+          {
+          }
+          common::Time::MSleep(1);
+          calls += _value;
+          --running;
+        }, options));
+  }
+
+  // Serial connections run after all the concurrent ones before them
+  conns.push_back(evt.Connect([&](int)
+      {
+        EXPECT_EQ(count, calls.load());
+        order.push_back(1);
+      }));
+
+  evt(1);
+
+  EXPECT_EQ(count, calls.load());
+  EXPECT_EQ(std::vector<int>({0, 1}), order);
+  EXPECT_EQ(0, running.load());
+  if (std::thread::hardware_concurrency() > 1)
+    EXPECT_GT(maxRunning.load(), 1);
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, ConcurrentPhase)
+{
+  event::EventT<void ()> evt;
+
+  std::atomic<int> started(0);
+  std::atomic<int> finished(0);
+  int finishedBefore = -1;
+  std::vector<int> order;
+
+  event::ConnectionOptions options;
+  options.concurrent = true;
+
+  // Wait a bit for the other concurrent callback to start, which it only
+  // does if both run in the same phase
+  const bool parallel = std::thread::hardware_concurrency() > 1;
+  std::atomic<int> overlapped(0);
+  auto concurrent = [&]()
+  {
+    ++started;
+    for (int i = 0; i < 100 && parallel && started < 2; ++i)
+      common::Time::MSleep(1);
+    if (started == 2)
+      ++overlapped;
+    ++finished;
+  };
+
+  // A serial connection between two concurrent ones doesn't split the
+  // concurrent phase, which takes the place of the first of them
+  std::vector<event::ConnectionPtr> conns;
+  conns.push_back(evt.Connect([&]() {order.push_back(0);}));
+  conns.push_back(evt.Connect(concurrent, options));
+  conns.push_back(evt.Connect([&]()
+      {
+        finishedBefore = finished;
+        order.push_back(1);
+      }));
+  conns.push_back(evt.Connect(concurrent, options));
+  EXPECT_EQ(4u, evt.ConnectionCount());
+
+  evt();
+
+  EXPECT_EQ(2, finished.load());
+  EXPECT_EQ(2, finishedBefore);
+  EXPECT_EQ(std::vector<int>({0, 1}), order);
+  if (parallel)
+  {
+    EXPECT_EQ(2, overlapped.load());
+  }
+
+  // Timings follow the order of the calls
+  auto timings = evt.ConnectionTimings();
+  ASSERT_EQ(4u, timings.size());
+  EXPECT_EQ(conns[0]->Id(), timings[0].id);
+  EXPECT_EQ(conns[1]->Id(), timings[1].id);
+  EXPECT_EQ(conns[3]->Id(), timings[2].id);
+  EXPECT_TRUE(timings[2].concurrent);
+  EXPECT_EQ(conns[2]->Id(), timings[3].id);
+
+  // Removing the first concurrent connection moves the phase after the
+  // serial connection
+  conns[1].reset();
+  order.clear();
+  started = 0;
+  finished = 0;
+  evt();
+  EXPECT_EQ(1, finished.load());
+  EXPECT_EQ(0, finishedBefore);
+  EXPECT_EQ(std::vector<int>({0, 1}), order);
+}
+
+/////////////////////////////////////////////////
+TEST_F(EventTest, Timing)
+{
+  event::EventT<void ()> evt;
+
+  event::ConnectionOptions options;
+  options.name = "slow";
+  event::ConnectionPtr slow = evt.Connect(
+      []() {common::Time::MSleep(5);}, options);
+  event::ConnectionPtr fast = evt.Connect(std::bind(&callback));
+
+  // Not timed by default
+  EXPECT_FALSE(evt.TimingEnabled());
+  evt();
+  auto timings = evt.ConnectionTimings();
+  ASSERT_EQ(2u, timings.size());
+  EXPECT_EQ(0u, timings[0].count);
+
+  evt.SetTimingEnabled(true);
+  evt();
+  evt();
+
+  timings = evt.ConnectionTimings();
+  ASSERT_EQ(2u, timings.size());
+  EXPECT_EQ(slow->Id(), timings[0].id);
+  EXPECT_EQ("slow", timings[0].name);
+  EXPECT_FALSE(timings[0].concurrent);
+  EXPECT_EQ(2u, timings[0].count);
+  EXPECT_GT(timings[0].total, 0.009);
+  EXPECT_GT(timings[0].max, 0.004);
+  EXPECT_LE(timings[0].max, timings[0].total);
+  EXPECT_EQ(2u, timings[1].count);
+  EXPECT_LT(timings[1].max, timings[0].max);
+
+  evt.ResetTimings();
+  timings = evt.ConnectionTimings();
+  EXPECT_EQ(0u, timings[0].count);
+  EXPECT_DOUBLE_EQ(0.0, timings[0].total);
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
@@ -19,6 +19,10 @@
 using namespace gazebo;
 using namespace event;
 
+/// \brief Default options of the connections to worldUpdateBegin made by
+/// the current thread.
+static thread_local ConnectionOptions worldUpdateBeginOptions;
+
 EventT<void (bool)> Events::pause;
 EventT<void ()> Events::step;
 EventT<void ()> Events::stop;
@@ -49,3 +53,15 @@ EventT<void (std::string)> Events::removeSensor;
 
 EventT<void (sdf::ElementPtr, const std::string &,
     const std::string &, const uint32_t)> Events::createSensor;
+
+//////////////////////////////////////////////////
+void Events::SetWorldUpdateBeginOptions(const ConnectionOptions &_options)
+{
+  worldUpdateBeginOptions = _options;
+}
+
+//////////////////////////////////////////////////
+const ConnectionOptions &Events::WorldUpdateBeginOptions()
+{
+  return worldUpdateBeginOptions;
+}
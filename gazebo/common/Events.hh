@@ -101,12 +101,50 @@ namespace gazebo
               { return addEntity.Connect(_subscriber); }
 
       //////////////////////////////////////////////////////////////////////////
-      /// \brief Connect a callback to the world update start signal
+      /// \brief Connect a callback to the world update start signal, with
+      /// the default options of the calling thread.
       /// \param[in] _subscriber the subscriber to this event
       /// \return a connection
+      /// \sa SetWorldUpdateBeginOptions
       public: template<typename T>
               static ConnectionPtr ConnectWorldUpdateBegin(T _subscriber)
-              { return worldUpdateBegin.Connect(_subscriber); }
+              {
+                return worldUpdateBegin.Connect(_subscriber,
+                    WorldUpdateBeginOptions());
+              }
+
+      //////////////////////////////////////////////////////////////////////////
+      /// \brief Set the default options of the connections to the world
+      /// update start signal made by the calling thread. A model loads each
+      /// of its plugins with the options given by the <concurrent> element
+      /// of the plugin, so that plugins which only touch their own model run
+      /// concurrently without code changes.
+      /// \param[in] _options Default options, reset with
+      /// ConnectionOptions().
+      public: static void SetWorldUpdateBeginOptions(
+                  const ConnectionOptions &_options);
+
+      //////////////////////////////////////////////////////////////////////////
+      /// \brief Get the default options of the connections to the world
+      /// update start signal made by the calling thread.
+      /// \return The options.
+      public: static const ConnectionOptions &WorldUpdateBeginOptions();
+
+      //////////////////////////////////////////////////////////////////////////
+      /// \brief Connect a callback to the world update start signal, with
+      /// options. A model plugin whose callback only touches its own model
+      /// can set ConnectionOptions::concurrent, so that it runs concurrently
+      /// with other such callbacks. Such a callback runs on another thread
+      /// while World::Update holds the world update mutex, so it must not
+      /// call World functions which lock it, such as Reset, SetPaused or
+      /// Step.
+      /// \param[in] _subscriber the subscriber to this event
+      /// \param[in] _options Options of the connection
+      /// \return a connection
+      public: template<typename T>
+              static ConnectionPtr ConnectWorldUpdateBegin(T _subscriber,
+                  const ConnectionOptions &_options)
+              { return worldUpdateBegin.Connect(_subscriber, _options); }
 
       //////////////////////////////////////////////////////////////////////////
       /// \brief Connect a callback to the before physics update signal
@@ -120,6 +158,18 @@ namespace gazebo
               static ConnectionPtr ConnectBeforePhysicsUpdate(T _subscriber)
               { return beforePhysicsUpdate.Connect(_subscriber); }
 
+      //////////////////////////////////////////////////////////////////////////
+      /// \brief Connect a callback to the before physics update signal, with
+      /// options.
+      /// \param[in] _subscriber the subscriber to this event
+      /// \param[in] _options Options of the connection
+      /// \return a connection
+      /// \sa ConnectWorldUpdateBegin(T, const ConnectionOptions &)
+      public: template<typename T>
+              static ConnectionPtr ConnectBeforePhysicsUpdate(T _subscriber,
+                  const ConnectionOptions &_options)
+              { return beforePhysicsUpdate.Connect(_subscriber, _options); }
+
       //////////////////////////////////////////////////////////////////////////
       /// \brief Connect a callback to the world update end signal
       /// \param[in] _subscriber the subscriber to this event
@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/ProfilerPrivate.hh"
+#include "gazebo/common/Profiler.hh"
+
+using namespace gazebo;
+using namespace common;
+
+namespace
+{
+  /// \brief Owns the calling thread's buffer, and flags it when the thread
+  /// exits so the profiler can release it once drained.
+  struct ThreadBufferHolder
+  {
+    /// \brief Destructor.
+    ~ThreadBufferHolder()
+    {
+      if (this->buffer)
+        this->buffer->alive = false;
+    }
+
+    /// \brief The thread's buffer, null until the first sample.
+    std::shared_ptr<ProfileThreadBuffer> buffer;
+  };
+
+  /// \brief Buffer of the calling thread.
+  thread_local ThreadBufferHolder threadBuffer;
+}
+
+//////////////////////////////////////////////////
+size_t ProfileHistogram::Bucket(const uint64_t _ticks)
+{
+  if (_ticks < kSubBuckets)
+    return static_cast<size_t>(_ticks);
+
+  // Position of the most significant bit.
+  unsigned int msb = kSubBits;
+  while (msb < 63 && (_ticks >> (msb + 1)) != 0)
+    ++msb;
+
+  const unsigned int shift = msb - kSubBits;
+  return (shift + 1) * kSubBuckets + ((_ticks >> shift) - kSubBuckets);
+}
+
+//////////////////////////////////////////////////
+uint64_t ProfileHistogram::BucketLow(const size_t _bucket)
+{
+  if (_bucket < kSubBuckets)
+    return _bucket;
+
+  const unsigned int shift = _bucket / kSubBuckets - 1;
+  return (_bucket % kSubBuckets + kSubBuckets) << shift;
+}
+
+//////////////////////////////////////////////////
+void ProfileHistogram::Add(const uint64_t _ticks)
+{
+  if (this->buckets.empty())
+    this->buckets.resize(kBuckets, 0u);
+
+  ++this->buckets[Bucket(_ticks)];
+  ++this->count;
+  this->sum += _ticks;
+  this->max = std::max(this->max, _ticks);
+}
+
+//////////////////////////////////////////////////
+void ProfileHistogram::Merge(const ProfileHistogram &_other)
+{
+  if (_other.count == 0)
+    return;
+
+  if (this->buckets.empty())
+    this->buckets.resize(kBuckets, 0u);
+
+  for (size_t i = 0; i < kBuckets; ++i)
+    this->buckets[i] += _other.buckets[i];
+  this->count += _other.count;
+  this->sum += _other.sum;
+  this->max = std::max(this->max, _other.max);
+}
+
+//////////////////////////////////////////////////
+void ProfileHistogram::Clear()
+{
+  this->count = 0;
+  this->sum = 0;
+  this->max = 0;
+  std::fill(this->buckets.begin(), this->buckets.end(), 0u);
+}
+
+//////////////////////////////////////////////////
+double ProfileHistogram::Percentile(const double _fraction) const
+{
+  if (this->count == 0)
+    return 0;
+
+  // Rank of the requested sample, starting at 1.
+  const uint64_t rank = std::max<uint64_t>(1u, static_cast<uint64_t>(
+        std::ceil(std::min(1.0, std::max(0.0, _fraction)) * this->count)));
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i)
+  {
+    seen += this->buckets[i];
+    if (seen >= rank)
+    {
+      // Report the middle of the bucket, but never above the maximum.
+      const double low = static_cast<double>(BucketLow(i));
+      const double high = i + 1 < kBuckets ?
+        static_cast<double>(BucketLow(i + 1)) : low;
+      return std::min((low + high) * 0.5, static_cast<double>(this->max));
+    }
+  }
+
+  return static_cast<double>(this->max);
+}
+
+//////////////////////////////////////////////////
+std::vector<ProfileZoneStats> ProfilerPrivate::Stats(
+    const std::vector<ProfileHistogram> &_histograms) const
+{
+  std::vector<ProfileZoneStats> result;
+
+  // Convert ticks to seconds.
+  const double tickTime = 1.0 / Profiler::Instance()->TicksPerSecond();
+
+  std::lock_guard<std::mutex> lock(this->zonesMutex);
+  for (size_t i = 0; i < _histograms.size(); ++i)
+  {
+    const auto &histogram = _histograms[i];
+    if (histogram.count == 0 || i >= this->zoneNames.size())
+      continue;
+
+    ProfileZoneStats stats;
+    stats.name = this->zoneNames[i];
+    stats.count = histogram.count;
+    stats.mean = histogram.sum / histogram.count * tickTime;
+    stats.p50 = histogram.Percentile(0.5) * tickTime;
+    stats.p99 = histogram.Percentile(0.99) * tickTime;
+    stats.max = histogram.max * tickTime;
+    result.push_back(stats);
+  }
+
+  std::sort(result.begin(), result.end(),
+      [](const ProfileZoneStats &_a, const ProfileZoneStats &_b)
+      {
+        return _a.name < _b.name;
+      });
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+Profiler::Profiler()
+  : dataPtr(new ProfilerPrivate)
+{
+  this->dataPtr->startTicks = Ticks();
+  this->dataPtr->startTime = std::chrono::steady_clock::now();
+}
+
+//////////////////////////////////////////////////
+Profiler::~Profiler()
+{
+}
+
+//////////////////////////////////////////////////
+ProfileZoneId Profiler::RegisterZone(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->zonesMutex);
+
+  auto iter = this->dataPtr->zoneIds.find(_name);
+  if (iter != this->dataPtr->zoneIds.end())
+    return iter->second;
+
+  ProfileZoneId id = static_cast<ProfileZoneId>(
+      this->dataPtr->zoneNames.size());
+  this->dataPtr->zoneNames.push_back(_name);
+  this->dataPtr->zoneIds[_name] = id;
+  return id;
+}
+
+//////////////////////////////////////////////////
+std::string Profiler::ZoneName(const ProfileZoneId _zone) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->zonesMutex);
+  if (_zone >= this->dataPtr->zoneNames.size())
+    return std::string();
+  return this->dataPtr->zoneNames[_zone];
+}
+
+//////////////////////////////////////////////////
+size_t Profiler::ZoneCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->zonesMutex);
+  return this->dataPtr->zoneNames.size();
+}
+
+//////////////////////////////////////////////////
+double Profiler::TicksPerSecond() const
+{
+#ifdef GZ_PROFILER_USE_TSC
+  const uint64_t ticks = Ticks() - this->dataPtr->startTicks;
+  const double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - this->dataPtr->startTime).count();
+
+  // The estimate is only meaningful once some time has elapsed.
+  if (seconds <= 1e-3 || ticks == 0)
+    return 1e9;
+  return ticks / seconds;
+#else
+  return 1e9;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Profiler::Record(const ProfileZoneId _zone, const uint64_t _start,
+    const uint64_t _end)
+{
+  if (!this->dataPtr->enabled.load(std::memory_order_relaxed))
+    return;
+
+  ProfileThreadBuffer *buffer = threadBuffer.buffer.get();
+  if (!buffer)
+  {
+    threadBuffer.buffer = std::make_shared<ProfileThreadBuffer>();
+    buffer = threadBuffer.buffer.get();
+
+    std::lock_guard<std::mutex> lock(this->dataPtr->buffersMutex);
+    this->dataPtr->buffers.push_back(threadBuffer.buffer);
+  }
+
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  const uint64_t tail = buffer->tail.load(std::memory_order_acquire);
+  if (head - tail >= ProfileThreadBuffer::kSize)
+  {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto &sample = buffer->ring[head & (ProfileThreadBuffer::kSize - 1)];
+  sample.zone = _zone;
+  sample.ticks = _end >= _start ? _end - _start : 0u;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+void Profiler::SetEnabled(const bool _enabled)
+{
+  this->dataPtr->enabled = _enabled;
+}
+
+//////////////////////////////////////////////////
+bool Profiler::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+//////////////////////////////////////////////////
+void Profiler::Collect()
+{
+  std::vector<std::shared_ptr<ProfileThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->buffersMutex);
+    buffers = this->dataPtr->buffers;
+  }
+
+  const size_t zoneCount = this->ZoneCount();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+  if (this->dataPtr->histograms.size() < zoneCount)
+  {
+    this->dataPtr->histograms.resize(zoneCount);
+    this->dataPtr->window.resize(zoneCount);
+  }
+
+  bool exited = false;
+  for (auto &buffer : buffers)
+  {
+    // Read the liveness first, so samples written before exiting are
+    // drained before the buffer is released.
+    const bool alive = buffer->alive;
+    uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+    for (; tail != head; ++tail)
+    {
+      const auto &sample =
+        buffer->ring[tail & (ProfileThreadBuffer::kSize - 1)];
+      if (sample.zone >= zoneCount)
+        continue;
+      this->dataPtr->histograms[sample.zone].Add(sample.ticks);
+      this->dataPtr->window[sample.zone].Add(sample.ticks);
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+
+    if (!alive)
+    {
+      this->dataPtr->dropped += buffer->dropped;
+      exited = true;
+    }
+  }
+
+  // Release the buffers of threads which have exited.
+  if (exited)
+  {
+    std::lock_guard<std::mutex> buffersLock(this->dataPtr->buffersMutex);
+    auto &all = this->dataPtr->buffers;
+    all.erase(std::remove_if(all.begin(), all.end(),
+          [](const std::shared_ptr<ProfileThreadBuffer> &_buffer)
+          {
+            return !_buffer->alive &&
+              _buffer->head == _buffer->tail;
+          }), all.end());
+  }
+}
+
+//////////////////////////////////////////////////
+std::vector<ProfileZoneStats> Profiler::Stats()
+{
+  this->Collect();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+  return this->dataPtr->Stats(this->dataPtr->histograms);
+}
+
+//////////////////////////////////////////////////
+std::vector<ProfileZoneStats> Profiler::WindowStats()
+{
+  this->Collect();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+  auto result = this->dataPtr->Stats(this->dataPtr->window);
+  for (auto &histogram : this->dataPtr->window)
+    histogram.Clear();
+  return result;
+}
+
+//////////////////////////////////////////////////
+uint64_t Profiler::Dropped() const
+{
+  uint64_t dropped;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+    dropped = this->dataPtr->dropped;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->buffersMutex);
+  for (auto const &buffer : this->dataPtr->buffers)
+  {
+    if (buffer->alive)
+      dropped += buffer->dropped;
+  }
+  return dropped;
+}
+
+//////////////////////////////////////////////////
+void Profiler::Reset()
+{
+  this->Collect();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->statsMutex);
+  for (auto &histogram : this->dataPtr->histograms)
+    histogram.Clear();
+  for (auto &histogram : this->dataPtr->window)
+    histogram.Clear();
+  this->dataPtr->dropped = 0;
+
+  std::lock_guard<std::mutex> buffersLock(this->dataPtr->buffersMutex);
+  for (auto &buffer : this->dataPtr->buffers)
+    buffer->dropped = 0;
+}
+
+//////////////////////////////////////////////////
+bool Profiler::WriteReport(const std::string &_filename)
+{
+  std::ofstream out(_filename.c_str(), std::ios::out);
+  if (!out.is_open())
+  {
+    gzerr << "Unable to open profiler report file[" << _filename << "]\n";
+    return false;
+  }
+
+  auto stats = this->Stats();
+
+  out << std::setw(50) << std::left << "zone"
+      << std::setw(12) << "count"
+      << std::setw(15) << "mean"
+      << std::setw(15) << "p50"
+      << std::setw(15) << "p99"
+      << std::setw(15) << "max" << std::endl;
+
+  for (auto const &zone : stats)
+  {
+    out << std::setw(50) << std::left << zone.name
+        << std::setw(12) << zone.count
+        << std::setw(15) << std::scientific << zone.mean
+        << std::setw(15) << zone.p50
+        << std::setw(15) << zone.p99
+        << std::setw(15) << zone.max << std::endl;
+  }
+  out << "dropped " << this->Dropped() << std::endl;
+
+  return out.good();
+}
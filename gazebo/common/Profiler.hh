@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PROFILER_HH_
+#define GAZEBO_COMMON_PROFILER_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  #define GZ_PROFILER_USE_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define GZ_PROFILER_USE_TSC
+#else
+  #include <chrono>
+#endif
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, Profiler)
+
+/// \brief Helpers to build unique variable names.
+#define GZ_PROFILE_CONCAT_IMPL(_a, _b) _a ## _b
+#define GZ_PROFILE_CONCAT(_a, _b) GZ_PROFILE_CONCAT_IMPL(_a, _b)
+
+/// \brief Declare a static zone identifier. The zone is registered the
+/// first time the declaration is executed, so later uses only cost an
+/// integer.
+/// \param[in] _id Name of the variable holding the identifier.
+/// \param[in] _name Name of the zone.
+#define GZ_PROFILE_ZONE(_id, _name) \
+  static const gazebo::common::ProfileZoneId _id = \
+    gazebo::common::Profiler::Instance()->RegisterZone(_name)
+
+/// \brief Profile the rest of the current scope.
+/// \param[in] _name Name of the zone.
+#define GZ_PROFILE_SCOPE(_name) \
+  GZ_PROFILE_ZONE(GZ_PROFILE_CONCAT(gzProfileZone, __LINE__), _name); \
+  gazebo::common::ProfileScope GZ_PROFILE_CONCAT(gzProfileScope, __LINE__)( \
+      GZ_PROFILE_CONCAT(gzProfileZone, __LINE__))
+
+/// \brief Start a lap timer, used to profile consecutive phases.
+/// \param[in] _timer Name of the timer variable.
+#define GZ_PROFILE_LAP_START(_timer) \
+  gazebo::common::ProfileLapTimer _timer
+
+/// \brief Record the time since the timer started or the last lap, and
+/// start a new lap.
+/// \param[in] _timer Timer started with GZ_PROFILE_LAP_START.
+/// \param[in] _name Name of the zone for this lap.
+#define GZ_PROFILE_LAP(_timer, _name) \
+  do \
+  { \
+    GZ_PROFILE_ZONE(gzProfileLapZone, _name); \
+    _timer.Lap(gzProfileLapZone); \
+  } while (0)
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declare private data class.
+    class ProfilerPrivate;
+
+    /// \addtogroup gazebo_common
+    /// \{
+
+    /// \brief Identifier of a profiled zone.
+    using ProfileZoneId = uint32_t;
+
+    /// \brief Timing statistics of a profiled zone. Times are in seconds.
+    class GZ_COMMON_VISIBLE ProfileZoneStats
+    {
+      /// \brief Name of the zone.
+      public: std::string name;
+
+      /// \brief Number of samples.
+      public: uint64_t count = 0;
+
+      /// \brief Mean duration.
+      public: double mean = 0;
+
+      /// \brief Median duration.
+      public: double p50 = 0;
+
+      /// \brief 99th percentile duration.
+      public: double p99 = 0;
+
+      /// \brief Maximum duration.
+      public: double max = 0;
+    };
+
+    /// \class Profiler Profiler.hh common/common.hh
+    /// \brief A low overhead profiler, cheap enough to be always on.
+    ///
+    /// Zones are registered once, usually through the GZ_PROFILE_* macros,
+    /// and referred to by an integer identifier afterwards. Each thread
+    /// records the duration of its zones, in CPU timestamp counter ticks,
+    /// into its own lock-free ring buffer. The buffers are drained by
+    /// Collect into per zone histograms, from which percentiles are
+    /// computed. If a ring fills up before it is drained, samples are
+    /// dropped and counted.
+    class GZ_COMMON_VISIBLE Profiler : public SingletonT<Profiler>
+    {
+      /// \brief Constructor.
+      private: Profiler();
+
+      /// \brief Destructor.
+      private: virtual ~Profiler();
+
+      /// \brief Register a zone. Registering the same name twice returns
+      /// the same identifier.
+      /// \param[in] _name Name of the zone.
+      /// \return Zone identifier.
+      public: ProfileZoneId RegisterZone(const std::string &_name);
+
+      /// \brief Get the name of a zone.
+      /// \param[in] _zone Zone identifier.
+      /// \return Name of the zone, empty if it isn't registered.
+      public: std::string ZoneName(const ProfileZoneId _zone) const;
+
+      /// \brief Get the number of registered zones.
+      /// \return Number of zones.
+      public: size_t ZoneCount() const;
+
+      /// \brief Get the current timestamp.
+      /// \return Ticks of the CPU timestamp counter, or nanoseconds of a
+      /// steady clock on platforms without one.
+      public: static inline uint64_t Ticks()
+              {
+#ifdef GZ_PROFILER_USE_TSC
+                return __rdtsc();
+#else
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+#endif
+              }
+
+      /// \brief Get the number of ticks per second, estimated by comparing
+      /// the timestamp counter to a steady clock.
+      /// \return Ticks per second.
+      public: double TicksPerSecond() const;
+
+      /// \brief Record a sample of a zone, in the calling thread's buffer.
+      /// \param[in] _zone Zone identifier.
+      /// \param[in] _start Timestamp at the start of the zone.
+      /// \param[in] _end Timestamp at the end of the zone.
+      public: void Record(const ProfileZoneId _zone, const uint64_t _start,
+                  const uint64_t _end);
+
+      /// \brief Enable or disable recording. Enabled by default.
+      /// \param[in] _enabled True to record samples.
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Whether samples are being recorded.
+      /// \return True if enabled.
+      public: bool Enabled() const;
+
+      /// \brief Drain the buffers of all threads into the histograms. This
+      /// should be called often enough for the buffers not to fill up.
+      public: void Collect();
+
+      /// \brief Get the statistics of all zones with samples since the
+      /// profiler was created or reset. Buffers are collected first.
+      /// \return Statistics, ordered by zone name.
+      public: std::vector<ProfileZoneStats> Stats();
+
+      /// \brief Get the statistics of all zones with samples since the last
+      /// call to this function, and start a new window.
+      /// \return Statistics, ordered by zone name.
+      public: std::vector<ProfileZoneStats> WindowStats();
+
+      /// \brief Get the number of samples dropped because a buffer was full.
+      /// \return Number of dropped samples.
+      public: uint64_t Dropped() const;
+
+      /// \brief Clear all statistics. Zones remain registered.
+      public: void Reset();
+
+      /// \brief Write the statistics of all zones to a file.
+      /// \param[in] _filename Path of the file.
+      /// \return True on success.
+      public: bool WriteReport(const std::string &_filename);
+
+      // Singleton implementation
+      private: friend class SingletonT<Profiler>;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ProfilerPrivate> dataPtr;
+    };
+
+    /// \class ProfileScope Profiler.hh common/common.hh
+    /// \brief Records the time between its construction and destruction.
+    /// \sa GZ_PROFILE_SCOPE
+    class ProfileScope
+    {
+      /// \brief Constructor.
+      /// \param[in] _zone Zone identifier.
+      public: explicit ProfileScope(const ProfileZoneId _zone)
+              : zone(_zone), start(Profiler::Ticks())
+              {
+              }
+
+      /// \brief Destructor. Records the sample.
+      public: ~ProfileScope()
+              {
+                Profiler::Instance()->Record(this->zone, this->start,
+                    Profiler::Ticks());
+              }
+
+      /// \brief Zone identifier.
+      private: const ProfileZoneId zone;
+
+      /// \brief Timestamp at construction.
+      private: const uint64_t start;
+    };
+
+    /// \class ProfileLapTimer Profiler.hh common/common.hh
+    /// \brief Records the time of consecutive phases.
+    /// \sa GZ_PROFILE_LAP_START
+    class ProfileLapTimer
+    {
+      /// \brief Constructor. Starts the first lap.
+      public: ProfileLapTimer()
+              : last(Profiler::Ticks())
+              {
+              }
+
+      /// \brief Record the current lap and start a new one.
+      /// \param[in] _zone Zone of the lap being recorded.
+      public: void Lap(const ProfileZoneId _zone)
+              {
+                const uint64_t now = Profiler::Ticks();
+                Profiler::Instance()->Record(_zone, this->last, now);
+                this->last = now;
+              }
+
+      /// \brief Start a new lap without recording the current one.
+      public: void Restart()
+              {
+                this->last = Profiler::Ticks();
+              }
+
+      /// \brief Timestamp at the start of the current lap.
+      private: uint64_t last;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_PROFILERPRIVATE_HH_
+#define GAZEBO_COMMON_PROFILERPRIVATE_HH_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gazebo/common/Profiler.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    /// \brief A sample recorded by a thread.
+    struct ProfileSample
+    {
+      /// \brief Zone identifier.
+      ProfileZoneId zone;
+
+      /// \brief Duration in ticks.
+      uint64_t ticks;
+    };
+
+    /// \brief Ring buffer of samples owned by one thread. The owning thread
+    /// is the only producer and Profiler::Collect the only consumer.
+    struct ProfileThreadBuffer
+    {
+      /// \brief Capacity of the ring, must be a power of two.
+      static const size_t kSize = 8192;
+
+      /// \brief Samples.
+      std::array<ProfileSample, kSize> ring;
+
+      /// \brief Index of the next sample to write.
+      std::atomic<uint64_t> head{0};
+
+      /// \brief Index of the next sample to read.
+      std::atomic<uint64_t> tail{0};
+
+      /// \brief Number of samples dropped because the ring was full.
+      std::atomic<uint64_t> dropped{0};
+
+      /// \brief False once the owning thread has exited.
+      std::atomic<bool> alive{true};
+    };
+
+    /// \brief Log-linear histogram of durations in ticks. Each power of two
+    /// is split into kSubBuckets linear buckets, which bounds the relative
+    /// error of percentiles to 1 / kSubBuckets.
+    class ProfileHistogram
+    {
+      /// \brief Number of bits of the linear part.
+      public: static const unsigned int kSubBits = 4;
+
+      /// \brief Number of linear buckets per power of two.
+      public: static const uint64_t kSubBuckets = 1u << kSubBits;
+
+      /// \brief Total number of buckets, enough for any 64 bit value.
+      public: static const size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+      /// \brief Add a sample.
+      /// \param[in] _ticks Duration.
+      public: void Add(const uint64_t _ticks);
+
+      /// \brief Add all the samples of another histogram.
+      /// \param[in] _other Histogram to merge.
+      public: void Merge(const ProfileHistogram &_other);
+
+      /// \brief Clear all samples.
+      public: void Clear();
+
+      /// \brief Get a percentile.
+      /// \param[in] _fraction Fraction of samples below the value, in [0, 1].
+      /// \return Duration in ticks.
+      public: double Percentile(const double _fraction) const;
+
+      /// \brief Get the bucket of a value.
+      /// \param[in] _ticks Value.
+      /// \return Bucket index.
+      public: static size_t Bucket(const uint64_t _ticks);
+
+      /// \brief Get the smallest value of a bucket.
+      /// \param[in] _bucket Bucket index.
+      /// \return Lower bound of the bucket.
+      public: static uint64_t BucketLow(const size_t _bucket);
+
+      /// \brief Number of samples.
+      public: uint64_t count = 0;
+
+      /// \brief Sum of all samples.
+      public: double sum = 0;
+
+      /// \brief Largest sample.
+      public: uint64_t max = 0;
+
+      /// \brief Samples per bucket, allocated on the first sample.
+      public: std::vector<uint64_t> buckets;
+    };
+
+    /// \brief Private data for the Profiler class.
+    class ProfilerPrivate
+    {
+      /// \brief Get the statistics of a set of histograms.
+      /// \param[in] _histograms Histograms, indexed by zone.
+      /// \return Statistics of the zones with samples, ordered by name.
+      public: std::vector<ProfileZoneStats> Stats(
+                  const std::vector<ProfileHistogram> &_histograms) const;
+
+      /// \brief Names of the zones, indexed by identifier.
+      public: std::vector<std::string> zoneNames;
+
+      /// \brief Identifiers of the zones, indexed by name.
+      public: std::map<std::string, ProfileZoneId> zoneIds;
+
+      /// \brief Protects zoneNames and zoneIds.
+      public: mutable std::mutex zonesMutex;
+
+      /// \brief Buffers of all threads which recorded samples.
+      public: std::vector<std::shared_ptr<ProfileThreadBuffer>> buffers;
+
+      /// \brief Protects buffers.
+      public: std::mutex buffersMutex;
+
+      /// \brief Histograms since the profiler was created or reset, indexed
+      /// by zone.
+      public: std::vector<ProfileHistogram> histograms;
+
+      /// \brief Histograms since the last call to WindowStats, indexed by
+      /// zone.
+      public: std::vector<ProfileHistogram> window;
+
+      /// \brief Samples dropped by threads which have exited.
+      public: uint64_t dropped = 0;
+
+      /// \brief Protects histograms, window and dropped, and serializes
+      /// collection.
+      public: mutable std::mutex statsMutex;
+
+      /// \brief Whether samples are recorded.
+      public: std::atomic<bool> enabled{true};
+
+      /// \brief Ticks when the profiler was created.
+      public: uint64_t startTicks = 0;
+
+      /// \brief Steady time when the profiler was created.
+      public: std::chrono::steady_clock::time_point startTime;
+    };
+  }
+}
+#endif
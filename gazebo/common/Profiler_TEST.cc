@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/common/Time.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ProfilerTest : public gazebo::testing::AutoLogFixture
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Find the statistics of a zone.
+/// \param[in] _stats Statistics of all zones.
+/// \param[in] _name Name of the zone.
+/// \return Statistics of the zone, with count 0 if it isn't found.
+common::ProfileZoneStats FindZone(
+    const std::vector<common::ProfileZoneStats> &_stats,
+    const std::string &_name)
+{
+  for (auto const &zone : _stats)
+  {
+    if (zone.name == _name)
+      return zone;
+  }
+  return common::ProfileZoneStats();
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, RegisterZone)
+{
+  auto profiler = common::Profiler::Instance();
+
+  auto zone = profiler->RegisterZone("ProfilerTest::RegisterZone");
+  EXPECT_EQ(zone, profiler->RegisterZone("ProfilerTest::RegisterZone"));
+  EXPECT_NE(zone, profiler->RegisterZone("ProfilerTest::Other"));
+  EXPECT_EQ("ProfilerTest::RegisterZone", profiler->ZoneName(zone));
+  EXPECT_TRUE(profiler->ZoneName(profiler->ZoneCount()).empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Percentiles)
+{
+  auto profiler = common::Profiler::Instance();
+  profiler->Reset();
+
+  auto zone = profiler->RegisterZone("ProfilerTest::Percentiles");
+
+  // Durations of 100 to 10000 ticks
+  for (uint64_t i = 1; i <= 100; ++i)
+    profiler->Record(zone, 1000, 1000 + i * 100);
+
+  auto stats = FindZone(profiler->Stats(), "ProfilerTest::Percentiles");
+  EXPECT_EQ(100u, stats.count);
+  ASSERT_GT(stats.max, 0.0);
+
+  // Percentiles are accurate to the histogram resolution
+  EXPECT_NEAR(0.505, stats.mean / stats.max, 1e-6);
+  EXPECT_NEAR(0.5, stats.p50 / stats.max, 0.05);
+  EXPECT_NEAR(0.99, stats.p99 / stats.max, 0.05);
+  EXPECT_LE(stats.p99, stats.max);
+
+  // The window is cleared after being read
+  stats = FindZone(profiler->WindowStats(), "ProfilerTest::Percentiles");
+  EXPECT_EQ(100u, stats.count);
+  stats = FindZone(profiler->WindowStats(), "ProfilerTest::Percentiles");
+  EXPECT_EQ(0u, stats.count);
+
+  // The cumulative statistics aren't
+  stats = FindZone(profiler->Stats(), "ProfilerTest::Percentiles");
+  EXPECT_EQ(100u, stats.count);
+
+  profiler->Reset();
+  stats = FindZone(profiler->Stats(), "ProfilerTest::Percentiles");
+  EXPECT_EQ(0u, stats.count);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Threads)
+{
+  auto profiler = common::Profiler::Instance();
+  profiler->Reset();
+
+  const int threadCount = 4;
+  const int sampleCount = 1000;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t)
+  {
+    threads.push_back(std::thread([]()
+      {
+        for (int i = 0; i < sampleCount; ++i)
+        {
+          GZ_PROFILE_SCOPE("ProfilerTest::Threads");
+        }
+      }));
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  // Buffers of exited threads are still collected
+  auto stats = FindZone(profiler->Stats(), "ProfilerTest::Threads");
+  EXPECT_EQ(static_cast<uint64_t>(threadCount * sampleCount), stats.count);
+  EXPECT_EQ(0u, profiler->Dropped());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, LapTimer)
+{
+  auto profiler = common::Profiler::Instance();
+  profiler->Reset();
+
+  GZ_PROFILE_LAP_START(timer);
+  common::Time::MSleep(10);
+  GZ_PROFILE_LAP(timer, "ProfilerTest::LapTimer::first");
+  GZ_PROFILE_LAP(timer, "ProfilerTest::LapTimer::second");
+
+  auto stats = profiler->Stats();
+  auto first = FindZone(stats, "ProfilerTest::LapTimer::first");
+  auto second = FindZone(stats, "ProfilerTest::LapTimer::second");
+  EXPECT_EQ(1u, first.count);
+  EXPECT_EQ(1u, second.count);
+  EXPECT_GT(first.max, second.max);
+  EXPECT_GT(first.max, 0.005);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ProfilerTest, Disabled)
+{
+  auto profiler = common::Profiler::Instance();
+  profiler->Reset();
+
+  profiler->SetEnabled(false);
+  EXPECT_FALSE(profiler->Enabled());
+  {
+    GZ_PROFILE_SCOPE("ProfilerTest::Disabled");
+  }
+  profiler->SetEnabled(true);
+  EXPECT_TRUE(profiler->Enabled());
+
+  auto stats = FindZone(profiler->Stats(), "ProfilerTest::Disabled");
+  EXPECT_EQ(0u, stats.count);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
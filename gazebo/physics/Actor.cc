@@ -29,6 +29,7 @@
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/physics/Actor.hh"
+#include "gazebo/physics/ActorCrowd.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
@@ -54,6 +55,16 @@ class gazebo::physics::ActorPrivate
 
   /// \brief Last map associating skeleton nodes from skin and animation
   public: std::map<std::string, std::string> lastSkelMap;
+
+  /// \brief Keys identifying each skeleton animation's source, used to
+  /// share clips between crowd actors. Indexed by animation name.
+  public: std::map<std::string, std::string> animKeys;
+
+  /// \brief Slot in the world's actor crowd, -1 if not in crowd mode.
+  public: int crowdSlot = -1;
+
+  /// \brief Pre-sampled clips used in crowd mode, indexed by animation name.
+  public: std::map<std::string, std::shared_ptr<const ActorClip>> clips;
 };
 
 using namespace gazebo;
@@ -514,6 +525,11 @@ void Actor::LoadAnimation(sdf::ElementPtr _sdf)
   this->skelAnimation[animName] = skel->GetAnimation(0);
   this->interpolateX[animName] = _sdf->Get<bool>("interpolate_x");
   this->skelNodesMap[animName] = skelMap;
+
+  std::stringstream key;
+  key << this->skinFile << ":" << this->skinScale << ":" << animFile << ":"
+      << animScale;
+  this->dataPtr->animKeys[animName] = key.str();
 }
 
 //////////////////////////////////////////////////
@@ -676,8 +692,12 @@ void Actor::Update()
   common::Time currentTime = this->world->SimTime();
   if (!this->active)
   {
-    this->SetPose(this->dataPtr->lastFrame, this->dataPtr->lastSkelMap,
-                  currentTime.Double());
+    // Crowd actors keep the poses set by the last crowd update
+    if (this->dataPtr->crowdSlot < 0)
+    {
+      this->SetPose(this->dataPtr->lastFrame, this->dataPtr->lastSkelMap,
+                    currentTime.Double());
+    }
     return;
   }
 
@@ -698,8 +718,11 @@ void Actor::Update()
     // waiting for delayed start
     if (this->scriptTime < 0)
     {
-      this->SetPose(this->dataPtr->lastFrame, this->dataPtr->lastSkelMap,
-                    currentTime.Double());
+      if (this->dataPtr->crowdSlot < 0)
+      {
+        this->SetPose(this->dataPtr->lastFrame, this->dataPtr->lastSkelMap,
+                      currentTime.Double());
+      }
       return;
     }
 
@@ -717,15 +740,19 @@ void Actor::Update()
       }
     }
 
-    // Pick trajectory which should be played at this time
-    for (unsigned int i = 0; i < this->trajInfo.size(); ++i)
+    // Pick trajectory which should be played at this time. Trajectories
+    // are contiguous and sorted by time, so this is the first one which
+    // hasn't ended yet.
+    auto trajIter = std::lower_bound(this->trajInfo.begin(),
+        this->trajInfo.end(), this->scriptTime,
+        [](const TrajectoryInfo &_info, const double _time)
+        {
+          return _info.endTime < _time;
+        });
+    if (trajIter != this->trajInfo.end() &&
+        trajIter->startTime <= this->scriptTime)
     {
-      if (this->trajInfo[i].startTime <= this->scriptTime &&
-          this->trajInfo[i].endTime >= this->scriptTime)
-      {
-        tinfo = &this->trajInfo[i];
-        break;
-      }
+      tinfo = &(*trajIter);
     }
 
     if (tinfo == nullptr)
@@ -783,6 +810,13 @@ void Actor::Update()
     return;
   }
 
+  // In crowd mode, the world's actor crowd evaluates the skeleton
+  if (this->dataPtr->crowdSlot >= 0)
+  {
+    this->SubmitCrowdFrame(*tinfo, modelPose, currentTime.Double());
+    return;
+  }
+
   auto skelMap = this->skelNodesMap[tinfo->type];
 
   std::map<std::string, ignition::math::Matrix4d> frame;
@@ -813,22 +847,36 @@ void Actor::Update()
     rootTrans = frame[skelMap[this->skeleton->GetRootNode()->GetName()]];
   }
 
-  ignition::math::Vector3d rootPos = rootTrans.Translation();
-  ignition::math::Quaterniond rootRot = rootTrans.Rotation();
+  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] =
+      this->RootTransform(*tinfo, modelPose, rootTrans);
+
+  this->dataPtr->lastFrame = frame;
+  this->dataPtr->lastSkelMap = skelMap;
+
+  this->SetPose(frame, skelMap, currentTime.Double());
+}
+
+//////////////////////////////////////////////////
+ignition::math::Matrix4d Actor::RootTransform(const TrajectoryInfo &_tinfo,
+    const ignition::math::Pose3d &_modelPose,
+    const ignition::math::Matrix4d &_rootTrans) const
+{
+  ignition::math::Vector3d rootPos = _rootTrans.Translation();
+  ignition::math::Quaterniond rootRot = _rootTrans.Rotation();
   // Zero root pos for BVH
   if (this->dataPtr->bvhFile)
   {
     rootPos = ignition::math::Vector3d::Zero;
   }
 
-  if (tinfo->translated)
+  if (_tinfo.translated)
     rootPos.X() = 0.0;
   ignition::math::Pose3d actorPose;
 
   if (!this->customTrajectoryInfo)
   {
-    actorPose.Pos() = modelPose.Pos() + modelPose.Rot().RotateVector(rootPos);
-    actorPose.Rot() = modelPose.Rot() * rootRot;
+    actorPose.Pos() = _modelPose.Pos() + _modelPose.Rot().RotateVector(rootPos);
+    actorPose.Rot() = _modelPose.Rot() * rootRot;
   }
   else
   {
@@ -852,12 +900,104 @@ void Actor::Update()
   // workaround for rotation bug
   rootM.SetTranslation(rootM.Translation() * this->skinScale);
 
-  frame[skelMap[this->skeleton->GetRootNode()->GetName()]] = rootM;
+  return rootM;
+}
 
-  this->dataPtr->lastFrame = frame;
-  this->dataPtr->lastSkelMap = skelMap;
+//////////////////////////////////////////////////
+void Actor::SubmitCrowdFrame(const TrajectoryInfo &_tinfo,
+    const ignition::math::Pose3d &_modelPose, const double _time)
+{
+  auto clipIter = this->dataPtr->clips.find(_tinfo.type);
+  if (clipIter == this->dataPtr->clips.end() || !clipIter->second)
+    return;
 
-  this->SetPose(frame, skelMap, currentTime.Double());
+  const auto &clip = clipIter->second;
+
+  double animTime = this->scriptTime;
+  if (!this->customTrajectoryInfo && this->interpolateX[_tinfo.type] &&
+      this->trajectories.find(_tinfo.id) != this->trajectories.end())
+  {
+    animTime = clip->TimeAtX(this->pathLength);
+  }
+  unsigned int frameIndex = clip->FrameIndex(animTime);
+
+  this->lastTraj = _tinfo.id;
+
+  ignition::math::Matrix4d rootTrans = ignition::math::Matrix4d::Identity;
+  if (clip->Animated(0))
+  {
+    const double *root = clip->Frame(frameIndex);
+    rootTrans = ignition::math::Matrix4d(
+        root[0], root[1], root[2], root[3],
+        root[4], root[5], root[6], root[7],
+        root[8], root[9], root[10], root[11],
+        0, 0, 0, 1);
+  }
+
+  ignition::math::Matrix4d rootM = clip->AlignRoot(
+      this->RootTransform(_tinfo, _modelPose, rootTrans));
+
+  this->world->ActorCrowd().Submit(this->dataPtr->crowdSlot, clip,
+      frameIndex, rootM, this->customTrajectoryInfo != nullptr, _time);
+}
+
+//////////////////////////////////////////////////
+void Actor::SetCrowdMode(const bool _enable)
+{
+  if (_enable == (this->dataPtr->crowdSlot >= 0))
+    return;
+
+  physics::ActorCrowd &crowd = this->world->ActorCrowd();
+
+  if (!_enable)
+  {
+    crowd.RemoveActor(this->dataPtr->crowdSlot);
+    this->dataPtr->crowdSlot = -1;
+    this->dataPtr->clips.clear();
+    return;
+  }
+
+  if (!this->skeleton)
+  {
+    gzwarn << "Actor [" << this->GetName() << "] has no skeleton, crowd mode "
+        << "will only update its trajectory." << std::endl;
+  }
+
+  // Clips are sampled at twice the maximum animation refresh rate
+  const double clipRate = 60.0;
+
+  for (auto &anim : this->skelAnimation)
+  {
+    if (!anim.second || !this->skeleton)
+      continue;
+
+    const std::string &animName = anim.first;
+    std::string key = this->dataPtr->animKeys[animName];
+    if (key.empty())
+      key = this->skinFile + ":" + animName;
+
+    this->dataPtr->clips[animName] = crowd.Clip(key,
+        [&]()
+        {
+          if (this->dataPtr->bvhFile)
+          {
+            return std::make_shared<ActorClip>(this->skeleton,
+                anim.second, this->skelNodesMap[animName], clipRate,
+                this->dataPtr->translationAligner,
+                this->dataPtr->rotationAligner);
+          }
+          return std::make_shared<ActorClip>(this->skeleton,
+              anim.second, this->skelNodesMap[animName], clipRate);
+        });
+  }
+
+  this->dataPtr->crowdSlot = crowd.AddActor(this);
+}
+
+//////////////////////////////////////////////////
+bool Actor::CrowdMode() const
+{
+  return this->dataPtr->crowdSlot >= 0;
 }
 
 //////////////////////////////////////////////////
@@ -980,6 +1120,7 @@ void Actor::SetPose(std::map<std::string, ignition::math::Matrix4d> _frame,
 //////////////////////////////////////////////////
 void Actor::Fini()
 {
+  this->SetCrowdMode(false);
   this->ResetCustomTrajectory();
   Model::Fini();
 }
@@ -39,6 +39,7 @@ namespace gazebo
 
   namespace physics
   {
+    class ActorCrowd;
     class ActorPrivate;
 
     /// \brief Information about a trajectory for an Actor.
@@ -168,6 +169,20 @@ namespace gazebo
       /// \sa SetCustomTrajectory
       public: void ResetCustomTrajectory();
 
+      /// \brief Enable or disable crowd mode. In crowd mode, the skeleton
+      /// animations are pre-sampled into clips which are shared with other
+      /// actors using the same skin and animation, and bone poses are
+      /// evaluated and published together with all other crowd actors by the
+      /// world's ActorCrowd.
+      /// \param[in] _enable True to enable crowd mode.
+      /// \sa CrowdMode
+      public: void SetCrowdMode(const bool _enable);
+
+      /// \brief Get whether the actor is in crowd mode.
+      /// \return True if crowd mode is enabled.
+      /// \sa SetCrowdMode
+      public: bool CrowdMode() const;
+
       /// \brief Get whether the links in the actor can collide with each other.
       /// This is always false for actors.
       /// \return False, because actors can't self-collide.
@@ -287,6 +302,25 @@ namespace gazebo
                    std::map<std::string, std::string> _skelMap,
                    const double _time);
 
+      /// \brief Submit the current frame to the world's actor crowd instead
+      /// of setting the pose directly.
+      /// \param[in] _tinfo Trajectory being played.
+      /// \param[in] _modelPose Pose of the trajectory at the current time.
+      /// \param[in] _time Current simulation time.
+      private: void SubmitCrowdFrame(const TrajectoryInfo &_tinfo,
+                   const ignition::math::Pose3d &_modelPose,
+                   const double _time);
+
+      /// \brief Compute the world transform of the root bone.
+      /// \param[in] _tinfo Trajectory being played.
+      /// \param[in] _modelPose Pose of the trajectory at the current time.
+      /// \param[in] _rootTrans Animated transform of the root bone.
+      /// \return World transform of the root bone.
+      private: ignition::math::Matrix4d RootTransform(
+                   const TrajectoryInfo &_tinfo,
+                   const ignition::math::Pose3d &_modelPose,
+                   const ignition::math::Matrix4d &_rootTrans) const;
+
       /// \brief Pointer to the actor's mesh.
       protected: const common::Mesh *mesh = nullptr;
 
@@ -388,6 +422,10 @@ namespace gazebo
 
       /// \brief Pointer to private data.
       private: std::unique_ptr<ActorPrivate> dataPtr;
+
+      /// \brief The crowd publishes skin visual information on behalf of
+      /// the actor.
+      private: friend class ActorCrowd;
     };
     /// \}
   }
@@ -0,0 +1,745 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Skeleton.hh"
+#include "gazebo/common/SkeletonAnimation.hh"
+
+#include "gazebo/msgs/msgs.hh"
+
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/Publisher.hh"
+
+#include "gazebo/physics/Actor.hh"
+#include "gazebo/physics/ActorCrowd.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/World.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the ActorClip class
+    class ActorClipPrivate
+    {
+      /// \brief Sampling rate in Hz.
+      public: double rate = 0.0;
+
+      /// \brief Animation length in seconds.
+      public: double length = 0.0;
+
+      /// \brief Number of frames.
+      public: unsigned int frameCount = 0;
+
+      /// \brief Number of bones per frame.
+      public: unsigned int boneCount = 0;
+
+      /// \brief Bone transforms, frame major.
+      public: std::vector<double> frames;
+
+      /// \brief Running maximum of the root bone's X coordinate at each
+      /// frame, used to look up times by X.
+      public: std::vector<double> rootMaxX;
+
+      /// \brief Root bone X coordinate at each frame.
+      public: std::vector<double> rootX;
+
+      /// \brief Parent index of each bone.
+      public: std::vector<int> parents;
+
+      /// \brief Skeleton handle of each bone.
+      public: std::vector<unsigned int> handles;
+
+      /// \brief Skin node name of each bone.
+      public: std::vector<std::string> names;
+
+      /// \brief Whether each bone is animated.
+      public: std::vector<bool> animated;
+
+      /// \brief BVH translation alignment of the root bone.
+      public: ignition::math::Matrix4d rootTranslationAlign =
+          ignition::math::Matrix4d::Identity;
+
+      /// \brief BVH rotation alignment of the root bone.
+      public: ignition::math::Matrix4d rootRotationAlign =
+          ignition::math::Matrix4d::Identity;
+    };
+
+    /// \internal
+    /// \brief Per actor state held by the crowd.
+    class ActorCrowdSlot
+    {
+      /// \brief The actor, null if the slot is free.
+      public: Actor *actor = nullptr;
+
+      /// \brief True if a frame was submitted since the last update.
+      public: bool pending = false;
+
+      /// \brief Clip being played.
+      public: std::shared_ptr<const ActorClip> clip;
+
+      /// \brief Frame index within the clip.
+      public: unsigned int frame = 0;
+
+      /// \brief Root bone world transform, in 3x4 form.
+      public: double root[ActorClip::kTransformSize];
+
+      /// \brief True if the actor follows a custom trajectory.
+      public: bool custom = false;
+
+      /// \brief Simulation time of the frame.
+      public: double time = 0.0;
+
+      /// \brief Clip for which the links were resolved.
+      public: const ActorClip *linksClip = nullptr;
+
+      /// \brief Link of each bone, in clip bone order.
+      public: std::vector<Link *> links;
+    };
+
+    /// \internal
+    /// \brief Actors evaluated together because they play the same clip.
+    class ActorCrowdGroup
+    {
+      /// \brief Slots of the actors in the group.
+      public: std::vector<unsigned int> slots;
+
+      /// \brief World transforms of all bones of all actors, structure of
+      /// arrays: element k of bone b for actor a is at
+      /// (b * kTransformSize + k) * n + a.
+      public: std::vector<double> world;
+
+      /// \brief Local transforms of one bone for all actors, structure of
+      /// arrays.
+      public: std::vector<double> local;
+    };
+
+    /// \internal
+    /// \brief Private data for the ActorCrowd class
+    class ActorCrowdPrivate
+    {
+      /// \brief Constructor.
+      /// \param[in] _world A reference to the world.
+      public: explicit ActorCrowdPrivate(World &_world)
+        : world(_world)
+      {
+      }
+
+      /// \brief Reference to the world.
+      public: World &world;
+
+      /// \brief Shared clips, indexed by key.
+      public: std::map<std::string, std::shared_ptr<const ActorClip>> clips;
+
+      /// \brief Actor slots. A deque is used so that references to slots
+      /// stay valid while new actors are added.
+      public: std::deque<ActorCrowdSlot> slots;
+
+      /// \brief Free slot indices.
+      public: std::vector<unsigned int> freeSlots;
+
+      /// \brief Groups of actors evaluated together, indexed by clip. Kept
+      /// across updates to avoid reallocating buffers.
+      public: std::unordered_map<const ActorClip *, ActorCrowdGroup> groups;
+
+      /// \brief Aggregated skeleton pose message, reused across updates.
+      public: msgs::PoseAnimation_V msg;
+
+      /// \brief Protects clips and slots.
+      public: std::mutex mutex;
+
+      // Transport is declared last.
+      /// \brief Node for communication.
+      public: transport::NodePtr node;
+
+      /// \brief Publisher of the aggregated skeleton poses.
+      public: transport::PublisherPtr posePub;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+/// \brief Copy the top 3 rows of an affine matrix.
+/// \param[in] _m Matrix.
+/// \param[out] _out 12 doubles.
+static void ToAffine(const ignition::math::Matrix4d &_m, double *_out)
+{
+  for (unsigned int r = 0; r < 3; ++r)
+    for (unsigned int c = 0; c < 4; ++c)
+      _out[r * 4 + c] = _m(r, c);
+}
+
+/////////////////////////////////////////////////
+/// \brief Build an affine matrix from its top 3 rows.
+/// \param[in] _in 12 doubles.
+/// \return Matrix.
+static ignition::math::Matrix4d FromAffine(const double *_in)
+{
+  return ignition::math::Matrix4d(
+      _in[0], _in[1], _in[2], _in[3],
+      _in[4], _in[5], _in[6], _in[7],
+      _in[8], _in[9], _in[10], _in[11],
+      0, 0, 0, 1);
+}
+
+/////////////////////////////////////////////////
+/// \brief Look up an aligner matrix, defaulting to the identity.
+/// \param[in] _aligner Aligner map.
+/// \param[in] _name Animation node name.
+/// \return Aligner matrix.
+static ignition::math::Matrix4d Aligner(
+    const std::map<std::string, ignition::math::Matrix4d> &_aligner,
+    const std::string &_name)
+{
+  auto iter = _aligner.find(_name);
+  if (iter == _aligner.end())
+    return ignition::math::Matrix4d::Identity;
+  return iter->second;
+}
+
+/////////////////////////////////////////////////
+ActorClip::ActorClip(common::Skeleton *_skel,
+    common::SkeletonAnimation *_anim,
+    const std::map<std::string, std::string> &_skelMap, const double _rate,
+    const std::map<std::string, ignition::math::Matrix4d> &_translationAligner,
+    const std::map<std::string, ignition::math::Matrix4d> &_rotationAligner)
+  : dataPtr(new ActorClipPrivate)
+{
+  this->dataPtr->rate = std::max(_rate, 1.0);
+  this->dataPtr->length = _anim ? _anim->GetLength() : 0.0;
+
+  const bool bvh = !_translationAligner.empty() || !_rotationAligner.empty();
+
+  // Order bones breadth first so parents are evaluated before children
+  std::vector<common::SkeletonNode *> nodes;
+  if (_skel && _skel->GetRootNode())
+  {
+    nodes.push_back(_skel->GetRootNode());
+    this->dataPtr->parents.push_back(-1);
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+      for (unsigned int c = 0; c < nodes[i]->GetChildCount(); ++c)
+      {
+        nodes.push_back(nodes[i]->GetChild(c));
+        this->dataPtr->parents.push_back(static_cast<int>(i));
+      }
+    }
+  }
+
+  this->dataPtr->boneCount = nodes.size();
+
+  std::vector<std::string> animNames(nodes.size());
+  for (unsigned int b = 0; b < nodes.size(); ++b)
+  {
+    this->dataPtr->handles.push_back(nodes[b]->GetHandle());
+    this->dataPtr->names.push_back(nodes[b]->GetName());
+
+    auto mapIter = _skelMap.find(nodes[b]->GetName());
+    if (mapIter != _skelMap.end())
+      animNames[b] = mapIter->second;
+
+    this->dataPtr->animated.push_back(_anim && !animNames[b].empty() &&
+        _anim->HasNode(animNames[b]));
+  }
+
+  if (bvh && !nodes.empty())
+  {
+    this->dataPtr->rootTranslationAlign =
+        Aligner(_translationAligner, animNames[0]);
+    this->dataPtr->rootRotationAlign = Aligner(_rotationAligner, animNames[0]);
+  }
+
+  this->dataPtr->frameCount = static_cast<unsigned int>(
+      std::ceil(this->dataPtr->length * this->dataPtr->rate)) + 1;
+  this->dataPtr->frames.resize(static_cast<size_t>(this->dataPtr->frameCount) *
+      this->dataPtr->boneCount * kTransformSize);
+  this->dataPtr->rootX.resize(this->dataPtr->frameCount, 0.0);
+  this->dataPtr->rootMaxX.resize(this->dataPtr->frameCount, 0.0);
+
+  for (unsigned int f = 0; f < this->dataPtr->frameCount; ++f)
+  {
+    double time = std::min(f / this->dataPtr->rate, this->dataPtr->length);
+    double *frame = &this->dataPtr->frames[
+        static_cast<size_t>(f) * this->dataPtr->boneCount * kTransformSize];
+
+    for (unsigned int b = 0; b < nodes.size(); ++b)
+    {
+      ignition::math::Matrix4d transform = nodes[b]->Transform();
+      if (this->dataPtr->animated[b])
+      {
+        transform = _anim->NodePoseAt(animNames[b], time);
+
+        if (b == 0)
+          this->dataPtr->rootX[f] = transform.Translation().X();
+
+        // Same alignment as Actor::SetPose. The root is aligned after the
+        // actor's trajectory is applied, see AlignRoot.
+        if (bvh && b != 0)
+        {
+          ignition::math::Vector3d bvhOffset = transform.Translation();
+          ignition::math::Vector3d daeOffset =
+              nodes[b]->Transform().Translation();
+          transform.SetTranslation(daeOffset.Length() * bvhOffset.Normalize());
+          transform = Aligner(_translationAligner, animNames[b]) * transform *
+              Aligner(_rotationAligner, animNames[b]);
+        }
+      }
+
+      ToAffine(transform, frame + b * kTransformSize);
+    }
+
+    this->dataPtr->rootMaxX[f] = f == 0 ? this->dataPtr->rootX[f] :
+        std::max(this->dataPtr->rootMaxX[f-1], this->dataPtr->rootX[f]);
+  }
+}
+
+/////////////////////////////////////////////////
+ActorClip::~ActorClip()
+{
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorClip::FrameCount() const
+{
+  return this->dataPtr->frameCount;
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorClip::BoneCount() const
+{
+  return this->dataPtr->boneCount;
+}
+
+/////////////////////////////////////////////////
+double ActorClip::Length() const
+{
+  return this->dataPtr->length;
+}
+
+/////////////////////////////////////////////////
+double ActorClip::Rate() const
+{
+  return this->dataPtr->rate;
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorClip::FrameIndex(const double _time) const
+{
+  double time = std::max(_time, 0.0);
+
+  // Wrap around, as SkeletonAnimation::PoseAt does when looping
+  if (this->dataPtr->length > 0.0 && time > this->dataPtr->length)
+  {
+    time = std::fmod(time, this->dataPtr->length);
+    if (ignition::math::equal(time, 0.0))
+      time = this->dataPtr->length;
+  }
+
+  unsigned int index =
+      static_cast<unsigned int>(std::lround(time * this->dataPtr->rate));
+  return std::min(index, this->dataPtr->frameCount - 1);
+}
+
+/////////////////////////////////////////////////
+double ActorClip::TimeAtX(const double _x) const
+{
+  if (!this->dataPtr->animated.empty() && !this->dataPtr->animated[0])
+    return 0.0;
+
+  const auto &rootX = this->dataPtr->rootX;
+  const double firstX = rootX.front();
+  const double lastX = rootX.back();
+
+  double x = std::max(_x, firstX);
+  if (lastX > 0.0)
+  {
+    while (x > lastX)
+      x -= lastX;
+  }
+  else
+  {
+    x = std::min(x, lastX);
+  }
+
+  // First frame at which the root reaches x. The running maximum is
+  // monotonic, so this is a binary search.
+  auto iter = std::lower_bound(this->dataPtr->rootMaxX.begin(),
+      this->dataPtr->rootMaxX.end(), x);
+  if (iter == this->dataPtr->rootMaxX.end())
+    return this->dataPtr->length;
+
+  size_t index = iter - this->dataPtr->rootMaxX.begin();
+  double time = std::min(index / this->dataPtr->rate, this->dataPtr->length);
+  if (index == 0 || ignition::math::equal(rootX[index], x))
+    return time;
+
+  double x1 = rootX[index - 1];
+  double x2 = rootX[index];
+  double t1 = (index - 1) / this->dataPtr->rate;
+  if (ignition::math::equal(x1, x2))
+    return t1;
+
+  return t1 + ((time - t1) * (x - x1) / (x2 - x1));
+}
+
+/////////////////////////////////////////////////
+const double *ActorClip::Frame(const unsigned int _frame) const
+{
+  unsigned int frame = std::min(_frame, this->dataPtr->frameCount - 1);
+  return &this->dataPtr->frames[
+      static_cast<size_t>(frame) * this->dataPtr->boneCount * kTransformSize];
+}
+
+/////////////////////////////////////////////////
+ignition::math::Matrix4d ActorClip::AlignRoot(
+    const ignition::math::Matrix4d &_root) const
+{
+  return this->dataPtr->rootTranslationAlign * _root *
+      this->dataPtr->rootRotationAlign;
+}
+
+/////////////////////////////////////////////////
+const std::vector<int> &ActorClip::Parents() const
+{
+  return this->dataPtr->parents;
+}
+
+/////////////////////////////////////////////////
+const std::vector<unsigned int> &ActorClip::Handles() const
+{
+  return this->dataPtr->handles;
+}
+
+/////////////////////////////////////////////////
+const std::vector<std::string> &ActorClip::BoneNames() const
+{
+  return this->dataPtr->names;
+}
+
+/////////////////////////////////////////////////
+bool ActorClip::Animated(const unsigned int _bone) const
+{
+  return _bone < this->dataPtr->animated.size() &&
+      this->dataPtr->animated[_bone];
+}
+
+/////////////////////////////////////////////////
+ActorCrowd::ActorCrowd(World &_world)
+  : dataPtr(new ActorCrowdPrivate(_world))
+{
+  this->dataPtr->node = transport::NodePtr(new transport::Node());
+  this->dataPtr->node->Init(this->dataPtr->world.Name());
+  this->dataPtr->posePub =
+      this->dataPtr->node->Advertise<msgs::PoseAnimation_V>(
+      "~/skeleton_pose/info_v", 10);
+}
+
+/////////////////////////////////////////////////
+ActorCrowd::~ActorCrowd()
+{
+  this->dataPtr->posePub.reset();
+  // Must call fini on node to remove it from topic manager.
+  this->dataPtr->node->Fini();
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const ActorClip> ActorCrowd::Clip(const std::string &_key,
+    const std::function<std::shared_ptr<const ActorClip>()> &_build)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->clips.find(_key);
+  if (iter != this->dataPtr->clips.end())
+    return iter->second;
+
+  auto clip = _build();
+  if (clip)
+    this->dataPtr->clips[_key] = clip;
+  return clip;
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorCrowd::ClipCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->clips.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorCrowd::AddActor(Actor *_actor)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  unsigned int slot;
+  if (!this->dataPtr->freeSlots.empty())
+  {
+    slot = this->dataPtr->freeSlots.back();
+    this->dataPtr->freeSlots.pop_back();
+  }
+  else
+  {
+    slot = this->dataPtr->slots.size();
+    this->dataPtr->slots.emplace_back();
+  }
+
+  this->dataPtr->slots[slot] = ActorCrowdSlot();
+  this->dataPtr->slots[slot].actor = _actor;
+  return slot;
+}
+
+/////////////////////////////////////////////////
+void ActorCrowd::RemoveActor(const unsigned int _slot)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  if (_slot >= this->dataPtr->slots.size() ||
+      !this->dataPtr->slots[_slot].actor)
+  {
+    gzerr << "Invalid actor crowd slot [" << _slot << "]" << std::endl;
+    return;
+  }
+
+  this->dataPtr->slots[_slot] = ActorCrowdSlot();
+  this->dataPtr->freeSlots.push_back(_slot);
+
+  // Drop groups which may refer to clips that are no longer played
+  this->dataPtr->groups.clear();
+}
+
+/////////////////////////////////////////////////
+unsigned int ActorCrowd::ActorCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->slots.size() - this->dataPtr->freeSlots.size();
+}
+
+/////////////////////////////////////////////////
+void ActorCrowd::Submit(const unsigned int _slot,
+    const std::shared_ptr<const ActorClip> &_clip, const unsigned int _frame,
+    const ignition::math::Matrix4d &_root, const bool _custom,
+    const double _time)
+{
+  // No lock: each actor only writes to its own slot, and slots are only
+  // added or removed outside of the world update.
+  ActorCrowdSlot &slot = this->dataPtr->slots[_slot];
+  slot.clip = _clip;
+  slot.frame = _frame;
+  ToAffine(_root, slot.root);
+  slot.custom = _custom;
+  slot.time = _time;
+  slot.pending = true;
+}
+
+/////////////////////////////////////////////////
+void ActorCrowd::Update()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const unsigned int kSize = ActorClip::kTransformSize;
+
+  // Group pending actors by clip
+  for (auto &group : this->dataPtr->groups)
+    group.second.slots.clear();
+
+  bool any = false;
+  for (unsigned int s = 0; s < this->dataPtr->slots.size(); ++s)
+  {
+    const ActorCrowdSlot &slot = this->dataPtr->slots[s];
+    if (!slot.actor || !slot.pending || !slot.clip)
+      continue;
+    this->dataPtr->groups[slot.clip.get()].slots.push_back(s);
+    any = true;
+  }
+
+  if (!any)
+    return;
+
+  const bool publish = this->dataPtr->posePub &&
+      this->dataPtr->posePub->HasConnections();
+  if (publish)
+    this->dataPtr->msg.clear_pose_animation();
+
+  for (auto &groupIter : this->dataPtr->groups)
+  {
+    ActorCrowdGroup &group = groupIter.second;
+    const size_t n = group.slots.size();
+    if (n == 0)
+      continue;
+
+    const ActorClip *clip =
+        this->dataPtr->slots[group.slots[0]].clip.get();
+    const unsigned int boneCount = clip->BoneCount();
+    const std::vector<int> &parents = clip->Parents();
+
+    group.world.resize(static_cast<size_t>(boneCount) * kSize * n);
+    group.local.resize(kSize * n);
+    double *world = group.world.data();
+    double *local = group.local.data();
+
+    // Root bones come straight from the submitted transforms
+    for (size_t a = 0; a < n; ++a)
+    {
+      const double *root = this->dataPtr->slots[group.slots[a]].root;
+      for (unsigned int k = 0; k < kSize; ++k)
+        world[k * n + a] = root[k];
+    }
+
+    // Evaluate one bone at a time for all actors. Each of the 12 matrix
+    // elements is a contiguous array over actors, so the compose loops
+    // below are straight line code which the compiler can vectorize.
+    for (unsigned int b = 1; b < boneCount; ++b)
+    {
+      for (size_t a = 0; a < n; ++a)
+      {
+        const ActorCrowdSlot &slot = this->dataPtr->slots[group.slots[a]];
+        const double *src = clip->Frame(slot.frame) + b * kSize;
+        for (unsigned int k = 0; k < kSize; ++k)
+          local[k * n + a] = src[k];
+      }
+
+      const double *p = world + static_cast<size_t>(parents[b]) * kSize * n;
+      double *out = world + static_cast<size_t>(b) * kSize * n;
+      for (unsigned int r = 0; r < 3; ++r)
+      {
+        const double *p0 = p + (r * 4 + 0) * n;
+        const double *p1 = p + (r * 4 + 1) * n;
+        const double *p2 = p + (r * 4 + 2) * n;
+        const double *p3 = p + (r * 4 + 3) * n;
+        for (unsigned int c = 0; c < 4; ++c)
+        {
+          const double *l0 = local + (0 * 4 + c) * n;
+          const double *l1 = local + (1 * 4 + c) * n;
+          const double *l2 = local + (2 * 4 + c) * n;
+          double *o = out + (r * 4 + c) * n;
+          if (c < 3)
+          {
+            for (size_t a = 0; a < n; ++a)
+              o[a] = p0[a] * l0[a] + p1[a] * l1[a] + p2[a] * l2[a];
+          }
+          else
+          {
+            for (size_t a = 0; a < n; ++a)
+              o[a] = p0[a] * l0[a] + p1[a] * l1[a] + p2[a] * l2[a] + p3[a];
+          }
+        }
+      }
+    }
+
+    // Apply the results to each actor
+    double tmp[kSize];
+    for (size_t a = 0; a < n; ++a)
+    {
+      ActorCrowdSlot &slot = this->dataPtr->slots[group.slots[a]];
+      slot.pending = false;
+      Actor *actor = slot.actor;
+
+      // Resolve bone links once per clip
+      if (slot.linksClip != clip)
+      {
+        slot.links.assign(boneCount, nullptr);
+        for (unsigned int b = 0; b < boneCount; ++b)
+        {
+          LinkPtr link = actor->GetChildLink(clip->BoneNames()[b]);
+          slot.links[b] = link.get();
+        }
+        slot.linksClip = clip;
+      }
+
+      msgs::PoseAnimation *msg = nullptr;
+      if (publish)
+      {
+        msg = this->dataPtr->msg.add_pose_animation();
+        msg->set_model_name(actor->visualName);
+        msg->set_model_id(actor->visualId);
+      }
+
+      ignition::math::Pose3d mainLinkPose;
+      if (slot.custom)
+        mainLinkPose = actor->WorldPose();
+      else
+        mainLinkPose = FromAffine(slot.root).Pose();
+
+      const double *frame = clip->Frame(slot.frame);
+      for (unsigned int b = 0; b < boneCount; ++b)
+      {
+        for (unsigned int k = 0; k < kSize; ++k)
+          tmp[k] = world[(b * kSize + k) * n + a];
+        ignition::math::Pose3d pose = FromAffine(tmp).Pose();
+        if (!pose.IsFinite())
+        {
+          gzerr << "ACTOR: " << slot.time << " " << clip->BoneNames()[b]
+                << " " << pose << "\n";
+          pose.Correct();
+        }
+
+        if (msg)
+        {
+          msgs::Pose *bonePose = msg->add_pose();
+          bonePose->set_name(clip->BoneNames()[b]);
+          if (b == 0)
+          {
+            msgs::Set(bonePose, ignition::math::Pose3d::Zero);
+          }
+          else
+          {
+            msgs::Set(bonePose,
+                FromAffine(frame + b * kSize).Pose());
+          }
+        }
+
+        Link *link = slot.links[b];
+        if (!link)
+          continue;
+
+        if (msg)
+        {
+          msgs::Pose *linkPose = msg->add_pose();
+          linkPose->set_name(link->GetScopedName());
+          linkPose->set_id(link->GetId());
+          msgs::Set(linkPose, pose - mainLinkPose);
+        }
+        link->SetWorldPose(pose, true, false);
+      }
+
+      if (msg)
+      {
+        msgs::Set(msg->add_time(), common::Time(slot.time));
+        msgs::Pose *modelPose = msg->add_pose();
+        modelPose->set_name(actor->GetScopedName());
+        modelPose->set_id(actor->GetId());
+        msgs::Set(modelPose, mainLinkPose);
+      }
+
+      if (!slot.custom)
+        actor->SetWorldPose(mainLinkPose, true, false);
+    }
+  }
+
+  if (publish && this->dataPtr->msg.pose_animation_size() > 0)
+    this->dataPtr->posePub->Publish(this->dataPtr->msg);
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ACTORCROWD_HH_
+#define GAZEBO_PHYSICS_ACTORCROWD_HH_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Matrix4.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace common
+  {
+    class Skeleton;
+    class SkeletonAnimation;
+  }
+
+  namespace physics
+  {
+    // Forward declare private data classes.
+    class ActorClipPrivate;
+    class ActorCrowdPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ActorClip ActorCrowd.hh physics/physics.hh
+    /// \brief A skeleton animation pre-sampled at a fixed rate into a
+    /// compact table of bone transforms. A clip is immutable once built and
+    /// is shared by every crowd actor which plays the same animation on the
+    /// same skin.
+    ///
+    /// Bones are stored in an order where parents always come before their
+    /// children, and each transform is stored as the top 3x4 rows of an
+    /// affine matrix.
+    class GZ_PHYSICS_VISIBLE ActorClip
+    {
+      /// \brief Number of doubles used to store one bone transform.
+      public: static const unsigned int kTransformSize = 12;
+
+      /// \brief Constructor. Samples the animation.
+      /// \param[in] _skel Skeleton of the actor's skin.
+      /// \param[in] _anim Animation to sample.
+      /// \param[in] _skelMap Map from skin node names to animation node
+      /// names.
+      /// \param[in] _rate Sampling rate in Hz.
+      /// \param[in] _translationAligner Translations used to align a BVH
+      /// animation to the skin, indexed by animation node name. Leave empty
+      /// for COLLADA animations.
+      /// \param[in] _rotationAligner Rotations used to align a BVH
+      /// animation to the skin, indexed by animation node name. Leave empty
+      /// for COLLADA animations.
+      public: ActorClip(common::Skeleton *_skel,
+                  common::SkeletonAnimation *_anim,
+                  const std::map<std::string, std::string> &_skelMap,
+                  const double _rate,
+                  const std::map<std::string, ignition::math::Matrix4d>
+                    &_translationAligner =
+                    std::map<std::string, ignition::math::Matrix4d>(),
+                  const std::map<std::string, ignition::math::Matrix4d>
+                    &_rotationAligner =
+                    std::map<std::string, ignition::math::Matrix4d>());
+
+      /// \brief Destructor.
+      public: ~ActorClip();
+
+      /// \brief Get the number of sampled frames.
+      /// \return Number of frames.
+      public: unsigned int FrameCount() const;
+
+      /// \brief Get the number of bones in each frame.
+      /// \return Number of bones.
+      public: unsigned int BoneCount() const;
+
+      /// \brief Get the length of the animation in seconds.
+      /// \return Animation length.
+      public: double Length() const;
+
+      /// \brief Get the rate at which the animation was sampled.
+      /// \return Sampling rate in Hz.
+      public: double Rate() const;
+
+      /// \brief Get the index of the frame closest to a given time. Times
+      /// past the end of the animation wrap around.
+      /// \param[in] _time Time in seconds from the start of the animation.
+      /// \return Frame index.
+      public: unsigned int FrameIndex(const double _time) const;
+
+      /// \brief Get the animation time at which the root bone reaches a
+      /// given X coordinate. Equivalent to the time computed by
+      /// common::SkeletonAnimation::PoseAtX.
+      /// \param[in] _x X coordinate of the root bone.
+      /// \return Time in seconds.
+      public: double TimeAtX(const double _x) const;
+
+      /// \brief Get the bone transforms of a frame. BVH alignment is already
+      /// applied to all bones except the root, whose transform is stored as
+      /// it comes from the animation.
+      /// \param[in] _frame Frame index.
+      /// \return Pointer to BoneCount() * kTransformSize doubles.
+      public: const double *Frame(const unsigned int _frame) const;
+
+      /// \brief Apply BVH alignment to a root bone transform. This is the
+      /// identity for COLLADA animations.
+      /// \param[in] _root Root transform.
+      /// \return Aligned root transform.
+      public: ignition::math::Matrix4d AlignRoot(
+                  const ignition::math::Matrix4d &_root) const;
+
+      /// \brief Get the index of each bone's parent within the clip.
+      /// The root bone has parent -1.
+      /// \return Parent indices, in clip bone order.
+      public: const std::vector<int> &Parents() const;
+
+      /// \brief Get the skeleton node handle of each bone.
+      /// \return Skeleton handles, in clip bone order.
+      public: const std::vector<unsigned int> &Handles() const;
+
+      /// \brief Get the skin node name of each bone.
+      /// \return Bone names, in clip bone order.
+      public: const std::vector<std::string> &BoneNames() const;
+
+      /// \brief Whether a bone is driven by the animation. Bones which are
+      /// not animated keep the skin's rest transform.
+      /// \param[in] _bone Bone index within the clip.
+      /// \return True if the bone is animated.
+      public: bool Animated(const unsigned int _bone) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ActorClipPrivate> dataPtr;
+    };
+
+    /// \class ActorCrowd ActorCrowd.hh physics/physics.hh
+    /// \brief Batched animation of actors in crowd mode.
+    ///
+    /// Actors which have crowd mode enabled don't animate their own skeleton.
+    /// Instead, during Actor::Update they submit the clip frame and root
+    /// transform for this step, and the crowd evaluates the bone transforms
+    /// of all submitted actors together, grouped by clip. All skeleton poses
+    /// are then published as a single msgs::PoseAnimation_V on
+    /// "~/skeleton_pose/info_v".
+    class GZ_PHYSICS_VISIBLE ActorCrowd
+    {
+      /// \brief Constructor.
+      /// \param[in] _world Reference to the world.
+      public: explicit ActorCrowd(World &_world);
+
+      /// \brief Destructor.
+      public: virtual ~ActorCrowd();
+
+      /// \brief Get a shared clip, building it if it doesn't exist yet.
+      /// \param[in] _key Unique key identifying the skin and animation.
+      /// \param[in] _build Function which builds the clip, only called if
+      /// the key hasn't been seen before.
+      /// \return The shared clip.
+      public: std::shared_ptr<const ActorClip> Clip(const std::string &_key,
+                  const std::function<std::shared_ptr<const ActorClip>()>
+                  &_build);
+
+      /// \brief Get the number of distinct clips held by the crowd.
+      /// \return Number of clips.
+      public: unsigned int ClipCount() const;
+
+      /// \brief Add an actor to the crowd.
+      /// \param[in] _actor Actor to add.
+      /// \return Slot which the actor must use to submit frames.
+      public: unsigned int AddActor(Actor *_actor);
+
+      /// \brief Remove an actor from the crowd.
+      /// \param[in] _slot Slot returned by AddActor.
+      public: void RemoveActor(const unsigned int _slot);
+
+      /// \brief Get the number of actors in the crowd.
+      /// \return Number of actors.
+      public: unsigned int ActorCount() const;
+
+      /// \brief Submit a new frame for an actor. Different actors may submit
+      /// concurrently, as each one writes to its own slot.
+      /// \param[in] _slot The actor's slot.
+      /// \param[in] _clip Clip being played.
+      /// \param[in] _frame Frame index within the clip.
+      /// \param[in] _root World transform of the root bone.
+      /// \param[in] _custom True if the actor follows a custom trajectory,
+      /// in which case the actor's pose isn't changed.
+      /// \param[in] _time Simulation time of the frame.
+      public: void Submit(const unsigned int _slot,
+                  const std::shared_ptr<const ActorClip> &_clip,
+                  const unsigned int _frame,
+                  const ignition::math::Matrix4d &_root,
+                  const bool _custom, const double _time);
+
+      /// \brief Evaluate all frames submitted since the last update, apply
+      /// the bone poses to the actors' links and publish them.
+      public: void Update();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ActorCrowdPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <map>
+#include <string>
+
+#include "gazebo/common/Skeleton.hh"
+#include "gazebo/common/SkeletonAnimation.hh"
+#include "gazebo/physics/ActorCrowd.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ActorClipTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ActorClipTest, SampleAnimation)
+{
+  // Skeleton chain with a root, a hip and a knee
+  auto root = new common::SkeletonNode(nullptr, "root", "root");
+  auto hip = new common::SkeletonNode(root, "hip", "hip");
+  auto knee = new common::SkeletonNode(hip, "knee", "knee");
+  root->SetTransform(ignition::math::Matrix4d::Identity, false);
+  hip->SetTransform(ignition::math::Matrix4d::Identity, false);
+
+  ignition::math::Matrix4d kneeRest(ignition::math::Matrix4d::Identity);
+  kneeRest.SetTranslation(ignition::math::Vector3d(0, 0, -0.5));
+  knee->SetTransform(kneeRest, false);
+
+  common::Skeleton skel(root);
+
+  // Root walks along X, hip rotates, knee isn't animated
+  common::SkeletonAnimation anim("walk");
+  anim.AddKeyFrame("anim_root", 0.0,
+      ignition::math::Pose3d(0, 0, 0, 0, 0, 0));
+  anim.AddKeyFrame("anim_root", 1.0,
+      ignition::math::Pose3d(2, 0, 0, 0, 0, 0));
+  anim.AddKeyFrame("anim_hip", 0.0,
+      ignition::math::Pose3d(0, 0, 1, 0, 0, 0));
+  anim.AddKeyFrame("anim_hip", 1.0,
+      ignition::math::Pose3d(0, 0, 1, 0, 0, 1.0));
+
+  std::map<std::string, std::string> skelMap;
+  skelMap["root"] = "anim_root";
+  skelMap["hip"] = "anim_hip";
+  skelMap["knee"] = "anim_knee";
+
+  physics::ActorClip clip(&skel, &anim, skelMap, 10.0);
+
+  EXPECT_EQ(3u, clip.BoneCount());
+  EXPECT_EQ(11u, clip.FrameCount());
+  EXPECT_DOUBLE_EQ(1.0, clip.Length());
+  EXPECT_DOUBLE_EQ(10.0, clip.Rate());
+
+  // Parents come before children
+  ASSERT_EQ(3u, clip.Parents().size());
+  EXPECT_EQ(-1, clip.Parents()[0]);
+  for (unsigned int b = 1; b < clip.BoneCount(); ++b)
+    EXPECT_LT(clip.Parents()[b], static_cast<int>(b));
+  EXPECT_EQ("root", clip.BoneNames()[0]);
+  EXPECT_EQ("hip", clip.BoneNames()[1]);
+  EXPECT_EQ("knee", clip.BoneNames()[2]);
+
+  EXPECT_TRUE(clip.Animated(0));
+  EXPECT_TRUE(clip.Animated(1));
+  EXPECT_FALSE(clip.Animated(2));
+  EXPECT_FALSE(clip.Animated(3));
+
+  // Frame lookup rounds to the closest sample and wraps around
+  EXPECT_EQ(0u, clip.FrameIndex(0.0));
+  EXPECT_EQ(5u, clip.FrameIndex(0.52));
+  EXPECT_EQ(10u, clip.FrameIndex(1.0));
+  EXPECT_EQ(3u, clip.FrameIndex(1.3));
+  EXPECT_EQ(0u, clip.FrameIndex(-1.0));
+
+  // Sampled transforms match the animation
+  for (unsigned int f = 0; f < clip.FrameCount(); ++f)
+  {
+    const double *frame = clip.Frame(f);
+    double time = f / clip.Rate();
+    auto pose = anim.PoseAt(time);
+    for (unsigned int r = 0; r < 3; ++r)
+    {
+      for (unsigned int c = 0; c < 4; ++c)
+      {
+        EXPECT_NEAR(pose["anim_root"](r, c), frame[r * 4 + c], 1e-9);
+        EXPECT_NEAR(pose["anim_hip"](r, c),
+            frame[physics::ActorClip::kTransformSize + r * 4 + c], 1e-9);
+        EXPECT_NEAR(kneeRest(r, c),
+            frame[2 * physics::ActorClip::kTransformSize + r * 4 + c], 1e-9);
+      }
+    }
+  }
+
+  // Time lookup by root X
+  EXPECT_NEAR(0.0, clip.TimeAtX(-1.0), 1e-9);
+  EXPECT_NEAR(0.25, clip.TimeAtX(0.5), 1e-9);
+  EXPECT_NEAR(0.5, clip.TimeAtX(1.0), 1e-9);
+  EXPECT_NEAR(0.25, clip.TimeAtX(2.5), 1e-9);
+
+  // COLLADA clips don't align the root
+  ignition::math::Matrix4d m(ignition::math::Quaterniond(0.1, 0.2, 0.3));
+  m.SetTranslation(ignition::math::Vector3d(1, 2, 3));
+  EXPECT_EQ(m, clip.AlignRoot(m));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
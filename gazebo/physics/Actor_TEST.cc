@@ -133,6 +133,42 @@ TEST_F(ActorTest, ActorCollision)
   EXPECT_LT((poseTarget - actor->WorldPose().Pos()).Length(), 0.1);
 }
 
+//////////////////////////////////////////////////
+TEST_F(ActorTest, CrowdMode)
+{
+  // Load a world with an actor
+  this->Load("worlds/actor.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto actor = boost::dynamic_pointer_cast<physics::Actor>(
+      world->ModelByName("actor"));
+  ASSERT_TRUE(actor != nullptr);
+
+  // Enable crowd mode
+  EXPECT_FALSE(actor->CrowdMode());
+  actor->SetCrowdMode(true);
+  EXPECT_TRUE(actor->CrowdMode());
+  EXPECT_EQ(1u, world->ActorCrowd().ActorCount());
+  EXPECT_EQ(1u, world->ActorCrowd().ClipCount());
+
+  // The crowd still moves the actor along its trajectory
+  world->Step(4000);
+
+  ignition::math::Vector3d target(1.0, 0.0, 1.0);
+  EXPECT_LT((target - actor->WorldPose().Pos()).Length(), 0.1);
+
+  // Disable crowd mode
+  actor->SetCrowdMode(false);
+  EXPECT_FALSE(actor->CrowdMode());
+  EXPECT_EQ(0u, world->ActorCrowd().ActorCount());
+
+  world->Step(4000);
+
+  target.Set(0.3, -1.0, 1.0);
+  EXPECT_LT((target - actor->WorldPose().Pos()).Length(), 0.1);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
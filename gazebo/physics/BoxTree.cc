@@ -0,0 +1,543 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/BoxTreePrivate.hh"
+#include "gazebo/physics/BoxTree.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+/// \brief Get the surface area of a box.
+/// \param[in] _min Minimum corner.
+/// \param[in] _max Maximum corner.
+/// \return Surface area.
+static double Area(const ignition::math::Vector3d &_min,
+    const ignition::math::Vector3d &_max)
+{
+  const ignition::math::Vector3d d = _max - _min;
+  return 2.0 * (d.X() * d.Y() + d.Y() * d.Z() + d.Z() * d.X());
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the surface area of the union of two boxes.
+/// \param[in] _a First node.
+/// \param[in] _b Second node.
+/// \return Surface area.
+static double MergedArea(const BoxTreeNode &_a, const BoxTreeNode &_b)
+{
+  ignition::math::Vector3d min = _a.min;
+  ignition::math::Vector3d max = _a.max;
+  min.Min(_b.min);
+  max.Max(_b.max);
+  return Area(min, max);
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a box contains another one.
+/// \param[in] _node Node with the outer box.
+/// \param[in] _box Inner box.
+/// \return True if _box is inside the node box.
+static bool Contains(const BoxTreeNode &_node,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  return _node.min.X() <= _box.Min().X() && _node.min.Y() <= _box.Min().Y() &&
+         _node.min.Z() <= _box.Min().Z() && _node.max.X() >= _box.Max().X() &&
+         _node.max.Y() >= _box.Max().Y() && _node.max.Z() >= _box.Max().Z();
+}
+
+/////////////////////////////////////////////////
+int BoxTreePrivate::Allocate()
+{
+  if (this->freeList == kNullNode)
+  {
+    // Grow the pool and chain the new nodes into the free list
+    const int oldSize = static_cast<int>(this->nodes.size());
+    const int newSize = std::max(16, oldSize * 2);
+    this->nodes.resize(newSize);
+    for (int i = oldSize; i < newSize - 1; ++i)
+      this->nodes[i].parent = i + 1;
+    this->nodes[newSize - 1].parent = kNullNode;
+    this->freeList = oldSize;
+  }
+
+  const int index = this->freeList;
+  BoxTreeNode &node = this->nodes[index];
+  this->freeList = node.parent;
+  node.parent = kNullNode;
+  node.child1 = kNullNode;
+  node.child2 = kNullNode;
+  node.height = 0;
+  node.userData = nullptr;
+  return index;
+}
+
+/////////////////////////////////////////////////
+void BoxTreePrivate::Free(const int _node)
+{
+  BoxTreeNode &node = this->nodes[_node];
+  node.parent = this->freeList;
+  node.height = -1;
+  node.userData = nullptr;
+  this->freeList = _node;
+}
+
+/////////////////////////////////////////////////
+void BoxTreePrivate::Merge(const int _node, const int _a, const int _b)
+{
+  BoxTreeNode &node = this->nodes[_node];
+  node.min = this->nodes[_a].min;
+  node.max = this->nodes[_a].max;
+  node.min.Min(this->nodes[_b].min);
+  node.max.Max(this->nodes[_b].max);
+}
+
+/////////////////////////////////////////////////
+void BoxTreePrivate::InsertLeaf(const int _leaf)
+{
+  if (this->root == kNullNode)
+  {
+    this->root = _leaf;
+    this->nodes[_leaf].parent = kNullNode;
+    return;
+  }
+
+  // Descend to the sibling with the lowest surface area cost
+  int index = this->root;
+  while (!this->nodes[index].IsLeaf())
+  {
+    const BoxTreeNode &node = this->nodes[index];
+    const BoxTreeNode &leaf = this->nodes[_leaf];
+
+    const double area = Area(node.min, node.max);
+    const double combinedArea = MergedArea(node, leaf);
+
+    // Cost of making a new parent for this node and the leaf
+    const double cost = 2.0 * combinedArea;
+
+    // Minimum cost of pushing the leaf further down the tree
+    const double inheritanceCost = 2.0 * (combinedArea - area);
+
+    double childCost[2];
+    const int children[2] = {node.child1, node.child2};
+    for (int i = 0; i < 2; ++i)
+    {
+      const BoxTreeNode &child = this->nodes[children[i]];
+      childCost[i] = MergedArea(child, leaf) + inheritanceCost;
+      if (!child.IsLeaf())
+        childCost[i] -= Area(child.min, child.max);
+    }
+
+    if (cost < childCost[0] && cost < childCost[1])
+      break;
+
+    index = childCost[0] < childCost[1] ? children[0] : children[1];
+  }
+
+  // Create a new parent for the sibling and the leaf
+  const int sibling = index;
+  const int newParent = this->Allocate();
+  const int oldParent = this->nodes[sibling].parent;
+
+  this->nodes[newParent].parent = oldParent;
+  this->nodes[newParent].height = this->nodes[sibling].height + 1;
+  this->nodes[newParent].child1 = sibling;
+  this->nodes[newParent].child2 = _leaf;
+  this->Merge(newParent, sibling, _leaf);
+  this->nodes[sibling].parent = newParent;
+  this->nodes[_leaf].parent = newParent;
+
+  if (oldParent != kNullNode)
+  {
+    if (this->nodes[oldParent].child1 == sibling)
+      this->nodes[oldParent].child1 = newParent;
+    else
+      this->nodes[oldParent].child2 = newParent;
+  }
+  else
+  {
+    this->root = newParent;
+  }
+
+  this->Refit(oldParent);
+}
+
+/////////////////////////////////////////////////
+void BoxTreePrivate::RemoveLeaf(const int _leaf)
+{
+  if (_leaf == this->root)
+  {
+    this->root = kNullNode;
+    return;
+  }
+
+  const int parent = this->nodes[_leaf].parent;
+  const int grandParent = this->nodes[parent].parent;
+  const int sibling = this->nodes[parent].child1 == _leaf ?
+      this->nodes[parent].child2 : this->nodes[parent].child1;
+
+  // Replace the parent by the sibling
+  this->nodes[sibling].parent = grandParent;
+  if (grandParent != kNullNode)
+  {
+    if (this->nodes[grandParent].child1 == parent)
+      this->nodes[grandParent].child1 = sibling;
+    else
+      this->nodes[grandParent].child2 = sibling;
+  }
+  else
+  {
+    this->root = sibling;
+  }
+
+  this->Free(parent);
+  this->nodes[_leaf].parent = kNullNode;
+  this->Refit(grandParent);
+}
+
+/////////////////////////////////////////////////
+void BoxTreePrivate::Refit(int _node)
+{
+  while (_node != kNullNode)
+  {
+    _node = this->Balance(_node);
+
+    BoxTreeNode &node = this->nodes[_node];
+    node.height = 1 + std::max(this->nodes[node.child1].height,
+        this->nodes[node.child2].height);
+    this->Merge(_node, node.child1, node.child2);
+
+    _node = node.parent;
+  }
+}
+
+/////////////////////////////////////////////////
+int BoxTreePrivate::Balance(const int _node)
+{
+  const int iA = _node;
+  if (this->nodes[iA].IsLeaf() || this->nodes[iA].height < 2)
+    return iA;
+
+  const int iB = this->nodes[iA].child1;
+  const int iC = this->nodes[iA].child2;
+  const int balance = this->nodes[iC].height - this->nodes[iB].height;
+
+  // Rotate the higher child up. The higher grandchild stays below it, and
+  // the other one moves below A.
+  if (balance > 1 || balance < -1)
+  {
+    const int iUp = balance > 1 ? iC : iB;
+    const int iOther = balance > 1 ? iB : iC;
+    const int iF = this->nodes[iUp].child1;
+    const int iG = this->nodes[iUp].child2;
+
+    BoxTreeNode &a = this->nodes[iA];
+    BoxTreeNode &up = this->nodes[iUp];
+
+    // Swap A and the rotated child
+    up.child1 = iA;
+    up.parent = a.parent;
+    a.parent = iUp;
+
+    if (up.parent != kNullNode)
+    {
+      if (this->nodes[up.parent].child1 == iA)
+        this->nodes[up.parent].child1 = iUp;
+      else
+        this->nodes[up.parent].child2 = iUp;
+    }
+    else
+    {
+      this->root = iUp;
+    }
+
+    const int iKeep = this->nodes[iF].height > this->nodes[iG].height ?
+        iF : iG;
+    const int iMove = iKeep == iF ? iG : iF;
+
+    up.child2 = iKeep;
+    if (balance > 1)
+      a.child2 = iMove;
+    else
+      a.child1 = iMove;
+    this->nodes[iMove].parent = iA;
+
+    this->Merge(iA, iOther, iMove);
+    this->Merge(iUp, iA, iKeep);
+    a.height = 1 + std::max(this->nodes[iOther].height,
+        this->nodes[iMove].height);
+    up.height = 1 + std::max(a.height, this->nodes[iKeep].height);
+
+    return iUp;
+  }
+
+  return iA;
+}
+
+/////////////////////////////////////////////////
+bool BoxTreePrivate::Validate(const int _node) const
+{
+  const BoxTreeNode &node = this->nodes[_node];
+  if (node.IsLeaf())
+    return node.height == 0 && node.child2 == kNullNode;
+
+  const BoxTreeNode &child1 = this->nodes[node.child1];
+  const BoxTreeNode &child2 = this->nodes[node.child2];
+  if (child1.parent != _node || child2.parent != _node)
+    return false;
+
+  if (node.height != 1 + std::max(child1.height, child2.height))
+    return false;
+
+  ignition::math::Vector3d min = child1.min;
+  ignition::math::Vector3d max = child1.max;
+  min.Min(child2.min);
+  max.Max(child2.max);
+  if (min != node.min || max != node.max)
+    return false;
+
+  return this->Validate(node.child1) && this->Validate(node.child2);
+}
+
+/////////////////////////////////////////////////
+BoxTree::BoxTree(const double _margin)
+  : dataPtr(new BoxTreePrivate)
+{
+  this->dataPtr->margin = _margin;
+}
+
+/////////////////////////////////////////////////
+BoxTree::~BoxTree()
+{
+}
+
+/////////////////////////////////////////////////
+int BoxTree::Insert(const ignition::math::AxisAlignedBox &_box,
+    void *_userData)
+{
+  const int proxy = this->dataPtr->Allocate();
+  const ignition::math::Vector3d margin(this->dataPtr->margin,
+      this->dataPtr->margin, this->dataPtr->margin);
+
+  BoxTreeNode &node = this->dataPtr->nodes[proxy];
+  node.min = _box.Min() - margin;
+  node.max = _box.Max() + margin;
+  node.userData = _userData;
+
+  this->dataPtr->InsertLeaf(proxy);
+  ++this->dataPtr->leafCount;
+  return proxy;
+}
+
+/////////////////////////////////////////////////
+void BoxTree::Remove(const int _proxy)
+{
+  GZ_ASSERT(_proxy >= 0 &&
+      _proxy < static_cast<int>(this->dataPtr->nodes.size()) &&
+      this->dataPtr->nodes[_proxy].IsLeaf() &&
+      this->dataPtr->nodes[_proxy].height == 0, "Invalid proxy");
+
+  this->dataPtr->RemoveLeaf(_proxy);
+  this->dataPtr->Free(_proxy);
+  --this->dataPtr->leafCount;
+}
+
+/////////////////////////////////////////////////
+bool BoxTree::Move(const int _proxy,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  GZ_ASSERT(_proxy >= 0 &&
+      _proxy < static_cast<int>(this->dataPtr->nodes.size()) &&
+      this->dataPtr->nodes[_proxy].IsLeaf() &&
+      this->dataPtr->nodes[_proxy].height == 0, "Invalid proxy");
+
+  if (Contains(this->dataPtr->nodes[_proxy], _box))
+    return false;
+
+  const ignition::math::Vector3d margin(this->dataPtr->margin,
+      this->dataPtr->margin, this->dataPtr->margin);
+
+  this->dataPtr->RemoveLeaf(_proxy);
+  BoxTreeNode &node = this->dataPtr->nodes[_proxy];
+  node.min = _box.Min() - margin;
+  node.max = _box.Max() + margin;
+  this->dataPtr->InsertLeaf(_proxy);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void BoxTree::Clear()
+{
+  this->dataPtr->nodes.clear();
+  this->dataPtr->root = kNullNode;
+  this->dataPtr->freeList = kNullNode;
+  this->dataPtr->leafCount = 0;
+}
+
+/////////////////////////////////////////////////
+void *BoxTree::UserData(const int _proxy) const
+{
+  return this->dataPtr->nodes[_proxy].userData;
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox BoxTree::FatBox(const int _proxy) const
+{
+  const BoxTreeNode &node = this->dataPtr->nodes[_proxy];
+  return ignition::math::AxisAlignedBox(node.min, node.max);
+}
+
+/////////////////////////////////////////////////
+size_t BoxTree::Size() const
+{
+  return this->dataPtr->leafCount;
+}
+
+/////////////////////////////////////////////////
+int BoxTree::Height() const
+{
+  if (this->dataPtr->root == kNullNode)
+    return 0;
+  return this->dataPtr->nodes[this->dataPtr->root].height;
+}
+
+/////////////////////////////////////////////////
+bool BoxTree::Validate() const
+{
+  if (this->dataPtr->root == kNullNode)
+    return this->dataPtr->leafCount == 0;
+
+  if (this->dataPtr->nodes[this->dataPtr->root].parent != kNullNode)
+    return false;
+
+  return this->dataPtr->Validate(this->dataPtr->root);
+}
+
+/////////////////////////////////////////////////
+void BoxTree::QueryBox(const ignition::math::AxisAlignedBox &_box,
+    const QueryCallback &_callback) const
+{
+  const ignition::math::Vector3d &qMin = _box.Min();
+  const ignition::math::Vector3d &qMax = _box.Max();
+  this->dataPtr->Query(
+      [&](const ignition::math::Vector3d &_min,
+          const ignition::math::Vector3d &_max)
+      {
+        return _min.X() <= qMax.X() && _max.X() >= qMin.X() &&
+               _min.Y() <= qMax.Y() && _max.Y() >= qMin.Y() &&
+               _min.Z() <= qMax.Z() && _max.Z() >= qMin.Z();
+      }, _callback);
+}
+
+/////////////////////////////////////////////////
+void BoxTree::QuerySphere(const ignition::math::Vector3d &_center,
+    const double _radius, const QueryCallback &_callback) const
+{
+  this->dataPtr->Query(
+      [&](const ignition::math::Vector3d &_min,
+          const ignition::math::Vector3d &_max)
+      {
+        return SphereOverlaps(ignition::math::AxisAlignedBox(_min, _max),
+            _center, _radius);
+      }, _callback);
+}
+
+/////////////////////////////////////////////////
+void BoxTree::QueryRay(const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _maxDist,
+    const QueryCallback &_callback) const
+{
+  this->dataPtr->Query(
+      [&](const ignition::math::Vector3d &_min,
+          const ignition::math::Vector3d &_max)
+      {
+        double dist;
+        return RayDistance(ignition::math::AxisAlignedBox(_min, _max),
+            _origin, _dir, _maxDist, dist);
+      }, _callback);
+}
+
+/////////////////////////////////////////////////
+void BoxTree::QueryFrustum(const ignition::math::Frustum &_frustum,
+    const QueryCallback &_callback) const
+{
+  this->dataPtr->Query(
+      [&](const ignition::math::Vector3d &_min,
+          const ignition::math::Vector3d &_max)
+      {
+        return _frustum.Contains(ignition::math::AxisAlignedBox(_min, _max));
+      }, _callback);
+}
+
+/////////////////////////////////////////////////
+bool BoxTree::RayDistance(const ignition::math::AxisAlignedBox &_box,
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _maxDist,
+    double &_dist)
+{
+  // Clip the ray against the three slabs of the box
+  double tMin = 0.0;
+  double tMax = _maxDist;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double low = _box.Min()[i];
+    const double high = _box.Max()[i];
+    if (std::abs(_dir[i]) < 1e-12)
+    {
+      if (_origin[i] < low || _origin[i] > high)
+        return false;
+      continue;
+    }
+
+    const double inv = 1.0 / _dir[i];
+    double t1 = (low - _origin[i]) * inv;
+    double t2 = (high - _origin[i]) * inv;
+    if (t1 > t2)
+      std::swap(t1, t2);
+
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      return false;
+  }
+
+  _dist = tMin;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool BoxTree::SphereOverlaps(const ignition::math::AxisAlignedBox &_box,
+    const ignition::math::Vector3d &_center, const double _radius)
+{
+  // Squared distance from the center to the closest point of the box
+  double dist2 = 0.0;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double d = 0.0;
+    if (_center[i] < _box.Min()[i])
+      d = _box.Min()[i] - _center[i];
+    else if (_center[i] > _box.Max()[i])
+      d = _center[i] - _box.Max()[i];
+    dist2 += d * d;
+  }
+  return dist2 <= _radius * _radius;
+}
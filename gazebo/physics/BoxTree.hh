@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BOXTREE_HH_
+#define GAZEBO_PHYSICS_BOXTREE_HH_
+
+#include <functional>
+#include <memory>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class BoxTreePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class BoxTree BoxTree.hh physics/physics.hh
+    /// \brief A dynamic bounding volume hierarchy of axis aligned boxes.
+    ///
+    /// Each box is stored in a leaf, enlarged by a margin, so that small
+    /// motions don't change the tree. Leaves are inserted next to the
+    /// sibling which minimizes the surface area of the tree, and branches
+    /// are rotated to keep the tree balanced. Leaves are identified by a
+    /// proxy, which stays valid until the leaf is removed.
+    class GZ_PHYSICS_VISIBLE BoxTree
+    {
+      /// \brief Callback of a query.
+      /// The argument is the proxy of a leaf which overlaps the query. The
+      /// callback returns false to stop the query.
+      public: using QueryCallback = std::function<bool(const int)>;
+
+      /// \brief Constructor.
+      /// \param[in] _margin Distance by which leaf boxes are enlarged.
+      public: explicit BoxTree(const double _margin = 0.1);
+
+      /// \brief Destructor.
+      public: ~BoxTree();
+
+      /// \brief Insert a box.
+      /// \param[in] _box Box to insert, which must be valid and finite.
+      /// \param[in] _userData Data attached to the leaf.
+      /// \return Proxy of the new leaf.
+      public: int Insert(const ignition::math::AxisAlignedBox &_box,
+                  void *_userData);
+
+      /// \brief Remove a leaf.
+      /// \param[in] _proxy Proxy returned by Insert.
+      public: void Remove(const int _proxy);
+
+      /// \brief Update the box of a leaf. The tree only changes if the new
+      /// box isn't contained in the enlarged box of the leaf.
+      /// \param[in] _proxy Proxy returned by Insert.
+      /// \param[in] _box New box.
+      /// \return True if the leaf was reinserted.
+      public: bool Move(const int _proxy,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Remove all leaves.
+      public: void Clear();
+
+      /// \brief Get the data attached to a leaf.
+      /// \param[in] _proxy Proxy returned by Insert.
+      /// \return Data passed to Insert.
+      public: void *UserData(const int _proxy) const;
+
+      /// \brief Get the enlarged box of a leaf.
+      /// \param[in] _proxy Proxy returned by Insert.
+      /// \return Box stored in the tree.
+      public: ignition::math::AxisAlignedBox FatBox(const int _proxy) const;
+
+      /// \brief Get the number of leaves.
+      /// \return Number of leaves.
+      public: size_t Size() const;
+
+      /// \brief Get the height of the tree.
+      /// \return Height of the root, 0 for an empty tree or a single leaf.
+      public: int Height() const;
+
+      /// \brief Check the structure of the tree. Used by tests.
+      /// \return True if parents, heights, boxes and balance are consistent.
+      public: bool Validate() const;
+
+      /// \brief Find the leaves which overlap a box.
+      /// \param[in] _box Query box.
+      /// \param[in] _callback Called for each leaf found.
+      public: void QueryBox(const ignition::math::AxisAlignedBox &_box,
+                  const QueryCallback &_callback) const;
+
+      /// \brief Find the leaves which overlap a sphere.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[in] _callback Called for each leaf found.
+      public: void QuerySphere(const ignition::math::Vector3d &_center,
+                  const double _radius, const QueryCallback &_callback) const;
+
+      /// \brief Find the leaves hit by a ray.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Unit direction of the ray.
+      /// \param[in] _maxDist Length of the ray.
+      /// \param[in] _callback Called for each leaf found.
+      public: void QueryRay(const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, const double _maxDist,
+                  const QueryCallback &_callback) const;
+
+      /// \brief Find the leaves which aren't entirely outside a frustum,
+      /// using the same test as ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Query frustum.
+      /// \param[in] _callback Called for each leaf found.
+      public: void QueryFrustum(const ignition::math::Frustum &_frustum,
+                  const QueryCallback &_callback) const;
+
+      /// \brief Distance along a ray to a box.
+      /// \param[in] _box Box to test.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Unit direction of the ray.
+      /// \param[in] _maxDist Length of the ray.
+      /// \param[out] _dist Distance at which the ray enters the box, 0 if
+      /// the origin is inside.
+      /// \return True if the ray hits the box.
+      public: static bool RayDistance(
+                  const ignition::math::AxisAlignedBox &_box,
+                  const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir, const double _maxDist,
+                  double &_dist);
+
+      /// \brief Check if a box overlaps a sphere.
+      /// \param[in] _box Box to test.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \return True if they overlap.
+      public: static bool SphereOverlaps(
+                  const ignition::math::AxisAlignedBox &_box,
+                  const ignition::math::Vector3d &_center,
+                  const double _radius);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<BoxTreePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_BOXTREEPRIVATE_HH_
+#define GAZEBO_PHYSICS_BOXTREEPRIVATE_HH_
+
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Index used for missing nodes.
+    static const int kNullNode = -1;
+
+    /// \brief A node of the tree. Nodes are either leaves, which hold user
+    /// data, or branches with exactly two children.
+    struct BoxTreeNode
+    {
+      /// \brief Minimum corner of the box.
+      ignition::math::Vector3d min;
+
+      /// \brief Maximum corner of the box.
+      ignition::math::Vector3d max;
+
+      /// \brief Data of a leaf.
+      void *userData = nullptr;
+
+      /// \brief Parent node, or next free node if the node isn't used.
+      int parent = kNullNode;
+
+      /// \brief First child.
+      int child1 = kNullNode;
+
+      /// \brief Second child.
+      int child2 = kNullNode;
+
+      /// \brief Height of the node, 0 for leaves and -1 for free nodes.
+      int height = -1;
+
+      /// \brief Check if the node is a leaf.
+      /// \return True if it has no children.
+      bool IsLeaf() const
+      {
+        return this->child1 == kNullNode;
+      }
+    };
+
+    /// \internal
+    /// \brief Private data for the BoxTree class.
+    class BoxTreePrivate
+    {
+      /// \brief Get a node from the free list, growing the pool if needed.
+      /// \return Index of the node.
+      public: int Allocate();
+
+      /// \brief Return a node to the free list.
+      /// \param[in] _node Index of the node.
+      public: void Free(const int _node);
+
+      /// \brief Insert a leaf next to the cheapest sibling.
+      /// \param[in] _leaf Index of the leaf.
+      public: void InsertLeaf(const int _leaf);
+
+      /// \brief Detach a leaf from the tree, without freeing it.
+      /// \param[in] _leaf Index of the leaf.
+      public: void RemoveLeaf(const int _leaf);
+
+      /// \brief Recompute the boxes and heights of the ancestors of a node,
+      /// rotating unbalanced branches on the way up.
+      /// \param[in] _node Index of the first ancestor.
+      public: void Refit(int _node);
+
+      /// \brief Rotate a branch if its children heights differ by more
+      /// than one.
+      /// \param[in] _node Index of the branch.
+      /// \return Index of the node which replaces the branch.
+      public: int Balance(const int _node);
+
+      /// \brief Set the box of a node to the union of two nodes.
+      /// \param[in] _node Index of the node to update.
+      /// \param[in] _a Index of the first node.
+      /// \param[in] _b Index of the second node.
+      public: void Merge(const int _node, const int _a, const int _b);
+
+      /// \brief Check a subtree. Used by BoxTree::Validate.
+      /// \param[in] _node Root of the subtree.
+      /// \return True if the subtree is consistent.
+      public: bool Validate(const int _node) const;
+
+      /// \brief Walk the tree, descending into nodes accepted by a test.
+      /// \param[in] _test Called with the box corners of each node.
+      /// \param[in] _callback Called for each accepted leaf.
+      public: template<typename T, typename C>
+              void Query(const T &_test, const C &_callback) const
+              {
+                if (this->root == kNullNode)
+                  return;
+
+                std::vector<int> stack;
+                stack.reserve(64);
+                stack.push_back(this->root);
+                while (!stack.empty())
+                {
+                  const int index = stack.back();
+                  stack.pop_back();
+
+                  const BoxTreeNode &node = this->nodes[index];
+                  if (!_test(node.min, node.max))
+                    continue;
+
+                  if (node.IsLeaf())
+                  {
+                    if (!_callback(index))
+                      return;
+                  }
+                  else
+                  {
+                    stack.push_back(node.child1);
+                    stack.push_back(node.child2);
+                  }
+                }
+              }
+
+      /// \brief Pool of nodes.
+      public: std::vector<BoxTreeNode> nodes;
+
+      /// \brief Index of the root node.
+      public: int root = kNullNode;
+
+      /// \brief Head of the list of free nodes.
+      public: int freeList = kNullNode;
+
+      /// \brief Number of leaves.
+      public: size_t leafCount = 0;
+
+      /// \brief Distance by which leaf boxes are enlarged.
+      public: double margin = 0.1;
+    };
+  }
+}
+#endif
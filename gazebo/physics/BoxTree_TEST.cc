@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <ignition/math/Angle.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/physics/BoxTree.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class BoxTreeTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Make a random box.
+/// \param[in] _gen Random generator.
+/// \return Box with a corner in [-50, 50] and sides in [0.1, 3].
+ignition::math::AxisAlignedBox RandomBox(std::mt19937 &_gen)
+{
+  std::uniform_real_distribution<double> pos(-50.0, 50.0);
+  std::uniform_real_distribution<double> size(0.1, 3.0);
+  ignition::math::Vector3d min(pos(_gen), pos(_gen), pos(_gen));
+  ignition::math::Vector3d max = min +
+      ignition::math::Vector3d(size(_gen), size(_gen), size(_gen));
+  return ignition::math::AxisAlignedBox(min, max);
+}
+
+/////////////////////////////////////////////////
+/// \brief Collect the proxies found by a query.
+/// \param[in] _query Function which runs the query with a callback.
+/// \return Sorted proxies.
+template<typename Q>
+std::set<int> Collect(const Q &_query)
+{
+  std::set<int> result;
+  _query([&](const int _proxy)
+      {
+        result.insert(_proxy);
+        return true;
+      });
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoxTreeTest, InsertMoveRemove)
+{
+  physics::BoxTree tree(0.2);
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(0, tree.Height());
+  EXPECT_TRUE(tree.Validate());
+
+  int data[3];
+  ignition::math::AxisAlignedBox box(ignition::math::Vector3d(0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  int a = tree.Insert(box, &data[0]);
+  int b = tree.Insert(box + ignition::math::Vector3d(5, 0, 0), &data[1]);
+  int c = tree.Insert(box + ignition::math::Vector3d(0, 5, 0), &data[2]);
+  EXPECT_EQ(3u, tree.Size());
+  EXPECT_TRUE(tree.Validate());
+  EXPECT_EQ(&data[0], tree.UserData(a));
+  EXPECT_EQ(&data[1], tree.UserData(b));
+  EXPECT_EQ(&data[2], tree.UserData(c));
+
+  // Leaves are enlarged by the margin
+  auto fat = tree.FatBox(a);
+  EXPECT_EQ(ignition::math::Vector3d(-0.2, -0.2, -0.2), fat.Min());
+  EXPECT_EQ(ignition::math::Vector3d(1.2, 1.2, 1.2), fat.Max());
+
+  // Small motions stay inside the enlarged box
+  EXPECT_FALSE(tree.Move(a, box + ignition::math::Vector3d(0.1, 0, 0)));
+  EXPECT_TRUE(tree.Move(a, box + ignition::math::Vector3d(0.5, 0, 0)));
+  EXPECT_TRUE(tree.Validate());
+  EXPECT_EQ(&data[0], tree.UserData(a));
+
+  tree.Remove(b);
+  EXPECT_EQ(2u, tree.Size());
+  EXPECT_TRUE(tree.Validate());
+
+  auto found = Collect([&](const physics::BoxTree::QueryCallback &_cb)
+      {
+        tree.QueryBox(box + ignition::math::Vector3d(5, 0, 0), _cb);
+      });
+  EXPECT_TRUE(found.empty());
+
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_TRUE(tree.Validate());
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoxTreeTest, QueriesMatchBruteForce)
+{
+  std::mt19937 gen(1234);
+  physics::BoxTree tree;
+
+  std::vector<int> proxies;
+  for (int i = 0; i < 1000; ++i)
+    proxies.push_back(tree.Insert(RandomBox(gen), nullptr));
+  EXPECT_TRUE(tree.Validate());
+
+  // Move half of the boxes, remove a quarter and insert some more
+  for (size_t i = 0; i < proxies.size(); i += 2)
+    tree.Move(proxies[i], RandomBox(gen));
+  for (size_t i = 1; i < proxies.size(); i += 4)
+    tree.Remove(proxies[i]);
+  for (size_t i = 1; i < proxies.size(); i += 4)
+    proxies[i] = tree.Insert(RandomBox(gen), nullptr);
+  ASSERT_TRUE(tree.Validate());
+  EXPECT_EQ(proxies.size(), tree.Size());
+
+  // The tree stays balanced
+  EXPECT_LE(tree.Height(),
+      2 * static_cast<int>(std::ceil(std::log2(proxies.size()))));
+
+  for (int q = 0; q < 20; ++q)
+  {
+    // Box query
+    auto queryBox = RandomBox(gen);
+    queryBox.Max() += ignition::math::Vector3d(10, 10, 10);
+    std::set<int> expected;
+    for (auto const proxy : proxies)
+    {
+      if (tree.FatBox(proxy).Intersects(queryBox))
+        expected.insert(proxy);
+    }
+    EXPECT_EQ(expected, Collect([&](const physics::BoxTree::QueryCallback &_cb)
+        {
+          tree.QueryBox(queryBox, _cb);
+        }));
+
+    // Sphere query
+    auto center = queryBox.Center();
+    expected.clear();
+    for (auto const proxy : proxies)
+    {
+      if (physics::BoxTree::SphereOverlaps(tree.FatBox(proxy), center, 8.0))
+        expected.insert(proxy);
+    }
+    EXPECT_EQ(expected, Collect([&](const physics::BoxTree::QueryCallback &_cb)
+        {
+          tree.QuerySphere(center, 8.0, _cb);
+        }));
+
+    // Ray query, aimed at one of the boxes
+    ignition::math::Vector3d origin(0, 0, 80);
+    ignition::math::Vector3d dir =
+        tree.FatBox(proxies[q * 37]).Center() - origin;
+    dir.Normalize();
+    expected.clear();
+    for (auto const proxy : proxies)
+    {
+      double dist;
+      if (physics::BoxTree::RayDistance(tree.FatBox(proxy), origin, dir, 200,
+            dist))
+      {
+        expected.insert(proxy);
+      }
+    }
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(expected, Collect([&](const physics::BoxTree::QueryCallback &_cb)
+        {
+          tree.QueryRay(origin, dir, 200, _cb);
+        }));
+
+    // Frustum query
+    ignition::math::Frustum frustum(1.0, 40.0,
+        ignition::math::Angle(1.0), 1.5,
+        ignition::math::Pose3d(origin, ignition::math::Quaterniond(
+            0, -std::asin(dir.Z()), std::atan2(dir.Y(), dir.X()))));
+    expected.clear();
+    for (auto const proxy : proxies)
+    {
+      if (frustum.Contains(tree.FatBox(proxy)))
+        expected.insert(proxy);
+    }
+    EXPECT_EQ(expected, Collect([&](const physics::BoxTree::QueryCallback &_cb)
+        {
+          tree.QueryFrustum(frustum, _cb);
+        }));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoxTreeTest, StopQuery)
+{
+  physics::BoxTree tree;
+  ignition::math::AxisAlignedBox box(ignition::math::Vector3d(0, 0, 0),
+      ignition::math::Vector3d(1, 1, 1));
+  for (int i = 0; i < 10; ++i)
+    tree.Insert(box, nullptr);
+
+  int count = 0;
+  tree.QueryBox(box, [&](const int)
+      {
+        ++count;
+        return false;
+      });
+  EXPECT_EQ(1, count);
+}
+
+/////////////////////////////////////////////////
+TEST_F(BoxTreeTest, RayDistance)
+{
+  ignition::math::AxisAlignedBox box(ignition::math::Vector3d(-1, -1, 0),
+      ignition::math::Vector3d(1, 1, 2));
+  double dist = -1;
+
+  // Straight down onto the top face
+  EXPECT_TRUE(physics::BoxTree::RayDistance(box,
+      ignition::math::Vector3d(0, 0, 10), -ignition::math::Vector3d::UnitZ,
+      100, dist));
+  EXPECT_DOUBLE_EQ(8.0, dist);
+
+  // Too short
+  EXPECT_FALSE(physics::BoxTree::RayDistance(box,
+      ignition::math::Vector3d(0, 0, 10), -ignition::math::Vector3d::UnitZ,
+      5, dist));
+
+  // Parallel to a face, outside the box
+  EXPECT_FALSE(physics::BoxTree::RayDistance(box,
+      ignition::math::Vector3d(2, 0, 10), -ignition::math::Vector3d::UnitZ,
+      100, dist));
+
+  // From inside
+  EXPECT_TRUE(physics::BoxTree::RayDistance(box,
+      ignition::math::Vector3d(0, 0, 1), ignition::math::Vector3d::UnitX,
+      100, dist));
+  EXPECT_DOUBLE_EQ(0.0, dist);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/transport/Node.hh"
@@ -56,6 +57,7 @@ ContactManager::~ContactManager()
     {
       iter->second->collisions.clear();
       iter->second->collisionNames.clear();
+      iter->second->subscriptions.clear();
       iter->second->publisher.reset();
       delete iter->second;
       iter->second = NULL;
@@ -296,7 +298,7 @@ void ContactManager::PublishContacts()
   }
 
   // publish to default topic, ~/physics/contacts
-  if (!transport::getMinimalComms())
+  if (!transport::getMinimalComms() && this->contactPub->HasConnections())
   {
     msgs::Contacts msg;
     for (unsigned int i = 0; i < this->contactIndex; ++i)
@@ -319,18 +321,27 @@ void ContactManager::PublishContacts()
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
-    msgs::Contacts msg2;
-    for (unsigned int j = 0;
-        j < contactPublisher->contacts.size(); ++j)
+
+    // hand the contacts to the in-process subscribers directly
+    for (auto const &subscription : contactPublisher->subscriptions)
+      subscription->Push(contactPublisher->contacts);
+
+    // only serialize the contacts for external subscribers
+    if (contactPublisher->publisher->HasConnections())
     {
-      if (contactPublisher->contacts[j]->count == 0)
-        continue;
+      msgs::Contacts msg2;
+      for (unsigned int j = 0;
+          j < contactPublisher->contacts.size(); ++j)
+      {
+        if (contactPublisher->contacts[j]->count == 0)
+          continue;
 
-      msgs::Contact *contactMsg = msg2.add_contact();
-      contactPublisher->contacts[j]->FillMsg(*contactMsg);
+        msgs::Contact *contactMsg = msg2.add_contact();
+        contactPublisher->contacts[j]->FillMsg(*contactMsg);
+      }
+      msgs::Set(msg2.mutable_time(), this->world->SimTime());
+      contactPublisher->publisher->Publish(msg2);
     }
-    msgs::Set(msg2.mutable_time(), this->world->SimTime());
-    contactPublisher->publisher->Publish(msg2);
     contactPublisher->contacts.clear();
   }
 }
@@ -439,12 +450,52 @@ void ContactManager::RemoveFilter(const std::string &_name)
     contactPublisher->contacts.clear();
     contactPublisher->collisionNames.clear();
     contactPublisher->collisions.clear();
+    contactPublisher->subscriptions.clear();
     contactPublisher->publisher->Fini();
     contactPublisher->publisher.reset();
     this->customContactPublishers.erase(iter);
   }
 }
 
+/////////////////////////////////////////////////
+ContactSubscriptionPtr ContactManager::SubscribeFilter(
+    const std::string &_name, const unsigned int _capacity)
+{
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->customContactPublishers.find(name);
+  if (iter == this->customContactPublishers.end())
+  {
+    gzerr << "Contact filter [" << _name << "] does not exist. "
+          << "Unable to subscribe to it.\n";
+    return ContactSubscriptionPtr();
+  }
+
+  ContactSubscriptionPtr subscription(new ContactSubscription(_capacity));
+  iter->second->subscriptions.push_back(subscription);
+  return subscription;
+}
+
+/////////////////////////////////////////////////
+void ContactManager::UnsubscribeFilter(const std::string &_name,
+    const ContactSubscriptionPtr &_subscription)
+{
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->customContactPublishers.find(name);
+  if (iter == this->customContactPublishers.end())
+    return;
+
+  std::vector<ContactSubscriptionPtr> &subscriptions =
+      iter->second->subscriptions;
+  subscriptions.erase(std::remove(subscriptions.begin(), subscriptions.end(),
+      _subscription), subscriptions.end());
+}
+
 /////////////////////////////////////////////////
 unsigned int ContactManager::GetFilterCount()
 {
@@ -31,6 +31,7 @@
 
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactSubscription.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -56,6 +57,9 @@ namespace gazebo
       /// \brief A list of contacts associated to the collisions.
       public: std::vector<Contact *> contacts;
 
+      /// \brief In-process subscriptions to the contacts of the filter.
+      public: std::vector<ContactSubscriptionPtr> subscriptions;
+
       // Place ignition::transport objects at the end of this file to
       // guarantee they are destructed first.
 
@@ -195,6 +199,23 @@ namespace gazebo
       /// param[in] _name Filter name.
       public: void RemoveFilter(const std::string &_name);
 
+      /// \brief Subscribe in-process to the contacts of a filter. After
+      /// each step the contacts of the filter are copied into the ring
+      /// buffer of the subscription, without going through the filter
+      /// topic. The topic is only published while it has subscribers.
+      /// param[in] _name Filter name, as passed to CreateFilter.
+      /// param[in] _capacity Most contacts buffered between two reads.
+      /// \return The new subscription, NULL if the filter does not exist.
+      public: ContactSubscriptionPtr SubscribeFilter(const std::string &_name,
+                  const unsigned int _capacity);
+
+      /// \brief Remove an in-process subscription to the contacts of a
+      /// filter.
+      /// param[in] _name Filter name.
+      /// param[in] _subscription Subscription returned by SubscribeFilter.
+      public: void UnsubscribeFilter(const std::string &_name,
+                  const ContactSubscriptionPtr &_subscription);
+
       /// \brief Get the number of filters in the contact manager.
       /// return Number of filters
       public: unsigned int GetFilterCount();
@@ -16,6 +16,7 @@
 */
 
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/ContactSubscription.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -194,6 +195,89 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, SubscribeFilter)
+{
+  // world needs to be paused in order to use World::Step()
+  // function correctly (second parameter true)
+  Load("test/worlds/box.world", true);
+
+  // Get a pointer to the world, make sure world loads
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  // Verify physics engine type
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // No subscription to a filter that does not exist
+  EXPECT_TRUE(manager->SubscribeFilter("unknown", 10) == nullptr);
+
+  const std::string collisionName = "box::link::collision";
+  const std::string filterName = "box::filter";
+  manager->CreateFilter(filterName, collisionName);
+  physics::ContactSubscriptionPtr subscription =
+      manager->SubscribeFilter(filterName, 10);
+  ASSERT_TRUE(subscription != nullptr);
+  EXPECT_EQ(10u, subscription->Capacity());
+  EXPECT_EQ(0u, subscription->Size());
+  EXPECT_EQ(0u, subscription->StepCount());
+
+  // The box rests on the ground, so each step has one contact between
+  // the box and the ground.
+  world->Step(1);
+  EXPECT_EQ(1u, subscription->StepCount());
+  EXPECT_EQ(1u, subscription->Size());
+
+  unsigned int read = subscription->Read(
+      [&](const physics::ContactSample &_contact)
+  {
+    EXPECT_EQ("default", _contact.world);
+    EXPECT_TRUE(_contact.collision1 == collisionName ||
+        _contact.collision2 == collisionName);
+    EXPECT_FALSE(_contact.positions.empty());
+    EXPECT_EQ(_contact.positions.size(), _contact.normals.size());
+    EXPECT_EQ(_contact.positions.size(), _contact.depths.size());
+    EXPECT_EQ(_contact.positions.size(), _contact.wrench.size());
+
+    msgs::Contact msg;
+    _contact.FillMsg(msg);
+    EXPECT_EQ(_contact.collision1, msg.collision1());
+    EXPECT_EQ(static_cast<int>(_contact.positions.size()),
+        msg.position_size());
+  });
+  EXPECT_EQ(1u, read);
+  EXPECT_EQ(0u, subscription->Size());
+  EXPECT_EQ(0u, subscription->StepCount());
+
+  // Once full, the oldest contacts are overwritten
+  physics::ContactSubscriptionPtr small =
+      manager->SubscribeFilter(filterName, 1);
+  ASSERT_TRUE(small != nullptr);
+  world->Step(5);
+  EXPECT_EQ(5u, small->StepCount());
+  EXPECT_EQ(1u, small->Size());
+  EXPECT_EQ(4u, small->OverwrittenCount());
+  EXPECT_EQ(5u, subscription->Size());
+
+  // An unsubscribed subscription is not fed anymore
+  manager->UnsubscribeFilter(filterName, small);
+  small->Read([](const physics::ContactSample &) {});
+  world->Step(1);
+  EXPECT_EQ(0u, small->StepCount());
+  EXPECT_EQ(6u, subscription->StepCount());
+
+  // Removing the filter removes its subscriptions
+  manager->RemoveFilter(filterName);
+  subscription->Read([](const physics::ContactSample &) {});
+  world->Step(1);
+  EXPECT_EQ(0u, subscription->StepCount());
+  EXPECT_EQ(0u, subscription->Size());
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
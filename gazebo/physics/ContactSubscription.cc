@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactSubscription.hh"
+#include "gazebo/physics/World.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the ContactSubscription class
+    class ContactSubscriptionPrivate
+    {
+      /// \brief Get the scoped name of a collision, from the cache.
+      /// \param[in] _collision The collision.
+      /// \return Scoped name of the collision.
+      public: const std::string &ScopedName(Collision *_collision)
+      {
+        auto iter = this->scopedNames.find(_collision->GetId());
+        if (iter == this->scopedNames.end())
+        {
+          iter = this->scopedNames.emplace(_collision->GetId(),
+              _collision->GetScopedName()).first;
+        }
+        return iter->second;
+      }
+
+      /// \brief Protects the ring buffer.
+      public: mutable std::mutex mutex;
+
+      /// \brief Ring buffer of samples, grown up to the capacity.
+      public: std::vector<ContactSample> samples;
+
+      /// \brief Most samples buffered.
+      public: unsigned int capacity = 1;
+
+      /// \brief Index of the oldest sample.
+      public: unsigned int head = 0;
+
+      /// \brief Number of samples buffered.
+      public: unsigned int size = 0;
+
+      /// \brief Steps pushed since the last Read.
+      public: unsigned int steps = 0;
+
+      /// \brief Samples overwritten before being read.
+      public: uint64_t overwritten = 0;
+
+      /// \brief Name of the world, set by the first contact.
+      public: std::string world;
+
+      /// \brief Scoped names of the collisions, by collision id. Only
+      /// accessed in the physics thread.
+      public: std::unordered_map<uint32_t, std::string> scopedNames;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+void ContactSample::FillMsg(msgs::Contact &_msg) const
+{
+  _msg.set_world(this->world);
+  _msg.set_collision1(this->collision1);
+  _msg.set_collision2(this->collision2);
+  msgs::Set(_msg.mutable_time(), this->time);
+
+  for (size_t j = 0; j < this->depths.size(); ++j)
+  {
+    _msg.add_depth(this->depths[j]);
+
+    msgs::Set(_msg.add_position(), this->positions[j]);
+    msgs::Set(_msg.add_normal(), this->normals[j]);
+
+    msgs::JointWrench *jntWrench = _msg.add_wrench();
+    jntWrench->set_body_1_name(this->collision1);
+    jntWrench->set_body_1_id(this->collision1Id);
+    jntWrench->set_body_2_name(this->collision2);
+    jntWrench->set_body_2_id(this->collision2Id);
+
+    msgs::Wrench *wrenchMsg =  jntWrench->mutable_body_1_wrench();
+    msgs::Set(wrenchMsg->mutable_force(), this->wrench[j].body1Force);
+    msgs::Set(wrenchMsg->mutable_torque(), this->wrench[j].body1Torque);
+
+    wrenchMsg =  jntWrench->mutable_body_2_wrench();
+    msgs::Set(wrenchMsg->mutable_force(), this->wrench[j].body2Force);
+    msgs::Set(wrenchMsg->mutable_torque(), this->wrench[j].body2Torque);
+  }
+}
+
+//////////////////////////////////////////////////
+ContactSubscription::ContactSubscription(const unsigned int _capacity)
+  : dataPtr(new ContactSubscriptionPrivate)
+{
+  this->dataPtr->capacity = std::max(_capacity, 1u);
+}
+
+//////////////////////////////////////////////////
+ContactSubscription::~ContactSubscription()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int ContactSubscription::Capacity() const
+{
+  return this->dataPtr->capacity;
+}
+
+//////////////////////////////////////////////////
+unsigned int ContactSubscription::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+unsigned int ContactSubscription::StepCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->steps;
+}
+
+//////////////////////////////////////////////////
+uint64_t ContactSubscription::OverwrittenCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->overwritten;
+}
+
+//////////////////////////////////////////////////
+void ContactSubscription::Push(const std::vector<Contact *> &_contacts)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  ++this->dataPtr->steps;
+
+  for (auto const contact : _contacts)
+  {
+    if (!contact || contact->count <= 0 ||
+        !contact->collision1 || !contact->collision2)
+    {
+      continue;
+    }
+
+    // Take the next free sample, or overwrite the oldest one once full.
+    unsigned int index;
+    if (this->dataPtr->size < this->dataPtr->capacity)
+    {
+      index = (this->dataPtr->head + this->dataPtr->size) %
+        this->dataPtr->capacity;
+      ++this->dataPtr->size;
+    }
+    else
+    {
+      index = this->dataPtr->head;
+      this->dataPtr->head = (this->dataPtr->head + 1) %
+        this->dataPtr->capacity;
+      ++this->dataPtr->overwritten;
+    }
+    if (index >= this->dataPtr->samples.size())
+      this->dataPtr->samples.resize(index + 1);
+
+    if (this->dataPtr->world.empty() && contact->world)
+      this->dataPtr->world = contact->world->Name();
+
+    ContactSample &sample = this->dataPtr->samples[index];
+    sample.world = this->dataPtr->world;
+    sample.collision1 = this->dataPtr->ScopedName(contact->collision1);
+    sample.collision2 = this->dataPtr->ScopedName(contact->collision2);
+    sample.collision1Id = contact->collision1->GetId();
+    sample.collision2Id = contact->collision2->GetId();
+    sample.time = contact->time;
+
+    const int count = contact->count;
+    sample.positions.assign(contact->positions, contact->positions + count);
+    sample.normals.assign(contact->normals, contact->normals + count);
+    sample.depths.assign(contact->depths, contact->depths + count);
+    sample.wrench.assign(contact->wrench, contact->wrench + count);
+  }
+}
+
+//////////////////////////////////////////////////
+unsigned int ContactSubscription::Read(
+    const std::function<void (const ContactSample &)> &_reader)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  const unsigned int size = this->dataPtr->size;
+  for (unsigned int i = 0; i < size; ++i)
+  {
+    _reader(this->dataPtr->samples[
+        (this->dataPtr->head + i) % this->dataPtr->capacity]);
+  }
+
+  this->dataPtr->head = 0;
+  this->dataPtr->size = 0;
+  this->dataPtr->steps = 0;
+  return size;
+}
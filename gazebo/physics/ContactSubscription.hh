@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GAZEBO_PHYSICS_CONTACTSUBSCRIPTION_HH_
+#define GAZEBO_PHYSICS_CONTACTSUBSCRIPTION_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/JointWrench.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class ContactSubscriptionPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class ContactSample ContactSubscription.hh physics/physics.hh
+    /// \brief A contact between two collisions, as buffered by a
+    /// ContactSubscription. It holds the names and ids of the collisions
+    /// instead of pointers to them, so that it stays valid when the
+    /// collisions are removed after the step.
+    class GZ_PHYSICS_VISIBLE ContactSample
+    {
+      /// \brief Fill a contact message, as Contact::FillMsg does.
+      /// \param[out] _msg Contact message to fill.
+      public: void FillMsg(msgs::Contact &_msg) const;
+
+      /// \brief Name of the world.
+      public: std::string world;
+
+      /// \brief Scoped name of the first collision.
+      public: std::string collision1;
+
+      /// \brief Scoped name of the second collision.
+      public: std::string collision2;
+
+      /// \brief Id of the first collision.
+      public: uint32_t collision1Id = 0;
+
+      /// \brief Id of the second collision.
+      public: uint32_t collision2Id = 0;
+
+      /// \brief Time of the contact.
+      public: common::Time time;
+
+      /// \brief Contact positions, one per contact point.
+      public: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Contact normals, one per contact point.
+      public: std::vector<ignition::math::Vector3d> normals;
+
+      /// \brief Penetration depths, one per contact point.
+      public: std::vector<double> depths;
+
+      /// \brief Contact wrenches, one per contact point.
+      public: std::vector<JointWrench> wrench;
+    };
+
+    /// \class ContactSubscription ContactSubscription.hh physics/physics.hh
+    /// \brief In-process subscription to the contacts of a ContactManager
+    /// filter, created by ContactManager::SubscribeFilter.
+    ///
+    /// At the end of each step the ContactManager copies the contacts of
+    /// the filter into the ring buffer of the subscription, in the physics
+    /// thread. The subscriber reads them from its own thread with Read().
+    /// Once the buffer is full, each new contact overwrites the oldest
+    /// one. The samples of the buffer are reused, so that a subscription
+    /// stops allocating once it has seen its largest contacts.
+    class GZ_PHYSICS_VISIBLE ContactSubscription
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Most contacts buffered, at least 1.
+      public: explicit ContactSubscription(const unsigned int _capacity);
+
+      /// \brief Destructor.
+      public: virtual ~ContactSubscription();
+
+      /// \brief Get the most contacts buffered.
+      /// \return The capacity of the ring buffer.
+      public: unsigned int Capacity() const;
+
+      /// \brief Get the number of contacts buffered and not read yet.
+      /// \return Number of contacts.
+      public: unsigned int Size() const;
+
+      /// \brief Get the number of steps pushed since the last Read, steps
+      /// without contacts included.
+      /// \return Number of steps.
+      public: unsigned int StepCount() const;
+
+      /// \brief Get the number of contacts overwritten before being read.
+      /// \return Number of contacts lost since construction.
+      public: uint64_t OverwrittenCount() const;
+
+      /// \brief Buffer the contacts of a step. This is called by the
+      /// ContactManager once per step with the contacts of the filter.
+      /// Contacts without contact points are skipped.
+      /// \param[in] _contacts Contacts of the step.
+      public: void Push(const std::vector<Contact *> &_contacts);
+
+      /// \brief Read the buffered contacts, oldest first, and remove them.
+      /// The buffer is locked while reading, so _reader should copy what
+      /// it needs and return.
+      /// \param[in] _reader Function called with each contact.
+      /// \return Number of contacts read.
+      public: unsigned int Read(
+                  const std::function<void (const ContactSample &)> &_reader);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ContactSubscriptionPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
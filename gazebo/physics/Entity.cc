@@ -36,6 +36,7 @@
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/Entity.hh"
 
@@ -486,6 +487,7 @@ void Entity::SetWorldPose(const ignition::math::Pose3d &_pose,
     std::lock_guard<std::mutex> lock(this->GetWorld()->WorldPoseMutex());
     (*this.*setWorldPoseFunc)(_pose, _notify, _publish);
   }
+  this->GetWorld()->SpatialIndex().MarkDirty(this);
   if (_publish)
     this->PublishPose();
 }
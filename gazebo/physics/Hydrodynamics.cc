@@ -0,0 +1,685 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/HydrodynamicsPrivate.hh"
+#include "gazebo/physics/Hydrodynamics.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Number of sides of the prism used for cylinders.
+static const unsigned int kCylinderSides = 24;
+
+/////////////////////////////////////////////////
+/// \brief Add a box to a hull.
+/// \param[in] _pose Pose of the box in the link frame.
+/// \param[in] _size Size of the box.
+/// \param[in,out] _hull Hull to extend.
+static void AddBox(const ignition::math::Pose3d &_pose,
+    const ignition::math::Vector3d &_size, HydrodynamicsHull &_hull)
+{
+  const unsigned int first = _hull.vertices.size();
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    ignition::math::Vector3d corner(
+        ((i & 1) ? 0.5 : -0.5) * _size.X(),
+        ((i & 2) ? 0.5 : -0.5) * _size.Y(),
+        ((i & 4) ? 0.5 : -0.5) * _size.Z());
+    _hull.vertices.push_back(_pose.CoordPositionAdd(corner));
+  }
+
+  // Faces, counter clockwise when seen from outside
+  static const unsigned int faces[6][4] =
+  {
+    {0, 2, 3, 1}, {4, 5, 7, 6},
+    {0, 1, 5, 4}, {2, 6, 7, 3},
+    {2, 0, 4, 6}, {1, 3, 7, 5}
+  };
+  for (auto const &face : faces)
+  {
+    _hull.indices.insert(_hull.indices.end(),
+        {first + face[0], first + face[1], first + face[2],
+         first + face[0], first + face[2], first + face[3]});
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a cylinder to a hull, as a prism with the same volume.
+/// \param[in] _pose Pose of the cylinder in the link frame.
+/// \param[in] _radius Radius of the cylinder.
+/// \param[in] _length Length of the cylinder along its Z axis.
+/// \param[in,out] _hull Hull to extend.
+static void AddCylinder(const ignition::math::Pose3d &_pose,
+    const double _radius, const double _length, HydrodynamicsHull &_hull)
+{
+  const unsigned int n = kCylinderSides;
+  const double step = 2.0 * IGN_PI / n;
+
+  // Enlarge the polygon so that its area matches the circle's
+  const double radius = _radius * std::sqrt(step / std::sin(step));
+
+  const unsigned int first = _hull.vertices.size();
+  for (unsigned int top = 0; top < 2; ++top)
+  {
+    double z = (top ? 0.5 : -0.5) * _length;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      _hull.vertices.push_back(_pose.CoordPositionAdd(
+          ignition::math::Vector3d(radius * std::cos(i * step),
+            radius * std::sin(i * step), z)));
+    }
+  }
+  _hull.vertices.push_back(_pose.CoordPositionAdd(
+      ignition::math::Vector3d(0, 0, -0.5 * _length)));
+  _hull.vertices.push_back(_pose.CoordPositionAdd(
+      ignition::math::Vector3d(0, 0, 0.5 * _length)));
+
+  const unsigned int bottomCenter = first + 2 * n;
+  const unsigned int topCenter = bottomCenter + 1;
+  for (unsigned int i = 0; i < n; ++i)
+  {
+    unsigned int b0 = first + i;
+    unsigned int b1 = first + (i + 1) % n;
+    unsigned int t0 = b0 + n;
+    unsigned int t1 = b1 + n;
+    _hull.indices.insert(_hull.indices.end(),
+        {b0, b1, t1, b0, t1, t0,
+         topCenter, t0, t1,
+         bottomCenter, b1, b0});
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Add a sphere to a hull.
+/// \param[in] _center Center of the sphere in the link frame.
+/// \param[in] _volume Volume of the sphere.
+/// \param[in,out] _hull Hull to extend.
+static void AddSphereVolume(const ignition::math::Vector3d &_center,
+    const double _volume, HydrodynamicsHull &_hull)
+{
+  _hull.sphereCenters.push_back(_center);
+  _hull.sphereRadii.push_back(std::cbrt(3.0 * _volume / (4.0 * IGN_PI)));
+}
+
+/////////////////////////////////////////////////
+/// \brief Compute the part of a hull below a plane.
+/// \param[in] _hull Hull.
+/// \param[in] _plane Plane in the frame of the hull.
+/// \param[out] _volume Volume below the plane.
+/// \param[out] _center Center of the volume below the plane, zero if
+/// _volume is zero.
+static void ClipHull(const HydrodynamicsHull &_hull,
+    const ignition::math::Planed &_plane, double &_volume,
+    ignition::math::Vector3d &_center)
+{
+  _volume = 0.0;
+  ignition::math::Vector3d moment;
+
+  double volume = 0.0;
+  ignition::math::Vector3d center;
+  if (!_hull.indices.empty())
+  {
+    Hydrodynamics::ClipMesh(_hull.vertices, _hull.indices, _plane,
+        volume, center);
+    _volume += volume;
+    moment += volume * center;
+  }
+
+  for (size_t i = 0; i < _hull.sphereRadii.size(); ++i)
+  {
+    volume = 0.0;
+    Hydrodynamics::ClipSphere(_hull.sphereCenters[i], _hull.sphereRadii[i],
+        _plane, volume, center);
+    _volume += volume;
+    moment += volume * center;
+  }
+
+  _center = _volume > 0 ? moment / _volume : ignition::math::Vector3d::Zero;
+}
+
+/////////////////////////////////////////////////
+Hydrodynamics::Hydrodynamics(World &_world)
+  : dataPtr(new HydrodynamicsPrivate(_world))
+{
+}
+
+/////////////////////////////////////////////////
+Hydrodynamics::~Hydrodynamics()
+{
+}
+
+/////////////////////////////////////////////////
+bool Hydrodynamics::AddLink(const LinkPtr &_link,
+    const HydrodynamicsProperties &_props)
+{
+  if (!_link)
+    return false;
+
+  HydrodynamicsBody body;
+  body.link = _link;
+  body.props = _props;
+  HydrodynamicsPrivate::BuildHull(*_link, _props, body.hull);
+  if (body.hull.volume <= 0)
+  {
+    gzwarn << "Link [" << _link->GetScopedName() << "] has no volume, "
+           << "it won't get fluid forces.\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto &existing : this->dataPtr->bodies)
+  {
+    if (existing.link == _link)
+    {
+      existing = body;
+      return true;
+    }
+  }
+  this->dataPtr->bodies.push_back(body);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::RemoveLink(const Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &bodies = this->dataPtr->bodies;
+  bodies.erase(std::remove_if(bodies.begin(), bodies.end(),
+        [&](const HydrodynamicsBody &_body)
+        {
+          return _body.link.get() == _link;
+        }), bodies.end());
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::RemoveModel(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  for (auto const &link : _model->GetLinks())
+    this->RemoveLink(link.get());
+  for (auto const &nested : _model->NestedModels())
+    this->RemoveModel(nested);
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->bodies.clear();
+}
+
+/////////////////////////////////////////////////
+size_t Hydrodynamics::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->bodies.size();
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::SetWaterPlane(const ignition::math::Planed &_plane)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  ignition::math::Vector3d normal = _plane.Normal();
+  double length = normal.Length();
+  if (length <= 0)
+  {
+    gzerr << "Water plane normal can't be zero.\n";
+    return;
+  }
+
+  this->dataPtr->plane.Set(normal / length, _plane.Offset() / length);
+  this->dataPtr->surface = HydrodynamicsPrivate::PLANE;
+}
+
+/////////////////////////////////////////////////
+bool Hydrodynamics::SetWaterHeightfield(const std::vector<double> &_heights,
+    const unsigned int _columns, const unsigned int _rows,
+    const ignition::math::Vector2d &_size,
+    const ignition::math::Vector2d &_center)
+{
+  if (_columns < 2 || _rows < 2 ||
+      _heights.size() != static_cast<size_t>(_columns) * _rows)
+  {
+    gzerr << "Water heightfield needs at least 2x2 samples, and "
+          << _columns << "x" << _rows << " heights, got "
+          << _heights.size() << ".\n";
+    return false;
+  }
+
+  if (_size.X() <= 0 || _size.Y() <= 0)
+  {
+    gzerr << "Water heightfield size must be positive, got ["
+          << _size << "].\n";
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->heights = _heights;
+  this->dataPtr->columns = _columns;
+  this->dataPtr->rows = _rows;
+  this->dataPtr->size = _size;
+  this->dataPtr->center = _center;
+  this->dataPtr->surface = HydrodynamicsPrivate::HEIGHTFIELD;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::ClearWaterSurface()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->surface = HydrodynamicsPrivate::NONE;
+  this->dataPtr->heights.clear();
+}
+
+/////////////////////////////////////////////////
+bool Hydrodynamics::WaterPlane(const ignition::math::Vector3d &_pos,
+    ignition::math::Planed &_plane) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->SurfacePlane(_pos, _plane);
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::SetCurrent(const ignition::math::Vector3d &_current)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->current = _current;
+}
+
+/////////////////////////////////////////////////
+ignition::math::Vector3d Hydrodynamics::Current() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->current;
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::Update()
+{
+  IGN_PROFILE("Hydrodynamics::Update");
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto &bodies = this->dataPtr->bodies;
+  const size_t count = bodies.size();
+  if (count == 0)
+    return;
+
+  const ignition::math::Vector3d gravity = this->dataPtr->world.Gravity();
+  const double dt = this->dataPtr->world.Physics()->GetMaxStepSize();
+
+  this->dataPtr->fraction.resize(count);
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    this->dataPtr->vel[k].resize(count);
+    this->dataPtr->angVel[k].resize(count);
+    this->dataPtr->accel[k].resize(count);
+    this->dataPtr->linearDrag[k].resize(count);
+    this->dataPtr->quadraticDrag[k].resize(count);
+    this->dataPtr->angularDrag[k].resize(count);
+    this->dataPtr->addedMass[k].resize(count);
+    this->dataPtr->force[k].resize(count);
+    this->dataPtr->torque[k].resize(count);
+  }
+
+  // Submerged volumes and buoyancy, then gather the state of all links
+  IGN_PROFILE_BEGIN("Buoyancy");
+  for (size_t i = 0; i < count; ++i)
+  {
+    HydrodynamicsBody &body = bodies[i];
+    const ignition::math::Pose3d pose = body.link->WorldPose();
+    const ignition::math::Quaterniond invRot = pose.Rot().Inverse();
+
+    double volume = body.hull.volume;
+    ignition::math::Vector3d center = body.hull.center;
+    ignition::math::Planed water;
+    if (this->dataPtr->SurfacePlane(pose.Pos(), water))
+    {
+      // Move the plane into the link frame rather than the hull into the
+      // world frame
+      ignition::math::Planed local(invRot.RotateVector(water.Normal()),
+          water.Offset() - water.Normal().Dot(pose.Pos()));
+      ClipHull(body.hull, local, volume, center);
+    }
+
+    body.submergedVolume = volume;
+    body.center = pose.CoordPositionAdd(center);
+    this->dataPtr->fraction[i] = volume / body.hull.volume;
+
+    // By Archimedes' principle
+    if (volume > 0)
+    {
+      ignition::math::Vector3d buoyancy =
+          -body.props.fluidDensity * volume * gravity;
+      body.link->AddLinkForce(invRot.RotateVector(buoyancy), center);
+    }
+
+    ignition::math::Vector3d vel = invRot.RotateVector(
+        body.link->WorldLinearVel() - this->dataPtr->current);
+    ignition::math::Vector3d angVel =
+        invRot.RotateVector(body.link->WorldAngularVel());
+    ignition::math::Vector3d accel;
+    if (body.hasPrevVel && dt > 0)
+      accel = (vel - body.prevVel) / dt;
+    body.prevVel = vel;
+    body.hasPrevVel = true;
+
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      this->dataPtr->vel[k][i] = vel[k];
+      this->dataPtr->angVel[k][i] = angVel[k];
+      this->dataPtr->accel[k][i] = accel[k];
+      this->dataPtr->linearDrag[k][i] = body.props.linearDrag[k];
+      this->dataPtr->quadraticDrag[k][i] = body.props.quadraticDrag[k];
+      this->dataPtr->angularDrag[k][i] = body.props.angularDrag[k];
+      this->dataPtr->addedMass[k][i] = body.props.addedMass[k];
+    }
+  }
+  IGN_PROFILE_END();
+
+  // Drag and added mass of all the links, one axis at a time
+  IGN_PROFILE_BEGIN("Drag");
+  const double *fraction = this->dataPtr->fraction.data();
+  for (unsigned int k = 0; k < 3; ++k)
+  {
+    const double *vel = this->dataPtr->vel[k].data();
+    const double *angVel = this->dataPtr->angVel[k].data();
+    const double *accel = this->dataPtr->accel[k].data();
+    const double *linearDrag = this->dataPtr->linearDrag[k].data();
+    const double *quadraticDrag = this->dataPtr->quadraticDrag[k].data();
+    const double *angularDrag = this->dataPtr->angularDrag[k].data();
+    const double *addedMass = this->dataPtr->addedMass[k].data();
+    double *force = this->dataPtr->force[k].data();
+    double *torque = this->dataPtr->torque[k].data();
+    for (size_t i = 0; i < count; ++i)
+    {
+      force[i] = -fraction[i] * (linearDrag[i] * vel[i] +
+          quadraticDrag[i] * std::abs(vel[i]) * vel[i] +
+          addedMass[i] * accel[i]);
+      torque[i] = -fraction[i] * angularDrag[i] * angVel[i];
+    }
+  }
+  IGN_PROFILE_END();
+
+  IGN_PROFILE_BEGIN("Apply");
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (fraction[i] <= 0)
+      continue;
+
+    ignition::math::Vector3d force(this->dataPtr->force[0][i],
+        this->dataPtr->force[1][i], this->dataPtr->force[2][i]);
+    ignition::math::Vector3d torque(this->dataPtr->torque[0][i],
+        this->dataPtr->torque[1][i], this->dataPtr->torque[2][i]);
+    if (force != ignition::math::Vector3d::Zero)
+      bodies[i].link->AddLinkForce(force);
+    if (torque != ignition::math::Vector3d::Zero)
+      bodies[i].link->AddRelativeTorque(torque);
+  }
+  IGN_PROFILE_END();
+}
+
+/////////////////////////////////////////////////
+bool Hydrodynamics::Submerged(const Link *_link, double &_volume,
+    ignition::math::Vector3d &_center) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto const &body : this->dataPtr->bodies)
+  {
+    if (body.link.get() == _link)
+    {
+      _volume = body.submergedVolume;
+      _center = body.center;
+      return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::ClipMesh(
+    const std::vector<ignition::math::Vector3d> &_vertices,
+    const std::vector<unsigned int> &_indices,
+    const ignition::math::Planed &_plane,
+    double &_volume, ignition::math::Vector3d &_center)
+{
+  _volume = 0.0;
+  if (_vertices.empty() || _indices.size() < 3)
+    return;
+
+  const double length = _plane.Normal().Length();
+  if (length <= 0)
+    return;
+  const ignition::math::Vector3d normal = _plane.Normal() / length;
+  const double offset = _plane.Offset() / length;
+
+  // Signed heights above the plane
+  std::vector<double> heights(_vertices.size());
+  for (size_t i = 0; i < _vertices.size(); ++i)
+    heights[i] = normal.Dot(_vertices[i]) - offset;
+
+  // Sum the signed volumes of the tetrahedra between a point of the
+  // plane and each submerged triangle. The triangles which close the
+  // submerged part lie in the plane, so they don't contribute.
+  const ignition::math::Vector3d ref = _vertices[0] - heights[0] * normal;
+  ignition::math::Vector3d moment;
+  auto addTriangle = [&](const ignition::math::Vector3d &_a,
+      const ignition::math::Vector3d &_b, const ignition::math::Vector3d &_c)
+  {
+    double volume = (_a - ref).Dot((_b - ref).Cross(_c - ref)) / 6.0;
+    _volume += volume;
+    moment += volume * (ref + _a + _b + _c) / 4.0;
+  };
+  auto cut = [&](const unsigned int _from, const unsigned int _to)
+  {
+    double t = heights[_from] / (heights[_from] - heights[_to]);
+    return _vertices[_from] + (_vertices[_to] - _vertices[_from]) * t;
+  };
+
+  for (size_t t = 0; t + 2 < _indices.size(); t += 3)
+  {
+    const unsigned int *tri = &_indices[t];
+    unsigned int wet = 0;
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      if (heights[tri[j]] < 0)
+        wet |= 1u << j;
+    }
+
+    if (wet == 7)
+    {
+      addTriangle(_vertices[tri[0]], _vertices[tri[1]], _vertices[tri[2]]);
+    }
+    else if (wet == 1 || wet == 2 || wet == 4)
+    {
+      // Rotate the triangle so that a is the submerged vertex
+      unsigned int j = wet == 1 ? 0 : (wet == 2 ? 1 : 2);
+      unsigned int a = tri[j];
+      unsigned int b = tri[(j + 1) % 3];
+      unsigned int c = tri[(j + 2) % 3];
+      addTriangle(_vertices[a], cut(a, b), cut(a, c));
+    }
+    else if (wet != 0)
+    {
+      // Rotate the triangle so that c is the dry vertex
+      unsigned int j = wet == 6 ? 0 : (wet == 5 ? 1 : 2);
+      unsigned int c = tri[j];
+      unsigned int a = tri[(j + 1) % 3];
+      unsigned int b = tri[(j + 2) % 3];
+      ignition::math::Vector3d bc = cut(b, c);
+      ignition::math::Vector3d ca = cut(a, c);
+      addTriangle(_vertices[a], _vertices[b], bc);
+      addTriangle(_vertices[a], bc, ca);
+    }
+  }
+
+  if (_volume > 0)
+    _center = moment / _volume;
+  else
+    _volume = 0.0;
+}
+
+/////////////////////////////////////////////////
+void Hydrodynamics::ClipSphere(const ignition::math::Vector3d &_center,
+    const double _radius, const ignition::math::Planed &_plane,
+    double &_volume, ignition::math::Vector3d &_centroid)
+{
+  _volume = 0.0;
+  const double length = _plane.Normal().Length();
+  if (_radius <= 0 || length <= 0)
+    return;
+  const ignition::math::Vector3d normal = _plane.Normal() / length;
+
+  // Depth of the submerged cap
+  double depth = _radius - (normal.Dot(_center) - _plane.Offset() / length);
+  if (depth <= 0)
+    return;
+
+  if (depth >= 2 * _radius)
+  {
+    _volume = 4.0 / 3.0 * IGN_PI * std::pow(_radius, 3);
+    _centroid = _center;
+    return;
+  }
+
+  _volume = IGN_PI * depth * depth * (3 * _radius - depth) / 3.0;
+  double offset = 3 * std::pow(2 * _radius - depth, 2) /
+      (4 * (3 * _radius - depth));
+  _centroid = _center - offset * normal;
+}
+
+/////////////////////////////////////////////////
+void HydrodynamicsPrivate::BuildHull(const Link &_link,
+    const HydrodynamicsProperties &_props, HydrodynamicsHull &_hull)
+{
+  if (_props.volume > 0)
+  {
+    AddSphereVolume(_props.centerOfVolume, _props.volume, _hull);
+  }
+  else
+  {
+    for (auto const &collision : _link.GetCollisions())
+    {
+      ShapePtr shape = collision->GetShape();
+      if (!shape)
+        continue;
+
+      ignition::math::Pose3d pose = collision->RelativePose();
+      if (auto box = boost::dynamic_pointer_cast<BoxShape>(shape))
+      {
+        AddBox(pose, box->Size(), _hull);
+      }
+      else if (auto sphere = boost::dynamic_pointer_cast<SphereShape>(shape))
+      {
+        _hull.sphereCenters.push_back(pose.Pos());
+        _hull.sphereRadii.push_back(sphere->GetRadius());
+      }
+      else if (auto cylinder =
+          boost::dynamic_pointer_cast<CylinderShape>(shape))
+      {
+        AddCylinder(pose, cylinder->GetRadius(), cylinder->GetLength(),
+            _hull);
+      }
+      else
+      {
+        double volume = shape->ComputeVolume();
+        if (volume > 0)
+          AddSphereVolume(pose.Pos(), volume, _hull);
+      }
+    }
+  }
+
+  // Volume of the whole hull, using a plane above all of it
+  double top = -ignition::math::MAX_D;
+  for (auto const &vertex : _hull.vertices)
+    top = std::max(top, vertex.Z());
+  for (size_t i = 0; i < _hull.sphereRadii.size(); ++i)
+    top = std::max(top, _hull.sphereCenters[i].Z() + _hull.sphereRadii[i]);
+
+  ClipHull(_hull, ignition::math::Planed(ignition::math::Vector3d::UnitZ,
+        top + 1.0), _hull.volume, _hull.center);
+}
+
+/////////////////////////////////////////////////
+double HydrodynamicsPrivate::Height(const double _x, const double _y) const
+{
+  const double cellX = this->size.X() / (this->columns - 1);
+  const double cellY = this->size.Y() / (this->rows - 1);
+  double u = ignition::math::clamp(
+      (_x - this->center.X() + 0.5 * this->size.X()) / cellX,
+      0.0, this->columns - 1.0);
+  double v = ignition::math::clamp(
+      (_y - this->center.Y() + 0.5 * this->size.Y()) / cellY,
+      0.0, this->rows - 1.0);
+
+  unsigned int i = std::min(static_cast<unsigned int>(u), this->columns - 2);
+  unsigned int j = std::min(static_cast<unsigned int>(v), this->rows - 2);
+  double fu = u - i;
+  double fv = v - j;
+
+  const double *row0 = &this->heights[j * this->columns];
+  const double *row1 = row0 + this->columns;
+  return (1 - fv) * ((1 - fu) * row0[i] + fu * row0[i + 1]) +
+      fv * ((1 - fu) * row1[i] + fu * row1[i + 1]);
+}
+
+/////////////////////////////////////////////////
+bool HydrodynamicsPrivate::SurfacePlane(const ignition::math::Vector3d &_pos,
+    ignition::math::Planed &_plane) const
+{
+  switch (this->surface)
+  {
+    case PLANE:
+      _plane = this->plane;
+      return true;
+    case HEIGHTFIELD:
+    {
+      // Tangent plane, with the slope of the neighboring cells
+      const double dx = this->size.X() / (this->columns - 1);
+      const double dy = this->size.Y() / (this->rows - 1);
+      double height = this->Height(_pos.X(), _pos.Y());
+      double slopeX = (this->Height(_pos.X() + dx, _pos.Y()) -
+          this->Height(_pos.X() - dx, _pos.Y())) / (2 * dx);
+      double slopeY = (this->Height(_pos.X(), _pos.Y() + dy) -
+          this->Height(_pos.X(), _pos.Y() - dy)) / (2 * dy);
+      ignition::math::Vector3d normal(-slopeX, -slopeY, 1.0);
+      normal.Normalize();
+      _plane.Set(normal, normal.Dot(
+            ignition::math::Vector3d(_pos.X(), _pos.Y(), height)));
+      return true;
+    }
+    default:
+      return false;
+  }
+}
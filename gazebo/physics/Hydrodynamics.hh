@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HYDRODYNAMICS_HH_
+#define GAZEBO_PHYSICS_HYDRODYNAMICS_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Plane.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class HydrodynamicsPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Fluid properties of a link registered with Hydrodynamics.
+    /// Vectors are expressed in the link frame, one value per axis.
+    class GZ_PHYSICS_VISIBLE HydrodynamicsProperties
+    {
+      /// \brief Density of the fluid around the link (kg/m^3). Defaults to
+      /// liquid water at 1 atm and 15 degrees Celsius.
+      public: double fluidDensity = 999.1026;
+
+      /// \brief Volume of the link (m^3). When positive, the link is
+      /// modeled as a sphere of this volume centered on centerOfVolume.
+      /// Otherwise the volume is computed from the collision shapes.
+      public: double volume = 0.0;
+
+      /// \brief Center of volume in the link frame, used when volume is
+      /// positive.
+      public: ignition::math::Vector3d centerOfVolume;
+
+      /// \brief Linear drag coefficients (N / (m/s)).
+      public: ignition::math::Vector3d linearDrag;
+
+      /// \brief Quadratic drag coefficients (N / (m/s)^2).
+      public: ignition::math::Vector3d quadraticDrag;
+
+      /// \brief Angular drag coefficients (N m / (rad/s)).
+      public: ignition::math::Vector3d angularDrag;
+
+      /// \brief Added mass (kg).
+      public: ignition::math::Vector3d addedMass;
+    };
+
+    /// \class Hydrodynamics Hydrodynamics.hh physics/physics.hh
+    /// \brief Fluid forces on all the registered links of a world, computed
+    /// in one pass per iteration before the physics update.
+    ///
+    /// The submerged volume of each link and its center of buoyancy are
+    /// computed from the collision shapes clipped against the water
+    /// surface. Boxes and cylinders are clipped as closed meshes, spheres
+    /// analytically. Other shapes are approximated by a sphere of the same
+    /// volume. The water surface is either a plane, or a heightfield which
+    /// is approximated by its tangent plane below each link. Without a
+    /// surface, the fluid fills the whole world.
+    ///
+    /// Drag and added mass are scaled by the submerged fraction of each
+    /// link, and evaluated for all the links at once over arrays. The
+    /// acceleration used for the added mass is estimated from the velocity
+    /// of the previous iteration, so the added mass should stay well below
+    /// the mass of the link.
+    class GZ_PHYSICS_VISIBLE Hydrodynamics
+    {
+      /// \brief Constructor.
+      /// \param[in] _world Reference to the world.
+      public: explicit Hydrodynamics(World &_world);
+
+      /// \brief Destructor.
+      public: virtual ~Hydrodynamics();
+
+      /// \brief Register a link. Registering a link again replaces its
+      /// properties.
+      /// \param[in] _link Link to add.
+      /// \param[in] _props Fluid properties of the link.
+      /// \return False if the link has no volume.
+      public: bool AddLink(const LinkPtr &_link,
+                  const HydrodynamicsProperties &_props);
+
+      /// \brief Unregister a link.
+      /// \param[in] _link Link to remove.
+      public: void RemoveLink(const Link *_link);
+
+      /// \brief Unregister the links of a model and its nested models.
+      /// \param[in] _model Model to remove.
+      public: void RemoveModel(const ModelPtr &_model);
+
+      /// \brief Unregister all the links.
+      public: void Clear();
+
+      /// \brief Get the number of registered links.
+      /// \return Number of links.
+      public: size_t LinkCount() const;
+
+      /// \brief Use a plane as the water surface. The fluid is on the side
+      /// opposite to the normal.
+      /// \param[in] _plane Water plane.
+      public: void SetWaterPlane(const ignition::math::Planed &_plane);
+
+      /// \brief Use a heightfield as the water surface.
+      /// \param[in] _heights Water heights, row by row, starting at the
+      /// minimum X and Y.
+      /// \param[in] _columns Number of samples along X.
+      /// \param[in] _rows Number of samples along Y.
+      /// \param[in] _size Size of the heightfield along X and Y.
+      /// \param[in] _center Center of the heightfield in the XY plane.
+      /// \return False if the number of heights doesn't match.
+      public: bool SetWaterHeightfield(const std::vector<double> &_heights,
+                  const unsigned int _columns, const unsigned int _rows,
+                  const ignition::math::Vector2d &_size,
+                  const ignition::math::Vector2d &_center);
+
+      /// \brief Remove the water surface, so that the fluid fills the
+      /// whole world. This is the default.
+      public: void ClearWaterSurface();
+
+      /// \brief Get the water surface below a point, as a plane.
+      /// \param[in] _pos Position in the world frame.
+      /// \param[out] _plane Water plane, or tangent plane of the
+      /// heightfield below _pos.
+      /// \return False if there is no water surface.
+      public: bool WaterPlane(const ignition::math::Vector3d &_pos,
+                  ignition::math::Planed &_plane) const;
+
+      /// \brief Set the velocity of the fluid.
+      /// \param[in] _current Velocity in the world frame (m/s).
+      public: void SetCurrent(const ignition::math::Vector3d &_current);
+
+      /// \brief Get the velocity of the fluid.
+      /// \return Velocity in the world frame (m/s).
+      public: ignition::math::Vector3d Current() const;
+
+      /// \brief Compute and apply the fluid forces of all the links. Called
+      /// by the world once per iteration.
+      public: void Update();
+
+      /// \brief Get the submerged part of a link computed by the last
+      /// Update.
+      /// \param[in] _link A registered link.
+      /// \param[out] _volume Submerged volume (m^3).
+      /// \param[out] _center Center of buoyancy in the world frame.
+      /// \return False if the link isn't registered.
+      public: bool Submerged(const Link *_link, double &_volume,
+                  ignition::math::Vector3d &_center) const;
+
+      /// \brief Compute the part of a closed triangle mesh below a plane.
+      /// \param[in] _vertices Vertices of the mesh.
+      /// \param[in] _indices Three vertex indices per triangle, counter
+      /// clockwise when seen from outside.
+      /// \param[in] _plane Plane, the kept side is opposite to the normal.
+      /// \param[out] _volume Volume below the plane.
+      /// \param[out] _center Center of the volume below the plane,
+      /// unchanged if _volume is zero.
+      public: static void ClipMesh(
+                  const std::vector<ignition::math::Vector3d> &_vertices,
+                  const std::vector<unsigned int> &_indices,
+                  const ignition::math::Planed &_plane,
+                  double &_volume, ignition::math::Vector3d &_center);
+
+      /// \brief Compute the part of a sphere below a plane.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[in] _plane Plane, the kept side is opposite to the normal.
+      /// \param[out] _volume Volume below the plane.
+      /// \param[out] _centroid Center of the volume below the plane,
+      /// unchanged if _volume is zero.
+      public: static void ClipSphere(const ignition::math::Vector3d &_center,
+                  const double _radius,
+                  const ignition::math::Planed &_plane,
+                  double &_volume, ignition::math::Vector3d &_centroid);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<HydrodynamicsPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HYDRODYNAMICSPRIVATE_HH_
+#define GAZEBO_PHYSICS_HYDRODYNAMICSPRIVATE_HH_
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include <ignition/math/Plane.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/Hydrodynamics.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Geometry of a link used to compute its submerged volume,
+    /// in the link frame.
+    struct HydrodynamicsHull
+    {
+      /// \brief Vertices of the closed meshes.
+      std::vector<ignition::math::Vector3d> vertices;
+
+      /// \brief Three vertex indices per triangle.
+      std::vector<unsigned int> indices;
+
+      /// \brief Centers of the spheres.
+      std::vector<ignition::math::Vector3d> sphereCenters;
+
+      /// \brief Radii of the spheres.
+      std::vector<double> sphereRadii;
+
+      /// \brief Total volume.
+      double volume = 0.0;
+
+      /// \brief Center of the total volume.
+      ignition::math::Vector3d center;
+    };
+
+    /// \brief A link registered with Hydrodynamics.
+    struct HydrodynamicsBody
+    {
+      /// \brief The link.
+      LinkPtr link;
+
+      /// \brief Fluid properties.
+      HydrodynamicsProperties props;
+
+      /// \brief Geometry.
+      HydrodynamicsHull hull;
+
+      /// \brief Velocity relative to the fluid at the previous update, in
+      /// the link frame.
+      ignition::math::Vector3d prevVel;
+
+      /// \brief True once prevVel is set.
+      bool hasPrevVel = false;
+
+      /// \brief Submerged volume computed by the last update.
+      double submergedVolume = 0.0;
+
+      /// \brief Center of buoyancy computed by the last update, in the
+      /// world frame.
+      ignition::math::Vector3d center;
+    };
+
+    /// \internal
+    /// \brief Private data for the Hydrodynamics class.
+    class HydrodynamicsPrivate
+    {
+      /// \brief Types of water surface.
+      public: enum SurfaceType
+              {
+                /// \brief The fluid fills the world.
+                NONE,
+
+                /// \brief Water plane.
+                PLANE,
+
+                /// \brief Water heightfield.
+                HEIGHTFIELD
+              };
+
+      /// \brief Constructor.
+      /// \param[in] _world Reference to the world.
+      public: explicit HydrodynamicsPrivate(World &_world)
+              : world(_world)
+              {
+              }
+
+      /// \brief Build the geometry of a link.
+      /// \param[in] _link Link.
+      /// \param[in] _props Fluid properties of the link.
+      /// \param[out] _hull Geometry in the link frame.
+      public: static void BuildHull(const Link &_link,
+                  const HydrodynamicsProperties &_props,
+                  HydrodynamicsHull &_hull);
+
+      /// \brief Get the height of the heightfield. Must be called with
+      /// mutex locked.
+      /// \param[in] _x X coordinate, clamped to the heightfield.
+      /// \param[in] _y Y coordinate, clamped to the heightfield.
+      /// \return Interpolated height.
+      public: double Height(const double _x, const double _y) const;
+
+      /// \brief Get the water surface below a point. Must be called with
+      /// mutex locked.
+      /// \param[in] _pos Position in the world frame.
+      /// \param[out] _plane Water plane below the point.
+      /// \return False if there is no water surface.
+      public: bool SurfacePlane(const ignition::math::Vector3d &_pos,
+                  ignition::math::Planed &_plane) const;
+
+      /// \brief Reference to the world.
+      public: World &world;
+
+      /// \brief Registered links, in order of registration.
+      public: std::vector<HydrodynamicsBody> bodies;
+
+      /// \brief Type of water surface.
+      public: SurfaceType surface = NONE;
+
+      /// \brief Water plane.
+      public: ignition::math::Planed plane;
+
+      /// \brief Heights of the heightfield, row by row.
+      public: std::vector<double> heights;
+
+      /// \brief Number of heightfield samples along X.
+      public: unsigned int columns = 0;
+
+      /// \brief Number of heightfield samples along Y.
+      public: unsigned int rows = 0;
+
+      /// \brief Size of the heightfield.
+      public: ignition::math::Vector2d size;
+
+      /// \brief Center of the heightfield.
+      public: ignition::math::Vector2d center;
+
+      /// \brief Velocity of the fluid in the world frame.
+      public: ignition::math::Vector3d current;
+
+      /// \brief Submerged fraction of each link.
+      public: std::vector<double> fraction;
+
+      /// \brief Velocity of each link relative to the fluid, one column
+      /// per axis of the link frame.
+      public: std::array<std::vector<double>, 3> vel;
+
+      /// \brief Angular velocity of each link, one column per axis of the
+      /// link frame.
+      public: std::array<std::vector<double>, 3> angVel;
+
+      /// \brief Acceleration of each link relative to the fluid, one
+      /// column per axis of the link frame.
+      public: std::array<std::vector<double>, 3> accel;
+
+      /// \brief Linear drag coefficients, one column per axis.
+      public: std::array<std::vector<double>, 3> linearDrag;
+
+      /// \brief Quadratic drag coefficients, one column per axis.
+      public: std::array<std::vector<double>, 3> quadraticDrag;
+
+      /// \brief Angular drag coefficients, one column per axis.
+      public: std::array<std::vector<double>, 3> angularDrag;
+
+      /// \brief Added mass, one column per axis.
+      public: std::array<std::vector<double>, 3> addedMass;
+
+      /// \brief Drag and added mass force, one column per axis.
+      public: std::array<std::vector<double>, 3> force;
+
+      /// \brief Drag torque, one column per axis.
+      public: std::array<std::vector<double>, 3> torque;
+
+      /// \brief Protects all members above.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/Hydrodynamics.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class HydrodynamicsTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Make a box mesh centered on the origin.
+/// \param[in] _size Size of the box.
+/// \param[out] _vertices Vertices.
+/// \param[out] _indices Triangles, counter clockwise from outside.
+void BoxMesh(const ignition::math::Vector3d &_size,
+    std::vector<ignition::math::Vector3d> &_vertices,
+    std::vector<unsigned int> &_indices)
+{
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    _vertices.push_back(ignition::math::Vector3d(
+        ((i & 1) ? 0.5 : -0.5) * _size.X(),
+        ((i & 2) ? 0.5 : -0.5) * _size.Y(),
+        ((i & 4) ? 0.5 : -0.5) * _size.Z()));
+  }
+  const unsigned int faces[6][4] =
+  {
+    {0, 2, 3, 1}, {4, 5, 7, 6},
+    {0, 1, 5, 4}, {2, 6, 7, 3},
+    {2, 0, 4, 6}, {1, 3, 7, 5}
+  };
+  for (auto const &face : faces)
+  {
+    _indices.insert(_indices.end(),
+        {face[0], face[1], face[2], face[0], face[2], face[3]});
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Rotate a vector about X, then about Z.
+/// \param[in] _v Vector to rotate.
+/// \param[in] _roll Angle about X.
+/// \param[in] _yaw Angle about Z.
+/// \return Rotated vector.
+ignition::math::Vector3d Rotate(const ignition::math::Vector3d &_v,
+    const double _roll, const double _yaw)
+{
+  ignition::math::Vector3d r(_v.X(),
+      std::cos(_roll) * _v.Y() - std::sin(_roll) * _v.Z(),
+      std::sin(_roll) * _v.Y() + std::cos(_roll) * _v.Z());
+  return ignition::math::Vector3d(
+      std::cos(_yaw) * r.X() - std::sin(_yaw) * r.Y(),
+      std::sin(_yaw) * r.X() + std::cos(_yaw) * r.Y(),
+      r.Z());
+}
+
+/////////////////////////////////////////////////
+TEST_F(HydrodynamicsTest, ClipBox)
+{
+  std::vector<ignition::math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  BoxMesh(ignition::math::Vector3d(2, 3, 1), vertices, indices);
+
+  double volume = -1;
+  ignition::math::Vector3d center;
+
+  // Above the water
+  physics::Hydrodynamics::ClipMesh(vertices, indices,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, -0.5),
+      volume, center);
+  EXPECT_DOUBLE_EQ(0.0, volume);
+
+  // Fully submerged
+  physics::Hydrodynamics::ClipMesh(vertices, indices,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, 0.6),
+      volume, center);
+  EXPECT_NEAR(6.0, volume, 1e-9);
+  EXPECT_NEAR(0.0, center.Length(), 1e-9);
+
+  // Partially submerged, the center of buoyancy goes down with the water
+  for (double level = -0.4; level < 0.5; level += 0.1)
+  {
+    physics::Hydrodynamics::ClipMesh(vertices, indices,
+        ignition::math::Planed(ignition::math::Vector3d::UnitZ, level),
+        volume, center);
+    EXPECT_NEAR(6.0 * (level + 0.5), volume, 1e-9);
+    EXPECT_NEAR(0.0, center.X(), 1e-9);
+    EXPECT_NEAR(0.0, center.Y(), 1e-9);
+    EXPECT_NEAR(0.5 * (level - 0.5), center.Z(), 1e-9);
+  }
+
+  // A plane through the center along a diagonal keeps half of the box
+  physics::Hydrodynamics::ClipMesh(vertices, indices,
+      ignition::math::Planed(ignition::math::Vector3d(1, 0, 1), 0.0),
+      volume, center);
+  EXPECT_NEAR(3.0, volume, 1e-9);
+  EXPECT_LT(center.X(), 0.0);
+  EXPECT_LT(center.Z(), 0.0);
+  EXPECT_NEAR(0.0, center.Y(), 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HydrodynamicsTest, ClipRotated)
+{
+  std::vector<ignition::math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  BoxMesh(ignition::math::Vector3d(1, 2, 0.5), vertices, indices);
+
+  // Rotating both the mesh and the plane doesn't change the volume
+  const ignition::math::Vector3d normal(0.3, -0.2, 1.0);
+  double volume;
+  ignition::math::Vector3d center;
+  physics::Hydrodynamics::ClipMesh(vertices, indices,
+      ignition::math::Planed(normal, 0.1), volume, center);
+  EXPECT_GT(volume, 0.0);
+  EXPECT_LT(volume, 1.0);
+
+  std::vector<ignition::math::Vector3d> rotated;
+  for (auto const &vertex : vertices)
+    rotated.push_back(Rotate(vertex, 0.7, -1.2));
+
+  double rotatedVolume;
+  ignition::math::Vector3d rotatedCenter;
+  physics::Hydrodynamics::ClipMesh(rotated, indices,
+      ignition::math::Planed(Rotate(normal, 0.7, -1.2), 0.1),
+      rotatedVolume, rotatedCenter);
+  EXPECT_NEAR(volume, rotatedVolume, 1e-9);
+  EXPECT_NEAR(0.0, (Rotate(center, 0.7, -1.2) - rotatedCenter).Length(),
+      1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HydrodynamicsTest, ClipSphere)
+{
+  const double radius = 0.5;
+  const ignition::math::Vector3d center(1, 2, 3);
+  const double full = 4.0 / 3.0 * IGN_PI * std::pow(radius, 3);
+  double volume = -1;
+  ignition::math::Vector3d centroid;
+
+  physics::Hydrodynamics::ClipSphere(center, radius,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, 2.5),
+      volume, centroid);
+  EXPECT_DOUBLE_EQ(0.0, volume);
+
+  physics::Hydrodynamics::ClipSphere(center, radius,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, 4.0),
+      volume, centroid);
+  EXPECT_NEAR(full, volume, 1e-9);
+  EXPECT_EQ(center, centroid);
+
+  // Half sphere
+  physics::Hydrodynamics::ClipSphere(center, radius,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, 3.0),
+      volume, centroid);
+  EXPECT_NEAR(0.5 * full, volume, 1e-9);
+  EXPECT_NEAR(3.0 - 3.0 * radius / 8.0, centroid.Z(), 1e-9);
+
+  // Cap against a numerical integration of the disks
+  const double level = 2.8;
+  double expected = 0.0;
+  double moment = 0.0;
+  const int steps = 100000;
+  const double dz = (level - (center.Z() - radius)) / steps;
+  for (int i = 0; i < steps; ++i)
+  {
+    double z = center.Z() - radius + (i + 0.5) * dz;
+    double r2 = radius * radius - std::pow(z - center.Z(), 2);
+    expected += IGN_PI * r2 * dz;
+    moment += IGN_PI * r2 * dz * z;
+  }
+  physics::Hydrodynamics::ClipSphere(center, radius,
+      ignition::math::Planed(ignition::math::Vector3d::UnitZ, level),
+      volume, centroid);
+  EXPECT_NEAR(expected, volume, 1e-6);
+  EXPECT_NEAR(moment / expected, centroid.Z(), 1e-6);
+  EXPECT_NEAR(center.X(), centroid.X(), 1e-9);
+  EXPECT_NEAR(center.Y(), centroid.Y(), 1e-9);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -698,6 +698,7 @@ bool Joint::SetPosition(const unsigned int /*_index*/, const double _position,
                         const bool /*_preserveWorldVelocity*/)
 {
   // parent class doesn't do much, derived classes do all the work.
+  this->MarkModelJointStatesStale();
   if (this->model)
   {
     if (this->model->IsStatic())
@@ -837,6 +838,7 @@ bool Joint::SetPositionMaximal(
 //////////////////////////////////////////////////
 bool Joint::SetVelocityMaximal(unsigned int _index, double _velocity)
 {
+  this->MarkModelJointStatesStale();
   // check if index is within bounds
   if (_index >= this->DOF())
   {
@@ -933,9 +935,22 @@ void Joint::SetState(const JointState &_state)
   }
 }
 
+//////////////////////////////////////////////////
+void Joint::MarkModelJointStatesStale(const bool _forcesOnly)
+{
+  if (!this->model)
+    return;
+
+  if (_forcesOnly)
+    this->model->MarkJointForcesStale();
+  else
+    this->model->MarkJointStatesStale();
+}
+
 //////////////////////////////////////////////////
 double Joint::CheckAndTruncateForce(unsigned int _index, double _effort)
 {
+  this->MarkModelJointStatesStale(true);
   if (_index >= this->DOF())
   {
     gzerr << "Calling Joint::SetForce with an index ["
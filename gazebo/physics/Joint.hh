@@ -112,7 +112,7 @@ namespace gazebo
       public: virtual void Fini() override;
 
       /// \brief Update the joint.
-      public: void Update() override;
+      public: void Update() override final;
 
       /// \brief Update the parameters using new sdf values.
       /// \param[in] _sdf SDF values to update from.
@@ -387,6 +387,11 @@ namespace gazebo
       /// \return returns true if operation succeeds, false if it fails.
       protected: bool SetVelocityMaximal(unsigned int _index, double _velocity);
 
+      /// \brief Mark the joint state buffers of the model as stale. Called
+      /// when the position, velocity or force of the joint is set.
+      /// \param[in] _forcesOnly True if only a force was applied.
+      protected: void MarkModelJointStatesStale(const bool _forcesOnly = false);
+
       /// \brief Get the forces applied to the center of mass of a physics::Link
       /// due to the existence of this Joint.
       /// Note that the unit of force should be consistent with the rest
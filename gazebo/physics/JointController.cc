@@ -31,6 +31,39 @@
 using namespace gazebo;
 using namespace physics;
 
+/////////////////////////////////////////////////
+/// \brief Compile the command maps of a joint controller into arrays.
+/// \param[in,out] _data Private data of the joint controller.
+static void compileCommands(JointControllerPrivate &_data)
+{
+  _data.forceCommands.clear();
+  _data.positionCommands.clear();
+  _data.velocityCommands.clear();
+
+  auto compile = [&_data](const std::map<std::string, double> &_targets,
+      std::map<std::string, common::PID> *_pids,
+      std::vector<JointCommand> &_commands)
+  {
+    for (auto const &target : _targets)
+    {
+      auto joint = _data.joints.find(target.first);
+      if (joint == _data.joints.end() || !joint->second)
+        continue;
+
+      JointCommand cmd;
+      cmd.joint = joint->second;
+      cmd.index = _data.model->JointStateIndex(joint->second->GetScopedName());
+      cmd.pid = _pids ? &(*_pids)[target.first] : nullptr;
+      cmd.target = target.second;
+      _commands.push_back(cmd);
+    }
+  };
+
+  compile(_data.forces, nullptr, _data.forceCommands);
+  compile(_data.positions, &_data.posPids, _data.positionCommands);
+  compile(_data.velocities, &_data.velPids, _data.velocityCommands);
+}
+
 /////////////////////////////////////////////////
 JointController::JointController(ModelPtr _model)
   : dataPtr(new JointControllerPrivate)
@@ -74,6 +107,7 @@ void JointController::AddJoint(JointPtr _joint)
       1, 0.1, 0.01, 1, -1, 1000, -1000);
   this->dataPtr->velPids[_joint->GetScopedName()].Init(
       1, 0.1, 0.01, 1, -1, 1000, -1000);
+  this->dataPtr->commandsStale = true;
 }
 
 /////////////////////////////////////////////////
@@ -85,6 +119,7 @@ void JointController::RemoveJoint(Joint *_joint)
     this->dataPtr->posPids.erase(_joint->GetScopedName());
     this->dataPtr->velPids.erase(_joint->GetScopedName());
   }
+  this->dataPtr->commandsStale = true;
 }
 
 /////////////////////////////////////////////////
@@ -108,6 +143,7 @@ void JointController::Reset()
   {
     iter->second.Reset();
   }
+  this->dataPtr->commandsStale = true;
 }
 
 /////////////////////////////////////////////////
@@ -123,42 +159,34 @@ void JointController::Update()
   // TODO: fix this when World::ResetTime is improved
   if (stepTime > 0)
   {
-    if (!this->dataPtr->forces.empty())
-    {
-      std::map<std::string, double>::iterator iter;
-      for (iter = this->dataPtr->forces.begin();
-          iter != this->dataPtr->forces.end(); ++iter)
-      {
-        this->dataPtr->joints[iter->first]->SetForce(0, iter->second);
-      }
-    }
+    if (this->dataPtr->commandsStale.exchange(false))
+      compileCommands(*this->dataPtr);
 
-    if (!this->dataPtr->positions.empty())
-    {
-      std::map<std::string, double>::iterator iter;
+    // The joint states of the last step, read from the buffers of the
+    // model before any force is applied
+    if (!this->dataPtr->positionCommands.empty())
+      this->dataPtr->model->JointPositions(this->dataPtr->jointPositions);
+    if (!this->dataPtr->velocityCommands.empty())
+      this->dataPtr->model->JointVelocities(this->dataPtr->jointVelocities);
 
-      for (iter = this->dataPtr->positions.begin();
-           iter != this->dataPtr->positions.end(); ++iter)
-      {
-        double cmd = this->dataPtr->posPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->Position(0) -
-            iter->second, stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
-    }
+    for (auto const &cmd : this->dataPtr->forceCommands)
+      cmd.joint->SetForce(0, cmd.target);
 
-    if (!this->dataPtr->velocities.empty())
+    for (auto const &cmd : this->dataPtr->positionCommands)
     {
-      std::map<std::string, double>::iterator iter;
+      double position = cmd.index >= 0 ?
+        this->dataPtr->jointPositions[cmd.index] : cmd.joint->Position(0);
+      cmd.joint->SetForce(0,
+          cmd.pid->Update(position - cmd.target, stepTime));
+    }
 
-      for (iter = this->dataPtr->velocities.begin();
-           iter != this->dataPtr->velocities.end(); ++iter)
-      {
-        double cmd = this->dataPtr->velPids[iter->first].Update(
-            this->dataPtr->joints[iter->first]->GetVelocity(0) - iter->second,
-            stepTime);
-        this->dataPtr->joints[iter->first]->SetForce(0, cmd);
-      }
+    for (auto const &cmd : this->dataPtr->velocityCommands)
+    {
+      double velocity = cmd.index >= 0 ?
+        this->dataPtr->jointVelocities[cmd.index] :
+        cmd.joint->GetVelocity(0);
+      cmd.joint->SetForce(0,
+          cmd.pid->Update(velocity - cmd.target, stepTime));
     }
   }
 
@@ -371,6 +399,7 @@ void JointController::OnJointCommand(const ignition::msgs::JointCmd &_msg)
   }
   else
     gzerr << "Unable to find joint[" << _msg.name() << "]\n";
+  this->dataPtr->commandsStale = true;
 }
 
 //////////////////////////////////////////////////
@@ -418,6 +447,7 @@ void JointController::SetJointPosition(
   JointPtr _joint, double _position, int _index)
 {
   _joint->SetPosition(_index, _position);
+  this->dataPtr->model->MarkJointStatesStale();
 }
 
 /////////////////////////////////////////////////
@@ -473,6 +503,7 @@ void JointController::SetPositionPID(const std::string &_jointName,
     this->dataPtr->posPids[_jointName] = _pid;
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
+  this->dataPtr->commandsStale = true;
 }
 
 /////////////////////////////////////////////////
@@ -488,6 +519,7 @@ bool JointController::SetPositionTarget(const std::string &_jointName,
     result = true;
   }
 
+  this->dataPtr->commandsStale = true;
   return result;
 }
 
@@ -502,6 +534,7 @@ void JointController::SetVelocityPID(const std::string &_jointName,
     this->dataPtr->velPids[_jointName] = _pid;
   else
     gzerr << "Unable to find joint with name[" << _jointName << "]\n";
+  this->dataPtr->commandsStale = true;
 }
 
 /////////////////////////////////////////////////
@@ -517,6 +550,7 @@ bool JointController::SetVelocityTarget(const std::string &_jointName,
     result = true;
   }
 
+  this->dataPtr->commandsStale = true;
   return result;
 }
 
@@ -533,5 +567,6 @@ bool JointController::SetForce(const std::string &_jointName,
     result = true;
   }
 
+  this->dataPtr->commandsStale = true;
   return result;
 }
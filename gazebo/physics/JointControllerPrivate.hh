@@ -17,8 +17,10 @@
 #ifndef _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 #define _GAZEBO_JOINTCONTROLLER_PRIVATE_HH_
 
+#include <atomic>
 #include <string>
 #include <map>
+#include <vector>
 #include <ignition/transport.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -30,6 +32,24 @@ namespace gazebo
 {
   namespace physics
   {
+    /// \brief A command of a joint, compiled from the command maps of the
+    /// joint controller, so that updates don't look joints up by name.
+    class JointCommand
+    {
+      /// \brief Commanded joint.
+      public: JointPtr joint;
+
+      /// \brief Index of the joint in the joint state buffers of the
+      /// model, -1 if it isn't there.
+      public: int index = -1;
+
+      /// \brief PID controller, null for a force command.
+      public: common::PID *pid = nullptr;
+
+      /// \brief Target position or velocity, or force.
+      public: double target = 0;
+    };
+
     class JointControllerPrivate
     {
       /// \brief Model to control.
@@ -68,6 +88,26 @@ namespace gazebo
 
       /// \brief Last time the controller was updated.
       public: common::Time prevUpdateTime;
+
+      /// \brief Force commands.
+      public: std::vector<JointCommand> forceCommands;
+
+      /// \brief Position commands.
+      public: std::vector<JointCommand> positionCommands;
+
+      /// \brief Velocity commands.
+      public: std::vector<JointCommand> velocityCommands;
+
+      /// \brief True if the commands must be compiled again from the maps.
+      /// Set by the setters, which may be called from transport threads;
+      /// the commands are only compiled and used by Update.
+      public: std::atomic<bool> commandsStale{true};
+
+      /// \brief Joint positions of the model, read by Update.
+      public: std::vector<double> jointPositions;
+
+      /// \brief Joint velocities of the model, read by Update.
+      public: std::vector<double> jointVelocities;
     };
   }
 }
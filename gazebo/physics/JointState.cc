@@ -20,6 +20,7 @@
 #include "gazebo/physics/Joint.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/StateStream.hh"
 #include "gazebo/physics/JointState.hh"
 
 using namespace gazebo;
@@ -214,3 +215,16 @@ void JointState::FillSDF(sdf::ElementPtr _sdf)
     elem->Set((*iter));
   }
 }
+
+/////////////////////////////////////////////////
+void JointState::Serialize(StateWriter &_writer) const
+{
+  _writer.WriteName(this->name);
+  _writer.WriteDoubles(this->positions);
+}
+
+/////////////////////////////////////////////////
+bool JointState::Deserialize(StateReader &_reader)
+{
+  return _reader.ReadName(this->name) && _reader.ReadDoubles(this->positions);
+}
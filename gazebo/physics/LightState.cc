@@ -16,6 +16,7 @@
  */
 
 #include "gazebo/physics/Light.hh"
+#include "gazebo/physics/StateStream.hh"
 #include "gazebo/physics/LightState.hh"
 
 using namespace gazebo;
@@ -117,3 +118,16 @@ void LightState::FillSDF(sdf::ElementPtr _sdf)
   _sdf->GetElement("pose")->Set(this->pose);
 }
 
+/////////////////////////////////////////////////
+void LightState::Serialize(StateWriter &_writer) const
+{
+  _writer.WriteName(this->name);
+  _writer.WritePose(this->pose);
+}
+
+/////////////////////////////////////////////////
+bool LightState::Deserialize(StateReader &_reader)
+{
+  return _reader.ReadName(this->name) && _reader.ReadPose(this->pose);
+}
+
@@ -97,8 +97,8 @@ class gazebo::physics::LinkPrivate
   /// \brief Wind velocity.
   public: ignition::math::Vector3d windLinearVel;
 
-  /// \brief Update connection to calculate wind velocity.
-  public: event::ConnectionPtr updateConnection;
+  /// \brief True if the link is registered with the world's wind.
+  public: bool windEnabled = false;
 
   /// \brief All the attached batteries.
   public: std::vector<common::BatteryPtr> batteries;
@@ -344,7 +344,8 @@ void Link::Init()
 //////////////////////////////////////////////////
 void Link::Fini()
 {
-  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->windEnabled)
+    this->SetWindEnabled(false);
 
   this->dataPtr->attachedModels.clear();
   this->dataPtr->parentJoints.clear();
@@ -842,26 +843,33 @@ void Link::SetWindMode(const bool _mode)
 {
   this->sdf->GetElement("enable_wind")->Set(_mode);
 
-  if (!this->WindMode() && this->dataPtr->updateConnection)
+  if (!this->WindMode() && this->dataPtr->windEnabled)
     this->SetWindEnabled(false);
-  else if (this->WindMode() && !this->dataPtr->updateConnection)
+  else if (this->WindMode() && !this->dataPtr->windEnabled)
     this->SetWindEnabled(true);
 }
 
 /////////////////////////////////////////////////
 void Link::SetWindEnabled(const bool _enable)
 {
+  // The wind computes the velocity of all its links at once
   if (_enable)
   {
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-        std::bind(&Link::UpdateWind, this, std::placeholders::_1));
+    this->world->Wind().AddLink(this);
   }
   else
   {
-    this->dataPtr->updateConnection.reset();
+    this->world->Wind().RemoveLink(this);
     // Make sure wind velocity is null
     this->dataPtr->windLinearVel.Set(0, 0, 0);
   }
+  this->dataPtr->windEnabled = _enable;
+}
+
+//////////////////////////////////////////////////
+void Link::SetWorldWindLinearVel(const ignition::math::Vector3d &_vel)
+{
+  this->dataPtr->windLinearVel = _vel;
 }
 
 //////////////////////////////////////////////////
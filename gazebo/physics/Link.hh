@@ -570,7 +570,8 @@ namespace gazebo
       /// \return this link's wind velocity.
       public: const ignition::math::Vector3d RelativeWindLinearVel() const;
 
-      /// \brief Update the wind.
+      /// \brief Update the wind of this link only. The wind of all the
+      /// wind-enabled links is updated at once by Wind::Update.
       /// \param[in] _info Update information.
       public: void UpdateWind(const common::UpdateInfo &_info);
 
@@ -689,6 +690,15 @@ namespace gazebo
 
       /// \brief Pointer to private data
       private: std::unique_ptr<LinkPrivate> dataPtr;
+
+      /// \brief Set the wind velocity of this link.
+      /// \param[in] _vel Wind velocity in the world frame.
+      private: void SetWorldWindLinearVel(
+                   const ignition::math::Vector3d &_vel);
+
+      /// \brief The wind computes the velocity of all the wind-enabled
+      /// links in one pass.
+      private: friend class Wind;
     };
     /// \}
   }
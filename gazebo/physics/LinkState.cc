@@ -19,6 +19,7 @@
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/StateStream.hh"
 #include "gazebo/physics/LinkState.hh"
 
 using namespace gazebo;
@@ -320,6 +321,48 @@ void LinkState::FillSDF(sdf::ElementPtr _sdf)
   // }
 }
 
+/////////////////////////////////////////////////
+void LinkState::Serialize(StateWriter &_writer) const
+{
+  // Flags of the non-zero quantities, which are the only ones written
+  uint64_t flags = 0;
+  if (this->velocity != ignition::math::Pose3d::Zero)
+    flags |= 1;
+  if (this->acceleration != ignition::math::Pose3d::Zero)
+    flags |= 2;
+  if (this->wrench != ignition::math::Pose3d::Zero)
+    flags |= 4;
+
+  _writer.WriteName(this->name);
+  _writer.WriteUInt(flags);
+  _writer.WritePose(this->pose);
+  if (flags & 1)
+    _writer.WritePose(this->velocity);
+  if (flags & 2)
+    _writer.WritePose(this->acceleration);
+  if (flags & 4)
+    _writer.WritePose(this->wrench);
+}
+
+/////////////////////////////////////////////////
+bool LinkState::Deserialize(StateReader &_reader)
+{
+  uint64_t flags;
+  if (!_reader.ReadName(this->name) || !_reader.ReadUInt(flags) ||
+      !_reader.ReadPose(this->pose))
+  {
+    return false;
+  }
+
+  this->velocity = ignition::math::Pose3d::Zero;
+  this->acceleration = ignition::math::Pose3d::Zero;
+  this->wrench = ignition::math::Pose3d::Zero;
+
+  return (!(flags & 1) || _reader.ReadPose(this->velocity)) &&
+         (!(flags & 2) || _reader.ReadPose(this->acceleration)) &&
+         (!(flags & 4) || _reader.ReadPose(this->wrench));
+}
+
 /////////////////////////////////////////////////
 void LinkState::SetWallTime(const common::Time &_time)
 {
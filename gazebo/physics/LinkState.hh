@@ -146,6 +146,16 @@ namespace gazebo
       /// \param[out] _sdf SDF element to populate.
       public: void FillSDF(sdf::ElementPtr _sdf);
 
+      /// \brief Write the state in binary form.
+      /// \param[in,out] _writer Writer of the current segment.
+      /// \sa StateWriter
+      public: void Serialize(StateWriter &_writer) const;
+
+      /// \brief Read a state written by Serialize.
+      /// \param[in,out] _reader Reader of the current segment.
+      /// \return True on success.
+      public: bool Deserialize(StateReader &_reader);
+
       /// \brief Set the wall time when this state was generated
       /// \param[in] _time The absolute clock time when the State
       /// data was recorded.
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/util/LogPlay.hh"
+#include "gazebo/physics/LogPlayPipelinePrivate.hh"
+#include "gazebo/physics/LogPlayPipeline.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+LogPlayPipeline::LogPlayPipeline(const size_t _queueSize,
+    const size_t _cacheSize)
+: dataPtr(new LogPlayPipelinePrivate)
+{
+  this->dataPtr->queueSize = std::max<size_t>(1, _queueSize);
+  this->dataPtr->cacheSize = std::max<size_t>(1, _cacheSize);
+
+  this->dataPtr->stateSdf.reset(new sdf::Element);
+  sdf::initFile("state.sdf", this->dataPtr->stateSdf);
+}
+
+//////////////////////////////////////////////////
+LogPlayPipeline::~LogPlayPipeline()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipeline::Start()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->stop)
+    return;
+
+  this->dataPtr->stop = false;
+  this->dataPtr->Reset();
+  this->dataPtr->thread =
+    std::thread(&LogPlayPipelinePrivate::Run, this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipeline::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->decodeCondition.notify_all();
+  this->dataPtr->readyCondition.notify_all();
+
+  if (this->dataPtr->thread.joinable())
+    this->dataPtr->thread.join();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<WorldState> LogPlayPipeline::Next()
+{
+  GZ_PROFILE_SCOPE("LogPlayPipeline::Next");
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto &cache = this->dataPtr->cache;
+  auto &queue = this->dataPtr->queue;
+
+  // Replay a frame from the cache, after stepping backwards
+  if (this->dataPtr->current + 1 <
+      this->dataPtr->cacheStart + static_cast<int64_t>(cache.size()))
+  {
+    ++this->dataPtr->current;
+    return cache[this->dataPtr->current - this->dataPtr->cacheStart];
+  }
+
+  // Decoding stays paused after stepping back past the cache, until the
+  // cache has been replayed.
+  if (queue.empty() && this->dataPtr->paused)
+    this->dataPtr->Resume();
+
+  this->dataPtr->readyCondition.wait(lock, [this]()
+      {
+        return !this->dataPtr->queue.empty() || this->dataPtr->endOfLog ||
+          this->dataPtr->stop;
+      });
+
+  if (queue.empty())
+    return nullptr;
+
+  auto frame = queue.front();
+  queue.pop_front();
+  this->dataPtr->decodeCondition.notify_one();
+
+  if (cache.empty())
+    this->dataPtr->cacheStart = this->dataPtr->current + 1;
+  cache.push_back(frame);
+  ++this->dataPtr->current;
+
+  while (cache.size() > this->dataPtr->cacheSize)
+  {
+    cache.pop_front();
+    ++this->dataPtr->cacheStart;
+  }
+
+  return frame;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<WorldState> LogPlayPipeline::Previous()
+{
+  GZ_PROFILE_SCOPE("LogPlayPipeline::Previous");
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto &cache = this->dataPtr->cache;
+
+  if (!cache.empty() &&
+      this->dataPtr->current - 1 >= this->dataPtr->cacheStart)
+  {
+    --this->dataPtr->current;
+    return cache[this->dataPtr->current - this->dataPtr->cacheStart];
+  }
+
+  // Not cached, step the log back to the frame before the current one.
+  this->dataPtr->Pause(lock);
+
+  util::LogPlay *play = util::LogPlay::Instance();
+  std::string data;
+  while (this->dataPtr->decoded > this->dataPtr->current - 1)
+  {
+    if (!play->Step(-1, data))
+    {
+      // Start of the log, catch up with the decoded frames.
+      this->dataPtr->Resume();
+      return nullptr;
+    }
+    --this->dataPtr->decoded;
+  }
+
+  auto frame = this->dataPtr->Parse(data);
+
+  // The cache now starts at the new frame. If it has to be trimmed, the
+  // queued frames no longer follow it and are dropped.
+  cache.push_front(frame);
+  --this->dataPtr->current;
+  this->dataPtr->cacheStart = this->dataPtr->current;
+  if (cache.size() > this->dataPtr->cacheSize)
+  {
+    cache.resize(this->dataPtr->cacheSize);
+    this->dataPtr->queue.clear();
+    this->dataPtr->endOfLog = false;
+  }
+
+  return frame;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<WorldState> LogPlayPipeline::Step(const int _step)
+{
+  std::shared_ptr<WorldState> result;
+  for (int i = 0; i < std::abs(_step); ++i)
+  {
+    auto frame = _step > 0 ? this->Next() : this->Previous();
+    if (!frame)
+      break;
+    result = frame;
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipeline::Reposition(const std::function<void()> &_move)
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Pause(lock);
+  _move();
+  this->dataPtr->Reset();
+}
+
+//////////////////////////////////////////////////
+size_t LogPlayPipeline::QueuedFrames() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->queue.size();
+}
+
+//////////////////////////////////////////////////
+size_t LogPlayPipeline::CachedFrames() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cache.size();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<WorldState> LogPlayPipelinePrivate::Parse(
+    const std::string &_data)
+{
+  GZ_PROFILE_SCOPE("LogPlayPipeline::Parse");
+
+  this->stateSdf->Clear();
+  sdf::readString(_data, this->stateSdf);
+
+  auto state = std::make_shared<WorldState>();
+  state->Load(this->stateSdf);
+  return state;
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipelinePrivate::Pause(std::unique_lock<std::mutex> &_lock)
+{
+  this->paused = true;
+  this->readyCondition.wait(_lock, [this]() {return !this->busy;});
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipelinePrivate::Resume()
+{
+  // The decoding thread continues after the last known frame.
+  int64_t last = this->cache.empty() ? this->current :
+    this->cacheStart + static_cast<int64_t>(this->cache.size()) - 1;
+  last += static_cast<int64_t>(this->queue.size());
+
+  std::string data;
+  while (this->decoded < last)
+  {
+    if (!util::LogPlay::Instance()->Step(data))
+    {
+      this->endOfLog = true;
+      break;
+    }
+    ++this->decoded;
+  }
+
+  this->paused = false;
+  this->decodeCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipelinePrivate::Reset()
+{
+  this->queue.clear();
+  this->cache.clear();
+  this->cacheStart = 0;
+  this->current = 0;
+  this->decoded = 0;
+  this->endOfLog = false;
+  this->paused = false;
+  this->decodeCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+void LogPlayPipelinePrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->decodeCondition.wait(lock, [this]()
+        {
+          return this->stop || (!this->paused && !this->endOfLog &&
+              this->queue.size() < this->queueSize);
+        });
+
+    if (this->stop)
+      break;
+
+    // Decompress and parse without holding the lock
+    this->busy = true;
+    lock.unlock();
+
+    std::shared_ptr<WorldState> frame;
+    std::string data;
+    if (util::LogPlay::Instance()->Step(data))
+      frame = this->Parse(data);
+
+    lock.lock();
+    this->busy = false;
+
+    if (frame)
+    {
+      this->queue.push_back(frame);
+      ++this->decoded;
+    }
+    else
+      this->endOfLog = true;
+
+    this->readyCondition.notify_all();
+  }
+}
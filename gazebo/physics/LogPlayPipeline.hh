@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_LOGPLAYPIPELINE_HH_
+#define GAZEBO_PHYSICS_LOGPLAYPIPELINE_HH_
+
+#include <functional>
+#include <memory>
+
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class LogPlayPipelinePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class LogPlayPipeline LogPlayPipeline.hh physics/physics.hh
+    /// \brief Decodes the frames of the open log file ahead of playback.
+    ///
+    /// A background thread steps through util::LogPlay, which decompresses
+    /// chunks, and parses each frame into a WorldState, up to a bounded
+    /// number of frames ahead. Frames which have been played are kept in a
+    /// small cache, so stepping backwards doesn't decode them again.
+    /// Stepping back past the cache moves the log back one frame at a time,
+    /// and decoding resumes once the cached frames have been replayed.
+    ///
+    /// While the pipeline is running, the position in the log must only be
+    /// changed through Reposition.
+    class GZ_PHYSICS_VISIBLE LogPlayPipeline
+    {
+      /// \brief Constructor.
+      /// \param[in] _queueSize Maximum number of frames decoded ahead.
+      /// \param[in] _cacheSize Number of played frames kept for stepping
+      /// backwards.
+      public: explicit LogPlayPipeline(const size_t _queueSize = 64,
+                  const size_t _cacheSize = 256);
+
+      /// \brief Destructor. Stops the decoding thread.
+      public: ~LogPlayPipeline();
+
+      /// \brief Start decoding from the current position in the log.
+      public: void Start();
+
+      /// \brief Stop the decoding thread. The position in the log is ahead
+      /// of the last frame returned.
+      public: void Stop();
+
+      /// \brief Get the next frame, waiting for it to be decoded if needed.
+      /// \return The frame, or null at the end of the log.
+      public: std::shared_ptr<WorldState> Next();
+
+      /// \brief Get the frame before the current one.
+      /// \return The frame, or null at the start of the log.
+      public: std::shared_ptr<WorldState> Previous();
+
+      /// \brief Step forward or backward.
+      /// \param[in] _step Number of frames, negative to step backward.
+      /// \return The last frame reached, or null if no step could be made.
+      public: std::shared_ptr<WorldState> Step(const int _step);
+
+      /// \brief Move to a new position in the log. Decoding is paused while
+      /// the function runs, and the decoded frames are discarded.
+      /// \param[in] _move Function which moves util::LogPlay, such as a call
+      /// to Seek, Rewind or Forward.
+      public: void Reposition(const std::function<void()> &_move);
+
+      /// \brief Get the number of frames decoded ahead.
+      /// \return Number of frames.
+      public: size_t QueuedFrames() const;
+
+      /// \brief Get the number of played frames in the cache.
+      /// \return Number of frames.
+      public: size_t CachedFrames() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<LogPlayPipelinePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_LOGPLAYPIPELINEPRIVATE_HH_
+#define GAZEBO_PHYSICS_LOGPLAYPIPELINEPRIVATE_HH_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sdf/sdf.hh>
+
+#include "gazebo/physics/WorldState.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the LogPlayPipeline class.
+    ///
+    /// Frames are numbered in the order of the log, relative to the
+    /// position of the log when the pipeline was started or repositioned,
+    /// which is frame 0. The played frames in the cache are consecutive,
+    /// and are followed by the queued frames.
+    class LogPlayPipelinePrivate
+    {
+      /// \brief Parse a frame. Only called by the thread which owns
+      /// stateSdf: the decoding thread, or the player while decoding is
+      /// paused.
+      /// \param[in] _data Frame from the log.
+      /// \return The state.
+      public: std::shared_ptr<WorldState> Parse(const std::string &_data);
+
+      /// \brief Pause the decoding thread, and wait for it to be idle.
+      /// \param[in] _lock Lock on mutex.
+      public: void Pause(std::unique_lock<std::mutex> &_lock);
+
+      /// \brief Move the log forward to the last known frame, which may be
+      /// behind after stepping backwards, and resume decoding. Called with
+      /// the mutex locked and decoding paused.
+      public: void Resume();
+
+      /// \brief Discard all frames, and resume decoding from frame 0.
+      public: void Reset();
+
+      /// \brief Function run by the decoding thread.
+      public: void Run();
+
+      /// \brief Maximum number of frames decoded ahead.
+      public: size_t queueSize;
+
+      /// \brief Maximum number of played frames in the cache.
+      public: size_t cacheSize;
+
+      /// \brief Decoded frames waiting to be played, in order.
+      public: std::deque<std::shared_ptr<WorldState>> queue;
+
+      /// \brief Played frames, in order.
+      public: std::deque<std::shared_ptr<WorldState>> cache;
+
+      /// \brief Number of the first frame in the cache.
+      public: int64_t cacheStart = 0;
+
+      /// \brief Number of the current frame.
+      public: int64_t current = 0;
+
+      /// \brief Number of the last frame read from the log.
+      public: int64_t decoded = 0;
+
+      /// \brief True once the end of the log has been reached.
+      public: bool endOfLog = false;
+
+      /// \brief True while decoding is paused.
+      public: bool paused = false;
+
+      /// \brief True while the decoding thread reads the log.
+      public: bool busy = false;
+
+      /// \brief True to stop the decoding thread.
+      public: bool stop = true;
+
+      /// \brief Protects all the members above.
+      public: mutable std::mutex mutex;
+
+      /// \brief Wakes up the decoding thread.
+      public: std::condition_variable decodeCondition;
+
+      /// \brief Signaled when a frame has been decoded or the decoding
+      /// thread went idle.
+      public: std::condition_variable readyCondition;
+
+      /// \brief SDF element used to parse frames.
+      public: sdf::ElementPtr stateSdf;
+
+      /// \brief Decoding thread.
+      public: std::thread thread;
+    };
+  }
+}
+#endif
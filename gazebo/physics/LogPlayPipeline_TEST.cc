@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/LogPlayPipeline.hh"
+#include "gazebo/util/LogPlay.hh"
+#include "test_config.h"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class LogPlayPipelineTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Open the test log, and read the sim times of all its frames
+  /// without the pipeline.
+  /// \return Sim times in the order of the log.
+  protected: std::vector<common::Time> OpenLog()
+  {
+    boost::filesystem::path logFilePath(TEST_PATH);
+    logFilePath /= boost::filesystem::path("logs");
+    logFilePath /= boost::filesystem::path("state.log");
+
+    util::LogPlay *player = util::LogPlay::Instance();
+    EXPECT_NO_THROW(player->Open(logFilePath.string()));
+
+    sdf::ElementPtr stateSdf(new sdf::Element);
+    sdf::initFile("state.sdf", stateSdf);
+
+    std::vector<common::Time> times;
+    std::string data;
+    EXPECT_TRUE(player->Rewind());
+    while (player->Step(data))
+    {
+      stateSdf->Clear();
+      sdf::readString(data, stateSdf);
+      physics::WorldState state;
+      state.Load(stateSdf);
+      times.push_back(state.GetSimTime());
+    }
+    EXPECT_TRUE(player->Rewind());
+
+    return times;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(LogPlayPipelineTest, Forward)
+{
+  auto expected = this->OpenLog();
+  ASSERT_GT(expected.size(), 10u);
+
+  physics::LogPlayPipeline pipeline(4, 8);
+  pipeline.Start();
+
+  for (auto const &time : expected)
+  {
+    auto state = pipeline.Next();
+    ASSERT_NE(nullptr, state);
+    EXPECT_EQ(time, state->GetSimTime());
+    EXPECT_LE(pipeline.QueuedFrames(), 4u);
+    EXPECT_LE(pipeline.CachedFrames(), 8u);
+  }
+
+  EXPECT_EQ(nullptr, pipeline.Next());
+  pipeline.Stop();
+}
+
+/////////////////////////////////////////////////
+TEST_F(LogPlayPipelineTest, Backward)
+{
+  auto expected = this->OpenLog();
+  ASSERT_GT(expected.size(), 20u);
+
+  // The cache is smaller than the number of frames stepped back, which
+  // exercises stepping back through the log.
+  physics::LogPlayPipeline pipeline(4, 5);
+  pipeline.Start();
+
+  auto state = pipeline.Step(20);
+  ASSERT_NE(nullptr, state);
+  EXPECT_EQ(expected[19], state->GetSimTime());
+
+  for (int i = 18; i >= 5; --i)
+  {
+    state = pipeline.Previous();
+    ASSERT_NE(nullptr, state);
+    EXPECT_EQ(expected[i], state->GetSimTime());
+  }
+
+  // Replay the cache, then decode past it again
+  for (size_t i = 6; i < 25; ++i)
+  {
+    state = pipeline.Next();
+    ASSERT_NE(nullptr, state);
+    EXPECT_EQ(expected[i], state->GetSimTime());
+  }
+
+  // Back to the first frame, and no further
+  state = pipeline.Step(-24);
+  ASSERT_NE(nullptr, state);
+  EXPECT_EQ(expected[0], state->GetSimTime());
+  EXPECT_EQ(nullptr, pipeline.Previous());
+
+  state = pipeline.Next();
+  ASSERT_NE(nullptr, state);
+  EXPECT_EQ(expected[1], state->GetSimTime());
+
+  pipeline.Stop();
+}
+
+/////////////////////////////////////////////////
+TEST_F(LogPlayPipelineTest, Reposition)
+{
+  auto expected = this->OpenLog();
+  ASSERT_GT(expected.size(), 10u);
+
+  physics::LogPlayPipeline pipeline;
+  pipeline.Start();
+
+  auto state = pipeline.Step(10);
+  ASSERT_NE(nullptr, state);
+  EXPECT_EQ(expected[9], state->GetSimTime());
+
+  pipeline.Reposition([]()
+      {
+        util::LogPlay::Instance()->Rewind();
+      });
+  EXPECT_EQ(0u, pipeline.CachedFrames());
+
+  state = pipeline.Next();
+  ASSERT_NE(nullptr, state);
+  EXPECT_EQ(expected[0], state->GetSimTime());
+
+  pipeline.Stop();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -354,9 +354,10 @@ void Model::Update()
 
   boost::recursive_mutex::scoped_lock lock(this->updateMutex);
 
-  for (Joint_V::iterator jiter = this->joints.begin();
-       jiter != this->joints.end(); ++jiter)
-    (*jiter)->Update();
+  // Joint::Update is final, so these calls aren't virtual, and joints
+  // without update connections return right away
+  for (auto const &joint : this->joints)
+    joint->Update();
 
   if (this->jointController)
     this->jointController->Update();
@@ -417,6 +418,219 @@ void Model::SetJointPositions(
     this->jointController->SetJointPositions(_jointPositions);
 }
 
+//////////////////////////////////////////////////
+void Model::UpdateJointStateLayout() const
+{
+  bool changed = this->jointStateJoints.size() != this->joints.size();
+  for (size_t i = 0; !changed && i < this->joints.size(); ++i)
+    changed = this->jointStateJoints[i] != this->joints[i];
+
+  if (!changed && !this->jointStateOffsets.empty())
+    return;
+
+  this->jointStateJoints.clear();
+  this->jointStateOffsets.clear();
+  unsigned int size = 0;
+  for (auto const &joint : this->joints)
+  {
+    this->jointStateJoints.push_back(joint);
+    this->jointStateOffsets.push_back(size);
+    size += joint->DOF();
+  }
+  this->jointStateOffsets.push_back(size);
+
+  this->jointStatePositions.assign(size, 0.0);
+  this->jointStateVelocities.assign(size, 0.0);
+  this->jointStateForces.assign(size, 0.0);
+  this->jointStatesStale = true;
+}
+
+//////////////////////////////////////////////////
+void Model::ReadJointStates() const
+{
+  this->UpdateJointStateLayout();
+
+  // Cleared first, so that a joint set during the read marks the buffers
+  // stale again
+  const bool states = this->jointStatesStale.exchange(false);
+  const bool forces = this->jointForcesStale.exchange(false) || states;
+  if (!forces)
+    return;
+
+  for (size_t i = 0; i < this->jointStateJoints.size(); ++i)
+  {
+    Joint &joint = *this->jointStateJoints[i];
+    const unsigned int offset = this->jointStateOffsets[i];
+    const unsigned int dof = this->jointStateOffsets[i + 1] - offset;
+    for (unsigned int axis = 0; axis < dof; ++axis)
+    {
+      if (states)
+      {
+        this->jointStatePositions[offset + axis] = joint.Position(axis);
+        this->jointStateVelocities[offset + axis] = joint.GetVelocity(axis);
+      }
+      this->jointStateForces[offset + axis] = joint.GetForce(axis);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Model::UpdateJointStates()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->jointStateMutex);
+    this->jointStatesStale = true;
+    this->ReadJointStates();
+  }
+
+  for (auto &model : this->models)
+    model->UpdateJointStates();
+}
+
+//////////////////////////////////////////////////
+void Model::MarkJointStatesStale()
+{
+  this->jointStatesStale = true;
+}
+
+//////////////////////////////////////////////////
+void Model::MarkJointForcesStale()
+{
+  this->jointForcesStale = true;
+}
+
+//////////////////////////////////////////////////
+bool Model::CheckJointStateSize(const size_t _size) const
+{
+  this->UpdateJointStateLayout();
+  if (_size != this->jointStateOffsets.back())
+  {
+    gzerr << "Model [" << this->GetScopedName() << "] has "
+          << this->jointStateOffsets.back() << " joint axes, "
+          << _size << " values given" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+unsigned int Model::JointStateSize() const
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  this->UpdateJointStateLayout();
+  return this->jointStateOffsets.back();
+}
+
+//////////////////////////////////////////////////
+int Model::JointStateIndex(const std::string &_jointName,
+    const unsigned int _axis) const
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  this->UpdateJointStateLayout();
+  for (size_t i = 0; i < this->jointStateJoints.size(); ++i)
+  {
+    const JointPtr &joint = this->jointStateJoints[i];
+    if (joint->GetScopedName() == _jointName ||
+        joint->GetName() == _jointName)
+    {
+      unsigned int offset = this->jointStateOffsets[i];
+      if (offset + _axis >= this->jointStateOffsets[i + 1])
+        return -1;
+      return static_cast<int>(offset + _axis);
+    }
+  }
+  return -1;
+}
+
+//////////////////////////////////////////////////
+void Model::JointPositions(std::vector<double> &_positions) const
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  this->ReadJointStates();
+  _positions = this->jointStatePositions;
+}
+
+//////////////////////////////////////////////////
+void Model::JointVelocities(std::vector<double> &_velocities) const
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  this->ReadJointStates();
+  _velocities = this->jointStateVelocities;
+}
+
+//////////////////////////////////////////////////
+void Model::JointForces(std::vector<double> &_forces) const
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  this->ReadJointStates();
+  _forces = this->jointStateForces;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointPositions(const std::vector<double> &_positions)
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  if (!this->CheckJointStateSize(_positions.size()))
+    return false;
+
+  for (size_t i = 0; i < this->jointStateJoints.size(); ++i)
+  {
+    const JointPtr &joint = this->jointStateJoints[i];
+    for (unsigned int index = this->jointStateOffsets[i];
+         index < this->jointStateOffsets[i + 1]; ++index)
+    {
+      joint->SetPosition(index - this->jointStateOffsets[i],
+          _positions[index]);
+    }
+  }
+
+  this->jointStatesStale = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointVelocities(const std::vector<double> &_velocities)
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  if (!this->CheckJointStateSize(_velocities.size()))
+    return false;
+
+  for (size_t i = 0; i < this->jointStateJoints.size(); ++i)
+  {
+    const JointPtr &joint = this->jointStateJoints[i];
+    for (unsigned int index = this->jointStateOffsets[i];
+         index < this->jointStateOffsets[i + 1]; ++index)
+    {
+      joint->SetVelocity(index - this->jointStateOffsets[i],
+          _velocities[index]);
+    }
+  }
+
+  this->jointStatesStale = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Model::SetJointForces(const std::vector<double> &_forces)
+{
+  std::lock_guard<std::mutex> lock(this->jointStateMutex);
+  if (!this->CheckJointStateSize(_forces.size()))
+    return false;
+
+  for (size_t i = 0; i < this->jointStateJoints.size(); ++i)
+  {
+    const JointPtr &joint = this->jointStateJoints[i];
+    for (unsigned int index = this->jointStateOffsets[i];
+         index < this->jointStateOffsets[i + 1]; ++index)
+    {
+      joint->SetForce(index - this->jointStateOffsets[i], _forces[index]);
+    }
+  }
+
+  this->jointForcesStale = true;
+  return true;
+}
+
 //////////////////////////////////////////////////
 void Model::RemoveChild(EntityPtr _child)
 {
@@ -494,6 +708,11 @@ void Model::Fini()
   }
   this->joints.clear();
   this->jointController.reset();
+  {
+    std::lock_guard<std::mutex> lock(this->jointStateMutex);
+    this->jointStateJoints.clear();
+    this->jointStateOffsets.clear();
+  }
 
   // Destroy all links
   for (auto &link : this->links)
@@ -704,6 +923,7 @@ void Model::Reset()
   {
     (*jiter)->Reset();
   }
+  this->MarkJointStatesStale();
 
   // Reset plugins after links and joints,
   // so that plugins can restore initial conditions
@@ -1128,12 +1348,22 @@ void Model::LoadPlugin(sdf::ElementPtr _sdf)
 
     ModelPtr myself = boost::static_pointer_cast<Model>(shared_from_this());
 
+    // The world update connections made by the plugin are named after it,
+    // and run concurrently if the plugin only touches its own model
+    event::ConnectionOptions options;
+    options.name = pluginName;
+    options.concurrent = _sdf->HasElement("concurrent") &&
+        _sdf->Get<bool>("concurrent");
+    event::Events::SetWorldUpdateBeginOptions(options);
+
     try
     {
       plugin->Load(myself, _sdf);
+      event::Events::SetWorldUpdateBeginOptions(event::ConnectionOptions());
     }
     catch(...)
     {
+      event::Events::SetWorldUpdateBeginOptions(event::ConnectionOptions());
       gzerr << "Exception occured in the Load function of plugin with name["
         << pluginName << "] and filename[" << filename << "]. "
         << "This plugin will not run.\n";
@@ -1375,6 +1605,9 @@ void Model::SetState(const ModelState &_state)
       gzerr << "Unable to find model[" << ms.first << "]\n";
   }
 
+  // Links moved, and joints with them
+  this->MarkJointStatesStale();
+
   // For now we don't use the joint state values to set the state of
   // simulation.
   // for (unsigned int i = 0; i < _state.GetJointStateCount(); ++i)
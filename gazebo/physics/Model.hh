@@ -19,6 +19,7 @@
 
 #include <string>
 #include <map>
+#include <atomic>
 #include <mutex>
 #include <vector>
 #include <boost/function.hpp>
@@ -262,6 +263,67 @@ namespace gazebo
       public: void SetJointPositions(
                   const std::map<std::string, double> &_jointPositions);
 
+      /// \brief Get the number of values in the joint state buffers, which
+      /// is the sum of the DOF of the joints of this model, nested models
+      /// excluded. Values are ordered as GetJoints, one per axis.
+      /// \return Number of joint axes.
+      public: unsigned int JointStateSize() const;
+
+      /// \brief Get the index of a joint axis in the joint state buffers.
+      /// \param[in] _jointName Name or scoped name of the joint.
+      /// \param[in] _axis Axis of the joint.
+      /// \return Index of the axis, -1 if not found.
+      public: int JointStateIndex(const std::string &_jointName,
+                  const unsigned int _axis = 0) const;
+
+      /// \brief Get the positions of all the joint axes at once, copied
+      /// from the joint state buffers. The buffers are filled right after
+      /// each physics step, and read again from the physics engine only if
+      /// a joint was set since.
+      /// \param[out] _positions Positions, see JointStateIndex.
+      public: void JointPositions(std::vector<double> &_positions) const;
+
+      /// \brief Get the velocities of all the joint axes at once.
+      /// \sa JointPositions
+      /// \param[out] _velocities Velocities, see JointStateIndex.
+      public: void JointVelocities(std::vector<double> &_velocities) const;
+
+      /// \brief Get the forces applied to all the joint axes at once.
+      /// \sa JointPositions
+      /// \param[out] _forces Forces, see JointStateIndex.
+      public: void JointForces(std::vector<double> &_forces) const;
+
+      /// \brief Set the positions of all the joint axes at once.
+      /// \param[in] _positions Positions, see JointStateIndex.
+      /// \return False if the size doesn't match JointStateSize.
+      public: bool SetJointPositions(const std::vector<double> &_positions);
+
+      /// \brief Set the velocities of all the joint axes at once.
+      /// \param[in] _velocities Velocities, see JointStateIndex.
+      /// \return False if the size doesn't match JointStateSize.
+      public: bool SetJointVelocities(const std::vector<double> &_velocities);
+
+      /// \brief Set the forces of all the joint axes at once, for the next
+      /// step.
+      /// \param[in] _forces Forces, see JointStateIndex.
+      /// \return False if the size doesn't match JointStateSize.
+      public: bool SetJointForces(const std::vector<double> &_forces);
+
+      /// \brief Fill the joint state buffers of this model and of its
+      /// nested models from the physics engine, in a single pass over the
+      /// joints. Called by the world right after each physics step.
+      public: void UpdateJointStates();
+
+      /// \brief Mark the joint state buffers as stale, so that they are
+      /// read again from the physics engine when queried. Called when the
+      /// position or velocity of a joint is set, and on reset.
+      public: void MarkJointStatesStale();
+
+      /// \brief Mark only the joint force buffer as stale. Called when a
+      /// force is applied to a joint, which doesn't change the positions
+      /// and velocities before the next step.
+      public: void MarkJointForcesStale();
+
       /// \brief Joint Animation.
       /// \param[in] _anim Map of joint names to their position animation.
       /// \param[in] _onComplete Callback function for when the animation
@@ -483,6 +545,19 @@ namespace gazebo
       /// \brief Register items in the introspection service.
       protected: virtual void RegisterIntrospectionItems() override;
 
+      /// \brief Lay out the joint state buffers again if the joints
+      /// changed. Must be called with jointStateMutex locked.
+      private: void UpdateJointStateLayout() const;
+
+      /// \brief Read the joint state buffers from the physics engine if
+      /// they are stale. Must be called with jointStateMutex locked.
+      private: void ReadJointStates() const;
+
+      /// \brief Check a buffer passed to a bulk joint setter.
+      /// \param[in] _size Size of the buffer.
+      /// \return True if the size matches JointStateSize.
+      private: bool CheckJointStateSize(const size_t _size) const;
+
       /// \brief Load all the links.
       private: void LoadLinks();
 
@@ -552,6 +627,33 @@ namespace gazebo
       /// \brief Mutex to protect incoming message buffers.
       private: std::mutex receiveMutex;
 
+      /// \brief Joints whose axes are in the joint state buffers.
+      private: mutable Joint_V jointStateJoints;
+
+      /// \brief Index of the first axis of each joint in the joint state
+      /// buffers, plus the total size.
+      private: mutable std::vector<unsigned int> jointStateOffsets;
+
+      /// \brief Joint positions, one per axis.
+      private: mutable std::vector<double> jointStatePositions;
+
+      /// \brief Joint velocities, one per axis.
+      private: mutable std::vector<double> jointStateVelocities;
+
+      /// \brief Joint forces, one per axis.
+      private: mutable std::vector<double> jointStateForces;
+
+      /// \brief True if the joint state buffers must be read again. Set
+      /// without locking, since joint setters may be called by the bulk
+      /// setters with jointStateMutex locked.
+      private: mutable std::atomic<bool> jointStatesStale{true};
+
+      /// \brief True if the joint force buffer must be read again.
+      private: mutable std::atomic<bool> jointForcesStale{true};
+
+      /// \brief Protects the joint state buffers.
+      private: mutable std::mutex jointStateMutex;
+
       /// \brief SDF Model DOM object created by loading a model isolated from
       /// its world. This is used when a model is spawned without a world
       /// containing it.
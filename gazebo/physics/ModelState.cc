@@ -19,6 +19,7 @@
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/World.hh"
+#include "gazebo/physics/StateStream.hh"
 #include "gazebo/physics/ModelState.hh"
 
 using namespace gazebo;
@@ -610,6 +611,73 @@ void ModelState::FillSDF(sdf::ElementPtr _sdf)
   }
 }
 
+/////////////////////////////////////////////////
+void ModelState::Serialize(StateWriter &_writer) const
+{
+  _writer.WriteName(this->name);
+  _writer.WritePose(this->pose);
+  _writer.WriteVector3(this->scale);
+
+  _writer.WriteUInt(this->linkStates.size());
+  for (auto const &link : this->linkStates)
+    link.second.Serialize(_writer);
+
+  _writer.WriteUInt(this->jointStates.size());
+  for (auto const &joint : this->jointStates)
+    joint.second.Serialize(_writer);
+
+  _writer.WriteUInt(this->modelStates.size());
+  for (auto const &model : this->modelStates)
+    model.second.Serialize(_writer);
+}
+
+/////////////////////////////////////////////////
+bool ModelState::Deserialize(StateReader &_reader)
+{
+  if (!_reader.ReadName(this->name) || !_reader.ReadPose(this->pose) ||
+      !_reader.ReadVector3(this->scale))
+  {
+    return false;
+  }
+
+  uint64_t count;
+
+  this->linkStates.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    LinkState linkState;
+    if (!linkState.Deserialize(_reader))
+      return false;
+    this->linkStates.insert(std::make_pair(linkState.GetName(), linkState));
+  }
+
+  this->jointStates.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    JointState jointState;
+    if (!jointState.Deserialize(_reader))
+      return false;
+    this->jointStates.insert(std::make_pair(jointState.GetName(), jointState));
+  }
+
+  this->modelStates.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    ModelState modelState;
+    if (!modelState.Deserialize(_reader))
+      return false;
+    this->modelStates.insert(std::make_pair(modelState.GetName(), modelState));
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void ModelState::SetWallTime(const common::Time &_time)
 {
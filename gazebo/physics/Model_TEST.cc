@@ -19,9 +19,11 @@
 
 #include "gazebo/test/ServerFixture.hh"
 #include "test/util.hh"
+#include "gazebo/common/PID.hh"
 #include "gazebo/common/URI.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Model.hh"
+#include "gazebo/physics/JointController.hh"
 
 using namespace gazebo;
 
@@ -242,6 +244,159 @@ TEST_F(ModelTest, BoundingBox)
       model->BoundingBox());
 }
 
+//////////////////////////////////////////////////
+TEST_F(ModelTest, JointStateBuffers)
+{
+  this->Load("worlds/simple_arm_test.world", true);
+
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+
+  const physics::Joint_V &joints = model->GetJoints();
+  unsigned int size = 0;
+  for (auto const &joint : joints)
+    size += joint->DOF();
+  ASSERT_GT(size, 0u);
+  EXPECT_EQ(size, model->JointStateSize());
+
+  int index = model->JointStateIndex("arm_elbow_pan_joint");
+  ASSERT_GE(index, 0);
+  EXPECT_EQ(index,
+      model->JointStateIndex("simple_arm::arm_elbow_pan_joint", 0));
+  EXPECT_EQ(-1, model->JointStateIndex("arm_elbow_pan_joint", 1));
+  EXPECT_EQ(-1, model->JointStateIndex("no_such_joint"));
+
+  // Wrong sizes are rejected
+  EXPECT_FALSE(model->SetJointPositions(std::vector<double>(size + 1)));
+  EXPECT_FALSE(model->SetJointVelocities(std::vector<double>()));
+
+  std::vector<double> positions(size, 0.0);
+  positions[index] = 0.3;
+  EXPECT_TRUE(model->SetJointPositions(positions));
+
+  std::vector<double> forces(size, 0.0);
+  forces[index] = 1.5;
+  EXPECT_TRUE(model->SetJointForces(forces));
+
+  world->Step(1);
+
+  // The buffers match the per-joint queries
+  std::vector<double> bulkPositions, bulkVelocities, bulkForces;
+  model->JointPositions(bulkPositions);
+  model->JointVelocities(bulkVelocities);
+  model->JointForces(bulkForces);
+  ASSERT_EQ(size, bulkPositions.size());
+  ASSERT_EQ(size, bulkVelocities.size());
+  ASSERT_EQ(size, bulkForces.size());
+
+  for (auto const &joint : joints)
+  {
+    for (unsigned int axis = 0; axis < joint->DOF(); ++axis)
+    {
+      int i = model->JointStateIndex(joint->GetName(), axis);
+      ASSERT_GE(i, 0);
+      EXPECT_DOUBLE_EQ(joint->Position(axis), bulkPositions[i]);
+      EXPECT_DOUBLE_EQ(joint->GetVelocity(axis), bulkVelocities[i]);
+      EXPECT_DOUBLE_EQ(joint->GetForce(axis), bulkForces[i]);
+    }
+  }
+  EXPECT_NEAR(0.3, bulkPositions[index], 0.01);
+
+  // Setting velocities is visible without a step
+  std::vector<double> velocities(size, 0.0);
+  velocities[index] = -0.2;
+  EXPECT_TRUE(model->SetJointVelocities(velocities));
+  model->JointVelocities(bulkVelocities);
+  EXPECT_NEAR(-0.2, bulkVelocities[index], 1e-6);
+}
+
+//////////////////////////////////////////////////
+TEST_F(ModelTest, JointStateBuffersPaused)
+{
+  this->Load("worlds/simple_arm_test.world", true);
+
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+
+  auto joint = model->GetJoint("arm_elbow_pan_joint");
+  ASSERT_TRUE(joint != nullptr);
+  int index = model->JointStateIndex("arm_elbow_pan_joint");
+  ASSERT_GE(index, 0);
+
+  std::vector<double> positions;
+  model->JointPositions(positions);
+  ASSERT_GT(positions.size(), static_cast<size_t>(index));
+  EXPECT_NEAR(0.0, positions[index], 1e-6);
+
+  // Changes made through the joint are seen while the world is paused
+  EXPECT_TRUE(joint->SetPosition(0, 0.4));
+  model->JointPositions(positions);
+  EXPECT_NEAR(0.4, positions[index], 1e-6);
+
+  joint->SetForce(0, 2.0);
+  std::vector<double> forces;
+  model->JointForces(forces);
+  EXPECT_DOUBLE_EQ(joint->GetForce(0), forces[index]);
+
+  // and after a reset
+  world->Step(1);
+  world->Reset();
+  model->JointPositions(positions);
+  EXPECT_NEAR(joint->Position(0), positions[index], 1e-6);
+  EXPECT_NEAR(0.0, positions[index], 1e-6);
+}
+
+//////////////////////////////////////////////////
+TEST_F(ModelTest, JointStateBuffersController)
+{
+  this->Load("worlds/simple_arm_test.world", true);
+
+  auto world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  auto model = world->ModelByName("simple_arm");
+  ASSERT_TRUE(model != nullptr);
+
+  auto joint = model->GetJoint("arm_elbow_pan_joint");
+  ASSERT_TRUE(joint != nullptr);
+  int index = model->JointStateIndex("arm_elbow_pan_joint");
+  ASSERT_GE(index, 0);
+
+  // The position PID reads the buffers, filled after each step
+  auto controller = model->GetJointController();
+  ASSERT_TRUE(controller != nullptr);
+  controller->SetPositionPID(joint->GetScopedName(),
+      common::PID(20, 0, 2, 0, 0, 100, -100));
+  EXPECT_TRUE(controller->SetPositionTarget(joint->GetScopedName(), 0.5));
+
+  std::vector<double> positions;
+  world->Step(2000);
+  model->JointPositions(positions);
+  EXPECT_DOUBLE_EQ(joint->Position(0), positions[index]);
+  EXPECT_NEAR(0.5, positions[index], 0.05);
+
+  // A new target takes effect without a lookup per step
+  EXPECT_TRUE(controller->SetPositionTarget(joint->GetScopedName(), -0.5));
+  world->Step(2000);
+  model->JointPositions(positions);
+  EXPECT_NEAR(-0.5, positions[index], 0.05);
+
+  // A force applied through the joint only refreshes the forces
+  controller->Reset();
+  joint->SetForce(0, 3.0);
+  std::vector<double> forces;
+  model->JointForces(forces);
+  EXPECT_DOUBLE_EQ(joint->GetForce(0), forces[index]);
+  model->JointPositions(positions);
+  EXPECT_DOUBLE_EQ(joint->Position(0), positions[index]);
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
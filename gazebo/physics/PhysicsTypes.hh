@@ -39,6 +39,9 @@ namespace gazebo
     class World;
     class Model;
     class Actor;
+    class ActorCrowd;
+    class SpatialIndex;
+    class Hydrodynamics;
     class Light;
     class Link;
     class Collision;
@@ -47,6 +50,7 @@ namespace gazebo
     class Joint;
     class JointController;
     class Contact;
+    class ContactSubscription;
     class PresetManager;
     class UserCmd;
     class UserCmdManager;
@@ -71,6 +75,8 @@ namespace gazebo
     class LightState;
     class LinkState;
     class JointState;
+    class StateReader;
+    class StateWriter;
     class TrajectoryInfo;
 
     /// \def BasePtr
@@ -81,6 +87,10 @@ namespace gazebo
     /// \brief Boost shared pointer to a Contact object
     typedef boost::shared_ptr<Contact> ContactPtr;
 
+    /// \def ContactSubscriptionPtr
+    /// \brief Shared pointer to a ContactSubscription object
+    typedef std::shared_ptr<ContactSubscription> ContactSubscriptionPtr;
+
     /// \def EntityPtr
     /// \brief Boost shared pointer to an Entity object
     typedef boost::shared_ptr<Entity> EntityPtr;
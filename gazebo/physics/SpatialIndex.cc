@@ -0,0 +1,485 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include <ignition/math/Helpers.hh>
+
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/SpatialIndexPrivate.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Boxes with a coordinate larger than this are kept out of the
+/// tree, where they would make every surface area cost overflow.
+static const double kMaxExtent = 1e9;
+
+/////////////////////////////////////////////////
+/// \brief Get an empty box, as returned for entities without collisions.
+/// \return Box whose minimum is larger than its maximum.
+static ignition::math::AxisAlignedBox EmptyBox()
+{
+  ignition::math::AxisAlignedBox box;
+  box.Min().Set(ignition::math::MAX_D, ignition::math::MAX_D,
+      ignition::math::MAX_D);
+  box.Max().Set(-ignition::math::MAX_D, -ignition::math::MAX_D,
+      -ignition::math::MAX_D);
+  return box;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a box is empty, as returned for entities without
+/// collisions.
+/// \param[in] _box Box to check.
+/// \return True if a minimum is larger than the matching maximum.
+static bool IsEmpty(const ignition::math::AxisAlignedBox &_box)
+{
+  return !(_box.Min().X() <= _box.Max().X() &&
+           _box.Min().Y() <= _box.Max().Y() &&
+           _box.Min().Z() <= _box.Max().Z());
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a box is unbounded.
+/// \param[in] _box Box to check.
+/// \return True if a coordinate is infinite or very large.
+static bool IsUnbounded(const ignition::math::AxisAlignedBox &_box)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (!(std::abs(_box.Min()[i]) < kMaxExtent) ||
+        !(std::abs(_box.Max()[i]) < kMaxExtent))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if an entry passes a query filter.
+/// \param[in] _entry Entry to check.
+/// \param[in] _filter Types of entities requested.
+/// \return True if the entry has one of the requested types.
+static bool Accepts(const SpatialIndexEntry &_entry,
+    const SpatialIndex::EntityFilter _filter)
+{
+  return (_entry.model ? SpatialIndex::MODELS : SpatialIndex::LINKS) &
+      _filter;
+}
+
+/////////////////////////////////////////////////
+/// \brief Run a query on the tree and on the unbounded entries.
+/// \param[in] _data Index data.
+/// \param[in] _filter Types of entities to return.
+/// \param[in] _query Runs the tree query with a proxy callback.
+/// \param[in] _test Exact test of a candidate, using its box.
+/// \return Entities found, in insertion order.
+template<typename Q, typename T>
+static std::vector<EntityPtr> Collect(const SpatialIndexPrivate &_data,
+    const SpatialIndex::EntityFilter _filter, const Q &_query, const T &_test)
+{
+  std::vector<const SpatialIndexEntry *> found;
+  {
+    std::lock_guard<std::mutex> lock(_data.mutex);
+
+    auto accept = [&](const SpatialIndexEntry *_entry)
+    {
+      // Leaves are enlarged, so the tree only returns candidates
+      if (Accepts(*_entry, _filter) && _test(*_entry))
+        found.push_back(_entry);
+    };
+
+    _query([&](const int _proxy)
+        {
+          accept(static_cast<const SpatialIndexEntry *>(
+                _data.tree.UserData(_proxy)));
+          return true;
+        });
+
+    for (auto const entry : _data.unbounded)
+      accept(entry);
+
+    std::sort(found.begin(), found.end(),
+        [](const SpatialIndexEntry *_a, const SpatialIndexEntry *_b)
+        {
+          return _a->order < _b->order;
+        });
+  }
+
+  std::vector<EntityPtr> result;
+  result.reserve(found.size());
+  for (auto const entry : found)
+    result.push_back(entry->entity);
+  return result;
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::AddModel(const ModelPtr &_model)
+{
+  this->AddEntity(_model, nullptr);
+
+  for (auto const &link : _model->GetLinks())
+  {
+    if (link)
+      this->AddEntity(link, _model.get());
+  }
+
+  for (auto const &nested : _model->NestedModels())
+  {
+    if (nested)
+      this->AddModel(nested);
+  }
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::RemoveModel(const ModelPtr &_model)
+{
+  for (auto const &nested : _model->NestedModels())
+  {
+    if (nested)
+      this->RemoveModel(nested);
+  }
+
+  for (auto const &link : _model->GetLinks())
+  {
+    if (link)
+      this->RemoveEntity(link.get());
+  }
+
+  this->RemoveEntity(_model.get());
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::AddEntity(const EntityPtr &_entity,
+    const Entity *_parentModel)
+{
+  if (this->entries.find(_entity.get()) != this->entries.end())
+    return;
+
+  SpatialIndexEntry &entry = this->entries[_entity.get()];
+  entry.entity = _entity;
+  entry.model = _parentModel == nullptr;
+  entry.parentModel = _parentModel;
+  entry.order = this->nextOrder++;
+  entry.box = EmptyBox();
+  this->MarkEntry(entry);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::RemoveEntity(const Entity *_entity)
+{
+  auto iter = this->entries.find(_entity);
+  if (iter == this->entries.end())
+    return;
+
+  if (iter->second.proxy >= 0)
+    this->tree.Remove(iter->second.proxy);
+  this->unbounded.erase(&iter->second);
+  this->entries.erase(iter);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::MarkEntry(SpatialIndexEntry &_entry)
+{
+  if (!_entry.dirty)
+  {
+    _entry.dirty = true;
+    this->dirty.push_back(_entry.entity.get());
+  }
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::MarkModel(const Model &_model)
+{
+  auto iter = this->entries.find(&_model);
+  if (iter != this->entries.end())
+    this->MarkEntry(iter->second);
+
+  // Setting the pose of a model moves its links without setting theirs
+  for (auto const &link : _model.GetLinks())
+  {
+    iter = this->entries.find(link.get());
+    if (iter != this->entries.end())
+      this->MarkEntry(iter->second);
+  }
+
+  for (auto const &nested : _model.NestedModels())
+  {
+    if (nested)
+      this->MarkModel(*nested);
+  }
+}
+
+/////////////////////////////////////////////////
+void SpatialIndexPrivate::SetBox(SpatialIndexEntry &_entry,
+    const ignition::math::AxisAlignedBox &_box)
+{
+  _entry.box = _box;
+
+  const bool empty = IsEmpty(_box);
+  const bool unboundedBox = !empty && IsUnbounded(_box);
+
+  if ((empty || unboundedBox) && _entry.proxy >= 0)
+  {
+    this->tree.Remove(_entry.proxy);
+    _entry.proxy = -1;
+  }
+
+  if (unboundedBox != _entry.unbounded)
+  {
+    if (unboundedBox)
+      this->unbounded.insert(&_entry);
+    else
+      this->unbounded.erase(&_entry);
+    _entry.unbounded = unboundedBox;
+  }
+
+  if (empty || unboundedBox)
+    return;
+
+  if (_entry.proxy < 0)
+    _entry.proxy = this->tree.Insert(_box, &_entry);
+  else
+    this->tree.Move(_entry.proxy, _box);
+}
+
+/////////////////////////////////////////////////
+SpatialIndex::SpatialIndex()
+  : dataPtr(new SpatialIndexPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SpatialIndex::~SpatialIndex()
+{
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Add(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->AddModel(_model);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Remove(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->RemoveModel(_model);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->tree.Clear();
+  this->dataPtr->unbounded.clear();
+  this->dataPtr->dirty.clear();
+  this->dataPtr->entries.clear();
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::MarkDirty(const Entity *_entity)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+
+  auto iter = this->dataPtr->entries.find(_entity);
+  if (iter == this->dataPtr->entries.end())
+    return;
+
+  SpatialIndexEntry &entry = iter->second;
+  if (entry.model)
+  {
+    this->dataPtr->MarkModel(static_cast<const Model &>(*_entity));
+    return;
+  }
+
+  // The box of a model is the union of the boxes of its links
+  this->dataPtr->MarkEntry(entry);
+  iter = this->dataPtr->entries.find(entry.parentModel);
+  if (iter != this->dataPtr->entries.end())
+    this->dataPtr->MarkEntry(iter->second);
+}
+
+/////////////////////////////////////////////////
+void SpatialIndex::Refit()
+{
+  std::lock_guard<std::mutex> refitLock(this->dataPtr->refitMutex);
+
+  std::vector<EntityPtr> entities;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (auto const entity : this->dataPtr->dirty)
+    {
+      auto iter = this->dataPtr->entries.find(entity);
+      if (iter == this->dataPtr->entries.end() || !iter->second.dirty)
+        continue;
+
+      iter->second.dirty = false;
+      entities.push_back(iter->second.entity);
+    }
+    this->dataPtr->dirty.clear();
+  }
+
+  if (entities.empty())
+    return;
+
+  // Compute the boxes without blocking queries. Entities which move in the
+  // meantime are marked dirty again.
+  std::vector<ignition::math::AxisAlignedBox> boxes(entities.size());
+  for (size_t i = 0; i < entities.size(); ++i)
+    boxes[i] = entities[i]->BoundingBox();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (size_t i = 0; i < entities.size(); ++i)
+  {
+    auto iter = this->dataPtr->entries.find(entities[i].get());
+
+    // Skip entities removed during the computation
+    if (iter == this->dataPtr->entries.end() ||
+        iter->second.entity != entities[i])
+    {
+      continue;
+    }
+
+    this->dataPtr->SetBox(iter->second, boxes[i]);
+  }
+}
+
+/////////////////////////////////////////////////
+size_t SpatialIndex::Size() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+size_t SpatialIndex::DirtyCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  size_t count = 0;
+  for (auto const &entry : this->dataPtr->entries)
+  {
+    if (entry.second.dirty)
+      ++count;
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+ignition::math::AxisAlignedBox SpatialIndex::Box(const Entity *_entity) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto iter = this->dataPtr->entries.find(_entity);
+  if (iter == this->dataPtr->entries.end())
+  {
+    return EmptyBox();
+  }
+  return iter->second.box;
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::QueryBox(
+    const ignition::math::AxisAlignedBox &_box,
+    const EntityFilter _filter) const
+{
+  return Collect(*this->dataPtr, _filter,
+      [&](const BoxTree::QueryCallback &_callback)
+      {
+        this->dataPtr->tree.QueryBox(_box, _callback);
+      },
+      [&](const SpatialIndexEntry &_entry)
+      {
+        return _entry.box.Intersects(_box);
+      });
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::QuerySphere(
+    const ignition::math::Vector3d &_center, const double _radius,
+    const EntityFilter _filter) const
+{
+  return Collect(*this->dataPtr, _filter,
+      [&](const BoxTree::QueryCallback &_callback)
+      {
+        this->dataPtr->tree.QuerySphere(_center, _radius, _callback);
+      },
+      [&](const SpatialIndexEntry &_entry)
+      {
+        return BoxTree::SphereOverlaps(_entry.box, _center, _radius);
+      });
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::QueryRay(
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_dir, const double _maxDist,
+    const EntityFilter _filter) const
+{
+  // Distance to each entity found, by entity
+  std::unordered_map<const Entity *, double> dists;
+
+  auto result = Collect(*this->dataPtr, _filter,
+      [&](const BoxTree::QueryCallback &_callback)
+      {
+        this->dataPtr->tree.QueryRay(_origin, _dir, _maxDist, _callback);
+      },
+      [&](const SpatialIndexEntry &_entry)
+      {
+        double dist;
+        if (!BoxTree::RayDistance(_entry.box, _origin, _dir, _maxDist, dist))
+          return false;
+        dists[_entry.entity.get()] = dist;
+        return true;
+      });
+
+  // Stable, so that entities at the same distance stay in insertion order
+  std::stable_sort(result.begin(), result.end(),
+      [&](const EntityPtr &_a, const EntityPtr &_b)
+      {
+        return dists[_a.get()] < dists[_b.get()];
+      });
+  return result;
+}
+
+/////////////////////////////////////////////////
+std::vector<EntityPtr> SpatialIndex::QueryFrustum(
+    const ignition::math::Frustum &_frustum,
+    const EntityFilter _filter) const
+{
+  return Collect(*this->dataPtr, _filter,
+      [&](const BoxTree::QueryCallback &_callback)
+      {
+        this->dataPtr->tree.QueryFrustum(_frustum, _callback);
+      },
+      [&](const SpatialIndexEntry &_entry)
+      {
+        return _frustum.Contains(_entry.box);
+      });
+}
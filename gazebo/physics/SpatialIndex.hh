@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEX_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEX_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class SpatialIndexPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SpatialIndex SpatialIndex.hh physics/physics.hh
+    /// \brief Index of the bounding boxes of the models and links of a
+    /// world, used to answer spatial queries without visiting every model.
+    ///
+    /// The boxes are stored in a BoxTree. Entities are marked dirty when
+    /// their pose is set, and Refit recomputes the boxes of the dirty
+    /// entities only. The world refits the index once per iteration.
+    ///
+    /// Boxes are the ones returned by Model::BoundingBox and
+    /// Link::BoundingBox. Entities without collisions have an empty box and
+    /// are never found. Entities with an unbounded box, such as ground
+    /// planes, are kept out of the tree and tested by every query.
+    ///
+    /// Queries return entities in the order in which they were added, so
+    /// results are deterministic.
+    class GZ_PHYSICS_VISIBLE SpatialIndex
+    {
+      /// \brief Types of entities returned by a query.
+      public: enum EntityFilter
+              {
+                /// \brief Models and nested models.
+                MODELS = 1,
+
+                /// \brief Links.
+                LINKS = 2,
+
+                /// \brief Models and links.
+                ALL = MODELS | LINKS
+              };
+
+      /// \brief Constructor.
+      public: SpatialIndex();
+
+      /// \brief Destructor.
+      public: ~SpatialIndex();
+
+      /// \brief Add a model, its links and its nested models. They are
+      /// indexed at the next call to Refit.
+      /// \param[in] _model Model to add.
+      public: void Add(const ModelPtr &_model);
+
+      /// \brief Remove a model, its links and its nested models.
+      /// \param[in] _model Model to remove.
+      public: void Remove(const ModelPtr &_model);
+
+      /// \brief Remove all entities.
+      public: void Clear();
+
+      /// \brief Mark the box of an entity as out of date. Links also mark
+      /// their model, and models mark all their links and nested models.
+      /// Other entities are ignored.
+      /// \param[in] _entity Entity whose pose changed.
+      public: void MarkDirty(const Entity *_entity);
+
+      /// \brief Recompute the boxes of the dirty entities and update the
+      /// tree. This is cheap when nothing moved.
+      public: void Refit();
+
+      /// \brief Get the number of entities in the index.
+      /// \return Number of models and links.
+      public: size_t Size() const;
+
+      /// \brief Get the number of entities waiting for Refit.
+      /// \return Number of dirty entities.
+      public: size_t DirtyCount() const;
+
+      /// \brief Get the box of an entity computed by the last Refit.
+      /// \param[in] _entity Entity in the index.
+      /// \return Bounding box, empty if the entity isn't indexed.
+      public: ignition::math::AxisAlignedBox Box(
+                  const Entity *_entity) const;
+
+      /// \brief Find the entities whose box overlaps a box.
+      /// \param[in] _box Query box.
+      /// \param[in] _filter Types of entities to return.
+      /// \return Entities found.
+      public: std::vector<EntityPtr> QueryBox(
+                  const ignition::math::AxisAlignedBox &_box,
+                  const EntityFilter _filter = ALL) const;
+
+      /// \brief Find the entities whose box overlaps a sphere.
+      /// \param[in] _center Center of the sphere.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[in] _filter Types of entities to return.
+      /// \return Entities found.
+      public: std::vector<EntityPtr> QuerySphere(
+                  const ignition::math::Vector3d &_center,
+                  const double _radius,
+                  const EntityFilter _filter = ALL) const;
+
+      /// \brief Find the entities whose box is hit by a ray.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Unit direction of the ray.
+      /// \param[in] _maxDist Length of the ray.
+      /// \param[in] _filter Types of entities to return.
+      /// \return Entities found, ordered by the distance at which the ray
+      /// enters their box.
+      public: std::vector<EntityPtr> QueryRay(
+                  const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_dir,
+                  const double _maxDist,
+                  const EntityFilter _filter = ALL) const;
+
+      /// \brief Find the entities whose box isn't entirely outside a
+      /// frustum, as tested by ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Query frustum.
+      /// \param[in] _filter Types of entities to return.
+      /// \return Entities found.
+      public: std::vector<EntityPtr> QueryFrustum(
+                  const ignition::math::Frustum &_frustum,
+                  const EntityFilter _filter = ALL) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SpatialIndexPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
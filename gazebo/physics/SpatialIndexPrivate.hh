@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SPATIALINDEXPRIVATE_HH_
+#define GAZEBO_PHYSICS_SPATIALINDEXPRIVATE_HH_
+
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "gazebo/physics/BoxTree.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief An entity of the spatial index.
+    struct SpatialIndexEntry
+    {
+      /// \brief The entity.
+      EntityPtr entity;
+
+      /// \brief True for models, false for links.
+      bool model = false;
+
+      /// \brief Model of a link, null for models.
+      const Entity *parentModel = nullptr;
+
+      /// \brief Rank of the entity in the order of insertion.
+      uint64_t order = 0;
+
+      /// \brief Box computed by the last refit.
+      ignition::math::AxisAlignedBox box;
+
+      /// \brief Proxy of the entity in the tree, -1 if it isn't in it.
+      int proxy = -1;
+
+      /// \brief True if the box is unbounded.
+      bool unbounded = false;
+
+      /// \brief True if the entity is waiting for a refit.
+      bool dirty = false;
+    };
+
+    /// \internal
+    /// \brief Private data for the SpatialIndex class.
+    class SpatialIndexPrivate
+    {
+      /// \brief Add a model and its children. Must be called with mutex
+      /// locked.
+      /// \param[in] _model Model to add.
+      public: void AddModel(const ModelPtr &_model);
+
+      /// \brief Remove a model and its children. Must be called with mutex
+      /// locked.
+      /// \param[in] _model Model to remove.
+      public: void RemoveModel(const ModelPtr &_model);
+
+      /// \brief Add a single entity. Must be called with mutex locked.
+      /// \param[in] _entity Entity to add.
+      /// \param[in] _parentModel Model of a link, null for models.
+      public: void AddEntity(const EntityPtr &_entity,
+                  const Entity *_parentModel);
+
+      /// \brief Remove a single entity. Must be called with mutex locked.
+      /// \param[in] _entity Entity to remove.
+      public: void RemoveEntity(const Entity *_entity);
+
+      /// \brief Mark an entity dirty. Must be called with mutex locked.
+      /// \param[in] _entry Entry of the entity.
+      public: void MarkEntry(SpatialIndexEntry &_entry);
+
+      /// \brief Mark a model, its links and its nested models dirty. Must
+      /// be called with mutex locked.
+      /// \param[in] _model Model to mark.
+      public: void MarkModel(const Model &_model);
+
+      /// \brief Store a new box for an entity. Must be called with mutex
+      /// locked.
+      /// \param[in] _entry Entry of the entity.
+      /// \param[in] _box New box.
+      public: void SetBox(SpatialIndexEntry &_entry,
+                  const ignition::math::AxisAlignedBox &_box);
+
+      /// \brief Entities, indexed by address.
+      public: std::unordered_map<const Entity *, SpatialIndexEntry> entries;
+
+      /// \brief Entities waiting for a refit. Entries may have been
+      /// removed since they were marked.
+      public: std::vector<const Entity *> dirty;
+
+      /// \brief Entities with an unbounded box.
+      public: std::set<SpatialIndexEntry *> unbounded;
+
+      /// \brief Tree of the bounded boxes. Leaves point to entries.
+      public: BoxTree tree;
+
+      /// \brief Rank given to the next entity added.
+      public: uint64_t nextOrder = 0;
+
+      /// \brief Protects all members above.
+      public: mutable std::mutex mutex;
+
+      /// \brief Serializes refits, so that boxes computed by an earlier
+      /// refit never overwrite newer ones.
+      public: std::mutex refitMutex;
+    };
+  }
+}
+#endif
@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstring>
+
+#include "gazebo/physics/StateStreamPrivate.hh"
+#include "gazebo/physics/StateStream.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Convert the bits of a double to little endian and back.
+/// \param[in] _value Value.
+/// \return Value with its bytes in the other order on big endian hosts.
+static inline uint64_t LittleEndian(uint64_t _value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return __builtin_bswap64(_value);
+#else
+  return _value;
+#endif
+}
+
+//////////////////////////////////////////////////
+StateWriter::StateWriter()
+: dataPtr(new StateWriterPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+StateWriter::~StateWriter()
+{
+}
+
+//////////////////////////////////////////////////
+void StateWriter::Reset()
+{
+  this->dataPtr->data.clear();
+  this->dataPtr->names.clear();
+}
+
+//////////////////////////////////////////////////
+void StateWriter::Clear()
+{
+  this->dataPtr->data.clear();
+}
+
+//////////////////////////////////////////////////
+const std::string &StateWriter::Data() const
+{
+  return this->dataPtr->data;
+}
+
+//////////////////////////////////////////////////
+size_t StateWriter::NameCount() const
+{
+  return this->dataPtr->names.size();
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteUInt(const uint64_t _value)
+{
+  uint64_t value = _value;
+  while (value >= 0x80)
+  {
+    this->dataPtr->data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  this->dataPtr->data.push_back(static_cast<char>(value));
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteDouble(const double _value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &_value, sizeof(bits));
+  bits = LittleEndian(bits);
+  this->dataPtr->Append(&bits, sizeof(bits));
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteDoubles(const std::vector<double> &_values)
+{
+  this->WriteUInt(_values.size());
+  for (auto const value : _values)
+    this->WriteDouble(value);
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteVector3(const ignition::math::Vector3d &_value)
+{
+  this->WriteDouble(_value.X());
+  this->WriteDouble(_value.Y());
+  this->WriteDouble(_value.Z());
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WritePose(const ignition::math::Pose3d &_value)
+{
+  this->WriteVector3(_value.Pos());
+  this->WriteDouble(_value.Rot().W());
+  this->WriteDouble(_value.Rot().X());
+  this->WriteDouble(_value.Rot().Y());
+  this->WriteDouble(_value.Rot().Z());
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteTime(const common::Time &_value)
+{
+  this->WriteUInt(static_cast<uint32_t>(_value.sec));
+  this->WriteUInt(static_cast<uint32_t>(_value.nsec));
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteString(const std::string &_value)
+{
+  this->WriteUInt(_value.size());
+  this->dataPtr->Append(_value.data(), _value.size());
+}
+
+//////////////////////////////////////////////////
+void StateWriter::WriteName(const std::string &_value)
+{
+  auto iter = this->dataPtr->names.find(_value);
+  if (iter != this->dataPtr->names.end())
+  {
+    this->WriteUInt(iter->second);
+    return;
+  }
+
+  // A new name gets the next index, and is followed by its text
+  uint64_t index = this->dataPtr->names.size();
+  this->dataPtr->names[_value] = index;
+  this->WriteUInt(index);
+  this->WriteString(_value);
+}
+
+//////////////////////////////////////////////////
+void StateWriterPrivate::Append(const void *_data, const size_t _size)
+{
+  this->data.append(static_cast<const char *>(_data), _size);
+}
+
+//////////////////////////////////////////////////
+StateReader::StateReader()
+: dataPtr(new StateReaderPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+StateReader::~StateReader()
+{
+}
+
+//////////////////////////////////////////////////
+void StateReader::Reset()
+{
+  this->dataPtr->names.clear();
+  this->dataPtr->failed = false;
+}
+
+//////////////////////////////////////////////////
+void StateReader::SetData(const char *_data, const size_t _size)
+{
+  this->dataPtr->pos = _data;
+  this->dataPtr->end = _data + _size;
+  this->dataPtr->failed = false;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::End() const
+{
+  return this->dataPtr->pos == this->dataPtr->end;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::Failed() const
+{
+  return this->dataPtr->failed;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadUInt(uint64_t &_value)
+{
+  _value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7)
+  {
+    uint8_t byte;
+    if (!this->dataPtr->Consume(&byte, 1))
+      return false;
+
+    _value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+
+  this->dataPtr->failed = true;
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadDouble(double &_value)
+{
+  uint64_t bits;
+  if (!this->dataPtr->Consume(&bits, sizeof(bits)))
+    return false;
+
+  bits = LittleEndian(bits);
+  std::memcpy(&_value, &bits, sizeof(bits));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadDoubles(std::vector<double> &_values)
+{
+  uint64_t size;
+  if (!this->ReadUInt(size))
+    return false;
+
+  // Each double takes 8 bytes, which bounds the size of valid data
+  if (size > static_cast<uint64_t>(this->dataPtr->end - this->dataPtr->pos) /
+      sizeof(double))
+  {
+    this->dataPtr->failed = true;
+    return false;
+  }
+
+  _values.resize(size);
+  for (auto &value : _values)
+  {
+    if (!this->ReadDouble(value))
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadVector3(ignition::math::Vector3d &_value)
+{
+  double x, y, z;
+  if (!this->ReadDouble(x) || !this->ReadDouble(y) || !this->ReadDouble(z))
+    return false;
+
+  _value.Set(x, y, z);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadPose(ignition::math::Pose3d &_value)
+{
+  ignition::math::Vector3d pos;
+  double w, x, y, z;
+  if (!this->ReadVector3(pos) || !this->ReadDouble(w) ||
+      !this->ReadDouble(x) || !this->ReadDouble(y) || !this->ReadDouble(z))
+  {
+    return false;
+  }
+
+  _value.Set(pos, ignition::math::Quaterniond(w, x, y, z));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadTime(common::Time &_value)
+{
+  uint64_t sec, nsec;
+  if (!this->ReadUInt(sec) || !this->ReadUInt(nsec))
+    return false;
+
+  _value.sec = static_cast<int32_t>(static_cast<uint32_t>(sec));
+  _value.nsec = static_cast<int32_t>(static_cast<uint32_t>(nsec));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadString(std::string &_value)
+{
+  uint64_t size;
+  if (!this->ReadUInt(size))
+    return false;
+
+  if (size > static_cast<uint64_t>(this->dataPtr->end - this->dataPtr->pos))
+  {
+    this->dataPtr->failed = true;
+    return false;
+  }
+
+  _value.assign(this->dataPtr->pos, size);
+  this->dataPtr->pos += size;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReader::ReadName(std::string &_value)
+{
+  uint64_t index;
+  if (!this->ReadUInt(index))
+    return false;
+
+  if (index < this->dataPtr->names.size())
+  {
+    _value = this->dataPtr->names[index];
+    return true;
+  }
+
+  // Names are defined in order, the first time they're used
+  if (index != this->dataPtr->names.size() || !this->ReadString(_value))
+  {
+    this->dataPtr->failed = true;
+    return false;
+  }
+
+  this->dataPtr->names.push_back(_value);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateReaderPrivate::Consume(void *_data, const size_t _size)
+{
+  if (this->failed || static_cast<size_t>(this->end - this->pos) < _size)
+  {
+    this->failed = true;
+    return false;
+  }
+
+  std::memcpy(_data, this->pos, _size);
+  this->pos += _size;
+  return true;
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_STATESTREAM_HH_
+#define GAZEBO_PHYSICS_STATESTREAM_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data classes.
+    class StateWriterPrivate;
+    class StateReaderPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class StateWriter StateStream.hh physics/physics.hh
+    /// \brief Writes states in a compact binary form.
+    ///
+    /// Integers are written as variable length integers, and doubles,
+    /// poses and joint positions as raw little endian doubles. Names are
+    /// interned: the first time a name is written in a segment it is
+    /// written in full and assigned an index, which is written instead
+    /// afterwards. States must therefore be read back in the order they
+    /// were written, starting at the beginning of the segment.
+    /// \sa StateReader
+    class GZ_PHYSICS_VISIBLE StateWriter
+    {
+      /// \brief Constructor.
+      public: StateWriter();
+
+      /// \brief Destructor.
+      public: ~StateWriter();
+
+      /// \brief Start a new segment. Clears the data and the names.
+      public: void Reset();
+
+      /// \brief Clear the data, keeping the names of the segment. Used to
+      /// write the next state of a segment to a new buffer.
+      public: void Clear();
+
+      /// \brief Get the data written so far.
+      /// \return The data.
+      public: const std::string &Data() const;
+
+      /// \brief Get the number of names interned in the segment.
+      /// \return Number of names.
+      public: size_t NameCount() const;
+
+      /// \brief Write an unsigned integer.
+      /// \param[in] _value Value to write.
+      public: void WriteUInt(const uint64_t _value);
+
+      /// \brief Write a double.
+      /// \param[in] _value Value to write.
+      public: void WriteDouble(const double _value);
+
+      /// \brief Write an array of doubles, preceded by its size.
+      /// \param[in] _values Values to write.
+      public: void WriteDoubles(const std::vector<double> &_values);
+
+      /// \brief Write a vector.
+      /// \param[in] _value Value to write.
+      public: void WriteVector3(const ignition::math::Vector3d &_value);
+
+      /// \brief Write a pose, as a position and a quaternion.
+      /// \param[in] _value Value to write.
+      public: void WritePose(const ignition::math::Pose3d &_value);
+
+      /// \brief Write a time.
+      /// \param[in] _value Value to write.
+      public: void WriteTime(const common::Time &_value);
+
+      /// \brief Write a string.
+      /// \param[in] _value Value to write.
+      public: void WriteString(const std::string &_value);
+
+      /// \brief Write an interned name.
+      /// \param[in] _value Value to write.
+      public: void WriteName(const std::string &_value);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StateWriterPrivate> dataPtr;
+    };
+
+    /// \class StateReader StateStream.hh physics/physics.hh
+    /// \brief Reads states written by a StateWriter.
+    ///
+    /// The read functions return false once the data is exhausted or
+    /// malformed, after which the reader stays in error.
+    class GZ_PHYSICS_VISIBLE StateReader
+    {
+      /// \brief Constructor.
+      public: StateReader();
+
+      /// \brief Destructor.
+      public: ~StateReader();
+
+      /// \brief Start a new segment. Clears the names.
+      public: void Reset();
+
+      /// \brief Set the data to read. The data isn't copied, and must
+      /// remain valid while it is read. Names of the segment are kept.
+      /// \param[in] _data Data written by a StateWriter.
+      /// \param[in] _size Size of the data in bytes.
+      public: void SetData(const char *_data, const size_t _size);
+
+      /// \brief Whether all the data has been read.
+      /// \return True at the end of the data.
+      public: bool End() const;
+
+      /// \brief Whether the data was exhausted or malformed.
+      /// \return True if a read failed.
+      public: bool Failed() const;
+
+      /// \brief Read an unsigned integer.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadUInt(uint64_t &_value);
+
+      /// \brief Read a double.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadDouble(double &_value);
+
+      /// \brief Read an array of doubles.
+      /// \param[out] _values Values read.
+      /// \return True on success.
+      public: bool ReadDoubles(std::vector<double> &_values);
+
+      /// \brief Read a vector.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadVector3(ignition::math::Vector3d &_value);
+
+      /// \brief Read a pose.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadPose(ignition::math::Pose3d &_value);
+
+      /// \brief Read a time.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadTime(common::Time &_value);
+
+      /// \brief Read a string.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadString(std::string &_value);
+
+      /// \brief Read an interned name.
+      /// \param[out] _value Value read.
+      /// \return True on success.
+      public: bool ReadName(std::string &_value);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<StateReaderPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_STATESTREAMPRIVATE_HH_
+#define GAZEBO_PHYSICS_STATESTREAMPRIVATE_HH_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the StateWriter class.
+    class StateWriterPrivate
+    {
+      /// \brief Append raw bytes.
+      /// \param[in] _data Bytes to append.
+      /// \param[in] _size Number of bytes.
+      public: void Append(const void *_data, const size_t _size);
+
+      /// \brief Data written.
+      public: std::string data;
+
+      /// \brief Index of each name interned in the segment.
+      public: std::unordered_map<std::string, uint64_t> names;
+    };
+
+    /// \internal
+    /// \brief Private data for the StateReader class.
+    class StateReaderPrivate
+    {
+      /// \brief Consume raw bytes.
+      /// \param[out] _data Destination of the bytes.
+      /// \param[in] _size Number of bytes.
+      /// \return False if there are not enough bytes left.
+      public: bool Consume(void *_data, const size_t _size);
+
+      /// \brief Next byte to read.
+      public: const char *pos = nullptr;
+
+      /// \brief End of the data.
+      public: const char *end = nullptr;
+
+      /// \brief True once a read failed.
+      public: bool failed = false;
+
+      /// \brief Names interned in the segment, by index.
+      public: std::vector<std::string> names;
+    };
+  }
+}
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/StateStream.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class StateStreamTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Load a world state from SDF.
+  /// \param[in] _x X position of the first model.
+  /// \return The state.
+  protected: physics::WorldState LoadState(const double _x)
+  {
+    std::ostringstream sdfStr;
+    sdfStr << "<sdf version ='" << SDF_VERSION << "'>"
+      << "<world name='default'>"
+      << "<state world_name='default'>"
+      << "<sim_time>1 500</sim_time>"
+      << "<wall_time>1500000000 20</wall_time>"
+      << "<real_time>2 10</real_time>"
+      << "<iterations>1234</iterations>"
+      << "<deletions><name>old_model</name></deletions>"
+      << "<model name='model_00'>"
+      << "  <pose>" << _x << " 0 0.5 0 0 0.3</pose>"
+      << "  <scale>1 2 1</scale>"
+      << "  <link name='link_00'>"
+      << "    <pose>" << _x << " 0 0.5 0 0 0.3</pose>"
+      << "    <velocity>0.001 0 0 0 0 0</velocity>"
+      << "    <acceleration>0 0.006121 0 0.012288 0 0.001751</acceleration>"
+      << "    <wrench>0 0.006121 0 0 0 0</wrench>"
+      << "  </link>"
+      << "  <model name='model_01'>"
+      << "    <pose>1 0 0.5 0 0 0</pose>"
+      << "    <link name='link_01'>"
+      << "      <pose>1.25 0 0.5 0.1 0.2 0.3</pose>"
+      << "    </link>"
+      << "  </model>"
+      << "</model>"
+      << "<light name='sun'>"
+      << "  <pose>0 0 10 0 0.5 0</pose>"
+      << "</light>"
+      << "</state>"
+      << "</world>"
+      << "</sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    worldSDF->SetFromString(sdfStr.str());
+    sdf::ElementPtr stateElem =
+      worldSDF->Root()->GetElement("world")->GetElement("state");
+    return physics::WorldState(stateElem);
+  }
+};
+
+/////////////////////////////////////////////////
+/// \brief Text form of a state.
+/// \param[in] _state State.
+/// \return SDF string.
+std::string Text(const physics::WorldState &_state)
+{
+  std::ostringstream stream;
+  stream << _state;
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+TEST_F(StateStreamTest, Primitives)
+{
+  physics::StateWriter writer;
+  writer.WriteUInt(0);
+  writer.WriteUInt(300);
+  writer.WriteUInt(UINT64_MAX);
+  writer.WriteDouble(-1.5e-300);
+  writer.WriteDoubles({1.0, 2.0, 3.0});
+  writer.WritePose(ignition::math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3));
+  writer.WriteTime(common::Time(-2, 500));
+  writer.WriteName("name");
+  writer.WriteName("other");
+  writer.WriteName("name");
+  EXPECT_EQ(2u, writer.NameCount());
+
+  physics::StateReader reader;
+  reader.SetData(writer.Data().data(), writer.Data().size());
+
+  uint64_t value;
+  EXPECT_TRUE(reader.ReadUInt(value));
+  EXPECT_EQ(0u, value);
+  EXPECT_TRUE(reader.ReadUInt(value));
+  EXPECT_EQ(300u, value);
+  EXPECT_TRUE(reader.ReadUInt(value));
+  EXPECT_EQ(UINT64_MAX, value);
+
+  double d;
+  EXPECT_TRUE(reader.ReadDouble(d));
+  EXPECT_EQ(-1.5e-300, d);
+
+  std::vector<double> values;
+  EXPECT_TRUE(reader.ReadDoubles(values));
+  EXPECT_EQ(std::vector<double>({1.0, 2.0, 3.0}), values);
+
+  ignition::math::Pose3d pose;
+  EXPECT_TRUE(reader.ReadPose(pose));
+  EXPECT_EQ(ignition::math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), pose);
+
+  common::Time time;
+  EXPECT_TRUE(reader.ReadTime(time));
+  EXPECT_EQ(common::Time(-2, 500), time);
+
+  std::string name;
+  EXPECT_TRUE(reader.ReadName(name));
+  EXPECT_EQ("name", name);
+  EXPECT_TRUE(reader.ReadName(name));
+  EXPECT_EQ("other", name);
+  EXPECT_TRUE(reader.ReadName(name));
+  EXPECT_EQ("name", name);
+
+  EXPECT_TRUE(reader.End());
+  EXPECT_FALSE(reader.Failed());
+
+  // Reading past the end fails
+  EXPECT_FALSE(reader.ReadUInt(value));
+  EXPECT_TRUE(reader.Failed());
+}
+
+/////////////////////////////////////////////////
+TEST_F(StateStreamTest, RoundTrip)
+{
+  physics::WorldState state = this->LoadState(0.5);
+  EXPECT_EQ(1u, state.GetModelStateCount());
+  EXPECT_EQ(1u, state.LightStateCount());
+
+  physics::StateWriter writer;
+  state.Serialize(writer);
+
+  physics::StateReader reader;
+  reader.SetData(writer.Data().data(), writer.Data().size());
+  physics::WorldState result;
+  EXPECT_TRUE(result.Deserialize(reader));
+  EXPECT_TRUE(reader.End());
+
+  // Same text form as the state loaded from SDF
+  EXPECT_EQ(Text(state), Text(result));
+
+  // And same values, including the ones the text form leaves out
+  EXPECT_EQ(state.GetSimTime(), result.GetSimTime());
+  EXPECT_EQ(state.GetWallTime(), result.GetWallTime());
+  EXPECT_EQ(state.GetRealTime(), result.GetRealTime());
+  EXPECT_EQ(state.GetIterations(), result.GetIterations());
+  EXPECT_EQ(state.Deletions(), result.Deletions());
+
+  auto model = state.GetModelState("model_00");
+  auto resultModel = result.GetModelState("model_00");
+  EXPECT_EQ(model.Pose(), resultModel.Pose());
+  EXPECT_EQ(model.Scale(), resultModel.Scale());
+  EXPECT_EQ(model.GetSimTime(), resultModel.GetSimTime());
+
+  auto link = model.GetLinkState("link_00");
+  auto resultLink = resultModel.GetLinkState("link_00");
+  EXPECT_EQ(link.Pose(), resultLink.Pose());
+  EXPECT_EQ(link.Velocity(), resultLink.Velocity());
+  EXPECT_EQ(link.Acceleration(), resultLink.Acceleration());
+  EXPECT_EQ(link.Wrench(), resultLink.Wrench());
+
+  ASSERT_TRUE(resultModel.HasNestedModelState("model_01"));
+  auto nested = resultModel.NestedModelState("model_01");
+  EXPECT_EQ(model.NestedModelState("model_01").GetLinkState("link_01").Pose(),
+      nested.GetLinkState("link_01").Pose());
+
+  EXPECT_EQ(state.GetLightState("sun").Pose(),
+      result.GetLightState("sun").Pose());
+}
+
+/////////////////////////////////////////////////
+TEST_F(StateStreamTest, Segment)
+{
+  physics::WorldState first = this->LoadState(0.5);
+  physics::WorldState second = this->LoadState(1.5);
+
+  // Each state goes into its own buffer, names are only written in full
+  // in the first one
+  physics::StateWriter writer;
+  first.Serialize(writer);
+  std::string firstData = writer.Data();
+  size_t nameCount = writer.NameCount();
+
+  writer.Clear();
+  second.Serialize(writer);
+  std::string secondData = writer.Data();
+  EXPECT_EQ(nameCount, writer.NameCount());
+  EXPECT_LT(secondData.size(), firstData.size());
+
+  physics::StateReader reader;
+  physics::WorldState result;
+  reader.SetData(firstData.data(), firstData.size());
+  EXPECT_TRUE(result.Deserialize(reader));
+  EXPECT_EQ(Text(first), Text(result));
+
+  reader.SetData(secondData.data(), secondData.size());
+  EXPECT_TRUE(result.Deserialize(reader));
+  EXPECT_EQ(Text(second), Text(result));
+
+  // A truncated state can't be read
+  reader.Reset();
+  reader.SetData(firstData.data(), firstData.size() / 2);
+  EXPECT_FALSE(result.Deserialize(reader));
+  EXPECT_TRUE(reader.Failed());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,7 +15,11 @@
  *
 */
 
+#include <algorithm>
 #include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 #include <boost/lexical_cast.hpp>
 #include <sdf/sdf.hh>
 
@@ -25,8 +29,10 @@
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Link.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/WindField.hh"
 #include "gazebo/physics/World.hh"
 
 namespace gazebo
@@ -57,6 +63,27 @@ namespace gazebo
       public: std::function< ignition::math::Vector3d (
                   const Wind *, const Entity *)> linearVelFunc;
 
+      /// \brief True if linearVelFunc was set by SetLinearVelFunc.
+      public: bool customLinearVelFunc = false;
+
+      /// \brief Spatially varying part of the wind.
+      public: WindField field;
+
+      /// \brief File loaded by the wind field.
+      public: std::string fieldFile;
+
+      /// \brief Links whose wind velocity is computed by Update.
+      public: std::vector<Link *> links;
+
+      /// \brief Positions of the links, one column per axis.
+      public: std::vector<double> x, y, z;
+
+      /// \brief Wind field at the links, one column per axis.
+      public: std::vector<double> vx, vy, vz;
+
+      /// \brief Protects links.
+      public: std::mutex mutex;
+
       // Transport is declared last.
       /// \brief Node for communication.
       public: transport::NodePtr node;
@@ -93,8 +120,8 @@ Wind::Wind(World &_world, sdf::ElementPtr _sdf)
   this->dataPtr->requestSub = this->dataPtr->node->Subscribe("~/request",
                                            &Wind::OnRequest, this);
 
-  this->SetLinearVelFunc(std::bind(&Wind::LinearVelDefault, this,
-        std::placeholders::_1, std::placeholders::_2));
+  this->dataPtr->linearVelFunc = std::bind(&Wind::LinearVelDefault, this,
+        std::placeholders::_1, std::placeholders::_2);
 }
 
 //////////////////////////////////////////////////
@@ -109,9 +136,16 @@ Wind::~Wind()
 
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::LinearVelDefault(
-    const Wind *_wind, const Entity */*_entity*/)
+    const Wind *_wind, const Entity *_entity)
 {
-  return _wind->LinearVel();
+  ignition::math::Vector3d vel = _wind->LinearVel();
+  if (_entity && !this->dataPtr->field.Empty())
+  {
+    // The turbulence is carried by the global wind
+    vel += this->dataPtr->field.Sample(_entity->WorldPose().Pos(),
+        vel * this->dataPtr->world.SimTime().Double());
+  }
+  return vel;
 }
 
 //////////////////////////////////////////////////
@@ -151,6 +185,13 @@ bool Wind::SetParam(const std::string &_key,
           boost::any_cast<ignition::math::Vector3d>(_value);
       this->SetLinearVel(vel);
     }
+    else if (_key == "field_file")
+    {
+      std::string filename = boost::any_cast<std::string>(_value);
+      if (!this->dataPtr->field.Load(filename))
+        return false;
+      this->dataPtr->fieldFile = filename;
+    }
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in wind " << std::endl;
@@ -186,6 +227,8 @@ bool Wind::Param(const std::string &_key,
 {
   if (_key == "linear_velocity")
     _value = this->LinearVel();
+  else if (_key == "field_file")
+    _value = this->dataPtr->fieldFile;
   else
   {
     gzwarn << "Param failed for [" << _key << "] in wind " << std::endl;
@@ -239,4 +282,91 @@ void Wind::SetLinearVelFunc(std::function< ignition::math::Vector3d (
     const Wind *, const Entity *_entity) > _linearVelFunc)
 {
   this->dataPtr->linearVelFunc = _linearVelFunc;
+  this->dataPtr->customLinearVelFunc = true;
+}
+
+/////////////////////////////////////////////////
+WindField &Wind::Field() const
+{
+  return this->dataPtr->field;
+}
+
+/////////////////////////////////////////////////
+void Wind::AddLink(Link *_link)
+{
+  if (!_link)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &links = this->dataPtr->links;
+  if (std::find(links.begin(), links.end(), _link) == links.end())
+    links.push_back(_link);
+}
+
+/////////////////////////////////////////////////
+void Wind::RemoveLink(const Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &links = this->dataPtr->links;
+  links.erase(std::remove(links.begin(), links.end(), _link), links.end());
+}
+
+/////////////////////////////////////////////////
+size_t Wind::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->links.size();
+}
+
+/////////////////////////////////////////////////
+void Wind::Update()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &links = this->dataPtr->links;
+  if (links.empty())
+    return;
+
+  // A custom function may depend on anything about the link
+  if (this->dataPtr->customLinearVelFunc)
+  {
+    for (auto link : links)
+      link->SetWorldWindLinearVel(this->dataPtr->linearVelFunc(this, link));
+    return;
+  }
+
+  const ignition::math::Vector3d linearVel = this->dataPtr->linearVel;
+  if (this->dataPtr->field.Empty())
+  {
+    for (auto link : links)
+      link->SetWorldWindLinearVel(linearVel);
+    return;
+  }
+
+  const size_t count = links.size();
+  this->dataPtr->x.resize(count);
+  this->dataPtr->y.resize(count);
+  this->dataPtr->z.resize(count);
+  this->dataPtr->vx.resize(count);
+  this->dataPtr->vy.resize(count);
+  this->dataPtr->vz.resize(count);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const ignition::math::Vector3d &pos = links[i]->WorldPose().Pos();
+    this->dataPtr->x[i] = pos.X();
+    this->dataPtr->y[i] = pos.Y();
+    this->dataPtr->z[i] = pos.Z();
+  }
+
+  this->dataPtr->field.Sample(count, this->dataPtr->x.data(),
+      this->dataPtr->y.data(), this->dataPtr->z.data(),
+      linearVel * this->dataPtr->world.SimTime().Double(),
+      this->dataPtr->vx.data(), this->dataPtr->vy.data(),
+      this->dataPtr->vz.data());
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    links[i]->SetWorldWindLinearVel(linearVel + ignition::math::Vector3d(
+        this->dataPtr->vx[i], this->dataPtr->vy[i], this->dataPtr->vz[i]));
+  }
 }
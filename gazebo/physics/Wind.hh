@@ -32,6 +32,7 @@ namespace gazebo
   {
     // Forward declare private data class.
     class WindPrivate;
+    class WindField;
 
     /// \addtogroup gazebo_physics
     /// \{
@@ -57,6 +58,7 @@ namespace gazebo
       /// \param[in] _key String key
       /// Below is a list of _key parameter definitions:
       ///       -# "linear_vel" (Vector3d) - wind linear velocity
+      ///       -# "field_file" (std::string) - file loaded by the wind field
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -110,11 +112,36 @@ namespace gazebo
       /// to calculate the wind's velocity. The parameters to the
       /// function callback is a reference to an instance of
       /// Wind and a pointer to an entity in the scene. The function must
-      /// return the new wind velocity as a vector.
+      /// return the new wind velocity as a vector. Update then calls it
+      /// for each registered link instead of sampling the wind field.
       public: void SetLinearVelFunc(std::function< ignition::math::Vector3d (
           const Wind *_wind, const Entity *_entity) > _linearVelFunc);
 
-      /// \brief Get the global wind velocity, ignoring the entity.
+      /// \brief Get the spatially varying part of the wind, added to the
+      /// global wind velocity by the default velocity function.
+      /// \return Reference to the wind field.
+      public: WindField &Field() const;
+
+      /// \brief Register a link whose wind velocity is computed by Update.
+      /// \param[in] _link Link to add.
+      public: void AddLink(Link *_link);
+
+      /// \brief Unregister a link.
+      /// \param[in] _link Link to remove.
+      public: void RemoveLink(const Link *_link);
+
+      /// \brief Get the number of registered links.
+      /// \return Number of links.
+      public: size_t LinkCount() const;
+
+      /// \brief Compute the wind velocity of all the registered links.
+      /// Without a custom velocity function, the wind field is sampled for
+      /// all the links at once. Called by the world once per iteration,
+      /// before the world update begin event.
+      public: void Update();
+
+      /// \brief Get the global wind velocity plus the wind field at the
+      /// entity location.
       /// \param[in] _wind Reference to the wind.
       /// \param[in] _entity Pointer to an entity at which location the wind
       /// velocity is to be calculated.
@@ -0,0 +1,498 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/WindFieldPrivate.hh"
+#include "gazebo/physics/WindField.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Number of Fourier modes summed to synthesize turbulence.
+static const unsigned int kTurbulenceModes = 128;
+
+//////////////////////////////////////////////////
+/// \brief Find the two samples around a coordinate along one axis.
+/// \param[in] _u Coordinate in units of samples.
+/// \param[in] _n Number of samples.
+/// \param[in] _periodic True to wrap, false to clamp.
+/// \param[out] _i0 Index of the sample below.
+/// \param[out] _i1 Index of the sample above.
+/// \param[out] _f Weight of the sample above.
+static void Bracket(double _u, const unsigned int _n, const bool _periodic,
+    unsigned int &_i0, unsigned int &_i1, double &_f)
+{
+  if (!std::isfinite(_u))
+    _u = 0.0;
+
+  if (_periodic)
+  {
+    _u -= _n * std::floor(_u / _n);
+    _i0 = std::min(static_cast<unsigned int>(_u), _n - 1);
+    _i1 = (_i0 + 1) % _n;
+  }
+  else
+  {
+    _u = ignition::math::clamp(_u, 0.0, _n - 1.0);
+    _i0 = std::min(static_cast<unsigned int>(_u), _n - 2);
+    _i1 = _i0 + 1;
+  }
+  _f = _u - _i0;
+}
+
+//////////////////////////////////////////////////
+void WindGrid::Accumulate(const size_t _count,
+    const double *_x, const double *_y, const double *_z,
+    const ignition::math::Vector3d &_offset,
+    double *_vx, double *_vy, double *_vz) const
+{
+  const size_t nx = this->samples[0];
+  const size_t nxy = nx * this->samples[1];
+  const double *vel[3] = {this->velocity[0].data(),
+      this->velocity[1].data(), this->velocity[2].data()};
+  double *out[3] = {_vx, _vy, _vz};
+
+  for (size_t i = 0; i < _count; ++i)
+  {
+    unsigned int x0, x1, y0, y1, z0, z1;
+    double fx, fy, fz;
+    Bracket((_x[i] - _offset.X() - this->min.X()) * this->invSpacing.X(),
+        this->samples[0], this->periodic, x0, x1, fx);
+    Bracket((_y[i] - _offset.Y() - this->min.Y()) * this->invSpacing.Y(),
+        this->samples[1], this->periodic, y0, y1, fy);
+    Bracket((_z[i] - _offset.Z() - this->min.Z()) * this->invSpacing.Z(),
+        this->samples[2], this->periodic, z0, z1, fz);
+
+    const size_t c00 = y0 * nx + z0 * nxy;
+    const size_t c10 = y1 * nx + z0 * nxy;
+    const size_t c01 = y0 * nx + z1 * nxy;
+    const size_t c11 = y1 * nx + z1 * nxy;
+
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      const double *v = vel[c];
+      double v00 = v[c00 + x0] + fx * (v[c00 + x1] - v[c00 + x0]);
+      double v10 = v[c10 + x0] + fx * (v[c10 + x1] - v[c10 + x0]);
+      double v01 = v[c01 + x0] + fx * (v[c01 + x1] - v[c01 + x0]);
+      double v11 = v[c11 + x0] + fx * (v[c11 + x1] - v[c11 + x0]);
+      double v0 = v00 + fy * (v10 - v00);
+      double v1 = v01 + fy * (v11 - v01);
+      out[c][i] += v0 + fz * (v1 - v0);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void WindFieldPrivate::Synthesize(const bool _vonKarman,
+    const double _intensity, const double _lengthScale,
+    const double _size, const unsigned int _resolution,
+    const unsigned int _seed, WindGrid &_grid)
+{
+  const unsigned int n = _resolution;
+  const size_t total = static_cast<size_t>(n) * n * n;
+  const double spacing = _size / n;
+
+  _grid.samples = {{n, n, n}};
+  _grid.min = ignition::math::Vector3d::Zero;
+  _grid.invSpacing.Set(1.0 / spacing, 1.0 / spacing, 1.0 / spacing);
+  _grid.periodic = true;
+  for (auto &column : _grid.velocity)
+    column.assign(total, 0.0);
+
+  // Wave vectors are multiples of the fundamental, so that the field
+  // repeats itself, up to the Nyquist frequency of the grid.
+  const double k0 = 2.0 * IGN_PI / _size;
+  const int maxIndex = static_cast<int>(n / 2);
+  const double logStep = std::log(static_cast<double>(maxIndex)) /
+      kTurbulenceModes;
+
+  // Energy spectrum E(k) ~ (aLk)^4 / (1 + (aLk)^2)^p
+  const double a = _vonKarman ? 1.339 : 1.0;
+  const double p = _vonKarman ? 17.0 / 6.0 : 3.0;
+
+  std::mt19937 gen(_seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  auto randomDirection = [&]()
+  {
+    double cosTheta = 2.0 * uniform(gen) - 1.0;
+    double sinTheta = std::sqrt(1.0 - cosTheta * cosTheta);
+    double phi = 2.0 * IGN_PI * uniform(gen);
+    return ignition::math::Vector3d(sinTheta * std::cos(phi),
+        sinTheta * std::sin(phi), cosTheta);
+  };
+
+  std::vector<std::complex<double>> ex(n), ey(n), ez(n);
+  for (unsigned int m = 0; m < kTurbulenceModes; ++m)
+  {
+    // Log-spaced magnitudes, jittered within their bin
+    double k = k0 * std::exp((m + uniform(gen)) * logStep);
+    ignition::math::Vector3d dir = randomDirection();
+    int ix = ignition::math::clamp(
+        static_cast<int>(std::round(k * dir.X() / k0)), -maxIndex, maxIndex);
+    int iy = ignition::math::clamp(
+        static_cast<int>(std::round(k * dir.Y() / k0)), -maxIndex, maxIndex);
+    int iz = ignition::math::clamp(
+        static_cast<int>(std::round(k * dir.Z() / k0)), -maxIndex, maxIndex);
+    ignition::math::Vector3d kv(ix * k0, iy * k0, iz * k0);
+    double kLength = kv.Length();
+
+    // The velocity of each mode is normal to its wave vector, so that the
+    // field is divergence free.
+    ignition::math::Vector3d sigma = kv.Cross(randomDirection());
+    double phase = 2.0 * IGN_PI * uniform(gen);
+    if (kLength < 1e-9 || sigma.Length() < 1e-9 * kLength)
+      continue;
+    sigma.Normalize();
+
+    double akl = a * kLength * _lengthScale;
+    double energy = std::pow(akl, 4) / std::pow(1.0 + akl * akl, p);
+    double amplitude = std::sqrt(energy * k * logStep);
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+      double x = i * spacing;
+      ex[i] = std::polar(1.0, kv.X() * x);
+      ey[i] = std::polar(1.0, kv.Y() * x);
+      ez[i] = std::polar(1.0, kv.Z() * x + phase);
+    }
+
+    size_t index = 0;
+    for (unsigned int iz2 = 0; iz2 < n; ++iz2)
+    {
+      for (unsigned int iy2 = 0; iy2 < n; ++iy2)
+      {
+        std::complex<double> eyz = ey[iy2] * ez[iz2];
+        for (unsigned int ix2 = 0; ix2 < n; ++ix2, ++index)
+        {
+          double c = amplitude * (ex[ix2] * eyz).real();
+          _grid.velocity[0][index] += sigma.X() * c;
+          _grid.velocity[1][index] += sigma.Y() * c;
+          _grid.velocity[2][index] += sigma.Z() * c;
+        }
+      }
+    }
+  }
+
+  // Zero mean, and the requested standard deviation on each axis
+  for (auto &column : _grid.velocity)
+  {
+    double mean = 0.0;
+    for (double v : column)
+      mean += v;
+    mean /= total;
+
+    double variance = 0.0;
+    for (double &v : column)
+    {
+      v -= mean;
+      variance += v * v;
+    }
+    variance /= total;
+
+    if (variance > 0.0)
+    {
+      double scale = _intensity / std::sqrt(variance);
+      for (double &v : column)
+        v *= scale;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+WindField::WindField()
+  : dataPtr(new WindFieldPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+WindField::~WindField()
+{
+}
+
+//////////////////////////////////////////////////
+bool WindField::Load(const std::string &_filename)
+{
+  this->Clear();
+
+  std::ifstream file(_filename);
+  if (!file.is_open())
+  {
+    gzerr << "Unable to open wind field [" << _filename << "]" << std::endl;
+    return false;
+  }
+
+  bool hasTurbulence = false;
+  TurbulenceModel model = DRYDEN;
+  double intensity = 1.0;
+  double lengthScale = 10.0;
+  double size = -1.0;
+  unsigned int resolution = 32;
+  unsigned int seed = ignition::math::Rand::Seed();
+
+  bool hasGrid = false;
+  unsigned int samples[3] = {0, 0, 0};
+  ignition::math::Vector3d min;
+  ignition::math::Vector3d max;
+  std::vector<double> data;
+  bool inData = false;
+
+  std::string line;
+  unsigned int lineNumber = 0;
+  while (std::getline(file, line))
+  {
+    ++lineNumber;
+    line = line.substr(0, line.find('#'));
+    std::istringstream stream(line);
+
+    if (inData)
+    {
+      double value;
+      while (stream >> value)
+        data.push_back(value);
+      if (!stream.eof())
+      {
+        gzerr << "Invalid velocity in wind field [" << _filename
+              << "] line " << lineNumber << std::endl;
+        return false;
+      }
+      continue;
+    }
+
+    std::string key;
+    if (!(stream >> key))
+      continue;
+
+    if (key == "turbulence")
+    {
+      std::string type;
+      stream >> type;
+      hasTurbulence = true;
+      if (type == "dryden")
+        model = DRYDEN;
+      else if (type == "von_karman")
+        model = VON_KARMAN;
+      else
+        stream.setstate(std::ios::failbit);
+    }
+    else if (key == "intensity")
+      stream >> intensity;
+    else if (key == "length_scale")
+      stream >> lengthScale;
+    else if (key == "size")
+      stream >> size;
+    else if (key == "resolution")
+      stream >> resolution;
+    else if (key == "seed")
+      stream >> seed;
+    else if (key == "grid")
+    {
+      hasGrid = true;
+      stream >> samples[0] >> samples[1] >> samples[2];
+    }
+    else if (key == "min")
+      stream >> min;
+    else if (key == "max")
+      stream >> max;
+    else if (key == "data")
+      inData = true;
+    else
+      stream.setstate(std::ios::failbit);
+
+    if (stream.fail())
+    {
+      gzerr << "Invalid line " << lineNumber << " in wind field ["
+            << _filename << "]: " << line << std::endl;
+      return false;
+    }
+  }
+
+  if (!hasTurbulence && !hasGrid)
+  {
+    gzerr << "Wind field [" << _filename << "] has neither a grid nor "
+          << "turbulence" << std::endl;
+    return false;
+  }
+
+  if (hasTurbulence)
+  {
+    if (size <= 0.0)
+      size = 8.0 * lengthScale;
+    if (!this->SetTurbulence(model, intensity, lengthScale, size,
+          resolution, seed))
+    {
+      return false;
+    }
+  }
+
+  if (hasGrid)
+  {
+    if (data.size() % 3 != 0)
+    {
+      gzerr << "Wind field [" << _filename << "] has an incomplete velocity"
+            << std::endl;
+      this->Clear();
+      return false;
+    }
+
+    std::vector<ignition::math::Vector3d> velocities;
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+      velocities.push_back(
+          ignition::math::Vector3d(data[i], data[i+1], data[i+2]));
+    }
+
+    if (!this->SetGrid(min, max, samples[0], samples[1], samples[2],
+          velocities))
+    {
+      this->Clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WindField::SetGrid(const ignition::math::Vector3d &_min,
+    const ignition::math::Vector3d &_max,
+    const unsigned int _nx, const unsigned int _ny, const unsigned int _nz,
+    const std::vector<ignition::math::Vector3d> &_velocities)
+{
+  if (_nx < 2 || _ny < 2 || _nz < 2)
+  {
+    gzerr << "A wind grid needs at least 2 samples along each axis"
+          << std::endl;
+    return false;
+  }
+
+  if (_velocities.size() != static_cast<size_t>(_nx) * _ny * _nz)
+  {
+    gzerr << "Wind grid of " << _nx << "x" << _ny << "x" << _nz
+          << " samples has " << _velocities.size() << " velocities"
+          << std::endl;
+    return false;
+  }
+
+  ignition::math::Vector3d extent = _max - _min;
+  if (extent.X() <= 0.0 || extent.Y() <= 0.0 || extent.Z() <= 0.0)
+  {
+    gzerr << "Wind grid max [" << _max << "] must be above min [" << _min
+          << "]" << std::endl;
+    return false;
+  }
+
+  WindGrid grid;
+  grid.samples = {{_nx, _ny, _nz}};
+  grid.min = _min;
+  grid.invSpacing.Set((_nx - 1) / extent.X(), (_ny - 1) / extent.Y(),
+      (_nz - 1) / extent.Z());
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    grid.velocity[c].reserve(_velocities.size());
+    for (auto const &vel : _velocities)
+      grid.velocity[c].push_back(vel[c]);
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->grid = std::move(grid);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool WindField::SetTurbulence(const TurbulenceModel _model,
+    const double _intensity, const double _lengthScale, const double _size,
+    const unsigned int _resolution, const unsigned int _seed)
+{
+  if (_intensity < 0.0 || _lengthScale <= 0.0 || _size <= 0.0 ||
+      _resolution < 4)
+  {
+    gzerr << "Invalid turbulence: intensity [" << _intensity
+          << "], length scale [" << _lengthScale << "], size [" << _size
+          << "], resolution [" << _resolution << "]" << std::endl;
+    return false;
+  }
+
+  WindGrid turbulence;
+  WindFieldPrivate::Synthesize(_model == VON_KARMAN, _intensity,
+      _lengthScale, _size, _resolution, _seed, turbulence);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->turbulence = std::move(turbulence);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void WindField::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->grid = WindGrid();
+  this->dataPtr->turbulence = WindGrid();
+}
+
+//////////////////////////////////////////////////
+bool WindField::Empty() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return !this->dataPtr->grid.Valid() && !this->dataPtr->turbulence.Valid();
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d WindField::Sample(
+    const ignition::math::Vector3d &_pos,
+    const ignition::math::Vector3d &_offset) const
+{
+  double x = _pos.X();
+  double y = _pos.Y();
+  double z = _pos.Z();
+  ignition::math::Vector3d vel;
+  this->Sample(1, &x, &y, &z, _offset, &vel.X(), &vel.Y(), &vel.Z());
+  return vel;
+}
+
+//////////////////////////////////////////////////
+void WindField::Sample(const size_t _count,
+    const double *_x, const double *_y, const double *_z,
+    const ignition::math::Vector3d &_offset,
+    double *_vx, double *_vy, double *_vz) const
+{
+  std::fill(_vx, _vx + _count, 0.0);
+  std::fill(_vy, _vy + _count, 0.0);
+  std::fill(_vz, _vz + _count, 0.0);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->grid.Valid())
+  {
+    this->dataPtr->grid.Accumulate(_count, _x, _y, _z,
+        ignition::math::Vector3d::Zero, _vx, _vy, _vz);
+  }
+  if (this->dataPtr->turbulence.Valid())
+  {
+    this->dataPtr->turbulence.Accumulate(_count, _x, _y, _z, _offset,
+        _vx, _vy, _vz);
+  }
+}
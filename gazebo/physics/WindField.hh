@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WINDFIELD_HH_
+#define GAZEBO_PHYSICS_WINDFIELD_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class WindFieldPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WindField WindField.hh physics/physics.hh
+    /// \brief Spatially varying wind velocity, added by Wind to the global
+    /// wind velocity.
+    ///
+    /// The field is the sum of two optional parts, both sampled with
+    /// trilinear interpolation:
+    /// - A grid of velocities, typically exported from a flow solver.
+    /// Positions outside of the grid are clamped to its boundary.
+    /// - Homogeneous turbulence following a Dryden or von Karman spectrum,
+    /// synthesized once on a periodic grid from random Fourier modes. The
+    /// turbulence is frozen and carried by the mean wind.
+    ///
+    /// A field can be loaded from a text file made of the following
+    /// lines, all optional, where # starts a comment:
+    /// \verbatim
+    /// turbulence <dryden|von_karman>
+    /// intensity <standard deviation of each component (m/s)>
+    /// length_scale <turbulence length scale (m)>
+    /// size <edge of the periodic turbulence cube (m)>
+    /// resolution <samples along each edge of the turbulence cube>
+    /// seed <random seed>
+    /// grid <samples along X> <samples along Y> <samples along Z>
+    /// min <x> <y> <z>
+    /// max <x> <y> <z>
+    /// data
+    /// <vx> <vy> <vz>
+    /// ...
+    /// \endverbatim
+    /// The grid velocities follow the data line, X varying fastest, then Y,
+    /// then Z.
+    class GZ_PHYSICS_VISIBLE WindField
+    {
+      /// \brief Turbulence spectra.
+      public: enum TurbulenceModel
+              {
+                /// \brief Dryden spectrum.
+                DRYDEN,
+
+                /// \brief Von Karman spectrum.
+                VON_KARMAN
+              };
+
+      /// \brief Constructor.
+      public: WindField();
+
+      /// \brief Destructor.
+      public: virtual ~WindField();
+
+      /// \brief Load a field from a file, replacing the current one.
+      /// \param[in] _filename Path to the file.
+      /// \return False if the file can't be read or is invalid, in which
+      /// case the field is cleared.
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Set the gridded part of the field.
+      /// \param[in] _min Position of the first sample.
+      /// \param[in] _max Position of the last sample.
+      /// \param[in] _nx Number of samples along X, at least 2.
+      /// \param[in] _ny Number of samples along Y, at least 2.
+      /// \param[in] _nz Number of samples along Z, at least 2.
+      /// \param[in] _velocities Wind velocities, X varying fastest, then Y,
+      /// then Z.
+      /// \return False if the grid is invalid.
+      public: bool SetGrid(const ignition::math::Vector3d &_min,
+                  const ignition::math::Vector3d &_max,
+                  const unsigned int _nx, const unsigned int _ny,
+                  const unsigned int _nz,
+                  const std::vector<ignition::math::Vector3d> &_velocities);
+
+      /// \brief Set the turbulent part of the field.
+      /// \param[in] _model Turbulence spectrum.
+      /// \param[in] _intensity Standard deviation of each component of the
+      /// velocity (m/s).
+      /// \param[in] _lengthScale Turbulence length scale (m).
+      /// \param[in] _size Edge of the periodic cube on which the turbulence
+      /// is synthesized (m). It should be a few length scales at least.
+      /// \param[in] _resolution Number of samples along each edge, at
+      /// least 4.
+      /// \param[in] _seed Seed of the random phases and directions.
+      /// \return False if a parameter is invalid.
+      public: bool SetTurbulence(const TurbulenceModel _model,
+                  const double _intensity, const double _lengthScale,
+                  const double _size, const unsigned int _resolution,
+                  const unsigned int _seed);
+
+      /// \brief Remove both parts of the field.
+      public: void Clear();
+
+      /// \brief Get whether the field is zero everywhere.
+      /// \return True if neither a grid nor turbulence is set.
+      public: bool Empty() const;
+
+      /// \brief Sample the field at a single position.
+      /// \param[in] _pos Position in the world frame.
+      /// \param[in] _offset Distance travelled by the frozen turbulence.
+      /// \return Wind velocity of the field.
+      public: ignition::math::Vector3d Sample(
+                  const ignition::math::Vector3d &_pos,
+                  const ignition::math::Vector3d &_offset) const;
+
+      /// \brief Sample the field at many positions at once.
+      /// \param[in] _count Number of positions.
+      /// \param[in] _x X coordinates of the positions.
+      /// \param[in] _y Y coordinates of the positions.
+      /// \param[in] _z Z coordinates of the positions.
+      /// \param[in] _offset Distance travelled by the frozen turbulence.
+      /// \param[out] _vx X components of the velocities.
+      /// \param[out] _vy Y components of the velocities.
+      /// \param[out] _vz Z components of the velocities.
+      public: void Sample(const size_t _count,
+                  const double *_x, const double *_y, const double *_z,
+                  const ignition::math::Vector3d &_offset,
+                  double *_vx, double *_vy, double *_vz) const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WindFieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
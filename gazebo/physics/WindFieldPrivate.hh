@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WINDFIELDPRIVATE_HH_
+#define GAZEBO_PHYSICS_WINDFIELDPRIVATE_HH_
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \brief Regular grid of velocities sampled with trilinear
+    /// interpolation.
+    class WindGrid
+    {
+      /// \brief Get whether the grid holds samples.
+      /// \return True if the grid isn't empty.
+      public: bool Valid() const
+              {
+                return !this->velocity[0].empty();
+              }
+
+      /// \brief Add the interpolated velocities at many positions.
+      /// \param[in] _count Number of positions.
+      /// \param[in] _x X coordinates of the positions.
+      /// \param[in] _y Y coordinates of the positions.
+      /// \param[in] _z Z coordinates of the positions.
+      /// \param[in] _offset Offset subtracted from all the positions.
+      /// \param[in,out] _vx X components, incremented.
+      /// \param[in,out] _vy Y components, incremented.
+      /// \param[in,out] _vz Z components, incremented.
+      public: void Accumulate(const size_t _count,
+                  const double *_x, const double *_y, const double *_z,
+                  const ignition::math::Vector3d &_offset,
+                  double *_vx, double *_vy, double *_vz) const;
+
+      /// \brief Number of samples along each axis.
+      public: std::array<unsigned int, 3> samples = {{0, 0, 0}};
+
+      /// \brief Position of the first sample.
+      public: ignition::math::Vector3d min;
+
+      /// \brief Inverse of the distance between samples along each axis.
+      public: ignition::math::Vector3d invSpacing;
+
+      /// \brief True if the grid repeats itself along all axes, false if
+      /// positions are clamped to the grid.
+      public: bool periodic = false;
+
+      /// \brief Velocities, one column per axis, X varying fastest.
+      public: std::array<std::vector<double>, 3> velocity;
+    };
+
+    /// \internal
+    /// \brief Private data for the WindField class.
+    class WindFieldPrivate
+    {
+      /// \brief Synthesize turbulence on a periodic grid.
+      /// \param[in] _vonKarman True for a von Karman spectrum, false for
+      /// a Dryden spectrum.
+      /// \param[in] _intensity Standard deviation of each component.
+      /// \param[in] _lengthScale Turbulence length scale.
+      /// \param[in] _size Edge of the grid.
+      /// \param[in] _resolution Samples along each edge.
+      /// \param[in] _seed Random seed.
+      /// \param[out] _grid Periodic grid.
+      public: static void Synthesize(const bool _vonKarman,
+                  const double _intensity, const double _lengthScale,
+                  const double _size, const unsigned int _resolution,
+                  const unsigned int _seed, WindGrid &_grid);
+
+      /// \brief Gridded part of the field.
+      public: WindGrid grid;
+
+      /// \brief Turbulent part of the field.
+      public: WindGrid turbulence;
+
+      /// \brief Protects the grids.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+#endif
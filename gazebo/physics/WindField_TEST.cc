@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/physics/WindField.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WindFieldTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief A linear velocity field, which trilinear interpolation
+/// reproduces exactly.
+ignition::math::Vector3d LinearField(const ignition::math::Vector3d &_pos)
+{
+  return ignition::math::Vector3d(
+      1.0 + 2.0 * _pos.X() - _pos.Z(),
+      -0.5 * _pos.Y() + 3.0,
+      0.25 * _pos.X() + 0.75 * _pos.Y() + _pos.Z());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, Grid)
+{
+  physics::WindField field;
+  EXPECT_TRUE(field.Empty());
+  EXPECT_EQ(ignition::math::Vector3d::Zero,
+      field.Sample(ignition::math::Vector3d(1, 2, 3),
+        ignition::math::Vector3d::Zero));
+
+  const ignition::math::Vector3d min(-2, -1, 0);
+  const ignition::math::Vector3d max(2, 3, 1);
+  const unsigned int nx = 5, ny = 3, nz = 2;
+
+  std::vector<ignition::math::Vector3d> velocities;
+  EXPECT_FALSE(field.SetGrid(min, max, nx, ny, nz, velocities));
+  for (unsigned int k = 0; k < nz; ++k)
+  {
+    for (unsigned int j = 0; j < ny; ++j)
+    {
+      for (unsigned int i = 0; i < nx; ++i)
+      {
+        ignition::math::Vector3d pos(
+            min.X() + i * (max.X() - min.X()) / (nx - 1),
+            min.Y() + j * (max.Y() - min.Y()) / (ny - 1),
+            min.Z() + k * (max.Z() - min.Z()) / (nz - 1));
+        velocities.push_back(LinearField(pos));
+      }
+    }
+  }
+  EXPECT_FALSE(field.SetGrid(max, min, nx, ny, nz, velocities));
+  EXPECT_FALSE(field.SetGrid(min, max, nx, ny, 1, velocities));
+  EXPECT_TRUE(field.SetGrid(min, max, nx, ny, nz, velocities));
+  EXPECT_FALSE(field.Empty());
+
+  // Exact inside of the grid, and the offset only moves the turbulence
+  std::vector<double> x, y, z;
+  for (int i = 0; i < 50; ++i)
+  {
+    x.push_back(min.X() + (max.X() - min.X()) * ((i * 7) % 50) / 49.0);
+    y.push_back(min.Y() + (max.Y() - min.Y()) * ((i * 11) % 50) / 49.0);
+    z.push_back(min.Z() + (max.Z() - min.Z()) * ((i * 13) % 50) / 49.0);
+  }
+  std::vector<double> vx(x.size()), vy(x.size()), vz(x.size());
+  field.Sample(x.size(), x.data(), y.data(), z.data(),
+      ignition::math::Vector3d(5, 5, 5), vx.data(), vy.data(), vz.data());
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    ignition::math::Vector3d expected =
+        LinearField(ignition::math::Vector3d(x[i], y[i], z[i]));
+    EXPECT_NEAR(expected.X(), vx[i], 1e-9);
+    EXPECT_NEAR(expected.Y(), vy[i], 1e-9);
+    EXPECT_NEAR(expected.Z(), vz[i], 1e-9);
+  }
+
+  // Clamped outside
+  EXPECT_EQ(LinearField(ignition::math::Vector3d(2, -1, 1)),
+      field.Sample(ignition::math::Vector3d(10, -10, 10),
+        ignition::math::Vector3d::Zero));
+
+  field.Clear();
+  EXPECT_TRUE(field.Empty());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, Turbulence)
+{
+  physics::WindField field;
+  EXPECT_FALSE(field.SetTurbulence(physics::WindField::DRYDEN,
+      1.0, -1.0, 10.0, 16, 1));
+  EXPECT_FALSE(field.SetTurbulence(physics::WindField::DRYDEN,
+      1.0, 1.0, 10.0, 2, 1));
+
+  const double intensity = 2.0;
+  const double size = 40.0;
+  const unsigned int resolution = 16;
+  for (auto model : {physics::WindField::DRYDEN,
+      physics::WindField::VON_KARMAN})
+  {
+    ASSERT_TRUE(field.SetTurbulence(model, intensity, 5.0, size,
+        resolution, 42));
+
+    // Statistics over the grid samples
+    std::vector<double> x, y, z;
+    const double spacing = size / resolution;
+    for (unsigned int k = 0; k < resolution; ++k)
+    {
+      for (unsigned int j = 0; j < resolution; ++j)
+      {
+        for (unsigned int i = 0; i < resolution; ++i)
+        {
+          x.push_back(i * spacing);
+          y.push_back(j * spacing);
+          z.push_back(k * spacing);
+        }
+      }
+    }
+    std::vector<double> vx(x.size()), vy(x.size()), vz(x.size());
+    field.Sample(x.size(), x.data(), y.data(), z.data(),
+        ignition::math::Vector3d::Zero, vx.data(), vy.data(), vz.data());
+
+    for (auto const *v : {&vx, &vy, &vz})
+    {
+      double mean = 0.0;
+      double squares = 0.0;
+      for (double value : *v)
+      {
+        mean += value;
+        squares += value * value;
+      }
+      mean /= v->size();
+      EXPECT_NEAR(0.0, mean, 1e-9);
+      EXPECT_NEAR(intensity, std::sqrt(squares / v->size()), 1e-9);
+    }
+
+    // Periodic, and carried by the offset
+    ignition::math::Vector3d pos(3.3, -7.1, 12.8);
+    ignition::math::Vector3d offset(1.5, 0.2, -0.7);
+    ignition::math::Vector3d vel = field.Sample(pos, offset);
+    EXPECT_NE(ignition::math::Vector3d::Zero, vel);
+    EXPECT_EQ(vel, field.Sample(pos + ignition::math::Vector3d(size, 0, 0),
+          offset));
+    EXPECT_EQ(vel, field.Sample(pos - ignition::math::Vector3d(0, 0, size),
+          offset));
+    EXPECT_EQ(vel, field.Sample(pos - offset,
+          ignition::math::Vector3d::Zero));
+  }
+
+  // The same seed gives the same field
+  physics::WindField other;
+  ASSERT_TRUE(other.SetTurbulence(physics::WindField::VON_KARMAN,
+      intensity, 5.0, size, resolution, 42));
+  ignition::math::Vector3d pos(1, 2, 3);
+  EXPECT_EQ(field.Sample(pos, ignition::math::Vector3d::Zero),
+      other.Sample(pos, ignition::math::Vector3d::Zero));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, Load)
+{
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+
+  physics::WindField field;
+  EXPECT_FALSE(field.Load(path.string()));
+
+  {
+    std::ofstream file(path.string());
+    file << "# Gridded field\n"
+         << "grid 2 2 2\n"
+         << "min 0 0 0\n"
+         << "max 1 1 1  # unit cube\n"
+         << "turbulence von_karman\n"
+         << "intensity 0\n"
+         << "resolution 8\n"
+         << "data\n"
+         << "0 0 0  1 0 0\n"
+         << "0 1 0  1 1 0\n"
+         << "0 0 1  1 0 1\n"
+         << "0 1 1  1 1 1\n";
+  }
+  EXPECT_TRUE(field.Load(path.string()));
+  EXPECT_EQ(ignition::math::Vector3d(0.2, 0.4, 0.6),
+      field.Sample(ignition::math::Vector3d(0.2, 0.4, 0.6),
+        ignition::math::Vector3d::Zero));
+
+  {
+    std::ofstream file(path.string());
+    file << "grid 2 2 2\n"
+         << "max 1 1 1\n"
+         << "data\n"
+         << "0 0 0\n";
+  }
+  EXPECT_FALSE(field.Load(path.string()));
+  EXPECT_TRUE(field.Empty());
+
+  {
+    std::ofstream file(path.string());
+    file << "turbulence hurricane\n";
+  }
+  EXPECT_FALSE(field.Load(path.string()));
+
+  boost::filesystem::remove(path);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -15,9 +15,11 @@
  *
 */
 #include <memory>
+#include <vector>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/WindField.hh"
 
 using namespace gazebo;
 
@@ -44,6 +46,9 @@ class WindTest : public ServerFixture
   /// \brief Test setting up function to compute the wind.
   public: void WindSetLinearVelFunc();
 
+  /// \brief Test the wind field sampled at the links.
+  public: void WindFieldSample();
+
   /// \brief Incoming wind message.
   public: static msgs::Wind windPubMsg;
 
@@ -221,6 +226,52 @@ TEST_F(WindTest, WindSetLinearVelFunc)
   WindSetLinearVelFunc();
 }
 
+/////////////////////////////////////////////////
+void WindTest::WindFieldSample()
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(1, 2, 0.5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = GetModel("box");
+  ASSERT_TRUE(model != NULL);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != NULL);
+
+  physics::Wind &wind = world->Wind();
+  unsigned int count = wind.LinkCount();
+  link->SetWindMode(true);
+  EXPECT_EQ(count + 1, wind.LinkCount());
+
+  // Wind increasing with X
+  std::vector<ignition::math::Vector3d> velocities;
+  for (unsigned int i = 0; i < 8; ++i)
+  {
+    velocities.push_back(
+        ignition::math::Vector3d((i & 1) ? 4.0 : 0.0, 0, 0));
+  }
+  EXPECT_TRUE(wind.Field().SetGrid(ignition::math::Vector3d(-1, -10, -10),
+      ignition::math::Vector3d(3, 10, 10), 2, 2, 2, velocities));
+  wind.SetLinearVel(ignition::math::Vector3d(0, 0.5, 0));
+
+  world->Step(1);
+  ignition::math::Vector3d expected(2.0, 0.5, 0);
+  EXPECT_EQ(expected, link->WorldWindLinearVel());
+  EXPECT_EQ(expected, wind.WorldLinearVel(link.get()));
+
+  link->SetWindMode(false);
+  EXPECT_EQ(count, wind.LinkCount());
+  EXPECT_EQ(ignition::math::Vector3d::Zero, link->WorldWindLinearVel());
+}
+
+/////////////////////////////////////////////////
+TEST_F(WindTest, WindFieldSample)
+{
+  WindFieldSample();
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
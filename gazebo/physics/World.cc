@@ -22,6 +22,7 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
 #include <deque>
 #include <list>
 #include <set>
@@ -54,6 +55,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Plugin.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/SdfFrameSemantics.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/URI.hh"
@@ -78,6 +80,9 @@
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Actor.hh"
+#include "gazebo/physics/ActorCrowd.hh"
+#include "gazebo/physics/Hydrodynamics.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/Wind.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
@@ -121,9 +126,6 @@ World::World(const std::string &_name)
   this->dataPtr->factorySDF.reset(new sdf::SDF);
   sdf::initFile("root.sdf", this->dataPtr->factorySDF);
 
-  this->dataPtr->logPlayStateSDF.reset(new sdf::Element);
-  sdf::initFile("state.sdf", this->dataPtr->logPlayStateSDF);
-
   this->dataPtr->initialized = false;
   this->dataPtr->loaded = false;
   this->dataPtr->stepInc = 0;
@@ -156,6 +158,9 @@ World::World(const std::string &_name)
   this->dataPtr->logLastStatePlayedRealTime = common::Time(0);
   this->dataPtr->logPlayRealTimeFactor = 0.0;
 
+  // Created here because entities report pose changes to it while they load
+  this->dataPtr->spatialIndex.reset(new physics::SpatialIndex());
+
   this->dataPtr->connections.push_back(
      event::Events::ConnectStep(std::bind(&World::OnStep, this)));
   this->dataPtr->connections.push_back(
@@ -307,6 +312,13 @@ void World::Load(sdf::ElementPtr _sdf)
 
   this->dataPtr->wind->Load(windElem);
 
+  // This should come before loading of actors
+  this->dataPtr->actorCrowd.reset(new physics::ActorCrowd(*this));
+
+  // This should come before loading of models, whose plugins register
+  // links
+  this->dataPtr->hydrodynamics.reset(new physics::Hydrodynamics(*this));
+
   // This should come after loading physics engine
   sdf::ElementPtr atmosphereElem = this->dataPtr->sdf->GetElement("atmosphere");
 
@@ -566,12 +578,24 @@ void World::RunLoop()
   else
   {
     this->dataPtr->enablePhysicsEngine = false;
+
+    // Frames are decoded on a separate thread, ahead of playback.
+    this->dataPtr->logPlayPipeline.reset(new LogPlayPipeline());
+    this->dataPtr->logPlayPipeline->Start();
+
     for (this->dataPtr->iterations = 0; !this->dataPtr->stop &&
         (!this->dataPtr->stopIterations ||
          (this->dataPtr->iterations < this->dataPtr->stopIterations));)
     {
       this->LogStep();
     }
+
+    {
+      std::lock_guard<std::recursive_mutex> lk(
+          this->dataPtr->worldUpdateMutex);
+      this->dataPtr->logPlayPipeline->Stop();
+      this->dataPtr->logPlayPipeline.reset();
+    }
   }
 
   this->dataPtr->stop = true;
@@ -600,8 +624,9 @@ void World::LogStep()
       if (!this->IsPaused() && this->dataPtr->stepInc == 0)
         this->dataPtr->stepInc = 1;
 
-      std::string data;
-      if (!util::LogPlay::Instance()->Step(this->dataPtr->stepInc, data))
+      auto state =
+          this->dataPtr->logPlayPipeline->Step(this->dataPtr->stepInc);
+      if (!state)
       {
         // There are no more chunks, time to exit.
         this->SetPaused(true);
@@ -610,11 +635,7 @@ void World::LogStep()
       else
       {
         this->dataPtr->stepInc = 1;
-
-        this->dataPtr->logPlayStateSDF->Clear();
-        sdf::readString(data, this->dataPtr->logPlayStateSDF);
-
-        this->dataPtr->logPlayState.Load(this->dataPtr->logPlayStateSDF);
+        this->dataPtr->logPlayState = state;
 
         // If it's the first step, we're going back in time or
         // rt factor is close to zero, don't sleep.
@@ -622,10 +643,10 @@ void World::LogStep()
             (this->dataPtr->logLastStatePlayedRealTime != common::Time(0)) &&
             (this->dataPtr->logLastStatePlayedSimTime != common::Time(0)) &&
             (this->dataPtr->logLastStatePlayedSimTime <
-               this->dataPtr->logPlayState.GetSimTime()))
+               this->dataPtr->logPlayState->GetSimTime()))
         {
           common::Time timeUntilNextStep =
-              common::Time((this->dataPtr->logPlayState.GetSimTime()
+              common::Time((this->dataPtr->logPlayState->GetSimTime()
                            - this->dataPtr->logLastStatePlayedSimTime).Double()
                            / this->dataPtr->logPlayRealTimeFactor);
           common::Time realTimeOfNextStep =
@@ -642,14 +663,14 @@ void World::LogStep()
         // increase the iteration counter in logPlayState.
         if (!util::LogPlay::Instance()->HasIterations())
         {
-          this->dataPtr->logPlayState.SetIterations(
+          this->dataPtr->logPlayState->SetIterations(
             this->dataPtr->iterations + 1);
         }
 
         this->dataPtr->logLastStatePlayedRealTime = common::Time::GetWallTime();
         this->dataPtr->logLastStatePlayedSimTime =
-            this->dataPtr->logPlayState.GetSimTime();
-        this->SetState(this->dataPtr->logPlayState);
+            this->dataPtr->logPlayState->GetSimTime();
+        this->SetState(*this->dataPtr->logPlayState);
         this->Update();
       }
 
@@ -661,6 +682,8 @@ void World::LogStep()
   this->PublishWorldStats();
 
   this->ProcessMessages();
+
+  this->dataPtr->spatialIndex->Refit();
 }
 
 //////////////////////////////////////////////////
@@ -684,7 +707,8 @@ void World::SetSensorWaitFunc(std::function<void(double, double)> _func)
 //////////////////////////////////////////////////
 void World::Step()
 {
-  DIAG_TIMER_START("World::Step");
+  GZ_PROFILE_SCOPE("World::Step");
+  GZ_PROFILE_LAP_START(stepTimer);
 
   IGN_PROFILE("World::Step");
   IGN_PROFILE_BEGIN("loadPlugins");
@@ -699,14 +723,14 @@ void World::Step()
   }
 
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Step", "loadPlugins");
+  GZ_PROFILE_LAP(stepTimer, "World::Step::loadPlugins");
 
   IGN_PROFILE_BEGIN("publishWorldStats");
   // Send statistics about the world simulation
   this->PublishWorldStats();
   IGN_PROFILE_END();
 
-  DIAG_TIMER_LAP("World::Step", "publishWorldStats");
+  GZ_PROFILE_LAP(stepTimer, "World::Step::publishWorldStats");
 
   IGN_PROFILE_BEGIN("sleepOffset");
   if (this->dataPtr->waitForSensors)
@@ -733,7 +757,7 @@ void World::Step()
                       this->dataPtr->sleepOffset * 0.99;
 
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Step", "sleepOffset");
+  GZ_PROFILE_LAP(stepTimer, "World::Step::sleepOffset");
 
   IGN_PROFILE_BEGIN("worldUpdateMutex");
   // throttling update rate, with sleepOffset as tolerance
@@ -743,7 +767,7 @@ void World::Step()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
 
-    DIAG_TIMER_LAP("World::Step", "worldUpdateMutex");
+    GZ_PROFILE_LAP(stepTimer, "World::Step::worldUpdateMutex");
 
     this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
 
@@ -757,7 +781,7 @@ void World::Step()
       this->dataPtr->iterations++;
       this->Update();
 
-      DIAG_TIMER_LAP("World::Step", "update");
+      GZ_PROFILE_LAP(stepTimer, "World::Step::update");
 
       if (this->IsPaused() && this->dataPtr->stepInc > 0)
         this->dataPtr->stepInc--;
@@ -778,10 +802,12 @@ void World::Step()
 
   this->ProcessMessages();
 
-  DIAG_TIMER_STOP("World::Step");
-
   if (g_clearModels)
     this->ClearModels();
+
+  // Update the boxes of entities which moved or were inserted during this
+  // iteration
+  this->dataPtr->spatialIndex->Refit();
   IGN_PROFILE_END();
 }
 
@@ -813,7 +839,8 @@ void World::Step(const unsigned int _steps)
 //////////////////////////////////////////////////
 void World::Update()
 {
-  DIAG_TIMER_START("World::Update");
+  GZ_PROFILE_SCOPE("World::Update");
+  GZ_PROFILE_LAP_START(updateTimer);
 
   IGN_PROFILE("World::Update");
   IGN_PROFILE_BEGIN("needsReset");
@@ -829,26 +856,45 @@ void World::Update()
     return;
   }
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "needsReset");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::needsReset");
+
+  IGN_PROFILE_BEGIN("Wind::Update");
+  // Compute the wind of all wind-enabled links in one batch, before
+  // plugins read it
+  this->dataPtr->wind->Update();
+  IGN_PROFILE_END();
+  GZ_PROFILE_LAP(updateTimer, "World::Update::Wind::Update");
 
   IGN_PROFILE_BEGIN("worldUpdateBegin");
   this->dataPtr->updateInfo.simTime = this->SimTime();
   this->dataPtr->updateInfo.realTime = this->RealTime();
   event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::Events::worldUpdateBegin");
 
   IGN_PROFILE_BEGIN("Update");
   // Update all the models
   (*this.*dataPtr->modelUpdateFunc)();
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "Model::Update");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::Model::Update");
+
+  IGN_PROFILE_BEGIN("ActorCrowd::Update");
+  // Animate all actors in crowd mode in one batch
+  this->dataPtr->actorCrowd->Update();
+  IGN_PROFILE_END();
+  GZ_PROFILE_LAP(updateTimer, "World::Update::ActorCrowd::Update");
+
+  IGN_PROFILE_BEGIN("Hydrodynamics::Update");
+  // Apply fluid forces to all registered links in one batch
+  this->dataPtr->hydrodynamics->Update();
+  IGN_PROFILE_END();
+  GZ_PROFILE_LAP(updateTimer, "World::Update::Hydrodynamics::Update");
 
   IGN_PROFILE_BEGIN("UpdateCollision");
   // This must be called before PhysicsEngine::UpdatePhysics for ODE.
   this->dataPtr->physicsEngine->UpdateCollision();
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::PhysicsEngine::UpdateCollision");
 
   IGN_PROFILE_BEGIN("beforePhysicsUpdate");
   // Wait for logging to finish, if it's running.
@@ -872,7 +918,7 @@ void World::Update()
   event::Events::beforePhysicsUpdate(this->dataPtr->updateInfo);
 
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "Events::beforePhysicsUpdate");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::Events::beforePhysicsUpdate");
 
   // Update the physics engine
   if (this->dataPtr->enablePhysicsEngine && this->dataPtr->physicsEngine)
@@ -882,7 +928,7 @@ void World::Update()
     this->dataPtr->physicsEngine->UpdatePhysics();
 
     IGN_PROFILE_END();
-    DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdatePhysics");
+    GZ_PROFILE_LAP(updateTimer, "World::Update::PhysicsEngine::UpdatePhysics");
 
     // do this after physics update as
     //   ode --> MoveCallback sets the dirtyPoses
@@ -902,7 +948,18 @@ void World::Update()
       IGN_PROFILE_END();
     }
 
-    DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
+    GZ_PROFILE_LAP(updateTimer, "World::Update::SetWorldPose(dirtyPoses)");
+
+    // Read the joint states once, for everything that queries them until
+    // the next step
+    IGN_PROFILE_BEGIN("UpdateJointStates");
+    for (auto &model : this->dataPtr->models)
+    {
+      if (!model->IsStatic())
+        model->UpdateJointStates();
+    }
+    IGN_PROFILE_END();
+    GZ_PROFILE_LAP(updateTimer, "World::Update::Model::UpdateJointStates");
   }
 
   IGN_PROFILE_BEGIN("LogRecordNotify");
@@ -910,20 +967,18 @@ void World::Update()
   if (util::LogRecord::Instance()->Running())
     this->dataPtr->logCondition.notify_one();
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "LogRecordNotify");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::LogRecordNotify");
 
   IGN_PROFILE_BEGIN("PublishContacts");
   // Output the contact information
   this->dataPtr->physicsEngine->GetContactManager()->PublishContacts();
 
   IGN_PROFILE_END();
-  DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
+  GZ_PROFILE_LAP(updateTimer, "World::Update::ContactManager::PublishContacts");
 
   event::Events::worldUpdateEnd();
 
   gazebo::util::IntrospectionManager::Instance()->Update();
-
-  DIAG_TIMER_STOP("World::Update");
 }
 
 //////////////////////////////////////////////////
@@ -981,6 +1036,11 @@ void World::Fini()
   this->dataPtr->publishModelScales.clear();
   this->dataPtr->publishLightPoses.clear();
 
+  // The index holds pointers to the entities
+  this->dataPtr->spatialIndex->Clear();
+  if (this->dataPtr->hydrodynamics)
+    this->dataPtr->hydrodynamics->Clear();
+
   // Clean entities
   for (auto &model : this->dataPtr->models)
   {
@@ -1011,7 +1071,7 @@ void World::Fini()
   this->dataPtr->prevStates[0].SetWorld(WorldPtr());
   this->dataPtr->prevStates[1].SetWorld(WorldPtr());
   this->dataPtr->prevUnfilteredState.SetWorld(WorldPtr());
-  this->dataPtr->logPlayState.SetWorld(WorldPtr());
+  this->dataPtr->logPlayState.reset();
   this->dataPtr->states[0].clear();
   this->dataPtr->states[1].clear();
 
@@ -1020,6 +1080,8 @@ void World::Fini()
 
   this->dataPtr->atmosphere.reset();
   this->dataPtr->wind.reset();
+  this->dataPtr->actorCrowd.reset();
+  this->dataPtr->hydrodynamics.reset();
 
   // Engine shouldn't outlive world
   if (this->dataPtr->physicsEngine)
@@ -1089,6 +1151,24 @@ Wind &World::Wind() const
   return *this->dataPtr->wind;
 }
 
+//////////////////////////////////////////////////
+ActorCrowd &World::ActorCrowd() const
+{
+  return *this->dataPtr->actorCrowd;
+}
+
+//////////////////////////////////////////////////
+SpatialIndex &World::SpatialIndex() const
+{
+  return *this->dataPtr->spatialIndex;
+}
+
+//////////////////////////////////////////////////
+Hydrodynamics &World::Hydrodynamics() const
+{
+  return *this->dataPtr->hydrodynamics;
+}
+
 //////////////////////////////////////////////////
 Atmosphere &World::Atmosphere() const
 {
@@ -1214,6 +1294,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->spatialIndex->Add(model);
   return model;
 }
 
@@ -1269,6 +1350,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->spatialIndex->Add(actor);
 
   return actor;
 }
@@ -1576,6 +1658,15 @@ void World::ProcessPlaybackControlMsgs()
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
 
+  // Moving through the log discards the frames decoded ahead.
+  auto reposition = [this](const std::function<void()> &_move)
+  {
+    if (this->dataPtr->logPlayPipeline)
+      this->dataPtr->logPlayPipeline->Reposition(_move);
+    else
+      _move();
+  };
+
   for (auto const &msg : this->dataPtr->playbackControlMsgs)
   {
     if (msg.has_pause())
@@ -1592,13 +1683,19 @@ void World::ProcessPlaybackControlMsgs()
     if (msg.has_seek())
     {
       common::Time targetSimTime = msgs::Convert(msg.seek());
-      util::LogPlay::Instance()->Seek(targetSimTime);
+      reposition([&targetSimTime]()
+          {
+            util::LogPlay::Instance()->Seek(targetSimTime);
+          });
       this->dataPtr->stepInc = 1;
     }
 
     if (msg.has_rewind() && msg.rewind())
     {
-      util::LogPlay::Instance()->Rewind();
+      reposition([]()
+          {
+            util::LogPlay::Instance()->Rewind();
+          });
       this->dataPtr->stepInc = 1;
       if (!util::LogPlay::Instance()->HasIterations())
         this->dataPtr->iterations = 0;
@@ -1606,7 +1703,10 @@ void World::ProcessPlaybackControlMsgs()
 
     if (msg.has_forward() && msg.forward())
     {
-      util::LogPlay::Instance()->Forward();
+      reposition([]()
+          {
+            util::LogPlay::Instance()->Forward();
+          });
       this->dataPtr->stepInc = -1;
       this->SetPaused(true);
       // ToDo: Update iterations if the log doesn't have it.
@@ -2323,8 +2423,27 @@ EntityPtr World::EntityBelowPoint(const ignition::math::Vector3d &_pt) const
   double dist;
   ignition::math::Vector3d end;
 
+  // Pick up models loaded or moved since the last world iteration. This
+  // does nothing if none were.
+  this->dataPtr->spatialIndex->Refit();
+
+  // Only cast the ray as far as the lowest link box it crosses, and not at
+  // all if it crosses none.
+  const double maxDist = 1000;
+  auto candidates = this->dataPtr->spatialIndex->QueryRay(_pt,
+      -ignition::math::Vector3d::UnitZ, maxDist, physics::SpatialIndex::LINKS);
+  if (candidates.empty())
+    return EntityPtr();
+
+  double lowest = _pt.Z();
+  for (auto const &candidate : candidates)
+  {
+    lowest = std::min(lowest,
+        this->dataPtr->spatialIndex->Box(candidate.get()).Min().Z());
+  }
+
   end = _pt;
-  end.Z() -= 1000;
+  end.Z() = std::max(lowest - 1e-3, _pt.Z() - maxDist);
 
   this->dataPtr->physicsEngine->InitForThread();
   this->dataPtr->testRay->SetPoints(_pt, end);
@@ -3085,6 +3204,9 @@ void World::RemoveModel(const std::string &_name)
     {
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
+        this->dataPtr->spatialIndex->Remove(*model);
+        if (this->dataPtr->hydrodynamics)
+          this->dataPtr->hydrodynamics->RemoveModel(*model);
         this->dataPtr->models.erase(model);
         this->dataPtr->rootElement->RemoveChild(_name);
         break;
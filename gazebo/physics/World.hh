@@ -155,6 +155,22 @@ namespace gazebo
       /// \return Reference to the wind.
       public: physics::Wind &Wind() const;
 
+      /// \brief Get a reference to the crowd which animates actors in crowd
+      /// mode.
+      /// \return Reference to the actor crowd.
+      /// \sa Actor::SetCrowdMode
+      public: physics::ActorCrowd &ActorCrowd() const;
+
+      /// \brief Get a reference to the index of the bounding boxes of
+      /// models and links, refitted once per iteration.
+      /// \return Reference to the spatial index.
+      public: physics::SpatialIndex &SpatialIndex() const;
+
+      /// \brief Get a reference to the engine which applies fluid forces
+      /// to the registered links, once per iteration.
+      /// \return Reference to the hydrodynamics engine.
+      public: physics::Hydrodynamics &Hydrodynamics() const;
+
       /// \brief Return the spherical coordinates converter.
       /// \return Pointer to the spherical coordinates converter.
       public: common::SphericalCoordinatesPtr SphericalCoords() const;
@@ -39,7 +39,9 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/LogPlayPipeline.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
@@ -62,6 +64,18 @@ namespace gazebo
       /// The world owns this pointer.
       public: std::unique_ptr<Atmosphere> atmosphere;
 
+      /// \brief Unique pointer to the crowd which animates actors in crowd
+      /// mode. The world owns this pointer.
+      public: std::unique_ptr<ActorCrowd> actorCrowd;
+
+      /// \brief Index of the bounding boxes of models and links. The world
+      /// owns this pointer.
+      public: std::unique_ptr<SpatialIndex> spatialIndex;
+
+      /// \brief Engine which applies fluid forces to the registered links.
+      /// The world owns this pointer.
+      public: std::unique_ptr<Hydrodynamics> hydrodynamics;
+
       /// \brief Pointer the spherical coordinates data.
       public: common::SphericalCoordinatesPtr sphericalCoordinates;
 
@@ -275,11 +289,11 @@ namespace gazebo
       /// \brief Int used to toggle between prevStates
       public: int stateToggle;
 
-      /// \brief State from from log file.
-      public: sdf::ElementPtr logPlayStateSDF;
+      /// \brief Decodes the frames of the log file ahead of playback.
+      public: std::unique_ptr<LogPlayPipeline> logPlayPipeline;
 
       /// \brief Current state when playing from a log file.
-      public: WorldState logPlayState;
+      public: std::shared_ptr<WorldState> logPlayState;
 
       /// \brief Store a factory SDF object to improve speed at which
       /// objects are inserted via the factory.
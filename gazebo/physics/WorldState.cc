@@ -24,6 +24,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/Light.hh"
+#include "gazebo/physics/StateStream.hh"
 #include "gazebo/physics/WorldState.hh"
 
 using namespace gazebo;
@@ -603,6 +604,99 @@ void WorldState::FillSDF(sdf::ElementPtr _sdf)
   }
 }
 
+/////////////////////////////////////////////////
+void WorldState::Serialize(StateWriter &_writer) const
+{
+  _writer.WriteName(this->name);
+  _writer.WriteTime(this->simTime);
+  _writer.WriteTime(this->wallTime);
+  _writer.WriteTime(this->realTime);
+  _writer.WriteUInt(this->iterations);
+
+  _writer.WriteUInt(this->insertions.size());
+  for (auto const &insertion : this->insertions)
+    _writer.WriteString(insertion);
+
+  _writer.WriteUInt(this->deletions.size());
+  for (auto const &deletion : this->deletions)
+    _writer.WriteName(deletion);
+
+  _writer.WriteUInt(this->modelStates.size());
+  for (auto const &model : this->modelStates)
+    model.second.Serialize(_writer);
+
+  _writer.WriteUInt(this->lightStates.size());
+  for (auto const &light : this->lightStates)
+    light.second.Serialize(_writer);
+}
+
+/////////////////////////////////////////////////
+bool WorldState::Deserialize(StateReader &_reader)
+{
+  if (!_reader.ReadName(this->name) || !_reader.ReadTime(this->simTime) ||
+      !_reader.ReadTime(this->wallTime) || !_reader.ReadTime(this->realTime) ||
+      !_reader.ReadUInt(this->iterations))
+  {
+    return false;
+  }
+
+  uint64_t count;
+
+  this->insertions.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    std::string insertion;
+    if (!_reader.ReadString(insertion))
+      return false;
+    this->insertions.push_back(insertion);
+  }
+
+  this->deletions.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    std::string deletion;
+    if (!_reader.ReadName(deletion))
+      return false;
+    this->deletions.push_back(deletion);
+  }
+
+  this->modelStates.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    ModelState modelState;
+    if (!modelState.Deserialize(_reader))
+      return false;
+    modelState.SetSimTime(this->simTime);
+    modelState.SetWallTime(this->wallTime);
+    modelState.SetRealTime(this->realTime);
+    modelState.SetIterations(this->iterations);
+    this->modelStates.insert(std::make_pair(modelState.GetName(), modelState));
+  }
+
+  this->lightStates.clear();
+  if (!_reader.ReadUInt(count))
+    return false;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    LightState lightState;
+    if (!lightState.Deserialize(_reader))
+      return false;
+    lightState.SetSimTime(this->simTime);
+    lightState.SetWallTime(this->wallTime);
+    lightState.SetRealTime(this->realTime);
+    lightState.SetIterations(this->iterations);
+    this->lightStates.insert(std::make_pair(lightState.GetName(), lightState));
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void WorldState::SetWallTime(const common::Time &_time)
 {
@@ -15,7 +15,12 @@
  *
 */
 
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/test/ServerFixture.hh"
 #include "test/util.hh"
@@ -216,6 +221,113 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+/// \brief Check if a list of entities contains an entity.
+/// \param[in] _entities Entities to search.
+/// \param[in] _name Scoped name of the entity.
+/// \return True if it was found.
+bool HasEntity(const std::vector<physics::EntityPtr> &_entities,
+    const std::string &_name)
+{
+  for (auto const &entity : _entities)
+  {
+    if (entity->GetScopedName() == _name)
+      return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, SpatialIndex)
+{
+  // Load a world with simple shapes
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  auto &index = world->SpatialIndex();
+  index.Refit();
+  EXPECT_EQ(0u, index.DirtyCount());
+
+  // The ground plane, box, sphere and cylinder, with one link each
+  EXPECT_EQ(8u, index.Size());
+
+  // Models and links are found where they are
+  ignition::math::Vector3d boxPos(0, 0, 0.5);
+  auto found = index.QuerySphere(boxPos, 0.1);
+  EXPECT_TRUE(HasEntity(found, "box"));
+  EXPECT_TRUE(HasEntity(found, "box::link"));
+  EXPECT_FALSE(HasEntity(found, "sphere"));
+
+  found = index.QuerySphere(boxPos, 0.1, physics::SpatialIndex::MODELS);
+  EXPECT_TRUE(HasEntity(found, "box"));
+  EXPECT_FALSE(HasEntity(found, "box::link"));
+
+  // Moving a model marks it and its links dirty until the next refit
+  ignition::math::Vector3d newPos(100, 0, 0.5);
+  box->SetWorldPose(ignition::math::Pose3d(newPos,
+      ignition::math::Quaterniond::Identity));
+  index.Refit();
+  EXPECT_EQ(0u, index.DirtyCount());
+
+  found = index.QueryBox(ignition::math::AxisAlignedBox(
+      boxPos - ignition::math::Vector3d(0.1, 0.1, 0.1),
+      boxPos + ignition::math::Vector3d(0.1, 0.1, 0.1)));
+  EXPECT_FALSE(HasEntity(found, "box"));
+
+  found = index.QueryBox(ignition::math::AxisAlignedBox(
+      newPos - ignition::math::Vector3d(0.1, 0.1, 0.1),
+      newPos + ignition::math::Vector3d(0.1, 0.1, 0.1)));
+  EXPECT_TRUE(HasEntity(found, "box"));
+
+  // Rays return the closest box first
+  found = index.QueryRay(newPos + ignition::math::Vector3d(0, 0, 10),
+      -ignition::math::Vector3d::UnitZ, 100, physics::SpatialIndex::LINKS);
+  ASSERT_FALSE(found.empty());
+  EXPECT_EQ("box::link", found[0]->GetScopedName());
+
+  auto below = world->ModelBelowPoint(
+      newPos + ignition::math::Vector3d(0, 0, 10));
+  ASSERT_NE(nullptr, below);
+  EXPECT_EQ("box", below->GetName());
+
+  // Removed models are removed from the index
+  world->RemoveModel("box");
+  EXPECT_EQ(6u, index.Size());
+  found = index.QuerySphere(newPos, 0.1);
+  EXPECT_FALSE(HasEntity(found, "box"));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, ModelBelowPointWithoutStep)
+{
+  // Load a paused world, so that the index is not refit by a step
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto sphere = world->ModelByName("sphere");
+  ASSERT_NE(nullptr, sphere);
+
+  // Move a model and look below it right away
+  ignition::math::Vector3d newPos(-50, 20, 0.5);
+  sphere->SetWorldPose(ignition::math::Pose3d(newPos,
+      ignition::math::Quaterniond::Identity));
+
+  auto below = world->ModelBelowPoint(
+      newPos + ignition::math::Vector3d(0, 0, 10));
+  ASSERT_NE(nullptr, below);
+  EXPECT_EQ("sphere", below->GetName());
+
+  // Nothing is left where it was
+  below = world->ModelBelowPoint(ignition::math::Vector3d(0, 1.5, 10));
+  ASSERT_NE(nullptr, below);
+  EXPECT_NE("sphere", below->GetName());
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
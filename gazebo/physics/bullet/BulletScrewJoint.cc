@@ -311,6 +311,7 @@ void BulletScrewJoint::SetVelocity(unsigned int _index, double _vel)
   desiredVel += _vel * this->GlobalAxis(_index);
   if (this->childLink)
     this->childLink->SetLinearVel(desiredVel);
+  this->MarkModelJointStatesStale();
 }
 
 //////////////////////////////////////////////////
@@ -259,7 +259,10 @@ void DARTJoint::SetVelocity(unsigned int _index, double _vel)
         this->dataPtr->dtJoint->getNumDofs());
 
   if (_index < dofs)
+  {
     this->dataPtr->dtJoint->setVelocity(_index, _vel);
+    this->MarkModelJointStatesStale();
+  }
   else
     gzerr << "Invalid index [" << _index << "] (max: " << dofs << ")\n";
 }
@@ -716,6 +719,7 @@ bool DARTJoint::SetPosition(const unsigned int _index, const double _position,
   if (_index < dofs)
   {
     this->dataPtr->dtJoint->setPosition(_index, _position);
+    this->MarkModelJointStatesStale();
     return true;
   }
 
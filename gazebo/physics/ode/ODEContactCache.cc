@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cstring>
+
+#include "gazebo/physics/ode/ODEContactCache.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Minimum cosine of the angle between the normals of matching
+/// contacts.
+static const double kMinNormalDot = 0.95;
+
+//////////////////////////////////////////////////
+ODEContactCache::ODEContactCache()
+  : tolerance(0.01), matchCount(0)
+{
+}
+
+//////////////////////////////////////////////////
+void ODEContactCache::SetTolerance(const double _tolerance)
+{
+  this->tolerance = _tolerance;
+}
+
+//////////////////////////////////////////////////
+double ODEContactCache::Tolerance() const
+{
+  return this->tolerance;
+}
+
+//////////////////////////////////////////////////
+void ODEContactCache::Begin()
+{
+  this->current.clear();
+  this->matchCount = 0;
+}
+
+//////////////////////////////////////////////////
+bool ODEContactCache::Add(dGeomID _geom1, dGeomID _geom2,
+    const dContactGeom &_contact, dJointID _joint)
+{
+  // Express the contact in the frame of a body, so that contacts moving
+  // with the bodies still match
+  ODECachedContact entry;
+  dBodyID body = dGeomGetBody(_geom1);
+  if (!body)
+    body = dGeomGetBody(_geom2);
+
+  if (body)
+  {
+    dBodyGetPosRelPoint(body, _contact.pos[0], _contact.pos[1],
+        _contact.pos[2], entry.pos);
+    dBodyVectorFromWorld(body, _contact.normal[0], _contact.normal[1],
+        _contact.normal[2], entry.normal);
+  }
+  else
+  {
+    memcpy(entry.pos, _contact.pos, sizeof(dVector3));
+    memcpy(entry.normal, _contact.normal, sizeof(dVector3));
+  }
+  entry.side1 = _contact.side1;
+  entry.side2 = _contact.side2;
+  entry.joint = _joint;
+  entry.matched = false;
+
+  std::pair<dGeomID, dGeomID> key(_geom1, _geom2);
+  this->current[key].push_back(entry);
+
+  auto iter = this->previous.find(key);
+  if (iter == this->previous.end())
+    return false;
+
+  // Nearest unmatched contact of the same features
+  ODECachedContact *best = nullptr;
+  double bestDist = this->tolerance * this->tolerance;
+  for (auto &cached : iter->second)
+  {
+    if (cached.matched || cached.side1 != entry.side1 ||
+        cached.side2 != entry.side2)
+    {
+      continue;
+    }
+
+    double dot = cached.normal[0] * entry.normal[0] +
+      cached.normal[1] * entry.normal[1] +
+      cached.normal[2] * entry.normal[2];
+    if (dot < kMinNormalDot)
+      continue;
+
+    double dx = cached.pos[0] - entry.pos[0];
+    double dy = cached.pos[1] - entry.pos[1];
+    double dz = cached.pos[2] - entry.pos[2];
+    double dist = dx * dx + dy * dy + dz * dz;
+    if (dist <= bestDist)
+    {
+      best = &cached;
+      bestDist = dist;
+    }
+  }
+
+  if (!best)
+    return false;
+
+  best->matched = true;
+  dJointSetLambda(_joint, best->lambda, best->lambdaErp);
+  this->matchCount++;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ODEContactCache::Update()
+{
+  for (auto &pair : this->current)
+  {
+    for (auto &entry : pair.second)
+    {
+      dJointGetLambda(entry.joint, entry.lambda, entry.lambdaErp);
+      entry.joint = nullptr;
+    }
+  }
+
+  // Pairs which aren't in contact anymore are dropped
+  this->previous.swap(this->current);
+  this->current.clear();
+}
+
+//////////////////////////////////////////////////
+void ODEContactCache::Clear()
+{
+  this->previous.clear();
+  this->current.clear();
+  this->matchCount = 0;
+}
+
+//////////////////////////////////////////////////
+size_t ODEContactCache::Size() const
+{
+  size_t size = 0;
+  for (auto const &pair : this->previous)
+    size += pair.second.size();
+  return size;
+}
+
+//////////////////////////////////////////////////
+uint64_t ODEContactCache::MatchCount() const
+{
+  return this->matchCount;
+}
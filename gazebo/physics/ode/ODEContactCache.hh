@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODECONTACTCACHE_HH_
+#define GAZEBO_PHYSICS_ODE_ODECONTACTCACHE_HH_
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A contact of the previous step, with its impulses.
+    class ODECachedContact
+    {
+      /// \brief Position, in the frame of the body the contact is
+      /// attached to, or in the world frame without a body.
+      public: dVector3 pos;
+
+      /// \brief Normal, in the same frame as pos.
+      public: dVector3 normal;
+
+      /// \brief Features of the geoms which touch, or -1.
+      public: int side1;
+
+      /// \brief Features of the geoms which touch, or -1.
+      public: int side2;
+
+      /// \brief Constraint impulses.
+      public: dReal lambda[6];
+
+      /// \brief Position correction impulses.
+      public: dReal lambdaErp[6];
+
+      /// \brief Contact joint, until its impulses are read.
+      public: dJointID joint;
+
+      /// \brief True once matched by a contact of the next step.
+      public: bool matched;
+    };
+
+    /// \internal
+    /// \class ODEContactCache ODEContactCache.hh
+    /// \brief Carries the impulses of the contact joints over to the next
+    /// step. ODE contact joints are recreated every step, so quickstep's
+    /// warm start has nothing to start from. The cache matches the
+    /// contacts of a geom pair to the ones of the previous step, by
+    /// feature and position relative to the first body, and seeds the new
+    /// joints with the impulses of their match.
+    ///
+    /// A step goes through Begin, Add for each contact joint, then Update
+    /// once the world was stepped.
+    class GZ_PHYSICS_VISIBLE ODEContactCache
+    {
+      /// \brief Constructor.
+      public: ODEContactCache();
+
+      /// \brief Set the maximum distance between matching contacts.
+      /// \param[in] _tolerance Distance in meters.
+      public: void SetTolerance(const double _tolerance);
+
+      /// \brief Get the maximum distance between matching contacts.
+      /// \return Distance in meters.
+      public: double Tolerance() const;
+
+      /// \brief Start a step. Joints added since the last Update are
+      /// forgotten, since their group is about to be emptied.
+      public: void Begin();
+
+      /// \brief Add a contact joint of this step, and seed its impulses
+      /// with the ones of the matching contact of the previous step.
+      /// \param[in] _geom1 First geom of the contact.
+      /// \param[in] _geom2 Second geom of the contact.
+      /// \param[in] _contact Contact point.
+      /// \param[in] _joint Contact joint, attached to the geom bodies.
+      /// \return True if a matching contact was found.
+      public: bool Add(dGeomID _geom1, dGeomID _geom2,
+                  const dContactGeom &_contact, dJointID _joint);
+
+      /// \brief Read the impulses of the joints added during this step.
+      /// They are matched against the contacts of the next step. Must be
+      /// called after the world step, before the joints are destroyed.
+      public: void Update();
+
+      /// \brief Forget all contacts.
+      public: void Clear();
+
+      /// \brief Get the number of contacts cached for the next step.
+      /// \return Number of contacts.
+      public: size_t Size() const;
+
+      /// \brief Get the number of contacts of the current step which
+      /// matched a contact of the previous step.
+      /// \return Number of contacts.
+      public: uint64_t MatchCount() const;
+
+      /// \brief Contacts of a geom pair.
+      private: typedef std::map<std::pair<dGeomID, dGeomID>,
+               std::vector<ODECachedContact> > ContactMap;
+
+      /// \brief Contacts of the previous step, with their impulses.
+      private: ContactMap previous;
+
+      /// \brief Contacts added during this step.
+      private: ContactMap current;
+
+      /// \brief Maximum distance between matching contacts.
+      private: double tolerance;
+
+      /// \brief Number of contacts of this step which matched.
+      private: uint64_t matchCount;
+    };
+  }
+}
+#endif
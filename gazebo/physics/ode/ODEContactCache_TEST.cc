@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/physics/ode/ODEContactCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class ODEContactCacheTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Create a world with a box resting on a static box.
+  public: virtual void SetUp()
+  {
+    gazebo::testing::AutoLogFixture::SetUp();
+    dInitODE2(0);
+    dAllocateODEDataForThread(dAllocateMaskAll);
+
+    this->world = dWorldCreate();
+    this->group = dJointGroupCreate(0);
+    this->body = dBodyCreate(this->world);
+    dBodySetPosition(this->body, 1, 2, 0.5);
+    this->box = dCreateBox(0, 1, 1, 1);
+    dGeomSetBody(this->box, this->body);
+    this->ground = dCreateBox(0, 10, 10, 1);
+    dGeomSetPosition(this->ground, 0, 0, -0.5);
+  }
+
+  /// \brief Destroy the world.
+  public: virtual void TearDown()
+  {
+    dJointGroupDestroy(this->group);
+    dGeomDestroy(this->box);
+    dGeomDestroy(this->ground);
+    dWorldDestroy(this->world);
+    dCloseODE();
+    gazebo::testing::AutoLogFixture::TearDown();
+  }
+
+  /// \brief Create a contact joint between the box and the ground.
+  /// \param[in] _x X position of the contact, in the world frame.
+  /// \param[in] _side1 Feature of the box.
+  /// \param[out] _geom Contact point.
+  /// \return The contact joint.
+  public: dJointID Contact(const double _x, const int _side1,
+              dContactGeom &_geom)
+  {
+    dContact contact;
+    memset(&contact, 0, sizeof(contact));
+    contact.surface.mode = dContactApprox1;
+    contact.surface.mu = 1;
+    contact.geom.pos[0] = _x;
+    contact.geom.pos[1] = 2;
+    contact.geom.normal[2] = 1;
+    contact.geom.g1 = this->box;
+    contact.geom.g2 = this->ground;
+    contact.geom.side1 = _side1;
+    contact.geom.side2 = -1;
+    _geom = contact.geom;
+
+    dJointID joint = dJointCreateContact(this->world, this->group, &contact);
+    dJointAttach(joint, this->body, 0);
+    return joint;
+  }
+
+  /// \brief World.
+  public: dWorldID world;
+
+  /// \brief Group of the contact joints.
+  public: dJointGroupID group;
+
+  /// \brief Dynamic body.
+  public: dBodyID body;
+
+  /// \brief Geom of the dynamic body.
+  public: dGeomID box;
+
+  /// \brief Static geom.
+  public: dGeomID ground;
+};
+
+/////////////////////////////////////////////////
+TEST_F(ODEContactCacheTest, Match)
+{
+  ODEContactCache cache;
+  EXPECT_DOUBLE_EQ(0.01, cache.Tolerance());
+  EXPECT_EQ(0u, cache.Size());
+
+  // Nothing to match during the first step
+  dContactGeom geom;
+  cache.Begin();
+  dJointID joint = this->Contact(0.5, 0, geom);
+  EXPECT_FALSE(cache.Add(this->box, this->ground, geom, joint));
+  EXPECT_EQ(0u, cache.MatchCount());
+
+  // Impulses computed by the step
+  dReal lambda[6] = {10, 1, 2, 0, 0, 0};
+  dReal lambdaErp[6] = {3, 0, 0, 0, 0, 0};
+  dJointSetLambda(joint, lambda, lambdaErp);
+  cache.Update();
+  EXPECT_EQ(1u, cache.Size());
+
+  // The body moved along with the contact, which still matches
+  cache.Begin();
+  dJointGroupEmpty(this->group);
+  dBodySetPosition(this->body, 2, 2, 0.5);
+  joint = this->Contact(1.5, 0, geom);
+  EXPECT_TRUE(cache.Add(this->box, this->ground, geom, joint));
+  EXPECT_EQ(1u, cache.MatchCount());
+
+  dReal seeded[6];
+  dReal seededErp[6];
+  dJointGetLambda(joint, seeded, seededErp);
+  EXPECT_DOUBLE_EQ(10, seeded[0]);
+  EXPECT_DOUBLE_EQ(1, seeded[1]);
+  EXPECT_DOUBLE_EQ(2, seeded[2]);
+  EXPECT_DOUBLE_EQ(3, seededErp[0]);
+
+  // A cached contact seeds a single joint
+  dJointID second = this->Contact(1.5, 0, geom);
+  EXPECT_FALSE(cache.Add(this->box, this->ground, geom, second));
+  EXPECT_EQ(1u, cache.MatchCount());
+
+  cache.Update();
+  EXPECT_EQ(2u, cache.Size());
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.Size());
+  EXPECT_EQ(0u, cache.MatchCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEContactCacheTest, Reject)
+{
+  ODEContactCache cache;
+  cache.SetTolerance(0.05);
+  EXPECT_DOUBLE_EQ(0.05, cache.Tolerance());
+
+  dContactGeom geom;
+  cache.Begin();
+  dJointID joint = this->Contact(0.5, 0, geom);
+  cache.Add(this->box, this->ground, geom, joint);
+  cache.Update();
+
+  cache.Begin();
+  dJointGroupEmpty(this->group);
+
+  // Too far
+  joint = this->Contact(0.6, 0, geom);
+  EXPECT_FALSE(cache.Add(this->box, this->ground, geom, joint));
+
+  // Other feature
+  joint = this->Contact(0.5, 1, geom);
+  EXPECT_FALSE(cache.Add(this->box, this->ground, geom, joint));
+
+  // Other geom pair
+  joint = this->Contact(0.5, 0, geom);
+  EXPECT_FALSE(cache.Add(this->ground, this->box, geom, joint));
+
+  // Opposite normal
+  geom.normal[2] = -1;
+  EXPECT_FALSE(cache.Add(this->box, this->ground, geom, joint));
+
+  // Within tolerance
+  joint = this->Contact(0.54, 0, geom);
+  EXPECT_TRUE(cache.Add(this->box, this->ground, geom, joint));
+  EXPECT_EQ(1u, cache.MatchCount());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
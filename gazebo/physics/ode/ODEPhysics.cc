@@ -30,10 +30,12 @@
 #include <ignition/math/Vector3.hh>
 #include <ignition/common/Profiler.hh>
 
-#include "gazebo/util/Diagnostics.hh"
+#include <parallel_quickstep/parallel_quickstep.h>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Time.hh"
 #include "gazebo/common/Timer.hh"
 
@@ -360,11 +362,13 @@ void ODEPhysics::InitForThread()
 //////////////////////////////////////////////////
 void ODEPhysics::UpdateCollision()
 {
-  DIAG_TIMER_START("ODEPhysics::UpdateCollision");
+  GZ_PROFILE_SCOPE("ODEPhysics::UpdateCollision");
+  GZ_PROFILE_LAP_START(collisionTimer);
   IGN_PROFILE("ODEPhysics:UpdateCollision");
   IGN_PROFILE_BEGIN("dSpaceCollide");
 
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+  this->dataPtr->contactCache.Begin();
   dJointGroupEmpty(this->dataPtr->contactGroup);
 
   unsigned int i = 0;
@@ -377,7 +381,7 @@ void ODEPhysics::UpdateCollision()
 
   // Do collision detection; this will add contacts to the contact group
   dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
+  GZ_PROFILE_LAP(collisionTimer, "ODEPhysics::UpdateCollision::dSpaceCollide");
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("collideShapes");
@@ -387,7 +391,7 @@ void ODEPhysics::UpdateCollision()
     this->Collide(this->dataPtr->colliders[i].first,
         this->dataPtr->colliders[i].second, this->dataPtr->contactCollisions);
   }
-  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideShapes");
+  GZ_PROFILE_LAP(collisionTimer, "ODEPhysics::UpdateCollision::collideShapes");
   IGN_PROFILE_END();
 
 
@@ -400,16 +404,15 @@ void ODEPhysics::UpdateCollision()
     ODECollision *collision2 = this->dataPtr->trimeshColliders[i].second;
     this->Collide(collision1, collision2, this->dataPtr->contactCollisions);
   }
-  DIAG_TIMER_LAP("UpdateCollision", "collideTrimeshes");
+  GZ_PROFILE_LAP(collisionTimer,
+      "ODEPhysics::UpdateCollision::collideTrimeshes");
   IGN_PROFILE_END();
-
-  DIAG_TIMER_STOP("ODEPhysics::UpdateCollision");
 }
 
 //////////////////////////////////////////////////
 void ODEPhysics::UpdatePhysics()
 {
-  DIAG_TIMER_START("ODEPhysics::UpdatePhysics");
+  GZ_PROFILE_SCOPE("ODEPhysics::UpdatePhysics");
   IGN_PROFILE("ODEPhysics:UpdatePhysics");
 
   // need to lock, otherwise might conflict with world resetting
@@ -420,6 +423,10 @@ void ODEPhysics::UpdatePhysics()
     (*(this->dataPtr->physicsStepFunc))
       (this->dataPtr->worldId, this->maxStepSize);
 
+    // Keep the contact impulses for the next step
+    if (this->dataPtr->contactWarmStart)
+      this->dataPtr->contactCache.Update();
+
     ignition::math::Vector3d f1, f2, t1, t2;
 
     // Set the joint contact feedback for each contact.
@@ -452,8 +459,6 @@ void ODEPhysics::UpdatePhysics()
       }
     }
   }
-
-  DIAG_TIMER_STOP("ODEPhysics::UpdatePhysics");
 }
 
 //////////////////////////////////////////////////
@@ -494,6 +499,7 @@ void ODEPhysics::Reset()
   boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
   // Very important to clear out the contact group
   dJointGroupEmpty(this->dataPtr->contactGroup);
+  this->dataPtr->contactCache.Clear();
 }
 
 //////////////////////////////////////////////////
@@ -929,6 +935,12 @@ void ODEPhysics::SetStepType(const std::string &_type)
   // Set the physics update function
   if (this->dataPtr->stepType == "quick")
     this->dataPtr->physicsStepFunc = &dWorldQuickStep;
+  else if (this->dataPtr->stepType == "colored_quick")
+    this->dataPtr->physicsStepFunc = &dWorldColoredQuickStep;
+  else if (this->dataPtr->stepType == "parallel_quick")
+    this->dataPtr->physicsStepFunc = &dWorldParallelQuickStep;
+  else if (this->dataPtr->stepType == "sparse_quick")
+    this->dataPtr->physicsStepFunc = &dWorldSparseQuickStep;
   else if (this->dataPtr->stepType == "world")
     this->dataPtr->physicsStepFunc = &dWorldStep;
   else
@@ -1327,7 +1339,16 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     // Attach the contact joint if collideWithoutContact flags aren't set.
     if (!_collision1->GetSurface()->collideWithoutContact &&
         !_collision2->GetSurface()->collideWithoutContact)
+    {
       dJointAttach(contactJoint, b1, b2);
+
+      if (this->dataPtr->contactWarmStart)
+      {
+        this->dataPtr->contactCache.Add(_collision1->GetCollisionId(),
+            _collision2->GetCollisionId(),
+            _contactCollisions[this->dataPtr->indices[j]], contactJoint);
+      }
+    }
   }
 }
 
@@ -1536,11 +1557,31 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       dWorldSetQuickStepWarmStartFactor(this->dataPtr->worldId,
         any_cast<double>(_value));
     }
+    else if (_key == "contact_warm_start")
+    {
+      boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+      this->dataPtr->contactWarmStart = any_cast<bool>(_value);
+      this->dataPtr->contactCache.Clear();
+    }
+    else if (_key == "contact_warm_start_tolerance")
+    {
+      this->dataPtr->contactCache.SetTolerance(any_cast<double>(_value));
+    }
     else if (_key == "extra_friction_iterations")
     {
       dWorldSetQuickStepExtraFrictionIterations(this->dataPtr->worldId,
         any_cast<int>(_value));
     }
+    else if (_key == "colored_quick_threads")
+    {
+      dWorldSetQuickStepColoredThreads(this->dataPtr->worldId,
+        any_cast<int>(_value));
+    }
+    else if (_key == "parallel_quick_threads")
+    {
+      dWorldSetParallelQuickStepThreads(this->dataPtr->worldId,
+        any_cast<int>(_value));
+    }
     else if (_key == "island_threads")
     {
       int value;
@@ -1656,12 +1697,36 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
   }
   else if (_key == "warm_start_factor")
     _value = dWorldGetQuickStepWarmStartFactor(this->dataPtr->worldId);
+  else if (_key == "contact_warm_start")
+    _value = this->dataPtr->contactWarmStart;
+  else if (_key == "contact_warm_start_tolerance")
+    _value = this->dataPtr->contactCache.Tolerance();
+  else if (_key == "contact_warm_start_matches")
+    _value = this->dataPtr->contactCache.MatchCount();
   else if (_key == "extra_friction_iterations")
     _value = dWorldGetQuickStepExtraFrictionIterations(this->dataPtr->worldId);
   else if (_key == "friction_model")
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "colored_quick_threads")
+    _value = dWorldGetQuickStepColoredThreads(this->dataPtr->worldId);
+  else if (_key == "parallel_quick_threads")
+    _value = dWorldGetParallelQuickStepThreads(this->dataPtr->worldId);
+  else if (_key == "step_arena_count" || _key == "step_arena_bytes" ||
+           _key == "step_arena_high_water" || _key == "step_arena_grows")
+  {
+    dWorldStepMemoryStats stats;
+    dWorldGetStepMemoryStats(this->dataPtr->worldId, &stats);
+    if (_key == "step_arena_count")
+      _value = stats.arena_count;
+    else if (_key == "step_arena_bytes")
+      _value = static_cast<uint64_t>(stats.reserved_bytes);
+    else if (_key == "step_arena_high_water")
+      _value = static_cast<uint64_t>(stats.high_water_bytes);
+    else
+      _value = stats.grow_count;
+  }
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
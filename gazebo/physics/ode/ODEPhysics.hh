@@ -271,12 +271,21 @@ namespace gazebo
       public: static World_Solver_Type
               ConvertWorldStepSolverType(const std::string &_solverType);
 
-      /// \brief Get the step type (quick, world).
+      /// \brief Get the step type (quick, colored_quick, parallel_quick,
+      /// sparse_quick, world).
       /// \return The step type.
       public: virtual std::string GetStepType() const;
 
-      /// \brief Set the step type (quick, world).
-      /// \param[in] _type The step type (quick or world).
+      /// \brief Set the step type (quick, colored_quick, parallel_quick,
+      /// sparse_quick, world).
+      /// colored_quick is quick with the constraint rows of an island solved
+      /// in parallel, by graph coloring. parallel_quick is the batched PGS
+      /// solver of deps/parallel_quickstep, run with OpenMP threads.
+      /// sparse_quick solves the joints of kinematic trees exactly, with a
+      /// factorization linear in the number of links, and the contacts,
+      /// limits and loops with PGS.
+      /// \param[in] _type The step type (quick, colored_quick,
+      /// parallel_quick, sparse_quick or world).
       public: virtual void SetStepType(const std::string &_type);
 
 
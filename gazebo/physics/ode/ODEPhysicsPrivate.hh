@@ -24,6 +24,7 @@
 #include <utility>
 
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ode/ODEContactCache.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
 namespace gazebo
@@ -92,6 +93,14 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief True to warm start the contact joints with the impulses
+      /// of the previous step.
+      public: bool contactWarmStart = false;
+
+      /// \brief Contacts of the previous step, used to warm start the
+      /// contact joints.
+      public: ODEContactCache contactCache;
     };
   }
 }
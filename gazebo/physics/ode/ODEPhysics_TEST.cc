@@ -137,6 +137,18 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
   int extraFrictionIterationsRet = boost::any_cast<int>(value);
   EXPECT_EQ(extraFrictionIterations, extraFrictionIterationsRet);
 
+  // contact warm start is off by default
+  EXPECT_FALSE(boost::any_cast<bool>(
+        odePhysics->GetParam("contact_warm_start")));
+  EXPECT_TRUE(odePhysics->SetParam("contact_warm_start", true));
+  EXPECT_TRUE(odePhysics->SetParam("contact_warm_start_tolerance", 0.02));
+  EXPECT_TRUE(boost::any_cast<bool>(
+        odePhysics->GetParam("contact_warm_start")));
+  EXPECT_DOUBLE_EQ(0.02, boost::any_cast<double>(
+        odePhysics->GetParam("contact_warm_start_tolerance")));
+  EXPECT_EQ(0u, boost::any_cast<uint64_t>(
+        odePhysics->GetParam("contact_warm_start_matches")));
+
   // verify against equivalent functions
   EXPECT_EQ(type, odePhysics->GetStepType());
   EXPECT_EQ(preconIters, odePhysics->GetSORPGSPreconIters());
@@ -320,6 +332,91 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     }
   }
 
+  // Test colored_quick solver type and threads
+  {
+    EXPECT_TRUE(odePhysics->SetParam("solver_type",
+          std::string("colored_quick")));
+    EXPECT_EQ("colored_quick", odePhysics->GetStepType());
+
+    // colored_quick_threads should be 0, one per core, by default
+    int coloredThreads = 1;
+    EXPECT_NO_THROW(coloredThreads = boost::any_cast<int>(
+          odePhysics->GetParam("colored_quick_threads")));
+    EXPECT_EQ(0, coloredThreads);
+
+    EXPECT_TRUE(odePhysics->SetParam("colored_quick_threads", 2));
+    EXPECT_NO_THROW(coloredThreads = boost::any_cast<int>(
+          odePhysics->GetParam("colored_quick_threads")));
+    EXPECT_EQ(2, coloredThreads);
+
+    // negative values mean one thread per core
+    EXPECT_TRUE(odePhysics->SetParam("colored_quick_threads", -1));
+    EXPECT_NO_THROW(coloredThreads = boost::any_cast<int>(
+          odePhysics->GetParam("colored_quick_threads")));
+    EXPECT_EQ(0, coloredThreads);
+  }
+
+  // Test parallel_quick solver type and threads
+  {
+    EXPECT_TRUE(odePhysics->SetParam("solver_type",
+          std::string("parallel_quick")));
+    EXPECT_EQ("parallel_quick", odePhysics->GetStepType());
+
+    // parallel_quick_threads should be 0, one per core, by default
+    int parallelThreads = 1;
+    EXPECT_NO_THROW(parallelThreads = boost::any_cast<int>(
+          odePhysics->GetParam("parallel_quick_threads")));
+    EXPECT_EQ(0, parallelThreads);
+
+    EXPECT_TRUE(odePhysics->SetParam("parallel_quick_threads", 2));
+    EXPECT_NO_THROW(parallelThreads = boost::any_cast<int>(
+          odePhysics->GetParam("parallel_quick_threads")));
+    EXPECT_EQ(2, parallelThreads);
+
+    // negative values mean one thread per core
+    EXPECT_TRUE(odePhysics->SetParam("parallel_quick_threads", -1));
+    EXPECT_NO_THROW(parallelThreads = boost::any_cast<int>(
+          odePhysics->GetParam("parallel_quick_threads")));
+    EXPECT_EQ(0, parallelThreads);
+  }
+
+  // Test sparse_quick solver type
+  {
+    EXPECT_TRUE(odePhysics->SetParam("solver_type",
+          std::string("sparse_quick")));
+    EXPECT_EQ("sparse_quick", odePhysics->GetStepType());
+    world->Step(10);
+  }
+
+  // Test step arena statistics
+  {
+    EXPECT_TRUE(odePhysics->SetParam("solver_type", std::string("quick")));
+    world->Step(10);
+
+    unsigned int arenas = 0;
+    EXPECT_NO_THROW(arenas = boost::any_cast<unsigned int>(
+          odePhysics->GetParam("step_arena_count")));
+    EXPECT_GE(arenas, 1u);
+
+    uint64_t bytes = 0;
+    uint64_t highWater = 0;
+    EXPECT_NO_THROW(bytes = boost::any_cast<uint64_t>(
+          odePhysics->GetParam("step_arena_bytes")));
+    EXPECT_NO_THROW(highWater = boost::any_cast<uint64_t>(
+          odePhysics->GetParam("step_arena_high_water")));
+    EXPECT_GT(bytes, 0u);
+    EXPECT_LE(highWater, bytes);
+
+    // the arenas are kept from one step to the next
+    unsigned int grows = 0;
+    EXPECT_NO_THROW(grows = boost::any_cast<unsigned int>(
+          odePhysics->GetParam("step_arena_grows")));
+    EXPECT_GE(grows, arenas);
+    world->Step(10);
+    EXPECT_EQ(grows, boost::any_cast<unsigned int>(
+          odePhysics->GetParam("step_arena_grows")));
+  }
+
   // Test ode_quiet
   // convenient for disabling LCP internal error messages from world solver
   {
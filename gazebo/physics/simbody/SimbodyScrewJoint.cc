@@ -78,9 +78,12 @@ double SimbodyScrewJoint::GetVelocity(unsigned int _index) const
 void SimbodyScrewJoint::SetVelocity(unsigned int _index, double _rate)
 {
   if (_index < this->DOF())
+  {
     this->mobod.setOneU(
       this->simbodyPhysics->integ->updAdvancedState(),
       SimTK::MobilizerUIndex(_index), _rate);
+    this->MarkModelJointStatesStale();
+  }
   else
     gzerr << "SimbodyScrewJoint::SetVelocity _index too large.\n";
 }
@@ -67,6 +67,7 @@ void SimbodySliderJoint::SetVelocity(unsigned int _index, double _rate)
       SimTK::MobilizerUIndex(_index), _rate);
     this->simbodyPhysics->system.realize(
       this->simbodyPhysics->integ->getAdvancedState(), SimTK::Stage::Velocity);
+    this->MarkModelJointStatesStale();
   }
   else
     gzerr << "SetVelocity _index too large.\n";
@@ -102,6 +102,7 @@ void SimbodyUniversalJoint::SetVelocity(unsigned int _index,
       SimTK::MobilizerUIndex(_index), _rate);
     this->simbodyPhysics->system.realize(
       this->simbodyPhysics->integ->getAdvancedState(), SimTK::Stage::Velocity);
+    this->MarkModelJointStatesStale();
   }
   else
   {
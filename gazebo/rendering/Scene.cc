@@ -179,6 +179,9 @@ Scene::Scene(const std::string &_name, const bool _enableVisualizations,
   this->dataPtr->skeletonPoseSub =
       this->dataPtr->node->Subscribe("~/skeleton_pose/info",
       &Scene::OnSkeletonPoseMsg, this);
+  this->dataPtr->skeletonPoseVSub =
+      this->dataPtr->node->Subscribe("~/skeleton_pose/info_v",
+      &Scene::OnSkeletonPoseVMsg, this);
   this->dataPtr->skySub =
       this->dataPtr->node->Subscribe("~/sky", &Scene::OnSkyMsg, this);
   this->dataPtr->modelInfoSub = this->dataPtr->node->Subscribe("~/model/info",
@@ -220,6 +223,7 @@ void Scene::Clear()
   this->dataPtr->sensorSub.reset();
   this->dataPtr->sceneSub.reset();
   this->dataPtr->skeletonPoseSub.reset();
+  this->dataPtr->skeletonPoseVSub.reset();
   this->dataPtr->visSub.reset();
   this->dataPtr->skySub.reset();
   this->dataPtr->lightFactorySub.reset();
@@ -2932,6 +2936,17 @@ void Scene::OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg)
   this->dataPtr->skeletonPoseMsgs.push_back(_msg);
 }
 
+/////////////////////////////////////////////////
+void Scene::OnSkeletonPoseVMsg(ConstPoseAnimation_VPtr &_msg)
+{
+  for (int i = 0; i < _msg->pose_animation_size(); ++i)
+  {
+    ConstPoseAnimationPtr poseAnimMsg(
+        new msgs::PoseAnimation(_msg->pose_animation(i)));
+    this->OnSkeletonPoseMsg(poseAnimMsg);
+  }
+}
+
 /////////////////////////////////////////////////
 void Scene::OnRoadMsg(ConstRoadPtr &_msg)
 {
@@ -734,6 +734,10 @@ namespace gazebo
       /// \param[in] _msg The message data.
       private: void OnSkeletonPoseMsg(ConstPoseAnimationPtr &_msg);
 
+      /// \brief Aggregated skeleton animation callback.
+      /// \param[in] _msg The message data.
+      private: void OnSkeletonPoseVMsg(ConstPoseAnimation_VPtr &_msg);
+
       /// \brief Road message callback.
       /// \param[in] _msg The message data.
       private: void OnRoadMsg(ConstRoadPtr &_msg);
@@ -265,6 +265,10 @@ namespace gazebo
       /// \brief Subscribe to skeleton pose updates.
       public: transport::SubscriberPtr skeletonPoseSub;
 
+      /// \brief Subscribe to aggregated skeleton pose updates from actors
+      /// in crowd mode.
+      public: transport::SubscriberPtr skeletonPoseVSub;
+
       /// \brief Subscribe to sky updates.
       public: transport::SubscriberPtr skySub;
 
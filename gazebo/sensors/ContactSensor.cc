@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <sstream>
 
@@ -28,6 +29,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/ContactSubscription.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
@@ -114,12 +116,16 @@ void ContactSensor::Load(const std::string &_worldName)
     // request the contact manager to publish messages to a custom topic for
     // this sensor
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->dataPtr->filterName,
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
+    mgr->CreateFilter(this->dataPtr->filterName, this->dataPtr->collisions);
+
+    // read the contacts of the filter in-process, without the round-trip
+    // through the filter topic
+    if (!this->dataPtr->contactSubscription)
     {
-      this->dataPtr->contactSub = this->node->Subscribe(topic,
-          &ContactSensor::OnContacts, this);
+      this->dataPtr->contactSubscription = mgr->SubscribeFilter(
+          this->dataPtr->filterName,
+          ContactSensorPrivate::kStepCapacity *
+          this->dataPtr->collisions.size());
     }
   }
 }
@@ -139,64 +145,43 @@ bool ContactSensor::UpdateImpl(const bool /*_force*/)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Don't do anything if there is no new data to process.
-  if (this->dataPtr->incomingContacts.empty())
+  if (!this->dataPtr->contactSubscription ||
+      this->dataPtr->contactSubscription->StepCount() == 0)
+  {
     return false;
+  }
 
-  std::vector<std::string>::iterator collIter;
-  std::string collision1;
+  // Only process the contacts if the sensor is active, drop them otherwise.
+  if (!this->IsActive())
+  {
+    this->dataPtr->contactSubscription->Read(
+        [](const physics::ContactSample &) {});
+    return false;
+  }
 
   // Clear the outgoing contact message.
   this->dataPtr->contactsMsg.clear_contact();
 
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-       iter != this->dataPtr->incomingContacts.end(); ++iter)
+  // Iterate over all the contacts buffered since the last update
+  this->dataPtr->contactSubscription->Read(
+      [this](const physics::ContactSample &_contact)
   {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
+    // If this sensor is monitoring one of the collision's in the
+    // contact, then add the contact to our outgoing message.
+    if (std::find(this->dataPtr->collisions.begin(),
+          this->dataPtr->collisions.end(), _contact.collision1) !=
+        this->dataPtr->collisions.end() ||
+        std::find(this->dataPtr->collisions.begin(),
+          this->dataPtr->collisions.end(), _contact.collision2) !=
+        this->dataPtr->collisions.end())
     {
-      collision1 = (*iter)->contact(i).collision1();
-
-      // Try to find the first collision's name
-      collIter = std::find(this->dataPtr->collisions.begin(),
-          this->dataPtr->collisions.end(), collision1);
-
-      // If unable to find the first collision's name, try the second
-      if (collIter == this->dataPtr->collisions.end())
-      {
-        collision1 = (*iter)->contact(i).collision2();
-        collIter = std::find(this->dataPtr->collisions.begin(),
-            this->dataPtr->collisions.end(), collision1);
-      }
-
-      // If this sensor is monitoring one of the collision's in the
-      // contact, then add the contact to our outgoing message.
-      if (collIter != this->dataPtr->collisions.end())
-      {
-        int count = (*iter)->contact(i).position_size();
-
-        // Check to see if the contact arrays all have the same size.
-        if (count != (*iter)->contact(i).normal_size() ||
-            count != (*iter)->contact(i).wrench_size() ||
-            count != (*iter)->contact(i).depth_size())
-        {
-          gzerr << "Contact message has invalid array sizes\n";
-          continue;
-        }
-
-        // Copy the contact message.
-        msgs::Contact *contactMsg = this->dataPtr->contactsMsg.add_contact();
-        contactMsg->CopyFrom((*iter)->contact(i));
-      }
+      _contact.FillMsg(*this->dataPtr->contactsMsg.add_contact());
     }
-  }
+  });
 
   IGN_PROFILE_END();
   IGN_PROFILE_BEGIN("Publish");
 
-  // Clear the incoming contact list.
-  this->dataPtr->incomingContacts.clear();
-
   this->lastMeasurementTime = this->world->SimTime();
   msgs::Set(this->dataPtr->contactsMsg.mutable_time(),
             this->lastMeasurementTime);
@@ -222,7 +207,7 @@ void ContactSensor::Fini()
     mgr->RemoveFilter(this->dataPtr->filterName);
   }
 
-  this->dataPtr->contactSub.reset();
+  this->dataPtr->contactSubscription.reset();
   this->dataPtr->contactsPub.reset();
   Sensor::Fini();
 }
@@ -303,23 +288,6 @@ std::map<std::string, gazebo::physics::Contact> ContactSensor::Contacts(
   return result;
 }
 
-//////////////////////////////////////////////////
-void ContactSensor::OnContacts(ConstContactsPtr &_msg)
-{
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-  // Only store information if the sensor is active
-  if (this->IsActive())
-  {
-    // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
-
-    // Prevent the incomingContacts list to grow indefinitely.
-    if (this->dataPtr->incomingContacts.size() > 100)
-      this->dataPtr->incomingContacts.pop_front();
-  }
-}
-
 //////////////////////////////////////////////////
 bool ContactSensor::IsActive() const
 {
@@ -94,10 +94,10 @@ namespace gazebo
       /// to publish all contacts generated within a timestep onto
       /// Gazebo topic ~/physics/contacts.
       ///
-      /// Each ContactSensor subscribes to the Gazebo ~/physics/contacts topic,
-      /// retrieves all contact pairs in a time step and filters them wthin
-      /// ContactSensor::OnContacts against <collision> body name
-      /// specified by the ContactSensor SDF.
+      /// Each ContactSensor subscribes in-process to a ContactManager filter
+      /// for the <collision> bodies specified by the ContactSensor SDF,
+      /// and retrieves the contact pairs of these bodies buffered since its
+      /// last update.
       /// All collision pairs between ContactSensor <collision> body and
       /// other bodies in the world are stored in an array inside
       /// contacts.proto.
@@ -133,9 +133,6 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
-
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<ContactSensorPrivate> dataPtr;
@@ -20,6 +20,7 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/Model.hh"
+#include "gazebo/physics/SpatialIndex.hh"
 
 #include "gazebo/sensors/SensorFactory.hh"
 #include "gazebo/sensors/LogicalCameraSensorPrivate.hh"
@@ -112,28 +113,29 @@ void LogicalCameraSensor::Fini()
 
 //////////////////////////////////////////////////
 void LogicalCameraSensorPrivate::AddVisibleModels(
-    ignition::math::Pose3d &_myPose, const physics::Model_V &_models)
+    const ignition::math::Pose3d &_myPose, physics::SpatialIndex &_index)
 {
-  for (auto const &model : _models)
+  // Pick up models moved since the last world iteration. This does nothing
+  // if none moved.
+  _index.Refit();
+
+  // Nested models are indexed on their own, since the model AABB does not
+  // necessarily contain the nested models.
+  auto const models = _index.QueryFrustum(this->frustum,
+      physics::SpatialIndex::MODELS);
+
+  for (auto const &model : models)
   {
     auto const &scopedName = model->GetScopedName();
-    auto const aabb = model->BoundingBox();
-
-    if (this->modelName != scopedName && this->frustum.Contains(aabb))
-    {
-      // Add new model msg
-      msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
-
-      // Set the name and pose reported by the sensor.
-      modelMsg->set_name(scopedName);
-      msgs::Set(modelMsg->mutable_pose(),
-          model->WorldPose() - _myPose);
-    }
-    // Check nested models
-    // Note, the model AABB does not necessarily contain the nested model
-    // so nested models must be searched even if the frustum does not contain
-    // the parent model.
-    AddVisibleModels(_myPose, model->NestedModels());
+    if (this->modelName == scopedName)
+      continue;
+
+    // Add new model msg
+    msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
+
+    // Set the name and pose reported by the sensor.
+    modelMsg->set_name(scopedName);
+    msgs::Set(modelMsg->mutable_pose(), model->WorldPose() - _myPose);
   }
 }
 
@@ -158,8 +160,8 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Recursively check if models and nested models are in the frustum.
-    this->dataPtr->AddVisibleModels(myPose, this->world->Models());
+    // Check which models and nested models are in the frustum.
+    this->dataPtr->AddVisibleModels(myPose, this->world->SpatialIndex());
     IGN_PROFILE_END();
 
     IGN_PROFILE_BEGIN("Publish");
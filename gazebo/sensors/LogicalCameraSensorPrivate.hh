@@ -32,11 +32,12 @@ namespace gazebo
     /// \brief Logical camera sensor private data.
     class LogicalCameraSensorPrivate
     {
-      /// \brief Add models that are visible to the camera to a vector of models
+      /// \brief Add models that are visible to the camera to the message
       /// \param[in] _myPose pose of the logical camera
-      /// \param[in] _models list of models to test against frustum
-      public: void AddVisibleModels(ignition::math::Pose3d &_myPose,
-        const physics::Model_V &_models);
+      /// \param[in] _index spatial index of the world, queried with the
+      /// frustum
+      public: void AddVisibleModels(const ignition::math::Pose3d &_myPose,
+        physics::SpatialIndex &_index);
 
       /// \brief Publisher of msgs::LogicalCameraImage messages.
       public: transport::PublisherPtr pub;
@@ -18,6 +18,7 @@
 #include <functional>
 #include <boost/bind.hpp>
 
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/PhysicsIface.hh"
@@ -296,6 +297,8 @@ void PublishPerformanceMetrics()
 //////////////////////////////////////////////////
 void SensorManager::Update(bool _force)
 {
+  GZ_PROFILE_SCOPE("SensorManager::Update");
+
   {
     boost::recursive_mutex::scoped_lock lock(this->mutex);
 
@@ -848,6 +851,8 @@ void SensorManager::SensorContainer::RunLoop()
 //////////////////////////////////////////////////
 void SensorManager::SensorContainer::Update(bool _force)
 {
+  GZ_PROFILE_SCOPE("SensorManager::SensorContainer::Update");
+
   boost::recursive_mutex::scoped_lock lock(this->mutex);
 
   PublishPerformanceMetrics();
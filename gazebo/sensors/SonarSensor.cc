@@ -24,6 +24,7 @@
 #include "gazebo/physics/MeshShape.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/ContactSubscription.hh"
 #include "gazebo/physics/Collision.hh"
 
 #include "gazebo/common/Assert.hh"
@@ -192,15 +193,16 @@ void SonarSensor::Load(const std::string &_worldName)
     this->world->Physics()->GetContactManager();
     */
 
-  // Create a contact topic for the collision shape
-  std::string topic =
-    this->world->Physics()->GetContactManager()->CreateFilter(
-        this->dataPtr->sonarCollision->GetScopedName(),
-        this->dataPtr->sonarCollision->GetScopedName());
+  // Create a contact filter for the collision shape
+  physics::ContactManager *contactMgr =
+    this->world->Physics()->GetContactManager();
+  contactMgr->CreateFilter(this->dataPtr->sonarCollision->GetScopedName(),
+      this->dataPtr->sonarCollision->GetScopedName());
 
-  // Subscribe to the contact topic
-  this->dataPtr->contactSub = this->node->Subscribe(topic,
-      &SonarSensor::OnContacts, this);
+  // Read the contacts of the filter in-process
+  this->dataPtr->contactSubscription = contactMgr->SubscribeFilter(
+      this->dataPtr->sonarCollision->GetScopedName(),
+      SonarSensorPrivate::kContactCapacity);
 
   // Advertise the sensor's topic on which we will output range data.
   this->dataPtr->sonarPub = this->node->Advertise<msgs::SonarStamped>(
@@ -244,7 +246,7 @@ void SonarSensor::Fini()
   }
 
   this->dataPtr->sonarPub.reset();
-  this->dataPtr->contactSub.reset();
+  this->dataPtr->contactSubscription.reset();
   Sensor::Fini();
 }
 
@@ -296,12 +298,41 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
   msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_world_pose(),
       referencePose);
 
-  ignition::math::Vector3d pos;
+  // Find the closest of the contacts buffered since the last update. The
+  // contacts are dropped if the sensor is not active.
+  bool hasContacts = false;
+  double minLen = this->dataPtr->rangeMax;
+  ignition::math::Vector3d minPos;
+  if (this->dataPtr->contactSubscription)
+  {
+    const bool active = this->IsActive();
+    this->dataPtr->contactSubscription->Read(
+        [&](const physics::ContactSample &_contact)
+    {
+      if (!active || _contact.positions.empty())
+        return;
+      hasContacts = true;
+
+      for (size_t j = 0; j < _contact.positions.size(); ++j)
+      {
+        // Get the contact position relative to the reference position.
+        ignition::math::Vector3d pos =
+          _contact.positions[j] - referencePose.Pos();
+
+        // Compute the sensed range.
+        double len = pos.Length() - _contact.depths[j];
+        if (len < minLen)
+        {
+          minLen = len;
+          minPos = pos;
+        }
+      }
+    });
+  }
 
   // A 5-step hysteresis window was chosen to reduce range value from
   // bouncing.
-  if (!this->dataPtr->incomingContacts.empty() ||
-      this->dataPtr->emptyContactCount > 5)
+  if (hasContacts || this->dataPtr->emptyContactCount > 5)
   {
     this->dataPtr->sonarMsg.mutable_sonar()->set_range(
         this->dataPtr->rangeMax);
@@ -312,45 +343,14 @@ bool SonarSensor::UpdateImpl(const bool /*_force*/)
     ++this->dataPtr->emptyContactCount;
   }
 
-
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-      iter != this->dataPtr->incomingContacts.end(); ++iter)
+  // Copy the closest contact.
+  if (hasContacts && minLen < this->dataPtr->sonarMsg.sonar().range())
   {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
-    {
-      // Debug output:
-      // std::cout << "C1[" << (*iter)->contact(i).collision1() << "]"
-      //   << "C2[" << (*iter)->contact(i).collision2() << "]\n";
-
-      for (int j = 0; j < (*iter)->contact(i).position_size(); ++j)
-      {
-        // Get the contact position relative to the reference position.
-        pos = msgs::ConvertIgn((*iter)->contact(i).position(j)) -
-          referencePose.Pos();
-
-        // Compute the sensed range.
-        double len = pos.Length() - (*iter)->contact(i).depth(j);
-
-        // Debug output:
-        // std::cout << "  RP[" << referencePose << "]  P[" << pos
-        //   << "] L[" << len << "] D["
-        //   << (*iter)->contact(i).depth(j) << "]\n";
-
-        // Copy the contact message.
-        if (len < this->dataPtr->sonarMsg.sonar().range())
-        {
-          this->dataPtr->sonarMsg.mutable_sonar()->set_range(len);
-          msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
-              referencePose.Rot().RotateVectorReverse(pos));
-        }
-      }
-    }
+    this->dataPtr->sonarMsg.mutable_sonar()->set_range(minLen);
+    msgs::Set(this->dataPtr->sonarMsg.mutable_sonar()->mutable_contact(),
+        referencePose.Rot().RotateVectorReverse(minPos));
   }
 
-  // Clear the incoming contact list.
-  this->dataPtr->incomingContacts.clear();
   IGN_PROFILE_END();
 
   IGN_PROFILE_BEGIN("Publish");
@@ -369,23 +369,6 @@ bool SonarSensor::IsActive() const
   return Sensor::IsActive() || this->dataPtr->sonarPub->HasConnections();
 }
 
-//////////////////////////////////////////////////
-void SonarSensor::OnContacts(ConstContactsPtr &_msg)
-{
-  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-  // Only store information if the sensor is active
-  if (this->IsActive() && _msg->contact_size() > 0)
-  {
-    // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
-
-    // Prevent the incomingContacts list to grow indefinitely.
-    if (this->dataPtr->incomingContacts.size() > 100)
-      this->dataPtr->incomingContacts.pop_front();
-  }
-}
-
 //////////////////////////////////////////////////
 event::ConnectionPtr SonarSensor::ConnectUpdate(
     std::function<void (msgs::SonarStamped)> _subscriber)
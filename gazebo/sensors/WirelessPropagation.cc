@@ -0,0 +1,533 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Rand.hh>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/SpatialIndex.hh"
+#include "gazebo/sensors/WirelessReceiver.hh"
+#include "gazebo/sensors/WirelessTransmitter.hh"
+#include "gazebo/sensors/WirelessTransmitterPrivate.hh"
+
+#include "gazebo/sensors/WirelessPropagationPrivate.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+/////////////////////////////////////////////////
+/// \brief Check if a segment may hit a link found by a box query.
+/// \param[in] _entity Link whose box is crossed by the segment.
+/// \param[in] _start First point of the segment.
+/// \param[in] _end Last point of the segment.
+/// \return False only if the link is made of planes and both points
+/// are above all of them.
+static bool MayHit(const physics::EntityPtr &_entity,
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end)
+{
+  // Ground planes have an unbounded box and would otherwise force a ray
+  // cast for every segment.
+  physics::LinkPtr link = boost::dynamic_pointer_cast<physics::Link>(_entity);
+  if (!link)
+    return true;
+
+  for (auto const &collision : link->GetCollisions())
+  {
+    physics::PlaneShapePtr plane =
+        boost::dynamic_pointer_cast<physics::PlaneShape>(
+        collision->GetShape());
+    if (!plane)
+      return true;
+
+    ignition::math::Pose3d pose = collision->WorldPose();
+    ignition::math::Vector3d normal = pose.Rot().RotateVector(plane->Normal());
+    if (normal.Dot(_start - pose.Pos()) <= 0 ||
+        normal.Dot(_end - pose.Pos()) <= 0)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+/// \brief Compute the signal strength of a transmitter at many points.
+/// \param[in] _tx Transmitter.
+/// \param[in] _from Position of the transmitter's antenna.
+/// \param[in] _to Positions of the receiver's antenna.
+/// \param[in] _obstructed 1 if there is an obstacle before a point.
+/// \param[in] _rxGain Gain of the receiver's antenna (dBi).
+/// \param[out] _strengths Signal strength at each point (dBm).
+static void Strengths(const WirelessTransmitter &_tx,
+    const ignition::math::Vector3d &_from,
+    const std::vector<ignition::math::Vector3d> &_to,
+    const std::vector<uint8_t> &_obstructed,
+    const double _rxGain,
+    std::vector<double> &_strengths)
+{
+  const size_t count = _to.size();
+  std::vector<double> base(count, _tx.Power() + _tx.Gain() + _rxGain +
+      WirelessPropagation::ReferenceLoss(_tx.Freq()));
+  std::vector<double> distance(count);
+  std::vector<double> n(count);
+  std::vector<double> fading(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    distance[i] = _from.Distance(_to[i]);
+    n[i] = _obstructed[i] ? WirelessTransmitterPrivate::NObstacle :
+        WirelessTransmitterPrivate::NEmpty;
+    fading[i] = std::abs(ignition::math::Rand::DblNormal(0.0,
+        WirelessTransmitterPrivate::ModelStdDev));
+  }
+
+  _strengths.resize(count);
+  WirelessPropagation::PathLoss(count, base.data(), distance.data(),
+      n.data(), fading.data(), _strengths.data());
+}
+
+/////////////////////////////////////////////////
+WirelessPropagation::WirelessPropagation()
+  : dataPtr(new WirelessPropagationPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+WirelessPropagation::~WirelessPropagation()
+{
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::AddTransmitter(WirelessTransmitter *_tx,
+    const physics::WorldPtr &_world)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (std::find(this->dataPtr->transmitters.begin(),
+        this->dataPtr->transmitters.end(), _tx) !=
+      this->dataPtr->transmitters.end())
+  {
+    return;
+  }
+
+  if (this->dataPtr->world != _world)
+  {
+    this->dataPtr->ray.reset();
+    this->dataPtr->world = _world;
+  }
+
+  this->dataPtr->transmitters.push_back(_tx);
+  this->dataPtr->linksValid = false;
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::RemoveTransmitter(const WirelessTransmitter *_tx)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &txs = this->dataPtr->transmitters;
+  txs.erase(std::remove(txs.begin(), txs.end(), _tx), txs.end());
+
+  auto &pairs = this->dataPtr->pairCache;
+  for (auto iter = pairs.begin(); iter != pairs.end();)
+  {
+    if (iter->first.first == _tx)
+      iter = pairs.erase(iter);
+    else
+      ++iter;
+  }
+
+  this->dataPtr->gridCache.erase(_tx);
+  this->dataPtr->linksValid = false;
+  this->dataPtr->ReleaseIfUnused();
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::AddReceiver(WirelessReceiver *_rx,
+    const physics::WorldPtr &_world)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (std::find(this->dataPtr->receivers.begin(),
+        this->dataPtr->receivers.end(), _rx) !=
+      this->dataPtr->receivers.end())
+  {
+    return;
+  }
+
+  if (this->dataPtr->world != _world)
+  {
+    this->dataPtr->ray.reset();
+    this->dataPtr->world = _world;
+  }
+
+  this->dataPtr->receivers.push_back(_rx);
+  this->dataPtr->linksValid = false;
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::RemoveReceiver(const WirelessReceiver *_rx)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &rxs = this->dataPtr->receivers;
+  rxs.erase(std::remove(rxs.begin(), rxs.end(), _rx), rxs.end());
+
+  auto &pairs = this->dataPtr->pairCache;
+  for (auto iter = pairs.begin(); iter != pairs.end();)
+  {
+    if (iter->first.second == _rx)
+      iter = pairs.erase(iter);
+    else
+      ++iter;
+  }
+
+  this->dataPtr->links.erase(_rx);
+  this->dataPtr->linksValid = false;
+  this->dataPtr->ReleaseIfUnused();
+}
+
+/////////////////////////////////////////////////
+std::vector<WirelessLink> WirelessPropagation::Links(
+    const WirelessReceiver *_rx)
+{
+  IGN_PROFILE("WirelessPropagation::Links");
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->world)
+    return std::vector<WirelessLink>();
+
+  // All the receivers updated at the same simulation time share the
+  // result of a single pass.
+  common::Time now = this->dataPtr->world->SimTime();
+  if (!this->dataPtr->linksValid || now != this->dataPtr->linksTime)
+  {
+    this->dataPtr->UpdateLinks(now);
+    this->dataPtr->linksTime = now;
+    this->dataPtr->linksValid = true;
+  }
+
+  auto iter = this->dataPtr->links.find(_rx);
+  if (iter == this->dataPtr->links.end())
+    return std::vector<WirelessLink>();
+  return iter->second;
+}
+
+/////////////////////////////////////////////////
+double WirelessPropagation::SignalStrength(const WirelessTransmitter &_tx,
+    const ignition::math::Vector3d &_from,
+    const ignition::math::Vector3d &_to,
+    const double _rxGain)
+{
+  std::vector<ignition::math::Vector3d> starts(1, _from);
+  std::vector<ignition::math::Vector3d> ends(1, _to);
+  std::vector<uint8_t> obstructed(1, 0);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->Obstacles(starts, ends, std::vector<size_t>(1, 0),
+        obstructed);
+  }
+
+  std::vector<double> strengths;
+  Strengths(_tx, _from, ends, obstructed, _rxGain, strengths);
+  return strengths[0];
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::SignalStrengths(const WirelessTransmitter &_tx,
+    const ignition::math::Vector3d &_from,
+    const std::vector<ignition::math::Vector3d> &_to,
+    const double _rxGain,
+    std::vector<double> &_strengths)
+{
+  IGN_PROFILE("WirelessPropagation::SignalStrengths");
+  std::vector<uint8_t> obstructed;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    common::Time now;
+    if (this->dataPtr->world)
+      now = this->dataPtr->world->SimTime();
+
+    WirelessGridCache &cache = this->dataPtr->gridCache[&_tx];
+    if (!this->dataPtr->Expired(cache.time, now) &&
+        cache.origin == _from && cache.points == _to)
+    {
+      this->dataPtr->cacheHits += _to.size();
+    }
+    else
+    {
+      std::vector<ignition::math::Vector3d> starts(_to.size(), _from);
+      std::vector<size_t> indices(_to.size());
+      for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+
+      cache.obstructed.assign(_to.size(), 0);
+      this->dataPtr->Obstacles(starts, _to, indices, cache.obstructed);
+      cache.origin = _from;
+      cache.points = _to;
+      cache.time = now;
+    }
+    obstructed = cache.obstructed;
+  }
+
+  Strengths(_tx, _from, _to, obstructed, _rxGain, _strengths);
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::SetCacheMaxAge(const common::Time &_age)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxAge = _age;
+}
+
+/////////////////////////////////////////////////
+common::Time WirelessPropagation::CacheMaxAge() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->maxAge;
+}
+
+/////////////////////////////////////////////////
+uint64_t WirelessPropagation::RayCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->rayCount;
+}
+
+/////////////////////////////////////////////////
+uint64_t WirelessPropagation::CacheHits() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cacheHits;
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::PathLoss(const size_t _count,
+    const double *_base, const double *_distance,
+    const double *_n, const double *_fading,
+    double *_rxPower)
+{
+  // Hata-Okumara propagation model, as a plain loop over arrays so that
+  // the compiler can vectorize it.
+  for (size_t i = 0; i < _count; ++i)
+  {
+    _rxPower[i] = _base[i] - _fading[i] -
+        10.0 * _n[i] * std::log10(std::max(1.0, _distance[i]));
+  }
+}
+
+/////////////////////////////////////////////////
+double WirelessPropagation::ReferenceLoss(const double _freq)
+{
+  double wavelength = common::SpeedOfLight / (_freq * 1000000);
+  return 20 * log10(wavelength) - 20 * log10(4 * M_PI);
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagationPrivate::Obstacles(
+    const std::vector<ignition::math::Vector3d> &_starts,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    const std::vector<size_t> &_indices,
+    std::vector<uint8_t> &_obstructed)
+{
+  for (auto const i : _indices)
+    _obstructed[i] = 0;
+
+  if (!this->world)
+    return;
+
+  // Only cast the rays which cross the box of a link.
+  physics::SpatialIndex &index = this->world->SpatialIndex();
+  std::vector<size_t> cast;
+  for (auto const i : _indices)
+  {
+    ignition::math::Vector3d dir = _ends[i] - _starts[i];
+    double length = dir.Length();
+    if (length <= 0)
+    {
+      cast.push_back(i);
+      continue;
+    }
+    dir /= length;
+
+    for (auto const &entity : index.QueryRay(_starts[i], dir, length,
+          physics::SpatialIndex::LINKS))
+    {
+      if (MayHit(entity, _starts[i], _ends[i]))
+      {
+        cast.push_back(i);
+        break;
+      }
+    }
+  }
+
+  if (cast.empty())
+    return;
+
+  physics::PhysicsEnginePtr engine = this->world->Physics();
+  if (!this->ray)
+  {
+    this->ray = boost::dynamic_pointer_cast<physics::RayShape>(
+        engine->CreateShape("ray", physics::CollisionPtr()));
+  }
+  engine->InitForThread();
+
+  // Acquire the mutex once for all the rays, to avoid a race condition
+  // with the physics engine
+  boost::recursive_mutex::scoped_lock lock(
+      *engine->GetPhysicsUpdateMutex());
+
+  std::string entityName;
+  double dist;
+  for (auto const i : cast)
+  {
+    ignition::math::Vector3d end = _ends[i];
+
+    // Avoid computing the intersection of coincident points
+    // This prevents an assertion in bullet (issue #849)
+    if (_starts[i] == end)
+      end.Z() += 0.00001;
+
+    this->ray->SetPoints(_starts[i], end);
+    this->ray->GetIntersection(dist, entityName);
+    ++this->rayCount;
+
+    // ToDo: The ray intersects with my own collision model. Fix it.
+    _obstructed[i] = !entityName.empty();
+  }
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagationPrivate::UpdateLinks(const common::Time &_now)
+{
+  this->links.clear();
+
+  // Gather the pairs in band, and look for cached obstacle tests
+  std::vector<const WirelessTransmitter *> pairTx;
+  std::vector<const WirelessReceiver *> pairRx;
+  std::vector<ignition::math::Vector3d> starts;
+  std::vector<ignition::math::Vector3d> ends;
+  std::vector<uint8_t> obstructed;
+  std::vector<size_t> pending;
+  std::vector<double> base;
+
+  std::vector<ignition::math::Vector3d> txPos;
+  for (auto const tx : this->transmitters)
+    txPos.push_back(tx->AntennaPose().Pos());
+
+  for (auto const rx : this->receivers)
+  {
+    // Receivers without any transmitter in band get an empty list
+    this->links[rx];
+    ignition::math::Vector3d rxPos = rx->AntennaPose().Pos();
+
+    for (size_t t = 0; t < this->transmitters.size(); ++t)
+    {
+      const WirelessTransmitter *tx = this->transmitters[t];
+      double freq = tx->Freq();
+      if (freq < rx->MinFreqFiltered() || freq > rx->MaxFreqFiltered())
+        continue;
+
+      size_t k = starts.size();
+      pairTx.push_back(tx);
+      pairRx.push_back(rx);
+      starts.push_back(txPos[t]);
+      ends.push_back(rxPos);
+      base.push_back(tx->Power() + tx->Gain() + rx->Gain() +
+          WirelessPropagation::ReferenceLoss(freq));
+
+      auto iter = this->pairCache.find(std::make_pair(tx, rx));
+      if (iter != this->pairCache.end() &&
+          !this->Expired(iter->second.time, _now) &&
+          iter->second.txPos.Distance(txPos[t]) <= this->moveTolerance &&
+          iter->second.rxPos.Distance(rxPos) <= this->moveTolerance)
+      {
+        obstructed.push_back(iter->second.obstructed);
+        ++this->cacheHits;
+      }
+      else
+      {
+        obstructed.push_back(0);
+        pending.push_back(k);
+      }
+    }
+  }
+
+  this->Obstacles(starts, ends, pending, obstructed);
+  for (auto const k : pending)
+  {
+    WirelessPairCache &cache =
+        this->pairCache[std::make_pair(pairTx[k], pairRx[k])];
+    cache.txPos = starts[k];
+    cache.rxPos = ends[k];
+    cache.time = _now;
+    cache.obstructed = obstructed[k] != 0;
+  }
+
+  // Evaluate the model for all the pairs at once
+  const size_t count = starts.size();
+  std::vector<double> distance(count);
+  std::vector<double> n(count);
+  std::vector<double> fading(count);
+  std::vector<double> rxPower(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    distance[k] = starts[k].Distance(ends[k]);
+    n[k] = obstructed[k] ? WirelessTransmitterPrivate::NObstacle :
+        WirelessTransmitterPrivate::NEmpty;
+    fading[k] = std::abs(ignition::math::Rand::DblNormal(0.0,
+        WirelessTransmitterPrivate::ModelStdDev));
+  }
+  WirelessPropagation::PathLoss(count, base.data(), distance.data(),
+      n.data(), fading.data(), rxPower.data());
+
+  for (size_t k = 0; k < count; ++k)
+  {
+    WirelessLink link;
+    link.essid = pairTx[k]->ESSID();
+    link.frequency = pairTx[k]->Freq();
+    link.signalLevel = rxPower[k];
+    this->links[pairRx[k]].push_back(link);
+  }
+}
+
+/////////////////////////////////////////////////
+bool WirelessPropagationPrivate::Expired(const common::Time &_time,
+    const common::Time &_now) const
+{
+  // A test from the future means that the world was reset.
+  return this->maxAge <= common::Time::Zero || _time > _now ||
+      _now - _time >= this->maxAge;
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagationPrivate::ReleaseIfUnused()
+{
+  if (!this->transmitters.empty() || !this->receivers.empty())
+    return;
+
+  // Don't keep the physics engine alive after the sensors are gone.
+  this->ray.reset();
+  this->world.reset();
+  this->pairCache.clear();
+  this->gridCache.clear();
+  this->links.clear();
+  this->linksValid = false;
+}
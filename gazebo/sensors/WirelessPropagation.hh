@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_WIRELESSPROPAGATION_HH_
+#define GAZEBO_SENSORS_WIRELESSPROPAGATION_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_SENSORS_VISIBLE, gazebo, sensors,
+    WirelessPropagation)
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declarations
+    class WirelessPropagationPrivate;
+    class WirelessReceiver;
+    class WirelessTransmitter;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \brief A transmitter heard by a receiver.
+    class GZ_SENSORS_VISIBLE WirelessLink
+    {
+      /// \brief Service Set Identifier of the transmitter.
+      public: std::string essid;
+
+      /// \brief Frequency of the transmitter (MHz).
+      public: double frequency = 0.0;
+
+      /// \brief Signal strength at the receiver (dBm).
+      public: double signalLevel = 0.0;
+    };
+
+    /// \class WirelessPropagation WirelessPropagation.hh sensors/sensors.hh
+    /// \brief Computes the link budgets of all the wireless transmitters
+    /// and receivers of a world.
+    ///
+    /// Transmitters and receivers register themselves when they are
+    /// initialized. The first receiver that asks for its links at a given
+    /// simulation time triggers the computation of all the transmitter /
+    /// receiver pairs; the others reuse the result. Pairs outside the
+    /// band of the receiver are discarded before any ray is cast.
+    ///
+    /// Obstacles are detected with a ray cast between both antennas. The
+    /// result is cached while neither antenna moves and for at most
+    /// CacheMaxAge of simulation time, so moving obstacles are picked up
+    /// within that delay. Rays which don't cross the bounding box of any
+    /// link of the world's SpatialIndex are not cast.
+    ///
+    /// The path loss uses the same log-distance model as
+    /// WirelessTransmitter::SignalStrength, evaluated over arrays.
+    class GZ_SENSORS_VISIBLE WirelessPropagation
+      : public SingletonT<WirelessPropagation>
+    {
+      /// \brief Constructor.
+      private: WirelessPropagation();
+
+      /// \brief Destructor.
+      private: virtual ~WirelessPropagation();
+
+      /// \brief Register a transmitter.
+      /// \param[in] _tx Transmitter, which must call RemoveTransmitter
+      /// before it is destroyed.
+      /// \param[in] _world World of the transmitter.
+      public: void AddTransmitter(WirelessTransmitter *_tx,
+                  const physics::WorldPtr &_world);
+
+      /// \brief Unregister a transmitter.
+      /// \param[in] _tx Transmitter to remove.
+      public: void RemoveTransmitter(const WirelessTransmitter *_tx);
+
+      /// \brief Register a receiver.
+      /// \param[in] _rx Receiver, which must call RemoveReceiver before it
+      /// is destroyed.
+      /// \param[in] _world World of the receiver.
+      public: void AddReceiver(WirelessReceiver *_rx,
+                  const physics::WorldPtr &_world);
+
+      /// \brief Unregister a receiver.
+      /// \param[in] _rx Receiver to remove.
+      public: void RemoveReceiver(const WirelessReceiver *_rx);
+
+      /// \brief Get the transmitters in the band of a receiver, with their
+      /// signal strength at the receiver's antenna. The sensitivity of the
+      /// receiver isn't applied.
+      /// \param[in] _rx A registered receiver.
+      /// \return Links, in the order in which transmitters were added.
+      public: std::vector<WirelessLink> Links(const WirelessReceiver *_rx);
+
+      /// \brief Get the signal strength of a transmitter at one point. The
+      /// obstacle test isn't cached.
+      /// \param[in] _tx A registered transmitter.
+      /// \param[in] _from Position of the transmitter's antenna.
+      /// \param[in] _to Position of the receiver's antenna.
+      /// \param[in] _rxGain Gain of the receiver's antenna (dBi).
+      /// \return Signal strength (dBm).
+      public: double SignalStrength(const WirelessTransmitter &_tx,
+                  const ignition::math::Vector3d &_from,
+                  const ignition::math::Vector3d &_to,
+                  const double _rxGain);
+
+      /// \brief Get the signal strength of a transmitter at many points.
+      /// The obstacle tests are cached per transmitter, and reused while
+      /// the origin and the points are the same.
+      /// \param[in] _tx A registered transmitter.
+      /// \param[in] _from Position of the transmitter's antenna.
+      /// \param[in] _to Positions of the receiver's antenna.
+      /// \param[in] _rxGain Gain of the receiver's antenna (dBi).
+      /// \param[out] _strengths Signal strength at each point (dBm).
+      public: void SignalStrengths(const WirelessTransmitter &_tx,
+                  const ignition::math::Vector3d &_from,
+                  const std::vector<ignition::math::Vector3d> &_to,
+                  const double _rxGain,
+                  std::vector<double> &_strengths);
+
+      /// \brief Set how long an obstacle test stays valid.
+      /// \param[in] _age Simulation time, zero disables the cache.
+      public: void SetCacheMaxAge(const common::Time &_age);
+
+      /// \brief Get how long an obstacle test stays valid.
+      /// \return Simulation time.
+      public: common::Time CacheMaxAge() const;
+
+      /// \brief Get the number of rays cast in the physics engine.
+      /// \return Number of rays since the first registration.
+      public: uint64_t RayCount() const;
+
+      /// \brief Get the number of obstacle tests answered by the cache.
+      /// \return Number of cache hits since the first registration.
+      public: uint64_t CacheHits() const;
+
+      /// \brief Compute the received power of many links with the
+      /// log-distance path loss model:
+      /// _rxPower[i] = _base[i] - _fading[i]
+      ///               - 10 * _n[i] * log10(max(1, _distance[i]))
+      /// \param[in] _count Number of links.
+      /// \param[in] _base Transmitted power plus the antenna gains and
+      /// the free space loss at one meter (dBm).
+      /// \param[in] _distance Distance between the antennas (m).
+      /// \param[in] _n Path loss exponent.
+      /// \param[in] _fading Fading (dB).
+      /// \param[out] _rxPower Received power (dBm).
+      public: static void PathLoss(const size_t _count,
+                  const double *_base, const double *_distance,
+                  const double *_n, const double *_fading,
+                  double *_rxPower);
+
+      /// \brief Get the free space loss at one meter.
+      /// \param[in] _freq Frequency (MHz).
+      /// \return 20 * log10(wavelength / (4 * pi)) (dB).
+      public: static double ReferenceLoss(const double _freq);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WirelessPropagationPrivate> dataPtr;
+
+      /// \brief This is a singleton.
+      private: friend class SingletonT<WirelessPropagation>;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_WIRELESSPROPAGATIONPRIVATE_HH_
+#define GAZEBO_SENSORS_WIRELESSPROPAGATIONPRIVATE_HH_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \brief Cached obstacle test between a transmitter and a receiver.
+    struct WirelessPairCache
+    {
+      /// \brief Position of the transmitter's antenna.
+      ignition::math::Vector3d txPos;
+
+      /// \brief Position of the receiver's antenna.
+      ignition::math::Vector3d rxPos;
+
+      /// \brief Simulation time of the test.
+      common::Time time;
+
+      /// \brief True if an obstacle was found.
+      bool obstructed = false;
+    };
+
+    /// \brief Cached obstacle tests of a visualization grid.
+    struct WirelessGridCache
+    {
+      /// \brief Position of the transmitter's antenna.
+      ignition::math::Vector3d origin;
+
+      /// \brief Points of the grid.
+      std::vector<ignition::math::Vector3d> points;
+
+      /// \brief Simulation time of the tests.
+      common::Time time;
+
+      /// \brief 1 if an obstacle was found between the origin and a point.
+      std::vector<uint8_t> obstructed;
+    };
+
+    /// \internal
+    /// \brief Private data for the WirelessPropagation class.
+    class WirelessPropagationPrivate
+    {
+      /// \brief Look for obstacles along segments. Must be called with
+      /// mutex locked.
+      /// \param[in] _starts First point of each segment.
+      /// \param[in] _ends Last point of each segment.
+      /// \param[in] _indices Indices of the segments to test.
+      /// \param[in,out] _obstructed Set to 1 for the segments of _indices
+      /// which hit an obstacle, 0 for the others.
+      public: void Obstacles(
+                  const std::vector<ignition::math::Vector3d> &_starts,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  const std::vector<size_t> &_indices,
+                  std::vector<uint8_t> &_obstructed);
+
+      /// \brief Compute the links of all the receivers. Must be called
+      /// with mutex locked.
+      /// \param[in] _now Current simulation time.
+      public: void UpdateLinks(const common::Time &_now);
+
+      /// \brief Check if a cached test is too old. Must be called with
+      /// mutex locked.
+      /// \param[in] _time Simulation time of the test.
+      /// \param[in] _now Current simulation time.
+      /// \return True if the test must be done again.
+      public: bool Expired(const common::Time &_time,
+                  const common::Time &_now) const;
+
+      /// \brief Drop the world and the caches once all the transceivers
+      /// are gone. Must be called with mutex locked.
+      public: void ReleaseIfUnused();
+
+      /// \brief Registered transmitters, in order of registration.
+      public: std::vector<WirelessTransmitter *> transmitters;
+
+      /// \brief Registered receivers, in order of registration.
+      public: std::vector<WirelessReceiver *> receivers;
+
+      /// \brief World of the transceivers.
+      public: physics::WorldPtr world;
+
+      /// \brief Ray used for all the obstacle tests.
+      public: physics::RayShapePtr ray;
+
+      /// \brief Obstacle tests between transmitters and receivers.
+      public: std::map<std::pair<const WirelessTransmitter *,
+              const WirelessReceiver *>, WirelessPairCache> pairCache;
+
+      /// \brief Obstacle tests of the visualization grids.
+      public: std::map<const WirelessTransmitter *, WirelessGridCache>
+              gridCache;
+
+      /// \brief Links of each receiver, computed at linksTime.
+      public: std::map<const WirelessReceiver *, std::vector<WirelessLink>>
+              links;
+
+      /// \brief Simulation time of the links.
+      public: common::Time linksTime;
+
+      /// \brief True if links is up to date with the registered
+      /// transceivers.
+      public: bool linksValid = false;
+
+      /// \brief How long an obstacle test stays valid.
+      public: common::Time maxAge = common::Time(1, 0);
+
+      /// \brief An antenna that moved less than this distance reuses the
+      /// cached tests (m).
+      public: double moveTolerance = 1e-3;
+
+      /// \brief Number of rays cast.
+      public: uint64_t rayCount = 0;
+
+      /// \brief Number of tests answered by a cache.
+      public: uint64_t cacheHits = 0;
+
+      /// \brief Protects all members above.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+#endif
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gazebo/common/CommonTypes.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WirelessPropagationTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Path loss of a single link, as computed by
+/// WirelessTransmitter::SignalStrength before the batched model.
+double ScalarRxPower(const double _power, const double _txGain,
+    const double _rxGain, const double _freq, const double _dist,
+    const double _n, const double _x)
+{
+  double distance = std::max(1.0, _dist);
+  double wavelength = common::SpeedOfLight / (_freq * 1000000);
+  return _power + _txGain + _rxGain - _x +
+      20 * log10(wavelength) - 20 * log10(4 * M_PI) -
+      10 * _n * log10(distance);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WirelessPropagationTest, PathLossMatchesScalarModel)
+{
+  const double power = 14.5;
+  const double txGain = 2.6;
+  const double rxGain = 2.5;
+  const double freq = 2442.0;
+
+  std::vector<double> base;
+  std::vector<double> distance;
+  std::vector<double> n;
+  std::vector<double> fading;
+  for (int i = 0; i < 103; ++i)
+  {
+    base.push_back(power + txGain + rxGain +
+        sensors::WirelessPropagation::ReferenceLoss(freq));
+    distance.push_back(i * 0.37);
+    n.push_back(i % 3 == 0 ? 12.0 : 6.0);
+    fading.push_back((i % 7) * 1.3);
+  }
+
+  std::vector<double> rxPower(base.size());
+  sensors::WirelessPropagation::PathLoss(base.size(), base.data(),
+      distance.data(), n.data(), fading.data(), rxPower.data());
+
+  for (size_t i = 0; i < base.size(); ++i)
+  {
+    EXPECT_NEAR(ScalarRxPower(power, txGain, rxGain, freq, distance[i],
+          n[i], fading[i]), rxPower[i], 1e-9);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(WirelessPropagationTest, NoWorld)
+{
+  auto propagation = sensors::WirelessPropagation::Instance();
+
+  // Nothing registered
+  EXPECT_TRUE(propagation->Links(nullptr).empty());
+  EXPECT_EQ(0u, propagation->RayCount());
+
+  common::Time age = propagation->CacheMaxAge();
+  EXPECT_EQ(common::Time(1, 0), age);
+  propagation->SetCacheMaxAge(common::Time(2, 500000000));
+  EXPECT_EQ(common::Time(2, 500000000), propagation->CacheMaxAge());
+  propagation->SetCacheMaxAge(age);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
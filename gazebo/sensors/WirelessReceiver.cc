@@ -19,13 +19,12 @@
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/sensors/SensorFactory.hh"
-#include "gazebo/sensors/SensorManager.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 
 #include "gazebo/sensors/WirelessReceiverPrivate.hh"
 #include "gazebo/sensors/WirelessReceiver.hh"
-#include "gazebo/sensors/WirelessTransmitter.hh"
 
 using namespace gazebo;
 using namespace sensors;
@@ -48,6 +47,8 @@ WirelessReceiver::~WirelessReceiver()
 void WirelessReceiver::Init()
 {
   WirelessTransceiver::Init();
+
+  WirelessPropagation::Instance()->AddReceiver(this, this->world);
 }
 
 /////////////////////////////////////////////////
@@ -106,41 +107,27 @@ bool WirelessReceiver::UpdateImpl(const bool /*_force*/)
   IGN_PROFILE("WirelessReceiver::UpdateImpl");
   IGN_PROFILE_BEGIN("Update");
 
-  std::string txEssid;
   msgs::WirelessNodes msg;
-  double rxPower;
-  double txFreq;
 
   this->referencePose = this->pose + this->parentEntity.lock()->WorldPose();
 
-  ignition::math::Pose3d myPos = this->referencePose;
-  Sensor_V sensors = SensorManager::Instance()->GetSensors();
-  for (Sensor_V::iterator it = sensors.begin(); it != sensors.end(); ++it)
+  // The links of all the receivers are computed together, once per
+  // simulation time
+  for (auto const &link : WirelessPropagation::Instance()->Links(this))
   {
-    if ((*it)->Type() == "wireless_transmitter")
+    // Discard if the frequency received is out of our frequency range,
+    // or if the received signal strengh is lower than the sensivity
+    if ((link.frequency < this->MinFreqFiltered()) ||
+        (link.frequency > this->MaxFreqFiltered()) ||
+        (link.signalLevel < this->Sensitivity()))
     {
-      std::shared_ptr<gazebo::sensors::WirelessTransmitter> transmitter =
-          std::static_pointer_cast<WirelessTransmitter>(*it);
-
-      txFreq = transmitter->Freq();
-      rxPower = transmitter->SignalStrength(myPos, this->Gain());
-
-      // Discard if the frequency received is out of our frequency range,
-      // or if the received signal strengh is lower than the sensivity
-      if ((txFreq < this->MinFreqFiltered()) ||
-          (txFreq > this->MaxFreqFiltered()) ||
-          (rxPower < this->Sensitivity()))
-      {
-        continue;
-      }
-
-      txEssid = transmitter->ESSID();
-
-      msgs::WirelessNode *wirelessNode = msg.add_node();
-      wirelessNode->set_essid(txEssid);
-      wirelessNode->set_frequency(txFreq);
-      wirelessNode->set_signal_level(rxPower);
+      continue;
     }
+
+    msgs::WirelessNode *wirelessNode = msg.add_node();
+    wirelessNode->set_essid(link.essid);
+    wirelessNode->set_frequency(link.frequency);
+    wirelessNode->set_signal_level(link.signalLevel);
   }
   IGN_PROFILE_END();
   IGN_PROFILE_BEGIN("Publish");
@@ -174,5 +161,6 @@ double WirelessReceiver::Sensitivity() const
 //////////////////////////////////////////////////
 void WirelessReceiver::Fini()
 {
+  WirelessPropagation::Instance()->RemoveReceiver(this);
   WirelessTransceiver::Fini();
 }
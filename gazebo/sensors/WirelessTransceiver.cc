@@ -112,3 +112,12 @@ double WirelessTransceiver::Gain() const
 {
   return this->gain;
 }
+
+/////////////////////////////////////////////////
+ignition::math::Pose3d WirelessTransceiver::AntennaPose() const
+{
+  physics::LinkPtr parent = this->parentEntity.lock();
+  if (!parent)
+    return this->referencePose;
+  return this->pose + parent->WorldPose();
+}
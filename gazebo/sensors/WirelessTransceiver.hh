@@ -62,6 +62,11 @@ namespace gazebo
       /// \return Receiver power (dBm).
       public: double Power() const;
 
+      /// \brief Returns the current pose of the antenna in the world
+      /// frame, computed from the pose of the parent link.
+      /// \return Pose of the antenna.
+      public: ignition::math::Pose3d AntennaPose() const;
+
       /// \brief Publisher to publish propagation model data
       protected: transport::PublisherPtr pub;
 
@@ -53,6 +53,9 @@ namespace gazebo
       // Documentation inherited
       public: virtual void Init();
 
+      // Documentation inherited
+      public: virtual void Fini();
+
       /// \brief Returns the Service Set Identifier (network name).
       /// \return Service Set Identifier (network name).
       public: std::string ESSID() const;
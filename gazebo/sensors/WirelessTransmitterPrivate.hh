@@ -18,7 +18,6 @@
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
 #include <string>
-#include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
 {
@@ -56,9 +55,6 @@ namespace gazebo
 
       /// \brief Reception frequency (MHz).
       public: double freq = 2442.0;
-
-      // \brief Ray used to test for collisions when placing entities
-      public: physics::RayShapePtr testRay;
     };
   }
 }
@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/sensors/WirelessPropagation.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -27,6 +28,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
+    public: void TestGridCache();
     private: void TxMsg(const ConstPropagationGridPtr &_msg);
 
     private: std::mutex mutex;
@@ -236,6 +238,35 @@ void WirelessTransmitter_TEST::TestUpdateImplNoVisual()
   EXPECT_FALSE(this->receivedMsg);
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that the obstacle tests of the visualization grid are
+/// reused while the transmitter doesn't move
+void WirelessTransmitter_TEST::TestGridCache()
+{
+  ASSERT_TRUE(this->tx != nullptr);
+  sensors::WirelessPropagation *propagation =
+      sensors::WirelessPropagation::Instance();
+  common::Time maxAge = propagation->CacheMaxAge();
+  propagation->SetCacheMaxAge(common::Time(1000, 0));
+
+  this->tx->Update(true);
+  uint64_t rays = propagation->RayCount();
+  uint64_t hits = propagation->CacheHits();
+
+  // The transmitter is static, so the second grid is answered by the cache
+  this->tx->Update(true);
+  EXPECT_EQ(rays, propagation->RayCount());
+  EXPECT_LT(hits, propagation->CacheHits());
+
+  // Without a cache all the obstacle tests are done again
+  propagation->SetCacheMaxAge(common::Time::Zero);
+  hits = propagation->CacheHits();
+  this->tx->Update(true);
+  EXPECT_EQ(hits, propagation->CacheHits());
+
+  propagation->SetCacheMaxAge(maxAge);
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestSensorCreation)
 {
@@ -266,6 +297,12 @@ TEST_F(WirelessTransmitter_TEST, TestUpdateImplNoVisual)
   TestUpdateImplNoVisual();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestGridCache)
+{
+  TestGridCache();
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
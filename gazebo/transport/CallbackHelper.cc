@@ -39,6 +39,12 @@ std::string CallbackHelper::GetMsgType() const
   return std::string();
 }
 
+/////////////////////////////////////////////////
+bool CallbackHelper::IsQueued() const
+{
+  return false;
+}
+
 /////////////////////////////////////////////////
 bool CallbackHelper::GetLatching() const
 {
@@ -74,6 +74,11 @@ namespace gazebo
       ///         is tied to a remote connection
       public: virtual bool IsLocal() const = 0;
 
+      /// \brief Does the callback queue messages for its own executor?
+      /// \return true if messages can be handed over from any thread
+      /// without going through the transport thread.
+      public: virtual bool IsQueued() const;
+
       /// \brief Is the callback latching?
       /// \return true if the callback is latching, false otherwise
       public: bool GetLatching() const;
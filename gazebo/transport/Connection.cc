@@ -54,6 +54,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/transport/IOManager.hh"
@@ -94,6 +95,7 @@ Connection::Connection()
     iomanager = new IOManager();
 
   this->socket = new boost::asio::ip::tcp::socket(iomanager->GetIO());
+  this->strand = new boost::asio::io_service::strand(iomanager->GetIO());
 
   iomanager->IncCount();
   this->id = idCounter++;
@@ -103,6 +105,15 @@ Connection::Connection()
   this->connectError = false;
   this->writeQueue.clear();
   this->writeCount = 0;
+  this->writeKickPosted = false;
+  this->writeQueueBytes = 0;
+  this->writeQueueLimit = 0;
+  this->droppedCount = 0;
+  this->writtenCount = 0;
+  this->writtenBytes = 0;
+  this->writeQueueZone = 0;
+  this->readCount = 0;
+  this->readBytes = 0;
 
   this->localURI = std::string("http://") + this->GetLocalHostname() + ":" +
                    boost::lexical_cast<std::string>(this->GetLocalPort());
@@ -126,6 +137,9 @@ Connection::~Connection()
 {
   this->Shutdown();
 
+  delete this->strand;
+  this->strand = NULL;
+
   if (iomanager)
   {
     iomanager->DecCount();
@@ -186,8 +200,9 @@ bool Connection::Connect(const std::string &_host, unsigned int _port)
   // Use async connect so that we can use a custom timeout. This is useful
   // when trying to detect network errors.
   this->socket->async_connect(*endpointIter++,
-      common::weakBind(&Connection::OnConnect, this->shared_from_this(),
-        boost::asio::placeholders::error, endpointIter));
+      this->strand->wrap(common::weakBind(&Connection::OnConnect,
+        this->shared_from_this(), boost::asio::placeholders::error,
+        endpointIter)));
 
   // Wait for at most 60 seconds for a connection to be established.
   // The connectionCondition notification occurs in ::OnConnect.
@@ -233,8 +248,8 @@ void Connection::Listen(unsigned int port, const AcceptCallback &_acceptCB)
   this->acceptConn = ConnectionPtr(new Connection());
 
   this->acceptor->async_accept(*this->acceptConn->socket,
-      common::weakBind(&Connection::OnAccept, this->shared_from_this(),
-                  boost::asio::placeholders::error));
+      this->strand->wrap(common::weakBind(&Connection::OnAccept,
+        this->shared_from_this(), boost::asio::placeholders::error)));
 }
 
 //////////////////////////////////////////////////
@@ -262,8 +277,8 @@ void Connection::OnAccept(const boost::system::error_code &e)
     this->acceptConn = ConnectionPtr(new Connection());
 
     this->acceptor->async_accept(*this->acceptConn->socket,
-        common::weakBind(&Connection::OnAccept, this->shared_from_this(),
-          boost::asio::placeholders::error));
+        this->strand->wrap(common::weakBind(&Connection::OnAccept,
+          this->shared_from_this(), boost::asio::placeholders::error)));
   }
   else
   {
@@ -294,7 +309,22 @@ void Connection::EnqueueMsg(const std::string &_buffer, bool _force)
 
 //////////////////////////////////////////////////
 void Connection::EnqueueMsg(const std::string &_buffer,
-    boost::function<void(uint32_t)> _cb, uint32_t _id, bool _force)
+    boost::function<void(uint32_t)> _cb, uint32_t _id, bool /*_force*/)
+{
+  this->Enqueue(_buffer, _cb, _id, false);
+}
+
+//////////////////////////////////////////////////
+void Connection::EnqueueDataMsg(const std::string &_buffer,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  this->Enqueue(_buffer, _cb, _id, true);
+}
+
+//////////////////////////////////////////////////
+void Connection::Enqueue(const std::string &_buffer,
+    boost::function<void(uint32_t)> _cb, uint32_t _id,
+    const bool _droppable)
 {
   // Don't enqueue empty messages
   if (_buffer.empty() || !this->IsOpen())
@@ -309,36 +339,106 @@ void Connection::EnqueueMsg(const std::string &_buffer,
   {
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
-    if (this->writeQueue.empty() ||
-        (this->writeCount > 0 && this->writeQueue.size() == 1) ||
+    // The queue only holds data which isn't being written, so that small
+    // messages can always be appended to the last chunk of their kind
+    if (this->writeQueue.empty() || this->droppable.back() != _droppable ||
         (this->writeQueue.back().size() + HEADER_LENGTH + _buffer.size() >
          4096))
     {
       this->writeQueue.push_back(std::string(headerBuffer) + _buffer);
       this->callbacks.push_back({std::make_pair(_cb, _id)});
+      this->droppable.push_back(_droppable);
     }
     else
     {
       this->writeQueue.back() += std::string(headerBuffer) + _buffer;
       this->callbacks.back().push_back(std::make_pair(_cb, _id));
     }
+    this->writeQueueTicks.push_back(common::Profiler::Ticks());
+    this->writeQueueBytes += HEADER_LENGTH + _buffer.size();
+
+    // The remote side doesn't keep up. Drop the oldest data messages
+    // rather than growing the queue, which would only delay the newest
+    // ones. Control messages, such as the shared memory handshake, are
+    // kept.
+    size_t chunk = 0;
+    size_t ticks = 0;
+    while (this->writeQueueLimit > 0 &&
+        this->writeQueueBytes > this->writeQueueLimit &&
+        chunk + 1 < this->writeQueue.size())
+    {
+      if (!this->droppable[chunk])
+      {
+        ticks += this->callbacks[chunk].size();
+        ++chunk;
+        continue;
+      }
+
+      if (!this->dropMsgLogged)
+      {
+        gzwarn << "Connection to[" << this->RemoteEndpointName()
+               << "] is too slow, dropping the oldest messages\n";
+        this->dropMsgLogged = true;
+      }
+
+      for (auto const &callback : this->callbacks[chunk])
+      {
+        if (!callback.first.empty())
+          callback.first(callback.second);
+      }
+      this->droppedCount += this->callbacks[chunk].size();
+      this->writeQueueTicks.erase(this->writeQueueTicks.begin() + ticks,
+          this->writeQueueTicks.begin() + ticks +
+          this->callbacks[chunk].size());
+      this->writeQueueBytes -= this->writeQueue[chunk].size();
+      this->callbacks.erase(this->callbacks.begin() + chunk);
+      this->writeQueue.erase(this->writeQueue.begin() + chunk);
+      this->droppable.erase(this->droppable.begin() + chunk);
+    }
   }
 
-  if (_force)
+  // Start writing right away. Messages enqueued while a write is in
+  // progress are batched, and written when it completes.
+  this->ProcessWriteQueue();
+}
+
+/////////////////////////////////////////////////
+void Connection::ProcessWriteQueue(bool _blocking)
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+
+  if (_blocking)
   {
-    this->ProcessWriteQueue();
+    this->StartWrite(true);
+    return;
   }
-  else
+
+  // The write is started from the strand, like its completion handler.
+  // A write in progress picks up the queue when it completes, and a
+  // single kick is enough for all the messages enqueued meanwhile.
+  if (!this->IsOpen() || this->writeQueue.empty() || this->writeCount > 0 ||
+      this->writeKickPosted)
   {
-    // Tell the connection manager that it needs to update
-    ConnectionManager::Instance()->TriggerUpdate();
+    return;
   }
+
+  this->writeKickPosted = true;
+  this->strand->post(common::weakBind(&Connection::OnWriteKick,
+        this->shared_from_this()));
 }
 
 /////////////////////////////////////////////////
-void Connection::ProcessWriteQueue(bool _blocking)
+void Connection::OnWriteKick()
 {
   boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  this->writeKickPosted = false;
+  this->StartWrite(false);
+}
+
+/////////////////////////////////////////////////
+void Connection::StartWrite(bool _blocking)
+{
+  GZ_PROFILE_SCOPE("Connection::StartWrite");
 
   if (!this->IsOpen())
   {
@@ -354,24 +454,47 @@ void Connection::ProcessWriteQueue(bool _blocking)
 
   this->writeCount++;
 
-  // Write the serialized data to the socket. We use
-  // "gather-write" to send both the head and the data in
-  // a single write operation
+  // The statistics are named after the remote side, which is known once
+  // connected
+  if (this->statsName.empty())
+  {
+    this->statsName = this->RemoteEndpointName();
+    this->writeQueueZone = common::Profiler::Instance()->RegisterZone(
+        "transport/connection/" + this->statsName + "/write_queue");
+  }
+
+  // Move everything queued so far into a single "gather-write". The
+  // messages enqueued meanwhile are written once it completes, so a slow
+  // remote side gets fewer, larger writes.
+  std::vector<boost::asio::const_buffer> buffers;
+  while (!this->writeQueue.empty())
+  {
+    this->writeBuffers.push_back(std::move(this->writeQueue.front()));
+    this->writeQueue.pop_front();
+    this->writeCallbacks.insert(this->writeCallbacks.end(),
+        this->callbacks.front().begin(), this->callbacks.front().end());
+    this->callbacks.pop_front();
+  }
+  this->droppable.clear();
+  this->writeTicks.assign(this->writeQueueTicks.begin(),
+      this->writeQueueTicks.end());
+  this->writeQueueTicks.clear();
+  this->writeQueueBytes = 0;
+
+  for (auto const &buffer : this->writeBuffers)
+    buffers.push_back(boost::asio::buffer(buffer));
+
   if (!_blocking)
   {
-    boost::asio::async_write(*this->socket,
-        boost::asio::buffer(this->writeQueue.front().c_str(),
-          this->writeQueue.front().size()),
-          common::weakBind(&Connection::OnWrite, this->shared_from_this(),
-            boost::asio::placeholders::error));
+    boost::asio::async_write(*this->socket, buffers,
+        this->strand->wrap(common::weakBind(&Connection::OnWrite,
+          this->shared_from_this(), boost::asio::placeholders::error)));
   }
   else
   {
     try
     {
-      boost::asio::write(*this->socket,
-          boost::asio::buffer(this->writeQueue.front().c_str(),
-            this->writeQueue.front().size()));
+      boost::asio::write(*this->socket, buffers);
     }
     catch(...)
     {
@@ -382,6 +505,56 @@ void Connection::ProcessWriteQueue(bool _blocking)
   }
 }
 
+//////////////////////////////////////////////////
+void Connection::SetWriteQueueLimit(const size_t _bytes)
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  this->writeQueueLimit = _bytes;
+}
+
+//////////////////////////////////////////////////
+size_t Connection::WriteQueueLimit() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  return this->writeQueueLimit;
+}
+
+//////////////////////////////////////////////////
+size_t Connection::WriteQueueSize() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  return this->writeQueueBytes;
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::DroppedMessageCount() const
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  return this->droppedCount;
+}
+
+//////////////////////////////////////////////////
+ConnectionStatistics Connection::Statistics() const
+{
+  ConnectionStatistics stats;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+    stats.remote = this->statsName;
+    stats.written = this->writtenCount;
+    stats.writtenBytes = this->writtenBytes;
+    stats.dropped = this->droppedCount;
+    stats.queuedBytes = this->writeQueueBytes;
+    stats.writeQueueZone = this->writeQueueZone;
+  }
+  stats.read = this->readCount;
+  stats.readBytes = this->readBytes;
+
+  if (stats.remote.empty())
+    stats.remote = this->RemoteEndpointName();
+
+  return stats;
+}
+
 //////////////////////////////////////////////////
 std::string Connection::GetLocalURI() const
 {
@@ -397,17 +570,24 @@ std::string Connection::GetRemoteURI() const
 //////////////////////////////////////////////////
 void Connection::PostWrite()
 {
+  // Time spent by each message in the queue and on the socket
+  auto profiler = common::Profiler::Instance();
+  const uint64_t now = common::Profiler::Ticks();
+  for (auto const &ticks : this->writeTicks)
+    profiler->Record(this->writeQueueZone, ticks, now);
+
+  this->writtenCount += this->writeTicks.size();
+  for (auto const &buffer : this->writeBuffers)
+    this->writtenBytes += buffer.size();
+
   // Call the callbacks, if not NULL
-  if (!this->callbacks.empty())
-  {
-    for (auto const &callback : this->callbacks.front())
-      if (!callback.first.empty())
-        callback.first(callback.second);
-    this->callbacks.pop_front();
-  }
+  for (auto const &callback : this->writeCallbacks)
+    if (!callback.first.empty())
+      callback.first(callback.second);
 
-  if (!this->writeQueue.empty())
-    this->writeQueue.pop_front();
+  this->writeCallbacks.clear();
+  this->writeBuffers.clear();
+  this->writeTicks.clear();
   this->writeCount--;
 }
 
@@ -418,6 +598,10 @@ void Connection::OnWrite(const boost::system::error_code &_e)
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
     this->PostWrite();
+
+    // Write what was enqueued meanwhile, already on the strand
+    if (!_e)
+      this->StartWrite(false);
   }
 
   if (_e)
@@ -427,6 +611,20 @@ void Connection::OnWrite(const boost::system::error_code &_e)
   }
 }
 
+//////////////////////////////////////////////////
+void Connection::OnReadError(const boost::system::error_code &_e)
+{
+  if (_e.value() == boost::asio::error::eof)
+    this->isOpen = false;
+
+  // Reads canceled by Shutdown are already reported
+  if (_e == boost::asio::error::operation_aborted)
+    return;
+
+  this->shutdown();
+  ConnectionManager::Instance()->TriggerUpdate();
+}
+
 //////////////////////////////////////////////////
 void Connection::Shutdown()
 {
@@ -451,6 +649,8 @@ bool Connection::IsOpen() const
 //////////////////////////////////////////////////
 void Connection::Close()
 {
+  // Blocking writes are made from any thread, with the write mutex held
+  boost::recursive_mutex::scoped_lock lock2(this->writeMutex);
   boost::mutex::scoped_lock lock(this->socketMutex);
 
   if (this->socket && this->socket->is_open())
@@ -487,9 +687,11 @@ void Connection::Close()
     this->acceptor = NULL;
   }
 
-  boost::recursive_mutex::scoped_lock lock2(this->writeMutex);
   this->writeQueue.clear();
   this->callbacks.clear();
+  this->droppable.clear();
+  this->writeQueueTicks.clear();
+  this->writeQueueBytes = 0;
 }
 
 //////////////////////////////////////////////////
@@ -906,6 +1108,21 @@ boost::asio::ip::tcp::endpoint Connection::GetRemoteEndpoint() const
   return ep;
 }
 
+//////////////////////////////////////////////////
+std::string Connection::RemoteEndpointName() const
+{
+  boost::mutex::scoped_lock lock(this->socketMutex);
+  if (!this->socket)
+    return std::string();
+
+  boost::system::error_code ec;
+  boost::asio::ip::tcp::endpoint ep = this->socket->remote_endpoint(ec);
+  if (ec)
+    return std::string();
+
+  return ep.address().to_string() + ":" + std::to_string(ep.port());
+}
+
 //////////////////////////////////////////////////
 std::string Connection::GetHostname(boost::asio::ip::tcp::endpoint _ep)
 {
@@ -26,6 +26,7 @@
 #include <boost/thread.hpp>
 #include <boost/tuple/tuple.hpp>
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -34,6 +35,7 @@
 #include <utility>
 
 #include "gazebo/common/Event.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/WeakBind.hh"
@@ -84,6 +86,36 @@ namespace gazebo
     };
     /// \endcond
 
+    /// \class ConnectionStatistics Connection.hh transport/transport.hh
+    /// \brief Counters of a connection.
+    class GZ_TRANSPORT_VISIBLE ConnectionStatistics
+    {
+      /// \brief Remote side of the connection, as "address:port".
+      public: std::string remote;
+
+      /// \brief Number of messages written.
+      public: uint64_t written = 0;
+
+      /// \brief Number of bytes written, with the headers.
+      public: uint64_t writtenBytes = 0;
+
+      /// \brief Number of messages read.
+      public: uint64_t read = 0;
+
+      /// \brief Number of bytes read, without the headers.
+      public: uint64_t readBytes = 0;
+
+      /// \brief Number of messages dropped because of the write queue limit.
+      public: uint64_t dropped = 0;
+
+      /// \brief Number of bytes waiting to be written.
+      public: uint64_t queuedBytes = 0;
+
+      /// \brief Profiler zone holding the time between a message being
+      /// enqueued and its write completing. Only valid if written > 0.
+      public: common::ProfileZoneId writeQueueZone = 0;
+    };
+
     /// \addtogroup gazebo_transport Transport
     /// \{
     ///
@@ -153,8 +185,8 @@ namespace gazebo
 
       /// \brief Write data to the socket
       /// \param[in] _buffer Data to write
-      /// \param[in] _force If true, block until the data has been written
-      /// to the socket, otherwise just enqueue the data for asynchronous write
+      /// \param[in] _force Unused. The write starts right away, or when the
+      /// write in progress completes.
       /// \param[in] _cb If non-null, callback to be invoked after
       /// transmission is complete.
       /// \param[in] _id ID associated with the message data.
@@ -164,10 +196,21 @@ namespace gazebo
 
       /// \brief Write data to the socket
       /// \param[in] _buffer Data to write
-      /// \param[in] _force If true, block until the data has been written
-      /// to the socket, otherwise just enqueue the data for asynchronous write
+      /// \param[in] _force Unused. The write starts right away, or when the
+      /// write in progress completes.
       public: void EnqueueMsg(const std::string &_buffer, bool _force = false);
 
+      /// \brief Write a data message to the socket. Unlike the messages of
+      /// EnqueueMsg, which carry control and handshake traffic, data
+      /// messages may be dropped when the write queue is over its limit.
+      /// \param[in] _buffer Data to write
+      /// \param[in] _cb If non-null, callback to be invoked after
+      /// transmission is complete, or once the message is dropped.
+      /// \param[in] _id ID associated with the message data.
+      /// \sa SetWriteQueueLimit
+      public: void EnqueueDataMsg(const std::string &_buffer,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       /// \brief Get the local URI
       /// \return The local URI
       public: std::string GetLocalURI() const;
@@ -218,9 +261,10 @@ namespace gazebo
                 this->inboundHeader.resize(HEADER_LENGTH);
                 boost::asio::async_read(*this->socket,
                     boost::asio::buffer(this->inboundHeader),
-                    common::weakBind(f, this->shared_from_this(),
-                                boost::asio::placeholders::error,
-                                boost::make_tuple(_handler)));
+                    this->strand->wrap(common::weakBind(f,
+                        this->shared_from_this(),
+                        boost::asio::placeholders::error,
+                        boost::make_tuple(_handler))));
               }
 
       /// \brief Handle a completed read of a message header.
@@ -236,8 +280,7 @@ namespace gazebo
               {
                 if (_e)
                 {
-                  if (_e.value() == boost::asio::error::eof)
-                    this->isOpen = false;
+                  this->OnReadError(_e);
                 }
                 else
                 {
@@ -259,9 +302,10 @@ namespace gazebo
 
                     boost::asio::async_read(*this->socket,
                         boost::asio::buffer(this->inboundData),
-                        common::weakBind(f, this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    _handler));
+                        this->strand->wrap(common::weakBind(f,
+                            this->shared_from_this(),
+                            boost::asio::placeholders::error,
+                            _handler)));
                   }
                   else
                   {
@@ -295,10 +339,7 @@ namespace gazebo
                               boost::tuple<Handler> _handler)
               {
                 if (_e)
-                {
-                  if (_e.value() == boost::asio::error::eof)
-                    this->isOpen = false;
-                }
+                  this->OnReadError(_e);
 
                 // Inform caller that data has been received
                 std::string data(&this->inboundData[0],
@@ -308,6 +349,12 @@ namespace gazebo
                 if (data.empty())
                   gzerr << "OnReadData got empty data!!!\n";
 
+                if (!_e)
+                {
+                  this->readCount++;
+                  this->readBytes += data.size();
+                }
+
                 if (!_e && !transport::is_stopped())
                 {
                   ConnectionReadTask *task = new(tbb::task::allocate_root())
@@ -320,15 +367,47 @@ namespace gazebo
               }
 
       /// \brief Register a function to be called when the connection is shut
-      /// down \param[in] _subscriber Function to be called \return Handle
-      /// that can be used to unregister the function
+      /// down, locally or by the remote side. \param[in] _subscriber
+      /// Function to be called \return Handle that can be used to unregister
+      /// the function
       public: event::ConnectionPtr ConnectToShutdown(boost::function<void()>
                  _subscriber)
               { return this->shutdown.Connect(_subscriber); }
 
-      /// \brief Handle on-write callbacks
+      /// \brief Start writing the queued messages, if no write is in
+      /// progress. All the queued messages are written at once, and the
+      /// messages enqueued meanwhile are written when it completes.
+      /// \param[in] _blocking True to write the messages from the calling
+      /// thread, and wait until they are written. Otherwise the write is
+      /// started from the strand of the connection.
       public: void ProcessWriteQueue(bool _blocking = false);
 
+      /// \brief Limit the size of the messages waiting to be written. When
+      /// the remote side doesn't keep up, the oldest data messages are
+      /// dropped, so that it receives the latest ones. Messages enqueued
+      /// with EnqueueMsg are never dropped, nor is the newest message,
+      /// whatever its size.
+      /// \param[in] _bytes Maximum number of bytes, 0 for no limit.
+      public: void SetWriteQueueLimit(const size_t _bytes);
+
+      /// \brief Get the limit of the messages waiting to be written.
+      /// \return Maximum number of bytes, 0 for no limit.
+      public: size_t WriteQueueLimit() const;
+
+      /// \brief Get the size of the messages waiting to be written, without
+      /// the ones being written.
+      /// \return Number of bytes.
+      public: size_t WriteQueueSize() const;
+
+      /// \brief Get the number of messages dropped because of the write
+      /// queue limit.
+      /// \return Number of messages.
+      public: uint64_t DroppedMessageCount() const;
+
+      /// \brief Get the counters of the connection.
+      /// \return Counters.
+      public: ConnectionStatistics Statistics() const;
+
       /// \brief Get the ID of the connection.
       /// \return The connection's unique ID.
       public: unsigned int GetId() const;
@@ -343,6 +422,23 @@ namespace gazebo
       /// \return GAZEBO_IP_WHITE_LIST
       public: std::string GetIPWhiteList() const;
 
+      /// \brief Queue a message.
+      /// \param[in] _buffer Data to write
+      /// \param[in] _cb Callback invoked once written or dropped.
+      /// \param[in] _id ID associated with the message data.
+      /// \param[in] _droppable True if the message may be dropped.
+      private: void Enqueue(const std::string &_buffer,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id,
+                  const bool _droppable);
+
+      /// \brief Start writing the queued messages, if no write is in
+      /// progress. Called with writeMutex held.
+      /// \param[in] _blocking True to wait until the messages are written.
+      private: void StartWrite(bool _blocking);
+
+      /// \brief Write kick posted to the strand by ProcessWriteQueue.
+      private: void OnWriteKick();
+
       /// \brief Post write.
       /// Called afer a write is finished.
       private: void PostWrite();
@@ -352,6 +448,12 @@ namespace gazebo
       /// \param[in] _b Buffer of the data that was written.
       private: void OnWrite(const boost::system::error_code &_e);
 
+      /// \brief Handle a failed read. Notifies the shutdown subscribers and
+      /// the connection manager when the remote side went away, so that
+      /// nobody needs to poll the connection state.
+      /// \param[in] _e Error code of the read.
+      private: void OnReadError(const boost::system::error_code &_e);
+
       /// \brief Handle new connections, if this is a server
       /// \param[in] _e Error code for accept method
       private: void OnAccept(const boost::system::error_code &_e);
@@ -371,6 +473,11 @@ namespace gazebo
       /// \return The endpoint
       private: boost::asio::ip::tcp::endpoint GetRemoteEndpoint() const;
 
+      /// \brief Get the remote side of the connection, without logging an
+      /// error if the socket is closed.
+      /// \return "address:port", or an empty string if not connected.
+      private: std::string RemoteEndpointName() const;
+
       /// \brief Gets hostname
       /// \param[in] _ep The end point to get the hostename of
       private: static std::string GetHostname(
@@ -388,6 +495,10 @@ namespace gazebo
       /// \brief Accepts new connections.
       private: boost::asio::ip::tcp::acceptor *acceptor;
 
+      /// \brief Serializes the handlers of the connection, when the IO
+      /// service runs on several threads.
+      private: boost::asio::io_service::strand *strand;
+
       /// \brief Outgoing data queue
       private: std::deque<std::string> writeQueue;
 
@@ -397,11 +508,62 @@ namespace gazebo
                std::pair<boost::function<void(uint32_t)>, uint32_t> > >
                  callbacks;
 
+      /// \brief True for each chunk of writeQueue holding data messages,
+      /// which may be dropped. Data and control messages never share a
+      /// chunk.
+      private: std::deque<bool> droppable;
+
+      /// \brief True while a write kick is posted to the strand.
+      private: bool writeKickPosted;
+
+      /// \brief Data being written, moved out of writeQueue.
+      private: std::vector<std::string> writeBuffers;
+
+      /// \brief Callbacks of writeBuffers.
+      private: std::vector<
+               std::pair<boost::function<void(uint32_t)>, uint32_t> >
+                 writeCallbacks;
+
+      /// \brief Number of bytes in writeQueue.
+      private: size_t writeQueueBytes;
+
+      /// \brief Maximum of writeQueueBytes, 0 for no limit.
+      private: size_t writeQueueLimit;
+
+      /// \brief Number of messages dropped because of writeQueueLimit.
+      private: uint64_t droppedCount;
+
+      /// \brief Time at which each message of writeQueue was enqueued.
+      private: std::deque<uint64_t> writeQueueTicks;
+
+      /// \brief Time at which each message of writeBuffers was enqueued.
+      private: std::vector<uint64_t> writeTicks;
+
+      /// \brief Number of messages written.
+      private: uint64_t writtenCount;
+
+      /// \brief Number of bytes written.
+      private: uint64_t writtenBytes;
+
+      /// \brief Remote side used to name the statistics, set on the first
+      /// write.
+      private: std::string statsName;
+
+      /// \brief Profiler zone of the write queue latency, registered on
+      /// the first write.
+      private: common::ProfileZoneId writeQueueZone;
+
+      /// \brief Number of messages read.
+      private: std::atomic<uint64_t> readCount;
+
+      /// \brief Number of bytes read.
+      private: std::atomic<uint64_t> readBytes;
+
       /// \brief Mutex to protect new connections.
       private: boost::mutex connectMutex;
 
       /// \brief Mutex to protect write.
-      private: boost::recursive_mutex writeMutex;
+      private: mutable boost::recursive_mutex writeMutex;
 
       /// \brief Mutex to protect reads.
       private: boost::recursive_mutex readMutex;
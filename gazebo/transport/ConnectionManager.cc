@@ -19,6 +19,9 @@
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/transport/ShmRing.hh"
+#include "gazebo/transport/SubscriptionTransport.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 
@@ -63,6 +66,7 @@ ConnectionManager::ConnectionManager()
   this->initialized = false;
   this->stop = false;
   this->stopped = true;
+  this->updatePending = false;
 
   this->eventConnections.push_back(
       event::Events::ConnectStop(boost::bind(&ConnectionManager::Stop, this)));
@@ -71,8 +75,10 @@ ConnectionManager::ConnectionManager()
 //////////////////////////////////////////////////
 ConnectionManager::~ConnectionManager()
 {
-  boost::mutex::scoped_lock lock(this->updateMutex);
-  this->eventConnections.clear();
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->eventConnections.clear();
+  }
 
   this->Fini();
 }
@@ -242,15 +248,21 @@ void ConnectionManager::Fini()
 void ConnectionManager::Stop()
 {
   this->stop = true;
-  this->updateCondition.notify_all();
+  this->TriggerUpdate();
+
   if (this->initialized)
-    while (this->stopped == false)
-      common::Time::MSleep(100);
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    while (!this->stopped)
+      this->updateCondition.wait(lock);
+  }
 }
 
 //////////////////////////////////////////////////
 void ConnectionManager::RunUpdate()
 {
+  GZ_PROFILE_SCOPE("ConnectionManager::RunUpdate");
+
   std::list<ConnectionPtr>::iterator iter;
   std::list<ConnectionPtr>::iterator endIter;
 
@@ -301,21 +313,31 @@ void ConnectionManager::RunUpdate()
 //////////////////////////////////////////////////
 void ConnectionManager::Run()
 {
-  boost::mutex::scoped_lock lock(this->updateMutex);
-
-  this->stopped = false;
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->stopped = false;
+  }
 
+  // Sleep until there is something to do. Publishers, nodes and
+  // connections trigger an update when they have work for this thread.
   while (!this->stop && this->masterConn && this->masterConn->IsOpen())
   {
     this->RunUpdate();
-    this->updateCondition.timed_wait(lock,
-       boost::posix_time::milliseconds(100));
+
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    while (!this->updatePending && !this->stop)
+      this->updateCondition.wait(lock);
+    this->updatePending = false;
   }
   this->RunUpdate();
 
-  this->stopped = true;
-
   this->masterConn->Shutdown();
+
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->stopped = true;
+  }
+  this->updateCondition.notify_all();
 }
 
 //////////////////////////////////////////////////
@@ -461,6 +483,8 @@ void ConnectionManager::OnAccept(ConnectionPtr _newConnection)
 void ConnectionManager::OnRead(ConnectionPtr _connection,
                                const std::string &_data)
 {
+  GZ_PROFILE_SCOPE("ConnectionManager::OnRead");
+
   if (_data.empty())
   {
     gzerr << "Data was empty, try again\n";
@@ -483,6 +507,18 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     SubscriptionTransportPtr subLink(new SubscriptionTransport());
     subLink->Init(_connection, sub.latching());
 
+    // A subscriber on this host answers shared memory notices on the
+    // same connection
+    if (sub.has_host_id() && ShmRing::Enabled() &&
+        sub.host_id() == ShmRing::HostId())
+    {
+      subLink->EnableSharedMemory();
+      _connection->AsyncRead(
+          boost::bind(&ConnectionManager::OnSharedMemoryRead, this,
+            _connection, boost::weak_ptr<SubscriptionTransport>(subLink),
+            _1));
+    }
+
     // Connect the publisher to this transport mechanism
     TopicManager::Instance()->ConnectPubToSub(sub.topic(), subLink);
   }
@@ -490,6 +526,22 @@ void ConnectionManager::OnRead(ConnectionPtr _connection,
     gzerr << "Error est here\n";
 }
 
+//////////////////////////////////////////////////
+void ConnectionManager::OnSharedMemoryRead(ConnectionPtr _connection,
+    boost::weak_ptr<SubscriptionTransport> _subLink, const std::string &_data)
+{
+  SubscriptionTransportPtr subLink = _subLink.lock();
+  if (!subLink || !_connection->IsOpen())
+    return;
+
+  if (!_data.empty())
+    subLink->OnSharedMemoryNotice(_data);
+
+  _connection->AsyncRead(
+      boost::bind(&ConnectionManager::OnSharedMemoryRead, this,
+        _connection, _subLink, _1));
+}
+
 //////////////////////////////////////////////////
 void ConnectionManager::Advertise(const std::string &topic,
                                   const std::string &msgType)
@@ -697,5 +749,26 @@ ConnectionPtr ConnectionManager::FindConnection(const std::string &_host,
 //////////////////////////////////////////////////
 void ConnectionManager::TriggerUpdate()
 {
+  {
+    boost::mutex::scoped_lock lock(this->updateMutex);
+    this->updatePending = true;
+  }
   this->updateCondition.notify_all();
 }
+
+//////////////////////////////////////////////////
+std::list<ConnectionPtr> ConnectionManager::Connections()
+{
+  boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
+  return this->connections;
+}
+
+//////////////////////////////////////////////////
+std::string ConnectionManager::ServerAddress() const
+{
+  if (!this->initialized || !this->serverConn)
+    return std::string();
+
+  return this->serverConn->GetLocalAddress() + ":" +
+    std::to_string(this->serverConn->GetLocalPort());
+}
@@ -19,6 +19,7 @@
 
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <boost/interprocess/sync/interprocess_semaphore.hpp>
 #include <string>
 #include <list>
@@ -139,9 +140,20 @@ namespace gazebo
       public: ConnectionPtr ConnectToRemoteHost(const std::string &_host,
                                                   unsigned int _port);
 
-      /// \brief Inform the connection manager that it needs an update.
+      /// \brief Inform the connection manager that it needs an update. The
+      /// update loop only runs when triggered.
       public: void TriggerUpdate();
 
+      /// \brief Get the connections to the other processes.
+      /// \return Copy of the list of connections.
+      public: std::list<ConnectionPtr> Connections();
+
+      /// \brief Get the address on which this process accepts connections,
+      /// which identifies it to the master.
+      /// \return Address and port, as "address:port". Empty if the manager
+      /// isn't initialized.
+      public: std::string ServerAddress() const;
+
       /// \brief Callback function called when we have read data from the
       /// master
       /// \param[in] _data String of incoming data
@@ -157,6 +169,15 @@ namespace gazebo
       private: void OnRead(ConnectionPtr _newConnection,
                            const std::string &_data);
 
+      /// \brief Callback function called when a subscriber sent a shared
+      /// memory notice.
+      /// \param[in] _connection Connection to the subscriber.
+      /// \param[in] _subLink Transport link to the subscriber.
+      /// \param[in] _data Data that has been read.
+      private: void OnSharedMemoryRead(ConnectionPtr _connection,
+                   boost::weak_ptr<SubscriptionTransport> _subLink,
+                   const std::string &_data);
+
       /// \brief Process a raw message.
       /// \param[in] _packet The raw message data.
       private: void ProcessMessage(const std::string &_packet);
@@ -167,9 +188,12 @@ namespace gazebo
       /// \brief Condition used to trigger an update.
       private: boost::condition_variable updateCondition;
 
-      /// \brief Mutex for updateCondition
+      /// \brief Mutex for updateCondition, updatePending and stopped
       private: boost::mutex updateMutex;
 
+      /// \brief True when an update was triggered and hasn't run yet.
+      private: bool updatePending;
+
       private: ConnectionPtr masterConn;
       private: ConnectionPtr serverConn;
 
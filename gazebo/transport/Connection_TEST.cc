@@ -19,7 +19,9 @@
 #include <string>
 #include <stdlib.h>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/IOManager.hh"
 #include "test/util.hh"
 
 using namespace gazebo;
@@ -64,6 +66,102 @@ TEST_F(Connection, IPWhiteList)
     setenv("GAZEBO_IP_WHITE_LIST", ipEnv, 1);
 }
 
+/////////////////////////////////////////////////
+TEST_F(Connection, IOThreads)
+{
+  transport::IOManager io(3);
+  EXPECT_EQ(3u, io.ThreadCount());
+  io.Stop();
+  EXPECT_EQ(0u, io.ThreadCount());
+}
+
+/////////////////////////////////////////////////
+TEST_F(Connection, SlowConsumer)
+{
+  boost::mutex mutex;
+  transport::ConnectionPtr accepted;
+
+  transport::ConnectionPtr server(new transport::Connection());
+  server->Listen(0, [&](const transport::ConnectionPtr &_conn)
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        accepted = _conn;
+      });
+
+  transport::ConnectionPtr client(new transport::Connection());
+  ASSERT_TRUE(client->Connect("127.0.0.1", server->GetLocalPort()));
+  for (int i = 0; i < 500; ++i)
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      if (accepted)
+        break;
+    }
+    common::Time::MSleep(10);
+  }
+  ASSERT_TRUE(accepted != NULL);
+
+  const size_t limit = 1024 * 1024;
+  EXPECT_EQ(0u, client->WriteQueueLimit());
+  client->SetWriteQueueLimit(limit);
+  EXPECT_EQ(limit, client->WriteQueueLimit());
+
+  // Nothing is read yet, so the socket buffers fill up and the queue
+  // drops the oldest data messages. The control messages between them
+  // are kept.
+  const std::string payload(256 * 1024, 'x');
+  for (int i = 0; i < 200; ++i)
+  {
+    client->EnqueueDataMsg(std::to_string(i) + ":" + payload,
+        boost::function<void(uint32_t)>(), i);
+    if (i % 50 == 0)
+      client->EnqueueMsg("control:" + std::to_string(i));
+  }
+
+  EXPECT_GT(client->DroppedMessageCount(), 0u);
+  EXPECT_LE(client->WriteQueueSize(), limit + payload.size() + 64);
+
+  // The messages arrive in order, and the latest one isn't dropped
+  int last = -1;
+  int lastControl = -1;
+  std::string data;
+  while (last < 199 && accepted->Read(data))
+  {
+    if (data.compare(0, 8, "control:") == 0)
+    {
+      int index = std::stoi(data.substr(8));
+      EXPECT_EQ(lastControl + (lastControl < 0 ? 1 : 50), index);
+      lastControl = index;
+      continue;
+    }
+
+    int index = std::stoi(data.substr(0, data.find(':')));
+    EXPECT_GT(index, last);
+    last = index;
+  }
+  EXPECT_EQ(199, last);
+  EXPECT_EQ(150, lastControl);
+
+  // Every message was either written or dropped
+  transport::ConnectionStatistics stats;
+  for (int i = 0; i < 500; ++i)
+  {
+    stats = client->Statistics();
+    if (stats.written + stats.dropped == 204u)
+      break;
+    common::Time::MSleep(10);
+  }
+  EXPECT_EQ(204u, stats.written + stats.dropped);
+  EXPECT_EQ(client->DroppedMessageCount(), stats.dropped);
+  EXPECT_GT(stats.writtenBytes, (stats.written - 4) * payload.size());
+  EXPECT_EQ("127.0.0.1:" + std::to_string(server->GetLocalPort()),
+      stats.remote);
+
+  client->Shutdown();
+  accepted->Shutdown();
+  server->Shutdown();
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -14,10 +14,15 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <atomic>
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
+#include "gazebo/common/Console.hh"
 #include "gazebo/transport/IOManager.hh"
 
 namespace gazebo
@@ -36,20 +41,50 @@ class IOManagerPrivate
   /// \brief Reference count of connections using this IOManager.
   public: std::atomic_int count;
 
-  /// \brief Thread for IOManager.
-  public: boost::thread *thread = nullptr;
+  /// \brief Threads which run the IO service.
+  public: std::vector<boost::thread *> threads;
 };
 
+/////////////////////////////////////////////////
+/// \brief Get the number of IO threads from GAZEBO_IO_THREADS.
+/// \return Number of threads.
+static unsigned int ioThreadCount()
+{
+  const char *env = std::getenv("GAZEBO_IO_THREADS");
+  if (!env || std::string(env).empty())
+    return 1;
+
+  int threads = std::atoi(env);
+  if (threads < 1 || threads > 64)
+  {
+    gzwarn << "Invalid GAZEBO_IO_THREADS[" << env << "], using 1 thread\n";
+    return 1;
+  }
+  return static_cast<unsigned int>(threads);
+}
+
 /////////////////////////////////////////////////
 IOManager::IOManager()
+  : IOManager(ioThreadCount())
+{
+}
+
+/////////////////////////////////////////////////
+IOManager::IOManager(const unsigned int _threads)
   : dataPtr(new IOManagerPrivate)
 {
   this->dataPtr->io_service = new boost::asio::io_service;
   this->dataPtr->work = new boost::asio::io_service::work(
       *this->dataPtr->io_service);
   this->dataPtr->count = 0;
-  this->dataPtr->thread = new boost::thread(boost::bind(
-      &boost::asio::io_service::run, this->dataPtr->io_service));
+
+  // Handlers of a connection are serialized by its strand, so that the
+  // connections are spread over the threads
+  for (unsigned int i = 0; i < std::max(1u, _threads); ++i)
+  {
+    this->dataPtr->threads.push_back(new boost::thread(boost::bind(
+        &boost::asio::io_service::run, this->dataPtr->io_service)));
+  }
 }
 
 /////////////////////////////////////////////////
@@ -72,12 +107,16 @@ void IOManager::Stop()
 {
   this->dataPtr->io_service->reset();
   this->dataPtr->io_service->stop();
-  if (this->dataPtr->thread)
+  for (auto &thread : this->dataPtr->threads)
   {
-    this->dataPtr->thread->join();
-    delete this->dataPtr->thread;
-    this->dataPtr->thread = nullptr;
+    // The last connection may be released by one of its handlers
+    if (thread->get_id() == boost::this_thread::get_id())
+      thread->detach();
+    else
+      thread->join();
+    delete thread;
   }
+  this->dataPtr->threads.clear();
 }
 
 /////////////////////////////////////////////////
@@ -103,5 +142,11 @@ unsigned int IOManager::GetCount() const
 {
   return this->dataPtr->count;
 }
+
+/////////////////////////////////////////////////
+unsigned int IOManager::ThreadCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->threads.size());
+}
 }
 }
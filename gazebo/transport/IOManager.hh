@@ -32,11 +32,21 @@ namespace gazebo
 
     /// \class IOManager IOManager.hh transport/transport.hh
     /// \brief Manages boost::asio IO
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_IO_THREADS: Number of threads which run the IO service.
+    /// Defaults to 1.
     class GZ_TRANSPORT_VISIBLE IOManager
     {
-      /// \brief Constructor
+      /// \brief Constructor. Runs the IO service on the number of threads
+      /// given by GAZEBO_IO_THREADS.
       public: IOManager();
 
+      /// \brief Constructor
+      /// \param[in] _threads Number of threads which run the IO service.
+      public: explicit IOManager(const unsigned int _threads);
+
       /// \brief Destructor
       public: ~IOManager();
 
@@ -54,6 +64,10 @@ namespace gazebo
       /// \return The event count
       public: unsigned int GetCount() const;
 
+      /// \brief Get the number of threads which run the IO service.
+      /// \return Number of threads.
+      public: unsigned int ThreadCount() const;
+
       /// \brief Stop the IO service
       public: void Stop();
 
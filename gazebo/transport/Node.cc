@@ -18,6 +18,7 @@
 #include <boost/bind.hpp>
 #include "gazebo/transport/TransportIface.hh"
 #include "gazebo/transport/Node.hh"
+#include "gazebo/transport/TransportStatistics.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -32,6 +33,12 @@ Node::Node()
   this->id = idCounter++;
   this->topicNamespace = "";
   this->initialized = false;
+
+  this->executor.reset(new SubscriptionExecutor(0));
+  this->executor->SetNotify([]()
+      {
+        ConnectionManager::Instance()->TriggerUpdate();
+      });
 }
 
 /////////////////////////////////////////////////
@@ -63,9 +70,22 @@ void Node::Fini()
     this->publishers.clear();
   }
 
+  Callback_M callbacksCopy;
   {
     boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-    this->callbacks.clear();
+    callbacksCopy.swap(this->callbacks);
+  }
+
+  // Outside of the lock, a queued callback may be publishing
+  for (auto const &topic : callbacksCopy)
+  {
+    for (auto const &cb : topic.second)
+    {
+      SubscriptionQueuePtr queue =
+        boost::dynamic_pointer_cast<SubscriptionQueue>(cb);
+      if (queue)
+        queue->Stop();
+    }
   }
 }
 
@@ -195,8 +215,36 @@ void Node::ProcessPublishers()
 bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgs[_topic].push_back(_msg);
-  ConnectionManager::Instance()->TriggerUpdate();
+
+  TopicStatisticsPtr stats = this->TopicStats(_topic);
+  stats->received++;
+  stats->receivedBytes += _msg.size();
+
+  // Queued callbacks take the message right away, the others wait for
+  // the transport thread
+  bool deferred = true;
+  Callback_M::iterator cbIter = this->callbacks.find(_topic);
+  if (cbIter != this->callbacks.end() && !cbIter->second.empty())
+  {
+    deferred = false;
+    for (auto const &cb : cbIter->second)
+    {
+      if (cb->IsQueued())
+      {
+        cb->HandleData(_msg, boost::bind(&dummy_callback_fn, _1), 0);
+        stats->dispatched++;
+      }
+      else
+        deferred = true;
+    }
+  }
+
+  if (deferred)
+  {
+    this->incomingMsgs[_topic].push_back(_msg);
+    this->incomingTicks[_topic].push_back(common::Profiler::Ticks());
+    ConnectionManager::Instance()->TriggerUpdate();
+  }
   return true;
 }
 
@@ -204,8 +252,33 @@ bool Node::HandleData(const std::string &_topic, const std::string &_msg)
 bool Node::HandleMessage(const std::string &_topic, MessagePtr _msg)
 {
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-  this->incomingMsgsLocal[_topic].push_back(_msg);
-  ConnectionManager::Instance()->TriggerUpdate();
+
+  TopicStatisticsPtr stats = this->TopicStats(_topic);
+  stats->received++;
+
+  bool deferred = true;
+  Callback_M::iterator cbIter = this->callbacks.find(_topic);
+  if (cbIter != this->callbacks.end() && !cbIter->second.empty())
+  {
+    deferred = false;
+    for (auto const &cb : cbIter->second)
+    {
+      if (cb->IsQueued())
+      {
+        cb->HandleMessage(_msg);
+        stats->dispatched++;
+      }
+      else
+        deferred = true;
+    }
+  }
+
+  if (deferred)
+  {
+    this->incomingMsgsLocal[_topic].push_back(_msg);
+    this->incomingTicksLocal[_topic].push_back(common::Profiler::Ticks());
+    ConnectionManager::Instance()->TriggerUpdate();
+  }
   return true;
 }
 
@@ -214,12 +287,18 @@ void Node::ProcessIncoming()
 {
   boost::recursive_mutex::scoped_lock lock(this->processIncomingMutex);
 
-  if (!this->initialized ||
-      (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty()))
+  if (!this->initialized)
+    return;
+
+  // Callbacks of the subscription queues using the NODE executor
+  this->executor->Poll();
+
+  if (this->incomingMsgs.empty() && this->incomingMsgsLocal.empty())
     return;
 
   Callback_M::iterator cbIter;
   Callback_L::iterator liter;
+  auto profiler = common::Profiler::Instance();
 
   // For each topic
   {
@@ -243,21 +322,38 @@ void Node::ProcessIncoming()
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
 
+        TopicStatisticsPtr stats = this->TopicStats(inIter->first);
+        std::list<uint64_t>::iterator ticksIter =
+          this->incomingTicks[inIter->first].begin();
+
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        for (msgIter = msgInIter; msgIter != msgEndIter;
+             ++msgIter, ++ticksIter)
         {
+          uint64_t start = common::Profiler::Ticks();
+          profiler->Record(stats->incomingQueueZone, *ticksIter, start);
+
           // Send the message to all callbacks
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleData(*msgIter,
-                boost::bind(&dummy_callback_fn, _1), 0);
+            if (!(*liter)->IsQueued())
+            {
+              (*liter)->HandleData(*msgIter,
+                  boost::bind(&dummy_callback_fn, _1), 0);
+
+              uint64_t end = common::Profiler::Ticks();
+              profiler->Record(stats->callbackZone, start, end);
+              stats->dispatched++;
+              start = end;
+            }
           }
         }
       }
     }
 
     this->incomingMsgs.clear();
+    this->incomingTicks.clear();
   }
 
   {
@@ -281,23 +377,49 @@ void Node::ProcessIncoming()
         msgInIter = inIter->second.begin();
         msgEndIter = inIter->second.end();
 
+        TopicStatisticsPtr stats = this->TopicStats(inIter->first);
+        std::list<uint64_t>::iterator ticksIter =
+          this->incomingTicksLocal[inIter->first].begin();
+
         // For each message in the buffer
-        for (msgIter = msgInIter; msgIter != msgEndIter; ++msgIter)
+        for (msgIter = msgInIter; msgIter != msgEndIter;
+             ++msgIter, ++ticksIter)
         {
+          uint64_t start = common::Profiler::Ticks();
+          profiler->Record(stats->incomingQueueZone, *ticksIter, start);
+
           // Send the message to all callbacks
           for (liter = cbIter->second.begin();
               liter != cbIter->second.end(); ++liter)
           {
-            (*liter)->HandleMessage(*msgIter);
+            if (!(*liter)->IsQueued())
+            {
+              (*liter)->HandleMessage(*msgIter);
+
+              uint64_t end = common::Profiler::Ticks();
+              profiler->Record(stats->callbackZone, start, end);
+              stats->dispatched++;
+              start = end;
+            }
           }
         }
       }
     }
 
     this->incomingMsgsLocal.clear();
+    this->incomingTicksLocal.clear();
   }
 }
 
+//////////////////////////////////////////////////
+TopicStatisticsPtr Node::TopicStats(const std::string &_topic)
+{
+  TopicStatisticsPtr &stats = this->topicStats[_topic];
+  if (!stats)
+    stats = TransportStatistics::Instance()->Topic(_topic);
+  return stats;
+}
+
 //////////////////////////////////////////////////
 void Node::InsertLatchedMsg(const std::string &_topic, const std::string &_msg)
 {
@@ -366,24 +488,98 @@ void Node::RemoveCallback(const std::string &_topic, unsigned int _id)
   if (!this->initialized)
     return;
 
+  SubscriptionQueuePtr queue;
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+
+    // Find the topic list in the map.
+    Callback_M::iterator iter = this->callbacks.find(_topic);
+
+    if (iter != this->callbacks.end())
+    {
+      Callback_L::iterator liter;
+
+      // Find the callback with the correct ID and remove it.
+      for (liter = iter->second.begin(); liter != iter->second.end(); ++liter)
+      {
+        if ((*liter)->GetId() == _id)
+        {
+          queue = boost::dynamic_pointer_cast<SubscriptionQueue>(*liter);
+          (*liter).reset();
+          iter->second.erase(liter);
+          break;
+        }
+      }
+    }
+  }
+
+  // Wait for a queued callback running on another thread, outside of the
+  // lock since it may be publishing
+  if (queue)
+    queue->Stop();
+}
+
+/////////////////////////////////////////////////
+bool Node::QueueStats(const std::string &_topic, unsigned int _id,
+    SubscriptionQueueStats &_stats) const
+{
   boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
 
-  // Find the topic list in the map.
-  Callback_M::iterator iter = this->callbacks.find(_topic);
+  Callback_M::const_iterator iter = this->callbacks.find(_topic);
+  if (iter == this->callbacks.end())
+    return false;
 
-  if (iter != this->callbacks.end())
+  for (auto const &cb : iter->second)
   {
-    Callback_L::iterator liter;
+    if (cb->GetId() == _id)
+    {
+      SubscriptionQueuePtr queue =
+        boost::dynamic_pointer_cast<SubscriptionQueue>(cb);
+      if (!queue)
+        return false;
+      _stats = queue->Stats();
+      return true;
+    }
+  }
+
+  return false;
+}
 
-    // Find the callback with the correct ID and remove it.
-    for (liter = iter->second.begin(); liter != iter->second.end(); ++liter)
+/////////////////////////////////////////////////
+SubscriberPtr Node::AddSubscription(const SubscribeOptions &_ops,
+    CallbackHelperPtr _helper)
+{
+  if (_ops.GetExecutor() != SubscribeOptions::NODE ||
+      _ops.GetQueuePolicy() != SubscribeOptions::KEEP_ALL)
+  {
+    SubscriptionExecutorPtr queueExecutor;
+    switch (_ops.GetExecutor())
     {
-      if ((*liter)->GetId() == _id)
-      {
-        (*liter).reset();
-        iter->second.erase(liter);
+      case SubscribeOptions::DEDICATED:
+        queueExecutor.reset(new SubscriptionExecutor(1));
+        break;
+      case SubscribeOptions::POOLED:
+        queueExecutor = SubscriptionExecutor::Pool();
+        break;
+      default:
+        queueExecutor = this->executor;
         break;
-      }
     }
+
+    _helper.reset(new SubscriptionQueue(_helper, queueExecutor,
+          _ops.GetQueuePolicy(), _ops.GetQueueDepth()));
+  }
+
+  unsigned int callbackId = _helper->GetId();
+  {
+    boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
+    this->callbacks[_ops.GetTopic()].push_back(_helper);
   }
+
+  SubscriberPtr result =
+    transport::TopicManager::Instance()->Subscribe(_ops);
+
+  result->SetCallbackId(callbackId);
+
+  return result;
 }
@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 
+#include "gazebo/transport/SubscriptionQueue.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/util/system.hh"
@@ -243,21 +244,32 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
-                new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _latching);
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
+      }
 
-        return result;
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with subscription options such as the executor and queue policy.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Executor and queue policy of the subscription.
+      /// The topic and latching are set by this function.
+      /// \param[in] _latching If true, latch latest incoming message;
+      /// otherwise don't latch
+      /// \return Pointer to new Subscriber object
+      public: template<typename M, typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const boost::shared_ptr<M const> &), T *_obj,
+          const SubscribeOptions &_options, bool _latching = false)
+      {
+        SubscribeOptions ops = _options;
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _latching);
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new CallbackHelperT<M>(boost::bind(_fp, _obj, _1), _latching)));
       }
 
       /// \brief Subscribe to a topic using a bare function as the callback
@@ -272,21 +284,10 @@ namespace gazebo
                      bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.template Init<M>(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(
-              CallbackHelperPtr(new CallbackHelperT<M>(_fp, _latching)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
-
-        return result;
+        ops.template Init<M>(this->DecodeTopicName(_topic),
+            shared_from_this(), _latching);
+        return this->AddSubscription(ops,
+            CallbackHelperPtr(new CallbackHelperT<M>(_fp, _latching)));
       }
 
       /// \brief Subscribe to a topic using a class method as the callback
@@ -302,21 +303,32 @@ namespace gazebo
           bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.Init(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(CallbackHelperPtr(
-                new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
+        ops.Init(this->DecodeTopicName(_topic), shared_from_this(),
+            _latching);
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
+      }
 
-        return result;
+      /// \brief Subscribe to a topic using a class method as the callback,
+      /// with subscription options such as the executor and queue policy.
+      /// \param[in] _topic The topic to subscribe to
+      /// \param[in] _fp Class method to be called on receipt of new message
+      /// \param[in] _obj Class instance to be used on receipt of new message
+      /// \param[in] _options Executor and queue policy of the subscription.
+      /// The topic and latching are set by this function.
+      /// \param[in] _latching If true, latch latest incoming message;
+      /// otherwise don't latch
+      /// \return Pointer to new Subscriber object
+      template<typename T>
+      SubscriberPtr Subscribe(const std::string &_topic,
+          void(T::*_fp)(const std::string &), T *_obj,
+          const SubscribeOptions &_options, bool _latching = false)
+      {
+        SubscribeOptions ops = _options;
+        ops.Init(this->DecodeTopicName(_topic), shared_from_this(),
+            _latching);
+        return this->AddSubscription(ops, CallbackHelperPtr(
+              new RawCallbackHelper(boost::bind(_fp, _obj, _1))));
       }
 
 
@@ -330,21 +342,10 @@ namespace gazebo
           void(*_fp)(const std::string &), bool _latching = false)
       {
         SubscribeOptions ops;
-        std::string decodedTopic = this->DecodeTopicName(_topic);
-        ops.Init(decodedTopic, shared_from_this(), _latching);
-
-        {
-          boost::recursive_mutex::scoped_lock lock(this->incomingMutex);
-          this->callbacks[decodedTopic].push_back(
-              CallbackHelperPtr(new RawCallbackHelper(_fp)));
-        }
-
-        SubscriberPtr result =
-          transport::TopicManager::Instance()->Subscribe(ops);
-
-        result->SetCallbackId(this->callbacks[decodedTopic].back()->GetId());
-
-        return result;
+        ops.Init(this->DecodeTopicName(_topic), shared_from_this(),
+            _latching);
+        return this->AddSubscription(ops,
+            CallbackHelperPtr(new RawCallbackHelper(_fp)));
       }
 
       /// \brief Handle incoming data.
@@ -390,6 +391,23 @@ namespace gazebo
       /// \param[in] _id Id of the callback.
       public: void RemoveCallback(const std::string &_topic, unsigned int _id);
 
+      /// \brief Get the queue counters of a subscription.
+      /// \param[in] _topic Name of the topic.
+      /// \param[in] _id Id of the callback.
+      /// \param[out] _stats Queue counters.
+      /// \return False if the subscription doesn't have a queue, which is
+      /// the case when it uses the default executor and queue policy.
+      public: bool QueueStats(const std::string &_topic, unsigned int _id,
+                  SubscriptionQueueStats &_stats) const;
+
+      /// \brief Register a callback, and subscribe to its topic.
+      /// \param[in] _ops Subscription options.
+      /// \param[in] _helper Callback helper. It's wrapped in a
+      /// SubscriptionQueue when the options ask for one.
+      /// \return Pointer to new Subscriber object
+      private: SubscriberPtr AddSubscription(const SubscribeOptions &_ops,
+                   CallbackHelperPtr _helper);
+
       /// \internal
       /// \brief Private implementation of Init() and TryInit()
       /// \param[in] _space Namespace to initialize this Node to. Use an empty
@@ -405,6 +423,12 @@ namespace gazebo
                                 const common::Time &_maxWait,
                                 const bool _fallbackToDefault);
 
+      /// \brief Get the counters of a topic. The incoming mutex must be
+      /// locked.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \return Counters of the topic.
+      private: TopicStatisticsPtr TopicStats(const std::string &_topic);
+
       private: std::string topicNamespace;
       private: std::vector<PublisherPtr> publishers;
       private: std::vector<PublisherPtr>::iterator publishersIter;
@@ -419,14 +443,27 @@ namespace gazebo
       /// \brief List of newly arrive messages
       private: std::map<std::string, std::list<MessagePtr> > incomingMsgsLocal;
 
+      /// \brief Time at which each message of incomingMsgs arrived.
+      private: std::map<std::string, std::list<uint64_t> > incomingTicks;
+
+      /// \brief Time at which each message of incomingMsgsLocal arrived.
+      private: std::map<std::string, std::list<uint64_t> > incomingTicksLocal;
+
+      /// \brief Counters of the subscribed topics.
+      private: std::map<std::string, TopicStatisticsPtr> topicStats;
+
       private: boost::mutex publisherMutex;
       private: boost::mutex publisherDeleteMutex;
-      private: boost::recursive_mutex incomingMutex;
+      private: mutable boost::recursive_mutex incomingMutex;
 
       /// \brief make sure we don't call ProcessingIncoming simultaneously
       /// from separate threads.
       private: boost::recursive_mutex processIncomingMutex;
 
+      /// \brief Runs the subscription queues of the NODE executor, when
+      /// ProcessIncoming is called by the transport thread.
+      private: SubscriptionExecutorPtr executor;
+
       private: bool initialized;
     };
     /// \}
@@ -18,6 +18,7 @@
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include "gazebo/common/WeakBind.hh"
+#include "ShmRing.hh"
 #include "SubscriptionTransport.hh"
 #include "Publication.hh"
 #include "Node.hh"
@@ -59,45 +60,95 @@ void Publication::AddSubscription(const NodePtr &_node)
     this->nodes.push_back(_node);
   }
 
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-
-  // Send latched messages to the subscription.
-  for (std::map<uint32_t, MessagePtr>::iterator pubIter =
-      this->prevMsgs.begin(); pubIter != this->prevMsgs.end(); ++pubIter)
   {
-    if (pubIter->second)
+    boost::mutex::scoped_lock lock(this->callbackMutex);
+
+    // Send latched messages to the subscription.
+    for (std::map<uint32_t, MessagePtr>::iterator pubIter =
+        this->prevMsgs.begin(); pubIter != this->prevMsgs.end(); ++pubIter)
     {
-      _node->InsertLatchedMsg(this->topic, pubIter->second);
+      if (pubIter->second)
+      {
+        _node->InsertLatchedMsg(this->topic, pubIter->second);
+      }
     }
   }
+
+  this->NotifySubscription();
 }
 
 //////////////////////////////////////////////////
 void Publication::AddSubscription(const CallbackHelperPtr _callback)
 {
-  boost::mutex::scoped_lock lock(this->callbackMutex);
-
-  std::list< CallbackHelperPtr >::iterator iter;
-  iter = std::find(this->callbacks.begin(), this->callbacks.end(), _callback);
-
-  if (iter == this->callbacks.end())
   {
-    this->callbacks.push_back(_callback);
+    boost::mutex::scoped_lock lock(this->callbackMutex);
 
-    if (_callback->GetLatching())
+    std::list< CallbackHelperPtr >::iterator iter;
+    iter = std::find(this->callbacks.begin(), this->callbacks.end(),
+        _callback);
+
+    if (iter == this->callbacks.end())
     {
-      // Send latched messages to the subscription.
-      for (std::map<uint32_t, MessagePtr>::iterator pubIter =
-          this->prevMsgs.begin(); pubIter != this->prevMsgs.end(); ++pubIter)
+      this->callbacks.push_back(_callback);
+
+      // Subscribers on this host read large messages from one ring
+      SubscriptionTransportPtr subptr =
+        boost::dynamic_pointer_cast<SubscriptionTransport>(_callback);
+      if (subptr && subptr->SharedMemoryEnabled())
       {
-        if (pubIter->second)
+        if (!this->shmChannel)
+          this->shmChannel.reset(new ShmChannel());
+        subptr->SetSharedMemoryChannel(this->shmChannel);
+      }
+
+      if (_callback->GetLatching())
+      {
+        // Send latched messages to the subscription.
+        for (std::map<uint32_t, MessagePtr>::iterator pubIter =
+            this->prevMsgs.begin(); pubIter != this->prevMsgs.end();
+            ++pubIter)
         {
-          _callback->HandleMessage(pubIter->second);
+          if (pubIter->second)
+          {
+            _callback->HandleMessage(pubIter->second);
+          }
         }
+        _callback->SetLatching(false);
       }
-      _callback->SetLatching(false);
     }
   }
+
+  this->NotifySubscription();
+}
+
+//////////////////////////////////////////////////
+void Publication::NotifySubscription()
+{
+  {
+    // Serialize with the predicate check in WaitForSubscription
+    boost::mutex::scoped_lock lock(this->subscriptionMutex);
+  }
+  this->subscriptionCondition.notify_all();
+}
+
+//////////////////////////////////////////////////
+bool Publication::WaitForSubscription(const common::Time &_timeout) const
+{
+  boost::mutex::scoped_lock lock(this->subscriptionMutex);
+
+  boost::system_time deadline = boost::get_system_time() +
+    boost::posix_time::microseconds(static_cast<int64_t>(
+          _timeout.Double() * 1e6));
+
+  while (this->GetCallbackCount() == 0 && this->GetNodeCount() == 0)
+  {
+    if (_timeout <= 0.0)
+      this->subscriptionCondition.wait(lock);
+    else if (!this->subscriptionCondition.timed_wait(lock, deadline))
+      break;
+  }
+
+  return this->GetCallbackCount() > 0 || this->GetNodeCount() > 0;
 }
 
 //////////////////////////////////////////////////
@@ -321,12 +372,24 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     {
       std::string data;
       _msg->SerializeToString(&data);
+
+      // Copy a large message once into the ring of the subscribers on
+      // this host, each of them is only sent its slot
+      ShmNotice notice;
+      const bool shared = this->shmChannel &&
+        this->shmChannel->Write(data, notice);
+
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
       while (cbIter != this->callbacks.end())
       {
-        if ((*cbIter)->HandleData(data, _cb, _id))
+        SubscriptionTransportPtr subptr;
+        if (shared)
+          subptr = boost::dynamic_pointer_cast<SubscriptionTransport>(*cbIter);
+
+        if (subptr ? subptr->HandleData(data, &notice, _cb, _id) :
+            (*cbIter)->HandleData(data, _cb, _id))
         {
           ++result;
           ++cbIter;
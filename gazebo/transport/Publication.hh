@@ -21,12 +21,15 @@
 #include <utility>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
+#include "gazebo/common/Time.hh"
 #include "gazebo/transport/CallbackHelper.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/PublicationTransport.hh"
@@ -36,6 +39,9 @@ namespace gazebo
 {
   namespace transport
   {
+    // Forward declare the shared memory channel.
+    class ShmChannel;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -98,6 +104,13 @@ namespace gazebo
       /// \return The number of nodes
       public: unsigned int GetNodeCount() const;
 
+      /// \brief Block until the publication has a local subscriber, which
+      /// is a callback or a node.
+      /// \param[in] _timeout Maximum time to wait, or a non-positive time to
+      /// wait forever.
+      /// \return True if the publication has a local subscriber.
+      public: bool WaitForSubscription(const common::Time &_timeout) const;
+
       /// \brief Get the number of remote subscriptions
       /// \return The number of remote subscriptions
       public: unsigned int GetRemoteSubscriptionCount();
@@ -200,6 +213,9 @@ namespace gazebo
       /// \brief True if the publication is advertised in the same process.
       private: bool locallyAdvertised;
 
+      /// \brief Wake up the threads in WaitForSubscription.
+      private: void NotifySubscription();
+
       /// \brief Mutex to protect the list of nodes.
       private: mutable boost::mutex nodeMutex;
 
@@ -209,8 +225,18 @@ namespace gazebo
       /// \brief Mutex to protect the list of nodes id for removed.
       private: mutable boost::mutex nodeRemoveMutex;
 
+      /// \brief Mutex for subscriptionCondition.
+      private: mutable boost::mutex subscriptionMutex;
+
+      /// \brief Signaled when a subscription is added.
+      private: mutable boost::condition_variable subscriptionCondition;
+
       /// \brief Publishers and their last messages.
       private: std::map<uint32_t, MessagePtr> prevMsgs;
+
+      /// \brief Ring shared by the remote subscribers on this host,
+      /// created with the first of them.
+      private: std::shared_ptr<ShmChannel> shmChannel;
     };
     /// \}
   }
@@ -16,6 +16,7 @@
 */
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include "gazebo/common/Console.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/PublicationTransport.hh"
@@ -64,6 +65,8 @@ void PublicationTransport::Init(const ConnectionPtr &_conn, bool _latched)
   sub.set_host(this->connection->GetLocalAddress());
   sub.set_port(this->connection->GetLocalPort());
   sub.set_latching(_latched);
+  if (ShmRing::Enabled())
+    sub.set_host_id(ShmRing::HostId());
 
   this->connection->EnqueueMsg(msgs::Package("sub", sub));
 
@@ -92,12 +95,57 @@ void PublicationTransport::OnPublish(const std::string &_data)
 
     if (!_data.empty())
     {
-      if (this->callback)
+      ShmNotice notice;
+      if (_data[0] == '\0' && notice.Parse(_data))
+        this->OnSharedMemoryNotice(notice);
+      else if (this->callback)
         (this->callback)(_data);
     }
   }
 }
 
+/////////////////////////////////////////////////
+void PublicationTransport::OnSharedMemoryNotice(const ShmNotice &_notice)
+{
+  if (_notice.type == ShmNotice::OPEN)
+  {
+    this->shmRing.reset(new ShmRing());
+    this->shmGeneration = _notice.generation;
+
+    ShmNotice reply;
+    reply.generation = _notice.generation;
+    if (this->shmRing->Open(_notice.name) &&
+        this->shmRing->SlotSize() == _notice.size)
+    {
+      reply.type = ShmNotice::ACK;
+    }
+    else
+    {
+      reply.type = ShmNotice::REJECT;
+      this->shmRing.reset();
+    }
+    this->connection->EnqueueMsg(reply.Serialize());
+  }
+  else if (_notice.type == ShmNotice::MESSAGE)
+  {
+    if (!this->shmRing || _notice.generation != this->shmGeneration)
+    {
+      gzerr << "Shared memory message on topic[" << this->topic
+            << "] without a ring" << std::endl;
+    }
+    else if (!this->shmRing->Read(_notice.slot, _notice.sequence,
+          this->shmBuffer))
+    {
+      gzwarn << "Dropped a message on topic[" << this->topic
+             << "], overwritten before it was read" << std::endl;
+    }
+    else if (this->callback)
+    {
+      (this->callback)(this->shmBuffer);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 const ConnectionPtr PublicationTransport::GetConnection() const
 {
@@ -20,9 +20,11 @@
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <memory>
 #include <string>
 
 #include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/ShmRing.hh"
 #include "gazebo/common/Event.hh"
 #include "gazebo/util/system.hh"
 
@@ -79,6 +81,10 @@ namespace gazebo
       /// \param[in] _data Data to be published.
       private: void OnPublish(const std::string &_data);
 
+      /// \brief Called when a shared memory notice is received.
+      /// \param[in] _notice The notice.
+      private: void OnSharedMemoryNotice(const ShmNotice &_notice);
+
       /// \brief The topic for this publication transport.
       private: std::string topic;
 
@@ -96,6 +102,15 @@ namespace gazebo
 
       /// \brief The unique id for the publication transport.
       private: int id;
+
+      /// \brief Ring mapped from the remote publisher, if on the same host.
+      private: std::unique_ptr<ShmRing> shmRing;
+
+      /// \brief Generation of shmRing.
+      private: uint32_t shmGeneration = 0;
+
+      /// \brief Message read from shmRing, reused to avoid reallocation.
+      private: std::string shmBuffer;
     };
     /// \}
   }
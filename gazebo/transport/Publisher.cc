@@ -26,6 +26,7 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TopicManager.hh"
 #include "gazebo/transport/Publisher.hh"
+#include "gazebo/transport/TransportStatistics.hh"
 
 using namespace gazebo;
 using namespace transport;
@@ -44,6 +45,7 @@ Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
   this->queueLimitWarned = false;
   this->pubId = 0;
   this->id = ++idCounter;
+  this->stats = TransportStatistics::Instance()->Topic(_topic);
 }
 
 //////////////////////////////////////////////////
@@ -63,13 +65,16 @@ bool Publisher::HasConnections() const
 //////////////////////////////////////////////////
 void Publisher::WaitForConnection() const
 {
-  while (!this->HasConnections())
-    common::Time::MSleep(100);
+  this->WaitForConnection(common::Time::Zero);
 }
 
 //////////////////////////////////////////////////
 bool Publisher::WaitForConnection(const common::Time &_timeout) const
 {
+  if (this->publication)
+    return this->publication->WaitForSubscription(_timeout);
+
+  // Without a publication there is nothing to wait on
   common::Time start = common::Time::GetWallTime();
   common::Time curr = common::Time::GetWallTime();
 
@@ -126,10 +131,14 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     boost::mutex::scoped_lock lock(this->mutex);
 
     this->messages.push_back(msgPtr);
+    this->messageTicks.push_back(common::Profiler::Ticks());
+    this->stats->published++;
 
     if (this->messages.size() > this->queueLimit)
     {
       this->messages.pop_front();
+      this->messageTicks.pop_front();
+      this->stats->dropped++;
 
       if (!queueLimitWarned)
       {
@@ -160,6 +169,7 @@ void Publisher::SendMessage()
 {
   std::list<MessagePtr> localBuffer;
   std::list<uint32_t> localIds;
+  std::list<uint64_t> localTicks;
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
@@ -178,17 +188,24 @@ void Publisher::SendMessage()
     std::copy(this->messages.begin(), this->messages.end(),
         std::back_inserter(localBuffer));
     this->messages.clear();
+    localTicks.swap(this->messageTicks);
   }
 
   // Only send messages if there is something to send
   if (!localBuffer.empty())
   {
     std::list<uint32_t>::iterator pubIter = localIds.begin();
+    std::list<uint64_t>::iterator ticksIter = localTicks.begin();
+    auto profiler = common::Profiler::Instance();
 
     // Send all the current messages
     for (std::list<MessagePtr>::iterator iter = localBuffer.begin();
-        iter != localBuffer.end(); ++iter, ++pubIter)
+        iter != localBuffer.end(); ++iter, ++pubIter, ++ticksIter)
     {
+      profiler->Record(this->stats->publishQueueZone, *ticksIter,
+          common::Profiler::Ticks());
+      this->stats->sent++;
+
       // Expected number of calls to the callback function
       // Publisher::OnPublishComplete() triggered by subscriber callbacks.
       // If there are no subscriber callbacks, OnPublishComplete()
@@ -249,6 +266,7 @@ void Publisher::SendMessage()
     // Clear the local buffer.
     localBuffer.clear();
     localIds.clear();
+    localTicks.clear();
   }
 }
 
@@ -319,6 +337,7 @@ void Publisher::Fini()
   if (!this->messages.empty())
     this->SendMessage();
   this->messages.clear();
+  this->messageTicks.clear();
 
   if (!this->topic.empty())
     TopicManager::Instance()->Unadvertise(this->topic, this->id);
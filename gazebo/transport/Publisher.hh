@@ -172,6 +172,12 @@ namespace gazebo
       /// \brief List of messages to publish.
       private: std::list<MessagePtr> messages;
 
+      /// \brief Time at which each message of the list was published.
+      private: std::list<uint64_t> messageTicks;
+
+      /// \brief Counters of the topic.
+      private: TopicStatisticsPtr stats;
+
       /// \brief For mutual exclusion.
       private: mutable boost::mutex mutex;
 
@@ -0,0 +1,614 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/permissions.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/ShmRing.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace bip = boost::interprocess;
+
+#if ATOMIC_LLONG_LOCK_FREE != 2
+#error "The shared memory transport needs lock-free 64 bit atomics"
+#endif
+
+/// \brief First bytes of a serialized notice. The null byte can't start a
+/// serialized protobuf message.
+static const char kNoticeMagic[8] = {'\0', 'G', 'Z', 'S', 'H', 'M', '0', '1'};
+
+/// \brief Identifies a ring segment.
+static const uint64_t kRingMagic = 0x315245444e4952ULL;
+
+/// \brief Alignment of the slots, a cache line.
+static const uint64_t kAlignment = 64;
+
+/// \brief Maximum length of a segment name, including the terminating null
+/// byte. Some systems limit names to 31 characters.
+static const size_t kNameLength = 32;
+
+/// \brief Messages smaller than this always go over the connections.
+static const uint64_t kShmThreshold = 64 * 1024;
+
+/// \brief Minimum slot size of a channel ring.
+static const uint64_t kShmMinSlotSize = 1024 * 1024;
+
+/// \brief Number of messages a subscriber can lag behind before it
+/// drops one.
+static const unsigned int kShmSlotCount = 4;
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \brief Layout of a serialized notice.
+    struct ShmNoticeData
+    {
+      /// \brief kNoticeMagic.
+      char magic[8];
+
+      /// \brief ShmNotice::Type.
+      uint32_t type;
+
+      /// \brief Ring generation.
+      uint32_t generation;
+
+      /// \brief Slot count or index.
+      uint32_t slot;
+
+      /// \brief Padding.
+      uint32_t reserved;
+
+      /// \brief Slot or message size.
+      uint64_t size;
+
+      /// \brief Message sequence number.
+      uint64_t sequence;
+
+      /// \brief Ring name.
+      char name[kNameLength];
+    };
+
+    /// \brief Header at the start of a ring segment.
+    struct ShmRingHeader
+    {
+      /// \brief kRingMagic.
+      uint64_t magic;
+
+      /// \brief Number of slots.
+      uint64_t slotCount;
+
+      /// \brief Size of each slot.
+      uint64_t slotSize;
+    };
+
+    /// \brief Header at the start of each slot.
+    struct ShmSlotHeader
+    {
+      /// \brief Sequence number, odd while the slot is written.
+      std::atomic<uint64_t> sequence;
+
+      /// \brief Size of the message in the slot.
+      uint64_t size;
+    };
+
+    /// \internal
+    /// \brief Private data for the ShmRing class.
+    class ShmRingPrivate
+    {
+      /// \brief Get a slot header.
+      /// \param[in] _slot Slot index.
+      /// \return Slot header, followed by the slot data.
+      public: ShmSlotHeader *Slot(const uint64_t _slot) const
+              {
+                return reinterpret_cast<ShmSlotHeader *>(
+                    static_cast<char *>(this->region.get_address()) +
+                    ShmRingPrivate::HeaderSize() + _slot * this->stride);
+              }
+
+      /// \brief Get the size of the ring header, aligned.
+      /// \return Offset of the first slot.
+      public: static uint64_t HeaderSize()
+              {
+                return Align(sizeof(ShmRingHeader));
+              }
+
+      /// \brief Round a size up to the alignment.
+      /// \param[in] _size Size.
+      /// \return Aligned size.
+      public: static uint64_t Align(const uint64_t _size)
+              {
+                return (_size + kAlignment - 1) / kAlignment * kAlignment;
+              }
+
+      /// \brief Name of the segment.
+      public: std::string name;
+
+      /// \brief True if this ring created the segment and still owns
+      /// its name.
+      public: bool owner = false;
+
+      /// \brief Mapping of the segment.
+      public: bip::mapped_region region;
+
+      /// \brief Number of slots.
+      public: uint64_t slotCount = 0;
+
+      /// \brief Size of each slot.
+      public: uint64_t slotSize = 0;
+
+      /// \brief Distance between two slots.
+      public: uint64_t stride = 0;
+
+      /// \brief Next slot to write.
+      public: uint64_t nextSlot = 0;
+
+      /// \brief Last sequence number written.
+      public: uint64_t sequence = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the ShmChannel class.
+    class ShmChannelPrivate
+    {
+      /// \brief Protects the members.
+      public: mutable std::mutex mutex;
+
+      /// \brief Ring of the current generation.
+      public: std::unique_ptr<ShmRing> ring;
+
+      /// \brief Generation of the ring, 0 before the first one.
+      public: uint32_t generation = 0;
+
+      /// \brief Number of readers.
+      public: unsigned int readers = 0;
+
+      /// \brief Number of readers which mapped the current ring.
+      public: unsigned int mapped = 0;
+
+      /// \brief True while the name of the ring exists.
+      public: bool linked = false;
+
+      /// \brief True if a ring can't be created on this host.
+      public: bool failed = false;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+std::string ShmNotice::Serialize() const
+{
+  ShmNoticeData data;
+  memset(&data, 0, sizeof(data));
+  memcpy(data.magic, kNoticeMagic, sizeof(kNoticeMagic));
+  data.type = this->type;
+  data.generation = this->generation;
+  data.slot = this->slot;
+  data.size = this->size;
+  data.sequence = this->sequence;
+  strncpy(data.name, this->name.c_str(), kNameLength - 1);
+  return std::string(reinterpret_cast<const char *>(&data), sizeof(data));
+}
+
+//////////////////////////////////////////////////
+bool ShmNotice::Parse(const std::string &_data)
+{
+  if (_data.size() != sizeof(ShmNoticeData) ||
+      memcmp(_data.data(), kNoticeMagic, sizeof(kNoticeMagic)) != 0)
+  {
+    return false;
+  }
+
+  ShmNoticeData data;
+  memcpy(&data, _data.data(), sizeof(data));
+  if (data.type < OPEN || data.type > REJECT)
+    return false;
+
+  data.name[kNameLength - 1] = '\0';
+  this->type = static_cast<Type>(data.type);
+  this->generation = data.generation;
+  this->slot = data.slot;
+  this->size = data.size;
+  this->sequence = data.sequence;
+  this->name = data.name;
+  return true;
+}
+
+//////////////////////////////////////////////////
+ShmRing::ShmRing()
+  : dataPtr(new ShmRingPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ShmRing::~ShmRing()
+{
+  this->Unlink();
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Create(const std::string &_name, const unsigned int _slotCount,
+    const uint64_t _slotSize)
+{
+  if (this->IsOpen() || _name.empty() || _name.size() >= kNameLength ||
+      _slotCount == 0 || _slotSize == 0)
+  {
+    return false;
+  }
+
+  uint64_t stride = ShmRingPrivate::Align(sizeof(ShmSlotHeader)) +
+      ShmRingPrivate::Align(_slotSize);
+  uint64_t total = ShmRingPrivate::HeaderSize() + _slotCount * stride;
+
+  try
+  {
+    // Only readable by processes of the same user
+    bip::shared_memory_object shm(bip::create_only, _name.c_str(),
+        bip::read_write, bip::permissions(0600));
+    this->dataPtr->owner = true;
+    this->dataPtr->name = _name;
+    shm.truncate(static_cast<bip::offset_t>(total));
+    this->dataPtr->region = bip::mapped_region(shm, bip::read_write);
+  }
+  catch(bip::interprocess_exception &_e)
+  {
+    gzwarn << "Unable to create shared memory [" << _name << "] of "
+           << total << " bytes: " << _e.what() << std::endl;
+    this->Unlink();
+    this->dataPtr->region = bip::mapped_region();
+    return false;
+  }
+
+  auto header = static_cast<ShmRingHeader *>(
+      this->dataPtr->region.get_address());
+  header->magic = kRingMagic;
+  header->slotCount = _slotCount;
+  header->slotSize = _slotSize;
+
+  this->dataPtr->slotCount = _slotCount;
+  this->dataPtr->slotSize = _slotSize;
+  this->dataPtr->stride = stride;
+  for (uint64_t i = 0; i < this->dataPtr->slotCount; ++i)
+  {
+    ShmSlotHeader *slot = this->dataPtr->Slot(i);
+    new (&slot->sequence) std::atomic<uint64_t>(0);
+    slot->size = 0;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Open(const std::string &_name)
+{
+  if (this->IsOpen())
+    return false;
+
+  try
+  {
+    bip::shared_memory_object shm(bip::open_only, _name.c_str(),
+        bip::read_write);
+    this->dataPtr->region = bip::mapped_region(shm, bip::read_write);
+  }
+  catch(bip::interprocess_exception &_e)
+  {
+    gzwarn << "Unable to open shared memory [" << _name << "]: "
+           << _e.what() << std::endl;
+    return false;
+  }
+
+  // Check the layout against the size of the mapping
+  uint64_t mapped = this->dataPtr->region.get_size();
+  auto header = static_cast<const ShmRingHeader *>(
+      this->dataPtr->region.get_address());
+  uint64_t stride = 0;
+  bool valid = mapped >= ShmRingPrivate::HeaderSize() &&
+      header->magic == kRingMagic && header->slotCount > 0 &&
+      header->slotSize > 0;
+  if (valid)
+  {
+    stride = ShmRingPrivate::Align(sizeof(ShmSlotHeader)) +
+        ShmRingPrivate::Align(header->slotSize);
+    valid = (mapped - ShmRingPrivate::HeaderSize()) / stride >=
+        header->slotCount;
+  }
+
+  if (!valid)
+  {
+    gzwarn << "Shared memory [" << _name << "] isn't a ring" << std::endl;
+    this->dataPtr->region = bip::mapped_region();
+    return false;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->slotCount = header->slotCount;
+  this->dataPtr->slotSize = header->slotSize;
+  this->dataPtr->stride = stride;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ShmRing::Unlink()
+{
+  if (this->dataPtr->owner)
+  {
+    bip::shared_memory_object::remove(this->dataPtr->name.c_str());
+    this->dataPtr->owner = false;
+  }
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::IsOpen() const
+{
+  return this->dataPtr->slotCount > 0;
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::Name() const
+{
+  return this->dataPtr->name;
+}
+
+//////////////////////////////////////////////////
+unsigned int ShmRing::SlotCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->slotCount);
+}
+
+//////////////////////////////////////////////////
+uint64_t ShmRing::SlotSize() const
+{
+  return this->dataPtr->slotSize;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Write(const std::string &_data, uint32_t &_slot,
+    uint64_t &_sequence)
+{
+  if (!this->IsOpen() || _data.size() > this->dataPtr->slotSize)
+    return false;
+
+  _slot = static_cast<uint32_t>(this->dataPtr->nextSlot);
+  this->dataPtr->nextSlot = (this->dataPtr->nextSlot + 1) %
+      this->dataPtr->slotCount;
+  this->dataPtr->sequence += 2;
+  _sequence = this->dataPtr->sequence;
+
+  // Odd while writing, so that a reader of the previous message in this
+  // slot sees it was overwritten
+  ShmSlotHeader *slot = this->dataPtr->Slot(_slot);
+  slot->sequence.store(_sequence - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(reinterpret_cast<char *>(slot) +
+      ShmRingPrivate::Align(sizeof(ShmSlotHeader)),
+      _data.data(), _data.size());
+  slot->size = _data.size();
+  slot->sequence.store(_sequence, std::memory_order_release);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Read(const uint32_t _slot, const uint64_t _sequence,
+    std::string &_data) const
+{
+  if (_slot >= this->dataPtr->slotCount)
+    return false;
+
+  const ShmSlotHeader *slot = this->dataPtr->Slot(_slot);
+  if (slot->sequence.load(std::memory_order_acquire) != _sequence)
+    return false;
+
+  uint64_t size = slot->size;
+  if (size > this->dataPtr->slotSize)
+    return false;
+
+  _data.assign(reinterpret_cast<const char *>(slot) +
+      ShmRingPrivate::Align(sizeof(ShmSlotHeader)), size);
+
+  // Discard the copy if the writer came back to this slot meanwhile
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot->sequence.load(std::memory_order_relaxed) == _sequence;
+}
+
+//////////////////////////////////////////////////
+ShmChannel::ShmChannel()
+  : dataPtr(new ShmChannelPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+ShmChannel::~ShmChannel()
+{
+}
+
+//////////////////////////////////////////////////
+void ShmChannel::AddReader()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->readers++;
+}
+
+//////////////////////////////////////////////////
+void ShmChannel::RemoveReader(const uint32_t _generation)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->readers == 0)
+    return;
+
+  this->dataPtr->readers--;
+  if (this->dataPtr->ring && _generation == this->dataPtr->generation)
+    this->dataPtr->mapped--;
+
+  // Nobody reads the ring anymore
+  if (this->dataPtr->readers == 0)
+  {
+    this->dataPtr->ring.reset();
+    this->dataPtr->mapped = 0;
+    this->dataPtr->linked = false;
+  }
+  else if (this->dataPtr->linked &&
+      this->dataPtr->mapped == this->dataPtr->readers)
+  {
+    this->dataPtr->ring->Unlink();
+    this->dataPtr->linked = false;
+  }
+}
+
+//////////////////////////////////////////////////
+void ShmChannel::AddMapped(const uint32_t _generation)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->ring || _generation != this->dataPtr->generation)
+    return;
+
+  this->dataPtr->mapped++;
+
+  // Every reader has it mapped, so the name isn't needed anymore, and the
+  // memory is released with the last process using it
+  if (this->dataPtr->linked &&
+      this->dataPtr->mapped >= this->dataPtr->readers)
+  {
+    this->dataPtr->ring->Unlink();
+    this->dataPtr->linked = false;
+  }
+}
+
+//////////////////////////////////////////////////
+bool ShmChannel::Offer(ShmNotice &_notice) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (!this->dataPtr->ring || !this->dataPtr->linked)
+    return false;
+
+  _notice.type = ShmNotice::OPEN;
+  _notice.generation = this->dataPtr->generation;
+  _notice.name = this->dataPtr->ring->Name();
+  _notice.slot = this->dataPtr->ring->SlotCount();
+  _notice.size = this->dataPtr->ring->SlotSize();
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ShmChannel::Write(const std::string &_data, ShmNotice &_notice)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (_data.size() < kShmThreshold || this->dataPtr->readers == 0 ||
+      this->dataPtr->failed)
+  {
+    return false;
+  }
+
+  // A new ring replaces one which is too small, or whose name was removed
+  // before a reader was added. This message and the following ones go
+  // over the connections until the readers have mapped it.
+  if (!this->dataPtr->ring ||
+      (!this->dataPtr->linked &&
+       this->dataPtr->mapped < this->dataPtr->readers) ||
+      _data.size() > this->dataPtr->ring->SlotSize())
+  {
+    uint64_t slotSize = kShmMinSlotSize;
+    while (slotSize < 2 * _data.size())
+      slotSize *= 2;
+
+    this->dataPtr->ring.reset(new ShmRing());
+    this->dataPtr->generation++;
+    this->dataPtr->mapped = 0;
+    this->dataPtr->linked = this->dataPtr->ring->Create(
+        ShmRing::UniqueName(), kShmSlotCount, slotSize);
+    if (!this->dataPtr->linked)
+    {
+      this->dataPtr->ring.reset();
+      this->dataPtr->failed = true;
+    }
+    return false;
+  }
+
+  if (this->dataPtr->mapped == 0)
+    return false;
+
+  _notice.type = ShmNotice::MESSAGE;
+  _notice.generation = this->dataPtr->generation;
+  _notice.size = _data.size();
+  return this->dataPtr->ring->Write(_data, _notice.slot, _notice.sequence);
+}
+
+//////////////////////////////////////////////////
+/// \brief Compute the host id.
+/// \return Host name, boot id and mount namespace.
+static std::string ComputeHostId()
+{
+  std::ostringstream id;
+  id << Connection::GetLocalHostname();
+
+#ifdef __linux__
+  // Containers may share the host name but not /dev/shm
+  std::ifstream bootId("/proc/sys/kernel/random/boot_id");
+  std::string boot;
+  if (bootId >> boot)
+    id << "/" << boot;
+
+  char ns[64];
+  ssize_t length = readlink("/proc/self/ns/mnt", ns, sizeof(ns) - 1);
+  if (length > 0)
+    id << "/" << std::string(ns, length);
+#endif
+
+  return id.str();
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::HostId()
+{
+  static const std::string id = ComputeHostId();
+  return id;
+}
+
+//////////////////////////////////////////////////
+std::string ShmRing::UniqueName()
+{
+  static std::atomic<unsigned int> counter(0);
+  static const unsigned int prefix = std::random_device()();
+
+  std::ostringstream name;
+  name << "gzshm_" << std::hex << prefix << "_" << counter++;
+  return name.str();
+}
+
+//////////////////////////////////////////////////
+bool ShmRing::Enabled()
+{
+  const char *env = std::getenv("GAZEBO_SHM_TRANSPORT");
+  return !env || std::string(env) != "0";
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SHMRING_HH_
+#define GAZEBO_TRANSPORT_SHMRING_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private data classes.
+    class ShmChannelPrivate;
+    class ShmRingPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class ShmNotice ShmRing.hh transport/transport.hh
+    /// \brief Control frame of the shared memory transport, sent over the
+    /// TCP connection between a publisher and a subscriber on the same
+    /// host. A serialized notice starts with a null byte, which no
+    /// serialized message does, so that notices and messages can share the
+    /// connection.
+    class GZ_TRANSPORT_VISIBLE ShmNotice
+    {
+      /// \brief Types of notices.
+      public: enum Type
+              {
+                /// \brief Publisher to subscriber: a ring was created.
+                OPEN = 1,
+
+                /// \brief Publisher to subscriber: a message was written to
+                /// a slot.
+                MESSAGE = 2,
+
+                /// \brief Subscriber to publisher: the ring was mapped.
+                ACK = 3,
+
+                /// \brief Subscriber to publisher: the ring can't be
+                /// mapped, keep using TCP.
+                REJECT = 4
+              };
+
+      /// \brief Serialize the notice.
+      /// \return Serialized notice.
+      public: std::string Serialize() const;
+
+      /// \brief Parse a notice.
+      /// \param[in] _data Data received from a connection.
+      /// \return False if _data isn't a notice.
+      public: bool Parse(const std::string &_data);
+
+      /// \brief Type of the notice.
+      public: Type type = OPEN;
+
+      /// \brief Generation of the ring, incremented each time the
+      /// publisher replaces it.
+      public: uint32_t generation = 0;
+
+      /// \brief Name of the ring, for OPEN.
+      public: std::string name;
+
+      /// \brief Number of slots for OPEN, slot index for MESSAGE.
+      public: uint32_t slot = 0;
+
+      /// \brief Slot size for OPEN, message size for MESSAGE.
+      public: uint64_t size = 0;
+
+      /// \brief Sequence number of the message, for MESSAGE.
+      public: uint64_t sequence = 0;
+    };
+
+    /// \class ShmRing ShmRing.hh transport/transport.hh
+    /// \brief Ring of fixed size slots in a shared memory segment, written
+    /// by one publisher and read by its subscribers on the same host.
+    ///
+    /// Each slot is guarded by a sequence number, incremented before and
+    /// after the message is written, so that a reader can detect a slot
+    /// that was overwritten while it lagged behind. The writer never waits
+    /// for the readers, and each reader follows its own sequence numbers.
+    class GZ_TRANSPORT_VISIBLE ShmRing
+    {
+      /// \brief Constructor.
+      public: ShmRing();
+
+      /// \brief Destructor. Removes the segment if it was created by this
+      /// ring and not removed yet.
+      public: virtual ~ShmRing();
+
+      /// \brief Create a segment.
+      /// \param[in] _name Unique name of the segment.
+      /// \param[in] _slotCount Number of slots.
+      /// \param[in] _slotSize Size of each slot in bytes.
+      /// \return False if the segment can't be created.
+      public: bool Create(const std::string &_name,
+                  const unsigned int _slotCount, const uint64_t _slotSize);
+
+      /// \brief Map a segment created by another ring.
+      /// \param[in] _name Name of the segment.
+      /// \return False if the segment can't be mapped.
+      public: bool Open(const std::string &_name);
+
+      /// \brief Remove the name of the segment. Existing mappings stay
+      /// valid, which lets the segment go away with the last process using
+      /// it.
+      public: void Unlink();
+
+      /// \brief Get whether a segment is mapped.
+      /// \return True if Create or Open succeeded.
+      public: bool IsOpen() const;
+
+      /// \brief Get the name of the segment.
+      /// \return Name of the segment.
+      public: std::string Name() const;
+
+      /// \brief Get the number of slots.
+      /// \return Number of slots, 0 if no segment is mapped.
+      public: unsigned int SlotCount() const;
+
+      /// \brief Get the size of a slot.
+      /// \return Size of a slot in bytes, 0 if no segment is mapped.
+      public: uint64_t SlotSize() const;
+
+      /// \brief Write a message to the next slot.
+      /// \param[in] _data Message, at most SlotSize bytes.
+      /// \param[out] _slot Slot written.
+      /// \param[out] _sequence Sequence number of the message.
+      /// \return False if the message doesn't fit.
+      public: bool Write(const std::string &_data, uint32_t &_slot,
+                  uint64_t &_sequence);
+
+      /// \brief Read a message from a slot.
+      /// \param[in] _slot Slot to read.
+      /// \param[in] _sequence Sequence number of the message.
+      /// \param[out] _data Message.
+      /// \return False if the slot was overwritten.
+      public: bool Read(const uint32_t _slot, const uint64_t _sequence,
+                  std::string &_data) const;
+
+      /// \brief Get an identifier which is the same for two processes only
+      /// if they can share memory.
+      /// \return Identifier of this host.
+      public: static std::string HostId();
+
+      /// \brief Get a new segment name, unique on this host.
+      /// \return Segment name.
+      public: static std::string UniqueName();
+
+      /// \brief Get whether the shared memory transport is enabled. It can
+      /// be disabled by setting GAZEBO_SHM_TRANSPORT to 0.
+      /// \return True if enabled.
+      public: static bool Enabled();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ShmRingPrivate> dataPtr;
+    };
+
+    /// \class ShmChannel ShmRing.hh transport/transport.hh
+    /// \brief Ring of a publication, shared by all of its subscribers on
+    /// the same host. Each message is copied once into the ring, whatever
+    /// the number of subscribers, and each subscription sends its own
+    /// notice of the slot.
+    ///
+    /// The ring is created with the first large message, and offered to
+    /// each reader with an OPEN notice. Its name is removed once every
+    /// reader mapped it; a reader added later gets a new ring.
+    class GZ_TRANSPORT_VISIBLE ShmChannel
+    {
+      /// \brief Constructor.
+      public: ShmChannel();
+
+      /// \brief Destructor.
+      public: virtual ~ShmChannel();
+
+      /// \brief Add a reader, a subscription on the same host.
+      public: void AddReader();
+
+      /// \brief Remove a reader.
+      /// \param[in] _generation Generation of the ring mapped by the
+      /// reader, 0 if none.
+      public: void RemoveReader(const uint32_t _generation);
+
+      /// \brief Record that a reader mapped a ring.
+      /// \param[in] _generation Generation of the ring.
+      public: void AddMapped(const uint32_t _generation);
+
+      /// \brief Get the notice offering the current ring to a reader.
+      /// \param[out] _notice OPEN notice.
+      /// \return False if there is no ring.
+      public: bool Offer(ShmNotice &_notice) const;
+
+      /// \brief Write a message to the ring, once for all the readers. A
+      /// ring is created, or replaced by a larger one, when needed.
+      /// \param[in] _data The message.
+      /// \param[out] _notice MESSAGE notice for the readers which mapped
+      /// the current ring.
+      /// \return False if the message must go over the connections: it is
+      /// small, or no reader mapped the ring yet.
+      public: bool Write(const std::string &_data, ShmNotice &_notice);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ShmChannelPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
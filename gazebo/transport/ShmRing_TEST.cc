@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/transport/ShmRing.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class ShmRingTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Notice)
+{
+  transport::ShmNotice notice;
+  notice.type = transport::ShmNotice::MESSAGE;
+  notice.generation = 3;
+  notice.name = transport::ShmRing::UniqueName();
+  notice.slot = 2;
+  notice.size = 1 << 20;
+  notice.sequence = 42;
+
+  std::string data = notice.Serialize();
+  ASSERT_FALSE(data.empty());
+  EXPECT_EQ('\0', data[0]);
+
+  transport::ShmNotice parsed;
+  EXPECT_TRUE(parsed.Parse(data));
+  EXPECT_EQ(notice.type, parsed.type);
+  EXPECT_EQ(notice.generation, parsed.generation);
+  EXPECT_EQ(notice.name, parsed.name);
+  EXPECT_EQ(notice.slot, parsed.slot);
+  EXPECT_EQ(notice.size, parsed.size);
+  EXPECT_EQ(notice.sequence, parsed.sequence);
+
+  // Messages aren't notices
+  EXPECT_FALSE(parsed.Parse(""));
+  EXPECT_FALSE(parsed.Parse(data.substr(1)));
+  EXPECT_FALSE(parsed.Parse(std::string("\x0a\x05hello", 7)));
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, WriteRead)
+{
+  std::string name = transport::ShmRing::UniqueName();
+  EXPECT_NE(name, transport::ShmRing::UniqueName());
+  EXPECT_FALSE(transport::ShmRing::HostId().empty());
+
+  transport::ShmRing writer;
+  EXPECT_FALSE(writer.IsOpen());
+  ASSERT_TRUE(writer.Create(name, 2, 100));
+  EXPECT_TRUE(writer.IsOpen());
+  EXPECT_EQ(2u, writer.SlotCount());
+  EXPECT_EQ(100u, writer.SlotSize());
+
+  // The name is taken
+  transport::ShmRing other;
+  EXPECT_FALSE(other.Create(name, 2, 100));
+
+  transport::ShmRing reader;
+  ASSERT_TRUE(reader.Open(name));
+  EXPECT_EQ(name, reader.Name());
+  EXPECT_EQ(2u, reader.SlotCount());
+  EXPECT_EQ(100u, reader.SlotSize());
+
+  // Existing mappings outlive the name
+  writer.Unlink();
+  EXPECT_FALSE(other.Open(name));
+
+  uint32_t slot1, slot2, slot3;
+  uint64_t seq1, seq2, seq3;
+  EXPECT_FALSE(writer.Write(std::string(101, 'x'), slot1, seq1));
+  ASSERT_TRUE(writer.Write("first", slot1, seq1));
+  ASSERT_TRUE(writer.Write(std::string(100, 'b'), slot2, seq2));
+  EXPECT_NE(slot1, slot2);
+  EXPECT_LT(seq1, seq2);
+
+  std::string data;
+  EXPECT_TRUE(reader.Read(slot1, seq1, data));
+  EXPECT_EQ("first", data);
+  EXPECT_TRUE(reader.Read(slot2, seq2, data));
+  EXPECT_EQ(std::string(100, 'b'), data);
+  EXPECT_FALSE(reader.Read(slot2, seq1, data));
+  EXPECT_FALSE(reader.Read(2, seq1, data));
+
+  // The third message overwrites the first
+  ASSERT_TRUE(writer.Write("third", slot3, seq3));
+  EXPECT_EQ(slot1, slot3);
+  EXPECT_FALSE(reader.Read(slot1, seq1, data));
+  EXPECT_TRUE(reader.Read(slot3, seq3, data));
+  EXPECT_EQ("third", data);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ShmRingTest, Channel)
+{
+  transport::ShmChannel channel;
+  transport::ShmNotice offer, notice;
+  const std::string large(100 * 1024, 'l');
+
+  // No ring without readers, or for small messages
+  EXPECT_FALSE(channel.Write(large, notice));
+  EXPECT_FALSE(channel.Offer(offer));
+  channel.AddReader();
+  channel.AddReader();
+  EXPECT_FALSE(channel.Write("small", notice));
+  EXPECT_FALSE(channel.Offer(offer));
+
+  // The first large message creates the ring, and goes over the
+  // connections until the readers mapped it
+  EXPECT_FALSE(channel.Write(large, notice));
+  ASSERT_TRUE(channel.Offer(offer));
+  EXPECT_EQ(transport::ShmNotice::OPEN, offer.type);
+  EXPECT_EQ(1u, offer.generation);
+  EXPECT_GE(offer.size, 2 * large.size());
+  EXPECT_FALSE(channel.Write(large, notice));
+
+  transport::ShmRing reader1, reader2;
+  ASSERT_TRUE(reader1.Open(offer.name));
+  channel.AddMapped(offer.generation);
+  ASSERT_TRUE(reader2.Open(offer.name));
+
+  // The name is removed once every reader mapped the ring
+  transport::ShmRing other;
+  EXPECT_TRUE(other.Open(offer.name));
+  channel.AddMapped(offer.generation);
+  EXPECT_FALSE(channel.Offer(offer));
+  transport::ShmRing late;
+  EXPECT_FALSE(late.Open(offer.name));
+
+  // A message is written once, for both readers
+  ASSERT_TRUE(channel.Write(large, notice));
+  EXPECT_EQ(transport::ShmNotice::MESSAGE, notice.type);
+  EXPECT_EQ(1u, notice.generation);
+  EXPECT_EQ(large.size(), notice.size);
+  std::string data1, data2;
+  EXPECT_TRUE(reader1.Read(notice.slot, notice.sequence, data1));
+  EXPECT_TRUE(reader2.Read(notice.slot, notice.sequence, data2));
+  EXPECT_EQ(large, data1);
+  EXPECT_EQ(large, data2);
+
+  // A reader added later gets a new ring, which all readers map again
+  channel.AddReader();
+  EXPECT_FALSE(channel.Write(large, notice));
+  ASSERT_TRUE(channel.Offer(offer));
+  EXPECT_EQ(2u, offer.generation);
+  channel.AddMapped(1);
+  channel.AddMapped(offer.generation);
+  channel.AddMapped(offer.generation);
+  ASSERT_TRUE(channel.Write(large, notice));
+  EXPECT_EQ(2u, notice.generation);
+  EXPECT_TRUE(channel.Offer(offer));
+
+  // The name is removed when the reader which didn't map the ring leaves
+  channel.RemoveReader(0);
+  EXPECT_FALSE(channel.Offer(offer));
+  ASSERT_TRUE(channel.Write(large, notice));
+  EXPECT_EQ(2u, notice.generation);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
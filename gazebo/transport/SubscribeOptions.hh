@@ -34,9 +34,37 @@ namespace gazebo
     /// \brief Options for a subscription
     class GZ_TRANSPORT_VISIBLE SubscribeOptions
     {
+      /// \brief Threads which run the callback of a subscription.
+      public: enum Executor
+              {
+                /// \brief The transport thread, shared by all the
+                /// subscriptions of the process.
+                NODE,
+
+                /// \brief A thread dedicated to the subscription.
+                DEDICATED,
+
+                /// \brief A pool of threads shared by the subscriptions
+                /// which chose it. Callbacks of one subscription still run
+                /// one at a time, in order.
+                POOLED
+              };
+
+      /// \brief Messages kept while a callback is busy.
+      public: enum QueuePolicy
+              {
+                /// \brief Keep every message.
+                KEEP_ALL,
+
+                /// \brief Keep only the latest messages, up to the queue
+                /// depth, and drop the oldest ones.
+                KEEP_LATEST
+              };
+
       /// \brief Constructor
       public: SubscribeOptions()
-              : latching(false)
+              : latching(false), executor(NODE), queuePolicy(KEEP_ALL),
+                queueDepth(0)
               {}
 
       /// \brief Initialize the options
@@ -103,10 +131,59 @@ namespace gazebo
                 return this->latching;
               }
 
+      /// \brief Set the threads which run the callback. Callbacks are
+      /// run by the transport thread by default.
+      /// \param[in] _executor Executor of the callback.
+      public: void SetExecutor(const Executor _executor)
+              {
+                this->executor = _executor;
+              }
+
+      /// \brief Get the threads which run the callback.
+      /// \return Executor of the callback.
+      public: Executor GetExecutor() const
+              {
+                return this->executor;
+              }
+
+      /// \brief Set the messages kept while the callback is busy. Every
+      /// message is kept by default.
+      /// \param[in] _policy Queue policy.
+      /// \param[in] _depth Number of messages kept by KEEP_LATEST.
+      public: void SetQueuePolicy(const QueuePolicy _policy,
+                  const unsigned int _depth = 1)
+              {
+                this->queuePolicy = _policy;
+                this->queueDepth = _depth;
+              }
+
+      /// \brief Get the messages kept while the callback is busy.
+      /// \return Queue policy.
+      public: QueuePolicy GetQueuePolicy() const
+              {
+                return this->queuePolicy;
+              }
+
+      /// \brief Get the number of messages kept by KEEP_LATEST.
+      /// \return Queue depth.
+      public: unsigned int GetQueueDepth() const
+              {
+                return this->queueDepth;
+              }
+
       private: std::string topic;
       private: std::string msgType;
       private: NodePtr node;
       private: bool latching;
+
+      /// \brief Threads which run the callback.
+      private: Executor executor;
+
+      /// \brief Messages kept while the callback is busy.
+      private: QueuePolicy queuePolicy;
+
+      /// \brief Number of messages kept by KEEP_LATEST.
+      private: unsigned int queueDepth;
     };
     /// \}
   }
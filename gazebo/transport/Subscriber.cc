@@ -53,6 +53,15 @@ void Subscriber::Unsubscribe() const
   }
 }
 
+//////////////////////////////////////////////////
+bool Subscriber::QueueStats(SubscriptionQueueStats &_stats) const
+{
+  if (!this->node)
+    return false;
+
+  return this->node->QueueStats(this->topic, this->callbackId, _stats);
+}
+
 //////////////////////////////////////////////////
 void Subscriber::SetCallbackId(unsigned int _id)
 {
@@ -25,6 +25,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "gazebo/transport/CallbackHelper.hh"
+#include "gazebo/transport/SubscriptionQueue.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -65,6 +66,15 @@ namespace gazebo
       /// \brief Unsubscribe from the topic
       public: void Unsubscribe() const;
 
+      /// \brief Get the queue counters of the subscription: queue depth,
+      /// and messages received, delivered and dropped.
+      /// \param[out] _stats Queue counters.
+      /// \return False if the subscription doesn't have a queue, which is
+      /// the case when it uses the default executor and queue policy.
+      /// \sa SubscribeOptions::SetExecutor
+      /// \sa SubscribeOptions::SetQueuePolicy
+      public: bool QueueStats(SubscriptionQueueStats &_stats) const;
+
       /// \brief Topic this object is subscribe to.
       private: std::string topic;
 
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gazebo/transport/SubscriptionQueue.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the SubscriptionExecutor class.
+    class SubscriptionExecutorPrivate
+    {
+      /// \brief Run tasks until stopped.
+      /// \param[in] _self Keeps the data alive while the thread runs.
+      public: static void Run(std::shared_ptr<SubscriptionExecutorPrivate>
+                  _self)
+              {
+                std::unique_lock<std::mutex> lock(_self->mutex);
+                while (!_self->stop)
+                {
+                  if (_self->tasks.empty())
+                  {
+                    _self->condition.wait(lock);
+                    continue;
+                  }
+
+                  std::function<void()> task = std::move(_self->tasks.front());
+                  _self->tasks.pop_front();
+                  lock.unlock();
+                  task();
+                  lock.lock();
+                }
+              }
+
+      /// \brief Pending tasks.
+      public: std::deque<std::function<void()>> tasks;
+
+      /// \brief Function called after each Post.
+      public: std::function<void()> notify;
+
+      /// \brief Threads running the tasks.
+      public: std::vector<std::thread> threads;
+
+      /// \brief True when the executor is destroyed.
+      public: bool stop = false;
+
+      /// \brief Protects the tasks and stop flag.
+      public: std::mutex mutex;
+
+      /// \brief Signaled when a task is posted, or the executor stopped.
+      public: std::condition_variable condition;
+    };
+
+    /// \internal
+    /// \brief A message waiting in a subscription queue.
+    class SubscriptionQueueEntry
+    {
+      /// \brief Serialized message, if msg is null.
+      public: std::string data;
+
+      /// \brief Message published in this process.
+      public: MessagePtr msg;
+
+      /// \brief Callback invoked once the message was handled.
+      public: boost::function<void(uint32_t)> cb;
+
+      /// \brief ID passed to cb.
+      public: uint32_t id = 0;
+    };
+
+    /// \internal
+    /// \brief Private data for the SubscriptionQueue class.
+    class SubscriptionQueuePrivate
+    {
+      /// \brief Callback helper which handles the messages.
+      public: CallbackHelperPtr helper;
+
+      /// \brief Executor which runs the helper.
+      public: SubscriptionExecutorPtr executor;
+
+      /// \brief Messages kept while the helper is busy.
+      public: SubscribeOptions::QueuePolicy policy;
+
+      /// \brief Number of messages kept by KEEP_LATEST.
+      public: size_t depth;
+
+      /// \brief Messages waiting for the helper.
+      public: std::deque<SubscriptionQueueEntry> entries;
+
+      /// \brief Counters.
+      public: SubscriptionQueueStats stats;
+
+      /// \brief True while a Drain task is posted or running.
+      public: bool scheduled = false;
+
+      /// \brief True once stopped.
+      public: bool stopped = false;
+
+      /// \brief Thread running Drain.
+      public: std::thread::id drainThread;
+
+      /// \brief Protects the members above.
+      public: mutable std::mutex mutex;
+
+      /// \brief Held while messages are passed to the helper.
+      public: std::mutex drainMutex;
+    };
+  }
+}
+
+//////////////////////////////////////////////////
+SubscriptionExecutor::SubscriptionExecutor(const unsigned int _threads)
+  : dataPtr(new SubscriptionExecutorPrivate)
+{
+  for (unsigned int i = 0; i < _threads; ++i)
+  {
+    this->dataPtr->threads.push_back(
+        std::thread(&SubscriptionExecutorPrivate::Run, this->dataPtr));
+  }
+}
+
+//////////////////////////////////////////////////
+SubscriptionExecutor::~SubscriptionExecutor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+    this->dataPtr->tasks.clear();
+  }
+  this->dataPtr->condition.notify_all();
+
+  for (auto &thread : this->dataPtr->threads)
+  {
+    // A task may release the last reference to its executor
+    if (thread.get_id() == std::this_thread::get_id())
+      thread.detach();
+    else
+      thread.join();
+  }
+}
+
+//////////////////////////////////////////////////
+void SubscriptionExecutor::Post(const std::function<void()> &_task)
+{
+  std::function<void()> notify;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stop)
+      return;
+    this->dataPtr->tasks.push_back(_task);
+    notify = this->dataPtr->notify;
+  }
+  this->dataPtr->condition.notify_one();
+
+  if (notify)
+    notify();
+}
+
+//////////////////////////////////////////////////
+unsigned int SubscriptionExecutor::Poll()
+{
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    tasks.swap(this->dataPtr->tasks);
+  }
+
+  for (auto &task : tasks)
+    task();
+
+  return static_cast<unsigned int>(tasks.size());
+}
+
+//////////////////////////////////////////////////
+void SubscriptionExecutor::SetNotify(const std::function<void()> &_notify)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->notify = _notify;
+}
+
+//////////////////////////////////////////////////
+unsigned int SubscriptionExecutor::ThreadCount() const
+{
+  return static_cast<unsigned int>(this->dataPtr->threads.size());
+}
+
+//////////////////////////////////////////////////
+SubscriptionExecutorPtr SubscriptionExecutor::Pool()
+{
+  static SubscriptionExecutorPtr pool(new SubscriptionExecutor(
+        std::max(2u, std::thread::hardware_concurrency())));
+  return pool;
+}
+
+//////////////////////////////////////////////////
+SubscriptionQueue::SubscriptionQueue(CallbackHelperPtr _helper,
+    SubscriptionExecutorPtr _executor,
+    const SubscribeOptions::QueuePolicy _policy, const unsigned int _depth)
+  : CallbackHelper(_helper->GetLatching()),
+    dataPtr(new SubscriptionQueuePrivate)
+{
+  this->dataPtr->helper = _helper;
+  this->dataPtr->executor = _executor;
+  this->dataPtr->policy = _policy;
+  this->dataPtr->depth = std::max(1u, _depth);
+}
+
+//////////////////////////////////////////////////
+SubscriptionQueue::~SubscriptionQueue()
+{
+}
+
+//////////////////////////////////////////////////
+std::string SubscriptionQueue::GetMsgType() const
+{
+  return this->dataPtr->helper->GetMsgType();
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionQueue::HandleData(const std::string &_newdata,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  SubscriptionQueueEntry entry;
+  entry.data = _newdata;
+  entry.cb = _cb;
+  entry.id = _id;
+  return this->Push(entry);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionQueue::HandleMessage(MessagePtr _newMsg)
+{
+  SubscriptionQueueEntry entry;
+  entry.msg = _newMsg;
+  return this->Push(entry);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionQueue::Push(SubscriptionQueueEntry &_entry)
+{
+  this->SetLatching(false);
+
+  std::vector<SubscriptionQueueEntry> dropped;
+  bool post = false;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    if (this->dataPtr->stopped)
+      return false;
+
+    if (this->dataPtr->policy == SubscribeOptions::KEEP_LATEST)
+    {
+      while (this->dataPtr->entries.size() >= this->dataPtr->depth)
+      {
+        dropped.push_back(std::move(this->dataPtr->entries.front()));
+        this->dataPtr->entries.pop_front();
+        this->dataPtr->stats.dropped++;
+      }
+    }
+
+    this->dataPtr->entries.push_back(std::move(_entry));
+    this->dataPtr->stats.received++;
+    this->dataPtr->stats.maxDepth = std::max<uint64_t>(
+        this->dataPtr->stats.maxDepth, this->dataPtr->entries.size());
+
+    post = !this->dataPtr->scheduled;
+    this->dataPtr->scheduled = true;
+  }
+
+  // Dropped messages are done with, as far as the sender is concerned
+  for (auto &entry : dropped)
+  {
+    if (!entry.cb.empty())
+      entry.cb(entry.id);
+  }
+
+  if (post)
+    this->Schedule();
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionQueue::Drain()
+{
+  std::lock_guard<std::mutex> drainLock(this->dataPtr->drainMutex);
+
+  // Pass at most the messages present now, so that a busy subscription
+  // doesn't hold a pooled thread forever
+  size_t count;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    count = this->dataPtr->entries.size();
+    this->dataPtr->drainThread = std::this_thread::get_id();
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    SubscriptionQueueEntry entry;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      if (this->dataPtr->stopped || this->dataPtr->entries.empty())
+        break;
+      entry = std::move(this->dataPtr->entries.front());
+      this->dataPtr->entries.pop_front();
+      this->dataPtr->stats.delivered++;
+    }
+
+    if (entry.msg)
+      this->dataPtr->helper->HandleMessage(entry.msg);
+    else
+      this->dataPtr->helper->HandleData(entry.data, entry.cb, entry.id);
+  }
+
+  bool post = false;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->drainThread = std::thread::id();
+    post = !this->dataPtr->stopped && !this->dataPtr->entries.empty();
+    this->dataPtr->scheduled = post;
+  }
+
+  if (post)
+    this->Schedule();
+}
+
+//////////////////////////////////////////////////
+void SubscriptionQueue::Schedule()
+{
+  boost::weak_ptr<SubscriptionQueue> weak(this->shared_from_this());
+  this->dataPtr->executor->Post([weak]()
+      {
+        SubscriptionQueuePtr queue = weak.lock();
+        if (queue)
+          queue->Drain();
+      });
+}
+
+//////////////////////////////////////////////////
+void SubscriptionQueue::Stop()
+{
+  bool wait;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopped = true;
+    this->dataPtr->entries.clear();
+    wait = this->dataPtr->drainThread != std::this_thread::get_id();
+  }
+
+  // Wait for a callback running on another thread
+  if (wait)
+  {
+    std::lock_guard<std::mutex> drainLock(this->dataPtr->drainMutex);
+  }
+}
+
+//////////////////////////////////////////////////
+SubscriptionQueueStats SubscriptionQueue::Stats() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  SubscriptionQueueStats stats = this->dataPtr->stats;
+  stats.depth = this->dataPtr->entries.size();
+  return stats;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionQueue::IsLocal() const
+{
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionQueue::IsQueued() const
+{
+  return true;
+}
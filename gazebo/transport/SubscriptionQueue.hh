@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_SUBSCRIPTIONQUEUE_HH_
+#define GAZEBO_TRANSPORT_SUBSCRIPTIONQUEUE_HH_
+
+#include <boost/enable_shared_from_this.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "gazebo/transport/CallbackHelper.hh"
+#include "gazebo/transport/SubscribeOptions.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private data classes.
+    class SubscriptionExecutorPrivate;
+    class SubscriptionQueuePrivate;
+    class SubscriptionQueueEntry;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class SubscriptionExecutor SubscriptionQueue.hh
+    /// transport/transport.hh
+    /// \brief Threads which run the tasks posted by subscription queues.
+    class GZ_TRANSPORT_VISIBLE SubscriptionExecutor
+    {
+      /// \brief Constructor.
+      /// \param[in] _threads Number of threads. With 0 threads, the tasks
+      /// are run by the callers of Poll.
+      public: explicit SubscriptionExecutor(const unsigned int _threads);
+
+      /// \brief Destructor. Waits for the running tasks, and discards the
+      /// pending ones.
+      public: virtual ~SubscriptionExecutor();
+
+      /// \brief Post a task.
+      /// \param[in] _task Task to run.
+      public: void Post(const std::function<void()> &_task);
+
+      /// \brief Run the pending tasks on the calling thread.
+      /// \return Number of tasks run.
+      public: unsigned int Poll();
+
+      /// \brief Set a function called after each Post, used to wake up the
+      /// thread which calls Poll.
+      /// \param[in] _notify Function to call.
+      public: void SetNotify(const std::function<void()> &_notify);
+
+      /// \brief Get the number of threads.
+      /// \return Number of threads.
+      public: unsigned int ThreadCount() const;
+
+      /// \brief Get the pool shared by the POOLED subscriptions, with a
+      /// thread per core.
+      /// \return The shared pool.
+      public: static SubscriptionExecutorPtr Pool();
+
+      /// \internal
+      /// \brief Private data pointer. Shared with the threads, which may
+      /// outlive the executor when it's destroyed by one of its tasks.
+      private: std::shared_ptr<SubscriptionExecutorPrivate> dataPtr;
+    };
+
+    /// \class SubscriptionQueueStats SubscriptionQueue.hh
+    /// transport/transport.hh
+    /// \brief Counters of a subscription queue.
+    class GZ_TRANSPORT_VISIBLE SubscriptionQueueStats
+    {
+      /// \brief Number of messages waiting for the callback.
+      public: uint64_t depth = 0;
+
+      /// \brief Highest number of messages waiting for the callback.
+      public: uint64_t maxDepth = 0;
+
+      /// \brief Number of messages received.
+      public: uint64_t received = 0;
+
+      /// \brief Number of messages passed to the callback.
+      public: uint64_t delivered = 0;
+
+      /// \brief Number of messages dropped by the queue policy.
+      public: uint64_t dropped = 0;
+    };
+
+    /// \class SubscriptionQueue SubscriptionQueue.hh transport/transport.hh
+    /// \brief Callback helper which queues messages, and passes them to
+    /// another callback helper on an executor. Messages are handed over
+    /// directly by the node, without waiting for the transport thread,
+    /// and a callback which falls behind only delays its own subscription.
+    class GZ_TRANSPORT_VISIBLE SubscriptionQueue : public CallbackHelper,
+        public boost::enable_shared_from_this<SubscriptionQueue>
+    {
+      /// \brief Constructor.
+      /// \param[in] _helper Callback helper which handles the messages.
+      /// \param[in] _executor Executor which runs _helper.
+      /// \param[in] _policy Messages kept while _helper is busy.
+      /// \param[in] _depth Number of messages kept by KEEP_LATEST.
+      public: SubscriptionQueue(CallbackHelperPtr _helper,
+                  SubscriptionExecutorPtr _executor,
+                  const SubscribeOptions::QueuePolicy _policy,
+                  const unsigned int _depth);
+
+      /// \brief Destructor.
+      public: virtual ~SubscriptionQueue();
+
+      // Documentation inherited
+      public: virtual std::string GetMsgType() const;
+
+      // Documentation inherited
+      public: virtual bool HandleData(const std::string &_newdata,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
+      // Documentation inherited
+      public: virtual bool HandleMessage(MessagePtr _newMsg);
+
+      // Documentation inherited
+      public: virtual bool IsLocal() const;
+
+      // Documentation inherited
+      public: virtual bool IsQueued() const;
+
+      /// \brief Drop the queued messages, and wait for the callback if it
+      /// runs on another thread. The callback isn't called anymore
+      /// afterwards.
+      public: void Stop();
+
+      /// \brief Get the counters of the queue.
+      /// \return Counters.
+      public: SubscriptionQueueStats Stats() const;
+
+      /// \brief Queue a message, and schedule a drain if none is pending.
+      /// \param[in] _entry The message.
+      /// \return False if the queue was stopped.
+      private: bool Push(SubscriptionQueueEntry &_entry);
+
+      /// \brief Post a drain task to the executor.
+      private: void Schedule();
+
+      /// \brief Pass the queued messages to the callback helper. Run by
+      /// the executor.
+      private: void Drain();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SubscriptionQueuePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
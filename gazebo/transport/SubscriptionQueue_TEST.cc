@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <boost/bind.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gazebo/transport/SubscriptionQueue.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class SubscriptionQueueTest : public gazebo::testing::AutoLogFixture { };
+
+/// \brief Records the messages it receives.
+class Recorder
+{
+  /// \brief Raw message callback.
+  /// \param[in] _data Message.
+  public: void OnData(const std::string &_data)
+          {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->messages.push_back(_data);
+            this->threads.push_back(std::this_thread::get_id());
+          }
+
+  /// \brief Wait until a number of messages was received.
+  /// \param[in] _count Number of messages.
+  /// \return False on timeout.
+  public: bool Wait(const size_t _count)
+          {
+            for (int i = 0; i < 500; ++i)
+            {
+              {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                if (this->messages.size() >= _count)
+                  return true;
+              }
+              std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return false;
+          }
+
+  /// \brief Received messages.
+  public: std::vector<std::string> messages;
+
+  /// \brief Threads which received the messages.
+  public: std::vector<std::thread::id> threads;
+
+  /// \brief Protects the members above.
+  public: std::mutex mutex;
+};
+
+/////////////////////////////////////////////////
+/// \brief Create a queue around a raw callback helper.
+transport::SubscriptionQueuePtr MakeQueue(Recorder &_recorder,
+    transport::SubscriptionExecutorPtr _executor,
+    const transport::SubscribeOptions::QueuePolicy _policy,
+    const unsigned int _depth)
+{
+  transport::CallbackHelperPtr helper(new transport::RawCallbackHelper(
+        boost::bind(&Recorder::OnData, &_recorder, _1)));
+  return transport::SubscriptionQueuePtr(new transport::SubscriptionQueue(
+        helper, _executor, _policy, _depth));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SubscriptionQueueTest, KeepLatest)
+{
+  transport::SubscriptionExecutorPtr executor(
+      new transport::SubscriptionExecutor(0));
+  EXPECT_EQ(0u, executor->ThreadCount());
+
+  Recorder recorder;
+  transport::SubscriptionQueuePtr queue = MakeQueue(recorder, executor,
+      transport::SubscribeOptions::KEEP_LATEST, 3);
+  EXPECT_TRUE(queue->IsQueued());
+  EXPECT_TRUE(queue->IsLocal());
+  EXPECT_EQ("raw", queue->GetMsgType());
+
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(queue->HandleData(std::to_string(i), NULL, 0));
+
+  transport::SubscriptionQueueStats stats = queue->Stats();
+  EXPECT_EQ(3u, stats.depth);
+  EXPECT_EQ(3u, stats.maxDepth);
+  EXPECT_EQ(10u, stats.received);
+  EXPECT_EQ(0u, stats.delivered);
+  EXPECT_EQ(7u, stats.dropped);
+
+  // A single drain task was posted
+  EXPECT_EQ(1u, executor->Poll());
+  ASSERT_EQ(3u, recorder.messages.size());
+  EXPECT_EQ("7", recorder.messages[0]);
+  EXPECT_EQ("8", recorder.messages[1]);
+  EXPECT_EQ("9", recorder.messages[2]);
+  EXPECT_EQ(std::this_thread::get_id(), recorder.threads[0]);
+
+  stats = queue->Stats();
+  EXPECT_EQ(0u, stats.depth);
+  EXPECT_EQ(3u, stats.delivered);
+  EXPECT_EQ(0u, executor->Poll());
+}
+
+/////////////////////////////////////////////////
+TEST_F(SubscriptionQueueTest, KeepAll)
+{
+  transport::SubscriptionExecutorPtr executor(
+      new transport::SubscriptionExecutor(0));
+
+  Recorder recorder;
+  transport::SubscriptionQueuePtr queue = MakeQueue(recorder, executor,
+      transport::SubscribeOptions::KEEP_ALL, 1);
+
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(queue->HandleData(std::to_string(i), NULL, 0));
+  executor->Poll();
+
+  ASSERT_EQ(10u, recorder.messages.size());
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(std::to_string(i), recorder.messages[i]);
+  EXPECT_EQ(0u, queue->Stats().dropped);
+  EXPECT_EQ(10u, queue->Stats().maxDepth);
+
+  // Nothing is delivered once stopped
+  queue->Stop();
+  EXPECT_FALSE(queue->HandleData("late", NULL, 0));
+  executor->Poll();
+  EXPECT_EQ(10u, recorder.messages.size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(SubscriptionQueueTest, Dedicated)
+{
+  transport::SubscriptionExecutorPtr executor(
+      new transport::SubscriptionExecutor(1));
+  EXPECT_EQ(1u, executor->ThreadCount());
+
+  Recorder recorder;
+  transport::SubscriptionQueuePtr queue = MakeQueue(recorder, executor,
+      transport::SubscribeOptions::KEEP_ALL, 0);
+  executor.reset();
+
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(queue->HandleData(std::to_string(i), NULL, 0));
+  ASSERT_TRUE(recorder.Wait(100));
+
+  std::lock_guard<std::mutex> lock(recorder.mutex);
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(std::to_string(i), recorder.messages[i]);
+    EXPECT_NE(std::this_thread::get_id(), recorder.threads[i]);
+    EXPECT_EQ(recorder.threads[0], recorder.threads[i]);
+  }
+  EXPECT_EQ(100u, queue->Stats().delivered);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SubscriptionQueueTest, Pooled)
+{
+  transport::SubscriptionExecutorPtr pool =
+    transport::SubscriptionExecutor::Pool();
+  EXPECT_EQ(pool, transport::SubscriptionExecutor::Pool());
+  EXPECT_GE(pool->ThreadCount(), 2u);
+
+  // Messages of each queue stay in order across the pool threads
+  Recorder recorder1, recorder2;
+  transport::SubscriptionQueuePtr queue1 = MakeQueue(recorder1, pool,
+      transport::SubscribeOptions::KEEP_ALL, 0);
+  transport::SubscriptionQueuePtr queue2 = MakeQueue(recorder2, pool,
+      transport::SubscribeOptions::KEEP_ALL, 0);
+
+  for (int i = 0; i < 200; ++i)
+  {
+    queue1->HandleData(std::to_string(i), NULL, 0);
+    queue2->HandleData(std::to_string(i), NULL, 0);
+  }
+  ASSERT_TRUE(recorder1.Wait(200));
+  ASSERT_TRUE(recorder2.Wait(200));
+
+  for (int i = 0; i < 200; ++i)
+  {
+    EXPECT_EQ(std::to_string(i), recorder1.messages[i]);
+    EXPECT_EQ(std::to_string(i), recorder2.messages[i]);
+  }
+
+  queue1->Stop();
+  queue2->Stop();
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
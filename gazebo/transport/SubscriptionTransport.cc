@@ -16,7 +16,12 @@
 */
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include "gazebo/common/Console.hh"
 #include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/ShmRing.hh"
 #include "gazebo/transport/SubscriptionTransport.hh"
 
 using namespace gazebo;
@@ -24,14 +29,84 @@ using namespace transport;
 
 extern void dummy_callback_fn(uint32_t);
 
+/// \brief Default number of bytes queued for a subscriber.
+static const size_t kWriteQueueLimit = 16 * 1024 * 1024;
+
+/////////////////////////////////////////////////
+/// \brief Get the write queue limit from GAZEBO_WRITE_QUEUE_LIMIT.
+/// \return Number of bytes, 0 for no limit.
+static size_t writeQueueLimit()
+{
+  const char *env = std::getenv("GAZEBO_WRITE_QUEUE_LIMIT");
+  if (!env || std::string(env).empty())
+    return kWriteQueueLimit;
+
+  try
+  {
+    return static_cast<size_t>(std::stoull(env));
+  }
+  catch(...)
+  {
+    gzwarn << "Invalid GAZEBO_WRITE_QUEUE_LIMIT[" << env << "]\n";
+    return kWriteQueueLimit;
+  }
+}
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the SubscriptionTransport class.
+    class SubscriptionTransportPrivate
+    {
+      /// \brief State of the shared memory transport.
+      public: enum ShmState
+              {
+                /// \brief Not negotiated, or rejected.
+                DISABLED,
+
+                /// \brief Negotiated, no ring offered yet.
+                NONE,
+
+                /// \brief Ring offered, waiting for the subscriber.
+                PENDING,
+
+                /// \brief Ring mapped by the subscriber.
+                ACTIVE
+              };
+
+      /// \brief Shared memory state.
+      public: ShmState shmState = DISABLED;
+
+      /// \brief Channel of the publication.
+      public: std::shared_ptr<ShmChannel> shmChannel;
+
+      /// \brief Generation of the ring last offered to the subscriber.
+      public: uint32_t shmGeneration = 0;
+
+      /// \brief Protects the shared memory members.
+      public: mutable std::mutex shmMutex;
+    };
+  }
+}
+
 //////////////////////////////////////////////////
 SubscriptionTransport::SubscriptionTransport()
+  : dataPtr(new SubscriptionTransportPrivate)
 {
 }
 
 //////////////////////////////////////////////////
 SubscriptionTransport::~SubscriptionTransport()
 {
+  if (this->dataPtr->shmChannel)
+  {
+    this->dataPtr->shmChannel->RemoveReader(
+        this->dataPtr->shmState == SubscriptionTransportPrivate::ACTIVE ?
+        this->dataPtr->shmGeneration : 0);
+  }
+
   ConnectionManager::Instance()->RemoveConnection(this->connection);
   this->connection.reset();
 }
@@ -41,6 +116,9 @@ void SubscriptionTransport::Init(ConnectionPtr _conn, bool _latching)
 {
   this->connection = _conn;
   this->latching = _latching;
+
+  static const size_t limit = writeQueueLimit();
+  this->connection->SetWriteQueueLimit(limit);
 }
 
 //////////////////////////////////////////////////
@@ -54,11 +132,22 @@ bool SubscriptionTransport::HandleMessage(MessagePtr _newMsg)
 //////////////////////////////////////////////////
 bool SubscriptionTransport::HandleData(const std::string &_newdata,
     boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  return this->HandleData(_newdata, nullptr, _cb, _id);
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::HandleData(const std::string &_newdata,
+    const ShmNotice *_shared, boost::function<void(uint32_t)> _cb,
+    uint32_t _id)
 {
   bool result = false;
   if (this->connection->IsOpen())
   {
-    this->connection->EnqueueMsg(_newdata, _cb, _id);
+    if (!this->SendShared(_shared, _cb, _id))
+    {
+      this->connection->EnqueueDataMsg(_newdata, _cb, _id);
+    }
     result = true;
   }
   else
@@ -79,3 +168,97 @@ bool SubscriptionTransport::IsLocal() const
 {
   return false;
 }
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::EnableSharedMemory()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->shmMutex);
+  if (this->dataPtr->shmState == SubscriptionTransportPrivate::DISABLED)
+    this->dataPtr->shmState = SubscriptionTransportPrivate::NONE;
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::SharedMemoryEnabled() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->shmMutex);
+  return this->dataPtr->shmState != SubscriptionTransportPrivate::DISABLED;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::SetSharedMemoryChannel(
+    std::shared_ptr<ShmChannel> _channel)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->shmMutex);
+  if (this->dataPtr->shmState == SubscriptionTransportPrivate::DISABLED ||
+      this->dataPtr->shmChannel || !_channel)
+  {
+    return;
+  }
+
+  this->dataPtr->shmChannel = _channel;
+  this->dataPtr->shmChannel->AddReader();
+}
+
+//////////////////////////////////////////////////
+bool SubscriptionTransport::SendShared(const ShmNotice *_shared,
+    boost::function<void(uint32_t)> _cb, uint32_t _id)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->shmMutex);
+  if (!this->dataPtr->shmChannel)
+    return false;
+
+  // Offer a new ring once. This message and the following ones go over
+  // the connection until the subscriber has mapped it.
+  ShmNotice offer;
+  if (this->dataPtr->shmChannel->Offer(offer) &&
+      offer.generation != this->dataPtr->shmGeneration)
+  {
+    this->connection->EnqueueMsg(offer.Serialize());
+    this->dataPtr->shmGeneration = offer.generation;
+    this->dataPtr->shmState = SubscriptionTransportPrivate::PENDING;
+    return false;
+  }
+
+  if (!_shared ||
+      this->dataPtr->shmState != SubscriptionTransportPrivate::ACTIVE ||
+      _shared->generation != this->dataPtr->shmGeneration)
+  {
+    return false;
+  }
+
+  this->connection->EnqueueDataMsg(_shared->Serialize(), _cb, _id);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SubscriptionTransport::OnSharedMemoryNotice(const std::string &_data)
+{
+  ShmNotice notice;
+  if (!notice.Parse(_data))
+  {
+    gzwarn << "Ignoring unexpected data from a subscriber" << std::endl;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->shmMutex);
+
+  // Answers to a replaced ring don't matter anymore
+  if (notice.generation != this->dataPtr->shmGeneration ||
+      this->dataPtr->shmState != SubscriptionTransportPrivate::PENDING)
+  {
+    return;
+  }
+
+  if (notice.type == ShmNotice::ACK)
+  {
+    this->dataPtr->shmChannel->AddMapped(notice.generation);
+    this->dataPtr->shmState = SubscriptionTransportPrivate::ACTIVE;
+  }
+  else if (notice.type == ShmNotice::REJECT)
+  {
+    // The other readers shouldn't wait for this one
+    this->dataPtr->shmChannel->RemoveReader(0);
+    this->dataPtr->shmChannel.reset();
+    this->dataPtr->shmState = SubscriptionTransportPrivate::DISABLED;
+  }
+}
@@ -19,6 +19,7 @@
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <memory>
 #include <string>
 
 #include "Connection.hh"
@@ -29,6 +30,11 @@ namespace gazebo
 {
   namespace transport
   {
+    // Forward declare private data class.
+    class ShmChannel;
+    class ShmNotice;
+    class SubscriptionTransportPrivate;
+
     /// \addtogroup gazebo_transport
     /// \{
 
@@ -36,6 +42,12 @@ namespace gazebo
     /// transport/transport.hh
     /// \brief Handles sending data over the wire to
     /// remote subscribers
+    ///
+    /// \remarks
+    ///  Environment Variables:
+    ///   - GAZEBO_WRITE_QUEUE_LIMIT: Maximum number of bytes queued for a
+    /// remote subscriber. The oldest messages are dropped when a subscriber
+    /// doesn't keep up. Defaults to 16 MiB, 0 disables the limit.
     class GZ_TRANSPORT_VISIBLE SubscriptionTransport : public CallbackHelper
     {
       /// \brief Constructor
@@ -44,7 +56,8 @@ namespace gazebo
       /// \brief Destructor
       public: virtual ~SubscriptionTransport();
 
-      /// \brief Initialize the publication link
+      /// \brief Initialize the publication link, and limit the write queue
+      /// of the connection.
       /// \param[in] _conn The connection to use
       /// \param[in] _latching If true, latch the latest message; if false,
       /// don't latch
@@ -59,6 +72,19 @@ namespace gazebo
       public: virtual bool HandleData(const std::string &_newdata,
                   boost::function<void(uint32_t)> _cb, uint32_t _id);
 
+      /// \brief Output a message to a connection, or only its notice when
+      /// the message was written to the shared memory ring.
+      /// \param[in] _newdata The message to be handled
+      /// \param[in] _shared Notice of the message in the ring of the
+      /// shared memory channel, null if it wasn't written there.
+      /// \param[in] _cb If non-null, callback to be invoked after
+      /// transmission is complete.
+      /// \param[in] _id ID associated with the message data.
+      /// \return true if the message was handled successfully, false otherwise
+      public: bool HandleData(const std::string &_newdata,
+                  const ShmNotice *_shared,
+                  boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       // Documentation inherited
       public: virtual bool HandleMessage(MessagePtr _newMsg);
 
@@ -71,7 +97,43 @@ namespace gazebo
       /// is tied to a  remote connection
       public: virtual bool IsLocal() const;
 
+      /// \brief Send large messages through shared memory. Called when the
+      /// remote subscriber runs on the same host, before the subscription
+      /// is added to its publication.
+      public: void EnableSharedMemory();
+
+      /// \brief Is shared memory enabled?
+      /// \return True if the subscriber runs on the same host, and didn't
+      /// reject a ring.
+      public: bool SharedMemoryEnabled() const;
+
+      /// \brief Set the channel of the publication, whose ring is shared
+      /// by all of its subscribers on this host. Its ring is offered to the
+      /// subscriber, and used once the subscriber acknowledged it; until
+      /// then messages go over the connection.
+      /// \param[in] _channel Channel of the publication.
+      public: void SetSharedMemoryChannel(
+                  std::shared_ptr<ShmChannel> _channel);
+
+      /// \brief Handle a notice sent back by the remote subscriber.
+      /// \param[in] _data Data read from the connection.
+      public: void OnSharedMemoryNotice(const std::string &_data);
+
+      /// \brief Offer the ring of the channel to the subscriber, or send the
+      /// notice of a message written to it.
+      /// \param[in] _shared Notice of the message, null if it wasn't
+      /// written to the ring.
+      /// \param[in] _cb Callback invoked after the notice was sent.
+      /// \param[in] _id ID associated with the message data.
+      /// \return False if the message must go over the connection.
+      private: bool SendShared(const ShmNotice *_shared,
+                   boost::function<void(uint32_t)> _cb, uint32_t _id);
+
       private: ConnectionPtr connection;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SubscriptionTransportPrivate> dataPtr;
     };
     /// \}
   }
@@ -18,6 +18,7 @@
 #include <tbb/blocked_range.h>
 
 #include <boost/function.hpp>
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publication.hh"
@@ -152,6 +153,8 @@ void TopicManager::AddNodeToProcess(NodePtr _ptr)
 //////////////////////////////////////////////////
 void TopicManager::ProcessNodes(bool _onlyOut)
 {
+  GZ_PROFILE_SCOPE("TopicManager::ProcessNodes");
+
   {
     boost::mutex::scoped_lock lock(this->processNodesMutex);
     for (boost::unordered_set<NodePtr>::iterator iter =
@@ -452,4 +455,8 @@ void TopicManager::ClearBuffers()
 void TopicManager::PauseIncoming(bool _pause)
 {
   this->pauseIncoming = _pause;
+
+  // Deliver the messages held while paused
+  if (!_pause)
+    ConnectionManager::Instance()->TriggerUpdate();
 }
@@ -25,6 +25,7 @@
 #include "gazebo/transport/Subscriber.hh"
 #include "gazebo/transport/ConnectionManager.hh"
 #include "gazebo/transport/TransportIface.hh"
+#include "gazebo/transport/TransportStatistics.hh"
 
 using namespace gazebo;
 
@@ -111,6 +112,7 @@ void transport::run()
   g_stopped = false;
   g_runThread = new boost::thread(&transport::ConnectionManager::Run,
                                 transport::ConnectionManager::Instance());
+  transport::TransportStatistics::Instance()->Start();
 }
 
 /////////////////////////////////////////////////
@@ -125,6 +127,7 @@ void transport::stop()
   g_stopped = true;
   g_responseCondition.notify_all();
 
+  transport::TransportStatistics::Instance()->Stop();
   transport::ConnectionManager::Instance()->Stop();
 }
 
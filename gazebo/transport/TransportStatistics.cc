@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gazebo/common/Time.hh"
+#include "gazebo/transport/Connection.hh"
+#include "gazebo/transport/ConnectionManager.hh"
+#include "gazebo/transport/Node.hh"
+#include "gazebo/transport/TopicManager.hh"
+#include "gazebo/transport/TransportStatistics.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Private data for the TransportStatistics class.
+    class TransportStatisticsPrivate
+    {
+      /// \brief Statistics of the topics, by name.
+      public: std::map<std::string, TopicStatisticsPtr> topics;
+
+      /// \brief Thread publishing the statistics.
+      public: std::thread thread;
+
+      /// \brief True when the thread should stop.
+      public: bool stop = false;
+
+      /// \brief Protects the members above.
+      public: std::mutex mutex;
+
+      /// \brief Signaled when stopping.
+      public: std::condition_variable condition;
+    };
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Copy the statistics of a profiler zone into a message.
+/// \param[in] _stats Statistics of the zone.
+/// \param[in] _stage Name of the stage.
+/// \param[out] _msg Message to fill.
+static void fillLatency(const common::ProfileZoneStats &_stats,
+    const std::string &_stage, msgs::TransportStatistics::Latency *_msg)
+{
+  _msg->set_stage(_stage);
+  _msg->set_count(_stats.count);
+  _msg->set_mean(_stats.mean);
+  _msg->set_p50(_stats.p50);
+  _msg->set_p99(_stats.p99);
+  _msg->set_max(_stats.max);
+}
+
+//////////////////////////////////////////////////
+TopicStatistics::TopicStatistics(const std::string &_topic)
+  : topic(_topic), published(0), dropped(0), sent(0), received(0),
+    receivedBytes(0), dispatched(0),
+    publishQueueZone(common::Profiler::Instance()->RegisterZone(
+          "transport/topic" + _topic + "/publish_queue")),
+    incomingQueueZone(common::Profiler::Instance()->RegisterZone(
+          "transport/topic" + _topic + "/incoming_queue")),
+    callbackZone(common::Profiler::Instance()->RegisterZone(
+          "transport/topic" + _topic + "/callback"))
+{
+}
+
+//////////////////////////////////////////////////
+TransportStatistics::TransportStatistics()
+  : dataPtr(new TransportStatisticsPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TransportStatistics::~TransportStatistics()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+TopicStatisticsPtr TransportStatistics::Topic(const std::string &_topic)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  TopicStatisticsPtr &stats = this->dataPtr->topics[_topic];
+  if (!stats)
+    stats.reset(new TopicStatistics(_topic));
+  return stats;
+}
+
+//////////////////////////////////////////////////
+void TransportStatistics::Fill(msgs::TransportStatistics &_msg)
+{
+  std::vector<TopicStatisticsPtr> topics;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (auto const &topic : this->dataPtr->topics)
+      topics.push_back(topic.second);
+  }
+
+  // Latencies of all the zones with samples
+  auto profiler = common::Profiler::Instance();
+  std::map<std::string, common::ProfileZoneStats> zones;
+  for (auto const &zone : profiler->Stats())
+    zones[zone.name] = zone;
+
+  auto latency = [&](const common::ProfileZoneId _zone,
+      const std::string &_stage,
+      google::protobuf::RepeatedPtrField<msgs::TransportStatistics::Latency>
+      *_latencies)
+  {
+    auto iter = zones.find(profiler->ZoneName(_zone));
+    if (iter != zones.end())
+      fillLatency(iter->second, _stage, _latencies->Add());
+  };
+
+  _msg.set_process(ConnectionManager::Instance()->ServerAddress());
+  msgs::Set(_msg.mutable_real_time(), common::Time::GetWallTime());
+
+  for (auto const &stats : topics)
+  {
+    auto topicMsg = _msg.add_topic();
+    topicMsg->set_name(stats->topic);
+    topicMsg->set_published(stats->published);
+    topicMsg->set_dropped(stats->dropped);
+    topicMsg->set_sent(stats->sent);
+    topicMsg->set_received(stats->received);
+    topicMsg->set_received_bytes(stats->receivedBytes);
+    topicMsg->set_dispatched(stats->dispatched);
+    latency(stats->publishQueueZone, "publish_queue",
+        topicMsg->mutable_latency());
+    latency(stats->incomingQueueZone, "incoming_queue",
+        topicMsg->mutable_latency());
+    latency(stats->callbackZone, "callback", topicMsg->mutable_latency());
+  }
+
+  for (auto const &conn : ConnectionManager::Instance()->Connections())
+  {
+    ConnectionStatistics stats = conn->Statistics();
+    auto connMsg = _msg.add_connection();
+    connMsg->set_remote(stats.remote);
+    connMsg->set_written(stats.written);
+    connMsg->set_written_bytes(stats.writtenBytes);
+    connMsg->set_read(stats.read);
+    connMsg->set_read_bytes(stats.readBytes);
+    connMsg->set_dropped(stats.dropped);
+    connMsg->set_queued_bytes(stats.queuedBytes);
+
+    if (stats.written > 0)
+    {
+      auto iter = zones.find(profiler->ZoneName(stats.writeQueueZone));
+      if (iter != zones.end())
+      {
+        fillLatency(iter->second, "write_queue",
+            connMsg->mutable_write_queue());
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void TransportStatistics::Start()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->thread.joinable())
+    return;
+
+  this->dataPtr->stop = false;
+  this->dataPtr->thread = std::thread(&TransportStatistics::Run, this);
+}
+
+//////////////////////////////////////////////////
+void TransportStatistics::Stop()
+{
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+    thread.swap(this->dataPtr->thread);
+  }
+  this->dataPtr->condition.notify_all();
+
+  if (thread.joinable())
+    thread.join();
+}
+
+//////////////////////////////////////////////////
+void TransportStatistics::Run()
+{
+  NodePtr node(new Node());
+  PublisherPtr pub;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  while (!this->dataPtr->stop)
+  {
+    this->dataPtr->condition.wait_for(lock, std::chrono::seconds(1));
+    if (this->dataPtr->stop)
+      break;
+    lock.unlock();
+
+    // Join the namespace of the world once there is one, rather than
+    // registering a namespace of our own
+    if (!pub)
+    {
+      std::list<std::string> namespaces;
+      TopicManager::Instance()->GetTopicNamespaces(namespaces);
+      if (!namespaces.empty())
+      {
+        node->Init();
+        pub = node->Advertise<msgs::TransportStatistics>(
+            "~/transport/statistics");
+      }
+    }
+
+    if (pub && pub->HasConnections())
+    {
+      msgs::TransportStatistics msg;
+      this->Fill(msg);
+      pub->Publish(msg);
+    }
+
+    lock.lock();
+  }
+  lock.unlock();
+
+  pub.reset();
+  node->Fini();
+}
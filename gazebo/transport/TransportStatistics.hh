@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_TRANSPORTSTATISTICS_HH_
+#define GAZEBO_TRANSPORT_TRANSPORTSTATISTICS_HH_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gazebo/common/Profiler.hh"
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/TransportTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    class TransportStatistics;
+  }
+}
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_TRANSPORT_VISIBLE, gazebo, transport,
+    TransportStatistics)
+
+namespace gazebo
+{
+  namespace transport
+  {
+    // Forward declare private data class.
+    class TransportStatisticsPrivate;
+
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class TopicStatistics TransportStatistics.hh transport/transport.hh
+    /// \brief Counters of a topic in this process, shared by its publishers
+    /// and by the nodes subscribed to it. The time spent by messages in
+    /// each stage is recorded in the profiler zones.
+    class GZ_TRANSPORT_VISIBLE TopicStatistics
+    {
+      /// \brief Constructor. Registers the profiler zones of the topic.
+      /// \param[in] _topic Fully qualified name of the topic.
+      public: explicit TopicStatistics(const std::string &_topic);
+
+      /// \brief Name of the topic.
+      public: const std::string topic;
+
+      /// \brief Messages passed to Publisher::Publish.
+      public: std::atomic<uint64_t> published;
+
+      /// \brief Messages dropped because a publisher queue was full.
+      public: std::atomic<uint64_t> dropped;
+
+      /// \brief Messages taken from the publisher queues and sent to the
+      /// subscribers.
+      public: std::atomic<uint64_t> sent;
+
+      /// \brief Messages received by the subscribed nodes.
+      public: std::atomic<uint64_t> received;
+
+      /// \brief Bytes of the serialized messages received by the nodes.
+      /// Messages published in this process aren't serialized.
+      public: std::atomic<uint64_t> receivedBytes;
+
+      /// \brief Messages passed to the subscriber callbacks.
+      public: std::atomic<uint64_t> dispatched;
+
+      /// \brief Time between Publisher::Publish and the message being sent.
+      public: const common::ProfileZoneId publishQueueZone;
+
+      /// \brief Time between a node receiving a message and the message
+      /// being passed to the callbacks.
+      public: const common::ProfileZoneId incomingQueueZone;
+
+      /// \brief Time spent in the callbacks run by the transport thread.
+      public: const common::ProfileZoneId callbackZone;
+    };
+
+    /// \class TransportStatistics TransportStatistics.hh
+    /// transport/transport.hh
+    /// \brief Collects the statistics of the topics and connections of this
+    /// process, and publishes them on ~/transport/statistics once per
+    /// second while someone is subscribed.
+    /// \sa gz topic --stats
+    class GZ_TRANSPORT_VISIBLE TransportStatistics
+      : public SingletonT<TransportStatistics>
+    {
+      /// \brief Constructor.
+      private: TransportStatistics();
+
+      /// \brief Destructor.
+      private: virtual ~TransportStatistics();
+
+      /// \brief Get the statistics of a topic, created on first use.
+      /// \param[in] _topic Fully qualified name of the topic.
+      /// \return Statistics of the topic.
+      public: TopicStatisticsPtr Topic(const std::string &_topic);
+
+      /// \brief Fill a message with the statistics of all topics and
+      /// connections.
+      /// \param[out] _msg Message to fill.
+      public: void Fill(msgs::TransportStatistics &_msg);
+
+      /// \brief Start publishing the statistics.
+      public: void Start();
+
+      /// \brief Stop publishing the statistics.
+      public: void Stop();
+
+      /// \brief Publish the statistics until stopped. Run by a thread.
+      private: void Run();
+
+      // Singleton implementation
+      private: friend class SingletonT<TransportStatistics>;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TransportStatisticsPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "gazebo/transport/TransportStatistics.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TransportStatisticsTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TransportStatisticsTest, Topic)
+{
+  auto statistics = transport::TransportStatistics::Instance();
+
+  // Publishers and nodes of a topic share its counters
+  transport::TopicStatisticsPtr stats =
+    statistics->Topic("/gazebo/default/stats_test");
+  ASSERT_TRUE(stats != NULL);
+  EXPECT_EQ(stats, statistics->Topic("/gazebo/default/stats_test"));
+  EXPECT_NE(stats, statistics->Topic("/gazebo/default/other"));
+  EXPECT_EQ("/gazebo/default/stats_test", stats->topic);
+  EXPECT_EQ(0u, stats->published);
+  EXPECT_EQ(0u, stats->received);
+
+  stats->published += 3;
+  stats->dropped++;
+  stats->received += 2;
+  stats->receivedBytes += 100;
+
+  // Latency samples of the publisher queue
+  auto profiler = common::Profiler::Instance();
+  uint64_t start = common::Profiler::Ticks();
+  profiler->Record(stats->publishQueueZone, start, start + 1000);
+  profiler->Record(stats->publishQueueZone, start, start + 2000);
+
+  msgs::TransportStatistics msg;
+  statistics->Fill(msg);
+  EXPECT_EQ(0, msg.connection_size());
+
+  const msgs::TransportStatistics::Topic *topicMsg = NULL;
+  for (auto const &topic : msg.topic())
+  {
+    if (topic.name() == "/gazebo/default/stats_test")
+      topicMsg = &topic;
+  }
+  ASSERT_TRUE(topicMsg != NULL);
+  EXPECT_EQ(3u, topicMsg->published());
+  EXPECT_EQ(1u, topicMsg->dropped());
+  EXPECT_EQ(2u, topicMsg->received());
+  EXPECT_EQ(100u, topicMsg->received_bytes());
+  EXPECT_EQ(0u, topicMsg->dispatched());
+
+  // Only the stages with samples are reported
+  ASSERT_EQ(1, topicMsg->latency_size());
+  EXPECT_EQ("publish_queue", topicMsg->latency(0).stage());
+  EXPECT_EQ(2u, topicMsg->latency(0).count());
+  EXPECT_GT(topicMsg->latency(0).max(), 0.0);
+  EXPECT_LE(topicMsg->latency(0).p50(), topicMsg->latency(0).max());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -38,6 +38,9 @@ namespace gazebo
     class PublicationTransport;
     class Subscriber;
     class SubscriptionTransport;
+    class SubscriptionExecutor;
+    class SubscriptionQueue;
+    class TopicStatistics;
     class Node;
 
     /// \def MessagePtr
@@ -67,6 +70,18 @@ namespace gazebo
     /// \def SubscriptionTransportPtr
     /// \brief Shared_ptr to SubscriptionTransportPtr
     typedef boost::shared_ptr<SubscriptionTransport> SubscriptionTransportPtr;
+
+    /// \def SubscriptionExecutorPtr
+    /// \brief Shared_ptr to SubscriptionExecutor
+    typedef boost::shared_ptr<SubscriptionExecutor> SubscriptionExecutorPtr;
+
+    /// \def SubscriptionQueuePtr
+    /// \brief Shared_ptr to SubscriptionQueue
+    typedef boost::shared_ptr<SubscriptionQueue> SubscriptionQueuePtr;
+
+    /// \def TopicStatisticsPtr
+    /// \brief Shared_ptr to TopicStatistics
+    typedef boost::shared_ptr<TopicStatistics> TopicStatisticsPtr;
   }
 }
 #endif
@@ -20,6 +20,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/common/Profiler.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/transport/transport.hh"
 #include "gazebo/util/DiagnosticsPrivate.hh"
@@ -72,9 +73,15 @@ void DiagnosticManager::Fini()
 {
   this->dataPtr->updateConnection.reset();
 
+  // Export the profiler statistics of the whole run if requested.
+  const char *profilerLog = common::getEnv("GAZEBO_PROFILER_LOG");
+  if (this->dataPtr->node && profilerLog && std::string(profilerLog) != "")
+    common::Profiler::Instance()->WriteReport(profilerLog);
+
   this->dataPtr->timers.clear();
 
   this->dataPtr->pub.reset();
+  this->dataPtr->profilerPub.reset();
   if (this->dataPtr->node)
     this->dataPtr->node->Fini();
   this->dataPtr->node.reset();
@@ -90,6 +97,9 @@ void DiagnosticManager::Init(const std::string &_worldName)
   this->dataPtr->pub =
     this->dataPtr->node->Advertise<msgs::Diagnostics>("~/diagnostics");
 
+  this->dataPtr->profilerPub =
+    this->dataPtr->node->Advertise<msgs::ProfilerStatistics>("~/profiler");
+
   this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
       std::bind(&DiagnosticManager::Update, this, std::placeholders::_1));
 }
@@ -120,6 +130,39 @@ void DiagnosticManager::Update(const common::UpdateInfo &_info)
     this->dataPtr->pub->Publish(this->dataPtr->msg);
 
   this->dataPtr->msg.clear_time();
+
+  // Drain the profiler buffers every step so they don't fill up, and
+  // publish the statistics of the last window once per second.
+  auto profiler = common::Profiler::Instance();
+  profiler->Collect();
+
+  common::Time wallTime = common::Time::GetWallTime();
+  if (wallTime - this->dataPtr->lastProfilerPubTime < common::Time(1.0))
+    return;
+  this->dataPtr->lastProfilerPubTime = wallTime;
+
+  auto stats = profiler->WindowStats();
+  if (!this->dataPtr->profilerPub ||
+      !this->dataPtr->profilerPub->HasConnections())
+  {
+    return;
+  }
+
+  msgs::ProfilerStatistics profilerMsg;
+  msgs::Set(profilerMsg.mutable_sim_time(), _info.simTime);
+  msgs::Set(profilerMsg.mutable_real_time(), _info.realTime);
+  profilerMsg.set_dropped(profiler->Dropped());
+  for (auto const &zone : stats)
+  {
+    auto zoneMsg = profilerMsg.add_zone();
+    zoneMsg->set_name(zone.name);
+    zoneMsg->set_count(zone.count);
+    zoneMsg->set_mean(zone.mean);
+    zoneMsg->set_p50(zone.p50);
+    zoneMsg->set_p99(zone.p99);
+    zoneMsg->set_max(zone.max);
+  }
+  this->dataPtr->profilerPub->Publish(profilerMsg);
 }
 
 //////////////////////////////////////////////////
@@ -51,6 +51,12 @@ namespace gazebo
       /// \brief The message to output
       public: msgs::Diagnostics msg;
 
+      /// \brief Publisher of profiler statistics.
+      public: transport::PublisherPtr profilerPub;
+
+      /// \brief Wall time of the last profiler statistics publication.
+      public: common::Time lastProfilerPubTime;
+
       /// \brief Pointer to the update event connection
       public: event::ConnectionPtr updateConnection;
     };
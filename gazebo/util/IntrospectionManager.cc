@@ -14,6 +14,7 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
 #include <functional>
 #include <set>
 #include <string>
@@ -104,14 +105,39 @@ bool IntrospectionManager::Register(const std::string &_item,
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Sanity check: Make sure that nobody has registered the same item before.
-  if (this->dataPtr->allItems.find(_item) != this->dataPtr->allItems.end())
+  if (this->dataPtr->itemIndex.find(_item) != this->dataPtr->itemIndex.end())
   {
     gzwarn << "Item [" << _item << "] already registered" << std::endl;
     return false;
   }
 
-  this->dataPtr->allItemsKeys.insert(_item);
-  this->dataPtr->allItems[_item] = _cb;
+  // Reuse a free entry of the table if there's one.
+  size_t index;
+  if (!this->dataPtr->freeItems.empty())
+  {
+    index = this->dataPtr->freeItems.back();
+    this->dataPtr->freeItems.pop_back();
+  }
+  else
+  {
+    index = this->dataPtr->items.size();
+    this->dataPtr->items.emplace_back();
+  }
+
+  auto &entry = this->dataPtr->items[index];
+  entry.name = _item;
+  entry.cb = std::make_shared<const IntrospectionItemCallback>(_cb);
+  this->dataPtr->itemIndex[_item] = index;
+
+  // Filters may be waiting for this item already.
+  for (auto const &filter : this->dataPtr->filters)
+  {
+    if (filter.second.items.count(_item) > 0)
+    {
+      this->RebuildSnapshot();
+      break;
+    }
+  }
 
   this->dataPtr->itemsUpdated = true;
 
@@ -124,15 +150,28 @@ bool IntrospectionManager::Unregister(const std::string &_item)
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Sanity check: Make sure that the item has been previously registered.
-  if (this->dataPtr->allItems.find(_item) == this->dataPtr->allItems.end())
+  auto indexIter = this->dataPtr->itemIndex.find(_item);
+  if (indexIter == this->dataPtr->itemIndex.end())
   {
     gzwarn << "Item [" << _item << "] is not registered" << std::endl;
     return false;
   }
 
-  // Remove the item from the list of all items.
-  this->dataPtr->allItemsKeys.erase(_item);
-  this->dataPtr->allItems.erase(_item);
+  // Free the entry of the table. The callback stays alive as long as the
+  // current snapshot references it.
+  auto &entry = this->dataPtr->items[indexIter->second];
+  entry.name.clear();
+  entry.cb.reset();
+  this->dataPtr->freeItems.push_back(indexIter->second);
+  this->dataPtr->itemIndex.erase(indexIter);
+
+  // Stop sampling the item if someone was observing it.
+  auto snapshot = std::atomic_load(&this->dataPtr->snapshot);
+  if (snapshot && std::find(snapshot->names.begin(), snapshot->names.end(),
+        _item) != snapshot->names.end())
+  {
+    this->RebuildSnapshot();
+  }
 
   this->dataPtr->itemsUpdated = true;
 
@@ -143,8 +182,10 @@ bool IntrospectionManager::Unregister(const std::string &_item)
 void IntrospectionManager::Clear()
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-  this->dataPtr->allItemsKeys.clear();
-  this->dataPtr->allItems.clear();
+  this->dataPtr->items.clear();
+  this->dataPtr->itemIndex.clear();
+  this->dataPtr->freeItems.clear();
+  this->RebuildSnapshot();
   this->dataPtr->itemsUpdated = true;
 }
 
@@ -155,7 +196,8 @@ std::set<std::string> IntrospectionManager::Items() const
 
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-    items = this->dataPtr->allItemsKeys;
+    for (auto const &item : this->dataPtr->itemIndex)
+      items.insert(items.end(), item.first);
   }
 
   return items;
@@ -164,136 +206,207 @@ std::set<std::string> IntrospectionManager::Items() const
 //////////////////////////////////////////////////
 void IntrospectionManager::Update()
 {
-  std::map<std::string, IntrospectionFilter> filtersCopy;
-  std::map<std::string, ObservedItem> observedItemsCopy;
-  std::map<std::string, std::function <gazebo::msgs::Any ()>> usedItemsCopy;
-
+  // The snapshot is only replaced, never modified, while we hold it. When
+  // nobody is observing any item there's nothing to sample.
+  auto snapshot = std::atomic_load(&this->dataPtr->snapshot);
+  if (snapshot)
   {
-    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-
-    filtersCopy = this->dataPtr->filters;
-    observedItemsCopy = this->dataPtr->observedItems;
+    const uint64_t head = snapshot->head.load(std::memory_order_relaxed);
+    const uint64_t tail = snapshot->tail.load(std::memory_order_acquire);
 
-    for (const auto &observedItem: this->dataPtr->observedItems)
+    if (head - tail >= snapshot->ring.size())
     {
-      auto &item = observedItem.first;
-      // Sanity check: Make sure that someone registered this item.
-      if (this->dataPtr->allItemsKeys.count(item) == 0)
-      {
-        continue;
-      }
-
-      usedItemsCopy[item] = this->dataPtr->allItems[item];
+      // The consumer is behind, drop this sample.
+      snapshot->dropped.fetch_add(1, std::memory_order_relaxed);
     }
-
-    for (auto& filter: filtersCopy)
+    else
     {
-      for (auto const &item : filter.second.items)
+      auto &sample = snapshot->ring[head % snapshot->ring.size()];
+      for (size_t i = 0; i < snapshot->callbacks.size(); ++i)
       {
-        // Sanity check: Make sure that someone registered this item.
-        if (this->dataPtr->allItemsKeys.count(item) == 0)
+        try
         {
-          continue;
+          // Update the values of the items under observation.
+          sample[i].CopyFrom((*snapshot->callbacks[i])());
+        }
+        catch(...)
+        {
+          gzerr << "Exception caught calling user callback" << std::endl;
+          // Mark the value as not updated.
+          sample[i].Clear();
+          sample[i].set_type(gazebo::msgs::Any::NONE);
         }
-        usedItemsCopy[item] = this->dataPtr->allItems[item];
       }
+      snapshot->head.store(head + 1, std::memory_order_release);
     }
   }
 
-  for (auto &observedItem : observedItemsCopy)
-  {
-    auto &item = observedItem.first;
-    auto itemIter = usedItemsCopy.find(item);
+  this->NotifyUpdates();
+}
 
-    // Sanity check: Make sure that we can update the item.
-    if (itemIter == usedItemsCopy.end())
-      continue;
+//////////////////////////////////////////////////
+void IntrospectionManager::NotifyUpdates()
+{
+  if (this->dataPtr->itemsUpdated.exchange(false))
+  {
+    gazebo::msgs::Empty req;
+    gazebo::msgs::Param_V currentItems;
+    // Prepare the list of items to be sent.
+    this->Items(req, currentItems);
 
-    try
-    {
-      // Update the values of the items under observation.
-      gazebo::msgs::Any value = itemIter->second();
-      auto &lastValue = observedItem.second.lastValue;
-      lastValue.CopyFrom(value);
-    }
-    catch(...)
+    if (!this->dataPtr->itemsUpdatePub.Publish(currentItems))
     {
-      gzerr << "Exception caught calling user callback" << std::endl;
-      continue;
+      gzerr << "Failed to publish items on topic[/introspection/" <<
+        this->dataPtr->managerId << "/items_update]" << std::endl;
     }
   }
 
-  // Prepare the next message to be sent in each filter.
-  for (auto &filter : filtersCopy)
+  auto snapshot = std::atomic_load(&this->dataPtr->snapshot);
+  if (!snapshot)
+    return;
+
+  uint64_t tail = snapshot->tail.load(std::memory_order_relaxed);
+  const uint64_t head = snapshot->head.load(std::memory_order_acquire);
+  if (head == tail)
+    return;
+
+  // Only one thread drains the ring, the others leave their samples to it.
+  std::unique_lock<std::mutex> drainLock(this->dataPtr->drainMutex,
+      std::try_to_lock);
+  if (!drainLock.owns_lock())
+    return;
+
+  // Throttle publications.
+  const double rate = this->dataPtr->notifyRate;
+  common::Time now = common::Time::GetWallTime();
+  if (rate > 0 &&
+      (now - this->dataPtr->lastNotifyTime).Double() < 1.0 / rate)
   {
-    // First of all, clear the old message.
-    auto &nextMsg = filter.second.msg;
-    nextMsg.Clear();
+    return;
+  }
+  this->dataPtr->lastNotifyTime = now;
 
-    // Insert the last value of each item under observation for this filter.
-    for (auto const &item : filter.second.items)
-    {
-      // Sanity check: Make sure that someone registered this item.
-      if (usedItemsCopy.find(item) == usedItemsCopy.end())
-        continue;
+  // Publish each pending sample.
+  for (; tail != head; ++tail)
+  {
+    const auto &sample = snapshot->ring[tail % snapshot->ring.size()];
 
-      // Sanity check: Make sure that the value was updated.
-      // (e.g.: an exception was not raised).
-      auto &lastValue = observedItemsCopy[item].lastValue;
-      if (lastValue.type() == gazebo::msgs::Any::NONE)
-        continue;
+    for (auto &filter : snapshot->filters)
+    {
+      // First of all, clear the old message.
+      auto &nextMsg = filter.msg;
+      nextMsg.Clear();
 
-      auto nextParam = nextMsg.add_param();
-      nextParam->set_name(item);
-      nextParam->mutable_value()->CopyFrom(lastValue);
-    }
+      // Insert the sampled value of each item under observation for this
+      // filter.
+      for (auto const pos : filter.positions)
+      {
+        // Sanity check: Make sure that the value was updated.
+        // (e.g.: an exception was not raised).
+        if (sample[pos].type() == gazebo::msgs::Any::NONE)
+          continue;
 
-    // Sanity check: Make sure that we have at least one item updated.
-    if (nextMsg.param_size() == 0)
-      continue;
+        auto nextParam = nextMsg.add_param();
+        nextParam->set_name(snapshot->names[pos]);
+        nextParam->mutable_value()->CopyFrom(sample[pos]);
+      }
 
-    // Publish the update for this filter.
-    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
+      // Sanity check: Make sure that we have at least one item updated.
+      if (nextMsg.param_size() == 0)
+        continue;
 
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-      if (this->dataPtr->filterPubs.find(topicName) ==
-          this->dataPtr->filterPubs.end() ||
-          !this->dataPtr->filterPubs[topicName].Publish(nextMsg))
+      // Publish the update for this filter.
+      if (!filter.pub.Publish(nextMsg))
       {
-        gzerr << "Error publishing update for topic [" << topicName << "]"
+        gzerr << "Error publishing update for topic [" << filter.topic << "]"
           << std::endl;
       }
     }
+
+    // Hand the slot back to the producer.
+    snapshot->tail.store(tail + 1, std::memory_order_release);
   }
+}
 
-  this->NotifyUpdates();
+//////////////////////////////////////////////////
+void IntrospectionManager::SetNotifyRate(const double _hz)
+{
+  this->dataPtr->notifyRate = std::max(0.0, _hz);
 }
 
 //////////////////////////////////////////////////
-void IntrospectionManager::NotifyUpdates()
+double IntrospectionManager::NotifyRate() const
 {
-  bool itemsUpdatedCopy;
+  return this->dataPtr->notifyRate;
+}
 
+//////////////////////////////////////////////////
+uint64_t IntrospectionManager::DroppedSamples() const
+{
+  auto snapshot = std::atomic_load(&this->dataPtr->snapshot);
+  if (!snapshot)
+    return 0u;
+  return snapshot->dropped;
+}
+
+//////////////////////////////////////////////////
+void IntrospectionManager::RebuildSnapshot()
+{
+  auto snapshot = std::make_shared<IntrospectionSnapshot>();
+
+  // Collect the registered items observed by at least one filter.
+  std::map<std::string, size_t> positions;
+  for (auto const &filter : this->dataPtr->filters)
   {
-    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-    itemsUpdatedCopy = this->dataPtr->itemsUpdated;
-    this->dataPtr->itemsUpdated = false;
+    for (auto const &item : filter.second.items)
+    {
+      // Sanity check: Make sure that someone registered this item.
+      auto indexIter = this->dataPtr->itemIndex.find(item);
+      if (indexIter == this->dataPtr->itemIndex.end())
+        continue;
+
+      if (positions.find(item) == positions.end())
+      {
+        positions[item] = snapshot->names.size();
+        snapshot->names.push_back(item);
+        snapshot->callbacks.push_back(
+            this->dataPtr->items[indexIter->second].cb);
+      }
+    }
   }
 
-  if (itemsUpdatedCopy)
+  if (snapshot->names.empty())
   {
-    gazebo::msgs::Empty req;
-    gazebo::msgs::Param_V currentItems;
-    // Prepare the list of items to be sent.
-    this->Items(req, currentItems);
+    std::atomic_store(&this->dataPtr->snapshot,
+        std::shared_ptr<IntrospectionSnapshot>());
+    return;
+  }
 
-    if (!this->dataPtr->itemsUpdatePub.Publish(currentItems))
+  for (auto const &filter : this->dataPtr->filters)
+  {
+    std::string topicName = this->dataPtr->prefix + "filter/" + filter.first;
+    auto pubIter = this->dataPtr->filterPubs.find(topicName);
+    if (pubIter == this->dataPtr->filterPubs.end())
+      continue;
+
+    IntrospectionSnapshotFilter snapshotFilter;
+    snapshotFilter.pub = pubIter->second;
+    snapshotFilter.topic = topicName;
+    for (auto const &item : filter.second.items)
     {
-      gzerr << "Failed to publish items on topic[/introspection/" <<
-        this->dataPtr->managerId << "/items_update]" << std::endl;
+      auto posIter = positions.find(item);
+      if (posIter != positions.end())
+        snapshotFilter.positions.push_back(posIter->second);
     }
+    snapshot->filters.push_back(snapshotFilter);
   }
+
+  // Preallocate the ring, so the update path doesn't allocate.
+  snapshot->ring.resize(IntrospectionSnapshot::kRingSize);
+  for (auto &sample : snapshot->ring)
+    sample.resize(snapshot->names.size());
+
+  std::atomic_store(&this->dataPtr->snapshot, snapshot);
 }
 
 //////////////////////////////////////////////////
@@ -332,9 +445,8 @@ bool IntrospectionManager::NewFilterImpl(const std::set<std::string> &_newItems,
   // Add the items to the new filter.
   this->dataPtr->filters[_filterId].items = _newItems;
 
-  // Register the new filter in the list of observed items.
-  for (auto const &item : _newItems)
-    this->dataPtr->observedItems[item].filters.emplace(_filterId);
+  // Start sampling the new items.
+  this->RebuildSnapshot();
 
   return true;
 }
@@ -361,37 +473,10 @@ bool IntrospectionManager::UpdateFilterImpl(const std::string &_filterId,
     return false;
   }
 
-  // Save the old list of items.
-  auto oldItems = this->dataPtr->filters.at(_filterId).items;
-
   // Update the list of items for this filter.
   this->dataPtr->filters[_filterId].items = _newItems;
 
-  // The next block is needed for updating the 'observedItems' data structure
-  // that contains references to the filters.
-  {
-    // We need to ensure that the items that were part of the old filter but are
-    // not in the new filter are removed.
-    for (auto const &oldItem : oldItems)
-    {
-      if (_newItems.find(oldItem) == _newItems.end())
-      {
-        auto &filters = this->dataPtr->observedItems[oldItem].filters;
-        filters.erase(_filterId);
-
-        // If there is nobody interested in this item, remove it.
-        if (filters.empty())
-          this->dataPtr->observedItems.erase(oldItem);
-      }
-    }
-
-    // We need to add the new items that were not part of the old filter.
-    for (auto const &newItem : _newItems)
-    {
-      if (oldItems.find(newItem) == oldItems.end())
-        this->dataPtr->observedItems[newItem].filters.emplace(_filterId);
-    }
-  }
+  this->RebuildSnapshot();
 
   return true;
 }
@@ -424,22 +509,11 @@ bool IntrospectionManager::RemoveFilterImpl(const std::string &_filterId)
     this->dataPtr->filterPubs.erase(topicName);
   }
 
-  // Save the old list of items.
-  auto oldItems = this->dataPtr->filters.at(_filterId).items;
-
   // Let's remove the filter.
   this->dataPtr->filters.erase(_filterId);
 
-  // Remove any reference to this filter inside observedItems.
-  for (auto const &oldItem : oldItems)
-  {
-    auto &filters = this->dataPtr->observedItems[oldItem].filters;
-    filters.erase(_filterId);
-
-    // If there is nobody interested in this item, remove it.
-    if (filters.empty())
-      this->dataPtr->observedItems.erase(oldItem);
-  }
+  // Stop sampling items which nobody observes anymore.
+  this->RebuildSnapshot();
 
   return true;
 }
@@ -578,7 +652,7 @@ bool IntrospectionManager::Items(const gazebo::msgs::Empty &/*_req*/,
 {
   {
     std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
-    for (auto const &item : this->dataPtr->allItems)
+    for (auto const &item : this->dataPtr->itemIndex)
     {
       auto nextParam = _rep.add_param();
       nextParam->set_name("item");
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_UTIL_INTROSPECTION_MANAGER_HH_
 #define GAZEBO_UTIL_INTROSPECTION_MANAGER_HH_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <set>
@@ -83,20 +84,39 @@ namespace gazebo
       /// \return Set of registered items.
       public: std::set<std::string> Items() const;
 
-      /// \brief Update all the items under observation and publish updates
-      /// through all the topics. The message received in the update will
-      /// contain the name and latest values of all the items specified
-      /// in the filter.
-      /// If there are changes in the items list since the last update,
-      /// a new message is published under the topic
-      /// "/introspection/<manager_id>/items_update".
+      /// \brief Sample all the items under observation and publish updates
+      /// through all the topics, see NotifyUpdates. The message received in
+      /// the update will contain the name and latest values of all the items
+      /// specified in the filter.
+      /// Sampling doesn't lock the manager, and when no items are being
+      /// observed this function returns immediately.
       public: void Update();
 
-      /// \brief If there are changes in the items list since the last update,
-      /// a new message is published under the topic
+      /// \brief Publish the samples taken by Update since the last call,
+      /// one message per sample and filter. Publication is throttled by
+      /// NotifyRate. Also, if there are changes in the items list since the
+      /// last update, a new message is published under the topic
       /// "/introspection/<manager_id>/items_update".
       public: void NotifyUpdates();
 
+      /// \brief Set the maximum rate at which sampled values are published.
+      /// Samples taken between publications are kept in a fixed size buffer
+      /// and published together, new samples being dropped if the
+      /// buffer fills up.
+      /// \param[in] _hz Rate in Hz, zero publishes on every NotifyUpdates.
+      public: void SetNotifyRate(const double _hz);
+
+      /// \brief Get the maximum rate at which sampled values are published.
+      /// \return Rate in Hz, zero if unthrottled.
+      /// \sa SetNotifyRate
+      public: double NotifyRate() const;
+
+      /// \brief Get the number of samples which were dropped because they
+      /// couldn't be published fast enough, since the observed items last
+      /// changed.
+      /// \return Number of dropped samples.
+      public: uint64_t DroppedSamples() const;
+
       /// \brief Constructor.
       private: IntrospectionManager();
 
@@ -178,6 +198,11 @@ namespace gazebo
       private: bool Items(const gazebo::msgs::Empty &_req,
                           gazebo::msgs::Param_V &_rep);
 
+      /// \brief Rebuild the snapshot of observed items read by Update.
+      /// Must be called with the manager locked, after any change to the
+      /// registered items or the filters.
+      private: void RebuildSnapshot();
+
       /// \brief Helper function for creating a random string identifier.
       /// E.g.: "abcbgh", "egyufd".
       /// \param[in] _size Length of the identifier in chars.
@@ -17,12 +17,16 @@
 #ifndef GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 #define GAZEBO_UTIL_INTROSPECTION_MANAGER_PRIVATE_HH_
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 #include <ignition/transport.hh>
+#include "gazebo/common/Time.hh"
 #include "gazebo/msgs/any.pb.h"
 #include "gazebo/msgs/param_v.pb.h"
 #include "gazebo/util/IntrospectionManager.hh"
@@ -31,25 +35,78 @@ namespace gazebo
 {
   namespace util
   {
+    /// \brief Callback used to get the last value of an item.
+    using IntrospectionItemCallback = std::function<gazebo::msgs::Any ()>;
+
     /// \brief Private data for the IntrospectionFilter class.
     struct IntrospectionFilter
     {
       /// \brief Items observed by this filter.
       std::set<std::string> items;
+    };
+
+    /// \brief A registered item.
+    struct IntrospectionItem
+    {
+      /// \brief Name of the item.
+      std::string name;
+
+      /// \brief Callback used to get the last value of the item. Shared with
+      /// the observed snapshots, so it stays alive while the simulation
+      /// thread samples it even if the item is unregistered meanwhile.
+      /// Null if this entry of the table is free.
+      std::shared_ptr<const IntrospectionItemCallback> cb;
+    };
 
-      /// \brief Message containing the next update. A message is a collection
-      /// of items and values.
+    /// \brief A filter as seen from the update path.
+    struct IntrospectionSnapshotFilter
+    {
+      /// \brief Publisher of the filter topic.
+      ignition::transport::Node::Publisher pub;
+
+      /// \brief Topic name, used for error messages.
+      std::string topic;
+
+      /// \brief Position of each of the filter's items within the snapshot.
+      std::vector<size_t> positions;
+
+      /// \brief Message reused for each update of this filter. Only used
+      /// when draining.
       msgs::Param_V msg;
     };
 
-    /// \brief Todo.
-    struct ObservedItem
+    /// \brief Immutable view of the items which have at least one observer.
+    /// A new snapshot is built whenever items or filters change, and the
+    /// update path only ever reads the current one, so sampling values
+    /// doesn't require locking the manager. The snapshot also owns the
+    /// preallocated ring of samples written by Update and drained by
+    /// NotifyUpdates.
+    struct IntrospectionSnapshot
     {
-      /// \brief ToDo.
-      gazebo::msgs::Any lastValue;
+      /// \brief Capacity of the ring of samples.
+      static const size_t kRingSize = 64;
+
+      /// \brief Names of the observed items.
+      std::vector<std::string> names;
+
+      /// \brief Callbacks of the observed items, same order as names.
+      std::vector<std::shared_ptr<const IntrospectionItemCallback>> callbacks;
 
-      /// \brief ToDo.
-      std::set<std::string> filters;
+      /// \brief Active filters.
+      std::vector<IntrospectionSnapshotFilter> filters;
+
+      /// \brief Ring of samples. Each sample holds one value per observed
+      /// item, same order as names. Written only by the producer.
+      std::vector<std::vector<gazebo::msgs::Any>> ring;
+
+      /// \brief Index of the next sample to write.
+      std::atomic<uint64_t> head{0};
+
+      /// \brief Index of the next sample to read.
+      std::atomic<uint64_t> tail{0};
+
+      /// \brief Number of samples dropped because the ring was full.
+      std::atomic<uint64_t> dropped{0};
     };
 
     /// \brief Private data for the IntrospectionManager class.
@@ -60,28 +117,29 @@ namespace gazebo
       /// The value is the associated introspection filter.
       public: std::map<std::string, IntrospectionFilter> filters;
 
-      /// \brief List of all registered items.
-      /// The key contains the item name.
-      /// The value contains the string representation of the protobuf type
-      /// that stores the value.
-      /// E.g.: allItems["model1::pose"] = "gazebo::msgs::Pose"
-      public: std::map<std::string, std::function <gazebo::msgs::Any ()>>
-          allItems;
-
-      /// \brief Set of all registered items names.
-      /// This is a convenience/performance enhancement for retreving
-      /// registered keys.
-      public: std::set<std::string> allItemsKeys;
-
-      /// \brief List of items that have at least one active observer.
+      /// \brief Table of all registered items, addressed by index. Entries
+      /// of unregistered items are reused.
+      public: std::vector<IntrospectionItem> items;
+
+      /// \brief Index of each registered item in the items table.
       /// The key contains the item name.
-      /// The value contains the last value stored for this item, as well as a
-      /// list of all the filters that contain the item.
-      public: std::map<std::string, ObservedItem> observedItems;
+      public: std::map<std::string, size_t> itemIndex;
 
-      /// \brief Mutex to make this class thread-safe.
+      /// \brief Indices of free entries in the items table.
+      public: std::vector<size_t> freeItems;
+
+      /// \brief Current snapshot of observed items, null when nothing is
+      /// being observed. Always accessed with std::atomic_load and
+      /// std::atomic_store.
+      public: std::shared_ptr<IntrospectionSnapshot> snapshot;
+
+      /// \brief Mutex to make this class thread-safe. It isn't taken by the
+      /// update path.
       public: mutable std::mutex mutex;
 
+      /// \brief Ensures there's a single consumer draining the ring.
+      public: std::mutex drainMutex;
+
       /// \brief Node used for communications.
       public: ignition::transport::Node node;
 
@@ -94,7 +152,14 @@ namespace gazebo
 
       /// \brief Flag that will be true when the list of registered items has
       /// changed since the last update.
-      public: bool itemsUpdated = false;
+      public: std::atomic<bool> itemsUpdated{false};
+
+      /// \brief Maximum rate at which samples are published, in Hz. Zero
+      /// publishes on every call to NotifyUpdates.
+      public: std::atomic<double> notifyRate{0.0};
+
+      /// \brief Wall time of the last publication of samples.
+      public: common::Time lastNotifyTime;
 
       /// \brief Map of filter topic names to publishers.
       public: std::map<std::string, ignition::transport::Node::Publisher>
@@ -72,12 +72,35 @@ void LogPlay::Open(const std::string &_logFile)
   if (boost::filesystem::is_directory(path))
     gzthrow("Invalid logfile [" + _logFile + "]. This is a directory.");
 
+  this->dataPtr->chunks.clear();
+  this->dataPtr->currChunk = 0;
+  if (this->dataPtr->binaryFile.is_open())
+    this->dataPtr->binaryFile.close();
+
+  // Compressed chunks of recent logs are raw binary, which can't be parsed
+  // as XML. Only the header is parsed, and the chunks are indexed.
+  std::string header;
+  this->dataPtr->binaryFile.open(_logFile, std::ios::in | std::ios::binary);
+  this->dataPtr->binary = this->dataPtr->binaryFile.is_open() &&
+    LogPlayPrivate::ReadBinaryHeader(this->dataPtr->binaryFile, header);
+
   // Flag use to indicate if a parser failure has occurred
-  bool xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
-    tinyxml2::XML_SUCCESS;
+  bool xmlParserFail;
+  if (this->dataPtr->binary)
+  {
+    header += "</gazebo_log>";
+    xmlParserFail = this->dataPtr->xmlDoc.Parse(header.c_str()) !=
+      tinyxml2::XML_SUCCESS;
+  }
+  else
+  {
+    this->dataPtr->binaryFile.close();
+    xmlParserFail = this->dataPtr->xmlDoc.LoadFile(_logFile.c_str()) !=
+      tinyxml2::XML_SUCCESS;
+  }
 
   // Parse the log file
-  if (xmlParserFail)
+  if (xmlParserFail && !this->dataPtr->binary)
   {
     std::string endTag = "</gazebo_log>";
     // Open the log file for reading, we will check if the end of the log
@@ -147,7 +170,26 @@ void LogPlay::Open(const std::string &_logFile)
   // Read in the header.
   this->ReadHeader();
 
-  this->dataPtr->logCurrXml = this->dataPtr->logStartXml;
+  // Index the chunks.
+  if (this->dataPtr->binary)
+  {
+    this->dataPtr->IndexBinary(this->dataPtr->binaryFile);
+  }
+  else
+  {
+    for (auto chunkXml =
+         this->dataPtr->logStartXml->FirstChildElement("chunk");
+         chunkXml; chunkXml = chunkXml->NextSiblingElement("chunk"))
+    {
+      LogPlayChunk chunk;
+      chunk.xml = chunkXml;
+      chunk.SetTimes(chunkXml->Attribute("sim_start"),
+          chunkXml->Attribute("sim_end"));
+      this->dataPtr->chunks.push_back(chunk);
+    }
+  }
+
+  this->dataPtr->currChunk = 0;
   this->dataPtr->encoding.clear();
 
   // Extract the start/end log times from the log.
@@ -156,14 +198,12 @@ void LogPlay::Open(const std::string &_logFile)
   // Extract the initial "iterations" value from the log.
   this->dataPtr->iterationsFound = this->ReadIterations();
 
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
+  this->dataPtr->currChunk = 0;
 
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
     gzthrow("Unable to find the first chunk");
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
+  if (!this->dataPtr->ChunkData(0, this->dataPtr->currentChunk))
   {
     gzthrow("Unable to decode log file");
   }
@@ -224,7 +264,10 @@ void LogPlay::ReadHeader()
   else
     this->dataPtr->logVersion = childXml->GetText();
 
-  if (this->dataPtr->logVersion != GZ_LOG_VERSION)
+  // Version 1.0 logs only differ by their text chunks, which are still
+  // supported.
+  if (this->dataPtr->logVersion != GZ_LOG_VERSION &&
+      this->dataPtr->logVersion != "1.0")
   {
     gzwarn << "Log version[" << this->dataPtr->logVersion << "] in file["
            << this->dataPtr->filename
@@ -261,7 +304,11 @@ void LogPlay::ReadLogTimes()
   std::string chunk;
   bool found = false;
 
-  auto chunkXml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (this->dataPtr->chunks.empty())
+  {
+    gzerr << "Unable to find the first chunk" << std::endl;
+    return;
+  }
 
   // Try to read the start time of the log.
   auto numChunksToTry =
@@ -269,13 +316,7 @@ void LogPlay::ReadLogTimes()
 
   for (unsigned int i = 0; i < numChunksToTry; ++i)
   {
-    if (!chunkXml)
-    {
-      gzerr << "Unable to find the first chunk" << std::endl;
-      return;
-    }
-
-    if (!this->dataPtr->ChunkData(chunkXml, chunk))
+    if (!this->dataPtr->ChunkData(i, chunk))
       return;
 
     // Find the first <sim_time> of the log.
@@ -292,22 +333,13 @@ void LogPlay::ReadLogTimes()
       found = true;
       break;
     }
-
-    chunkXml = chunkXml->NextSiblingElement("chunk");
   }
 
   if (!found)
     gzwarn << "Unable to find <sim_time> tags in any chunk." << std::endl;
 
   // Jump to the last chunk for finding the last <sim_time>.
-  auto lastChunk = this->dataPtr->logStartXml->LastChildElement("chunk");
-  if (!lastChunk)
-  {
-    gzerr << "Unable to jump to the last chunk of the log file\n";
-    return;
-  }
-
-  if (!this->dataPtr->ChunkData(lastChunk, chunk))
+  if (!this->dataPtr->ChunkData(this->dataPtr->chunks.size() - 1, chunk))
     return;
 
   // Update the last <sim_time> of the log.
@@ -336,7 +368,11 @@ bool LogPlay::ReadIterations()
   const std::string kStartDelim = "<iterations>";
   const std::string kEndDelim = "</iterations>";
 
-  auto chunkXml = this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (this->dataPtr->chunks.empty())
+  {
+    gzerr << "Unable to find the first chunk" << std::endl;
+    return false;
+  }
 
   // Read the first "iterations" value of the log from the first chunk.
   auto numChunksToTry =
@@ -344,14 +380,8 @@ bool LogPlay::ReadIterations()
 
   for (unsigned int i = 0; i < numChunksToTry; ++i)
   {
-    if (!chunkXml)
-    {
-      gzerr << "Unable to find the first chunk" << std::endl;
-      return false;
-    }
-
     std::string chunk;
-    if (!this->dataPtr->ChunkData(chunkXml, chunk))
+    if (!this->dataPtr->ChunkData(i, chunk))
       return false;
 
     // Find the first <iterations> of the log.
@@ -365,8 +395,6 @@ bool LogPlay::ReadIterations()
       ss >> this->dataPtr->initialIterations;
       return true;
     }
-
-    chunkXml = chunkXml->NextSiblingElement("chunk");
   }
 
   gzwarn << "Unable to find <iterations>...</iterations> tags in the first "
@@ -536,20 +564,16 @@ bool LogPlay::Rewind()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   this->dataPtr->currentChunk.clear();
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
 
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
   {
     gzerr << "Unable to jump to the beginning of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
-                                this->dataPtr->currentChunk))
-  {
+  this->dataPtr->currChunk = 0;
+  if (!this->dataPtr->ChunkData(0, this->dataPtr->currentChunk))
     return false;
-  }
 
   // Skip first <sdf> block (it doesn't have a world state).
   this->dataPtr->end = this->dataPtr->currentChunk.find(
@@ -576,16 +600,14 @@ bool LogPlay::Forward()
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Get the last chunk.
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->LastChildElement("chunk");
-
-  if (!this->dataPtr->logCurrXml)
+  if (this->dataPtr->chunks.empty())
   {
     gzerr << "Unable to jump to the end of the log file\n";
     return false;
   }
 
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  this->dataPtr->currChunk = this->dataPtr->chunks.size() - 1;
+  if (!this->dataPtr->ChunkData(this->dataPtr->currChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -690,37 +712,40 @@ bool LogPlay::Seek(const common::Time &_time)
 /////////////////////////////////////////////////
 bool LogPlay::Chunk(unsigned int _index, std::string &_data) const
 {
-  unsigned int count = 0;
-  this->dataPtr->logCurrXml =
-    this->dataPtr->logStartXml->FirstChildElement("chunk");
+  if (_index >= this->dataPtr->chunks.size())
+    return false;
 
-  while (this->dataPtr->logCurrXml && count < _index)
-  {
-    count++;
-    this->dataPtr->logCurrXml =
-      this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  }
+  this->dataPtr->currChunk = _index;
+  return this->dataPtr->ChunkData(_index, _data);
+}
 
-  if (this->dataPtr->logCurrXml && count == _index)
-    return this->dataPtr->ChunkData(this->dataPtr->logCurrXml, _data);
-  else
-    return false;
+/////////////////////////////////////////////////
+bool LogPlay::ReadChunk(const unsigned int _index, std::string &_data) const
+{
+  std::string encoding;
+  return this->dataPtr->ReadChunk(_index, encoding, _data);
 }
 
 /////////////////////////////////////////////////
-bool LogPlayPrivate::ChunkData(
-    tinyxml2::XMLElement *_xml,
-    std::string &_data)
+bool LogPlay::ChunkTimeRange(const unsigned int _index, common::Time &_start,
+    common::Time &_end) const
 {
-  // Make sure we have valid xml pointer
-  if (!_xml)
+  if (_index >= this->dataPtr->chunks.size() ||
+      !this->dataPtr->chunks[_index].hasTimes)
   {
-    gzerr << "NULL XML element" << std::endl;
     return false;
   }
 
-  /// Get the chunk's encoding
-  this->encoding = _xml->Attribute("encoding");
+  _start = this->dataPtr->chunks[_index].startTime;
+  _end = this->dataPtr->chunks[_index].endTime;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::ChunkData(const size_t _index, std::string &_data)
+{
+  if (!this->ReadChunk(_index, this->encoding, _data))
+    return false;
 
   // Make sure there is an encoding value.
   if (this->encoding.empty())
@@ -728,52 +753,168 @@ bool LogPlayPrivate::ChunkData(
     gzthrow("Encoding missing for a chunk in log file[" + this->filename + "]");
   }
 
-  if (this->encoding == "txt")
-    _data = _xml->GetText();
-  else if (this->encoding == "bz2")
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::ReadChunk(const size_t _index, std::string &_encoding,
+    std::string &_data)
+{
+  if (_index >= this->chunks.size())
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    gzerr << "Invalid chunk index[" << _index << "]" << std::endl;
+    return false;
+  }
 
-    // Decode the base64 string
-    buffer = Base64Decode(data);
+  const LogPlayChunk &chunk = this->chunks[_index];
+  std::string buffer;
 
-    // Decompress the bz2 data
-    {
-      boost::iostreams::filtering_istream in;
-      in.push(boost::iostreams::bzip2_decompressor());
-      in.push(boost::make_iterator_range(buffer));
+  if (this->binary)
+  {
+    _encoding = chunk.encoding;
 
-      // Get the data
-      std::getline(in, _data, '\0');
-      _data += '\0';
+    // Only the file access is serialized, decompression isn't.
+    std::lock_guard<std::mutex> lock(this->fileMutex);
+    buffer.resize(chunk.size);
+    this->binaryFile.clear();
+    this->binaryFile.seekg(chunk.offset);
+    if (!this->binaryFile.read(&buffer[0], chunk.size))
+    {
+      gzerr << "Unable to read chunk[" << _index << "] of log file["
+        << this->filename << "]\n";
+      return false;
     }
   }
-  else if (this->encoding == "zlib")
+  else
   {
-    std::string data = _xml->GetText();
-    std::string buffer;
+    // Make sure we have valid xml pointer
+    if (!chunk.xml)
+    {
+      gzerr << "NULL XML element" << std::endl;
+      return false;
+    }
+
+    /// Get the chunk's encoding
+    const char *encodingAttr = chunk.xml->Attribute("encoding");
+    _encoding = encodingAttr ? encodingAttr : "";
+    if (_encoding.empty())
+      return true;
+
+    const char *text = chunk.xml->GetText();
+    if (_encoding == "txt")
+    {
+      _data = text ? text : "";
+      return true;
+    }
 
     // Decode the base64 string
-    buffer = Base64Decode(data);
+    buffer = Base64Decode(text ? text : "");
+  }
+
+  return this->Decompress(_encoding, buffer, _data);
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::ReadBinaryHeader(std::istream &_in, std::string &_header)
+{
+  const std::string kEndHeader = "</header>";
+
+  // The header is short, don't read a whole text log looking for it.
+  const unsigned int kMaxLines = 32;
+  std::string line;
+  for (unsigned int i = 0; i < kMaxLines && std::getline(_in, line); ++i)
+  {
+    _header += line + "\n";
+    if (line.find(kEndHeader) != std::string::npos)
+      return _header.find("<chunk_format>binary</chunk_format>") !=
+        std::string::npos;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+void LogPlayPrivate::IndexBinary(std::istream &_in)
+{
+  const std::string kStartChunk = "<chunk ";
+  const std::string kEndChunk = "</chunk>";
 
-    // Decompress the zlib data
+  while (_in)
+  {
+    // Skip whitespace between chunks
+    _in >> std::ws;
+
+    std::string tag;
+    if (!std::getline(_in, tag, '>'))
+      break;
+
+    // End of the log
+    if (tag.compare(0, kStartChunk.size(), kStartChunk) != 0)
+      break;
+
+    LogPlayChunk chunk;
+
+    // Get the encoding and size attributes
+    auto attribute = [&tag](const std::string &_name) -> std::string
+    {
+      auto from = tag.find(_name + "='");
+      if (from == std::string::npos)
+        return std::string();
+      from += _name.size() + 2;
+      auto to = tag.find('\'', from);
+      return to == std::string::npos ? std::string() :
+        tag.substr(from, to - from);
+    };
+    chunk.encoding = attribute("encoding");
+    chunk.SetTimes(attribute("sim_start").c_str(),
+        attribute("sim_end").c_str());
+    try
     {
-      boost::iostreams::filtering_istream in;
-      in.push(boost::iostreams::zlib_decompressor());
-      in.push(boost::make_iterator_range(buffer));
+      chunk.size = std::stoul(attribute("size"));
+    }
+    catch(...)
+    {
+      gzerr << "Chunk without a size in log file[" << this->filename
+        << "]\n";
+      break;
+    }
 
-      // Get the data
-      std::getline(in, _data, '\0');
-      _data += '\0';
+    chunk.offset = _in.tellg();
+    _in.seekg(chunk.size, std::ios::cur);
+
+    // A chunk cut short while recording is ignored
+    std::string endTag(kEndChunk.size(), '\0');
+    if (!_in.read(&endTag[0], endTag.size()) || endTag != kEndChunk)
+    {
+      gzwarn << "Ignoring truncated chunk at the end of log file["
+        << this->filename << "]\n";
+      break;
     }
+
+    this->chunks.push_back(chunk);
   }
+}
+
+/////////////////////////////////////////////////
+bool LogPlayPrivate::Decompress(const std::string &_encoding,
+    const std::string &_compressed, std::string &_data) const
+{
+  boost::iostreams::filtering_istream in;
+  if (_encoding == "bz2")
+    in.push(boost::iostreams::bzip2_decompressor());
+  else if (_encoding == "zlib")
+    in.push(boost::iostreams::zlib_decompressor());
   else
   {
-    gzerr << "Invalid encoding[" << this->encoding << "] in log file["
+    gzerr << "Invalid encoding[" << _encoding << "] in log file["
       << this->filename << "]\n";
     return false;
   }
+  in.push(boost::make_iterator_range(_compressed));
+
+  // Get the data
+  std::getline(in, _data, '\0');
+  _data += '\0';
 
   return true;
 }
@@ -787,27 +928,17 @@ std::string LogPlay::Encoding() const
 /////////////////////////////////////////////////
 unsigned int LogPlay::ChunkCount() const
 {
-  unsigned int count = 0;
-  auto xml = this->dataPtr->logStartXml->FirstChildElement("chunk");
-
-  while (xml)
-  {
-    count++;
-    xml = xml->NextSiblingElement("chunk");
-  }
-
-  return count;
+  return this->dataPtr->chunks.size();
 }
 
 /////////////////////////////////////////////////
 bool LogPlay::NextChunk()
 {
-  auto next = this->dataPtr->logCurrXml->NextSiblingElement("chunk");
-  if (!next)
+  if (this->dataPtr->currChunk + 1 >= this->dataPtr->chunks.size())
     return false;
 
-  this->dataPtr->logCurrXml = next;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  ++this->dataPtr->currChunk;
+  if (!this->dataPtr->ChunkData(this->dataPtr->currChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -822,12 +953,11 @@ bool LogPlay::NextChunk()
 /////////////////////////////////////////////////
 bool LogPlay::PrevChunk()
 {
-  auto prev = this->dataPtr->logCurrXml->PreviousSiblingElement("chunk");
-  if (!prev)
+  if (this->dataPtr->currChunk == 0 || this->dataPtr->chunks.empty())
     return false;
 
-  this->dataPtr->logCurrXml = prev;
-  if (!this->dataPtr->ChunkData(this->dataPtr->logCurrXml,
+  --this->dataPtr->currChunk;
+  if (!this->dataPtr->ChunkData(this->dataPtr->currChunk,
                                 this->dataPtr->currentChunk))
   {
     return false;
@@ -838,3 +968,17 @@ bool LogPlay::PrevChunk()
 
   return true;
 }
+
+/////////////////////////////////////////////////
+void LogPlayChunk::SetTimes(const char *_start, const char *_end)
+{
+  this->hasTimes = false;
+  if (!_start || !_end || *_start == '\0' || *_end == '\0')
+    return;
+
+  std::stringstream startStream(_start);
+  std::stringstream endStream(_end);
+  startStream >> this->startTime;
+  endStream >> this->endTime;
+  this->hasTimes = !startStream.fail() && !endStream.fail();
+}
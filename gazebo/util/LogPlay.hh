@@ -140,6 +140,24 @@ namespace gazebo
       /// \return True if the _index was valid.
       public: bool Chunk(const unsigned int _index, std::string &_data) const;
 
+      /// \brief Get data for a particular chunk index, without changing the
+      /// current position in the log. Unlike Chunk, this can be called from
+      /// several threads at once.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was read.
+      public: bool ReadChunk(const unsigned int _index,
+                  std::string &_data) const;
+
+      /// \brief Get the simulation time range of a chunk from the chunk
+      /// index, without decompressing the chunk.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _start First simulation time in the chunk.
+      /// \param[out] _end Last simulation time in the chunk.
+      /// \return False if the log doesn't record the range of the chunk.
+      public: bool ChunkTimeRange(const unsigned int _index,
+                  common::Time &_start, common::Time &_end) const;
+
       /// \brief Get the type of encoding used for current chunck in the
       /// open log file.
       /// \return The type of encoding. An empty string will be returned if
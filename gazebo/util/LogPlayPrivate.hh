@@ -25,8 +25,10 @@
 #include <tinyxml2.h>
 #endif
 
+#include <fstream>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "gazebo/common/Time.hh"
 #include "gazebo/util/system.hh"
@@ -35,18 +37,80 @@ namespace gazebo
 {
   namespace util
   {
+    /// \internal
+    /// \brief Location of a chunk in a log file.
+    class LogPlayChunk
+    {
+      /// \brief XML element of the chunk, for text logs.
+      public: tinyxml2::XMLElement *xml = nullptr;
+
+      /// \brief Encoding of the chunk, for binary logs.
+      public: std::string encoding;
+
+      /// \brief Offset of the compressed data in the file, for binary logs.
+      public: std::streamoff offset = 0;
+
+      /// \brief Size of the compressed data, for binary logs.
+      public: size_t size = 0;
+
+      /// \brief Set the simulation time range of the chunk.
+      /// \param[in] _start First sim time, as "sec nsec". May be null.
+      /// \param[in] _end Last sim time, as "sec nsec". May be null.
+      public: void SetTimes(const char *_start, const char *_end);
+
+      /// \brief True if the log records the time range of the chunk.
+      public: bool hasTimes = false;
+
+      /// \brief First simulation time in the chunk.
+      public: common::Time startTime;
+
+      /// \brief Last simulation time in the chunk.
+      public: common::Time endTime;
+    };
+
     /// \internal
     /// \brief Private data for log play
     class LogPlayPrivate
     {
-      /// \brief Helper function to get chunk data from XML.
-      /// \param[in] _xml Pointer to an xml block that has state data.
+      /// \brief Helper function to get the data of a chunk, and set the
+      /// current encoding.
+      /// \param[in] _index Index of the chunk.
       /// \param[out] _data Storage for the chunk's data.
-      /// \return True if the chunk was successfully parsed.
-      public: bool ChunkData(
-                  tinyxml2::XMLElement *_xml,
+      /// \return True if the chunk was successfully read.
+      public: bool ChunkData(const size_t _index, std::string &_data);
+
+      /// \brief Read and decompress a chunk. Can be called from several
+      /// threads at once.
+      /// \param[in] _index Index of the chunk.
+      /// \param[out] _encoding Encoding of the chunk.
+      /// \param[out] _data Storage for the chunk's data.
+      /// \return True if the chunk was successfully read.
+      public: bool ReadChunk(const size_t _index, std::string &_encoding,
                   std::string &_data);
 
+      /// \brief Decompress the data of a chunk.
+      /// \param[in] _encoding Encoding of the chunk (zlib or bz2).
+      /// \param[in] _compressed Compressed data.
+      /// \param[out] _data Decompressed data.
+      /// \return True on success.
+      public: bool Decompress(const std::string &_encoding,
+                  const std::string &_compressed, std::string &_data) const;
+
+      /// \brief Read the header of a log file, and check whether its chunks
+      /// are stored as raw binary.
+      /// \param[in] _in Stream of the log file. On return it is positioned
+      /// after the header.
+      /// \param[out] _header The header, from the start of the file.
+      /// \return True if the chunks are binary.
+      public: static bool ReadBinaryHeader(std::istream &_in,
+                  std::string &_header);
+
+      /// \brief Build the chunk index of a binary log file. A truncated
+      /// last chunk is ignored.
+      /// \param[in] _in Stream of the log file, positioned after the
+      /// header.
+      public: void IndexBinary(std::istream &_in);
+
       /// \brief Max number of chunks to inspect when looking for XML elements.
       public: const unsigned int kNumChunksToTry = 2u;
 
@@ -68,8 +132,21 @@ namespace gazebo
       /// \brief Start of the log.
       public: tinyxml2::XMLElement *logStartXml = nullptr;
 
-      /// \brief Current position in the log file.
-      public: tinyxml2::XMLElement *logCurrXml = nullptr;
+      /// \brief All the chunks of the log file, in order.
+      public: std::vector<LogPlayChunk> chunks;
+
+      /// \brief Index of the current chunk.
+      public: size_t currChunk = 0;
+
+      /// \brief True if the chunks of the open log file are stored as raw
+      /// binary.
+      public: bool binary = false;
+
+      /// \brief The open binary log file.
+      public: std::ifstream binaryFile;
+
+      /// \brief Serializes reads of the binary log file.
+      public: std::mutex fileMutex;
 
       /// \brief Name of the log file.
       public: std::string filename;
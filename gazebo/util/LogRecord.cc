@@ -25,6 +25,7 @@
   #define access _access
 #endif
 
+#include <algorithm>
 #include <functional>
 
 #include <boost/archive/iterators/base64_from_binary.hpp>
@@ -44,7 +45,6 @@
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Assert.hh"
-#include "gazebo/common/Base64.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Events.hh"
 #include "gazebo/common/Exception.hh"
@@ -58,6 +58,32 @@
 using namespace gazebo;
 using namespace util;
 
+/////////////////////////////////////////////////
+/// \brief Get the attributes recording the simulation time range of a
+/// chunk, which let readers skip chunks without decompressing them.
+/// \param[in] _data Raw chunk data.
+/// \return The attributes, empty if the chunk has no <sim_time>.
+static std::string TimeRangeAttributes(const std::string &_data)
+{
+  const std::string kStartTime = "<sim_time>";
+  const std::string kEndTime = "</sim_time>";
+
+  auto firstFrom = _data.find(kStartTime);
+  if (firstFrom == std::string::npos)
+    return std::string();
+  auto lastFrom = _data.rfind(kStartTime);
+
+  firstFrom += kStartTime.size();
+  lastFrom += kStartTime.size();
+  auto firstTo = _data.find(kEndTime, firstFrom);
+  auto lastTo = _data.find(kEndTime, lastFrom);
+  if (firstTo == std::string::npos || lastTo == std::string::npos)
+    return std::string();
+
+  return " sim_start='" + _data.substr(firstFrom, firstTo - firstFrom) +
+    "' sim_end='" + _data.substr(lastFrom, lastTo - lastFrom) + "'";
+}
+
 //////////////////////////////////////////////////
 LogRecord::LogRecord()
 : dataPtr(new LogRecordPrivate)
@@ -140,6 +166,8 @@ bool LogRecord::Start(const LogRecordParams &_params)
   this->dataPtr->period = _params.period;
   this->dataPtr->filter = _params.filter;
   this->dataPtr->recordResources = _params.recordResources;
+  this->dataPtr->compressionLevel = _params.compressionLevel;
+  this->dataPtr->workerCount = _params.workers;
   return this->Start(_params.encoding, _params.path);
 }
 
@@ -192,6 +220,16 @@ bool LogRecord::Start(const std::string &_encoding, const std::string &_path)
 
   this->dataPtr->encoding = _encoding;
 
+  // Start compressing chunks in the background. The write thread is woken
+  // up every time a chunk is ready.
+  this->dataPtr->pipeline.Start(_encoding, this->dataPtr->compressionLevel,
+      this->dataPtr->workerCount, [this]()
+      {
+        this->dataPtr->dataAvailableCondition.notify_one();
+      });
+  this->dataPtr->statusBytesIn = 0;
+  this->dataPtr->statusTime = common::Time();
+
   {
     std::unique_lock<std::mutex> logLock(this->dataPtr->writeMutex);
     this->dataPtr->logsEnd = this->dataPtr->logs.end();
@@ -382,7 +420,8 @@ void LogRecord::Add(const std::string &_name, const std::string &_filename,
   // Create a new log object
   try
   {
-    newLog = new LogRecordPrivate::Log(this, _filename, _logCallback);
+    newLog = new LogRecordPrivate::Log(this, _filename, _logCallback,
+        &this->dataPtr->pipeline);
   }
   catch(...)
   {
@@ -747,7 +786,7 @@ void LogRecord::RunWrite()
 }
 
 //////////////////////////////////////////////////
-void LogRecord::Write(const bool /*_force*/)
+void LogRecord::Write(const bool _force)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->writeMutex);
 
@@ -756,7 +795,7 @@ void LogRecord::Write(const bool /*_force*/)
       this->dataPtr->updateIter != this->dataPtr->logsEnd;
       ++this->dataPtr->updateIter)
   {
-    this->dataPtr->updateIter->second->Write();
+    this->dataPtr->updateIter->second->Write(_force);
   }
 }
 
@@ -769,10 +808,12 @@ common::Time LogRecord::RunTime() const
 //////////////////////////////////////////////////
 LogRecordPrivate::Log::Log(LogRecord *_parent,
     const std::string &_relativeFilename,
-    std::function<bool (std::ostringstream &)> _logCB)
+    std::function<bool (std::ostringstream &)> _logCB,
+    LogChunkPipeline *_pipeline)
 {
   this->parent = _parent;
   this->logCB = _logCB;
+  this->pipeline = _pipeline;
 
   this->relativeFilename = _relativeFilename;
 }
@@ -788,73 +829,32 @@ unsigned int LogRecordPrivate::Log::Update()
 {
   std::ostringstream stream;
 
-  // Get log data via the callback.
+  // Get log data via the callback. Compression happens on the pipeline's
+  // workers, so this only costs a copy of the data.
   if (this->logCB(stream))
   {
     std::string data = stream.str();
     if (!data.empty())
-    {
-      const std::string &encodingLocal = this->parent->Encoding();
-
-      this->buffer.append("<chunk encoding='");
-      this->buffer.append(encodingLocal);
-      this->buffer.append("'>\n");
-
-      this->buffer.append("<![CDATA[");
-      // Compress the data.
-      if (encodingLocal == "bz2")
-      {
-        std::string str;
-
-        // Compress to bzip2
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::bzip2_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
-
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
-      }
-      else if (encodingLocal == "zlib")
-      {
-        std::string str;
-
-        // Compress to zlib
-        {
-          boost::iostreams::filtering_ostream out;
-          out.push(boost::iostreams::zlib_compressor());
-          out.push(std::back_inserter(str));
-          boost::iostreams::copy(boost::make_iterator_range(data), out);
-        }
-
-        // Encode in base64.
-        Base64Encode(str.c_str(), str.size(), this->buffer);
-      }
-      else if (encodingLocal == "txt")
-        this->buffer.append(data);
-      else
-        gzerr << "Unknown log file encoding[" << encodingLocal << "]\n";
-      this->buffer.append("]]>\n");
-
-      this->buffer.append("</chunk>\n");
-    }
+      this->pending.push_back(this->pipeline->Submit(std::move(data)));
   }
 
-  return this->buffer.size();
+  return this->BufferSize();
 }
 
 //////////////////////////////////////////////////
 void LogRecordPrivate::Log::ClearBuffer()
 {
   this->buffer.clear();
+  this->pending.clear();
 }
 
 //////////////////////////////////////////////////
 unsigned int LogRecordPrivate::Log::BufferSize()
 {
-  return this->buffer.size();
+  size_t size = this->buffer.size();
+  for (auto const &job : this->pending)
+    size += job->done ? job->encoded.size() : job->rawSize;
+  return size;
 }
 
 //////////////////////////////////////////////////
@@ -875,7 +875,7 @@ void LogRecordPrivate::Log::Stop()
   if (this->logFile.is_open())
   {
     this->Update();
-    this->Write();
+    this->Write(true);
 
     std::string xmlEnd = "</gazebo_log>";
     this->logFile.write(xmlEnd.c_str(), xmlEnd.size());
@@ -903,15 +903,39 @@ void LogRecordPrivate::Log::Start(const boost::filesystem::path &_path)
          << "<header>\n"
          << "<log_version>" << GZ_LOG_VERSION << "</log_version>\n"
          << "<gazebo_version>" << GAZEBO_VERSION_FULL << "</gazebo_version>\n"
-         << "<rand_seed>" << ignition::math::Rand::Seed() << "</rand_seed>\n"
-         << "</header>\n";
+         << "<rand_seed>" << ignition::math::Rand::Seed() << "</rand_seed>\n";
+
+  // Compressed chunks are stored as raw binary, prefixed by their size.
+  if (this->parent->Encoding() != "txt")
+    stream << "<chunk_format>binary</chunk_format>\n";
+
+  stream << "</header>\n";
 
   this->buffer.append(stream.str());
 }
 
 //////////////////////////////////////////////////
-void LogRecordPrivate::Log::Write()
+void LogRecordPrivate::Log::Write(const bool _wait)
 {
+  // Move the encoded chunks to the buffer, in the order they were
+  // submitted.
+  while (!this->pending.empty())
+  {
+    const auto &job = this->pending.front();
+    if (!job->done)
+    {
+      if (!_wait)
+        break;
+      this->pipeline->Wait(job);
+    }
+
+    this->buffer.append(job->encoded);
+    this->pending.pop_front();
+  }
+
+  if (this->buffer.empty() && this->logFile.is_open())
+    return;
+
   // Make sure the file is open for writing
   if (!this->logFile.is_open())
   {
@@ -933,7 +957,7 @@ void LogRecordPrivate::Log::Write()
           << "Unable to write log data.\n";
 
     // We have to clear the buffer, or else it may grow indefinitely.
-    this->buffer.clear();
+    this->ClearBuffer();
     return;
   }
 
@@ -1003,6 +1027,21 @@ void LogRecord::PublishLogStatus()
   // Set whether to save model
   msg.mutable_log_file()->set_record_resources(this->dataPtr->recordResources);
 
+  // Compression throughput since the last status
+  common::Time wallTime = common::Time::GetWallTime();
+  uint64_t bytesIn = this->dataPtr->pipeline.BytesIn();
+  uint64_t bytesOut = this->dataPtr->pipeline.BytesOut();
+  double elapsed = (wallTime - this->dataPtr->statusTime).Double();
+  if (this->dataPtr->statusTime != common::Time::Zero && elapsed > 0 &&
+      bytesIn >= this->dataPtr->statusBytesIn)
+  {
+    msg.set_throughput((bytesIn - this->dataPtr->statusBytesIn) / elapsed);
+  }
+  if (bytesOut > 0)
+    msg.set_compression_ratio(static_cast<double>(bytesIn) / bytesOut);
+  this->dataPtr->statusBytesIn = bytesIn;
+  this->dataPtr->statusTime = wallTime;
+
   // Get the size of the log file
   size = this->FileSize();
 
@@ -1079,6 +1118,9 @@ void LogRecord::Cleanup()
     iter->second->Stop();
   }
 
+  // All chunks have been written, stop the compression workers.
+  this->dataPtr->pipeline.Stop();
+
   // Reset the times
   this->dataPtr->startTime = this->dataPtr->currTime = common::Time();
 
@@ -1110,3 +1152,197 @@ unsigned int LogRecord::BufferSize() const
 
   return size;
 }
+
+//////////////////////////////////////////////////
+LogChunkPipeline::~LogChunkPipeline()
+{
+  this->Stop();
+}
+
+//////////////////////////////////////////////////
+void LogChunkPipeline::Start(const std::string &_encoding, const int _level,
+    const unsigned int _workers, const std::function<void()> &_onEncoded)
+{
+  this->Stop();
+
+  this->encoding = _encoding;
+  this->level = _level;
+  this->onEncoded = _onEncoded;
+  this->bytesIn = 0;
+  this->bytesOut = 0;
+
+  // Leave some cores to the simulation
+  unsigned int count = _workers;
+  if (count == 0)
+    count = std::min(4u, std::max(1u, std::thread::hardware_concurrency() / 2));
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = false;
+  }
+
+  for (unsigned int i = 0; i < count; ++i)
+    this->workers.push_back(std::thread(&LogChunkPipeline::RunWorker, this));
+}
+
+//////////////////////////////////////////////////
+void LogChunkPipeline::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->jobCondition.notify_all();
+
+  // Workers encode the remaining jobs before exiting
+  for (auto &worker : this->workers)
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+  this->workers.clear();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<LogChunkPipeline::Job> LogChunkPipeline::Submit(
+    std::string &&_data)
+{
+  auto job = std::make_shared<Job>();
+  job->data = std::move(_data);
+  job->rawSize = job->data.size();
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->stop)
+    {
+      this->queue.push_back(job);
+      this->jobCondition.notify_one();
+      return job;
+    }
+  }
+
+  // Not running, encode in the calling thread
+  this->Process(job);
+  return job;
+}
+
+//////////////////////////////////////////////////
+void LogChunkPipeline::Wait(const std::shared_ptr<Job> &_job)
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  this->doneCondition.wait(lock, [&_job]() {return _job->done.load();});
+}
+
+//////////////////////////////////////////////////
+uint64_t LogChunkPipeline::BytesIn() const
+{
+  return this->bytesIn;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogChunkPipeline::BytesOut() const
+{
+  return this->bytesOut;
+}
+
+//////////////////////////////////////////////////
+void LogChunkPipeline::RunWorker()
+{
+  while (true)
+  {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->jobCondition.wait(lock, [this]()
+          {
+            return this->stop || !this->queue.empty();
+          });
+
+      // Only exit once the queue has been drained
+      if (this->queue.empty())
+        return;
+
+      job = this->queue.front();
+      this->queue.pop_front();
+    }
+
+    this->Process(job);
+  }
+}
+
+//////////////////////////////////////////////////
+void LogChunkPipeline::Process(const std::shared_ptr<Job> &_job)
+{
+  _job->encoded = Encode(_job->data, this->encoding, this->level);
+  this->bytesIn += _job->rawSize;
+  this->bytesOut += _job->encoded.size();
+
+  // The raw data isn't needed anymore
+  std::string().swap(_job->data);
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    _job->done = true;
+  }
+  this->doneCondition.notify_all();
+
+  if (this->onEncoded)
+    this->onEncoded();
+}
+
+//////////////////////////////////////////////////
+std::string LogChunkPipeline::Encode(const std::string &_data,
+    const std::string &_encoding, const int _level)
+{
+  std::string result;
+
+  if (_encoding == "txt")
+  {
+    result.reserve(_data.size() + 48);
+    result.append("<chunk encoding='txt'");
+    result.append(TimeRangeAttributes(_data));
+    result.append(">\n<![CDATA[");
+    result.append(_data);
+    result.append("]]>\n</chunk>\n");
+    return result;
+  }
+
+  std::string compressed;
+  {
+    boost::iostreams::filtering_ostream out;
+    if (_encoding == "bz2")
+    {
+      // The bzip2 level is its block size, in units of 100k
+      out.push(boost::iostreams::bzip2_compressor(_level > 0 ?
+          boost::iostreams::bzip2_params(std::min(_level, 9)) :
+          boost::iostreams::bzip2_params()));
+    }
+    else if (_encoding == "zlib")
+    {
+      out.push(boost::iostreams::zlib_compressor(_level >= 0 ?
+          boost::iostreams::zlib_params(std::min(_level, 9)) :
+          boost::iostreams::zlib_params()));
+    }
+    else
+    {
+      gzerr << "Unknown log file encoding[" << _encoding << "]\n";
+      return result;
+    }
+    out.push(std::back_inserter(compressed));
+    boost::iostreams::copy(boost::make_iterator_range(_data), out);
+  }
+
+  // Raw binary, the size attribute tells readers where the chunk ends.
+  result.reserve(compressed.size() + 64);
+  result.append("<chunk encoding='");
+  result.append(_encoding);
+  result.append("' size='");
+  result.append(std::to_string(compressed.size()));
+  result.append("'");
+  result.append(TimeRangeAttributes(_data));
+  result.append(">");
+  result.append(compressed);
+  result.append("</chunk>\n");
+
+  return result;
+}
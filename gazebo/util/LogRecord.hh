@@ -25,7 +25,7 @@
 #include "gazebo/common/SingletonT.hh"
 #include "gazebo/util/system.hh"
 
-#define GZ_LOG_VERSION "1.0"
+#define GZ_LOG_VERSION "2.0"
 
 /// \brief Explicit instantiation for typed SingletonT.
 GZ_SINGLETON_DECLARE(GZ_UTIL_VISIBLE, gazebo, util, LogRecord)
@@ -54,6 +54,15 @@ namespace gazebo
       /// \brief Recording resources. True will record state logs
       /// together with model meshes and materials.
       public: bool recordResources = false;
+
+      /// \brief Compression level. For zlib this is 0 (none) to 9 (best),
+      /// for bz2 the block size from 1 to 9. A value < 0 selects the
+      /// default of the encoding.
+      public: int compressionLevel = -1;
+
+      /// \brief Number of threads compressing log chunks. A value of 0
+      /// picks a number based on the available cores.
+      public: unsigned int workers = 0;
     };
 
     // Forward declare private data class
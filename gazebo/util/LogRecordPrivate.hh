@@ -17,11 +17,15 @@
 #ifndef _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 #define _GAZEBO_UTIL_LOGRECORD_PRIVATE_HH_
 
+#include <atomic>
+#include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 #include <functional>
 #include <condition_variable>
 #include <boost/filesystem.hpp>
@@ -32,6 +36,117 @@ namespace gazebo
   {
     class LogRecord;
 
+    /// \internal
+    /// \brief Encodes log chunks concurrently on a pool of worker threads.
+    /// Chunks are submitted in order by each log, which then writes them
+    /// in the same order once they are encoded.
+    class LogChunkPipeline
+    {
+      /// \brief A chunk being encoded.
+      public: class Job
+      {
+        /// \brief Raw chunk data, released once encoded.
+        public: std::string data;
+
+        /// \brief Size of the raw chunk data.
+        public: size_t rawSize = 0;
+
+        /// \brief Encoded chunk, ready to be written to the log file.
+        public: std::string encoded;
+
+        /// \brief True once the chunk has been encoded.
+        public: std::atomic<bool> done{false};
+      };
+
+      /// \brief Destructor. Stops the workers.
+      public: ~LogChunkPipeline();
+
+      /// \brief Start the workers.
+      /// \param[in] _encoding Chunk encoding (txt, zlib, or bz2).
+      /// \param[in] _level Compression level, -1 for the default.
+      /// \param[in] _workers Number of worker threads, 0 to pick one based
+      /// on the number of cores.
+      /// \param[in] _onEncoded Called by the workers every time a chunk has
+      /// been encoded.
+      public: void Start(const std::string &_encoding, const int _level,
+                  const unsigned int _workers,
+                  const std::function<void()> &_onEncoded);
+
+      /// \brief Encode all the submitted chunks and stop the workers.
+      public: void Stop();
+
+      /// \brief Submit a chunk for encoding. The chunk is encoded by the
+      /// calling thread if the workers aren't running.
+      /// \param[in] _data Raw chunk data, moved into the job.
+      /// \return The job.
+      public: std::shared_ptr<Job> Submit(std::string &&_data);
+
+      /// \brief Block until a job has been encoded.
+      /// \param[in] _job The job.
+      public: void Wait(const std::shared_ptr<Job> &_job);
+
+      /// \brief Get the number of raw bytes encoded since the pipeline was
+      /// started.
+      /// \return Number of bytes.
+      public: uint64_t BytesIn() const;
+
+      /// \brief Get the number of encoded bytes produced since the pipeline
+      /// was started.
+      /// \return Number of bytes.
+      public: uint64_t BytesOut() const;
+
+      /// \brief Encode a chunk. Compressed chunks are stored as raw binary
+      /// prefixed by their size, text chunks as CDATA.
+      /// \param[in] _data Raw chunk data.
+      /// \param[in] _encoding Chunk encoding (txt, zlib, or bz2).
+      /// \param[in] _level Compression level, -1 for the default.
+      /// \return The encoded chunk, including its <chunk> tags.
+      public: static std::string Encode(const std::string &_data,
+                  const std::string &_encoding, const int _level);
+
+      /// \brief Encode a job and notify its completion.
+      /// \param[in] _job Job to encode.
+      private: void Process(const std::shared_ptr<Job> &_job);
+
+      /// \brief Function run by each worker thread.
+      private: void RunWorker();
+
+      /// \brief Chunk encoding.
+      private: std::string encoding = "zlib";
+
+      /// \brief Compression level.
+      private: int level = -1;
+
+      /// \brief Jobs waiting for a worker.
+      private: std::deque<std::shared_ptr<Job>> queue;
+
+      /// \brief Worker threads.
+      private: std::vector<std::thread> workers;
+
+      /// \brief Protects the queue and the stop flag.
+      private: std::mutex mutex;
+
+      /// \brief Used by the workers to wait for jobs.
+      private: std::condition_variable jobCondition;
+
+      /// \brief Used to wait for jobs to be encoded.
+      private: std::condition_variable doneCondition;
+
+      /// \brief Flag used to stop the workers. The pipeline is stopped
+      /// until Start is called, so that chunks submitted before then are
+      /// encoded by the calling thread.
+      private: bool stop = true;
+
+      /// \brief Called every time a chunk has been encoded.
+      private: std::function<void()> onEncoded;
+
+      /// \brief Raw bytes encoded.
+      private: std::atomic<uint64_t> bytesIn{0};
+
+      /// \brief Encoded bytes produced.
+      private: std::atomic<uint64_t> bytesOut{0};
+    };
+
     /// \internal
     /// \brief Private data class for LogRecord.
     class LogRecordPrivate
@@ -48,8 +163,10 @@ namespace gazebo
         /// generate, sans the complete path.
         /// \param[in] _logCB Callback function, which is used to get log
         /// data.
+        /// \param[in] _pipeline Pipeline used to encode chunks.
         public: Log(LogRecord *_parent, const std::string &_relativeFilename,
-                    std::function<bool (std::ostringstream &)> _logCB);
+                    std::function<bool (std::ostringstream &)> _logCB,
+                    LogChunkPipeline *_pipeline);
 
         /// \brief Destructor
         public: virtual ~Log();
@@ -61,11 +178,14 @@ namespace gazebo
         /// \brief Stop logging.
         public: void Stop();
 
-        /// \brief Write data to disk.
-        public: void Write();
+        /// \brief Write data to disk. Only chunks which have been encoded
+        /// are written, in the order they were submitted.
+        /// \param[in] _wait True to wait for all submitted chunks to be
+        /// encoded.
+        public: void Write(const bool _wait = false);
 
-        /// \brief Update the data buffer.
-        /// \return The size of the data buffer.
+        /// \brief Get new log data and submit it for encoding.
+        /// \return The size of the data waiting to be written.
         public: unsigned int Update();
 
         /// \brief Clear the data buffer.
@@ -90,6 +210,13 @@ namespace gazebo
         /// \brief Callback from which to get data.
         public: std::function<bool (std::ostringstream &)> logCB;
 
+        /// \brief Pipeline used to encode chunks.
+        public: LogChunkPipeline *pipeline;
+
+        /// \brief Chunks submitted for encoding and not written yet, in
+        /// order.
+        public: std::deque<std::shared_ptr<LogChunkPipeline::Job>> pending;
+
         /// \brief Data buffer.
         public: std::string buffer;
 
@@ -217,6 +344,21 @@ namespace gazebo
 
       /// \brief List of saved files if record with resources is enabled.
       public: std::set<std::string> savedFiles;
+
+      /// \brief Compression level, -1 for the default.
+      public: int compressionLevel = -1;
+
+      /// \brief Number of encoding worker threads, 0 for automatic.
+      public: unsigned int workerCount = 0;
+
+      /// \brief Pipeline used to encode chunks.
+      public: LogChunkPipeline pipeline;
+
+      /// \brief Raw bytes encoded at the last status publication.
+      public: uint64_t statusBytesIn = 0;
+
+      /// \brief Wall time of the last status publication.
+      public: common::Time statusTime;
     };
     /// \}
   }
@@ -22,6 +22,7 @@
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/SystemPaths.hh"
 #include "gazebo/common/Time.hh"
+#include "gazebo/util/LogPlay.hh"
 #include "gazebo/util/LogRecord.hh"
 #include "test/util.hh"
 
@@ -184,6 +185,71 @@ TEST_F(LogRecord_TEST, Start_zlib)
   }
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that compressed chunks written by the worker threads are
+/// read back in order by LogPlay.
+TEST_F(LogRecord_TEST, CompressionRoundTrip)
+{
+  gazebo::util::LogRecord *recorder = gazebo::util::LogRecord::Instance();
+
+  for (auto const &encoding : {"zlib", "bz2"})
+  {
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+
+    EXPECT_TRUE(recorder->Init("test"));
+
+    // One frame per chunk, identified by its sim time
+    int frames = 0;
+    recorder->Add("round_trip", "state.log",
+        [&frames](std::ostringstream &_stream)
+        {
+          _stream << "<sdf version='1.6'><state><sim_time>" << frames
+                  << " 0</sim_time></state></sdf>\n";
+          ++frames;
+          return true;
+        });
+
+    gazebo::util::LogRecordParams params;
+    params.encoding = encoding;
+    params.path = path.string();
+    params.compressionLevel = 9;
+    params.workers = 3;
+    EXPECT_TRUE(recorder->Start(params));
+
+    for (int i = 0; i < 50; ++i)
+    {
+      recorder->Notify();
+      gazebo::common::Time::MSleep(5);
+    }
+
+    recorder->Stop();
+    while (!recorder->IsReadyToStart())
+      gazebo::common::Time::MSleep(100);
+    recorder->Remove("round_trip");
+
+    gazebo::util::LogPlay *player = gazebo::util::LogPlay::Instance();
+    EXPECT_NO_THROW(player->Open((path / "state.log").string()));
+    ASSERT_TRUE(player->IsOpen());
+    EXPECT_EQ(static_cast<unsigned int>(frames), player->ChunkCount());
+    EXPECT_EQ(gazebo::common::Time(0, 0), player->LogStartTime());
+    EXPECT_EQ(gazebo::common::Time(frames - 1, 0), player->LogEndTime());
+
+    // Every frame is read back, in order
+    std::string frame;
+    for (int i = 0; i < frames; ++i)
+    {
+      ASSERT_TRUE(player->Step(frame));
+      EXPECT_NE(frame.find("<sim_time>" + std::to_string(i) + " 0"),
+          std::string::npos) << frame;
+    }
+    EXPECT_FALSE(player->Step(frame));
+    EXPECT_EQ(encoding, player->Encoding());
+
+    boost::filesystem::remove_all(path);
+  }
+}
+
 /////////////////////////////////////////////////
 /// \brief Test LogRecord filter
 TEST_F(LogRecord_TEST, Filter)
@@ -15,9 +15,7 @@
  *
 */
 
-#include "ignition/common/Profiler.hh"
 #include "gazebo/common/Assert.hh"
-#include "gazebo/common/Events.hh"
 #include "plugins/BuoyancyPlugin.hh"
 
 using namespace gazebo;
@@ -47,6 +45,13 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
     this->fluidDensity = this->sdf->Get<double>("fluid_density");
   }
 
+  if (this->sdf->HasElement("water_level"))
+  {
+    double level = this->sdf->Get<double>("water_level");
+    world->Hydrodynamics().SetWaterPlane(
+        ignition::math::Planed(ignition::math::Vector3d::UnitZ, level));
+  }
+
   // Get "center of volume" and "volume" that were inputted in SDF
   // SDF input is recommended for mesh or polylines collision shapes
   if (this->sdf->HasElement("link"))
@@ -76,19 +81,43 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
         continue;
       }
 
-      if (this->volPropsMap.count(id) != 0)
+      if (this->linkPropsMap.count(id) != 0)
       {
         gzwarn << "Properties for link [" << name << "] already set, skipping "
                << "second property block" << std::endl;
+        continue;
       }
 
-      if (linkElem->HasElement("center_of_volume"))
+      physics::HydrodynamicsProperties &props = this->linkPropsMap[id];
+      if (linkElem->HasElement("linear_drag"))
       {
-        ignition::math::Vector3d cov = linkElem->GetElement("center_of_volume")
+        props.linearDrag = linkElem->GetElement("linear_drag")
             ->Get<ignition::math::Vector3d>();
-        this->volPropsMap[id].cov = cov;
       }
-      else
+      if (linkElem->HasElement("quadratic_drag"))
+      {
+        props.quadraticDrag = linkElem->GetElement("quadratic_drag")
+            ->Get<ignition::math::Vector3d>();
+      }
+      if (linkElem->HasElement("angular_drag"))
+      {
+        props.angularDrag = linkElem->GetElement("angular_drag")
+            ->Get<ignition::math::Vector3d>();
+      }
+      if (linkElem->HasElement("added_mass"))
+      {
+        props.addedMass = linkElem->GetElement("added_mass")
+            ->Get<ignition::math::Vector3d>();
+      }
+
+      // Without volume, the collision shapes are used
+      if (!linkElem->HasElement("center_of_volume") &&
+          !linkElem->HasElement("volume"))
+      {
+        continue;
+      }
+
+      if (!linkElem->HasElement("center_of_volume"))
       {
         gzwarn << "Required element center_of_volume missing from link ["
                << name
@@ -96,50 +125,24 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
         continue;
       }
 
-      if (linkElem->HasElement("volume"))
-      {
-        double volume = linkElem->GetElement("volume")->Get<double>();
-        if (volume <= 0)
-        {
-          gzwarn << "Nonpositive volume specified in BuoyancyPlugin!"
-                 << std::endl;
-          // Remove the element from the map since it's invalid.
-          this->volPropsMap.erase(id);
-          continue;
-        }
-        this->volPropsMap[id].volume = volume;
-      }
-      else
+      if (!linkElem->HasElement("volume"))
       {
         gzwarn << "Required element volume missing from element link [" << name
                << "] in BuoyancyPlugin SDF" << std::endl;
         continue;
       }
-    }
-  }
-
-  // For links the user didn't input, precompute the center of volume and
-  // density. This will be accurate for simple shapes.
-  for (auto link : this->model->GetLinks())
-  {
-    int id = link->GetId();
-    if (this->volPropsMap.find(id) == this->volPropsMap.end())
-    {
-      double volumeSum = 0;
-      ignition::math::Vector3d weightedPosSum = ignition::math::Vector3d::Zero;
 
-      // The center of volume of the link is a weighted average over the pose
-      // of each collision shape, where the weight is the volume of the shape
-      for (auto collision : link->GetCollisions())
+      double volume = linkElem->GetElement("volume")->Get<double>();
+      if (volume <= 0)
       {
-        double volume = collision->GetShape()->ComputeVolume();
-        volumeSum += volume;
-        weightedPosSum += volume*collision->WorldPose().Pos();
+        gzwarn << "Nonpositive volume specified in BuoyancyPlugin!"
+               << std::endl;
+        continue;
       }
-      // Subtract the center of volume into the link frame.
-      this->volPropsMap[id].cov =
-          weightedPosSum/volumeSum - link->WorldPose().Pos();
-      this->volPropsMap[id].volume = volumeSum;
+
+      this->volPropsMap[id].cov = linkElem->GetElement("center_of_volume")
+          ->Get<ignition::math::Vector3d>();
+      this->volPropsMap[id].volume = volume;
     }
   }
 }
@@ -147,34 +150,22 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 /////////////////////////////////////////////////
 void BuoyancyPlugin::Init()
 {
-  this->updateConnection = event::Events::ConnectWorldUpdateBegin(
-      std::bind(&BuoyancyPlugin::OnUpdate, this));
-}
+  physics::Hydrodynamics &hydrodynamics =
+      this->model->GetWorld()->Hydrodynamics();
 
-/////////////////////////////////////////////////
-void BuoyancyPlugin::OnUpdate()
-{
-  IGN_PROFILE("BuoyancyPlugin::OnUpdate");
-  IGN_PROFILE_BEGIN("Update");
   for (auto link : this->model->GetLinks())
   {
-    VolumeProperties volumeProperties = this->volPropsMap[link->GetId()];
-    double volume = volumeProperties.volume;
-    GZ_ASSERT(volume > 0, "Nonpositive volume found in volume properties!");
-
-    // By Archimedes' principle,
-    // buoyancy = -(mass*gravity)*fluid_density/object_density
-    // object_density = mass/volume, so the mass term cancels.
-    // Therefore,
-    ignition::math::Vector3d buoyancy =
-        -this->fluidDensity * volume * this->model->GetWorld()->Gravity();
-
-    ignition::math::Pose3d linkFrame = link->WorldPose();
-    // rotate buoyancy into the link frame before applying the force.
-    ignition::math::Vector3d buoyancyLinkFrame =
-        linkFrame.Rot().Inverse().RotateVector(buoyancy);
-
-    link->AddLinkForce(buoyancyLinkFrame, volumeProperties.cov);
+    int id = link->GetId();
+    physics::HydrodynamicsProperties &props = this->linkPropsMap[id];
+    props.fluidDensity = this->fluidDensity;
+
+    auto volProps = this->volPropsMap.find(id);
+    if (volProps != this->volPropsMap.end())
+    {
+      props.volume = volProps->second.volume;
+      props.centerOfVolume = volProps->second.cov;
+    }
+
+    hydrodynamics.AddLink(link, props);
   }
-  IGN_PROFILE_END();
 }
@@ -21,7 +21,6 @@
 #include <map>
 #include <ignition/math/Vector3.hh>
 
-#include "gazebo/common/Event.hh"
 #include "gazebo/common/Plugin.hh"
 #include "gazebo/physics/physics.hh"
 
@@ -40,41 +39,46 @@ namespace gazebo
     public: double volume;
   };
 
-  /// \brief A plugin that simulates buoyancy of an object immersed in fluid.
+  /// \brief A plugin that registers the links of a model with the world's
+  /// physics::Hydrodynamics engine, which applies buoyancy, drag and added
+  /// mass to all registered links in one pass per iteration.
   /// All SDF parameters are optional.
   /// <fluid_density> sets the density of the fluid that surrounds the buoyant
   /// object.
-  /// <link> elements describe the volume properties of individual links in the
+  /// <water_level> sets the height of a horizontal water plane, shared by
+  /// the whole world. Without it, the fluid fills the world and links are
+  /// always fully submerged.
+  /// <link> elements describe the properties of individual links in the
   /// model. For example:
   /// <link name="body">
   ///   <center_of_volume>1 2 3</center_of_volume>
   ///   <volume>50</volume>
+  ///   <linear_drag>10 10 20</linear_drag>
+  ///   <quadratic_drag>5 5 10</quadratic_drag>
+  ///   <angular_drag>1 1 1</angular_drag>
+  ///   <added_mass>2 2 4</added_mass>
   /// </link>
   /// <center_of_volume> A point representing the volumetric center of the
   /// link in the link frame. This is where the buoyancy force will be applied.
-  /// <volume> The volume of the link in kg/m^3.
-  /// If center of volume and volume are not specified, the plugin will attempt
-  /// to compute these properties from the link collision shapes. This
-  /// computation will not be accurate if the object is not composed of simple
-  /// collision shapes.
+  /// <volume> The volume of the link in m^3.
+  /// If center of volume and volume are not specified, the submerged volume
+  /// and center of buoyancy are computed from the link collision shapes.
+  /// Boxes, spheres and cylinders are exact, other shapes are approximated
+  /// by a sphere of the same volume.
+  /// <linear_drag>, <quadratic_drag>, <angular_drag> and <added_mass> are
+  /// per axis of the link frame, and default to zero.
   class GZ_PLUGIN_VISIBLE BuoyancyPlugin : public ModelPlugin
   {
     /// \brief Constructor.
     public: BuoyancyPlugin();
 
-    /// \brief Read the model SDF to compute volume and center of volume for
-    /// each link, and store those properties in volPropsMap.
+    /// \brief Read the model SDF to get the volume, center of volume and
+    /// drag coefficients of each link.
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
 
     // Documentation inherited
     public: virtual void Init();
 
-    /// \brief Callback for World Update events.
-    protected: virtual void OnUpdate();
-
-    /// \brief Connection to World Update events.
-    protected: event::ConnectionPtr updateConnection;
-
     /// \brief Pointer to model containing the plugin.
     protected: physics::ModelPtr model;
 
@@ -86,9 +90,13 @@ namespace gazebo
     protected: double fluidDensity;
 
     /// \brief Map of <link ID, point> pairs mapping link IDs to the CoV (center
-    /// of volume) and volume of the link.
+    /// of volume) and volume of the link, for links whose volume is given in
+    /// SDF.
     protected: std::map<int, VolumeProperties> volPropsMap;
+
+    /// \brief Map of link IDs to the fluid properties registered with the
+    /// hydrodynamics engine.
+    protected: std::map<int, physics::HydrodynamicsProperties> linkPropsMap;
   };
 }
-
 #endif
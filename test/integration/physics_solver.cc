@@ -15,12 +15,14 @@
  *
  */
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ode_inc.h"
 #include "SimplePendulumIntegrator.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/test/helper_physics_generator.hh"
@@ -121,6 +123,210 @@ TEST_P(PhysicsTest, DropTest)
 INSTANTIATE_TEST_CASE_P(WorldStepSolvers, PhysicsTest,
                         WORLD_STEP_SOLVERS,);  // NOLINT
 
+/// \brief Result of a run of the colored solver tests.
+struct SolverRun
+{
+  /// \brief Mean RMS residual of the contact normal rows.
+  double residual;
+
+  /// \brief Final pose of each model.
+  std::map<std::string, ignition::math::Pose3d> poses;
+};
+
+class ColoredSolverTest : public ServerFixture
+{
+  /// \brief Run the world from its initial state.
+  /// \param[in] _solverType Solver type, quick or colored_quick.
+  /// \param[in] _threads Threads of the colored solver.
+  /// \return Residual and final poses of the run.
+  public: SolverRun Run(const std::string &_solverType, const int _threads);
+
+  /// \brief Check that the colored solver reaches the accuracy of the
+  /// serial one on the loaded world, whatever its number of threads.
+  public: void Parity();
+};
+
+////////////////////////////////////////////////////////////////////////
+SolverRun ColoredSolverTest::Run(const std::string &_solverType,
+    const int _threads)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  physics::PhysicsEnginePtr physics = world->Physics();
+  world->Reset();
+
+  EXPECT_TRUE(physics->SetParam("solver_type", _solverType));
+  EXPECT_TRUE(physics->SetParam("colored_quick_threads", _threads));
+
+  const unsigned int settleSteps = 500;
+  const unsigned int steps = 1000;
+  world->Step(settleSteps);
+
+  SolverRun run;
+  run.residual = 0;
+  for (unsigned int i = 0; i < steps; ++i)
+  {
+    world->Step(1);
+    dReal *residual =
+      boost::any_cast<dReal*>(physics->GetParam("constraint_residual"));
+    run.residual += residual[1] / steps;
+  }
+
+  for (auto const &model : world->Models())
+    run.poses[model->GetName()] = model->WorldPose();
+  return run;
+}
+
+////////////////////////////////////////////////////////////////////////
+void ColoredSolverTest::Parity()
+{
+  SolverRun serial = this->Run("quick", 0);
+  SolverRun colored1 = this->Run("colored_quick", 1);
+  SolverRun colored = this->Run("colored_quick", 2);
+  SolverRun colored4 = this->Run("colored_quick", 4);
+
+  gzdbg << "residual quick " << serial.residual
+        << " colored_quick " << colored.residual << std::endl;
+
+  // the rows are solved in another order, so the error is of the same
+  // magnitude rather than the same
+  EXPECT_LT(colored.residual, 2 * serial.residual + 1e-6);
+
+  ASSERT_EQ(serial.poses.size(), colored.poses.size());
+  for (auto const &pose : serial.poses)
+  {
+    const ignition::math::Pose3d &other = colored.poses[pose.first];
+    EXPECT_LT((pose.second.Pos() - other.Pos()).Length(), PHYSICS_TOL)
+      << pose.first;
+
+    // the blocks of a color touch disjoint bodies, so the solution does
+    // not depend on the number of threads, one included
+    EXPECT_EQ(other, colored1.poses[pose.first]) << pose.first;
+    EXPECT_EQ(other, colored4.poses[pose.first]) << pose.first;
+  }
+  EXPECT_DOUBLE_EQ(colored.residual, colored1.residual);
+  EXPECT_DOUBLE_EQ(colored.residual, colored4.residual);
+}
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ColoredSolverTest, Stacks)
+{
+  Load("worlds/stacks.world", true, "ode");
+  this->Parity();
+}
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ColoredSolverTest, DropTest)
+{
+  Load("worlds/drop_test.world", true, "ode");
+  this->Parity();
+}
+
+////////////////////////////////////////////////////////////////////////
+TEST_F(ColoredSolverTest, BoxStack)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+
+  // a single island with enough rows for the colored solver
+  for (unsigned int i = 0; i < 12; ++i)
+  {
+    std::string name = "box_" + std::to_string(i);
+    SpawnBox(name, ignition::math::Vector3d(0.2, 0.2, 0.2),
+        ignition::math::Vector3d(0, 0, 0.1 + 0.2 * i),
+        ignition::math::Vector3d::Zero);
+    world->ModelByName(name)->SetAutoDisable(false);
+  }
+  this->Parity();
+}
+
+/// \brief Result of a run of the sparse solver tests.
+struct ChainRun
+{
+  /// \brief Largest anchor error of the hinge joints over the run.
+  double drift;
+
+  /// \brief Final position of each joint.
+  std::map<std::string, double> positions;
+};
+
+class SparseSolverTest : public ServerFixture
+{
+  /// \brief Drive the joints of simple_arm from its initial state.
+  /// \param[in] _solverType Solver type: world, quick or sparse_quick.
+  /// \return Drift and final joint positions of the run.
+  public: ChainRun Run(const std::string &_solverType);
+};
+
+////////////////////////////////////////////////////////////////////////
+ChainRun SparseSolverTest::Run(const std::string &_solverType)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  physics::PhysicsEnginePtr physics = world->Physics();
+  world->Reset();
+
+  EXPECT_TRUE(physics->SetParam("solver_type", _solverType));
+
+  physics::ModelPtr model = world->ModelByName("simple_arm");
+  physics::JointPtr shoulder = model->GetJoint("arm_shoulder_pan_joint");
+  physics::JointPtr elbow = model->GetJoint("arm_elbow_pan_joint");
+
+  const unsigned int steps = 1000;
+  ChainRun run;
+  run.drift = 0;
+  for (unsigned int i = 0; i < steps; ++i)
+  {
+    shoulder->SetForce(0, 1.0);
+    elbow->SetForce(0, -0.5);
+    world->Step(1);
+
+    // the prismatic joint moves its anchors apart along its axis, so only
+    // the hinges measure the constraint error
+    for (auto const &joint : model->GetJoints())
+    {
+      if (joint->HasType(physics::Base::HINGE_JOINT))
+      {
+        run.drift = std::max(run.drift,
+            joint->AnchorErrorPose().Pos().Length());
+      }
+    }
+  }
+
+  for (auto const &joint : model->GetJoints())
+    run.positions[joint->GetName()] = joint->Position(0);
+  return run;
+}
+
+////////////////////////////////////////////////////////////////////////
+// The sparse solver follows the world step on a serial chain resting on
+// the ground, where quick only approximates its joint rows.
+TEST_F(SparseSolverTest, SimpleArm)
+{
+  Load("worlds/simple_arm_test.world", true, "ode");
+
+  ChainRun exact = this->Run("world");
+  ChainRun quick = this->Run("quick");
+  ChainRun sparse = this->Run("sparse_quick");
+
+  gzdbg << "anchor drift world " << exact.drift
+        << " quick " << quick.drift
+        << " sparse_quick " << sparse.drift << std::endl;
+
+  // the contacts of the base are still solved by PGS, so the drift is of
+  // the same magnitude as the world step rather than the same
+  EXPECT_LT(sparse.drift, 2 * exact.drift + 1e-6);
+  EXPECT_LT(sparse.drift, 2 * quick.drift + 1e-6);
+
+  ASSERT_EQ(exact.positions.size(), sparse.positions.size());
+  ASSERT_EQ(exact.positions.size(), quick.positions.size());
+  for (auto const &position : exact.positions)
+  {
+    EXPECT_NEAR(position.second, sparse.positions[position.first],
+        PHYSICS_TOL) << position.first;
+    EXPECT_NEAR(position.second, quick.positions[position.first],
+        PHYSICS_TOL) << position.first;
+  }
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -18,6 +18,12 @@
 #ifndef _WIN32
 #include <unistd.h>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -788,6 +794,204 @@ TEST_F(TransportTest, TryInit)
   EXPECT_EQ(physics::get_world()->Name(), node->GetTopicNamespace());
 }
 
+/////////////////////////////////////////////////
+/// \brief Subscriber with a slow callback.
+class SlowSubscriber
+{
+  /// \brief Callback which sleeps on the first message.
+  /// \param[in] _msg Message received.
+  public: void OnMsg(ConstVector3dPtr &_msg)
+          {
+            if (this->count++ == 0)
+              common::Time::MSleep(500);
+            this->last = _msg->x();
+          }
+
+  /// \brief Number of messages received.
+  public: std::atomic<int> count{0};
+
+  /// \brief Last value received.
+  public: std::atomic<double> last{-1.0};
+};
+
+/////////////////////////////////////////////////
+TEST_F(TransportTest, QueuedSubscription)
+{
+  Load("worlds/empty.world");
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr pub =
+    node->Advertise<msgs::Vector3d>("~/test/queued");
+
+  // A dedicated thread, which only keeps the latest message
+  SlowSubscriber slow;
+  transport::SubscribeOptions ops;
+  ops.SetExecutor(transport::SubscribeOptions::DEDICATED);
+  ops.SetQueuePolicy(transport::SubscribeOptions::KEEP_LATEST, 1);
+  transport::SubscriberPtr slowSub = node->Subscribe("~/test/queued",
+      &SlowSubscriber::OnMsg, &slow, ops);
+
+  // Subscription with the default executor doesn't have a queue
+  transport::SubscriberPtr stringSub = node->Subscribe("~/test/string",
+      &ReceiveStringMsg4);
+  transport::SubscriptionQueueStats stats;
+  EXPECT_FALSE(stringSub->QueueStats(stats));
+
+  pub->WaitForConnection();
+  msgs::Vector3d msg;
+  msgs::Set(&msg, ignition::math::Vector3d(0, 0, 0));
+  pub->Publish(msg);
+  for (int i = 0; i < 100 && slow.count == 0; ++i)
+    common::Time::MSleep(10);
+  ASSERT_EQ(1, slow.count);
+
+  // While the callback sleeps, the other topics are still delivered
+  g_stringMsg4 = false;
+  transport::PublisherPtr stringPub =
+    node->Advertise<msgs::GzString>("~/test/string");
+  stringPub->WaitForConnection();
+  msgs::GzString stringMsg;
+  stringMsg.set_data("hello");
+  stringPub->Publish(stringMsg);
+  for (int i = 0; i < 20 && !g_stringMsg4; ++i)
+    common::Time::MSleep(10);
+  EXPECT_TRUE(g_stringMsg4);
+  EXPECT_EQ(1, slow.count);
+
+  // A burst collapses to the latest message
+  for (int i = 1; i <= 10; ++i)
+  {
+    msgs::Set(&msg, ignition::math::Vector3d(i, 0, 0));
+    pub->Publish(msg);
+  }
+  for (int i = 0; i < 200 && slow.last < 10.0; ++i)
+    common::Time::MSleep(10);
+  EXPECT_DOUBLE_EQ(10.0, slow.last);
+  EXPECT_LT(slow.count, 11);
+
+  ASSERT_TRUE(slowSub->QueueStats(stats));
+  EXPECT_EQ(11u, stats.received);
+  EXPECT_EQ(stats.received, stats.delivered + stats.dropped);
+  EXPECT_GT(stats.dropped, 0u);
+  EXPECT_EQ(0u, stats.depth);
+  EXPECT_EQ(1u, stats.maxDepth);
+
+  slowSub.reset();
+  stringSub.reset();
+}
+
+/////////////////////////////////////////////////
+/// \brief Read packets from a connection until one of the given types
+/// announces a publisher of a topic.
+/// \param[in] _conn Connection to the master.
+/// \param[in] _topic Topic of the publisher.
+/// \param[out] _pub The publisher.
+/// \return True if the publisher was announced.
+static bool readPublisher(transport::ConnectionPtr _conn,
+    const std::string &_topic, msgs::Publish &_pub)
+{
+  std::string data;
+  while (_conn->Read(data))
+  {
+    msgs::Packet packet;
+    packet.ParseFromString(data);
+    if (packet.type() == "publisher_subscribe" ||
+        packet.type() == "publisher_advertise")
+    {
+      _pub.ParseFromString(packet.serialized_data());
+      if (_pub.topic() == _topic)
+        return true;
+    }
+  }
+  return false;
+}
+
+/////////////////////////////////////////////////
+// The transport threads are woken up by events, so a message published
+// right after advertising reaches a remote subscriber without waiting for
+// a polling period. The subscriber is a raw connection to the master, as
+// another process would open, so the time includes the advertisement
+// through the master, the connection to the publisher, and the
+// subscription. Polling loops of 10 ms in the master, and of 100 ms in
+// the connection manager and in WaitForConnection, took more than 100 ms.
+TEST_F(TransportTest, AdvertiseLatency)
+{
+  Load("worlds/empty.world");
+
+  std::string masterHost;
+  unsigned int masterPort;
+  ASSERT_TRUE(transport::get_master_uri(masterHost, masterPort));
+
+  // Skip the version, namespaces and publishers sent on connection
+  transport::ConnectionPtr masterConn(new transport::Connection());
+  ASSERT_TRUE(masterConn->Connect(masterHost, masterPort));
+  std::string data;
+  for (int i = 0; i < 3; ++i)
+    ASSERT_TRUE(masterConn->Read(data));
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+
+  msgs::GzString msg;
+  msg.set_data("hello");
+
+  std::vector<double> latencies;
+  for (int i = 0; i < 20; ++i)
+  {
+    std::string topic = node->DecodeTopicName(
+        "~/test/latency" + std::to_string(i));
+
+    common::Time start = common::Time::GetWallTime();
+    transport::PublisherPtr pub = node->Advertise<msgs::GzString>(topic);
+    std::thread publisher([&]()
+        {
+          if (pub->WaitForConnection(common::Time(5, 0)))
+            pub->Publish(msg);
+        });
+
+    // Subscribe through the master, which answers with the publisher
+    // whichever of the advertisement and the subscription comes first
+    msgs::Subscribe sub;
+    sub.set_topic(topic);
+    sub.set_msg_type(msg.GetTypeName());
+    sub.set_host(masterConn->GetLocalAddress());
+    sub.set_port(masterConn->GetLocalPort());
+    masterConn->EnqueueMsg(msgs::Package("subscribe", sub));
+
+    msgs::Publish pubMsg;
+    bool announced = readPublisher(masterConn, topic, pubMsg);
+
+    // Connect to the publisher, and read the first message
+    transport::ConnectionPtr pubConn(new transport::Connection());
+    bool received = false;
+    if (announced && pubConn->Connect(pubMsg.host(), pubMsg.port()))
+    {
+      msgs::Subscribe pubSub(sub);
+      pubSub.set_host(pubConn->GetLocalAddress());
+      pubSub.set_port(pubConn->GetLocalPort());
+      pubConn->EnqueueMsg(msgs::Package("sub", pubSub));
+
+      msgs::GzString first;
+      received = pubConn->Read(data) && first.ParseFromString(data) &&
+        first.data() == msg.data();
+    }
+    latencies.push_back((common::Time::GetWallTime() - start).Double());
+
+    publisher.join();
+    pubConn->Shutdown();
+    masterConn->EnqueueMsg(msgs::Package("unsubscribe", sub));
+
+    ASSERT_TRUE(announced);
+    ASSERT_TRUE(received);
+  }
+
+  masterConn->Shutdown();
+
+  std::sort(latencies.begin(), latencies.end());
+  EXPECT_LT(latencies[latencies.size() / 2], 0.05);
+}
+
 /////////////////////////////////////////////////
 // Main
 int main(int argc, char **argv)
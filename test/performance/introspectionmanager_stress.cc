@@ -16,6 +16,7 @@
 */
 #include <gtest/gtest.h>
 
+#include "gazebo/util/IntrospectionClient.hh"
 #include "gazebo/util/IntrospectionManager.hh"
 #include "gazebo/test/ServerFixture.hh"
 
@@ -92,4 +93,59 @@ TEST_F(IntrospectionManagerTest, IntrospectionManagerStressTest)
   // Not exactly median, but really close.
   std::cerr << "Median: " << times[n/2] << std::endl;
   std::cerr << "Mean: " << sum / static_cast<double>(n) << std::endl;
+
+  // Without observers, updating must not depend on the number of registered
+  // items.
+  EXPECT_LT(times[n/2], 1e-4);
+}
+
+/////////////////////////////////////////////////
+TEST_F(IntrospectionManagerTest, IntrospectionManagerObservedStressTest)
+{
+  const size_t kItems = 10000;
+  const size_t kObserved = 100;
+  for (size_t ii = 0; ii < kItems; ++ii)
+  {
+    std::stringstream ss;
+    ss << "item" << ii;
+    EXPECT_TRUE(this->manager->Register<double>(ss.str(),
+        [ii]() { return static_cast<double>(ii); }));
+  }
+
+  // Observe a few items through a filter.
+  util::IntrospectionClient client;
+  std::set<std::string> items;
+  for (size_t ii = 0; ii < kObserved; ++ii)
+    items.insert("item" + std::to_string(ii * (kItems / kObserved)));
+
+  std::string filterId;
+  std::string topic;
+  ASSERT_TRUE(client.NewFilter(this->manager->Id(), items, filterId, topic));
+
+  // Publish at a low rate, samples are buffered in the meantime.
+  this->manager->SetNotifyRate(10.0);
+  EXPECT_DOUBLE_EQ(10.0, this->manager->NotifyRate());
+
+  std::vector<double> times;
+  for (size_t ii = 0; ii < 1000; ++ii)
+  {
+    common::Time startTime = common::Time::GetWallTime();
+    this->manager->Update();
+    common::Time endTime = common::Time::GetWallTime();
+    times.push_back((endTime - startTime).Double());
+  }
+
+  auto n = times.size();
+  std::sort(times.begin(), times.end());
+  auto sum = std::accumulate(times.begin(), times.end(), 0.0);
+
+  std::cerr << "Samples: " << n << std::endl;
+  std::cerr << "Max: " << times.back() << std::endl;
+  std::cerr << "Min: " << times.front() << std::endl;
+  std::cerr << "Median: " << times[n/2] << std::endl;
+  std::cerr << "Mean: " << sum / static_cast<double>(n) << std::endl;
+  std::cerr << "Dropped: " << this->manager->DroppedSamples() << std::endl;
+
+  EXPECT_TRUE(client.RemoveFilter(this->manager->Id(), filterId));
+  this->manager->SetNotifyRate(0.0);
 }
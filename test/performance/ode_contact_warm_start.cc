@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Iteration counts of the sweep.
+static const std::vector<int> kIters = {5, 10, 20, 40, 80, 160};
+
+/// \brief Iteration count of the reference run.
+static const int kReferenceIters = 200;
+
+/// \brief Steps before measuring, for the contacts to settle.
+static const unsigned int kSettleSteps = 200;
+
+/// \brief Measured steps.
+static const unsigned int kSteps = 500;
+
+/// \brief Result of a run.
+struct Accuracy
+{
+  /// \brief Mean RMS residual of the contact normal rows.
+  double residual;
+
+  /// \brief Distance travelled by the tracked model.
+  double drift;
+};
+
+class ODEContactWarmStartTest : public ServerFixture
+{
+  /// \brief Spawn a stack of boxes.
+  /// \param[in] _count Number of boxes.
+  public: void SpawnStack(const unsigned int _count);
+
+  /// \brief Spawn a box held in the air between two paddles.
+  public: void SpawnGrasp();
+
+  /// \brief Run the world from its initial state.
+  /// \param[in] _iters PGS iterations.
+  /// \param[in] _cache True to warm start the contacts.
+  /// \param[in] _model Model whose drift is measured.
+  /// \return Accuracy of the run.
+  public: Accuracy Run(const int _iters, const bool _cache,
+              const std::string &_model);
+
+  /// \brief Sweep the iterations with and without warm starting and
+  /// check that warm starting reaches the reference accuracy with no more
+  /// iterations.
+  /// \param[in] _scene Name of the scene.
+  /// \param[in] _model Model whose drift is measured.
+  public: void Sweep(const std::string &_scene, const std::string &_model);
+
+  /// \brief Forces pressing the paddles against the box, applied before
+  /// each step. Empty when there are no paddles.
+  private: std::vector<std::pair<physics::LinkPtr,
+           ignition::math::Vector3d> > forces;
+};
+
+/////////////////////////////////////////////////
+void ODEContactWarmStartTest::SpawnStack(const unsigned int _count)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    std::string name = "box_" + std::to_string(i);
+    SpawnBox(name, ignition::math::Vector3d(0.2, 0.2, 0.2),
+        ignition::math::Vector3d(0, 0, 0.1 + 0.2 * i),
+        ignition::math::Vector3d::Zero);
+    world->ModelByName(name)->SetAutoDisable(false);
+  }
+}
+
+/////////////////////////////////////////////////
+void ODEContactWarmStartTest::SpawnGrasp()
+{
+  physics::WorldPtr world = physics::get_world("default");
+  SpawnBox("object", ignition::math::Vector3d(0.1, 0.1, 0.1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  SpawnBox("left", ignition::math::Vector3d(0.02, 0.2, 0.2),
+      ignition::math::Vector3d(-0.06, 0, 0.5),
+      ignition::math::Vector3d::Zero);
+  SpawnBox("right", ignition::math::Vector3d(0.02, 0.2, 0.2),
+      ignition::math::Vector3d(0.06, 0, 0.5),
+      ignition::math::Vector3d::Zero);
+
+  for (auto const &name : {"object", "left", "right"})
+    world->ModelByName(name)->SetAutoDisable(false);
+
+  // The paddles float and squeeze the object, which friction holds
+  for (auto const &name : {"left", "right"})
+  {
+    physics::LinkPtr link = world->ModelByName(name)->GetLink();
+    link->SetGravityMode(false);
+    this->forces.push_back(std::make_pair(link, ignition::math::Vector3d(
+            std::string(name) == "left" ? 50 : -50, 0, 0)));
+  }
+}
+
+/////////////////////////////////////////////////
+Accuracy ODEContactWarmStartTest::Run(const int _iters, const bool _cache,
+    const std::string &_model)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  physics::PhysicsEnginePtr physics = world->Physics();
+  world->Reset();
+
+  EXPECT_TRUE(physics->SetParam("iters", _iters));
+  EXPECT_TRUE(physics->SetParam("contact_warm_start", _cache));
+
+  physics::LinkPtr link = world->ModelByName(_model)->GetLink();
+  auto step = [&]()
+  {
+    for (auto const &force : this->forces)
+      force.first->SetForce(force.second);
+    world->Step(1);
+  };
+
+  for (unsigned int i = 0; i < kSettleSteps; ++i)
+    step();
+
+  ignition::math::Vector3d start = link->WorldPose().Pos();
+  Accuracy accuracy = {0, 0};
+  for (unsigned int i = 0; i < kSteps; ++i)
+  {
+    step();
+    dReal *residual =
+      boost::any_cast<dReal*>(physics->GetParam("constraint_residual"));
+    accuracy.residual += residual[1] / kSteps;
+  }
+  accuracy.drift = (link->WorldPose().Pos() - start).Length();
+  return accuracy;
+}
+
+/////////////////////////////////////////////////
+void ODEContactWarmStartTest::Sweep(const std::string &_scene,
+    const std::string &_model)
+{
+  physics::WorldPtr world = physics::get_world("default");
+  physics::PhysicsEnginePtr physics = world->Physics();
+  EXPECT_TRUE(physics->SetParam("warm_start_factor", 1.0));
+
+  Accuracy reference = this->Run(kReferenceIters, false, _model);
+  double tolerance = 2 * reference.residual + 1e-6;
+
+  std::ostringstream table;
+  table << _scene << ": reference residual " << reference.residual
+    << " drift " << reference.drift << "\n"
+    << std::setw(6) << "iters"
+    << std::setw(14) << "residual" << std::setw(14) << "drift"
+    << std::setw(14) << "residual ws" << std::setw(14) << "drift ws"
+    << "\n";
+
+  // Fewest iterations reaching the reference accuracy
+  int itersOff = kReferenceIters;
+  int itersOn = kReferenceIters;
+  for (auto const iters : kIters)
+  {
+    Accuracy off = this->Run(iters, false, _model);
+    Accuracy on = this->Run(iters, true, _model);
+    table << std::setw(6) << iters
+      << std::setw(14) << off.residual << std::setw(14) << off.drift
+      << std::setw(14) << on.residual << std::setw(14) << on.drift << "\n";
+
+    if (off.residual <= tolerance && itersOff == kReferenceIters)
+      itersOff = iters;
+    if (on.residual <= tolerance && itersOn == kReferenceIters)
+      itersOn = iters;
+  }
+  std::cout << table.str() << "iterations to reference accuracy: "
+    << itersOff << " without warm start, " << itersOn << " with\n";
+
+  EXPECT_GT(boost::any_cast<uint64_t>(
+        physics->GetParam("contact_warm_start_matches")), 0u);
+  EXPECT_LE(itersOn, itersOff);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEContactWarmStartTest, BoxStack)
+{
+  Load("worlds/empty.world", true, "ode");
+  this->SpawnStack(12);
+  this->Sweep("box stack", "box_11");
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEContactWarmStartTest, Grasp)
+{
+  Load("worlds/empty.world", true, "ode");
+  this->SpawnGrasp();
+  this->Sweep("grasp", "object");
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
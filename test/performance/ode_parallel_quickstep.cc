@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gazebo/ode/ode.h>
+#include <parallel_quickstep/parallel_quickstep.h>
+
+/// \brief Boxes in each stack.
+static const int kHeight = 4;
+
+/// \brief Side of the box.
+static const double kSize = 0.2;
+
+/// \brief Steps before measuring, for the contacts to settle.
+static const int kSettleSteps = 200;
+
+/// \brief Measured steps.
+static const int kSteps = 300;
+
+/// \brief PGS iterations.
+static const int kIters = 50;
+
+/// \brief A world of box stacks on a plane.
+class StackWorld
+{
+  /// \brief Constructor.
+  /// \param[in] _grid The stacks are on a _grid x _grid grid.
+  public: explicit StackWorld(const int _grid)
+  {
+    this->world = dWorldCreate();
+    this->space = dHashSpaceCreate(0);
+    this->contacts = dJointGroupCreate(0);
+    dWorldSetGravity(this->world, 0, 0, -9.8);
+    dWorldSetQuickStepNumIterations(this->world, kIters);
+    dWorldSetERP(this->world, 0.2);
+    dWorldSetCFM(this->world, 0);
+    dWorldSetAutoDisableFlag(this->world, 0);
+    dCreatePlane(this->space, 0, 0, 1, 0);
+
+    for (int x = 0; x < _grid; ++x)
+    {
+      for (int y = 0; y < _grid; ++y)
+      {
+        for (int i = 0; i < kHeight; ++i)
+        {
+          dBodyID body = dBodyCreate(this->world);
+          dMass mass;
+          dMassSetBox(&mass, 1000, kSize, kSize, kSize);
+          dBodySetMass(body, &mass);
+          dBodySetPosition(body, 2.5*kSize*x, 2.5*kSize*y,
+              kSize*(0.5 + i));
+          dGeomID geom = dCreateBox(this->space, kSize, kSize, kSize);
+          dGeomSetBody(geom, body);
+          this->bodies.push_back(body);
+        }
+      }
+    }
+  }
+
+  /// \brief Destructor.
+  public: ~StackWorld()
+  {
+    dJointGroupDestroy(this->contacts);
+    dSpaceDestroy(this->space);
+    dWorldDestroy(this->world);
+  }
+
+  /// \brief Collide and step.
+  /// \param[in] _parallel True to step with dWorldParallelQuickStep.
+  /// \return Seconds spent in the solver.
+  public: double Step(const bool _parallel)
+  {
+    dJointGroupEmpty(this->contacts);
+    dSpaceCollide(this->space, this, &StackWorld::Near);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    if (_parallel)
+      dWorldParallelQuickStep(this->world, 0.001);
+    else
+      dWorldQuickStep(this->world, 0.001);
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  /// \brief Largest distance of a box from its resting height.
+  /// \return Distance in meters.
+  public: double MaxSink() const
+  {
+    double sink = 0;
+    for (unsigned int i = 0; i < this->bodies.size(); ++i)
+    {
+      const double rest = kSize*(0.5 + i % kHeight);
+      sink = std::max(sink,
+          std::abs(dBodyGetPosition(this->bodies[i])[2] - rest));
+    }
+    return sink;
+  }
+
+  /// \brief Add the contacts of two geoms.
+  private: static void Near(void *_data, dGeomID _o1, dGeomID _o2)
+  {
+    StackWorld *self = static_cast<StackWorld *>(_data);
+    dContactGeom geoms[8];
+    int count = dCollide(_o1, _o2, 8, geoms, sizeof(dContactGeom));
+    for (int i = 0; i < count; ++i)
+    {
+      dContact contact;
+      memset(&contact, 0, sizeof(contact));
+      contact.surface.mode = dContactApprox1;
+      contact.surface.mu = 1;
+      contact.geom = geoms[i];
+      dJointID joint = dJointCreateContact(self->world, self->contacts,
+          &contact);
+      dJointAttach(joint, dGeomGetBody(_o1), dGeomGetBody(_o2));
+    }
+  }
+
+  /// \brief The world.
+  private: dWorldID world;
+
+  /// \brief Collision space.
+  private: dSpaceID space;
+
+  /// \brief Contact joints of the current step.
+  private: dJointGroupID contacts;
+
+  /// \brief The boxes.
+  private: std::vector<dBodyID> bodies;
+};
+
+class ODEParallelQuickStepTest : public ::testing::Test
+{
+  protected: virtual void SetUp()
+  {
+    dInitODE2(0);
+    dAllocateODEDataForThread(dAllocateMaskAll);
+  }
+
+  protected: virtual void TearDown()
+  {
+    dCloseODE();
+  }
+
+  /// \brief Settle a grid of stacks and time the following steps.
+  /// \param[in] _grid Side of the grid.
+  /// \param[in] _parallel True for parallel_quick, false for quick.
+  /// \param[out] _sink Largest distance of a box from its resting height.
+  /// \return Milliseconds per step spent in the solver.
+  protected: double Time(const int _grid, const bool _parallel,
+                 double &_sink)
+  {
+    StackWorld stacks(_grid);
+    for (int i = 0; i < kSettleSteps; ++i)
+      stacks.Step(_parallel);
+
+    double seconds = 0;
+    for (int i = 0; i < kSteps; ++i)
+      seconds += stacks.Step(_parallel);
+
+    _sink = stacks.MaxSink();
+    return seconds / kSteps * 1e3;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(ODEParallelQuickStepTest, Threads)
+{
+  dWorldID world = dWorldCreate();
+  EXPECT_EQ(0, dWorldGetParallelQuickStepThreads(world));
+  dWorldSetParallelQuickStepThreads(world, 2);
+  EXPECT_EQ(2, dWorldGetParallelQuickStepThreads(world));
+  dWorldSetParallelQuickStepThreads(world, -1);
+  EXPECT_EQ(0, dWorldGetParallelQuickStepThreads(world));
+
+  // the count belongs to each world
+  dWorldID other = dWorldCreate();
+  dWorldSetParallelQuickStepThreads(world, 3);
+  dWorldSetParallelQuickStepThreads(other, 1);
+  EXPECT_EQ(3, dWorldGetParallelQuickStepThreads(world));
+  EXPECT_EQ(1, dWorldGetParallelQuickStepThreads(other));
+  dWorldDestroy(other);
+  dWorldDestroy(world);
+}
+
+/////////////////////////////////////////////////
+// The solver step of quick and of parallel_quick with 1, 2, 4... threads,
+// up to one per core, as the number of contacts grows. The stacks have to
+// stay up with both.
+TEST_F(ODEParallelQuickStepTest, Scaling)
+{
+  const int cores =
+    std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<int> threads;
+  for (int t = 1; t < cores; t *= 2)
+    threads.push_back(t);
+  threads.push_back(cores);
+
+  std::ostringstream table;
+  table << std::setw(6) << "boxes" << std::setw(10) << "quick";
+  for (auto const t : threads)
+    table << std::setw(14) << ("parallel " + std::to_string(t));
+  table << "  (ms per step, speedup over quick)\n";
+
+  dWorldID world = dWorldCreate();
+  for (auto const grid : {2, 4, 8, 16})
+  {
+    double sink = 0;
+    const double quick = this->Time(grid, false, sink);
+    EXPECT_LT(sink, 0.01) << "quick, grid " << grid;
+    table << std::setw(6) << grid*grid*kHeight << std::setw(10)
+          << std::fixed << std::setprecision(3) << quick;
+
+    for (auto const t : threads)
+    {
+      // the thread count is shared by all worlds
+      dWorldSetParallelQuickStepThreads(world, t);
+      const double parallel = this->Time(grid, true, sink);
+      EXPECT_LT(sink, 0.01) << "parallel_quick, " << t << " threads, grid "
+        << grid;
+      table << std::setw(8) << std::setprecision(3) << parallel
+            << std::setw(6) << std::setprecision(2) << quick / parallel;
+    }
+    table << "\n";
+  }
+  dWorldSetParallelQuickStepThreads(world, 0);
+  dWorldDestroy(world);
+
+  std::cout << table.str();
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "deps/opende/src/quickstep_simd.h"
+
+using namespace ode::quickstep;
+
+/// \brief Number of constraint rows.
+static const int kRows = 4099;
+
+/// \brief Number of bodies.
+static const int kBodies = 1024;
+
+/// \brief Repetitions of each kernel when timing.
+static const int kRepeats = 2000;
+
+/// \brief Random rows of a quickstep problem, laid out like quickstep.
+class ODEQuickStepKernelsTest : public ::testing::Test
+{
+  /// \brief Fill the rows. About one row in four only has a first body,
+  /// its second half is left with NaN as quickstep leaves it unset.
+  protected: virtual void SetUp()
+  {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::uniform_int_distribution<int> body(0, kBodies-1);
+
+    this->J.resize(12*kRows);
+    this->iMJ.resize(12*kRows);
+    this->jb.resize(2*kRows);
+    this->scale.resize(kRows);
+    for (int i = 0; i < kRows; ++i)
+    {
+      this->jb[2*i] = body(gen);
+      this->jb[2*i+1] = (i % 4 == 3) ? -1 : body(gen);
+      for (int j = 0; j < 12; ++j)
+      {
+        const bool unset = j >= 6 && this->jb[2*i+1] < 0;
+        this->J[12*i+j] = unset ? NAN : value(gen);
+        this->iMJ[12*i+j] = unset ? NAN : value(gen);
+      }
+      this->scale[i] = value(gen);
+    }
+
+    this->vel.resize(6*kBodies);
+    this->acc.resize(6*kBodies);
+    for (int k = 0; k < 6*kBodies; ++k)
+    {
+      this->vel[k] = value(gen);
+      this->acc[k] = value(gen);
+    }
+  }
+
+  /// \brief Check the results of kernels against the scalar ones.
+  /// \param[in] _kernels Kernels to check.
+  protected: void Check(const dxQuickStepKernels &_kernels)
+  {
+    const dxQuickStepKernels &scalar =
+      *QuickStepKernelsFor(QUICKSTEP_KERNEL_SCALAR);
+
+    std::vector<dReal> expected(kRows), out(kRows);
+    scalar.row_dot(kRows, &this->iMJ[0], &this->J[0], &this->jb[0],
+        &expected[0]);
+    _kernels.row_dot(kRows, &this->iMJ[0], &this->J[0], &this->jb[0],
+        &out[0]);
+    for (int i = 0; i < kRows; ++i)
+      EXPECT_NEAR(out[i], expected[i], 1e-12) << "row_dot row " << i;
+
+    scalar.multiply_J(kRows, &this->J[0], &this->jb[0], &this->vel[0],
+        &expected[0]);
+    _kernels.multiply_J(kRows, &this->J[0], &this->jb[0], &this->vel[0],
+        &out[0]);
+    for (int i = 0; i < kRows; ++i)
+      EXPECT_NEAR(out[i], expected[i], 1e-12) << "multiply_J row " << i;
+
+    // scaling is exact
+    std::vector<dReal> scaledExpected(this->J), scaled(this->J);
+    scalar.scale_rows(kRows, &scaledExpected[0], &this->scale[0]);
+    _kernels.scale_rows(kRows, &scaled[0], &this->scale[0]);
+    for (int k = 0; k < 12*kRows; ++k)
+    {
+      if (!std::isnan(scaledExpected[k]))
+      {
+        EXPECT_DOUBLE_EQ(scaled[k], scaledExpected[k])
+          << "scale_rows " << k;
+      }
+    }
+
+    // in place, as in the body update
+    std::vector<dReal> subExpected(this->acc), sub(this->acc);
+    scalar.scaled_sub(6*kBodies-1, &subExpected[0], 0.001, &this->vel[0],
+        &subExpected[0]);
+    _kernels.scaled_sub(6*kBodies-1, &sub[0], 0.001, &this->vel[0],
+        &sub[0]);
+    for (int k = 0; k < 6*kBodies; ++k)
+      EXPECT_DOUBLE_EQ(sub[k], subExpected[k]) << "scaled_sub " << k;
+  }
+
+  /// \brief Time each kernel.
+  /// \param[in] _kernels Kernels to time.
+  /// \return Seconds per call of row_dot, multiply_J, scale_rows and
+  /// scaled_sub.
+  protected: std::vector<double> Time(const dxQuickStepKernels &_kernels)
+  {
+    std::vector<dReal> out(kRows);
+    std::vector<dReal> scaled(this->J);
+    std::vector<dReal> sub(this->acc);
+    std::vector<double> seconds;
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r)
+    {
+      _kernels.row_dot(kRows, &this->iMJ[0], &this->J[0], &this->jb[0],
+          &out[0]);
+    }
+    seconds.push_back(
+        std::chrono::duration<double>(Clock::now() - start).count());
+
+    start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r)
+    {
+      _kernels.multiply_J(kRows, &this->J[0], &this->jb[0], &this->vel[0],
+          &out[0]);
+    }
+    seconds.push_back(
+        std::chrono::duration<double>(Clock::now() - start).count());
+
+    // scale by one, to keep the values bounded
+    std::vector<dReal> ones(kRows, 1.0);
+    start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r)
+      _kernels.scale_rows(kRows, &scaled[0], &ones[0]);
+    seconds.push_back(
+        std::chrono::duration<double>(Clock::now() - start).count());
+
+    start = Clock::now();
+    for (int r = 0; r < kRepeats; ++r)
+    {
+      _kernels.scaled_sub(6*kBodies, &sub[0], 1.0, &this->acc[0],
+          &this->vel[0]);
+    }
+    seconds.push_back(
+        std::chrono::duration<double>(Clock::now() - start).count());
+
+    for (auto &s : seconds)
+      s /= kRepeats;
+    return seconds;
+  }
+
+  /// \brief Jacobian rows.
+  protected: std::vector<dReal> J;
+
+  /// \brief inv(M)*J' rows.
+  protected: std::vector<dReal> iMJ;
+
+  /// \brief Bodies of the rows.
+  protected: std::vector<int> jb;
+
+  /// \brief Row scaling.
+  protected: std::vector<dReal> scale;
+
+  /// \brief Body velocities.
+  protected: std::vector<dReal> vel;
+
+  /// \brief Body accelerations.
+  protected: std::vector<dReal> acc;
+};
+
+/////////////////////////////////////////////////
+TEST_F(ODEQuickStepKernelsTest, Selection)
+{
+  ASSERT_TRUE(QuickStepKernelsFor(QUICKSTEP_KERNEL_SCALAR) != NULL);
+  EXPECT_TRUE(QuickStepKernelsFor(QUICKSTEP_KERNEL_COUNT) == NULL);
+
+  // the kernels in use are one of the available ones
+  const dxQuickStepKernels &kernels = QuickStepKernels();
+  bool found = false;
+  for (int type = 0; type < QUICKSTEP_KERNEL_COUNT; ++type)
+    found = found || QuickStepKernelsFor(type) == &kernels;
+  EXPECT_TRUE(found);
+  std::cout << "quickstep kernels in use: " << kernels.name << std::endl;
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEQuickStepKernelsTest, Throughput)
+{
+  std::vector<double> scalar =
+    this->Time(*QuickStepKernelsFor(QUICKSTEP_KERNEL_SCALAR));
+
+  std::ostringstream table;
+  table << std::setw(8) << "kernels" << std::setw(14) << "row_dot"
+        << std::setw(14) << "multiply_J" << std::setw(14) << "scale_rows"
+        << std::setw(14) << "scaled_sub" << "  (Mrows/s, speedup)\n";
+  for (int type = 0; type < QUICKSTEP_KERNEL_COUNT; ++type)
+  {
+    const dxQuickStepKernels *kernels = QuickStepKernelsFor(type);
+    if (!kernels)
+    {
+      std::cout << "kernels " << type << " not available" << std::endl;
+      continue;
+    }
+
+    this->Check(*kernels);
+
+    std::vector<double> seconds = this->Time(*kernels);
+    table << std::setw(8) << kernels->name;
+    for (unsigned int k = 0; k < seconds.size(); ++k)
+    {
+      // scaled_sub goes through the bodies
+      const double rows = k == 3 ? 6*kBodies : kRows;
+      table << std::setw(8) << std::fixed << std::setprecision(0)
+            << rows / seconds[k] * 1e-6 << " " << std::setprecision(2)
+            << scalar[k] / seconds[k];
+    }
+    table << "\n";
+  }
+  std::cout << table.str();
+}
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gazebo/ode/ode.h>
+
+/// \brief Step size.
+static const double kStepSize = 0.001;
+
+/// \brief Steps of each run.
+static const int kSteps = 2000;
+
+/// \brief ODE step functions being compared.
+enum class Method
+{
+  /// \brief dWorldStep.
+  WORLD,
+
+  /// \brief dWorldQuickStep.
+  QUICK,
+
+  /// \brief dWorldSparseQuickStep.
+  SPARSE_QUICK
+};
+
+/// \brief An articulated model dropped on a plane.
+class Model
+{
+  /// \brief Constructor.
+  /// \param[in] _iters Iterations of quickstep and sparse quickstep.
+  public: explicit Model(const int _iters)
+  {
+    this->world = dWorldCreate();
+    this->space = dHashSpaceCreate(0);
+    this->contacts = dJointGroupCreate(0);
+    dWorldSetGravity(this->world, 0, 0, -9.8);
+    dWorldSetQuickStepNumIterations(this->world, _iters);
+    dWorldSetERP(this->world, 0.2);
+    dWorldSetCFM(this->world, 1e-10);
+    dWorldSetAutoDisableFlag(this->world, 0);
+    dCreatePlane(this->space, 0, 0, 1, 0);
+  }
+
+  /// \brief Destructor.
+  public: ~Model()
+  {
+    dJointGroupDestroy(this->contacts);
+    dSpaceDestroy(this->space);
+    dWorldDestroy(this->world);
+  }
+
+  /// \brief Add a box link.
+  /// \param[in] _x Center x.
+  /// \param[in] _y Center y.
+  /// \param[in] _z Center z.
+  /// \param[in] _sx Size along x.
+  /// \param[in] _sy Size along y.
+  /// \param[in] _sz Size along z.
+  /// \param[in] _mass Mass of the link.
+  /// \return The body.
+  public: dBodyID AddLink(const double _x, const double _y, const double _z,
+              const double _sx, const double _sy, const double _sz,
+              const double _mass)
+  {
+    dBodyID body = dBodyCreate(this->world);
+    dMass mass;
+    dMassSetBoxTotal(&mass, _mass, _sx, _sy, _sz);
+    dBodySetMass(body, &mass);
+    dBodySetPosition(body, _x, _y, _z);
+    dGeomID geom = dCreateBox(this->space, _sx, _sy, _sz);
+    dGeomSetBody(geom, body);
+    return body;
+  }
+
+  /// \brief Join two links with a hinge.
+  /// \param[in] _b1 First body, null for the world.
+  /// \param[in] _b2 Second body.
+  /// \param[in] _anchor Anchor in the world frame.
+  /// \param[in] _axis Axis in the world frame.
+  public: void AddHinge(dBodyID _b1, dBodyID _b2, const dVector3 _anchor,
+              const dVector3 _axis)
+  {
+    dJointID joint = dJointCreateHinge(this->world, 0);
+    dJointAttach(joint, _b1, _b2);
+    dJointSetHingeAnchor(joint, _anchor[0], _anchor[1], _anchor[2]);
+    dJointSetHingeAxis(joint, _axis[0], _axis[1], _axis[2]);
+    this->joints.push_back(joint);
+  }
+
+  /// \brief Join two links with a ball joint.
+  /// \param[in] _b1 First body.
+  /// \param[in] _b2 Second body.
+  /// \param[in] _anchor Anchor in the world frame.
+  public: void AddBall(dBodyID _b1, dBodyID _b2, const dVector3 _anchor)
+  {
+    dJointID joint = dJointCreateBall(this->world, 0);
+    dJointAttach(joint, _b1, _b2);
+    dJointSetBallAnchor(joint, _anchor[0], _anchor[1], _anchor[2]);
+    this->joints.push_back(joint);
+  }
+
+  /// \brief Collide and step.
+  /// \param[in] _method Step function.
+  /// \return Seconds spent in the step function.
+  public: double Step(const Method _method)
+  {
+    dJointGroupEmpty(this->contacts);
+    dSpaceCollide(this->space, this, &Model::Near);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    switch (_method)
+    {
+      case Method::WORLD:
+        dWorldStep(this->world, kStepSize);
+        break;
+      case Method::QUICK:
+        dWorldQuickStep(this->world, kStepSize);
+        break;
+      case Method::SPARSE_QUICK:
+        dWorldSparseQuickStep(this->world, kStepSize);
+        break;
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  /// \brief Largest distance between the anchors of a joint on its two
+  /// bodies.
+  /// \return Distance in meters.
+  public: double AnchorError() const
+  {
+    double error = 0;
+    for (auto const joint : this->joints)
+    {
+      dVector3 a1, a2;
+      if (dJointGetType(joint) == dJointTypeHinge)
+      {
+        dJointGetHingeAnchor(joint, a1);
+        dJointGetHingeAnchor2(joint, a2);
+      }
+      else
+      {
+        dJointGetBallAnchor(joint, a1);
+        dJointGetBallAnchor2(joint, a2);
+      }
+      error = std::max(error, std::sqrt(
+          (a1[0]-a2[0])*(a1[0]-a2[0]) + (a1[1]-a2[1])*(a1[1]-a2[1]) +
+          (a1[2]-a2[2])*(a1[2]-a2[2])));
+    }
+    return error;
+  }
+
+  /// \brief Add the contacts of two geoms, except between jointed links.
+  private: static void Near(void *_data, dGeomID _o1, dGeomID _o2)
+  {
+    Model *self = static_cast<Model *>(_data);
+    dBodyID b1 = dGeomGetBody(_o1);
+    dBodyID b2 = dGeomGetBody(_o2);
+    if (b1 && b2 && dAreConnectedExcluding(b1, b2, dJointTypeContact))
+      return;
+
+    dContactGeom geoms[4];
+    int count = dCollide(_o1, _o2, 4, geoms, sizeof(dContactGeom));
+    for (int i = 0; i < count; ++i)
+    {
+      dContact contact;
+      memset(&contact, 0, sizeof(contact));
+      contact.surface.mode = dContactApprox1;
+      contact.surface.mu = 1;
+      contact.geom = geoms[i];
+      dJointID joint = dJointCreateContact(self->world, self->contacts,
+          &contact);
+      dJointAttach(joint, b1, b2);
+    }
+  }
+
+  /// \brief The world.
+  private: dWorldID world;
+
+  /// \brief Collision space.
+  private: dSpaceID space;
+
+  /// \brief Contact joints of the current step.
+  private: dJointGroupID contacts;
+
+  /// \brief Joints of the model.
+  private: std::vector<dJointID> joints;
+};
+
+/// \brief A chain of links hinged to the world, holding a payload ten times
+/// heavier than a link, released horizontally.
+/// \param[in] _model Model to build in.
+/// \param[in] _links Number of links, the payload included.
+/// \param[in] _length Length of a link.
+static void BuildChain(Model &_model, const int _links, const double _length)
+{
+  const double height = 0.2 + _links * _length;
+  dBodyID parent = 0;
+  for (int i = 0; i < _links; ++i)
+  {
+    const double mass = i < _links - 1 ? 1.0 : 10.0;
+    dBodyID link = _model.AddLink(_length*(i + 0.5), 0, height,
+        _length, 0.05, 0.05, mass);
+    const dVector3 anchor = {_length*i, 0, height, 0};
+    // alternate the axes so that the arm twists as it falls
+    const dVector3 axis = {0, i % 2 ? 0.0 : 1.0, i % 2 ? 1.0 : 0.0, 0};
+    _model.AddHinge(parent, link, anchor, axis);
+    parent = link;
+  }
+}
+
+/// \brief A 7 degree of freedom arm.
+/// \param[in] _model Model to build in.
+static void BuildArm(Model &_model)
+{
+  BuildChain(_model, 7, 0.3);
+}
+
+/// \brief A chain of 40 links.
+/// \param[in] _model Model to build in.
+static void BuildLongChain(Model &_model)
+{
+  BuildChain(_model, 40, 0.1);
+}
+
+/// \brief A humanoid of 15 links, 10 ball joints and 4 hinges (34 degrees
+/// of freedom with the floating base), falling on its back.
+/// \param[in] _model Model to build in.
+static void BuildHumanoid(Model &_model)
+{
+  const double z = 1.2;
+  dBodyID pelvis = _model.AddLink(0, 0, z, 0.3, 0.2, 0.15, 10);
+  dBodyID torso = _model.AddLink(0, 0, z + 0.3, 0.35, 0.2, 0.4, 20);
+  dBodyID head = _model.AddLink(0, 0, z + 0.65, 0.2, 0.2, 0.2, 5);
+  {
+    const dVector3 waist = {0, 0, z + 0.1, 0};
+    const dVector3 neck = {0, 0, z + 0.53, 0};
+    _model.AddBall(pelvis, torso, waist);
+    _model.AddBall(torso, head, neck);
+  }
+
+  for (auto const side : {-1.0, 1.0})
+  {
+    // leg: thigh, shin and foot
+    const double y = 0.1 * side;
+    dBodyID thigh = _model.AddLink(0, y, z - 0.3, 0.12, 0.12, 0.4, 7);
+    dBodyID shin = _model.AddLink(0, y, z - 0.75, 0.1, 0.1, 0.4, 4);
+    dBodyID foot = _model.AddLink(0.05, y, z - 1.0, 0.22, 0.1, 0.05, 1);
+    const dVector3 hip = {0, y, z - 0.08, 0};
+    const dVector3 knee = {0, y, z - 0.52, 0};
+    const dVector3 ankle = {0, y, z - 0.96, 0};
+    const dVector3 pitch = {0, 1, 0, 0};
+    _model.AddBall(pelvis, thigh, hip);
+    _model.AddHinge(thigh, shin, knee, pitch);
+    _model.AddBall(shin, foot, ankle);
+
+    // arm: upper arm, forearm and hand, spread out
+    const double ya = 0.2 * side;
+    dBodyID upper = _model.AddLink(0, ya + 0.15*side, z + 0.45,
+        0.3, 0.08, 0.08, 2);
+    dBodyID fore = _model.AddLink(0, ya + 0.45*side, z + 0.45,
+        0.3, 0.07, 0.07, 1.5);
+    dBodyID hand = _model.AddLink(0, ya + 0.65*side, z + 0.45,
+        0.1, 0.05, 0.08, 0.5);
+    const dVector3 shoulder = {0, ya, z + 0.45, 0};
+    const dVector3 elbow = {0, ya + 0.3*side, z + 0.45, 0};
+    const dVector3 wrist = {0, ya + 0.6*side, z + 0.45, 0};
+    const dVector3 bend = {0, 0, 1, 0};
+    _model.AddBall(torso, upper, shoulder);
+    _model.AddHinge(upper, fore, elbow, bend);
+    _model.AddBall(fore, hand, wrist);
+  }
+
+  // push it over backwards
+  dBodySetLinearVel(torso, -1, 0, 0);
+}
+
+class ODESparseStepTest : public ::testing::Test
+{
+  protected: virtual void SetUp()
+  {
+    dInitODE2(0);
+    dAllocateODEDataForThread(dAllocateMaskAll);
+  }
+
+  protected: virtual void TearDown()
+  {
+    dCloseODE();
+  }
+
+  /// \brief Run a model with a step function.
+  /// \param[in] _build Function building the model.
+  /// \param[in] _method Step function.
+  /// \param[in] _iters Iterations of quickstep and sparse quickstep.
+  /// \param[out] _error Largest anchor error over the run.
+  /// \return Milliseconds per step.
+  protected: double Run(void (*_build)(Model &), const Method _method,
+                 const int _iters, double &_error)
+  {
+    Model model(_iters);
+    _build(model);
+
+    double seconds = 0;
+    _error = 0;
+    for (int i = 0; i < kSteps; ++i)
+    {
+      seconds += model.Step(_method);
+      _error = std::max(_error, model.AnchorError());
+    }
+    return seconds / kSteps * 1e3;
+  }
+
+  /// \brief Compare the step functions on a model, print a table and check
+  /// that sparse quickstep keeps the joints together at least as well as
+  /// quickstep with the same iterations, and close to the world step.
+  /// \param[in] _name Name of the model.
+  /// \param[in] _build Function building the model.
+  protected: void Compare(const std::string &_name,
+                 void (*_build)(Model &))
+  {
+    std::ostringstream table;
+    table << _name << "\n" << std::setw(16) << "step" << std::setw(12)
+          << "ms/step" << std::setw(14) << "anchor error\n";
+
+    double error = 0;
+    const double world = this->Run(_build, Method::WORLD, 0, error);
+    const double worldError = error;
+    table << std::setw(16) << "world" << std::setw(12) << std::fixed
+          << std::setprecision(4) << world << std::setw(14)
+          << std::scientific << std::setprecision(2) << error << "\n";
+
+    for (auto const iters : {10, 50})
+    {
+      const double quick = this->Run(_build, Method::QUICK, iters, error);
+      const double quickError = error;
+      table << std::setw(16) << ("quick " + std::to_string(iters))
+            << std::setw(12) << std::fixed << std::setprecision(4) << quick
+            << std::setw(14) << std::scientific << std::setprecision(2)
+            << error << "\n";
+
+      const double sparse =
+        this->Run(_build, Method::SPARSE_QUICK, iters, error);
+      table << std::setw(16) << ("sparse_quick " + std::to_string(iters))
+            << std::setw(12) << std::fixed << std::setprecision(4) << sparse
+            << std::setw(14) << std::scientific << std::setprecision(2)
+            << error << "\n";
+
+      EXPECT_LE(error, quickError) << _name << ", " << iters << " iterations";
+      EXPECT_LT(error, std::max(2*worldError, 1e-4))
+        << _name << ", " << iters << " iterations";
+    }
+
+    std::cout << table.str();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(ODESparseStepTest, Arm)
+{
+  this->Compare("arm", &BuildArm);
+}
+
+/////////////////////////////////////////////////
+// The world step factors the dense system of the chain, sparse quickstep
+// is linear in its length.
+TEST_F(ODESparseStepTest, LongChain)
+{
+  this->Compare("long chain", &BuildLongChain);
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODESparseStepTest, Humanoid)
+{
+  this->Compare("humanoid", &BuildHumanoid);
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include <gazebo/ode/ode.h>
+
+/// \brief True while the allocations are counted.
+static std::atomic<bool> counting(false);
+
+/// \brief Allocations made while counting.
+static std::atomic<int> allocations(0);
+
+/////////////////////////////////////////////////
+// Every allocation of the test goes through Alloc and Free: ODE's through
+// its alloc handlers, and the global operators new and delete, all forms,
+// below. Memory is never released by a function other than the one that
+// matches its allocation.
+static void *Alloc(size_t _size)
+{
+  if (counting)
+    ++allocations;
+  return std::malloc(_size);
+}
+
+/////////////////////////////////////////////////
+static void *Realloc(void *_p, size_t, size_t _size)
+{
+  if (counting)
+    ++allocations;
+  return std::realloc(_p, _size);
+}
+
+/////////////////////////////////////////////////
+static void Free(void *_p, size_t)
+{
+  std::free(_p);
+}
+
+/////////////////////////////////////////////////
+static void *New(size_t _size)
+{
+  void *p = Alloc(std::max<size_t>(_size, 1));
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+/////////////////////////////////////////////////
+void *operator new(size_t _size)
+{
+  return New(_size);
+}
+
+/////////////////////////////////////////////////
+void *operator new[](size_t _size)
+{
+  return New(_size);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_p) noexcept
+{
+  Free(_p, 0);
+}
+
+/////////////////////////////////////////////////
+void operator delete[](void *_p) noexcept
+{
+  Free(_p, 0);
+}
+
+/////////////////////////////////////////////////
+void operator delete(void *_p, size_t _size) noexcept
+{
+  Free(_p, _size);
+}
+
+/////////////////////////////////////////////////
+void operator delete[](void *_p, size_t _size) noexcept
+{
+  Free(_p, _size);
+}
+
+/// \brief Boxes in each stack.
+static const int kHeight = 4;
+
+/// \brief Side of the box.
+static const double kSize = 0.2;
+
+/// \brief Steps before counting, for the contacts and arenas to settle.
+static const int kSettleSteps = 300;
+
+/// \brief Counted steps.
+static const int kSteps = 300;
+
+class ODEStepArenaTest : public ::testing::Test
+{
+  protected: virtual void SetUp()
+  {
+    dSetAllocHandler(&Alloc);
+    dSetReallocHandler(&Realloc);
+    dSetFreeHandler(&Free);
+    dInitODE2(0);
+    dAllocateODEDataForThread(dAllocateMaskAll);
+  }
+
+  protected: virtual void TearDown()
+  {
+    dCloseODE();
+    dSetAllocHandler(nullptr);
+    dSetReallocHandler(nullptr);
+    dSetFreeHandler(nullptr);
+  }
+
+  /// \brief Step a grid of separate box stacks, each its own island, and
+  /// count the allocations of the steps once the stacks have settled.
+  /// \param[in] _grid The stacks are on a _grid x _grid grid.
+  /// \param[in] _islandThreads Island threads of the world.
+  /// \param[out] _stats Step memory statistics after the steps.
+  /// \return Allocations in the counted steps.
+  protected: int Count(const int _grid, const int _islandThreads,
+                 dWorldStepMemoryStats &_stats)
+  {
+    this->world = dWorldCreate();
+    dSpaceID space = dHashSpaceCreate(0);
+    this->contacts = dJointGroupCreate(0);
+    dWorldSetGravity(this->world, 0, 0, -9.8);
+    dWorldSetQuickStepNumIterations(this->world, 50);
+    dWorldSetAutoDisableFlag(this->world, 0);
+    dWorldSetIslandThreads(this->world, _islandThreads);
+    dCreatePlane(space, 0, 0, 1, 0);
+
+    for (int x = 0; x < _grid; ++x)
+    {
+      for (int y = 0; y < _grid; ++y)
+      {
+        for (int i = 0; i < kHeight; ++i)
+        {
+          dBodyID body = dBodyCreate(this->world);
+          dMass mass;
+          dMassSetBox(&mass, 1000, kSize, kSize, kSize);
+          dBodySetMass(body, &mass);
+          dBodySetPosition(body, 2.5*kSize*x, 2.5*kSize*y, kSize*(0.5 + i));
+          dGeomID geom = dCreateBox(space, kSize, kSize, kSize);
+          dGeomSetBody(geom, body);
+        }
+      }
+    }
+
+    int count = 0;
+    for (int i = 0; i < kSettleSteps + kSteps; ++i)
+    {
+      dJointGroupEmpty(this->contacts);
+      dSpaceCollide(space, this, &ODEStepArenaTest::Near);
+
+      allocations = 0;
+      counting = i >= kSettleSteps;
+      dWorldQuickStep(this->world, 0.001);
+      counting = false;
+      count += allocations;
+    }
+
+    dWorldGetStepMemoryStats(this->world, &_stats);
+
+    dJointGroupDestroy(this->contacts);
+    dSpaceDestroy(space);
+    dWorldDestroy(this->world);
+    return count;
+  }
+
+  /// \brief Add the contacts of two geoms.
+  private: static void Near(void *_data, dGeomID _o1, dGeomID _o2)
+  {
+    ODEStepArenaTest *self = static_cast<ODEStepArenaTest *>(_data);
+    dContactGeom geoms[8];
+    int count = dCollide(_o1, _o2, 8, geoms, sizeof(dContactGeom));
+    for (int i = 0; i < count; ++i)
+    {
+      dContact contact;
+      memset(&contact, 0, sizeof(contact));
+      contact.surface.mode = dContactApprox1;
+      contact.surface.mu = 1;
+      contact.geom = geoms[i];
+      dJointID joint = dJointCreateContact(self->world, self->contacts,
+          &contact);
+      dJointAttach(joint, dGeomGetBody(_o1), dGeomGetBody(_o2));
+    }
+  }
+
+  /// \brief World being stepped.
+  private: dWorldID world;
+
+  /// \brief Contact joints of the current step.
+  private: dJointGroupID contacts;
+};
+
+/////////////////////////////////////////////////
+// Once the arenas have grown to the largest step, quickstep does not
+// allocate, whether the islands are stepped in the calling thread or by
+// island threads.
+TEST_F(ODEStepArenaTest, SteadyStateAllocations)
+{
+  for (auto const threads : {0, 2, 4})
+  {
+    for (auto const grid : {1, 4, 8})
+    {
+      dWorldStepMemoryStats stats;
+      EXPECT_EQ(0, this->Count(grid, threads, stats))
+        << threads << " island threads, grid " << grid;
+
+      // one arena for the islands and one per island thread
+      EXPECT_EQ(std::max(threads, 1) + 1, static_cast<int>(stats.arena_count));
+      EXPECT_GT(stats.high_water_bytes, 0u);
+      EXPECT_LE(stats.high_water_bytes, stats.reserved_bytes);
+      EXPECT_GE(stats.grow_count, stats.arena_count);
+
+      std::cout << "island threads " << threads << ", "
+                << grid*grid*kHeight << " boxes: " << stats.arena_count
+                << " arenas, " << stats.reserved_bytes << " bytes reserved, "
+                << stats.high_water_bytes << " high water, "
+                << stats.grow_count << " grows" << std::endl;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST_F(ODEStepArenaTest, Cleanup)
+{
+  dWorldID world = dWorldCreate();
+  dWorldStepMemoryStats stats;
+  dWorldGetStepMemoryStats(world, &stats);
+  EXPECT_EQ(0u, stats.arena_count);
+  EXPECT_EQ(0u, stats.reserved_bytes);
+
+  dBodyCreate(world);
+  dWorldQuickStep(world, 0.001);
+  dWorldGetStepMemoryStats(world, &stats);
+  EXPECT_EQ(2u, stats.arena_count);
+  EXPECT_GT(stats.reserved_bytes, 0u);
+
+  dWorldCleanupWorkingMemory(world);
+  dWorldGetStepMemoryStats(world, &stats);
+  EXPECT_EQ(0u, stats.arena_count);
+  EXPECT_EQ(0u, stats.reserved_bytes);
+  EXPECT_EQ(0u, stats.grow_count);
+  dWorldDestroy(world);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "gazebo/physics/StateStream.hh"
+#include "gazebo/physics/WorldState.hh"
+
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Build the SDF text of a state with many models.
+/// \param[in] _models Number of models.
+/// \param[in] _links Number of links per model.
+/// \return Text of the state, in the form stored in log files.
+std::string StateText(const int _models, const int _links)
+{
+  std::ostringstream stream;
+  stream << "<sdf version='" << SDF_VERSION << "'>"
+    << "<state world_name='default'>"
+    << "<sim_time>12 345000000</sim_time>"
+    << "<wall_time>1500000000 123456789</wall_time>"
+    << "<real_time>13 456000000</real_time>"
+    << "<iterations>12345</iterations>";
+
+  for (int m = 0; m < _models; ++m)
+  {
+    stream << "<model name='model_" << m << "'>"
+      << "<pose>" << m * 0.1234 << " " << m * 0.5678 << " 0.5 0 0 "
+      << m * 0.01 << "</pose>";
+    for (int l = 0; l < _links; ++l)
+    {
+      stream << "<link name='link_" << l << "'>"
+        << "<pose>" << m * 0.1234 << " " << m * 0.5678 << " "
+        << l * 0.25 << " 0.01 0.02 " << l * 0.03 << "</pose>"
+        << "<velocity>0.001 0.002 0.003 0.1 0.2 0.3</velocity>"
+        << "</link>";
+    }
+    stream << "</model>";
+  }
+  stream << "</state></sdf>";
+
+  return stream.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Compare bytes and time per state of the SDF text form, as used
+/// by World::OnLog and log playback, and the binary form.
+TEST(StateSerialization, TextVsBinary)
+{
+  const int iterations = 100;
+
+  sdf::ElementPtr stateSdf(new sdf::Element);
+  sdf::initFile("state.sdf", stateSdf);
+  sdf::readString(StateText(100, 10), stateSdf);
+  physics::WorldState state(stateSdf);
+  ASSERT_EQ(100u, state.GetModelStateCount());
+
+  // Text form
+  std::string text;
+  physics::WorldState textState;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    std::ostringstream stream;
+    stream << "<sdf version='" << SDF_VERSION << "'>" << state << "</sdf>";
+    text = stream.str();
+
+    stateSdf->Clear();
+    sdf::readString(text, stateSdf);
+    textState.Load(stateSdf);
+  }
+  double textTime = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / iterations;
+
+  // Binary form. All states belong to the same segment, so names are only
+  // written in full in the first one.
+  physics::StateWriter writer;
+  physics::StateReader reader;
+  physics::WorldState binaryState;
+  size_t firstBytes = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    writer.Clear();
+    state.Serialize(writer);
+    if (i == 0)
+      firstBytes = writer.Data().size();
+
+    reader.SetData(writer.Data().data(), writer.Data().size());
+    ASSERT_TRUE(binaryState.Deserialize(reader));
+  }
+  double binaryTime = std::chrono::duration<double, std::nano>(
+      std::chrono::steady_clock::now() - start).count() / iterations;
+
+  std::cout << "Text:   " << text.size() << " bytes/state, "
+    << textTime << " ns/state" << std::endl;
+  std::cout << "Binary: " << writer.Data().size() << " bytes/state ("
+    << firstBytes << " for the first state of a segment), "
+    << binaryTime << " ns/state" << std::endl;
+
+  // The binary form doesn't lose precision
+  std::ostringstream expected, actual;
+  expected << state;
+  actual << binaryState;
+  EXPECT_EQ(expected.str(), actual.str());
+
+  // The text form rounds values to 4 decimals, so it isn't much larger
+  // than raw doubles. Parsing it is what costs.
+  EXPECT_LT(binaryTime, textTime);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,16 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/date_time/posix_time/posix_time_io.hpp>
@@ -591,6 +601,468 @@ std::string StateFilter::Filter(const std::string &_stateString)
   return result.str();
 }
 
+/////////////////////////////////////////////////
+bool StateExtractor::Init(const std::string &_columns)
+{
+  const std::string kComponents = "xyzrpa";
+
+  this->columns.clear();
+  this->models.clear();
+
+  std::vector<std::string> specs;
+  boost::split(specs, _columns, boost::is_any_of(","));
+  for (auto spec : specs)
+  {
+    boost::trim(spec);
+    if (spec.empty())
+      continue;
+
+    ExtractColumn column;
+    column.name = spec;
+
+    // <model>[/<entity>].<field>[.<component>]
+    auto slash = spec.rfind('/');
+    auto dot = spec.find('.', slash == std::string::npos ? 0 : slash);
+    if (dot == std::string::npos)
+    {
+      std::cerr << "Column[" << spec << "] has no field\n";
+      return false;
+    }
+    std::string path = spec.substr(0, dot);
+    std::string fields = spec.substr(dot + 1);
+    std::vector<std::string> fieldParts;
+    boost::split(fieldParts, fields, boost::is_any_of("."));
+
+    slash = path.find('/');
+    column.model = path.substr(0, slash);
+    if (slash != std::string::npos)
+      column.entity = path.substr(slash + 1);
+    column.field = fieldParts[0];
+
+    if (column.field == "angle" && !column.entity.empty())
+    {
+      // Joint angle, the axis defaults to 0
+      if (fieldParts.size() > 1)
+        column.component = std::strtoul(fieldParts[1].c_str(), nullptr, 10);
+    }
+    else if (column.field == "pose" ||
+        (column.field == "velocity" && !column.entity.empty()))
+    {
+      size_t component = fieldParts.size() > 1 && fieldParts[1].size() == 1 ?
+        kComponents.find(static_cast<char>(std::tolower(fieldParts[1][0]))) :
+        std::string::npos;
+      if (component == std::string::npos)
+      {
+        std::cerr << "Column[" << spec << "] needs one of the components "
+          << "x, y, z, r, p, a\n";
+        return false;
+      }
+      column.component = component;
+    }
+    else
+    {
+      std::cerr << "Invalid field[" << column.field << "] in column["
+        << spec << "]\n";
+      return false;
+    }
+
+    auto modelIter = std::find(this->models.begin(), this->models.end(),
+        column.model);
+    column.modelIndex = modelIter - this->models.begin();
+    if (modelIter == this->models.end())
+      this->models.push_back(column.model);
+
+    this->columns.push_back(column);
+  }
+
+  if (this->columns.empty())
+  {
+    std::cerr << "No columns to extract\n";
+    return false;
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::SetTimeRange(const common::Time &_start,
+    const common::Time &_end)
+{
+  this->startTime = _start;
+  this->endTime = _end;
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::SetThreads(const unsigned int _threads)
+{
+  this->threads = _threads;
+}
+
+/////////////////////////////////////////////////
+size_t StateExtractor::RowCount() const
+{
+  return this->times.size();
+}
+
+/////////////////////////////////////////////////
+unsigned int StateExtractor::SkippedChunks() const
+{
+  return this->skipped;
+}
+
+/////////////////////////////////////////////////
+bool StateExtractor::Extract(const gazebo::util::LogPlay *_play)
+{
+  this->times.clear();
+  this->values.assign(this->columns.size(), std::vector<double>());
+  this->skipped = 0;
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  // Use the chunk index to leave out chunks outside the time range.
+  std::vector<unsigned int> chunks;
+  std::vector<unsigned int> earlier;
+  for (unsigned int i = 0; i < _play->ChunkCount(); ++i)
+  {
+    common::Time chunkStart, chunkEnd;
+    if (_play->ChunkTimeRange(i, chunkStart, chunkEnd) &&
+        (chunkEnd < this->startTime || chunkStart > this->endTime))
+    {
+      if (chunkEnd < this->startTime)
+        earlier.push_back(i);
+      ++this->skipped;
+      continue;
+    }
+    chunks.push_back(i);
+  }
+
+  // Results of each chunk, merged in order afterwards.
+  struct ChunkTable
+  {
+    std::vector<double> times;
+    std::vector<std::vector<double>> values;
+    std::vector<double> before;
+  };
+  std::vector<ChunkTable> tables(chunks.size());
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&]()
+  {
+    std::string data;
+    for (size_t i = next++; i < chunks.size() && !failed; i = next++)
+    {
+      if (!_play->ReadChunk(chunks[i], data))
+      {
+        failed = true;
+        return;
+      }
+      tables[i].values.resize(this->columns.size());
+      tables[i].before.assign(this->columns.size(), nan);
+      this->ScanChunk(data, tables[i].times, tables[i].values,
+          tables[i].before);
+    }
+  };
+
+  unsigned int threadCount = this->threads;
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  threadCount = static_cast<unsigned int>(std::min<size_t>(threadCount,
+        std::max<size_t>(1, chunks.size())));
+
+  std::vector<std::thread> workers;
+  for (unsigned int t = 1; t < threadCount; ++t)
+    workers.push_back(std::thread(worker));
+  worker();
+  for (auto &thread : workers)
+    thread.join();
+
+  if (failed)
+  {
+    std::cerr << "Unable to read a chunk of the log file\n";
+    return false;
+  }
+
+  // Seed the carry-over with the last values before the time range. The
+  // decoded chunks hold the most recent ones. Columns which aren't in them
+  // are looked up in the skipped chunks, latest first.
+  std::vector<double> last(this->columns.size(), nan);
+  for (size_t c = 0; c < this->columns.size(); ++c)
+  {
+    for (auto const &table : tables)
+    {
+      if (!std::isnan(table.before[c]))
+        last[c] = table.before[c];
+    }
+  }
+
+  std::vector<double> earlierTimes;
+  std::vector<std::vector<double>> earlierValues(this->columns.size());
+  std::vector<double> before(this->columns.size(), nan);
+  std::string data;
+  for (auto iter = earlier.rbegin(); iter != earlier.rend() &&
+      std::any_of(last.begin(), last.end(),
+        [](const double _value) {return std::isnan(_value);}); ++iter)
+  {
+    if (!_play->ReadChunk(*iter, data))
+    {
+      std::cerr << "Unable to read a chunk of the log file\n";
+      return false;
+    }
+    std::fill(before.begin(), before.end(), nan);
+    this->ScanChunk(data, earlierTimes, earlierValues, before);
+    for (size_t c = 0; c < this->columns.size(); ++c)
+    {
+      if (std::isnan(last[c]))
+        last[c] = before[c];
+    }
+  }
+
+  // Merge, carrying over values of entities which didn't change.
+  for (auto &table : tables)
+  {
+    this->times.insert(this->times.end(), table.times.begin(),
+        table.times.end());
+    for (size_t c = 0; c < this->columns.size(); ++c)
+    {
+      for (auto &value : table.values[c])
+      {
+        if (std::isnan(value))
+          value = last[c];
+        else
+          last[c] = value;
+      }
+      this->values[c].insert(this->values[c].end(), table.values[c].begin(),
+          table.values[c].end());
+    }
+  }
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::ScanChunk(const std::string &_chunk,
+    std::vector<double> &_times,
+    std::vector<std::vector<double>> &_values,
+    std::vector<double> &_before) const
+{
+  const std::string kStartFrame = "<sdf ";
+  const std::string kEndFrame = "</sdf>";
+  const std::string kState = "<state ";
+  const std::string kSimTime = "<sim_time>";
+  const std::string kInsertions = "</insertions>";
+  const double start = this->startTime.Double();
+  const double end = this->endTime.Double();
+  std::vector<double> row(this->columns.size());
+
+  size_t pos = 0;
+  while ((pos = _chunk.find(kStartFrame, pos)) != std::string::npos)
+  {
+    size_t frameEnd = _chunk.find(kEndFrame, pos);
+    size_t body = _chunk.find('>', pos);
+    if (frameEnd == std::string::npos || body == std::string::npos)
+      break;
+    ++body;
+    pos = frameEnd + kEndFrame.size();
+
+    // Only states, not the world description
+    if (_chunk.compare(body, kState.size(), kState) != 0)
+      continue;
+
+    size_t timePos = _chunk.find(kSimTime, body);
+    if (timePos == std::string::npos || timePos > frameEnd)
+      continue;
+
+    char *timeEnd;
+    double sec = std::strtod(_chunk.c_str() + timePos + kSimTime.size(),
+        &timeEnd);
+    double nsec = std::strtod(timeEnd, nullptr);
+    double time = sec + nsec * 1e-9;
+    if (time > end)
+      continue;
+
+    std::fill(row.begin(), row.end(),
+        std::numeric_limits<double>::quiet_NaN());
+
+    // Skip the descriptions of inserted models
+    size_t from = _chunk.find(kInsertions, body);
+    if (from == std::string::npos || from > frameEnd)
+      from = body;
+
+    for (unsigned int m = 0; m < this->models.size(); ++m)
+    {
+      const std::string tag = "<model name='" + this->models[m] + "'>";
+      size_t modelPos = _chunk.find(tag, from);
+      if (modelPos == std::string::npos || modelPos > frameEnd)
+        continue;
+
+      // Find the matching end tag, skipping nested models
+      size_t modelBegin = modelPos + tag.size();
+      size_t modelEnd = modelBegin;
+      int depth = 1;
+      while (depth > 0)
+      {
+        size_t open = _chunk.find("<model ", modelEnd);
+        size_t close = _chunk.find("</model>", modelEnd);
+        if (close == std::string::npos || close > frameEnd)
+          break;
+        if (open < close)
+        {
+          ++depth;
+          modelEnd = open + 1;
+        }
+        else
+        {
+          --depth;
+          modelEnd = close + (depth > 0 ? 1 : 0);
+        }
+      }
+      if (depth > 0)
+        continue;
+
+      this->ScanModel(_chunk, modelBegin, modelEnd, m, row);
+    }
+
+    // States before the time range only update the carry-over values
+    if (time < start)
+    {
+      for (size_t c = 0; c < row.size(); ++c)
+      {
+        if (!std::isnan(row[c]))
+          _before[c] = row[c];
+      }
+    }
+    else
+    {
+      _times.push_back(time);
+      for (size_t c = 0; c < row.size(); ++c)
+        _values[c].push_back(row[c]);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::ScanModel(const std::string &_data, const size_t _begin,
+    const size_t _end, const unsigned int _model,
+    std::vector<double> &_row) const
+{
+  // Parse the n-th number of a field, starting at _pos
+  auto number = [&_data](size_t _pos, unsigned int _index)
+  {
+    const char *str = _data.c_str() + _pos;
+    char *next = nullptr;
+    double value = std::strtod(str, &next);
+    for (unsigned int i = 0; i < _index; ++i)
+    {
+      str = next;
+      value = std::strtod(str, &next);
+    }
+    return value;
+  };
+
+  for (size_t c = 0; c < this->columns.size(); ++c)
+  {
+    const ExtractColumn &column = this->columns[c];
+    if (column.modelIndex != _model)
+      continue;
+
+    size_t elemBegin = _begin;
+    size_t elemEnd = _end;
+    if (!column.entity.empty())
+    {
+      const std::string type = column.field == "angle" ? "joint" : "link";
+      const std::string tag = "<" + type + " name='" + column.entity + "'>";
+      elemBegin = _data.find(tag, _begin);
+      if (elemBegin == std::string::npos || elemBegin > _end)
+        continue;
+      elemBegin += tag.size();
+      elemEnd = _data.find("</" + type + ">", elemBegin);
+      if (elemEnd == std::string::npos || elemEnd > _end)
+        continue;
+    }
+
+    if (column.field == "angle")
+    {
+      const std::string tag = "<angle axis='" +
+        std::to_string(column.component) + "'>";
+      size_t angle = _data.find(tag, elemBegin);
+      if (angle != std::string::npos && angle < elemEnd)
+        _row[c] = number(angle + tag.size(), 0);
+    }
+    else
+    {
+      // The model pose comes right after the model tag, before any link.
+      const std::string tag = "<" + column.field + ">";
+      if (column.entity.empty())
+      {
+        elemBegin = _data.find_first_not_of(" \t\n", elemBegin);
+        if (elemBegin != std::string::npos &&
+            _data.compare(elemBegin, tag.size(), tag) == 0)
+          _row[c] = number(elemBegin + tag.size(), column.component);
+      }
+      else
+      {
+        size_t field = _data.find(tag, elemBegin);
+        if (field != std::string::npos && field < elemEnd)
+          _row[c] = number(field + tag.size(), column.component);
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::WriteCsv(std::ostream &_out) const
+{
+  _out << "sim_time";
+  for (auto const &column : this->columns)
+    _out << "," << column.name;
+  _out << "\n";
+
+  for (size_t r = 0; r < this->times.size(); ++r)
+  {
+    _out << std::fixed << std::setprecision(9) << this->times[r];
+    _out.unsetf(std::ios_base::floatfield);
+    _out << std::setprecision(std::numeric_limits<double>::digits10);
+    for (auto const &column : this->values)
+    {
+      _out << ",";
+      if (!std::isnan(column[r]))
+        _out << column[r];
+    }
+    _out << "\n";
+  }
+}
+
+/////////////////////////////////////////////////
+void StateExtractor::WriteBinary(std::ostream &_out) const
+{
+  const uint32_t columnCount = this->columns.size() + 1;
+  const uint64_t rowCount = this->times.size();
+
+  _out.write("GZCOLS01", 8);
+  _out.write(reinterpret_cast<const char *>(&columnCount),
+      sizeof(columnCount));
+  _out.write(reinterpret_cast<const char *>(&rowCount), sizeof(rowCount));
+
+  auto writeName = [&_out](const std::string &_name)
+  {
+    const uint32_t size = _name.size();
+    _out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    _out.write(_name.c_str(), size);
+  };
+  writeName("sim_time");
+  for (auto const &column : this->columns)
+    writeName(column.name);
+
+  _out.write(reinterpret_cast<const char *>(this->times.data()),
+      rowCount * sizeof(double));
+  for (auto const &column : this->values)
+  {
+    _out.write(reinterpret_cast<const char *>(column.data()),
+        rowCount * sizeof(double));
+  }
+}
+
 /////////////////////////////////////////////////
 LogCommand::LogCommand()
   : Command("log", "Introspects and manipulates Gazebo log files.")
@@ -622,7 +1094,22 @@ LogCommand::LogCommand()
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, and output commands")
+    ("extract,x", po::value<std::string>(),
+     "Extract the fields given by --columns to a file, decoding chunks in "
+     "parallel. The file is CSV if its name ends with .csv, binary "
+     "columnar otherwise.")
+    ("columns", po::value<std::string>(),
+     "Comma separated fields to extract: <model>.pose.<c>, "
+     "<model>/<link>.<pose|velocity>.<c>, or <model>/<joint>.angle[.<axis>]"
+     ", where <c> is one of x,y,z,r,p,a.")
+    ("start", po::value<double>(),
+     "Sim time in seconds from which to extract. Used with --extract.")
+    ("end", po::value<double>(),
+     "Sim time in seconds up to which to extract. Used with --extract.")
+    ("threads", po::value<unsigned int>()->default_value(0),
+     "Number of threads decoding chunks, 0 for one per core. Used with "
+     "--extract.");
 }
 
 /////////////////////////////////////////////////
@@ -692,7 +1179,19 @@ bool LogCommand::RunImpl()
   g_stateSdf.reset(new sdf::Element);
   sdf::initFile("state.sdf", g_stateSdf);
 
-  if (this->vm.count("output"))
+  if (this->vm.count("extract"))
+  {
+    common::Time start, end = common::Time::Maximum();
+    if (this->vm.count("start"))
+      start = common::Time(this->vm["start"].as<double>());
+    if (this->vm.count("end"))
+      end = common::Time(this->vm["end"].as<double>());
+
+    return this->Extract(this->vm["extract"].as<std::string>(),
+        this->vm.count("columns") ? this->vm["columns"].as<std::string>() : "",
+        start, end, this->vm["threads"].as<unsigned int>());
+  }
+  else if (this->vm.count("output"))
   {
     std::string encoding = this->vm.count("encoding") ?
       this->vm["encoding"].as<std::string>() : "";
@@ -892,6 +1391,38 @@ void LogCommand::Output(const std::string &_outFilename,
   outFile.close();
 }
 
+/////////////////////////////////////////////////
+bool LogCommand::Extract(const std::string &_outFilename,
+    const std::string &_columns, const common::Time &_start,
+    const common::Time &_end, const unsigned int _threads)
+{
+  StateExtractor extractor;
+  if (!extractor.Init(_columns))
+    return false;
+
+  extractor.SetTimeRange(_start, _end);
+  extractor.SetThreads(_threads);
+  if (!extractor.Extract(gazebo::util::LogPlay::Instance()))
+    return false;
+
+  std::ofstream outFile(_outFilename, std::fstream::out | std::ios::binary);
+  if (!outFile.is_open())
+  {
+    std::cerr << "Unable to open file[" << _outFilename << "] for writing.\n";
+    return false;
+  }
+
+  if (boost::algorithm::ends_with(_outFilename, ".csv"))
+    extractor.WriteCsv(outFile);
+  else
+    extractor.WriteBinary(outFile);
+
+  std::cout << "Extracted " << extractor.RowCount() << " states, skipped "
+    << extractor.SkippedChunks() << " chunks.\n";
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Echo(const std::string &_filter, bool _raw,
     const std::string &_stamp, double _hz)
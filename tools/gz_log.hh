@@ -17,10 +17,13 @@
 #ifndef GAZEBO_TOOLS_GZLOG_HH_
 #define GAZEBO_TOOLS_GZLOG_HH_
 
+#include <ostream>
 #include <string>
 #include <list>
+#include <vector>
 
 #include <gazebo/physics/WorldState.hh>
+#include <gazebo/util/LogPlay.hh>
 #include "gz.hh"
 
 namespace gazebo
@@ -187,6 +190,128 @@ namespace gazebo
     private: gazebo::common::Time prevTime;
   };
 
+  /// \brief A field extracted from a log by StateExtractor.
+  class ExtractColumn
+  {
+    /// \brief Column name, as given on the command line.
+    public: std::string name;
+
+    /// \brief Name of the model.
+    public: std::string model;
+
+    /// \brief Name of the link or joint, empty for a model field.
+    public: std::string entity;
+
+    /// \brief Field of the entity: pose, velocity or angle.
+    public: std::string field;
+
+    /// \brief Index of the component, a pose element or a joint axis.
+    public: unsigned int component = 0;
+
+    /// \brief Index of the model in StateExtractor's list of models.
+    public: unsigned int modelIndex = 0;
+  };
+
+  /// \brief Extracts fields of models, links and joints from a log into a
+  /// table with one row per state.
+  ///
+  /// Chunks are decompressed and scanned on several threads, looking only
+  /// for the requested fields instead of loading whole states. Chunks
+  /// whose time range, recorded in the chunk index, is outside the
+  /// requested range are never decompressed. Since states only contain
+  /// the entities which changed, missing values are carried over from the
+  /// previous row.
+  class StateExtractor
+  {
+    /// \brief Initialize the list of columns.
+    /// \param[in] _columns Comma separated columns, each one of
+    /// <model>.pose.<c>, <model>/<link>.<pose|velocity>.<c> or
+    /// <model>/<joint>.angle[.<axis>], where <c> is one of x,y,z,r,p,a.
+    /// \return False if a column is invalid.
+    public: bool Init(const std::string &_columns);
+
+    /// \brief Only extract states within a time range.
+    /// \param[in] _start First sim time.
+    /// \param[in] _end Last sim time.
+    public: void SetTimeRange(const common::Time &_start,
+                const common::Time &_end);
+
+    /// \brief Set the number of threads decoding chunks.
+    /// \param[in] _threads Number of threads, 0 for one per core.
+    public: void SetThreads(const unsigned int _threads);
+
+    /// \brief Extract the columns from a log.
+    /// \param[in] _play The open log.
+    /// \return False if a chunk couldn't be read.
+    public: bool Extract(const gazebo::util::LogPlay *_play);
+
+    /// \brief Write the table as CSV, with a header row. Values which are
+    /// not known yet are left empty.
+    /// \param[in] _out Output stream.
+    public: void WriteCsv(std::ostream &_out) const;
+
+    /// \brief Write the table in binary columnar format: the magic string
+    /// "GZCOLS01", the number of columns and of rows as uint32 and uint64,
+    /// each column name as a uint32 length and its characters, then the
+    /// doubles of each column in turn. The first column is the sim time.
+    /// Integers and doubles use the host's byte order.
+    /// \param[in] _out Output stream.
+    public: void WriteBinary(std::ostream &_out) const;
+
+    /// \brief Get the number of extracted rows.
+    /// \return Number of rows.
+    public: size_t RowCount() const;
+
+    /// \brief Get the number of chunks skipped thanks to the chunk index.
+    /// \return Number of chunks.
+    public: unsigned int SkippedChunks() const;
+
+    /// \brief Scan the states of a chunk.
+    /// \param[in] _chunk Decompressed chunk.
+    /// \param[out] _times Sim time of each state.
+    /// \param[out] _values Values of each column, NaN when not present.
+    /// \param[in,out] _before Last value of each column in the states
+    /// before the time range, left unchanged when not present.
+    private: void ScanChunk(const std::string &_chunk,
+                 std::vector<double> &_times,
+                 std::vector<std::vector<double>> &_values,
+                 std::vector<double> &_before) const;
+
+    /// \brief Scan a model element of a state.
+    /// \param[in] _data Chunk data.
+    /// \param[in] _begin Start of the model's content.
+    /// \param[in] _end End of the model's content.
+    /// \param[in] _model Index of the model.
+    /// \param[out] _row Value of each column in the state.
+    private: void ScanModel(const std::string &_data, const size_t _begin,
+                 const size_t _end, const unsigned int _model,
+                 std::vector<double> &_row) const;
+
+    /// \brief Columns to extract.
+    private: std::vector<ExtractColumn> columns;
+
+    /// \brief Names of the models with extracted columns.
+    private: std::vector<std::string> models;
+
+    /// \brief First sim time to extract.
+    private: common::Time startTime;
+
+    /// \brief Last sim time to extract.
+    private: common::Time endTime = common::Time::Maximum();
+
+    /// \brief Number of threads decoding chunks, 0 for one per core.
+    private: unsigned int threads = 0;
+
+    /// \brief Sim time of each row.
+    private: std::vector<double> times;
+
+    /// \brief Values of each column.
+    private: std::vector<std::vector<double>> values;
+
+    /// \brief Number of chunks skipped thanks to the chunk index.
+    private: unsigned int skipped = 0;
+  };
+
   /// \brief Log command
   class LogCommand : public Command
   {
@@ -222,6 +347,18 @@ namespace gazebo
                  const std::string &_stamp, const double _hz,
                  const std::string &_encoding = "");
 
+    /// \brief Extract columns of state data to a file.
+    /// \param[in] _outFilename Output filename. The output is CSV if the
+    /// name ends with .csv, binary columnar otherwise.
+    /// \param[in] _columns Columns to extract, see StateExtractor::Init.
+    /// \param[in] _start First sim time to extract.
+    /// \param[in] _end Last sim time to extract.
+    /// \param[in] _threads Number of threads, 0 for one per core.
+    /// \return True on success.
+    private: bool Extract(const std::string &_outFilename,
+                 const std::string &_columns, const common::Time &_start,
+                 const common::Time &_end, const unsigned int _threads);
+
     /// \brief Dump the contents of a log file to screen
     /// \param[in] _filter Filter string
     /// \param[in] _raw True to output data without xml formatting.
@@ -16,6 +16,7 @@
 */
 #include <thread>
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <gazebo/common/CommonIface.hh>
@@ -24,7 +25,11 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <fstream>
+#include <iterator>
 #include <string>
+#include <utility>
+#include <vector>
 
 // This header file isn't needed if shasums are used
 // #include "test/data/pr2_state_log_expected.h"
@@ -373,6 +378,105 @@ TEST(gz_log, Step)
     FAIL() << "Please add support for sdf version: " << SDF_VERSION;
 }
 
+/////////////////////////////////////////////////
+/// Check columnar extraction
+TEST(gz_log, Extract)
+{
+  boost::filesystem::path csvPath =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("%%%%-%%%%.csv");
+
+  custom_exec(std::string(GZ_LOG_PATH + " -x ") + csvPath.string() +
+      " --columns pr2.pose.z,pr2.pose.x -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+
+  std::ifstream csvFile(csvPath.string());
+  std::string csv((std::istreambuf_iterator<char>(csvFile)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ("sim_time,pr2.pose.z,pr2.pose.x\n"
+      "0.021343973,-8e-06,0\n"
+      "0.028958235,-1.5e-05,0\n", csv);
+
+  // Time range selection
+  custom_exec(std::string(GZ_LOG_PATH + " -x ") + csvPath.string() +
+      " --columns pr2.pose.z --start 0.025 --threads 2 -f " +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+
+  std::ifstream rangeFile(csvPath.string());
+  csv.assign((std::istreambuf_iterator<char>(rangeFile)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ("sim_time,pr2.pose.z\n0.028958235,-1.5e-05\n", csv);
+
+  boost::filesystem::remove(csvPath);
+}
+
+/////////////////////////////////////////////////
+/// Check that values carried over into a time range come from the states
+/// before it, including states of chunks skipped thanks to the chunk index
+TEST(gz_log, ExtractStartCarryOver)
+{
+  boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  boost::filesystem::path logPath = dir / "state.log";
+  boost::filesystem::path csvPath = dir / "columns.csv";
+
+  // A state holding the pose of each given model
+  auto state = [](const std::string &_time,
+      const std::vector<std::pair<std::string, std::string>> &_models)
+  {
+    std::string result = "<sdf version='1.6'><state world_name='default'>"
+      "<sim_time>" + _time + "</sim_time>";
+    for (auto const &model : _models)
+    {
+      result += "<model name='" + model.first + "'><pose>" + model.second +
+        "</pose></model>";
+    }
+    return result + "</state></sdf>\n";
+  };
+
+  // A txt chunk indexed by the sim time of its states
+  auto chunk = [](const std::string &_start, const std::string &_end,
+      const std::string &_data)
+  {
+    return "<chunk encoding='txt' sim_start='" + _start + "' sim_end='" +
+      _end + "'>\n<![CDATA[" + _data + "]]>\n</chunk>\n";
+  };
+
+  // The box only appears in the first chunk, and the ball doesn't change
+  // in the last state.
+  {
+    std::ofstream logFile(logPath.string());
+    logFile << "<?xml version='1.0'?>\n<gazebo_log>\n<header>\n"
+      << "<log_version>2.0</log_version>\n"
+      << "<gazebo_version>11.0.0</gazebo_version>\n"
+      << "<rand_seed>1</rand_seed>\n</header>\n"
+      << chunk("0 100000000", "0 200000000",
+          state("0 100000000", {{"box", "1 2 3 0 0 0"},
+            {"ball", "0 0 5 0 0 0"}}) +
+          state("0 200000000", {{"ball", "0 0 4 0 0 0"}}))
+      << chunk("0 300000000", "0 300000000",
+          state("0 300000000", {{"ball", "0 0 3 0 0 0"}}))
+      << chunk("0 400000000", "0 500000000",
+          state("0 400000000", {{"ball", "0 0 2 0 0 0"}}) +
+          state("0 500000000", {{"other", "0 0 0 0 0 0"}}))
+      << "</gazebo_log>\n";
+  }
+
+  std::string output = custom_exec(std::string(GZ_LOG_PATH + " -x ") +
+      csvPath.string() + " --columns box.pose.x,ball.pose.z --start 0.45 -f " +
+      logPath.string());
+  EXPECT_NE(output.find("Extracted 1 states, skipped 2 chunks"),
+      std::string::npos) << output;
+
+  std::ifstream csvFile(csvPath.string());
+  std::string csv((std::istreambuf_iterator<char>(csvFile)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ("sim_time,box.pose.x,ball.pose.z\n0.500000000,1,2\n", csv);
+
+  boost::filesystem::remove_all(dir);
+}
+
 /////////////////////////////////////////////////
 TEST(gz_log, HangCheck)
 {
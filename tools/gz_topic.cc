@@ -52,11 +52,14 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::string>()->implicit_value(""),
+     "Get the transport statistics of the running processes. "
+     "Optionally, only the topics containing the given string are shown.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw, and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -96,6 +99,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(this->vm["stats"].as<std::string>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -347,6 +352,97 @@ void TopicCommand::Bw(const std::string &_topic)
     this->sigCondition.wait(lock);
 }
 
+/////////////////////////////////////////////////
+void TopicCommand::StatsCB(ConstTransportStatisticsPtr &_msg)
+{
+  // Rates are computed from the previous statistics of the same process
+  msgs::TransportStatistics &prev = this->prevStats[_msg->process()];
+  double dt = 0;
+  std::map<std::string, const msgs::TransportStatistics::Topic *> prevTopics;
+  if (prev.has_real_time())
+  {
+    dt = (msgs::Convert(_msg->real_time()) -
+        msgs::Convert(prev.real_time())).Double();
+    for (auto const &topic : prev.topic())
+      prevTopics[topic.name()] = &topic;
+  }
+
+  printf("Process [%s]\n", _msg->process().c_str());
+  printf("  %-48s %10s %10s %8s %10s %10s\n", "Topic", "Published",
+      "Pub/s", "Dropped", "Received", "Recv/s");
+
+  for (auto const &topic : _msg->topic())
+  {
+    if (topic.name().find(this->statsFilter) == std::string::npos)
+      continue;
+
+    double pubRate = 0;
+    double recvRate = 0;
+    auto iter = prevTopics.find(topic.name());
+    if (iter != prevTopics.end() && dt > 0)
+    {
+      pubRate = (topic.published() - iter->second->published()) / dt;
+      recvRate = (topic.received() - iter->second->received()) / dt;
+    }
+
+    printf("  %-48s %10llu %10.2f %8llu %10llu %10.2f\n",
+        topic.name().c_str(),
+        static_cast<unsigned long long>(topic.published()), pubRate,
+        static_cast<unsigned long long>(topic.dropped()),
+        static_cast<unsigned long long>(topic.received()), recvRate);
+
+    for (auto const &latency : topic.latency())
+    {
+      printf("    %-16s p50 %9.3f ms  p99 %9.3f ms  max %9.3f ms\n",
+          latency.stage().c_str(), latency.p50() * 1e3,
+          latency.p99() * 1e3, latency.max() * 1e3);
+    }
+  }
+
+  if (_msg->connection_size() > 0)
+  {
+    printf("  %-24s %10s %12s %10s %12s %8s %10s\n", "Connection",
+        "Written", "Written B", "Read", "Read B", "Dropped", "Queued B");
+  }
+
+  for (auto const &conn : _msg->connection())
+  {
+    printf("  %-24s %10llu %12llu %10llu %12llu %8llu %10llu\n",
+        conn.remote().c_str(),
+        static_cast<unsigned long long>(conn.written()),
+        static_cast<unsigned long long>(conn.written_bytes()),
+        static_cast<unsigned long long>(conn.read()),
+        static_cast<unsigned long long>(conn.read_bytes()),
+        static_cast<unsigned long long>(conn.dropped()),
+        static_cast<unsigned long long>(conn.queued_bytes()));
+
+    if (conn.has_write_queue())
+    {
+      printf("    %-16s p50 %9.3f ms  p99 %9.3f ms  max %9.3f ms\n",
+          conn.write_queue().stage().c_str(), conn.write_queue().p50() * 1e3,
+          conn.write_queue().p99() * 1e3, conn.write_queue().max() * 1e3);
+    }
+  }
+  printf("\n");
+
+  prev = *_msg;
+}
+
+/////////////////////////////////////////////////
+void TopicCommand::Stats(const std::string &_filter)
+{
+  this->statsFilter = _filter;
+  transport::SubscriberPtr sub = this->node->Subscribe(
+      "~/transport/statistics", &TopicCommand::StatsCB, this);
+
+  boost::mutex::scoped_lock lock(this->sigMutex);
+  if (this->vm.count("duration"))
+    this->sigCondition.timed_wait(lock,
+        boost::posix_time::seconds(this->vm["duration"].as<uint64_t>()));
+  else
+    this->sigCondition.wait(lock);
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::View(const std::string &_topic)
 {
@@ -17,6 +17,7 @@
 #ifndef _GZ_TOPIC_HH_
 #define _GZ_TOPIC_HH_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -72,6 +73,14 @@ namespace gazebo
     /// \param[in] _topic Topic name.
     private: void Bw(const std::string &_topic);
 
+    /// \brief Subscription callback used by Stats().
+    /// \param[in] _msg Statistics of a process.
+    private: void StatsCB(ConstTransportStatisticsPtr &_msg);
+
+    /// \brief Output the transport statistics published by the processes.
+    /// \param[in] _filter Only topics containing this string are shown.
+    private: void Stats(const std::string &_filter);
+
     /// \brief View topic information using QT.
     /// \param[in] _topic Name of the topic to view. Empty will bring up
     /// a topic selector.
@@ -103,6 +112,13 @@ namespace gazebo
 
     /// \brief Buffer of message publish times, used by Bw().
     private: std::vector<common::Time> bwTime;
+
+    /// \brief Topics shown by Stats().
+    private: std::string statsFilter;
+
+    /// \brief Last statistics received from each process, used by Stats()
+    /// to compute rates.
+    private: std::map<std::string, msgs::TransportStatistics> prevStats;
   };
 }
 #endif